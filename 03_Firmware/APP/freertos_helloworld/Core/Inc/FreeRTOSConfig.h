@@ -74,9 +74,11 @@
 #define configUSE_16_BIT_TICKS                   0
 #define configUSE_MUTEXES                        1
 #define configQUEUE_REGISTRY_SIZE                8
+#define configCHECK_FOR_STACK_OVERFLOW           2
 #define configUSE_RECURSIVE_MUTEXES              1
 #define configUSE_COUNTING_SEMAPHORES            1
-#define configUSE_PORT_OPTIMISED_TASK_SELECTION  0
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  1
+#define configRECORD_STACK_HIGH_ADDRESS          1
 /* USER CODE BEGIN MESSAGE_BUFFER_LENGTH_TYPE */
 /* Defaults to size_t for backward compatibility, but can be changed
    if lengths will always be less than the number of bytes in a size_t. */
@@ -165,6 +167,106 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+
+/* osMessageQueuePut/Get honour msg_prio: highest priority first, FIFO within a
+   priority. Costs 12 bytes per message slot over a plain FreeRTOS queue. */
+#define configUSE_OS2_MSGQUEUE_PRIO          1
+
+/* The FreeRTOS heap is heap_4.c, or with configUSE_HEAP_TLSF 1 heap_tlsf.c,
+   whose malloc and free take constant time however fragmented the heap is.
+   Both files are in the project and the one not selected compiles to
+   nothing; bench_heap.c compares them. */
+#define configUSE_HEAP_TLSF                  0
+#if (configUSE_HEAP_TLSF == 1)
+  #undef  USE_FreeRTOS_HEAP_4
+  #define USE_FreeRTOS_HEAP_TLSF
+#endif
+
+/* Slot 0 holds the task's arena (task_arena.h). */
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS  1
+
+/* CMSIS-RTOS2 objects created without cb_mem/stack_mem take their memory from
+   the static object table in os2_pool_cfg.h instead of the FreeRTOS heap.
+   For a build with no heap at all also set configSUPPORT_DYNAMIC_ALLOCATION
+   and configUSE_OS2_THREAD_ENUMERATE to 0 and drop heap_4.c from the project. */
+#define configUSE_OS2_STATIC_POOLS           0
+
+/* Record the owner of every memory pool block and assert on ownership
+   violations and leaked blocks in the zero-copy message path
+   (freertos_os2_zcopy.h). Debug builds only, costs 8 bytes per block. */
+#define configUSE_OS2_MSGBLOCK_DEBUG         0
+
+/* Software timers are kept in a hierarchical timing wheel: start, stop and
+   expiry cost the same however many timers are active, and osTimerStart/Stop
+   arm the wheel directly instead of queueing a command to the timer task.
+   configTIMER_WHEEL_LEVELS levels of 32 slots cover 32^levels ticks; the
+   wheel takes 640 bytes per level. */
+#define configUSE_TIMER_WHEEL                1
+#define configTIMER_WHEEL_LEVELS             4
+
+/* Stream and message buffers created with xStreamBufferCreateMultiProducer()
+   or xMessageBufferCreateMultiProducer() accept writes from several tasks and
+   interrupts at once without a critical section. */
+#define configUSE_STREAM_BUFFER_MULTI_PRODUCER 1
+
+/* Queues and event groups accept a wake threshold (vQueueSetWakeThreshold,
+   vEventGroupSetWakeThreshold, freertos_os2_batch.h) so that a burst of sends
+   or sets, from interrupts in particular, wakes the receiver once. With the
+   timing wheel a batch that does not fill up is delivered after a set latency
+   (xQueueSetWakeLatency, xEventGroupSetWakeLatency); each object with one
+   takes a software timer. */
+#define configUSE_BATCHED_WAKEUP             1
+
+/* Run time stats, when enabled, count microseconds of the timestamp service
+   (timestamp.h), which runs independently of the tick. */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  extern uint32_t timestamp_us32(void);
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()     timestamp_us32()
+
+/* osMutexAcquire/Release keep per-mutex contention, wait and hold times and
+   log priority inheritances (freertos_os2_mprof.h, mutex_prof.h), timed with
+   the timestamp counter. An uncontended acquire adds a table lookup and a
+   clock read, bench_mutex.c measures it. */
+#define configUSE_OS2_MUTEX_PROFILE          1
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  extern uint32_t timestamp_now32(void);
+  extern uint32_t timestamp_hz(void);
+#endif
+#define configOS2_MUTEX_PROFILE_CLOCK()      timestamp_now32()
+#define configOS2_MUTEX_PROFILE_CLOCK_HZ()   timestamp_hz()
+
+/* Kernel trace recorder: with TRACE_REC_ENABLE set to 1, trace_rec.h defines
+   the trace hooks and task, queue, mutex, heap and interrupt events are
+   streamed over RTT. Needs configUSE_TRACE_FACILITY. */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  #include "trace_rec.h"
+#endif
+
+/* Unlink a deleted task's arena (task_arena.h) while its stack and TCB still
+   exist, and trace the deletion when the recorder is on. */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  extern void task_arena_task_deleted(void *task);
+#endif
+#define traceTASK_DELETE( pxTCB ) \
+  do { TRACE_REC_TASK_DELETE_HOOK( pxTCB ); task_arena_task_deleted( ( void * ) ( pxTCB ) ); } while( 0 )
+
+/* Count context switches for the benchmarks (bench.h), and trace them when
+   the recorder is on. */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  extern volatile uint32_t bench_switches;
+#endif
+#define traceTASK_SWITCHED_IN() \
+  do { TRACE_REC_TASK_SWITCHED_IN_HOOK(); bench_switches++; } while( 0 )
+
+#if (configUSE_OS2_STATIC_POOLS == 1)
+  #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+    extern void osPoolRelease (void *ptr);
+  #endif
+  /* Hand the TCB and stack back to the pool once the kernel deletes a task */
+  #define portCLEAN_UP_TCB( pxTCB )          osPoolRelease( ( void * ) ( pxTCB ) )
+#endif
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    bench.h
+  * @brief   On-target micro benchmarks. Timing is taken from the DWT cycle
+  *          counter and results are reported through EasyLogger.
+  ******************************************************************************
+  */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* Benchmarks are run once from the default task when enabled. */
+#ifndef APP_BENCH_ENABLE
+#define APP_BENCH_ENABLE        0
+#endif
+
+#ifndef APP_BENCH_SCHED
+#define APP_BENCH_SCHED         1
+#endif
+
+#ifndef APP_BENCH_HEAP
+#define APP_BENCH_HEAP          1
+#endif
+
+#ifndef APP_BENCH_MSGQ
+#define APP_BENCH_MSGQ          1
+#endif
+
+#ifndef APP_BENCH_MPOOL
+#define APP_BENCH_MPOOL         1
+#endif
+
+#ifndef APP_BENCH_ZCOPY
+#define APP_BENCH_ZCOPY         1
+#endif
+
+#ifndef APP_BENCH_TIMER
+#define APP_BENCH_TIMER         1
+#endif
+
+#ifndef APP_BENCH_SBUF
+#define APP_BENCH_SBUF          1
+#endif
+
+#ifndef APP_BENCH_BATCH
+#define APP_BENCH_BATCH         1
+#endif
+
+#ifndef APP_BENCH_UART
+#define APP_BENCH_UART          1
+#endif
+
+#ifndef APP_BENCH_TIME
+#define APP_BENCH_TIME          1
+#endif
+
+#ifndef APP_BENCH_TRACE
+#define APP_BENCH_TRACE         1
+#endif
+
+#ifndef APP_BENCH_MUTEX
+#define APP_BENCH_MUTEX         1
+#endif
+
+#ifndef APP_BENCH_CYCLIC
+#define APP_BENCH_CYCLIC        1
+#endif
+
+/* CMSIS-DSP kernel sweep (dsp_bench.h). Off by default: the project has to
+   link CMSIS-DSP first, see bench_dsp.c. */
+#ifndef APP_BENCH_DSP
+#define APP_BENCH_DSP           0
+#endif
+
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+} bench_stat_t;
+
+static inline uint32_t bench_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* Context switches since reset, every task switched in by the scheduler */
+extern volatile uint32_t bench_switches;
+
+void bench_init(void);
+void bench_stat_reset(bench_stat_t *stat);
+void bench_stat_add(bench_stat_t *stat, uint32_t cycles);
+void bench_stat_report(const char *name, const bench_stat_t *stat);
+
+void bench_run_all(void);
+
+void bench_sched_run(void);
+void bench_heap_run(void);
+void bench_msgq_run(void);
+void bench_mpool_run(void);
+void bench_zcopy_run(void);
+void bench_timer_run(void);
+void bench_sbuf_run(void);
+void bench_batch_run(void);
+void bench_uart_run(void);
+void bench_time_run(void);
+void bench_trace_run(void);
+void bench_mutex_run(void);
+void bench_cyclic_run(void);
+void bench_dsp_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    bench_heap_trace.h
+  * @brief   The allocation trace bench_heap.c replays through pvPortMalloc
+  *          and vPortFree.
+  ******************************************************************************
+  * Shared with the host replay of 04_Software/01_Source_Code/rtos_host
+  * (heap_replay), which links heap_4.c and heap_tlsf.c in turn, so the
+  * numbers of the target and the host come from the same request sequence.
+  * Include it from one source file only: it defines the trace.
+  ******************************************************************************
+  */
+#ifndef __BENCH_HEAP_TRACE_H__
+#define __BENCH_HEAP_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define BENCH_HEAP_SLOTS        32
+#define BENCH_HEAP_CHURN        4000
+#define BENCH_HEAP_CHURN_SEED   0x2545F491UL
+
+/* One trace step: allocate size bytes into slot, or free the slot when size is 0.
+ * A slot still holding a block is freed first. */
+typedef struct
+{
+    uint8_t slot;
+    uint16_t size;
+} bench_heap_op_t;
+
+/* Synthetic start-up pattern, written by hand to look like one: blocks the
+ * sizes of task control blocks and stacks, queues and timers, allocated and
+ * freed in an interleaved order, which is what leaves holes in a first-fit
+ * heap. */
+static const bench_heap_op_t s_bench_heap_trace[] =
+{
+    {  0,  96 }, {  1, 512 }, {  2,  80 }, {  3, 160 }, {  4,  96 }, {  5, 1024 },
+    {  6,  48 }, {  7,  48 }, {  8, 256 }, {  9,  96 }, { 10, 512 }, { 11,  80 },
+    {  2,   0 }, {  6,   0 }, { 12,  24 }, { 13, 320 }, {  9,   0 }, { 10,   0 },
+    { 14,  64 }, { 15, 768 }, { 16,  48 }, {  3,   0 }, { 17, 128 }, { 18,  40 },
+    {  7,   0 }, { 19, 200 }, { 20,  96 }, { 21, 384 }, { 13,   0 }, { 22,  32 },
+    { 23, 144 }, { 11,   0 }, { 24, 600 }, { 25,  72 }, { 16,   0 }, { 26, 256 },
+    { 18,   0 }, { 27,  96 }, { 28, 512 }, { 20,   0 }, { 21,   0 }, { 29,  56 },
+};
+
+/* Next step of the steady state churn run on top of the trace. The generator
+ * is seeded with BENCH_HEAP_CHURN_SEED, so every allocator sees exactly the
+ * same request sequence. */
+static inline bench_heap_op_t bench_heap_churn_step(uint32_t *seed)
+{
+    bench_heap_op_t op;
+
+    *seed = *seed * 1664525 + 1013904223;
+    op.slot = (uint8_t)((*seed >> 8) % BENCH_HEAP_SLOTS);
+    op.size = (uint16_t)(((*seed >> 16) & 3) ? 16 + ((*seed >> 20) & 0xFF) : 0);
+    return op;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_HEAP_TRACE_H__ */
@@ -0,0 +1,113 @@
+/**
+  ******************************************************************************
+  * @file    cyclic.h
+  * @brief   Multi-rate cyclic executive: runs a table of periodic jobs from
+  *          one high priority task, rate-monotonic, on a 1 ms minor cycle.
+  ******************************************************************************
+  * The executive task wakes every CYCLIC_MINOR_MS with vTaskDelayUntil(), so
+  * releases follow the tick without drift. In each minor cycle it runs every
+  * job due, shortest period first, to completion. A job's deadline is its next
+  * release. Everything else - aperiodic and event driven work - stays in
+  * ordinary tasks below CYCLIC_PRIORITY.
+  *
+  * Per job it keeps run counts, deadline misses, budget overruns, execution
+  * time (min, mean, max and a log2 histogram in microseconds) and the worst
+  * release jitter, timed with the timestamp service (timestamp.h).
+  *
+  * A job that falls behind - because it or a job before it overran - has
+  * releases pending when the executive gets to it. Its overrun policy says
+  * what happens to them:
+  *
+  *   CYCLIC_OVERRUN_SKIP      run once for the latest release, drop the rest
+  *   CYCLIC_OVERRUN_CATCH_UP  run the missed releases back to back, at most
+  *                            CYCLIC_CATCH_UP_MAX in one minor cycle
+  *   CYCLIC_OVERRUN_DISABLE   stop running the job after its first miss
+  ******************************************************************************
+  */
+#ifndef __CYCLIC_H__
+#define __CYCLIC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef CYCLIC_MINOR_MS
+#define CYCLIC_MINOR_MS         1
+#endif
+
+#ifndef CYCLIC_MAX_JOBS
+#define CYCLIC_MAX_JOBS         8
+#endif
+
+#ifndef CYCLIC_PRIORITY
+#define CYCLIC_PRIORITY         osPriorityRealtime
+#endif
+
+#ifndef CYCLIC_STACK_SIZE
+#define CYCLIC_STACK_SIZE       1024    /* Bytes; the jobs run on this stack */
+#endif
+
+#ifndef CYCLIC_CATCH_UP_MAX
+#define CYCLIC_CATCH_UP_MAX     4
+#endif
+
+#ifndef CYCLIC_REPORT_MS
+#define CYCLIC_REPORT_MS        10000   /* Default task report period, 0 for none */
+#endif
+
+#define CYCLIC_HIST_BUCKETS     16      /* <1 us, 1 us, 2-3 us, 4-7 us, ... >=16 ms */
+
+typedef enum
+{
+    CYCLIC_OVERRUN_SKIP = 0,
+    CYCLIC_OVERRUN_CATCH_UP,
+    CYCLIC_OVERRUN_DISABLE,
+} cyclic_policy_t;
+
+typedef struct
+{
+    const char *name;
+    void (*func)(void *argument);
+    void *argument;
+    uint16_t period;                    /* Minor cycles between releases */
+    uint16_t offset;                    /* Minor cycle of the first release, to spread load */
+    uint32_t budget_us;                 /* Execution time budget, 0 for none */
+    cyclic_policy_t policy;
+} cyclic_job_t;
+
+typedef struct
+{
+    uint32_t releases;
+    uint32_t runs;
+    uint32_t skipped;                   /* Releases dropped by the overrun policy */
+    uint32_t misses;                    /* Runs that finished after the next release */
+    uint32_t overruns;                  /* Runs over budget_us */
+    uint32_t exec_min_us;
+    uint32_t exec_max_us;
+    uint64_t exec_total_us;
+    uint32_t jitter_max_us;             /* Latest start after the release */
+    uint32_t hist[CYCLIC_HIST_BUCKETS]; /* Execution time histogram */
+    uint8_t disabled;
+} cyclic_stats_t;
+
+typedef struct
+{
+    uint32_t cycles;                    /* Minor cycles run */
+    uint32_t overruns;                  /* Minor cycles that ran into the next one */
+    uint32_t wake_jitter_max_us;        /* Worst wake-up error against the cycle */
+} cyclic_frame_stats_t;
+
+int cyclic_start(const cyclic_job_t *jobs, uint32_t count);
+void cyclic_stop(void);
+int cyclic_get_stats(uint32_t index, cyclic_stats_t *stats);
+void cyclic_get_frame_stats(cyclic_frame_stats_t *stats);
+void cyclic_reset_stats(void);
+void cyclic_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CYCLIC_H__ */
@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bench.h
+  * @brief   Cycle counts of the CMSIS-DSP kernels over a sweep of block sizes,
+  *          data types and buffer alignments, printed as CSV or JSON.
+  ******************************************************************************
+  * The suite is plain C on top of arm_math.h and runs unchanged on the target
+  * (bench_dsp.c, DWT cycle counter) and on the host (dsp_host's dsp_bench
+  * tool, rdtsc or perf counters). The caller supplies the counter, the
+  * output and the work memory in a dsp_bench_port_t.
+  *
+  * Each function is run at every power of two block size from min_block to
+  * max_block that it supports, once with its buffers aligned to 8 bytes
+  * ("aligned") and once moved by one element ("offset"). A block size counts
+  * samples, complex samples for complex data, and matrix elements for the
+  * matrix functions, which use the most nearly square shape. Filters use
+  * DSP_BENCH_TAPS taps and convolutions a DSP_BENCH_TAPS long second input.
+  * Each point is timed repeat times after one untimed call; the minimum and
+  * the mean are reported, less the cost of reading the counter.
+  *
+  * CSV output starts with # comment lines describing the run, then
+  *
+  *   function,type,block,align,min,mean,per_sample
+  *
+  * JSON output is one object per line: the run first, then one per point
+  * with the same fields. 07_Tools/dsp_bench_compare.py compares two runs.
+  *
+  * dsp_bench_fir_crossover() is a second sweep, over tap counts: it times
+  * arm_fir_f32 against dsp_ols_fir_f32 (dsp_ols.h) at each partition
+  * length, checks that their outputs agree, and reports from how many taps
+  * on the fast convolution is the faster. CSV output is
+  *
+  *   taps,partition,min,mean,per_sample,check
+  *
+  * with partition 0 for arm_fir_f32, then one "# crossover" line per
+  * partition length, taps=0 where arm_fir_f32 stays the faster, and
+  * stream=ok where dsp_ols_fir_stream_f32() agreed on unevenly cut blocks.
+  *
+  * dsp_bench_resample() times the sample rate converters of dsp_resample.h
+  * on blocks of max_block input samples, at a few audio ratios, in f32 and
+  * q15: the naive chain (arm_fir_interpolate_* by L, keeping every Mth
+  * output, with the one-stage filter), the one-stage converter and the
+  * multi-stage one. Each is first checked on a tone, against the same tone
+  * delayed by its filters. CSV output is
+  *
+  *   ratio,type,method,stages,bytes,min,mean,per_output,check
+  *
+  * per_output being cycles per output sample, then a "# speedup" line per
+  * ratio and type: the cycles of the chain and of the one-stage converter
+  * over those of the multi-stage one, 0 for any that did not run. What
+  * does not fit the arena is listed as "# skipped".
+  ******************************************************************************
+  */
+#ifndef __DSP_BENCH_H__
+#define __DSP_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef DSP_BENCH_TAPS
+#define DSP_BENCH_TAPS          32
+#endif
+
+#define DSP_BENCH_MIN_BLOCK     16
+
+/* Work memory needed for a sweep up to max_block */
+#define DSP_BENCH_ARENA_SIZE(max_block)     (5U * (8U * (uint32_t)(max_block) + 128U))
+
+/* Work memory needed for a crossover sweep of max_block samples per call */
+#define DSP_BENCH_CROSSOVER_ARENA_SIZE(max_block, max_taps) \
+    (4U * (15U * (uint32_t)(max_block) + 6U * (uint32_t)(max_taps)) + 64U)
+
+typedef enum
+{
+    DSP_BENCH_CSV = 0,
+    DSP_BENCH_JSON
+} dsp_bench_format_t;
+
+typedef struct
+{
+    uint32_t (*cycles)(void);           /* Free-running counter */
+    uint32_t hz;                        /* Its rate, 0 if not known */
+    const char *clock;                  /* Its name, for the report */
+    const char *build;                  /* Compiler and flags, for the report; may be NULL */
+    void (*write)(const char *line);    /* Print one line, adding the newline */
+    void (*enter)(void);                /* Around every timed call, to keep other */
+    void (*leave)(void);                /* work away; both may be NULL */
+    void *arena;                        /* DSP_BENCH_ARENA_SIZE(max_block) bytes, 8-byte aligned */
+    uint32_t min_block;                 /* Powers of two, DSP_BENCH_MIN_BLOCK or more */
+    uint32_t max_block;
+    uint32_t repeat;                    /* Timed calls per point */
+    dsp_bench_format_t format;
+    const char *filter;                 /* Only functions whose name contains this; may be NULL */
+} dsp_bench_port_t;
+
+/**
+ * @brief  Run the sweep and print the results.
+ * @retval The number of points printed, or -1 if the port is not usable.
+ */
+int dsp_bench_run(const dsp_bench_port_t *port);
+
+/**
+ * @brief  Time arm_fir_f32 and dsp_ols_fir_f32 on blocks of max_block
+ *         samples, from 16 to max_taps taps, with partitions of min_block
+ *         to max_block (at most DSP_OLS_MAX_PART), and print the results.
+ *         Each partition's summary line also tells whether
+ *         dsp_ols_fir_stream_f32() matched arm_fir_f32, one partition late,
+ *         on blocks cut at other lengths. The port's arena is
+ *         DSP_BENCH_CROSSOVER_ARENA_SIZE(max_block, max_taps) bytes; its
+ *         filter is not used.
+ * @retval The number of points printed, or -1 if the port is not usable.
+ */
+int dsp_bench_fir_crossover(const dsp_bench_port_t *port, uint32_t max_taps);
+
+/**
+ * @brief  Time the sample rate converters of dsp_resample.h against the
+ *         naive chain on blocks of max_block samples, and print the
+ *         results. Converters that need more than arena_size bytes of the
+ *         port's arena are skipped; the port's filter is not used.
+ * @retval The number of points printed, or -1 if the port is not usable.
+ */
+int dsp_bench_resample(const dsp_bench_port_t *port, uint32_t arena_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_BENCH_H__ */
@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bfp.h
+  * @brief   Block floating point complex FFTs in q15_t and q31_t: the
+  *          CMSIS-DSP fixed-point transforms without the fixed down scaling.
+  ******************************************************************************
+  * arm_cfft_q15 and arm_cfft_q31 shift the data right by 2 bits in every
+  * radix 4 stage whatever its level, so the output is the DFT / fftLen and
+  * a 1024 point transform of a signal well below full scale keeps few
+  * significant bits. These transforms keep one exponent for the whole
+  * block instead: the input is normalised, and before each stage the data
+  * is shifted, right or left, only as far as needed to leave the stage's
+  * worst case growth as headroom (3 bits for radix 4, 2 for radix 2). The
+  * final exponent is returned.
+  *
+  * They take the arm_cfft_sR_q15_len* / arm_cfft_sR_q31_len* instances
+  * (arm_const_structs.h), 16 to 4096 points, work in place on interleaved
+  * data and put the output in the same order as arm_cfft_q15/_q31. The
+  * result is that of arm_cfft_f32 on the same values as fractions, the
+  * inverse scaled by 1 / fftLen, times 2^exponent:
+  *
+  *   X[k] = p1[k] * 2^exponent
+  *
+  * The tools/dsp_bfp_check program of dsp_host compares the SNR and speed
+  * with arm_cfft_q15, arm_cfft_q31 and arm_cfft_f32; fixed-point results
+  * are the same on the host as on the target.
+  ******************************************************************************
+  */
+#ifndef __DSP_BFP_H__
+#define __DSP_BFP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "arm_math.h"
+
+/**
+ * @brief  Complex FFT of S->fftLen q15 points in place.
+ * @param  ifftFlag        0 forward, 1 inverse.
+ * @param  bitReverseFlag  1 to put the output in order, as arm_cfft_q15.
+ * @retval The exponent of the output.
+ */
+int32_t dsp_bfp_cfft_q15(const arm_cfft_instance_q15 *S, q15_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+
+/**
+ * @brief  Complex FFT of S->fftLen q31 points in place.
+ * @param  ifftFlag        0 forward, 1 inverse.
+ * @param  bitReverseFlag  1 to put the output in order, as arm_cfft_q31.
+ * @retval The exponent of the output.
+ */
+int32_t dsp_bfp_cfft_q31(const arm_cfft_instance_q31 *S, q31_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_BFP_H__ */
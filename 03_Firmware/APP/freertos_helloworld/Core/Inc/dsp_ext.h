@@ -0,0 +1,24 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ext.h
+  * @brief   Build switch of the modules that extend CMSIS-DSP: dsp_bench,
+  *          dsp_bfp, dsp_mrfft, dsp_ols and dsp_resample.
+  ******************************************************************************
+  * The modules are compiled only when the build configures CMSIS-DSP, that
+  * is defines ARM_MATH_CM4 (or another ARM_MATH_ core) or, on the host,
+  * ARM_MATH_HOST. Otherwise DSP_EXT_ENABLED is 0 and their sources compile
+  * to nothing, so the Keil project lists them whether or not it links the
+  * DSP library (bench_dsp.c).
+  ******************************************************************************
+  */
+#ifndef __DSP_EXT_H__
+#define __DSP_EXT_H__
+
+#if defined(ARM_MATH_CM4) || defined(ARM_MATH_CM7) || defined(ARM_MATH_CM3) || \
+    defined(ARM_MATH_CM0) || defined(ARM_MATH_CM0PLUS) || defined(ARM_MATH_HOST)
+#define DSP_EXT_ENABLED         1
+#else
+#define DSP_EXT_ENABLED         0
+#endif
+
+#endif /* __DSP_EXT_H__ */
@@ -0,0 +1,106 @@
+/**
+  ******************************************************************************
+  * @file    dsp_mrfft.h
+  * @brief   Mixed-radix (2, 3, 4, 5, 8) complex and real FFTs in float32_t for
+  *          lengths that arm_cfft_f32 and arm_rfft_fast_f32 do not cover.
+  ******************************************************************************
+  * The CMSIS-DSP transforms take powers of two from 16 to 4096 points and
+  * their twiddle and bit reversal tables are linked in as constants. These
+  * take any multiple of 4 of the form 2^a * 3^b * 5^c, up to
+  * DSP_MRFFT_MAX_LEN complex points, e.g. 8192, 16384, 1000 or 3000.
+  *
+  * The init function plans the transform for its length: the radix of each
+  * stage, a quarter wave cosine table from which every twiddle factor is
+  * read, and the cycles of the digit reversal that puts the output in
+  * order. The tables go in memory the caller supplies,
+  * dsp_mrfft_cfft_size_f32() / dsp_mrfft_rfft_size_f32() bytes of it, and
+  * stay in use for the life of the instance. For 8192 complex points that
+  * is 8 KB of table and 18 KB of cycles; arm_cfft_sR_f32_len4096 links in
+  * 40 KB of tables for half the length. The tools/dsp_fft_check program
+  * of dsp_host compares speed and memory with the CMSIS-DSP transforms.
+  *
+  * The transforms work like their CMSIS-DSP counterparts: interleaved
+  * complex data, the complex FFT in place, the inverse scaled by 1 / n, and
+  * the real FFT output packed as arm_rfft_fast_f32's, X[0] and X[n / 2] in
+  * the first two words, then X[1] .. X[n / 2 - 1].
+  ******************************************************************************
+  */
+#ifndef __DSP_MRFFT_H__
+#define __DSP_MRFFT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "arm_math.h"
+
+/* Largest complex length, twice that real; indices are kept in 16 bits */
+#define DSP_MRFFT_MAX_LEN       65536U
+#define DSP_MRFFT_MAX_STAGES    16U
+
+typedef struct
+{
+    uint32_t fftLen;                    /* Complex points */
+    uint32_t quarter;                   /* The table holds cos(2 pi k / (4 * quarter)), k = 0 .. quarter */
+    uint32_t stride;                    /* Table steps per 2 pi / fftLen */
+    uint32_t bytes;                     /* Caller memory in use */
+    uint8_t stages;
+    uint8_t radix[DSP_MRFFT_MAX_STAGES];
+    const float32_t *pCos;
+    const uint16_t *pCycles;            /* Length, then the indices of each cycle; 0 ends */
+} dsp_mrfft_cfft_instance_f32;
+
+typedef struct
+{
+    uint32_t fftLenReal;
+    dsp_mrfft_cfft_instance_f32 cfft;   /* fftLenReal / 2 points, sharing the table */
+} dsp_mrfft_rfft_instance_f32;
+
+/**
+ * @brief  Memory the complex FFT of fftLen points needs.
+ * @retval Bytes, or 0 if the length is not supported.
+ */
+uint32_t dsp_mrfft_cfft_size_f32(uint32_t fftLen);
+
+/**
+ * @brief  Plan a complex FFT.
+ * @param  mem   dsp_mrfft_cfft_size_f32(fftLen) bytes, 4-byte aligned.
+ * @retval ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR if the length is not
+ *         supported or size is too small.
+ */
+arm_status dsp_mrfft_cfft_init_f32(dsp_mrfft_cfft_instance_f32 *S, uint32_t fftLen, void *mem, uint32_t size);
+
+/**
+ * @brief  Complex FFT of fftLen interleaved points in place, in order.
+ * @param  ifftFlag 0 forward, 1 inverse scaled by 1 / fftLen.
+ */
+void dsp_mrfft_cfft_f32(const dsp_mrfft_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag);
+
+/**
+ * @brief  Memory the real FFT of fftLenReal samples needs.
+ * @retval Bytes, or 0 if the length is not supported.
+ */
+uint32_t dsp_mrfft_rfft_size_f32(uint32_t fftLenReal);
+
+/**
+ * @brief  Plan a real FFT.
+ * @param  mem   dsp_mrfft_rfft_size_f32(fftLenReal) bytes, 4-byte aligned.
+ * @retval ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR if the length is not
+ *         supported or size is too small.
+ */
+arm_status dsp_mrfft_rfft_init_f32(dsp_mrfft_rfft_instance_f32 *S, uint32_t fftLenReal, void *mem, uint32_t size);
+
+/**
+ * @brief  Real FFT, as arm_rfft_fast_f32. p is overwritten in both
+ *         directions.
+ * @param  p       fftLenReal samples forward, the packed spectrum inverse.
+ * @param  pOut    The packed spectrum forward, fftLenReal samples inverse.
+ * @param  ifftFlag 0 forward, 1 inverse.
+ */
+void dsp_mrfft_rfft_f32(const dsp_mrfft_rfft_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_MRFFT_H__ */
@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ols.h
+  * @brief   FIR filter in float32_t by partitioned overlap-save fast
+  *          convolution on arm_rfft_fast_f32, for filters of hundreds to
+  *          thousands of taps.
+  ******************************************************************************
+  * arm_fir_f32 costs numTaps multiply-adds per sample. This filter splits
+  * the taps into partitions of partLen, keeps the spectrum of each, and per
+  * partLen input samples does one real FFT and one inverse of 2 * partLen
+  * points plus numTaps / partLen complex multiply-adds per frequency bin,
+  * which is cheaper from some tens of taps on. dsp_bench_fir_crossover()
+  * (dsp_bench.h) measures where, on the target and on the host.
+  *
+  * The output is that of arm_fir_f32 with the same coefficients, to
+  * rounding, with no added delay. The partition length sets the trade-off:
+  * blocks passed to dsp_ols_fir_f32() are whole partitions, so a short
+  * partition allows short blocks, that is low latency, while a long one
+  * needs fewer multiply-adds per sample. dsp_ols_fir_stream_f32() takes
+  * blocks of any length and holds a partial partition over to the next
+  * call, at the cost of a delay of partLen samples.
+  *
+  * The spectra, the input history and the work buffers go in memory the
+  * caller supplies, dsp_ols_fir_size_f32() bytes of it; the coefficients
+  * are not referenced after init.
+  ******************************************************************************
+  */
+#ifndef __DSP_OLS_H__
+#define __DSP_OLS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "arm_math.h"
+
+/* Partition lengths: powers of two, the FFTs are twice as long */
+#define DSP_OLS_MIN_PART        16U
+#define DSP_OLS_MAX_PART        2048U
+
+typedef struct
+{
+    uint32_t numTaps;
+    uint32_t partLen;
+    uint32_t parts;                     /* numTaps / partLen, rounded up */
+    uint32_t head;                      /* Slot of the newest input spectrum in pDelay */
+    uint32_t fill;                      /* Samples in pIn, dsp_ols_fir_stream_f32() */
+    float32_t *pSpectra;                /* parts * 2 * partLen: spectrum of each partition */
+    float32_t *pDelay;                  /* parts * 2 * partLen: spectra of the last parts inputs */
+    float32_t *pHistory;                /* partLen: the previous input partition */
+    float32_t *pWork;                   /* 2 * partLen */
+    float32_t *pAcc;                    /* 2 * partLen */
+    float32_t *pIn;                     /* partLen: the partition being gathered */
+    float32_t *pOut;                    /* partLen: the output of the last one */
+    arm_rfft_fast_instance_f32 rfft;
+} dsp_ols_fir_instance_f32;
+
+/**
+ * @brief  Memory the filter needs.
+ * @retval Bytes, or 0 if partLen is not supported.
+ */
+uint32_t dsp_ols_fir_size_f32(uint32_t numTaps, uint32_t partLen);
+
+/**
+ * @brief  Set up the filter with a cleared history.
+ * @param  pCoeffs  numTaps coefficients in the order arm_fir_init_f32 takes,
+ *                  that is time reversed.
+ * @param  partLen  Partition length, a power of two from DSP_OLS_MIN_PART to
+ *                  DSP_OLS_MAX_PART.
+ * @param  mem      dsp_ols_fir_size_f32(numTaps, partLen) bytes, 4-byte
+ *                  aligned.
+ * @retval ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR if numTaps is 0,
+ *         partLen is not supported or size is too small.
+ */
+arm_status dsp_ols_fir_init_f32(dsp_ols_fir_instance_f32 *S, uint32_t numTaps, const float32_t *pCoeffs,
+                                uint32_t partLen, void *mem, uint32_t size);
+
+/**
+ * @brief  Filter a block, as arm_fir_f32. pSrc and pDst may be the same.
+ * @param  blockSize A multiple of partLen.
+ * @retval ARM_MATH_SUCCESS, or ARM_MATH_LENGTH_ERROR, with nothing done, if
+ *         blockSize is not a multiple of partLen or dsp_ols_fir_stream_f32()
+ *         holds a partial partition.
+ */
+arm_status dsp_ols_fir_f32(dsp_ols_fir_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief  Filter a block of any length; the output is that of
+ *         dsp_ols_fir_f32() delayed by partLen samples. pSrc and pDst may
+ *         be the same.
+ */
+void dsp_ols_fir_stream_f32(dsp_ols_fir_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_OLS_H__ */
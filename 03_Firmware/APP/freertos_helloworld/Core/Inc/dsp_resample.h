@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file    dsp_resample.h
+  * @brief   Rational sample rate converter in float32_t and q15_t: polyphase
+  *          up by L, down by M, split into stages.
+  ******************************************************************************
+  * arm_fir_interpolate_* followed by arm_fir_decimate_* converts by L / M
+  * but computes L outputs per input and filters at L times the input rate,
+  * to keep one output in M: 44.1 to 16 kHz, 160 / 441, needs a filter of
+  * tens of thousands of taps. This converter only computes the outputs it
+  * keeps, each a dot product with one phase of the filter, and factors the
+  * ratio into up to DSP_RESAMPLE_MAX_STAGES stages: the stages away from
+  * the lower of the two rates may let their transition band alias onto
+  * frequencies the next stage removes, so their filters are short, and the
+  * long one runs at a low rate. 160 / 441 runs as 4 / 7 then 40 / 63, in a
+  * sixth of the memory of one stage and two thirds of the time.
+  *
+  * The filters are Kaiser windowed sincs designed at init for
+  * DSP_RESAMPLE_ATTEN_DB of stopband attenuation, passing up to
+  * DSP_RESAMPLE_PASS of the lower Nyquist frequency; above that, up to the
+  * lower Nyquist frequency, is the transition band. Their polyphase banks,
+  * the state of each stage and the samples between stages go in memory the
+  * caller supplies, dsp_resample_size_*() bytes of it.
+  *
+  * Blocks of any length up to maxBlock may be passed; the state carries
+  * from one to the next, so the output of a stream does not depend on how
+  * it is cut. Each call returns the number of samples it wrote, on average
+  * L / M per input, at most S->maxOut. The output lags the input by
+  * S->delay input samples, the group delay of the filters.
+  *
+  * dsp_bench_resample() (dsp_bench.h) compares the cycles per output
+  * sample with those of arm_fir_interpolate_* and a one-stage converter.
+  ******************************************************************************
+  */
+#ifndef __DSP_RESAMPLE_H__
+#define __DSP_RESAMPLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "arm_math.h"
+
+#define DSP_RESAMPLE_MAX_STAGES 4U
+#define DSP_RESAMPLE_MAX_FACTOR 65535U  /* L and M, reduced */
+
+#ifndef DSP_RESAMPLE_ATTEN_DB
+#define DSP_RESAMPLE_ATTEN_DB   80.0
+#endif
+#ifndef DSP_RESAMPLE_PASS
+#define DSP_RESAMPLE_PASS       0.9
+#endif
+
+typedef struct
+{
+    uint16_t L;                         /* Up by L, */
+    uint16_t M;                         /* then down by M */
+    uint16_t taps;                      /* Per phase */
+    uint16_t phase;                     /* Of the next output, 0 .. L - 1 */
+    uint32_t next;                      /* Its newest input, counted from the next block's first */
+    uint32_t maxIn;                     /* Inputs per call */
+} dsp_resample_stage_t;
+
+typedef struct
+{
+    uint32_t L;                         /* The ratio, reduced */
+    uint32_t M;
+    uint32_t stages;                    /* 0 when L = M */
+    uint32_t maxBlock;
+    uint32_t maxOut;                    /* Outputs per call at most */
+    float32_t delay;                    /* Group delay, in input samples */
+    dsp_resample_stage_t stage[DSP_RESAMPLE_MAX_STAGES];
+    float32_t *pBank[DSP_RESAMPLE_MAX_STAGES];  /* L phases of taps, each time reversed */
+    float32_t *pState[DSP_RESAMPLE_MAX_STAGES]; /* taps - 1 + maxIn */
+} dsp_resample_instance_f32;
+
+typedef struct
+{
+    uint32_t L;
+    uint32_t M;
+    uint32_t stages;
+    uint32_t maxBlock;
+    uint32_t maxOut;
+    float32_t delay;
+    dsp_resample_stage_t stage[DSP_RESAMPLE_MAX_STAGES];
+    q15_t *pBank[DSP_RESAMPLE_MAX_STAGES];
+    q15_t *pState[DSP_RESAMPLE_MAX_STAGES];
+} dsp_resample_instance_q15;
+
+/**
+ * @brief  Memory the converter needs.
+ * @param  maxStages  Stages at most, 0 for DSP_RESAMPLE_MAX_STAGES; 1 makes
+ *                    a one-stage converter.
+ * @retval Bytes, or 0 if the ratio is not supported.
+ */
+uint32_t dsp_resample_size_f32(uint32_t L, uint32_t M, uint32_t maxStages, uint32_t maxBlock);
+uint32_t dsp_resample_size_q15(uint32_t L, uint32_t M, uint32_t maxStages, uint32_t maxBlock);
+
+/**
+ * @brief  Plan the stages, design their filters and clear the state.
+ * @param  L, M       Output rate / input rate; a common factor is removed.
+ * @param  mem        dsp_resample_size_*(L, M, maxStages, maxBlock) bytes,
+ *                    4-byte aligned.
+ * @retval ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR if L or M is 0, the
+ *         reduced ratio has a factor above DSP_RESAMPLE_MAX_FACTOR,
+ *         maxBlock is 0 or size is too small.
+ * @note   The planning takes about 1 KB of stack, and the design a few
+ *         sin() per tap: call it at start-up.
+ */
+arm_status dsp_resample_init_f32(dsp_resample_instance_f32 *S, uint32_t L, uint32_t M, uint32_t maxStages,
+                                 uint32_t maxBlock, void *mem, uint32_t size);
+arm_status dsp_resample_init_q15(dsp_resample_instance_q15 *S, uint32_t L, uint32_t M, uint32_t maxStages,
+                                 uint32_t maxBlock, void *mem, uint32_t size);
+
+/**
+ * @brief  Convert a block. pSrc and pDst must not overlap.
+ * @param  blockSize  At most maxBlock.
+ * @retval The number of samples written to pDst, at most S->maxOut; 0 if
+ *         blockSize is above maxBlock.
+ */
+uint32_t dsp_resample_f32(dsp_resample_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+uint32_t dsp_resample_q15(dsp_resample_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_RESAMPLE_H__ */
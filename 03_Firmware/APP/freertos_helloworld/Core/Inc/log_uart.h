@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    log_uart.h
+  * @brief   EasyLogger output over the DMA UART, for units without a probe.
+  ******************************************************************************
+  * Formatted lines are copied into a ring that the UART DMA sends from in
+  * place, in the longest contiguous runs available, so logging a line costs
+  * one memcpy. When the ring is full each level follows its own policy:
+  * drop the new line, drop the oldest lines not yet being sent, or block the
+  * logging task until DMA frees room.
+  *
+  * Selected in elog_port.c with LOG_UART_ENABLE; RTT is used otherwise.
+  ******************************************************************************
+  */
+#ifndef __LOG_UART_H__
+#define __LOG_UART_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef LOG_UART_ENABLE
+#define LOG_UART_ENABLE         0
+#endif
+
+#ifndef LOG_UART_BAUD
+#define LOG_UART_BAUD           2000000
+#endif
+
+#ifndef LOG_UART_RING_SIZE
+#define LOG_UART_RING_SIZE      8192
+#endif
+
+typedef enum
+{
+    LOG_UART_DROP_NEWEST = 0,   /* Discard the line that does not fit */
+    LOG_UART_DROP_OLDEST,       /* Discard queued lines, oldest first, to make room */
+    LOG_UART_BLOCK,             /* Wait for room; drop oldest where a task cannot wait */
+} log_uart_policy_t;
+
+typedef struct
+{
+    uint32_t queued_bytes;      /* Bytes accepted into the ring */
+    uint32_t sent_bytes;        /* Bytes sent by DMA */
+    uint32_t rate;              /* Bytes per second sent over the last second */
+    uint32_t dropped_lines;
+    uint32_t dropped_bytes;
+    uint32_t blocked;           /* Writes that had to wait for room */
+    uint32_t peak;              /* Highest ring fill in bytes */
+} log_uart_stats_t;
+
+int log_uart_init(uint32_t baudrate);
+void log_uart_set_policy(uint8_t level, log_uart_policy_t policy);
+void log_uart_write(uint8_t level, const char *log, size_t size);
+void log_uart_get_stats(log_uart_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_UART_H__ */
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    mutex_prof.h
+  * @brief   Reports of the CMSIS-RTOS2 mutex profile (freertos_os2_mprof.h).
+  ******************************************************************************
+  * mutex_prof_log() prints one line per profiled mutex and the latest priority
+  * inheritances through EasyLogger, times in microseconds.
+  *
+  * mutex_prof_rtt() writes the same data as binary records to an RTT
+  * up-buffer, for a host to collect while the target runs:
+  *
+  *   mutex_prof_rec_t      one per profiled mutex, type MUTEX_PROF_REC_STAT
+  *   mutex_prof_inherit_t  one per kept inheritance, type MUTEX_PROF_REC_INHERIT
+  *
+  * Both start with a type byte and are little endian; times are in profile
+  * clock counts, clock_hz per second.
+  ******************************************************************************
+  */
+#ifndef __MUTEX_PROF_H__
+#define __MUTEX_PROF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define MUTEX_PROF_REC_STAT     0x01
+#define MUTEX_PROF_REC_INHERIT  0x02
+
+#define MUTEX_PROF_NAME_LEN     16
+
+typedef struct
+{
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t clock_hz;
+    uint32_t mutex;                     /* Mutex id */
+    uint32_t acquired;
+    uint32_t contended;
+    uint32_t timeouts;
+    uint32_t inherits;
+    uint32_t wait_max;
+    uint32_t hold_max;
+    uint32_t wait_total_lo;
+    uint32_t wait_total_hi;
+    char name[MUTEX_PROF_NAME_LEN];
+} mutex_prof_rec_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint8_t owner_prio;
+    uint8_t waiter_prio;
+    uint8_t reserved;
+    uint32_t time;
+    uint32_t mutex;
+    char name[MUTEX_PROF_NAME_LEN];
+    char owner[MUTEX_PROF_NAME_LEN];
+    char waiter[MUTEX_PROF_NAME_LEN];
+} mutex_prof_inherit_t;
+
+void mutex_prof_log(void);
+int mutex_prof_rtt(unsigned channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MUTEX_PROF_H__ */
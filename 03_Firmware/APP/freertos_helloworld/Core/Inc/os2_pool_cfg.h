@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    os2_pool_cfg.h
+  * @brief   CMSIS-RTOS2 static object table, used when
+  *          configUSE_OS2_STATIC_POOLS is 1 (see FreeRTOSConfig.h).
+  ******************************************************************************
+  * One line per RTOS object the application creates without supplying its own
+  * cb_mem/stack_mem/mq_mem/mp_mem. Objects are matched to lines by name
+  * (osXxxAttr_t.name). A line whose name starts with OS2_POOL_ANY_PREFIX,
+  * e.g. TIMER (any_0), is a wildcard: an unnamed object, or a named one whose
+  * own line is missing or taken, takes the first free wildcard line of its
+  * type that is large enough, and creation fails when there is none. A line
+  * named for one object is never given to another.
+  *
+  *   THREAD     (name, stack_size)             stack_size in bytes
+  *   TIMER      (name)
+  *   EVENTFLAGS (name)
+  *   MUTEX      (name)
+  *   SEMAPHORE  (name)
+  *   MSGQUEUE   (name, msg_count, msg_size)
+  *   MEMPOOL    (name, block_count, block_size)
+  ******************************************************************************
+  */
+#ifndef __OS2_POOL_CFG_H__
+#define __OS2_POOL_CFG_H__
+
+#define OS2_POOL_TABLE(THREAD, TIMER, EVENTFLAGS, MUTEX, SEMAPHORE, MSGQUEUE, MEMPOOL) \
+  THREAD (defaultTask, 128 * 4)
+
+/* Name prefix of the wildcard lines */
+#define OS2_POOL_ANY_PREFIX     "any_"
+
+/* RAM the whole table may occupy; the build fails when it needs more. */
+#define OS2_POOL_BUDGET         (8U * 1024U)
+
+#endif /* __OS2_POOL_CFG_H__ */
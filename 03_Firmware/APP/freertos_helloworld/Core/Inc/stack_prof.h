@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    stack_prof.h
+  * @brief   Stack usage profiler. Samples the high-water mark of every task
+  *          and of the main (interrupt) stack, and recommends stack sizes.
+  ******************************************************************************
+  * A software timer samples every STACK_PROF_PERIOD_MS. Each task's deepest
+  * use is its stack size less the kernel's high-water mark. The main stack,
+  * which every interrupt runs on once the scheduler starts, is painted with a
+  * pattern by stack_prof_init() and scanned the same way. A task that comes
+  * within STACK_PROF_WARN_BYTES of its end is logged once.
+  *
+  * stack_prof_report() logs, for each task, the deepest use seen and a
+  * stack_size for its osThreadAttr_t: the use plus STACK_PROF_MARGIN_PCT,
+  * rounded up to 8 bytes and at least STACK_PROF_MIN_BYTES. The same is given
+  * for Stack_Size in startup_stm32f411xe.s. The figures only cover the paths
+  * that ran, so sample through a full workload - the benchmarks, say - before
+  * shrinking anything, and keep configCHECK_FOR_STACK_OVERFLOW on.
+  *
+  * 07_Tools/stack_usage.py gives the static worst case per function from the
+  * compiler's stack usage output, to set against these measurements.
+  ******************************************************************************
+  */
+#ifndef __STACK_PROF_H__
+#define __STACK_PROF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef STACK_PROF_ENABLE
+#define STACK_PROF_ENABLE       1
+#endif
+
+#ifndef STACK_PROF_PERIOD_MS
+#define STACK_PROF_PERIOD_MS    1000
+#endif
+
+#ifndef STACK_PROF_MAX_TASKS
+#define STACK_PROF_MAX_TASKS    12      /* Tasks tracked, live and deleted */
+#endif
+
+#ifndef STACK_PROF_MARGIN_PCT
+#define STACK_PROF_MARGIN_PCT   25
+#endif
+
+#ifndef STACK_PROF_MIN_BYTES
+#define STACK_PROF_MIN_BYTES    256     /* Room for an FPU exception frame and a call or two */
+#endif
+
+#ifndef STACK_PROF_WARN_BYTES
+#define STACK_PROF_WARN_BYTES   64
+#endif
+
+#define STACK_PROF_NAME_LEN     16
+
+typedef struct
+{
+    char name[STACK_PROF_NAME_LEN];
+    uint32_t number;                    /* Kernel task number */
+    uint32_t size;                      /* Stack size in bytes */
+    uint32_t used;                      /* Deepest use seen, in bytes */
+    uint32_t recommended;               /* Suggested stack_size in bytes */
+    uint8_t alive;                      /* 0 once the task has been deleted */
+} stack_prof_task_t;
+
+void stack_prof_init(void);
+void stack_prof_sample(void);
+int stack_prof_get(uint32_t index, stack_prof_task_t *task);
+void stack_prof_msp(uint32_t *size, uint32_t *used);
+uint32_t stack_prof_recommend(uint32_t used);
+void stack_prof_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STACK_PROF_H__ */
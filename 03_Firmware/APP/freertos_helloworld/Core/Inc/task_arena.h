@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file    task_arena.h
+  * @brief   Per-task bump allocator on top of pvPortMalloc.
+  ******************************************************************************
+  * A task takes one region from the FreeRTOS heap (or supplies its own buffer),
+  * carves short-lived buffers out of it with task_arena_alloc() and releases
+  * them all at once with task_arena_reset() at the end of its work cycle. The
+  * region belongs to one task, so allocation takes no lock and never suspends
+  * the scheduler. A task deleted without task_arena_destroy() has its arena
+  * unlinked by the kernel's traceTASK_DELETE hook and its heap region freed
+  * later.
+  ******************************************************************************
+  */
+#ifndef __TASK_ARENA_H__
+#define __TASK_ARENA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Thread local storage slot that holds the calling task's arena. */
+#ifndef TASK_ARENA_TLS_INDEX
+#define TASK_ARENA_TLS_INDEX    0
+#endif
+
+#if (configNUM_THREAD_LOCAL_STORAGE_POINTERS <= TASK_ARENA_TLS_INDEX)
+#error "task_arena needs configNUM_THREAD_LOCAL_STORAGE_POINTERS > TASK_ARENA_TLS_INDEX"
+#endif
+
+typedef struct task_arena
+{
+    uint8_t *base;
+    size_t size;
+    size_t used;                /* Bytes handed out since the last reset */
+    size_t peak;                /* Highest value of used ever seen */
+    uint32_t allocs;            /* Successful allocations, all cycles */
+    uint32_t fails;             /* Requests that did not fit */
+    uint32_t resets;            /* Completed work cycles */
+    TaskHandle_t owner;
+    uint8_t heap_owned;         /* base came from pvPortMalloc */
+    struct task_arena *next;
+} task_arena_t;
+
+BaseType_t task_arena_create(task_arena_t *arena, size_t size);
+BaseType_t task_arena_init(task_arena_t *arena, void *buf, size_t size);
+void task_arena_destroy(task_arena_t *arena);
+
+void *task_arena_alloc_from(task_arena_t *arena, size_t size);
+void task_arena_reset(task_arena_t *arena);
+
+/**
+ * @brief  Arena of the calling task, NULL when it has none.
+ */
+static inline task_arena_t *task_arena_self(void)
+{
+    return (task_arena_t *)pvTaskGetThreadLocalStoragePointer(NULL, TASK_ARENA_TLS_INDEX);
+}
+
+/**
+ * @brief  Allocate from the calling task's arena.
+ */
+static inline void *task_arena_alloc(size_t size)
+{
+    return task_arena_alloc_from(task_arena_self(), size);
+}
+
+void task_arena_task_deleted(void *task);
+
+/**
+ * @brief  Log every arena's use with its task's run time, in microseconds of
+ *         the timestamp service (0 unless configGENERATE_RUN_TIME_STATS).
+ */
+void task_arena_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TASK_ARENA_H__ */
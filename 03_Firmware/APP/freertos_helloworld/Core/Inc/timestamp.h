@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    timestamp.h
+  * @brief   Free-running high-resolution timestamps, independent of the RTOS
+  *          tick and the HAL timebase.
+  ******************************************************************************
+  * On the target TIM5, a 32-bit timer, counts the APB1 timer clock (100 MHz,
+  * 10 ns) and its update interrupt extends it to 64 bits. Reads take no lock
+  * and are valid in tasks, in interrupts of any priority and with interrupts
+  * masked, as long as they are not masked for more than half a wrap (21 s).
+  *
+  * Defining TIMESTAMP_HOST builds the same interface on clock_gettime() with
+  * CLOCK_MONOTONIC for host and simulation builds, at 1 ns per count.
+  ******************************************************************************
+  */
+#ifndef __TIMESTAMP_H__
+#define __TIMESTAMP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+void timestamp_init(void);
+uint32_t timestamp_hz(void);
+
+uint32_t timestamp_now32(void);
+uint64_t timestamp_now(void);
+
+uint64_t timestamp_to_ns(uint64_t ticks);
+uint64_t timestamp_us(void);
+uint32_t timestamp_us32(void);
+
+#ifndef TIMESTAMP_HOST
+void timestamp_overflow_isr(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMESTAMP_H__ */
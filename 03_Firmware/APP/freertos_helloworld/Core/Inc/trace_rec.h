@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    trace_rec.h
+  * @brief   Kernel trace recorder. Implements the FreeRTOS trace hooks and
+  *          streams compact binary event records over RTT.
+  ******************************************************************************
+  * Every record starts with an 8 byte header: the low 32 bits of the
+  * timestamp (timestamp.h), the event type and two arguments. Task and queue
+  * records carry the kernel's task and queue numbers; task names, heap
+  * addresses and the clock follow in the longer records listed below. A
+  * record goes into the RTT up-buffer whole or not at all, and records that
+  * did not fit are counted and reported in a TRACE_REC_LOST record.
+  *
+  * Capture RTT channel TRACE_REC_CHANNEL to a file, for example with
+  * JLinkRTTLogger, and convert it for chrome://tracing or Perfetto with
+  * 07_Tools/trace2json.py. Attach before the target starts so that the task
+  * and queue creation records are seen.
+  *
+  * Interrupts at or below configMAX_SYSCALL_INTERRUPT_PRIORITY mark their
+  * entry and exit with TRACE_REC_ISR_ENTER() and TRACE_REC_ISR_EXIT().
+  *
+  * This header is included by FreeRTOSConfig.h and must not include any
+  * kernel header.
+  ******************************************************************************
+  */
+#ifndef __TRACE_REC_H__
+#define __TRACE_REC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef TRACE_REC_ENABLE
+#define TRACE_REC_ENABLE        0
+#endif
+
+#ifndef TRACE_REC_CHANNEL
+#define TRACE_REC_CHANNEL       1       /* RTT up-buffer; 0 is the terminal */
+#endif
+
+#ifndef TRACE_REC_BUFFER_SIZE
+#define TRACE_REC_BUFFER_SIZE   4096
+#endif
+
+#ifndef TRACE_REC_SYNC_TICKS
+#define TRACE_REC_SYNC_TICKS    1000    /* Full timestamp every second */
+#endif
+
+/* Event types. The record layout of each is given as header arguments
+ * (a8, a16) and the words that follow the header. Keep trace2json.py in
+ * step with this list. */
+#define TRACE_REC_SYNC          0x01    /* a16 0; timestamp high word, counts per second */
+#define TRACE_REC_LOST          0x02    /* a16 records lost since the last record */
+#define TRACE_REC_TASK_CREATE   0x10    /* a8 priority, a16 task; 16 byte name */
+#define TRACE_REC_TASK_DELETE   0x11    /* a16 task */
+#define TRACE_REC_TASK_IN       0x12    /* a16 task */
+#define TRACE_REC_TASK_OUT      0x13    /* a16 task */
+#define TRACE_REC_TASK_READY    0x14    /* a16 task */
+#define TRACE_REC_QUEUE_CREATE  0x20    /* a8 queue type, a16 queue */
+#define TRACE_REC_QUEUE_SEND    0x21    /* a16 queue, for this and the rest */
+#define TRACE_REC_QUEUE_SEND_FAILED     0x22
+#define TRACE_REC_QUEUE_RECEIVE         0x23
+#define TRACE_REC_QUEUE_RECEIVE_FAILED  0x24
+#define TRACE_REC_QUEUE_BLOCK_SEND      0x25
+#define TRACE_REC_QUEUE_BLOCK_RECEIVE   0x26
+#define TRACE_REC_QUEUE_SEND_ISR        0x27
+#define TRACE_REC_QUEUE_RECEIVE_ISR     0x28
+#define TRACE_REC_QUEUE_DELETE          0x29
+#define TRACE_REC_MUTEX_INHERIT         0x30    /* a8 priority, a16 holder task */
+#define TRACE_REC_MUTEX_DISINHERIT      0x31    /* a8 priority, a16 holder task */
+#define TRACE_REC_MALLOC        0x40    /* address, size */
+#define TRACE_REC_FREE          0x41    /* address, size */
+#define TRACE_REC_ISR_ENTER_ID  0x50    /* a16 exception number */
+#define TRACE_REC_ISR_EXIT_ID   0x51    /* a16 exception number */
+
+void trace_rec_init(void);
+void trace_rec_start(void);
+void trace_rec_stop(void);
+uint32_t trace_rec_lost(void);
+
+void trace_rec_event(uint8_t type, uint8_t a8, uint32_t a16);
+void trace_rec_task_create(uint32_t task, uint32_t priority, const char *name);
+uint32_t trace_rec_queue_create(uint8_t type);
+void trace_rec_heap(uint8_t type, const void *address, uint32_t size);
+void trace_rec_tick(uint32_t tick);
+void trace_rec_isr(uint8_t type);
+
+#if TRACE_REC_ENABLE
+
+#define TRACE_REC_ISR_ENTER()   trace_rec_isr(TRACE_REC_ISR_ENTER_ID)
+#define TRACE_REC_ISR_EXIT()    trace_rec_isr(TRACE_REC_ISR_EXIT_ID)
+
+/* Kernel hooks. These expand inside tasks.c, queue.c and the heap, where the
+ * TCB and queue structures are visible. */
+#define traceTASK_CREATE( pxNewTCB ) \
+    trace_rec_task_create( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->uxPriority, ( pxNewTCB )->pcTaskName )
+/* traceTASK_DELETE is defined by FreeRTOSConfig.h, which adds this to it. */
+#define TRACE_REC_TASK_DELETE_HOOK( pxTCB ) \
+    trace_rec_event( TRACE_REC_TASK_DELETE, 0, ( pxTCB )->uxTCBNumber )
+/* traceTASK_SWITCHED_IN likewise, with the benchmarks' switch count. */
+#define TRACE_REC_TASK_SWITCHED_IN_HOOK() \
+    trace_rec_event( TRACE_REC_TASK_IN, 0, pxCurrentTCB->uxTCBNumber )
+#define traceTASK_SWITCHED_OUT() \
+    trace_rec_event( TRACE_REC_TASK_OUT, 0, pxCurrentTCB->uxTCBNumber )
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB ) \
+    trace_rec_event( TRACE_REC_TASK_READY, 0, ( pxTCB )->uxTCBNumber )
+#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority ) \
+    trace_rec_event( TRACE_REC_MUTEX_INHERIT, ( uint8_t ) ( uxInheritedPriority ), ( pxTCBOfMutexHolder )->uxTCBNumber )
+#define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority ) \
+    trace_rec_event( TRACE_REC_MUTEX_DISINHERIT, ( uint8_t ) ( uxOriginalPriority ), ( pxTCBOfMutexHolder )->uxTCBNumber )
+#define traceTASK_INCREMENT_TICK( xTickCount ) \
+    trace_rec_tick( xTickCount )
+
+#define traceQUEUE_CREATE( pxNewQueue ) \
+    ( pxNewQueue )->uxQueueNumber = trace_rec_queue_create( ( pxNewQueue )->ucQueueType )
+#define traceQUEUE_DELETE( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_DELETE, 0, ( pxQueue )->uxQueueNumber )
+#define traceQUEUE_SEND( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_SEND, 0, ( pxQueue )->uxQueueNumber )
+#define traceQUEUE_SEND_FAILED( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_SEND_FAILED, 0, ( pxQueue )->uxQueueNumber )
+#define traceQUEUE_RECEIVE( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_RECEIVE, 0, ( pxQueue )->uxQueueNumber )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_RECEIVE_FAILED, 0, ( pxQueue )->uxQueueNumber )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_BLOCK_SEND, 0, ( pxQueue )->uxQueueNumber )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_BLOCK_RECEIVE, 0, ( pxQueue )->uxQueueNumber )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_SEND_ISR, 0, ( pxQueue )->uxQueueNumber )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue ) \
+    trace_rec_event( TRACE_REC_QUEUE_RECEIVE_ISR, 0, ( pxQueue )->uxQueueNumber )
+
+#define traceMALLOC( pvAddress, uiSize ) \
+    trace_rec_heap( TRACE_REC_MALLOC, ( pvAddress ), ( uint32_t ) ( uiSize ) )
+#define traceFREE( pvAddress, uiSize ) \
+    trace_rec_heap( TRACE_REC_FREE, ( pvAddress ), ( uint32_t ) ( uiSize ) )
+
+#else
+
+#define TRACE_REC_ISR_ENTER()
+#define TRACE_REC_ISR_EXIT()
+#define TRACE_REC_TASK_DELETE_HOOK( pxTCB )
+#define TRACE_REC_TASK_SWITCHED_IN_HOOK()
+
+#endif /* TRACE_REC_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_REC_H__ */
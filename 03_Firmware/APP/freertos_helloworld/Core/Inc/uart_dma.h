@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    uart_dma.h
+  * @brief   Interrupt driven DMA transport on USART1.
+  ******************************************************************************
+  * Receive runs continuously into a circular DMA buffer. Half transfer,
+  * transfer complete and idle line events move whatever arrived into a
+  * FreeRTOS stream buffer, so the CPU is involved once per burst, not once
+  * per byte.
+  *
+  * Transmit is double buffered: writers append to one half while DMA sends
+  * the other. Frames queued while a transfer is running are gathered into the
+  * idle half and go out back to back in the next single transfer.
+  *
+  * A source attached with uart_dma_set_source(), such as a log ring, is sent
+  * in place, without a copy, whenever both halves are empty. Its chunks and
+  * the halves go out as separate transfers, so data written while a source
+  * is active is interleaved with it at transfer boundaries.
+  *
+  * One task at a time reads, with either uart_dma_read() or
+  * uart_dma_read_frame(). Any number of tasks may write.
+  ******************************************************************************
+  */
+#ifndef __UART_DMA_H__
+#define __UART_DMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "uart_frame.h"
+
+/* Circular DMA receive buffer. An event fires every half of it, so it must
+ * hold what arrives during the longest interrupt latency, twice over. */
+#ifndef UART_DMA_RX_DMA_SIZE
+#define UART_DMA_RX_DMA_SIZE    256
+#endif
+
+/* Stream buffer between the receive interrupt and the reading task. */
+#ifndef UART_DMA_RX_BUFFER_SIZE
+#define UART_DMA_RX_BUFFER_SIZE 1024
+#endif
+
+/* Size of each of the two transmit halves, the longest single DMA transfer. */
+#ifndef UART_DMA_TX_BUFFER_SIZE
+#define UART_DMA_TX_BUFFER_SIZE 512
+#endif
+
+typedef struct
+{
+    uint32_t tx_bytes;          /* Bytes of completed DMA transfers */
+    uint32_t tx_transfers;      /* DMA transfers started */
+    uint32_t rx_bytes;          /* Bytes moved into the stream buffer */
+    uint32_t rx_events;         /* Half, complete and idle line events */
+    uint32_t rx_dropped;        /* Bytes lost because the stream buffer was full */
+    uint32_t errors;            /* Framing, noise, overrun and DMA errors */
+} uart_dma_stats_t;
+
+/* Data sent from its own memory. Both functions are called with the UART and
+ * DMA interrupts masked, from tasks and from the UART interrupt. claim hands
+ * out the next contiguous run of at most max bytes, 0 if there is none, and
+ * the run must stay in place until release. release reports how much of it
+ * left the UART: all of it, or 0 if the transfer could not be started. */
+typedef struct
+{
+    size_t (*claim)(const uint8_t **chunk, size_t max);
+    void (*release)(size_t len);
+} uart_dma_source_t;
+
+int uart_dma_init(uint32_t baudrate);
+
+size_t uart_dma_write(const void *data, size_t len, TickType_t timeout);
+int uart_dma_write_frame(const void *payload, size_t len, TickType_t timeout);
+int uart_dma_flush(TickType_t timeout);
+
+void uart_dma_set_source(const uart_dma_source_t *source);
+void uart_dma_kick(void);
+
+size_t uart_dma_read(void *buf, size_t len, TickType_t timeout);
+size_t uart_dma_read_frame(uart_frame_decoder_t *dec, TickType_t timeout);
+
+void uart_dma_get_stats(uart_dma_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_DMA_H__ */
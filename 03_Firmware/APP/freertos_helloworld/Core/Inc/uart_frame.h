@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    uart_frame.h
+  * @brief   SLIP (RFC 1055) framing for the DMA UART transport.
+  ******************************************************************************
+  * A frame is sent as END, the payload with END and ESC bytes escaped, END.
+  * The decoder takes the received byte stream in blocks of any size and hands
+  * back one frame at a time. Frames that do not fit the decoder buffer, or
+  * that hold an invalid escape, are dropped and counted.
+  *
+  * This file and uart_frame.c use only the C library, so the framing layer
+  * also builds on a host against a stub transport.
+  ******************************************************************************
+  */
+#ifndef __UART_FRAME_H__
+#define __UART_FRAME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define UART_FRAME_END          0xC0U
+#define UART_FRAME_ESC          0xDBU
+#define UART_FRAME_ESC_END      0xDCU
+#define UART_FRAME_ESC_ESC      0xDDU
+
+/* Encoded size of a payload of n bytes in the worst case, delimiters included. */
+#define UART_FRAME_MAX_ENCODED(n)   (2U * (n) + 2U)
+
+typedef struct
+{
+    uint8_t *buf;
+    size_t size;
+    size_t len;                 /* Payload bytes of the frame being received */
+    uint8_t escaped;            /* The previous byte was ESC */
+    uint8_t discard;            /* Drop bytes up to the next END */
+    uint32_t frames;            /* Frames delivered */
+    uint32_t dropped;           /* Frames dropped as too long or malformed */
+} uart_frame_decoder_t;
+
+void uart_frame_decoder_init(uart_frame_decoder_t *dec, void *buf, size_t size);
+
+size_t uart_frame_escape(uint8_t *dst, const uint8_t *src, size_t len);
+size_t uart_frame_encode(uint8_t *dst, size_t size, const uint8_t *src, size_t len);
+
+size_t uart_frame_feed(uart_frame_decoder_t *dec, const uint8_t *data, size_t len, size_t *frame_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_FRAME_H__ */
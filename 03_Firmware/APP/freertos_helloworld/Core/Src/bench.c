@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    bench.c
+  * @brief   Shared helpers for the on-target micro benchmarks.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+
+/* Counted by traceTASK_SWITCHED_IN (FreeRTOSConfig.h) */
+volatile uint32_t bench_switches;
+
+/**
+ * @brief  Enable the DWT cycle counter used as the benchmark time base.
+ */
+void bench_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void bench_stat_reset(bench_stat_t *stat)
+{
+    stat->min = UINT32_MAX;
+    stat->max = 0;
+    stat->sum = 0;
+    stat->count = 0;
+}
+
+void bench_stat_add(bench_stat_t *stat, uint32_t cycles)
+{
+    if (cycles < stat->min)
+    {
+        stat->min = cycles;
+    }
+    if (cycles > stat->max)
+    {
+        stat->max = cycles;
+    }
+    stat->sum += cycles;
+    stat->count++;
+}
+
+void bench_stat_report(const char *name, const bench_stat_t *stat)
+{
+    if (stat->count == 0)
+    {
+        log_w("%s: no samples", name);
+        return;
+    }
+
+    log_i("%s: n=%lu min=%lu avg=%lu max=%lu cycles", name,
+          (unsigned long)stat->count, (unsigned long)stat->min,
+          (unsigned long)(stat->sum / stat->count), (unsigned long)stat->max);
+}
+
+/**
+ * @brief  Run every enabled benchmark. Called once from the default task.
+ */
+void bench_run_all(void)
+{
+    bench_init();
+    log_i("core clock %lu Hz", (unsigned long)SystemCoreClock);
+
+#if APP_BENCH_SCHED
+    bench_sched_run();
+#endif
+#if APP_BENCH_HEAP
+    bench_heap_run();
+#endif
+#if APP_BENCH_MSGQ
+    bench_msgq_run();
+#endif
+#if APP_BENCH_MPOOL
+    bench_mpool_run();
+#endif
+#if APP_BENCH_ZCOPY
+    bench_zcopy_run();
+#endif
+#if APP_BENCH_TIMER
+    bench_timer_run();
+#endif
+#if APP_BENCH_SBUF
+    bench_sbuf_run();
+#endif
+#if APP_BENCH_BATCH
+    bench_batch_run();
+#endif
+#if APP_BENCH_UART
+    bench_uart_run();
+#endif
+#if APP_BENCH_TIME
+    bench_time_run();
+#endif
+#if APP_BENCH_TRACE
+    bench_trace_run();
+#endif
+#if APP_BENCH_MUTEX
+    bench_mutex_run();
+#endif
+#if APP_BENCH_CYCLIC
+    bench_cyclic_run();
+#endif
+#if APP_BENCH_DSP
+    bench_dsp_run();
+#endif
+}
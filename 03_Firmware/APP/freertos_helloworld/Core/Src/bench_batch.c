@@ -0,0 +1,234 @@
+/**
+  ******************************************************************************
+  * @file    bench_batch.c
+  * @brief   Batched wakeup benchmark. An interrupt fires a burst every tick
+  *          and posts one event per call, once to an osMessageQueue and once
+  *          to an osEventFlags object, for a consumer task that waits with
+  *          osWaitForever. Each is run with a wake threshold of 1 (wake on
+  *          every event) and of one burst with a wake latency
+  *          (freertos_os2_batch.h), counting consumer wakeups and context
+  *          switches per second. A final half burst checks that the latency
+  *          delivers a batch that never fills up.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "freertos_os2_batch.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_BATCH_BURST       8       /* Events per tick */
+#define BENCH_BATCH_ROUNDS      200     /* Ticks */
+#define BENCH_BATCH_LATENCY     5       /* Ticks, bounds the wait for a batch */
+#define BENCH_BATCH_FLAG        0x0001U
+#define BENCH_BATCH_STACK       (configMINIMAL_STACK_SIZE * 2)
+
+/* SPI3 is not used on this board; its vector is pended from software. The
+ * priority must be numerically at or above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define BENCH_BATCH_IRQn        SPI3_IRQn
+#define BENCH_BATCH_IRQHandler  SPI3_IRQHandler
+#define BENCH_BATCH_IRQ_PRIO    (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+
+static osMessageQueueId_t s_queue;
+static osEventFlagsId_t s_flags;
+static volatile uint32_t s_sent;
+static volatile uint32_t s_received;
+static volatile uint32_t s_wakeups;
+static bench_stat_t s_isr_post;
+
+void BENCH_BATCH_IRQHandler(void)
+{
+    uint32_t msg, t;
+
+    msg = s_sent;
+
+    t = bench_cycles();
+    if (s_queue != NULL)
+    {
+        osMessageQueuePut(s_queue, &msg, 0, 0);
+    }
+    else
+    {
+        osEventFlagsSet(s_flags, BENCH_BATCH_FLAG);
+    }
+    bench_stat_add(&s_isr_post, bench_cycles() - t);
+
+    s_sent = msg + 1;
+}
+
+/* Runs above the producer. Each return from a blocking call is one wakeup;
+ * whatever else is queued by then is drained without blocking. */
+static void bench_batch_consumer(void *argument)
+{
+    uint32_t msg;
+
+    (void)argument;
+
+    for (;;)
+    {
+        if (s_queue != NULL)
+        {
+            if (osMessageQueueGet(s_queue, &msg, NULL, osWaitForever) == osOK)
+            {
+                s_wakeups++;
+                s_received++;
+                while (osMessageQueueGet(s_queue, &msg, NULL, 0) == osOK)
+                {
+                    s_received++;
+                }
+            }
+        }
+        else
+        {
+            if ((osEventFlagsWait(s_flags, BENCH_BATCH_FLAG, osFlagsWaitAny,
+                                  osWaitForever) & osFlagsError) == 0U)
+            {
+                s_wakeups++;
+            }
+        }
+    }
+}
+
+static void bench_batch_fire(uint32_t events)
+{
+    uint32_t i;
+
+    /* The interrupt preempts this task, so each pend is taken at once */
+    for (i = 0; i < events; i++)
+    {
+        NVIC_SetPendingIRQ(BENCH_BATCH_IRQn);
+    }
+}
+
+/**
+ * @brief  Fire a burst every tick with the given wake threshold and latency.
+ * @retval 0 on success, -1 if the object or consumer could not be set up.
+ */
+static int bench_batch_burst(const char *name, uint32_t threshold, uint32_t latency)
+{
+    TaskHandle_t consumer;
+    osStatus_t status;
+    uint32_t r, t, switches, sent, wakeups;
+    int delivered;
+
+    if (s_queue != NULL)
+    {
+        status = osMessageQueueSetWakeThreshold(s_queue, threshold, latency);
+    }
+    else
+    {
+        status = osEventFlagsSetWakeThreshold(s_flags, threshold, latency);
+    }
+    if ((status != osOK) && (threshold != 1))
+    {
+        return -1;
+    }
+
+    if (xTaskCreate(bench_batch_consumer, "bbatch", BENCH_BATCH_STACK, NULL,
+                    uxTaskPriorityGet(NULL) + 1, &consumer) != pdPASS)
+    {
+        return -1;
+    }
+
+    s_sent = 0;
+    s_received = 0;
+    s_wakeups = 0;
+    bench_stat_reset(&s_isr_post);
+
+    /* Start on a tick. The switches counted include this task's own wakeup
+     * every tick, which is the same for each threshold. */
+    osDelay(1);
+    switches = bench_switches;
+    t = bench_cycles();
+    for (r = 0; r < BENCH_BATCH_ROUNDS; r++)
+    {
+        bench_batch_fire(BENCH_BATCH_BURST);
+        osDelay(1);
+    }
+    t = bench_cycles() - t;
+    switches = bench_switches - switches;
+    sent = s_sent;
+    wakeups = s_wakeups;
+
+    /* Half a burst stays below the threshold; only the latency wakes the
+     * consumer for it */
+    bench_batch_fire(BENCH_BATCH_BURST / 2);
+    osDelay(BENCH_BATCH_LATENCY + 2);
+    if (s_queue != NULL)
+    {
+        delivered = (s_received == s_sent);
+    }
+    else
+    {
+        delivered = ((osEventFlagsGet(s_flags) & BENCH_BATCH_FLAG) == 0U);
+    }
+
+    vTaskDelete(consumer);
+
+    log_i("%s, threshold %lu: %lu consumer wakeups for %lu events, %lu context switches/s",
+          name, (unsigned long)threshold, (unsigned long)wakeups, (unsigned long)sent,
+          (unsigned long)(((uint64_t)switches * SystemCoreClock) / t));
+    bench_stat_report(threshold == 1 ? "batch isr post, threshold 1" : "batch isr post, threshold burst", &s_isr_post);
+    if (!delivered)
+    {
+        log_w("%s, threshold %lu: partial batch not delivered after %u ticks", name,
+              (unsigned long)threshold, BENCH_BATCH_LATENCY + 2);
+    }
+
+    return 0;
+}
+
+void bench_batch_run(void)
+{
+    uint32_t i, threshold, latency;
+
+    NVIC_SetPriority(BENCH_BATCH_IRQn, BENCH_BATCH_IRQ_PRIO);
+    NVIC_EnableIRQ(BENCH_BATCH_IRQn);
+
+    s_flags = NULL;
+    s_queue = osMessageQueueNew(BENCH_BATCH_BURST * 2, sizeof(uint32_t), NULL);
+    if (s_queue == NULL)
+    {
+        log_w("batch: no memory");
+    }
+    else
+    {
+        for (i = 0; i < 2; i++)
+        {
+            threshold = (i == 0) ? 1 : BENCH_BATCH_BURST;
+            latency = (i == 0) ? osWaitForever : BENCH_BATCH_LATENCY;
+            if (bench_batch_burst("batch msgq", threshold, latency) != 0)
+            {
+                log_w("batch: msgq setup failed");
+                break;
+            }
+        }
+        osMessageQueueDelete(s_queue);
+        s_queue = NULL;
+    }
+
+    s_flags = osEventFlagsNew(NULL);
+    if (s_flags == NULL)
+    {
+        log_w("batch: no memory");
+    }
+    else
+    {
+        for (i = 0; i < 2; i++)
+        {
+            threshold = (i == 0) ? 1 : BENCH_BATCH_BURST;
+            latency = (i == 0) ? osWaitForever : BENCH_BATCH_LATENCY;
+            if (bench_batch_burst("batch flags", threshold, latency) != 0)
+            {
+                log_w("batch: flags setup failed");
+                break;
+            }
+        }
+        osEventFlagsDelete(s_flags);
+    }
+
+    NVIC_DisableIRQ(BENCH_BATCH_IRQn);
+}
@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file    bench_dsp.c
+  * @brief   CMSIS-DSP kernel sweep on the target (dsp_bench.h). Prints the
+  *          cycle counts of every kernel from 16 to APP_BENCH_DSP_MAX_BLOCK
+  *          samples as CSV, or JSON with APP_BENCH_DSP_JSON, on the log port,
+  *          then the FIR crossover up to APP_BENCH_DSP_CROSSOVER_TAPS taps
+  *          and, with APP_BENCH_DSP_RESAMPLE, the sample rate converters.
+  ******************************************************************************
+  * The project does not link CMSIS-DSP yet. To enable the sweep add
+  * Drivers/CMSIS/DSP/Include to the include path, define ARM_MATH_CM4 and
+  * __FPU_PRESENT=1, add the sources under Drivers/CMSIS/DSP/Source to the
+  * project (Drivers/CMSIS/Lib has prebuilt libraries for GCC and IAR only)
+  * and set APP_BENCH_DSP to 1.
+  *
+  * Task switches are held off around each timed call; interrupts still run,
+  * which the minimum of the repeats filters out.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+
+#if APP_BENCH_DSP
+
+#ifndef ARM_MATH_CM4
+#error "APP_BENCH_DSP needs CMSIS-DSP: define ARM_MATH_CM4 and link the DSP library, see bench_dsp.c"
+#endif
+
+#include "dsp_bench.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef APP_BENCH_DSP_MAX_BLOCK
+#define APP_BENCH_DSP_MAX_BLOCK 512
+#endif
+
+#ifndef APP_BENCH_DSP_REPEAT
+#define APP_BENCH_DSP_REPEAT    10
+#endif
+
+#ifndef APP_BENCH_DSP_JSON
+#define APP_BENCH_DSP_JSON      0
+#endif
+
+/* arm_fir_f32 against dsp_ols_fir_f32 on APP_BENCH_DSP_MAX_BLOCK samples;
+   0 skips it and its larger arena */
+#ifndef APP_BENCH_DSP_CROSSOVER_TAPS
+#define APP_BENCH_DSP_CROSSOVER_TAPS    1024
+#endif
+
+/* The sample rate converters against the naive chain, in the same arena:
+   those that do not fit are skipped */
+#ifndef APP_BENCH_DSP_RESAMPLE
+#define APP_BENCH_DSP_RESAMPLE  1
+#endif
+
+#define BENCH_DSP_STR_(x)       #x
+#define BENCH_DSP_STR(x)        BENCH_DSP_STR_(x)
+
+#if defined(__ARMCC_VERSION) && defined(__OPTIMISE_LEVEL)
+#define BENCH_DSP_BUILD         "armcc " BENCH_DSP_STR(__ARMCC_VERSION) " -O" BENCH_DSP_STR(__OPTIMISE_LEVEL)
+#elif defined(__ARMCC_VERSION)
+#define BENCH_DSP_BUILD         "armclang " BENCH_DSP_STR(__ARMCC_VERSION)
+#elif defined(__GNUC__)
+#define BENCH_DSP_BUILD         "gcc " __VERSION__
+#else
+#define BENCH_DSP_BUILD         "unknown"
+#endif
+
+#define BENCH_DSP_MAX(a, b)     (((a) > (b)) ? (a) : (b))
+#define BENCH_DSP_ARENA_SIZE    BENCH_DSP_MAX(DSP_BENCH_ARENA_SIZE(APP_BENCH_DSP_MAX_BLOCK), \
+                                              DSP_BENCH_CROSSOVER_ARENA_SIZE(APP_BENCH_DSP_MAX_BLOCK, \
+                                                                             APP_BENCH_DSP_CROSSOVER_TAPS))
+
+static uint64_t s_arena[(BENCH_DSP_ARENA_SIZE + sizeof(uint64_t) - 1U) / sizeof(uint64_t)];
+
+static uint32_t bench_dsp_cycles(void)
+{
+    return bench_cycles();
+}
+
+static void bench_dsp_write(const char *line)
+{
+    elog_raw("%s\r\n", line);
+}
+
+static void bench_dsp_enter(void)
+{
+    vTaskSuspendAll();
+}
+
+static void bench_dsp_leave(void)
+{
+    (void)xTaskResumeAll();
+}
+
+void bench_dsp_run(void)
+{
+    dsp_bench_port_t port = {
+        .cycles = bench_dsp_cycles,
+        .hz = 0,
+        .clock = "dwt",
+        .build = BENCH_DSP_BUILD,
+        .write = bench_dsp_write,
+        .enter = bench_dsp_enter,
+        .leave = bench_dsp_leave,
+        .arena = s_arena,
+        .min_block = DSP_BENCH_MIN_BLOCK,
+        .max_block = APP_BENCH_DSP_MAX_BLOCK,
+        .repeat = APP_BENCH_DSP_REPEAT,
+        .format = APP_BENCH_DSP_JSON ? DSP_BENCH_JSON : DSP_BENCH_CSV,
+        .filter = NULL,
+    };
+    int points;
+
+    port.hz = SystemCoreClock;
+    points = dsp_bench_run(&port);
+    log_i("dsp: %d points", points);
+#if APP_BENCH_DSP_CROSSOVER_TAPS
+    points = dsp_bench_fir_crossover(&port, APP_BENCH_DSP_CROSSOVER_TAPS);
+    log_i("dsp fir crossover: %d points", points);
+#endif
+#if APP_BENCH_DSP_RESAMPLE
+    points = dsp_bench_resample(&port, (uint32_t)sizeof(s_arena));
+    log_i("dsp resample: %d points", points);
+#endif
+}
+
+#endif /* APP_BENCH_DSP */
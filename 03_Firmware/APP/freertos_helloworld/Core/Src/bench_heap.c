@@ -0,0 +1,156 @@
+/**
+  ******************************************************************************
+  * @file    bench_heap.c
+  * @brief   Heap allocator benchmark. Replays an allocation trace through
+  *          pvPortMalloc/vPortFree and reports the worst case latency and the
+  *          fragmentation left behind. Build once with configUSE_HEAP_TLSF 0
+  *          (heap_4.c) and once with 1 (heap_tlsf.c) to compare them.
+  ******************************************************************************
+  * The trace is bench_heap_trace.h. heap_replay in rtos_host replays it, or a
+  * trace_rec capture, through both heaps on the host in one run.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "bench_heap_trace.h"
+#include "elog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_arena.h"
+
+#define BENCH_HEAP_ARENA_SIZE   1024
+#define BENCH_HEAP_ARENA_CYCLES 100
+
+static void *s_slot[BENCH_HEAP_SLOTS];
+static bench_stat_t s_malloc;
+static bench_stat_t s_free;
+static uint32_t s_failed;
+
+static void bench_heap_step(uint32_t slot, uint32_t size)
+{
+    uint32_t t;
+
+    if (s_slot[slot] != NULL)
+    {
+        t = bench_cycles();
+        vPortFree(s_slot[slot]);
+        bench_stat_add(&s_free, bench_cycles() - t);
+        s_slot[slot] = NULL;
+    }
+
+    if (size != 0)
+    {
+        t = bench_cycles();
+        s_slot[slot] = pvPortMalloc(size);
+        bench_stat_add(&s_malloc, bench_cycles() - t);
+
+        if (s_slot[slot] == NULL)
+        {
+            s_failed++;
+        }
+    }
+}
+
+static void bench_heap_report_frag(const char *phase)
+{
+    HeapStats_t stats;
+    uint32_t frag;
+
+    vPortGetHeapStats(&stats);
+
+    /* Share of the free space that is not in the largest block, in per mille. */
+    frag = 0;
+    if (stats.xAvailableHeapSpaceInBytes != 0)
+    {
+        frag = 1000 - (uint32_t)(((uint64_t)stats.xSizeOfLargestFreeBlockInBytes * 1000) /
+                                 stats.xAvailableHeapSpaceInBytes);
+    }
+
+    log_i("heap %s: free=%lu largest=%lu blocks=%lu frag=%lu/1000 failed=%lu", phase,
+          (unsigned long)stats.xAvailableHeapSpaceInBytes,
+          (unsigned long)stats.xSizeOfLargestFreeBlockInBytes,
+          (unsigned long)stats.xNumberOfFreeBlocks, (unsigned long)frag,
+          (unsigned long)s_failed);
+}
+
+/* Per-cycle scratch buffers from a task arena against the same buffers from
+ * the shared heap, which suspends the scheduler on every call. */
+static void bench_heap_arena(void)
+{
+    task_arena_t arena;
+    bench_stat_t heap_cycle;
+    bench_stat_t arena_cycle;
+    void *buf[4];
+    uint32_t i, j, t;
+
+    bench_stat_reset(&heap_cycle);
+    bench_stat_reset(&arena_cycle);
+
+    if (task_arena_create(&arena, BENCH_HEAP_ARENA_SIZE) != pdPASS)
+    {
+        log_w("heap arena: no memory");
+        return;
+    }
+
+    for (i = 0; i < BENCH_HEAP_ARENA_CYCLES; i++)
+    {
+        t = bench_cycles();
+        for (j = 0; j < 4; j++)
+        {
+            buf[j] = pvPortMalloc(64 << j);
+        }
+        for (j = 0; j < 4; j++)
+        {
+            vPortFree(buf[j]);
+        }
+        bench_stat_add(&heap_cycle, bench_cycles() - t);
+
+        t = bench_cycles();
+        for (j = 0; j < 4; j++)
+        {
+            buf[j] = task_arena_alloc(64 << j);
+        }
+        task_arena_reset(&arena);
+        bench_stat_add(&arena_cycle, bench_cycles() - t);
+    }
+
+    bench_stat_report("heap 4 buffers/cycle", &heap_cycle);
+    bench_stat_report("arena 4 buffers/cycle", &arena_cycle);
+    task_arena_report();
+    task_arena_destroy(&arena);
+}
+
+void bench_heap_run(void)
+{
+    uint32_t i;
+    uint32_t seed = BENCH_HEAP_CHURN_SEED;
+    bench_heap_op_t op;
+
+    bench_stat_reset(&s_malloc);
+    bench_stat_reset(&s_free);
+    s_failed = 0;
+
+    for (i = 0; i < sizeof(s_bench_heap_trace) / sizeof(s_bench_heap_trace[0]); i++)
+    {
+        bench_heap_step(s_bench_heap_trace[i].slot, s_bench_heap_trace[i].size);
+    }
+    bench_heap_report_frag("trace");
+
+    for (i = 0; i < BENCH_HEAP_CHURN; i++)
+    {
+        op = bench_heap_churn_step(&seed);
+        bench_heap_step(op.slot, op.size);
+    }
+    bench_heap_report_frag("churn");
+
+    bench_stat_report("heap malloc", &s_malloc);
+    bench_stat_report("heap free", &s_free);
+
+    for (i = 0; i < BENCH_HEAP_SLOTS; i++)
+    {
+        bench_heap_step(i, 0);
+    }
+
+    bench_heap_arena();
+}
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    bench_mpool.c
+  * @brief   Memory pool benchmark. Blocks are passed between an interrupt and
+  *          a task in both directions, as a packet buffer pool is used, and
+  *          the cost of each osMemoryPoolAlloc/osMemoryPoolFree is recorded.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_MPOOL_BLOCKS      8
+#define BENCH_MPOOL_BLOCK_SIZE  64
+#define BENCH_MPOOL_ROUNDS      1000
+
+/* SPI5 is not used on this board; its vector is pended from software. The
+ * priority must be numerically at or above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define BENCH_MPOOL_IRQn        SPI5_IRQn
+#define BENCH_MPOOL_IRQHandler  SPI5_IRQHandler
+#define BENCH_MPOOL_IRQ_PRIO    (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+
+static osMemoryPoolId_t s_pool;
+static TaskHandle_t s_owner;
+static void *volatile s_block;
+static volatile uint32_t s_isr_frees;
+static bench_stat_t s_task_alloc;
+static bench_stat_t s_task_free;
+static bench_stat_t s_isr_alloc;
+static bench_stat_t s_isr_free;
+
+void BENCH_MPOOL_IRQHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+    uint32_t t;
+
+    t = bench_cycles();
+    if (s_isr_frees)
+    {
+        /* Task -> ISR: give back the block the task allocated. */
+        osMemoryPoolFree(s_pool, s_block);
+        bench_stat_add(&s_isr_free, bench_cycles() - t);
+        s_block = NULL;
+    }
+    else
+    {
+        /* ISR -> task: allocate a block for the task to consume. */
+        s_block = osMemoryPoolAlloc(s_pool, 0);
+        bench_stat_add(&s_isr_alloc, bench_cycles() - t);
+    }
+
+    vTaskNotifyGiveFromISR(s_owner, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void bench_mpool_run(void)
+{
+    uint32_t i, t;
+
+    bench_stat_reset(&s_task_alloc);
+    bench_stat_reset(&s_task_free);
+    bench_stat_reset(&s_isr_alloc);
+    bench_stat_reset(&s_isr_free);
+    s_owner = xTaskGetCurrentTaskHandle();
+
+    s_pool = osMemoryPoolNew(BENCH_MPOOL_BLOCKS, BENCH_MPOOL_BLOCK_SIZE, NULL);
+    if (s_pool == NULL)
+    {
+        log_w("mpool: no memory");
+        return;
+    }
+
+    NVIC_SetPriority(BENCH_MPOOL_IRQn, BENCH_MPOOL_IRQ_PRIO);
+    NVIC_EnableIRQ(BENCH_MPOOL_IRQn);
+
+    for (i = 0; i < BENCH_MPOOL_ROUNDS; i++)
+    {
+        /* ISR allocates, task frees. */
+        s_isr_frees = 0;
+        NVIC_SetPendingIRQ(BENCH_MPOOL_IRQn);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        t = bench_cycles();
+        osMemoryPoolFree(s_pool, s_block);
+        bench_stat_add(&s_task_free, bench_cycles() - t);
+
+        /* Task allocates, ISR frees. */
+        t = bench_cycles();
+        s_block = osMemoryPoolAlloc(s_pool, 0);
+        bench_stat_add(&s_task_alloc, bench_cycles() - t);
+
+        s_isr_frees = 1;
+        NVIC_SetPendingIRQ(BENCH_MPOOL_IRQn);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    NVIC_DisableIRQ(BENCH_MPOOL_IRQn);
+    osMemoryPoolDelete(s_pool);
+
+    bench_stat_report("mpool task alloc", &s_task_alloc);
+    bench_stat_report("mpool task free", &s_task_free);
+    bench_stat_report("mpool isr alloc", &s_isr_alloc);
+    bench_stat_report("mpool isr free", &s_isr_free);
+}
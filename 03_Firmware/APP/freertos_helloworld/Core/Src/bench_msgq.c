@@ -0,0 +1,116 @@
+/**
+  ******************************************************************************
+  * @file    bench_msgq.c
+  * @brief   Message queue priority benchmark. Measures how long an urgent
+  *          message takes to reach a consumer that is behind a queue full of
+  *          bulk data. Build once with configUSE_OS2_MSGQUEUE_PRIO set to 0
+  *          (FIFO) and once with 1 to compare.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_MSGQ_DEPTH        16
+#define BENCH_MSGQ_ROUNDS       100
+#define BENCH_MSGQ_WORK         200     /* Busy loop per message, in iterations */
+#define BENCH_MSGQ_STACK        (configMINIMAL_STACK_SIZE * 2)
+
+#define BENCH_MSGQ_PRIO_BULK    0
+#define BENCH_MSGQ_PRIO_URGENT  255
+
+typedef struct
+{
+    uint32_t stamp;
+    uint32_t urgent;
+} bench_msgq_msg_t;
+
+static osMessageQueueId_t s_queue;
+static TaskHandle_t s_owner;
+static bench_stat_t s_latency;
+static bench_stat_t s_position;
+
+static void bench_msgq_consumer(void *argument)
+{
+    bench_msgq_msg_t msg;
+    uint32_t i, pos;
+    volatile uint32_t work;
+
+    (void)argument;
+
+    for (;;)
+    {
+        /* Drain one saturated queue per round, simulating per message work. */
+        for (pos = 0; pos < BENCH_MSGQ_DEPTH; pos++)
+        {
+            osMessageQueueGet(s_queue, &msg, NULL, osWaitForever);
+
+            if (msg.urgent)
+            {
+                bench_stat_add(&s_latency, bench_cycles() - msg.stamp);
+                bench_stat_add(&s_position, pos);
+            }
+
+            for (i = 0, work = 0; i < BENCH_MSGQ_WORK; i++)
+            {
+                work += i;
+            }
+        }
+
+        xTaskNotifyGive(s_owner);
+    }
+}
+
+void bench_msgq_run(void)
+{
+    TaskHandle_t consumer;
+    bench_msgq_msg_t msg;
+    uint32_t i, r;
+
+    bench_stat_reset(&s_latency);
+    bench_stat_reset(&s_position);
+    s_owner = xTaskGetCurrentTaskHandle();
+
+    s_queue = osMessageQueueNew(BENCH_MSGQ_DEPTH, sizeof(bench_msgq_msg_t), NULL);
+    if (s_queue == NULL)
+    {
+        log_w("msgq: no memory");
+        return;
+    }
+
+    /* The consumer sits below this task, so the queue fills up completely
+     * before it gets to run. */
+    if (xTaskCreate(bench_msgq_consumer, "bmsgq", BENCH_MSGQ_STACK, NULL,
+                    tskIDLE_PRIORITY + 1, &consumer) != pdPASS)
+    {
+        osMessageQueueDelete(s_queue);
+        log_w("msgq: no memory");
+        return;
+    }
+
+    for (r = 0; r < BENCH_MSGQ_ROUNDS; r++)
+    {
+        msg.urgent = 0;
+        for (i = 0; i < BENCH_MSGQ_DEPTH - 1; i++)
+        {
+            msg.stamp = bench_cycles();
+            osMessageQueuePut(s_queue, &msg, BENCH_MSGQ_PRIO_BULK, 0);
+        }
+
+        msg.urgent = 1;
+        msg.stamp = bench_cycles();
+        osMessageQueuePut(s_queue, &msg, BENCH_MSGQ_PRIO_URGENT, 0);
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    vTaskDelete(consumer);
+    osMessageQueueDelete(s_queue);
+
+    bench_stat_report("msgq urgent latency", &s_latency);
+    bench_stat_report("msgq urgent position", &s_position);
+}
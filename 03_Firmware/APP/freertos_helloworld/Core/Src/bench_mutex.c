@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    bench_mutex.c
+  * @brief   Mutex profiler benchmark. Times an uncontended osMutexAcquire and
+  *          osMutexRelease pair against a plain FreeRTOS mutex, then has a
+  *          lower priority task hold the mutex while this task waits for it,
+  *          so that every round is contended and inherits priority, and
+  *          prints the profile (mutex_prof.h).
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "mutex_prof.h"
+#include "cmsis_os2.h"
+#include "freertos_os2_mprof.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#define BENCH_MUTEX_ROUNDS      1000
+#define BENCH_MUTEX_CONTENDED   20
+#define BENCH_MUTEX_HOLD        20000   /* Cycles the holder keeps the mutex */
+#define BENCH_MUTEX_TIMEOUT     100     /* Ticks */
+#define BENCH_MUTEX_STACK       (configMINIMAL_STACK_SIZE * 2)
+
+static osMutexId_t s_mutex;
+static osSemaphoreId_t s_go;
+static osSemaphoreId_t s_held;
+
+/* Runs below the benchmark task. Takes the mutex on every go, signals that
+ * it holds it, which lets the benchmark task preempt and block on the mutex,
+ * and keeps it BENCH_MUTEX_HOLD cycles at the inherited priority. */
+static void bench_mutex_holder(void *argument)
+{
+    uint32_t t;
+
+    (void)argument;
+
+    for (;;)
+    {
+        osSemaphoreAcquire(s_go, osWaitForever);
+        osMutexAcquire(s_mutex, osWaitForever);
+        osSemaphoreRelease(s_held);
+
+        t = bench_cycles();
+        while ((bench_cycles() - t) < BENCH_MUTEX_HOLD)
+        {
+        }
+
+        osMutexRelease(s_mutex);
+    }
+}
+
+/* Uncontended cost: a plain FreeRTOS mutex against a profiled osMutex */
+static void bench_mutex_uncontended(SemaphoreHandle_t plain, bench_stat_t *raw, bench_stat_t *prof)
+{
+    uint32_t i, t;
+
+    for (i = 0; i < BENCH_MUTEX_ROUNDS; i++)
+    {
+        t = bench_cycles();
+        xSemaphoreTake(plain, 0);
+        xSemaphoreGive(plain);
+        bench_stat_add(raw, bench_cycles() - t);
+
+        t = bench_cycles();
+        osMutexAcquire(s_mutex, 0);
+        osMutexRelease(s_mutex);
+        bench_stat_add(prof, bench_cycles() - t);
+    }
+}
+
+static void bench_mutex_contended(bench_stat_t *wait)
+{
+    TaskHandle_t holder;
+    uint32_t i, t;
+
+    if (xTaskCreate(bench_mutex_holder, "mholder", BENCH_MUTEX_STACK, NULL,
+                    uxTaskPriorityGet(NULL) - 1, &holder) != pdPASS)
+    {
+        log_e("mutex: no memory for holder task");
+        return;
+    }
+
+    for (i = 0; i < BENCH_MUTEX_CONTENDED; i++)
+    {
+        osSemaphoreRelease(s_go);
+        if (osSemaphoreAcquire(s_held, BENCH_MUTEX_TIMEOUT) != osOK)
+        {
+            break;
+        }
+
+        t = bench_cycles();
+        if (osMutexAcquire(s_mutex, BENCH_MUTEX_TIMEOUT) != osOK)
+        {
+            break;
+        }
+        bench_stat_add(wait, bench_cycles() - t);
+        osMutexRelease(s_mutex);
+    }
+
+    vTaskDelete(holder);
+}
+
+/**
+ * @brief  Measure the profiler's uncontended overhead and profile a run of
+ *         contended, inheriting acquisitions.
+ */
+void bench_mutex_run(void)
+{
+    const osMutexAttr_t attr = { "bench", 0, NULL, 0 };
+    bench_stat_t raw, prof, wait;
+    SemaphoreHandle_t plain;
+
+    bench_stat_reset(&raw);
+    bench_stat_reset(&prof);
+    bench_stat_reset(&wait);
+
+    s_mutex = osMutexNew(&attr);
+    s_go = osSemaphoreNew(1, 0, NULL);
+    s_held = osSemaphoreNew(1, 0, NULL);
+    plain = xSemaphoreCreateMutex();
+
+    if ((s_mutex != NULL) && (s_go != NULL) && (s_held != NULL) && (plain != NULL))
+    {
+        bench_mutex_uncontended(plain, &raw, &prof);
+
+        /* The uncontended rounds are profiled too; start the contended run
+         * from zero. */
+        osMutexProfileReset();
+        bench_mutex_contended(&wait);
+
+        bench_stat_report("xSemaphoreTake+Give, plain mutex", &raw);
+        bench_stat_report("osMutexAcquire+Release, profiled", &prof);
+        bench_stat_report("osMutexAcquire, contended", &wait);
+        mutex_prof_log();
+    }
+    else
+    {
+        log_w("mutex: no memory");
+    }
+
+    if (plain != NULL)
+    {
+        vSemaphoreDelete(plain);
+    }
+    if (s_held != NULL)
+    {
+        osSemaphoreDelete(s_held);
+    }
+    if (s_go != NULL)
+    {
+        osSemaphoreDelete(s_go);
+    }
+    if (s_mutex != NULL)
+    {
+        osMutexDelete(s_mutex);
+    }
+}
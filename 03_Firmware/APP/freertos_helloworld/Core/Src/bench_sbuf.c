@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    bench_sbuf.c
+  * @brief   Stream buffer benchmark with two producers, a task and an
+  *          interrupt, feeding one consumer task. Compares a plain stream
+  *          buffer whose writers take a critical section around every send
+  *          with a multi-producer stream buffer written without one.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+
+#define BENCH_SBUF_SIZE         512
+#define BENCH_SBUF_TRIGGER      64      /* Consumer wakes every 4 records */
+#define BENCH_SBUF_RECORD       16
+#define BENCH_SBUF_ROUNDS       1000    /* One task and one ISR record each */
+#define BENCH_SBUF_STACK        (configMINIMAL_STACK_SIZE * 2)
+
+/* SPI4 is not used on this board; its vector is pended from software. The
+ * priority must be numerically at or above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define BENCH_SBUF_IRQn         SPI4_IRQn
+#define BENCH_SBUF_IRQHandler   SPI4_IRQHandler
+#define BENCH_SBUF_IRQ_PRIO     (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+
+static StreamBufferHandle_t s_sbuf;
+static TaskHandle_t s_owner;
+static volatile uint32_t s_locked;
+static volatile uint32_t s_wakeups;
+static volatile uint32_t s_received;
+static bench_stat_t s_task_send;
+static bench_stat_t s_isr_send;
+
+void BENCH_SBUF_IRQHandler(void)
+{
+    uint8_t record[BENCH_SBUF_RECORD] = {0};
+    BaseType_t woken = pdFALSE;
+    UBaseType_t mask;
+    uint32_t t;
+
+    t = bench_cycles();
+    if (s_locked)
+    {
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        xStreamBufferSendFromISR(s_sbuf, record, sizeof(record), &woken);
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+    }
+    else
+    {
+        xStreamBufferSendFromISR(s_sbuf, record, sizeof(record), &woken);
+    }
+    bench_stat_add(&s_isr_send, bench_cycles() - t);
+
+    portYIELD_FROM_ISR(woken);
+}
+
+/* Runs above the producers and wakes each time the trigger level is reached. */
+static void bench_sbuf_consumer(void *argument)
+{
+    uint8_t data[BENCH_SBUF_TRIGGER];
+
+    (void)argument;
+
+    for (;;)
+    {
+        s_received += xStreamBufferReceive(s_sbuf, data, sizeof(data), portMAX_DELAY);
+        s_wakeups++;
+
+        if (s_received >= 2 * BENCH_SBUF_ROUNDS * BENCH_SBUF_RECORD)
+        {
+            xTaskNotifyGive(s_owner);
+        }
+    }
+}
+
+static int bench_sbuf_produce(uint32_t locked)
+{
+    uint8_t record[BENCH_SBUF_RECORD] = {0};
+    TaskHandle_t consumer;
+    uint32_t i, t;
+
+    if (locked)
+    {
+        s_sbuf = xStreamBufferCreate(BENCH_SBUF_SIZE, BENCH_SBUF_TRIGGER);
+    }
+    else
+    {
+        s_sbuf = xStreamBufferCreateMultiProducer(BENCH_SBUF_SIZE, BENCH_SBUF_TRIGGER);
+    }
+    if (s_sbuf == NULL)
+    {
+        return -1;
+    }
+
+    if (xTaskCreate(bench_sbuf_consumer, "bsbuf", BENCH_SBUF_STACK, NULL,
+                    uxTaskPriorityGet(NULL) + 1, &consumer) != pdPASS)
+    {
+        vStreamBufferDelete(s_sbuf);
+        return -1;
+    }
+
+    s_locked = locked;
+    s_wakeups = 0;
+    s_received = 0;
+    bench_stat_reset(&s_task_send);
+    bench_stat_reset(&s_isr_send);
+
+    for (i = 0; i < BENCH_SBUF_ROUNDS; i++)
+    {
+        t = bench_cycles();
+        if (locked)
+        {
+            taskENTER_CRITICAL();
+            xStreamBufferSend(s_sbuf, record, sizeof(record), 0);
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            xStreamBufferSend(s_sbuf, record, sizeof(record), 0);
+        }
+        bench_stat_add(&s_task_send, bench_cycles() - t);
+
+        NVIC_SetPendingIRQ(BENCH_SBUF_IRQn);
+    }
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    vTaskDelete(consumer);
+    vStreamBufferDelete(s_sbuf);
+
+    return 0;
+}
+
+void bench_sbuf_run(void)
+{
+    uint32_t i, locked;
+
+    s_owner = xTaskGetCurrentTaskHandle();
+
+    NVIC_SetPriority(BENCH_SBUF_IRQn, BENCH_SBUF_IRQ_PRIO);
+    NVIC_EnableIRQ(BENCH_SBUF_IRQn);
+
+    for (i = 0; i < 2; i++)
+    {
+        locked = (i == 0);
+        if (bench_sbuf_produce(locked) != 0)
+        {
+            log_w("sbuf: no memory");
+            break;
+        }
+
+        bench_stat_report(locked ? "sbuf task send, locked" : "sbuf task send, multi-producer", &s_task_send);
+        bench_stat_report(locked ? "sbuf isr send, locked" : "sbuf isr send, multi-producer", &s_isr_send);
+        log_i("sbuf consumer wakeups: %lu for %lu records", (unsigned long)s_wakeups,
+              (unsigned long)(2 * BENCH_SBUF_ROUNDS));
+    }
+
+    NVIC_DisableIRQ(BENCH_SBUF_IRQn);
+}
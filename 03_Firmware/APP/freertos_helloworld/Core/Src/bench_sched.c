@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file    bench_sched.c
+  * @brief   Context switch latency benchmark. Compares the generic ready list
+  *          scan against the bit map task selection; build once with
+  *          configUSE_PORT_OPTIMISED_TASK_SELECTION set to 0 and once with 1.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_SCHED_ROUNDS      1000
+#define BENCH_SCHED_STACK       (configMINIMAL_STACK_SIZE * 2)
+
+/* The ping task sits just above idle and the pong task at the top priority, so
+ * every switch back down makes the generic selection walk all the empty ready
+ * lists in between - its worst case with the 56 CMSIS-RTOS2 priorities. */
+#define BENCH_SCHED_PING_PRIO   (tskIDLE_PRIORITY + 1)
+#define BENCH_SCHED_PONG_PRIO   (configMAX_PRIORITIES - 1)
+
+static TaskHandle_t s_owner;
+static TaskHandle_t s_pong;
+static volatile uint32_t s_stamp;
+static bench_stat_t s_up;
+static bench_stat_t s_down;
+
+static void bench_sched_pong(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+        s_stamp = bench_cycles();
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bench_stat_add(&s_up, bench_cycles() - s_stamp);
+    }
+}
+
+static void bench_sched_ping(void *argument)
+{
+    uint32_t i;
+
+    (void)argument;
+
+    for (i = 0; i < BENCH_SCHED_ROUNDS; i++)
+    {
+        /* Wakes the pong task, which preempts immediately (low -> high) and
+         * blocks again (high -> low) before control comes back here. */
+        s_stamp = bench_cycles();
+        xTaskNotifyGive(s_pong);
+        bench_stat_add(&s_down, bench_cycles() - s_stamp);
+    }
+
+    xTaskNotifyGive(s_owner);
+    vTaskSuspend(NULL);
+}
+
+/**
+ * @brief  Measure task-to-task switch latency in both priority directions.
+ */
+void bench_sched_run(void)
+{
+    TaskHandle_t ping = NULL;
+
+    bench_stat_reset(&s_up);
+    bench_stat_reset(&s_down);
+    s_owner = xTaskGetCurrentTaskHandle();
+
+    if (xTaskCreate(bench_sched_pong, "bpong", BENCH_SCHED_STACK, NULL,
+                    BENCH_SCHED_PONG_PRIO, &s_pong) != pdPASS)
+    {
+        log_e("sched: no memory for pong task");
+        return;
+    }
+
+    if (xTaskCreate(bench_sched_ping, "bping", BENCH_SCHED_STACK, NULL,
+                    BENCH_SCHED_PING_PRIO, &ping) != pdPASS)
+    {
+        log_e("sched: no memory for ping task");
+        vTaskDelete(s_pong);
+        return;
+    }
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    vTaskDelete(ping);
+    vTaskDelete(s_pong);
+
+    log_i("sched: %s task selection, %u priorities",
+          configUSE_PORT_OPTIMISED_TASK_SELECTION ? "bit map" : "generic",
+          (unsigned)configMAX_PRIORITIES);
+    bench_stat_report("sched switch low->high", &s_up);
+    bench_stat_report("sched switch high->low", &s_down);
+}
@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    bench_time.c
+  * @brief   Timestamp service benchmark. Reports the cost of a 32-bit and a
+  *          64-bit read of the timestamp against xTaskGetTickCount(), and
+  *          checks the timestamp rate against the DWT cycle counter.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "timestamp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_TIME_ROUNDS       1000
+#define BENCH_TIME_SPAN_MS      100
+
+void bench_time_run(void)
+{
+    bench_stat_t now32, now64, tick;
+    volatile uint64_t sink;
+    uint64_t ts0, ts1, last;
+    uint32_t i, t, c0, c1, backwards = 0;
+
+    bench_stat_reset(&now32);
+    bench_stat_reset(&now64);
+    bench_stat_reset(&tick);
+
+    last = timestamp_now();
+    for (i = 0; i < BENCH_TIME_ROUNDS; i++)
+    {
+        t = bench_cycles();
+        sink = timestamp_now32();
+        bench_stat_add(&now32, bench_cycles() - t);
+
+        t = bench_cycles();
+        sink = timestamp_now();
+        bench_stat_add(&now64, bench_cycles() - t);
+
+        t = bench_cycles();
+        sink = xTaskGetTickCount();
+        bench_stat_add(&tick, bench_cycles() - t);
+
+        ts0 = timestamp_now();
+        if (ts0 < last)
+        {
+            backwards++;
+        }
+        last = ts0;
+    }
+    (void)sink;
+
+    bench_stat_report("timestamp_now32", &now32);
+    bench_stat_report("timestamp_now", &now64);
+    bench_stat_report("xTaskGetTickCount", &tick);
+
+    /* Both should count at the core clock on this board. */
+    c0 = bench_cycles();
+    ts0 = timestamp_now();
+    vTaskDelay(pdMS_TO_TICKS(BENCH_TIME_SPAN_MS));
+    c1 = bench_cycles();
+    ts1 = timestamp_now();
+
+    log_i("timestamp %lu Hz: %lu counts over %lu cycles, %lu ns, %lu went backwards",
+          (unsigned long)timestamp_hz(), (unsigned long)(ts1 - ts0), (unsigned long)(c1 - c0),
+          (unsigned long)timestamp_to_ns(ts1 - ts0), (unsigned long)backwards);
+}
@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file    bench_timer.c
+  * @brief   Software timer benchmark. Keeps a set of protocol style timeouts
+  *          active and restarts them with osTimerStart, timing each batch of
+  *          restarts until the timer task has applied them. Build once with
+  *          configUSE_TIMER_WHEEL set to 0 (sorted lists) and once with 1.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#define BENCH_TIMER_COUNT       100
+#define BENCH_TIMER_BATCH       8       /* Below configTIMER_QUEUE_LENGTH */
+#define BENCH_TIMER_ROUNDS      200
+#define BENCH_TIMER_PERIOD_MIN  10000   /* Ticks, long enough never to expire */
+
+static StaticTimer_t s_timer_cb[BENCH_TIMER_COUNT];
+static osTimerId_t s_timer[BENCH_TIMER_COUNT];
+
+static void bench_timer_expired(void *argument)
+{
+    (void)argument;
+}
+
+/* Runs in the timer task after every command queued before it. */
+static void bench_timer_sync(void *pvParameter1, uint32_t ulParameter2)
+{
+    (void)ulParameter2;
+    xTaskNotifyGive((TaskHandle_t)pvParameter1);
+}
+
+/* The timer task runs below this task, so wait for it to drain the command
+ * queue before it can overflow. */
+static void bench_timer_flush(void)
+{
+    xTimerPendFunctionCall(bench_timer_sync, xTaskGetCurrentTaskHandle(), 0, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static void bench_timer_restart(uint32_t count, bench_stat_t *stat)
+{
+    osTimerAttr_t attr = {0};
+    uint32_t r, i, n, t;
+
+    attr.cb_size = sizeof(StaticTimer_t);
+
+    for (i = 0; i < count; i++)
+    {
+        attr.cb_mem = &s_timer_cb[i];
+        s_timer[i] = osTimerNew(bench_timer_expired, osTimerOnce, NULL, &attr);
+        if (s_timer[i] == NULL)
+        {
+            log_w("timer: no memory");
+            count = i;
+            break;
+        }
+        osTimerStart(s_timer[i], BENCH_TIMER_PERIOD_MIN + i * 37);
+        if ((i % BENCH_TIMER_BATCH) == BENCH_TIMER_BATCH - 1)
+        {
+            bench_timer_flush();
+        }
+    }
+    bench_timer_flush();
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    for (r = 0, n = 0; r < BENCH_TIMER_ROUNDS; r++)
+    {
+        t = bench_cycles();
+        for (i = 0; i < BENCH_TIMER_BATCH; i++, n++)
+        {
+            osTimerStart(s_timer[n % count], BENCH_TIMER_PERIOD_MIN + (n * 7919) % 5000);
+        }
+        bench_timer_flush();
+        bench_stat_add(stat, (bench_cycles() - t) / BENCH_TIMER_BATCH);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        osTimerDelete(s_timer[i]);
+        if ((i % BENCH_TIMER_BATCH) == BENCH_TIMER_BATCH - 1)
+        {
+            bench_timer_flush();
+        }
+    }
+    bench_timer_flush();
+}
+
+void bench_timer_run(void)
+{
+    bench_stat_t few, many;
+
+    bench_stat_reset(&few);
+    bench_stat_reset(&many);
+
+    bench_timer_restart(BENCH_TIMER_BATCH, &few);
+    bench_timer_restart(BENCH_TIMER_COUNT, &many);
+
+    bench_stat_report("timer restart, 8 active", &few);
+    bench_stat_report("timer restart, 100 active", &many);
+}
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    bench_trace.c
+  * @brief   Trace recorder overhead. Times a single recorded event, and a
+  *          queue send and receive pair (four events) with the recorder
+  *          stopped and started. Built with TRACE_REC_ENABLE set to 1.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "trace_rec.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#define BENCH_TRACE_ROUNDS      1000
+
+#if TRACE_REC_ENABLE
+
+static void bench_trace_queue(QueueHandle_t queue, bench_stat_t *stat)
+{
+    uint32_t i, t, item = 0;
+
+    for (i = 0; i < BENCH_TRACE_ROUNDS; i++)
+    {
+        t = bench_cycles();
+        xQueueSend(queue, &item, 0);
+        xQueueReceive(queue, &item, 0);
+        bench_stat_add(stat, bench_cycles() - t);
+    }
+}
+
+void bench_trace_run(void)
+{
+    bench_stat_t event, off, on;
+    QueueHandle_t queue;
+    uint32_t i, t, lost;
+
+    bench_stat_reset(&event);
+    bench_stat_reset(&off);
+    bench_stat_reset(&on);
+
+    queue = xQueueCreate(1, sizeof(uint32_t));
+    if (queue == NULL)
+    {
+        log_w("trace: no memory");
+        return;
+    }
+
+    lost = trace_rec_lost();
+
+    /* The RTT buffer holds 512 plain records; without a host draining it the
+     * rest are counted as lost, which costs about the same. */
+    for (i = 0; i < BENCH_TRACE_ROUNDS; i++)
+    {
+        t = bench_cycles();
+        trace_rec_event(TRACE_REC_TASK_READY, 0, 0);
+        bench_stat_add(&event, bench_cycles() - t);
+    }
+
+    trace_rec_stop();
+    bench_trace_queue(queue, &off);
+    trace_rec_start();
+    bench_trace_queue(queue, &on);
+
+    vQueueDelete(queue);
+
+    bench_stat_report("trace one event", &event);
+    bench_stat_report("queue send+receive, trace stopped", &off);
+    bench_stat_report("queue send+receive, trace running", &on);
+    log_i("trace: %lu records lost during the run", (unsigned long)(trace_rec_lost() - lost));
+}
+
+#else
+
+void bench_trace_run(void)
+{
+    log_i("trace: recorder not built, set TRACE_REC_ENABLE to 1");
+}
+
+#endif /* TRACE_REC_ENABLE */
@@ -0,0 +1,137 @@
+/**
+  ******************************************************************************
+  * @file    bench_uart.c
+  * @brief   DMA UART throughput benchmark. Streams a fixed amount of data
+  *          through uart_dma_write() at a high baud rate and reports the
+  *          sustained rate against the line rate, the DMA transfers and
+  *          interrupts it took, and the CPU cost of each write. With PA9
+  *          wired to PA10 the data is also received and counted. With
+  *          LOG_UART_ENABLE set, the cost of a log line into the log ring
+  *          and the sink's rate and drop counters are reported too.
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include "bench.h"
+#include "elog.h"
+#include "uart_dma.h"
+#include "log_uart.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef BENCH_UART_BAUD
+#define BENCH_UART_BAUD         2000000
+#endif
+
+#define BENCH_UART_BYTES        (64 * 1024)
+#define BENCH_UART_CHUNK        128
+#define BENCH_UART_STACK        (configMINIMAL_STACK_SIZE * 2)
+#define BENCH_UART_LOG_LINES    200     /* About 16 KB, twice the log ring */
+
+static uint8_t s_chunk[BENCH_UART_CHUNK];
+static TaskHandle_t s_owner;
+static volatile uint32_t s_stop;
+static volatile uint32_t s_received;
+
+/* Drains the receive side so a loopback does not overflow it. Polls with a
+ * timeout so it never exits while blocked on the stream buffer. */
+static void bench_uart_reader(void *argument)
+{
+    uint8_t buf[64];
+
+    (void)argument;
+
+    while (!s_stop)
+    {
+        s_received += uart_dma_read(buf, sizeof(buf), pdMS_TO_TICKS(10));
+    }
+
+    xTaskNotifyGive(s_owner);
+    vTaskDelete(NULL);
+}
+
+void bench_uart_run(void)
+{
+    uart_dma_stats_t before, after;
+    bench_stat_t write;
+    uint32_t i, t, start, wall, rate;
+#if LOG_UART_ENABLE
+    log_uart_stats_t sink;
+#endif
+
+    s_owner = xTaskGetCurrentTaskHandle();
+
+    if (uart_dma_init(BENCH_UART_BAUD) != 0)
+    {
+        log_w("uart: init failed");
+        return;
+    }
+
+    s_stop = 0;
+    s_received = 0;
+    if (xTaskCreate(bench_uart_reader, "buart", BENCH_UART_STACK, NULL,
+                    uxTaskPriorityGet(NULL) + 1, NULL) != pdPASS)
+    {
+        log_w("uart: no memory");
+        return;
+    }
+
+    for (i = 0; i < sizeof(s_chunk); i++)
+    {
+        s_chunk[i] = (uint8_t)i;
+    }
+
+    bench_stat_reset(&write);
+    uart_dma_get_stats(&before);
+
+    start = bench_cycles();
+    for (i = 0; i < BENCH_UART_BYTES / BENCH_UART_CHUNK; i++)
+    {
+        t = bench_cycles();
+        uart_dma_write(s_chunk, sizeof(s_chunk), portMAX_DELAY);
+        bench_stat_add(&write, bench_cycles() - t);
+    }
+    uart_dma_flush(portMAX_DELAY);
+    wall = bench_cycles() - start;
+
+    /* Let the last idle line event through before stopping the reader. */
+    vTaskDelay(pdMS_TO_TICKS(20));
+    s_stop = 1;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    uart_dma_get_stats(&after);
+
+    rate = (uint32_t)((uint64_t)BENCH_UART_BYTES * SystemCoreClock / wall);
+    log_i("uart %lu baud: %lu B/s sustained, line rate %lu B/s",
+          (unsigned long)BENCH_UART_BAUD, (unsigned long)rate,
+          (unsigned long)(BENCH_UART_BAUD / 10));
+    log_i("uart tx: %lu bytes in %lu DMA transfers",
+          (unsigned long)(after.tx_bytes - before.tx_bytes),
+          (unsigned long)(after.tx_transfers - before.tx_transfers));
+    log_i("uart rx: %lu bytes in %lu events, %lu dropped, %lu errors",
+          (unsigned long)s_received, (unsigned long)(after.rx_events - before.rx_events),
+          (unsigned long)(after.rx_dropped - before.rx_dropped),
+          (unsigned long)(after.errors - before.errors));
+    /* The minimum is a write that found room: the copy into the DMA half. */
+    bench_stat_report("uart write 128 B", &write);
+
+#if LOG_UART_ENABLE
+    /* Debug lines drop the newest when the ring is full, so the burst never
+     * waits for the UART. */
+    bench_stat_reset(&write);
+    for (i = 0; i < BENCH_UART_LOG_LINES; i++)
+    {
+        t = bench_cycles();
+        log_d("log sink line %lu of %lu", (unsigned long)i, (unsigned long)BENCH_UART_LOG_LINES);
+        bench_stat_add(&write, bench_cycles() - t);
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    log_uart_get_stats(&sink);
+    bench_stat_report("log line to uart ring", &write);
+    log_i("log uart: %lu B/s, %lu B sent, %lu lines (%lu B) dropped, %lu blocked, peak %lu B",
+          (unsigned long)sink.rate, (unsigned long)sink.sent_bytes,
+          (unsigned long)sink.dropped_lines, (unsigned long)sink.dropped_bytes,
+          (unsigned long)sink.blocked, (unsigned long)sink.peak);
+#endif
+}
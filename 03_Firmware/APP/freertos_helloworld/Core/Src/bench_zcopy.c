@@ -0,0 +1,218 @@
+/**
+  ******************************************************************************
+  * @file    bench_zcopy.c
+  * @brief   Message passing throughput benchmark. Frames of 16 B to 4 KB are
+  *          sent from this task to a consumer task once by copying them
+  *          through an osMessageQueue and once as osMemoryPool blocks whose
+  *          pointer alone goes through the queue (freertos_os2_zcopy.h).
+  ******************************************************************************
+  */
+#define LOG_TAG "bench"
+
+#include <stdio.h>
+#include "bench.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "freertos_os2_zcopy.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BENCH_ZCOPY_DEPTH       1       /* Keeps a 4 KB run within the heap */
+#define BENCH_ZCOPY_FRAMES      64      /* Frames per measured burst */
+#define BENCH_ZCOPY_ROUNDS      16
+#define BENCH_ZCOPY_MIN_SIZE    16
+#define BENCH_ZCOPY_MAX_SIZE    4096
+#define BENCH_ZCOPY_STACK       (configMINIMAL_STACK_SIZE * 2)
+
+/* Frame buffers are static: a 4 KB frame does not fit on a task stack. */
+static uint32_t s_tx_frame[BENCH_ZCOPY_MAX_SIZE / 4];
+static uint32_t s_rx_frame[BENCH_ZCOPY_MAX_SIZE / 4];
+
+static osMessageQueueId_t s_queue;
+static osMemoryPoolId_t s_pool;
+static TaskHandle_t s_owner;
+static volatile uint32_t s_size;
+static volatile uint32_t s_sum;
+
+/* Producer side work shared by both paths: write every word of the frame. */
+static void bench_zcopy_fill(uint32_t *frame, uint32_t size, uint32_t seq)
+{
+    uint32_t i;
+
+    for (i = 0; i < size / 4; i++)
+    {
+        frame[i] = seq + i;
+    }
+}
+
+/* Consumer side work shared by both paths: read every word of the frame. */
+static uint32_t bench_zcopy_touch(const uint32_t *frame, uint32_t size)
+{
+    uint32_t i, sum = 0;
+
+    for (i = 0; i < size / 4; i++)
+    {
+        sum += frame[i];
+    }
+
+    return sum;
+}
+
+static void bench_zcopy_copy_consumer(void *argument)
+{
+    uint32_t i;
+
+    (void)argument;
+
+    for (;;)
+    {
+        for (i = 0; i < BENCH_ZCOPY_FRAMES; i++)
+        {
+            osMessageQueueGet(s_queue, s_rx_frame, NULL, osWaitForever);
+            s_sum += bench_zcopy_touch(s_rx_frame, s_size);
+        }
+
+        xTaskNotifyGive(s_owner);
+    }
+}
+
+static void bench_zcopy_block_consumer(void *argument)
+{
+    uint32_t i;
+    void *block;
+
+    (void)argument;
+
+    for (;;)
+    {
+        for (i = 0; i < BENCH_ZCOPY_FRAMES; i++)
+        {
+            block = osMessageQueueGetBlock(s_queue, NULL, osWaitForever);
+            s_sum += bench_zcopy_touch(block, s_size);
+            osMemoryPoolFree(s_pool, block);
+        }
+
+        xTaskNotifyGive(s_owner);
+    }
+}
+
+/**
+ * @brief  Send frames of size bytes through a queue of that message size.
+ * @retval 0 on success, -1 if the queue or consumer could not be created.
+ */
+static int bench_zcopy_copy(uint32_t size, bench_stat_t *stat)
+{
+    TaskHandle_t consumer;
+    uint32_t r, i, t;
+
+    s_queue = osMessageQueueNew(BENCH_ZCOPY_DEPTH, size, NULL);
+    if (s_queue == NULL)
+    {
+        return -1;
+    }
+
+    if (xTaskCreate(bench_zcopy_copy_consumer, "bzcopy", BENCH_ZCOPY_STACK, NULL,
+                    uxTaskPriorityGet(NULL), &consumer) != pdPASS)
+    {
+        osMessageQueueDelete(s_queue);
+        return -1;
+    }
+
+    for (r = 0; r < BENCH_ZCOPY_ROUNDS; r++)
+    {
+        t = bench_cycles();
+        for (i = 0; i < BENCH_ZCOPY_FRAMES; i++)
+        {
+            bench_zcopy_fill(s_tx_frame, size, i);
+            osMessageQueuePut(s_queue, s_tx_frame, 0, osWaitForever);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bench_stat_add(stat, (bench_cycles() - t) / BENCH_ZCOPY_FRAMES);
+    }
+
+    vTaskDelete(consumer);
+    osMessageQueueDelete(s_queue);
+
+    return 0;
+}
+
+/**
+ * @brief  Send frames of size bytes as pool blocks, passing only the pointer.
+ * @retval 0 on success, -1 if the pool, queue or consumer could not be created.
+ */
+static int bench_zcopy_block(uint32_t size, bench_stat_t *stat)
+{
+    TaskHandle_t consumer;
+    uint32_t r, i, t;
+    void *block;
+
+    /* One block more than the queue holds, so the producer can fill the next
+     * frame while the queue is full. */
+    s_pool = osMemoryPoolNew(BENCH_ZCOPY_DEPTH + 1, size, NULL);
+    if (s_pool == NULL)
+    {
+        return -1;
+    }
+
+    s_queue = osMessageQueueNew(BENCH_ZCOPY_DEPTH, sizeof(void *), NULL);
+    if (s_queue == NULL)
+    {
+        osMemoryPoolDelete(s_pool);
+        return -1;
+    }
+
+    if (xTaskCreate(bench_zcopy_block_consumer, "bzcopy", BENCH_ZCOPY_STACK, NULL,
+                    uxTaskPriorityGet(NULL), &consumer) != pdPASS)
+    {
+        osMessageQueueDelete(s_queue);
+        osMemoryPoolDelete(s_pool);
+        return -1;
+    }
+
+    for (r = 0; r < BENCH_ZCOPY_ROUNDS; r++)
+    {
+        t = bench_cycles();
+        for (i = 0; i < BENCH_ZCOPY_FRAMES; i++)
+        {
+            block = osMemoryPoolAlloc(s_pool, osWaitForever);
+            bench_zcopy_fill(block, size, i);
+            osMessageQueuePutBlock(s_queue, block, 0, osWaitForever);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bench_stat_add(stat, (bench_cycles() - t) / BENCH_ZCOPY_FRAMES);
+    }
+
+    vTaskDelete(consumer);
+    osMessageQueueDelete(s_queue);
+    osMemoryPoolDelete(s_pool);
+
+    return 0;
+}
+
+void bench_zcopy_run(void)
+{
+    bench_stat_t copy, zcopy;
+    char name[32];
+    uint32_t size;
+
+    s_owner = xTaskGetCurrentTaskHandle();
+
+    for (size = BENCH_ZCOPY_MIN_SIZE; size <= BENCH_ZCOPY_MAX_SIZE; size *= 2)
+    {
+        s_size = size;
+        bench_stat_reset(&copy);
+        bench_stat_reset(&zcopy);
+
+        if ((bench_zcopy_copy(size, &copy) != 0) || (bench_zcopy_block(size, &zcopy) != 0))
+        {
+            log_w("zcopy %lu B: no memory", (unsigned long)size);
+            continue;
+        }
+
+        /* Cycles per frame, producer fill to consumer done. */
+        snprintf(name, sizeof(name), "msg copy %lu B", (unsigned long)size);
+        bench_stat_report(name, &copy);
+        snprintf(name, sizeof(name), "msg zero-copy %lu B", (unsigned long)size);
+        bench_stat_report(name, &zcopy);
+    }
+}
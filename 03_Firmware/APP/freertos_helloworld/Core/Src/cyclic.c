@@ -0,0 +1,346 @@
+/**
+  ******************************************************************************
+  * @file    cyclic.c
+  * @brief   Multi-rate cyclic executive on a FreeRTOS task.
+  ******************************************************************************
+  */
+#define LOG_TAG "cyclic"
+
+#include <stdio.h>
+#include <string.h>
+#include "cyclic.h"
+#include "timestamp.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct
+{
+    const cyclic_job_t *job;
+    uint32_t next;                      /* Minor cycle of the next release */
+    cyclic_stats_t stats;
+} cyclic_entry_t;
+
+static cyclic_entry_t s_entries[CYCLIC_MAX_JOBS];
+static uint8_t s_order[CYCLIC_MAX_JOBS];        /* Shortest period first */
+static uint32_t s_count;
+static cyclic_frame_stats_t s_frame;
+static uint32_t s_per_us;               /* Timestamp counts per microsecond */
+static uint32_t s_cycle_counts;         /* Timestamp counts per minor cycle */
+static osThreadId_t s_thread;
+static TaskHandle_t s_stopper;
+static volatile uint8_t s_stop;
+
+/* Log2 bucket: 0 for under 1 us, b for 2^(b-1) to 2^b - 1 us */
+static uint32_t cyclic_bucket(uint32_t us)
+{
+    uint32_t b = 0;
+
+    while ((us != 0) && (b < CYCLIC_HIST_BUCKETS - 1))
+    {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/* Run one release of a job. release_ts is when the release fell due: the
+ * start of the minor cycle it belongs to. */
+static void cyclic_run(cyclic_entry_t *e, uint32_t release_ts)
+{
+    const cyclic_job_t *job = e->job;
+    cyclic_stats_t *st = &e->stats;
+    uint32_t t0, t1, exec, late;
+
+    t0 = timestamp_now32();
+    job->func(job->argument);
+    t1 = timestamp_now32();
+
+    exec = (t1 - t0) / s_per_us;
+    late = (t0 - release_ts) / s_per_us;
+
+    st->runs++;
+    st->exec_total_us += exec;
+    if (exec < st->exec_min_us)
+    {
+        st->exec_min_us = exec;
+    }
+    if (exec > st->exec_max_us)
+    {
+        st->exec_max_us = exec;
+    }
+    if (late > st->jitter_max_us)
+    {
+        st->jitter_max_us = late;
+    }
+    st->hist[cyclic_bucket(exec)]++;
+
+    if ((job->budget_us != 0) && (exec > job->budget_us))
+    {
+        st->overruns++;
+    }
+
+    if ((t1 - release_ts) > job->period * s_cycle_counts)
+    {
+        st->misses++;
+        if (job->policy == CYCLIC_OVERRUN_DISABLE)
+        {
+            st->disabled = 1;
+        }
+    }
+}
+
+/* Run every release of a job due by this cycle, as its policy allows */
+static void cyclic_dispatch(cyclic_entry_t *e, uint32_t cycle, uint32_t cycle_ts)
+{
+    uint32_t period = e->job->period;
+    uint32_t due, runs = 0;
+
+    while (((int32_t)(cycle - e->next) >= 0) && !e->stats.disabled)
+    {
+        due = (cycle - e->next) / period + 1;
+
+        if ((due > 1) && (e->job->policy != CYCLIC_OVERRUN_CATCH_UP))
+        {
+            e->stats.releases += due - 1;
+            e->stats.skipped += due - 1;
+            e->next += (due - 1) * period;
+        }
+        else if (runs == CYCLIC_CATCH_UP_MAX)
+        {
+            e->stats.releases += due;
+            e->stats.skipped += due;
+            e->next += due * period;
+            break;
+        }
+
+        e->stats.releases++;
+        cyclic_run(e, cycle_ts - (cycle - e->next) * s_cycle_counts);
+        e->next += period;
+        runs++;
+    }
+}
+
+static void cyclic_task(void *argument)
+{
+    const TickType_t minor = pdMS_TO_TICKS(CYCLIC_MINOR_MS);
+    TickType_t wake, now;
+    uint32_t cycle = 0, ts, prev_ts = 0, err, i;
+    uint8_t on_time = 0;                /* Cycles in a row started by the delay, up to 2 */
+
+    (void)argument;
+
+    wake = xTaskGetTickCount();
+
+    while (!s_stop)
+    {
+        ts = timestamp_now32();
+
+        /* Wake-up error, only between two cycles that started on time */
+        if (on_time == 2)
+        {
+            err = ts - prev_ts;
+            err = (err > s_cycle_counts) ? (err - s_cycle_counts) : (s_cycle_counts - err);
+            if (err / s_per_us > s_frame.wake_jitter_max_us)
+            {
+                s_frame.wake_jitter_max_us = err / s_per_us;
+            }
+        }
+        prev_ts = ts;
+
+        for (i = 0; i < s_count; i++)
+        {
+            cyclic_dispatch(&s_entries[s_order[i]], cycle, ts);
+        }
+        s_frame.cycles++;
+
+        /* A cycle that ran into the next one starts that one at once; the
+         * releases it held up are pending and left to each job's policy. */
+        now = xTaskGetTickCount();
+        if ((now - wake) >= minor)
+        {
+            s_frame.overruns++;
+            cycle += (now - wake) / minor;
+            wake += ((now - wake) / minor) * minor;
+            on_time = 0;
+        }
+        else
+        {
+            vTaskDelayUntil(&wake, minor);
+            cycle++;
+            on_time = (on_time < 2) ? (on_time + 1) : 2;
+        }
+    }
+
+    s_thread = NULL;
+    xTaskNotifyGive(s_stopper);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief  Start the executive on a job table, which must stay valid while
+ *         it runs. The jobs run shortest period first; ties keep table order.
+ * @retval 0 on success, -1 if already running, the table is invalid or the
+ *         task could not be created.
+ */
+int cyclic_start(const cyclic_job_t *jobs, uint32_t count)
+{
+    const osThreadAttr_t attr = {
+        .name = "cyclic",
+        .stack_size = CYCLIC_STACK_SIZE,
+        .priority = (osPriority_t)CYCLIC_PRIORITY,
+    };
+    uint32_t i, j;
+
+    if ((s_thread != NULL) || (count == 0) || (count > CYCLIC_MAX_JOBS))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if ((jobs[i].func == NULL) || (jobs[i].period == 0))
+        {
+            log_e("job %lu: no function or zero period", (unsigned long)i);
+            return -1;
+        }
+    }
+
+    memset(s_entries, 0, sizeof(s_entries));
+    memset(&s_frame, 0, sizeof(s_frame));
+    for (i = 0; i < count; i++)
+    {
+        s_entries[i].job = &jobs[i];
+        s_entries[i].next = jobs[i].offset;
+        s_entries[i].stats.exec_min_us = UINT32_MAX;
+
+        /* Insertion sort by period, stable */
+        for (j = i; (j > 0) && (jobs[s_order[j - 1]].period > jobs[i].period); j--)
+        {
+            s_order[j] = s_order[j - 1];
+        }
+        s_order[j] = (uint8_t)i;
+    }
+    s_count = count;
+
+    s_per_us = timestamp_hz() / 1000000U;
+    s_cycle_counts = (timestamp_hz() / 1000U) * CYCLIC_MINOR_MS;
+    s_stop = 0;
+
+    s_thread = osThreadNew(cyclic_task, NULL, &attr);
+    return (s_thread != NULL) ? 0 : -1;
+}
+
+/**
+ * @brief  Stop the executive at the end of the current minor cycle and wait
+ *         for it. Statistics stay readable until the next cyclic_start().
+ */
+void cyclic_stop(void)
+{
+    if (s_thread == NULL)
+    {
+        return;
+    }
+
+    s_stopper = xTaskGetCurrentTaskHandle();
+    s_stop = 1;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+/**
+ * @brief  Copy the statistics of the index-th job of the table.
+ * @retval 0 on success, -1 past the last job.
+ */
+int cyclic_get_stats(uint32_t index, cyclic_stats_t *stats)
+{
+    if (index >= s_count)
+    {
+        return -1;
+    }
+
+    vTaskSuspendAll();
+    *stats = s_entries[index].stats;
+    (void)xTaskResumeAll();
+    return 0;
+}
+
+void cyclic_get_frame_stats(cyclic_frame_stats_t *stats)
+{
+    vTaskSuspendAll();
+    *stats = s_frame;
+    (void)xTaskResumeAll();
+}
+
+/**
+ * @brief  Zero every statistic. Disabled jobs stay disabled.
+ */
+void cyclic_reset_stats(void)
+{
+    uint32_t i;
+    uint8_t disabled;
+
+    vTaskSuspendAll();
+    for (i = 0; i < s_count; i++)
+    {
+        disabled = s_entries[i].stats.disabled;
+        memset(&s_entries[i].stats, 0, sizeof(cyclic_stats_t));
+        s_entries[i].stats.exec_min_us = UINT32_MAX;
+        s_entries[i].stats.disabled = disabled;
+    }
+    memset(&s_frame, 0, sizeof(s_frame));
+    (void)xTaskResumeAll();
+}
+
+/**
+ * @brief  Log the minor cycle statistics and, per job, counts, execution
+ *         times, jitter and the non-empty histogram buckets.
+ */
+void cyclic_report(void)
+{
+    cyclic_frame_stats_t frame;
+    cyclic_stats_t st;
+    char hist[160];
+    uint32_t i, b;
+    int len;
+
+    cyclic_get_frame_stats(&frame);
+    log_i("%lu cycles of %d ms, %lu overran, wake jitter max %lu us",
+          (unsigned long)frame.cycles, CYCLIC_MINOR_MS,
+          (unsigned long)frame.overruns, (unsigned long)frame.wake_jitter_max_us);
+
+    for (i = 0; cyclic_get_stats(i, &st) == 0; i++)
+    {
+        log_i("%-10s %4u ms: run %lu skip %lu miss %lu over %lu exec %lu/%lu/%lu us jitter %lu us%s",
+              s_entries[i].job->name, s_entries[i].job->period * CYCLIC_MINOR_MS,
+              (unsigned long)st.runs, (unsigned long)st.skipped,
+              (unsigned long)st.misses, (unsigned long)st.overruns,
+              (unsigned long)((st.runs != 0) ? st.exec_min_us : 0),
+              (unsigned long)((st.runs != 0) ? st.exec_total_us / st.runs : 0),
+              (unsigned long)st.exec_max_us, (unsigned long)st.jitter_max_us,
+              st.disabled ? " DISABLED" : "");
+
+        len = 0;
+        for (b = 0; b < CYCLIC_HIST_BUCKETS; b++)
+        {
+            if ((st.hist[b] == 0) || (len >= (int)sizeof(hist)))
+            {
+                continue;
+            }
+            if (b < CYCLIC_HIST_BUCKETS - 1)
+            {
+                len += snprintf(hist + len, sizeof(hist) - len, " <%luus:%lu",
+                                (unsigned long)(1UL << b), (unsigned long)st.hist[b]);
+            }
+            else
+            {
+                len += snprintf(hist + len, sizeof(hist) - len, " >=%luus:%lu",
+                                (unsigned long)(1UL << (b - 1)), (unsigned long)st.hist[b]);
+            }
+        }
+        if (len > 0)
+        {
+            log_i("%-10s %s", "", hist);
+        }
+    }
+}
@@ -0,0 +1,2043 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bench.c
+  * @brief   CMSIS-DSP cycle count sweep, shared by the target and the host.
+  ******************************************************************************
+  * Every function is described by an entry: an optional setup, run untimed
+  * before each timed call to reset filter state or restore data that the
+  * function works on in place, and the call itself. The work memory is split
+  * into five regions of 8 * max_block + 128 bytes: two inputs (A, B; filter
+  * coefficients come from B), the output (D), state or scratch (S) and a
+  * copy of the input data (P) that in-place functions are restored from.
+  ******************************************************************************
+  */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "dsp_bench.h"
+#include "dsp_ext.h"
+
+#if DSP_EXT_ENABLED
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_bfp.h"
+#include "dsp_mrfft.h"
+#include "dsp_ols.h"
+#include "dsp_resample.h"
+
+#define DSP_BENCH_LINE          256
+#define DSP_BENCH_DECIMATE      4       /* Decimation and interpolation factor */
+#define DSP_BENCH_STAGES        4       /* Biquad sections */
+#define DSP_BENCH_LATTICE       8       /* Lattice filter stages */
+#define DSP_BENCH_SPARSE_DELAY  64      /* Largest sparse FIR tap delay */
+#define DSP_BENCH_LMS_ERR       64      /* Word offset of the LMS error in P */
+#define DSP_BENCH_FFT_MAX       4096
+
+/* Type of the data a function works on */
+enum
+{
+    T_F32 = 0,
+    T_Q31,
+    T_Q15,
+    T_Q7,
+    T_TYPES
+};
+
+/* Sizes a function supports, beyond DSP_BENCH_MIN_BLOCK .. max_block */
+#define L_FFT                   0x01U   /* Up to DSP_BENCH_FFT_MAX */
+#define L_RFFT                  0x02U   /* From 32 */
+#define L_DCT                   0x04U   /* 128, 512 or 2048 */
+#define L_POSITIVE              0x08U   /* Takes inputs of 0 or more only */
+
+typedef struct
+{
+    void *a, *b, *d, *s, *p;
+    uint32_t n;
+    uint32_t rows, cols;                /* Matrix shape, rows * cols = n */
+    union
+    {
+        arm_fir_instance_f32 fir_f32;
+        arm_fir_instance_q31 fir_q31;
+        arm_fir_instance_q15 fir_q15;
+        arm_fir_instance_q7 fir_q7;
+        arm_fir_decimate_instance_f32 dec_f32;
+        arm_fir_decimate_instance_q31 dec_q31;
+        arm_fir_decimate_instance_q15 dec_q15;
+        arm_fir_interpolate_instance_f32 int_f32;
+        arm_fir_interpolate_instance_q31 int_q31;
+        arm_fir_interpolate_instance_q15 int_q15;
+        arm_fir_lattice_instance_f32 fl_f32;
+        arm_fir_lattice_instance_q31 fl_q31;
+        arm_fir_lattice_instance_q15 fl_q15;
+        arm_iir_lattice_instance_f32 il_f32;
+        arm_iir_lattice_instance_q31 il_q31;
+        arm_iir_lattice_instance_q15 il_q15;
+        arm_fir_sparse_instance_f32 sp_f32;
+        arm_fir_sparse_instance_q31 sp_q31;
+        arm_fir_sparse_instance_q15 sp_q15;
+        arm_fir_sparse_instance_q7 sp_q7;
+        arm_biquad_casd_df1_inst_f32 bq_f32;
+        arm_biquad_casd_df1_inst_q31 bq_q31;
+        arm_biquad_casd_df1_inst_q15 bq_q15;
+        arm_biquad_cas_df1_32x64_ins_q31 bq_32x64;
+        arm_biquad_cascade_df2T_instance_f32 df2t_f32;
+        arm_biquad_cascade_stereo_df2T_instance_f32 sdf2t_f32;
+        arm_lms_instance_f32 lms_f32;
+        arm_lms_instance_q31 lms_q31;
+        arm_lms_instance_q15 lms_q15;
+        arm_lms_norm_instance_f32 lmsn_f32;
+        arm_lms_norm_instance_q31 lmsn_q31;
+        arm_lms_norm_instance_q15 lmsn_q15;
+        arm_pid_instance_f32 pid_f32;
+        arm_pid_instance_q31 pid_q31;
+        arm_pid_instance_q15 pid_q15;
+        arm_rfft_fast_instance_f32 rfft_fast;
+        arm_rfft_instance_q31 rfft_q31;
+        arm_rfft_instance_q15 rfft_q15;
+        dsp_mrfft_cfft_instance_f32 mr_cfft;
+        dsp_mrfft_rfft_instance_f32 mr_rfft;
+        struct
+        {
+            arm_dct4_instance_f32 dct;
+            arm_rfft_instance_f32 rfft;
+            arm_cfft_radix4_instance_f32 cfft;
+        } dct_f32;
+        struct
+        {
+            arm_dct4_instance_q31 dct;
+            arm_rfft_instance_q31 rfft;
+            arm_cfft_radix4_instance_q31 cfft;
+        } dct_q31;
+        struct
+        {
+            arm_dct4_instance_q15 dct;
+            arm_rfft_instance_q15 rfft;
+            arm_cfft_radix4_instance_q15 cfft;
+        } dct_q15;
+        struct
+        {
+            arm_matrix_instance_f32 a, b, d;
+        } m_f32;
+        struct
+        {
+            arm_matrix_instance_q31 a, b, d;
+        } m_q31;
+        struct
+        {
+            arm_matrix_instance_q15 a, b, d;
+        } m_q15;
+    } u;
+    union
+    {
+        float32_t f32;
+        q63_t q63;
+        q31_t q31;
+        q15_t q15;
+        q7_t q7;
+    } r, r2;                            /* Results of the reductions */
+    uint32_t index;
+} dsp_bench_ctx_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t type;
+    uint8_t limits;
+    void (*setup)(dsp_bench_ctx_t *c);
+    void (*run)(dsp_bench_ctx_t *c);
+} dsp_bench_entry_t;
+
+#define A(T)                    ((T *)c->a)
+#define B(T)                    ((T *)c->b)
+#define D(T)                    ((T *)c->d)
+#define S(T)                    ((T *)c->s)
+#define P(T)                    ((T *)c->p)
+
+/* ---------------------------------------------------------------------------
+ * Element-wise and reduction functions, by signature
+ * ------------------------------------------------------------------------ */
+
+#define UNARY(fn, Ti, To) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(Ti), D(To), c->n); }
+#define BINARY(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), B(T), D(T), c->n); }
+#define OFFSET(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), B(T)[0], D(T), c->n); }
+#define SCALE_Q(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), B(T)[0], 1, D(T), c->n); }
+#define SHIFT(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), 1, D(T), c->n); }
+#define FILL(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(B(T)[0], D(T), c->n); }
+#define DOT(fn, T, R) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), B(T), c->n, (R *)&c->r); }
+#define CDOT(fn, T, R) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), B(T), c->n, (R *)&c->r, (R *)&c->r2); }
+#define REDUCE(fn, T, R) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), c->n, (R *)&c->r); }
+#define MINMAX(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), c->n, (T *)&c->r, &c->index); }
+#define EACH(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) \
+    { \
+        uint32_t i; \
+        for (i = 0; i < c->n; i++) \
+        { \
+            D(T)[i] = fn(A(T)[i]); \
+        } \
+    }
+
+UNARY(arm_abs_f32, float32_t, float32_t)
+UNARY(arm_abs_q31, q31_t, q31_t)
+UNARY(arm_abs_q15, q15_t, q15_t)
+UNARY(arm_abs_q7, q7_t, q7_t)
+UNARY(arm_negate_f32, float32_t, float32_t)
+UNARY(arm_negate_q31, q31_t, q31_t)
+UNARY(arm_negate_q15, q15_t, q15_t)
+UNARY(arm_negate_q7, q7_t, q7_t)
+BINARY(arm_add_f32, float32_t)
+BINARY(arm_add_q31, q31_t)
+BINARY(arm_add_q15, q15_t)
+BINARY(arm_add_q7, q7_t)
+BINARY(arm_sub_f32, float32_t)
+BINARY(arm_sub_q31, q31_t)
+BINARY(arm_sub_q15, q15_t)
+BINARY(arm_sub_q7, q7_t)
+BINARY(arm_mult_f32, float32_t)
+BINARY(arm_mult_q31, q31_t)
+BINARY(arm_mult_q15, q15_t)
+BINARY(arm_mult_q7, q7_t)
+OFFSET(arm_offset_f32, float32_t)
+OFFSET(arm_offset_q31, q31_t)
+OFFSET(arm_offset_q15, q15_t)
+OFFSET(arm_offset_q7, q7_t)
+OFFSET(arm_scale_f32, float32_t)
+SCALE_Q(arm_scale_q31, q31_t)
+SCALE_Q(arm_scale_q15, q15_t)
+SCALE_Q(arm_scale_q7, q7_t)
+SHIFT(arm_shift_q31, q31_t)
+SHIFT(arm_shift_q15, q15_t)
+SHIFT(arm_shift_q7, q7_t)
+DOT(arm_dot_prod_f32, float32_t, float32_t)
+DOT(arm_dot_prod_q31, q31_t, q63_t)
+DOT(arm_dot_prod_q15, q15_t, q63_t)
+DOT(arm_dot_prod_q7, q7_t, q31_t)
+
+UNARY(arm_cmplx_conj_f32, float32_t, float32_t)
+UNARY(arm_cmplx_conj_q31, q31_t, q31_t)
+UNARY(arm_cmplx_conj_q15, q15_t, q15_t)
+UNARY(arm_cmplx_mag_f32, float32_t, float32_t)
+UNARY(arm_cmplx_mag_q31, q31_t, q31_t)
+UNARY(arm_cmplx_mag_q15, q15_t, q15_t)
+UNARY(arm_cmplx_mag_squared_f32, float32_t, float32_t)
+UNARY(arm_cmplx_mag_squared_q31, q31_t, q31_t)
+UNARY(arm_cmplx_mag_squared_q15, q15_t, q15_t)
+BINARY(arm_cmplx_mult_cmplx_f32, float32_t)
+BINARY(arm_cmplx_mult_cmplx_q31, q31_t)
+BINARY(arm_cmplx_mult_cmplx_q15, q15_t)
+BINARY(arm_cmplx_mult_real_f32, float32_t)
+BINARY(arm_cmplx_mult_real_q31, q31_t)
+BINARY(arm_cmplx_mult_real_q15, q15_t)
+CDOT(arm_cmplx_dot_prod_f32, float32_t, float32_t)
+CDOT(arm_cmplx_dot_prod_q31, q31_t, q63_t)
+CDOT(arm_cmplx_dot_prod_q15, q15_t, q31_t)
+
+MINMAX(arm_max_f32, float32_t)
+MINMAX(arm_max_q31, q31_t)
+MINMAX(arm_max_q15, q15_t)
+MINMAX(arm_max_q7, q7_t)
+MINMAX(arm_min_f32, float32_t)
+MINMAX(arm_min_q31, q31_t)
+MINMAX(arm_min_q15, q15_t)
+MINMAX(arm_min_q7, q7_t)
+REDUCE(arm_mean_f32, float32_t, float32_t)
+REDUCE(arm_mean_q31, q31_t, q31_t)
+REDUCE(arm_mean_q15, q15_t, q15_t)
+REDUCE(arm_mean_q7, q7_t, q7_t)
+REDUCE(arm_power_f32, float32_t, float32_t)
+REDUCE(arm_power_q31, q31_t, q63_t)
+REDUCE(arm_power_q15, q15_t, q63_t)
+REDUCE(arm_power_q7, q7_t, q31_t)
+REDUCE(arm_rms_f32, float32_t, float32_t)
+REDUCE(arm_rms_q31, q31_t, q31_t)
+REDUCE(arm_rms_q15, q15_t, q15_t)
+REDUCE(arm_std_f32, float32_t, float32_t)
+REDUCE(arm_std_q31, q31_t, q31_t)
+REDUCE(arm_std_q15, q15_t, q15_t)
+REDUCE(arm_var_f32, float32_t, float32_t)
+REDUCE(arm_var_q31, q31_t, q31_t)
+REDUCE(arm_var_q15, q15_t, q15_t)
+
+UNARY(arm_copy_f32, float32_t, float32_t)
+UNARY(arm_copy_q31, q31_t, q31_t)
+UNARY(arm_copy_q15, q15_t, q15_t)
+UNARY(arm_copy_q7, q7_t, q7_t)
+FILL(arm_fill_f32, float32_t)
+FILL(arm_fill_q31, q31_t)
+FILL(arm_fill_q15, q15_t)
+FILL(arm_fill_q7, q7_t)
+UNARY(arm_float_to_q31, float32_t, q31_t)
+UNARY(arm_float_to_q15, float32_t, q15_t)
+UNARY(arm_float_to_q7, float32_t, q7_t)
+UNARY(arm_q31_to_float, q31_t, float32_t)
+UNARY(arm_q31_to_q15, q31_t, q15_t)
+UNARY(arm_q31_to_q7, q31_t, q7_t)
+UNARY(arm_q15_to_float, q15_t, float32_t)
+UNARY(arm_q15_to_q31, q15_t, q31_t)
+UNARY(arm_q15_to_q7, q15_t, q7_t)
+UNARY(arm_q7_to_float, q7_t, float32_t)
+UNARY(arm_q7_to_q31, q7_t, q31_t)
+UNARY(arm_q7_to_q15, q7_t, q15_t)
+
+EACH(arm_sin_f32, float32_t)
+EACH(arm_sin_q31, q31_t)
+EACH(arm_sin_q15, q15_t)
+EACH(arm_cos_f32, float32_t)
+EACH(arm_cos_q31, q31_t)
+EACH(arm_cos_q15, q15_t)
+
+static void run_arm_sqrt_q31(dsp_bench_ctx_t *c)
+{
+    uint32_t i;
+
+    for (i = 0; i < c->n; i++)
+    {
+        arm_sqrt_q31(A(q31_t)[i], &D(q31_t)[i]);
+    }
+}
+
+static void run_arm_sqrt_q15(dsp_bench_ctx_t *c)
+{
+    uint32_t i;
+
+    for (i = 0; i < c->n; i++)
+    {
+        arm_sqrt_q15(A(q15_t)[i], &D(q15_t)[i]);
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Controller functions, one sample per call
+ * ------------------------------------------------------------------------ */
+
+static void run_arm_sin_cos_f32(dsp_bench_ctx_t *c)
+{
+    uint32_t i;
+
+    for (i = 0; i < c->n; i++)
+    {
+        arm_sin_cos_f32(A(float32_t)[i] * 360.0f, &D(float32_t)[i], &S(float32_t)[i]);
+    }
+}
+
+static void run_arm_sin_cos_q31(dsp_bench_ctx_t *c)
+{
+    uint32_t i;
+
+    for (i = 0; i < c->n; i++)
+    {
+        arm_sin_cos_q31(A(q31_t)[i], &D(q31_t)[i], &S(q31_t)[i]);
+    }
+}
+
+#define PID(sfx, T, kp, ki, kd) \
+    static void setup_pid_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        c->u.pid_##sfx.Kp = kp; \
+        c->u.pid_##sfx.Ki = ki; \
+        c->u.pid_##sfx.Kd = kd; \
+        arm_pid_init_##sfx(&c->u.pid_##sfx, 1); \
+    } \
+    static void run_arm_pid_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        uint32_t i; \
+        for (i = 0; i < c->n; i++) \
+        { \
+            D(T)[i] = arm_pid_##sfx(&c->u.pid_##sfx, A(T)[i]); \
+        } \
+    }
+
+PID(f32, float32_t, 0.5f, 0.1f, 0.01f)
+PID(q31, q31_t, 0x40000000, 0x0CCCCCCD, 0x0147AE14)
+PID(q15, q15_t, 0x4000, 0x0CCD, 0x0148)
+
+/* ---------------------------------------------------------------------------
+ * Filters
+ * ------------------------------------------------------------------------ */
+
+#define FIR(sfx, T) \
+    static void setup_fir_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_init_##sfx(&c->u.fir_##sfx, DSP_BENCH_TAPS, B(T), S(T), c->n); \
+    } \
+    static void run_arm_fir_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_##sfx(&c->u.fir_##sfx, A(T), D(T), c->n); \
+    }
+
+FIR(f32, float32_t)
+FIR(q31, q31_t)
+FIR(q15, q15_t)
+FIR(q7, q7_t)
+
+static void run_arm_fir_fast_q31(dsp_bench_ctx_t *c)
+{
+    arm_fir_fast_q31(&c->u.fir_q31, A(q31_t), D(q31_t), c->n);
+}
+
+static void run_arm_fir_fast_q15(dsp_bench_ctx_t *c)
+{
+    arm_fir_fast_q15(&c->u.fir_q15, A(q15_t), D(q15_t), c->n);
+}
+
+/* block input samples, block / DSP_BENCH_DECIMATE out */
+#define DECIMATE(sfx, T) \
+    static void setup_dec_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_decimate_init_##sfx(&c->u.dec_##sfx, DSP_BENCH_TAPS, DSP_BENCH_DECIMATE, B(T), S(T), c->n); \
+    } \
+    static void run_arm_fir_decimate_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_decimate_##sfx(&c->u.dec_##sfx, A(T), D(T), c->n); \
+    }
+
+DECIMATE(f32, float32_t)
+DECIMATE(q31, q31_t)
+DECIMATE(q15, q15_t)
+
+static void run_arm_fir_decimate_fast_q31(dsp_bench_ctx_t *c)
+{
+    arm_fir_decimate_fast_q31(&c->u.dec_q31, A(q31_t), D(q31_t), c->n);
+}
+
+static void run_arm_fir_decimate_fast_q15(dsp_bench_ctx_t *c)
+{
+    arm_fir_decimate_fast_q15(&c->u.dec_q15, A(q15_t), D(q15_t), c->n);
+}
+
+/* block / DSP_BENCH_DECIMATE input samples, block out */
+#define INTERPOLATE(sfx, T) \
+    static void setup_int_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_interpolate_init_##sfx(&c->u.int_##sfx, DSP_BENCH_DECIMATE, DSP_BENCH_TAPS, B(T), S(T), \
+                                       c->n / DSP_BENCH_DECIMATE); \
+    } \
+    static void run_arm_fir_interpolate_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_interpolate_##sfx(&c->u.int_##sfx, A(T), D(T), c->n / DSP_BENCH_DECIMATE); \
+    }
+
+INTERPOLATE(f32, float32_t)
+INTERPOLATE(q31, q31_t)
+INTERPOLATE(q15, q15_t)
+
+#define FIR_LATTICE(sfx, T) \
+    static void setup_fl_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_lattice_init_##sfx(&c->u.fl_##sfx, DSP_BENCH_LATTICE, B(T), S(T)); \
+    } \
+    static void run_arm_fir_lattice_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_lattice_##sfx(&c->u.fl_##sfx, A(T), D(T), c->n); \
+    }
+
+FIR_LATTICE(f32, float32_t)
+FIR_LATTICE(q31, q31_t)
+FIR_LATTICE(q15, q15_t)
+
+/* Reflection coefficients from B, ladder coefficients from B after them */
+#define IIR_LATTICE(sfx, T) \
+    static void setup_il_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_iir_lattice_init_##sfx(&c->u.il_##sfx, DSP_BENCH_LATTICE, B(T), B(T) + DSP_BENCH_LATTICE, \
+                                   S(T), c->n); \
+    } \
+    static void run_arm_iir_lattice_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_iir_lattice_##sfx(&c->u.il_##sfx, A(T), D(T), c->n); \
+    }
+
+IIR_LATTICE(f32, float32_t)
+IIR_LATTICE(q31, q31_t)
+IIR_LATTICE(q15, q15_t)
+
+/* Tap delays in P, spread over DSP_BENCH_SPARSE_DELAY; scratch in P after them */
+static int32_t *sparse_delays(dsp_bench_ctx_t *c)
+{
+    int32_t *delay = P(int32_t);
+    uint32_t i;
+
+    for (i = 0; i < DSP_BENCH_TAPS; i++)
+    {
+        delay[i] = (int32_t)((i * DSP_BENCH_SPARSE_DELAY) / DSP_BENCH_TAPS);
+    }
+    return delay;
+}
+
+#define SPARSE_SCRATCH(c)       (P(int32_t) + DSP_BENCH_TAPS)
+
+#define SPARSE(sfx, T) \
+    static void setup_sp_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_fir_sparse_init_##sfx(&c->u.sp_##sfx, DSP_BENCH_TAPS, B(T), S(T), sparse_delays(c), \
+                                  DSP_BENCH_SPARSE_DELAY, c->n); \
+    }
+
+SPARSE(f32, float32_t)
+SPARSE(q31, q31_t)
+SPARSE(q15, q15_t)
+SPARSE(q7, q7_t)
+
+static void run_arm_fir_sparse_f32(dsp_bench_ctx_t *c)
+{
+    arm_fir_sparse_f32(&c->u.sp_f32, A(float32_t), D(float32_t), (float32_t *)SPARSE_SCRATCH(c), c->n);
+}
+
+static void run_arm_fir_sparse_q31(dsp_bench_ctx_t *c)
+{
+    arm_fir_sparse_q31(&c->u.sp_q31, A(q31_t), D(q31_t), (q31_t *)SPARSE_SCRATCH(c), c->n);
+}
+
+static void run_arm_fir_sparse_q15(dsp_bench_ctx_t *c)
+{
+    q15_t *in = (q15_t *)SPARSE_SCRATCH(c);
+
+    arm_fir_sparse_q15(&c->u.sp_q15, A(q15_t), D(q15_t), in, (q31_t *)(in + c->n), c->n);
+}
+
+static void run_arm_fir_sparse_q7(dsp_bench_ctx_t *c)
+{
+    q7_t *in = (q7_t *)SPARSE_SCRATCH(c);
+
+    arm_fir_sparse_q7(&c->u.sp_q7, A(q7_t), D(q7_t), in, (q31_t *)(in + ((c->n + 3U) & ~3U)), c->n);
+}
+
+/* Stable low-pass sections, in the coefficient layout of each form. B holds
+   random data, which an IIR filter cannot take. */
+static void biquad_coeffs(dsp_bench_ctx_t *c, uint8_t type, uint32_t per_stage)
+{
+    static const float32_t df1[5] = { 0.2f, 0.4f, 0.2f, 0.5f, -0.3f };
+    uint32_t s, k, j;
+
+    for (s = 0; s < DSP_BENCH_STAGES; s++)
+    {
+        for (k = 0, j = 0; k < per_stage; k++)
+        {
+            /* The q15 layout has a 0 after b0 */
+            float32_t v = ((per_stage == 6U) && (k == 1U)) ? 0.0f : df1[j++];
+
+            if (type == T_F32)
+            {
+                B(float32_t)[s * per_stage + k] = v;
+            }
+            else if (type == T_Q31)
+            {
+                B(q31_t)[s * per_stage + k] = (q31_t)(v * 1073741824.0f);     /* postShift 1 */
+            }
+            else
+            {
+                B(q15_t)[s * per_stage + k] = (q15_t)(v * 16384.0f);
+            }
+        }
+    }
+}
+
+static void setup_bq_f32(dsp_bench_ctx_t *c)
+{
+    biquad_coeffs(c, T_F32, 5);
+    arm_biquad_cascade_df1_init_f32(&c->u.bq_f32, DSP_BENCH_STAGES, B(float32_t), S(float32_t));
+}
+
+static void run_arm_biquad_cascade_df1_f32(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_df1_f32(&c->u.bq_f32, A(float32_t), D(float32_t), c->n);
+}
+
+static void setup_bq_q31(dsp_bench_ctx_t *c)
+{
+    biquad_coeffs(c, T_Q31, 5);
+    arm_biquad_cascade_df1_init_q31(&c->u.bq_q31, DSP_BENCH_STAGES, B(q31_t), S(q31_t), 1);
+}
+
+static void run_arm_biquad_cascade_df1_q31(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_df1_q31(&c->u.bq_q31, A(q31_t), D(q31_t), c->n);
+}
+
+static void run_arm_biquad_cascade_df1_fast_q31(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_df1_fast_q31(&c->u.bq_q31, A(q31_t), D(q31_t), c->n);
+}
+
+static void setup_bq_q15(dsp_bench_ctx_t *c)
+{
+    biquad_coeffs(c, T_Q15, 6);
+    arm_biquad_cascade_df1_init_q15(&c->u.bq_q15, DSP_BENCH_STAGES, B(q15_t), S(q15_t), 1);
+}
+
+static void run_arm_biquad_cascade_df1_q15(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_df1_q15(&c->u.bq_q15, A(q15_t), D(q15_t), c->n);
+}
+
+static void run_arm_biquad_cascade_df1_fast_q15(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_df1_fast_q15(&c->u.bq_q15, A(q15_t), D(q15_t), c->n);
+}
+
+static void setup_bq_32x64(dsp_bench_ctx_t *c)
+{
+    biquad_coeffs(c, T_Q31, 5);
+    arm_biquad_cas_df1_32x64_init_q31(&c->u.bq_32x64, DSP_BENCH_STAGES, B(q31_t), S(q63_t), 1);
+}
+
+static void run_arm_biquad_cas_df1_32x64_q31(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cas_df1_32x64_q31(&c->u.bq_32x64, A(q31_t), D(q31_t), c->n);
+}
+
+static void setup_df2t_f32(dsp_bench_ctx_t *c)
+{
+    biquad_coeffs(c, T_F32, 5);
+    arm_biquad_cascade_df2T_init_f32(&c->u.df2t_f32, DSP_BENCH_STAGES, B(float32_t), S(float32_t));
+}
+
+static void run_arm_biquad_cascade_df2T_f32(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_df2T_f32(&c->u.df2t_f32, A(float32_t), D(float32_t), c->n);
+}
+
+/* block stereo frames, from the interleaved data in A */
+static void setup_sdf2t_f32(dsp_bench_ctx_t *c)
+{
+    biquad_coeffs(c, T_F32, 5);
+    arm_biquad_cascade_stereo_df2T_init_f32(&c->u.sdf2t_f32, DSP_BENCH_STAGES, B(float32_t), S(float32_t));
+}
+
+static void run_arm_biquad_cascade_stereo_df2T_f32(dsp_bench_ctx_t *c)
+{
+    arm_biquad_cascade_stereo_df2T_f32(&c->u.sdf2t_f32, A(float32_t), D(float32_t), c->n);
+}
+
+/* Input A, reference B, coefficients copied from B into P (they adapt), error
+   in P from DSP_BENCH_LMS_ERR words */
+#define LMS_COEFFS(c, T) \
+    (memcpy(P(T), B(T), DSP_BENCH_TAPS * sizeof(T)), P(T))
+#define LMS_ERR(c, T)           ((T *)(P(int32_t) + DSP_BENCH_LMS_ERR))
+
+static void setup_lms_f32(dsp_bench_ctx_t *c)
+{
+    arm_lms_init_f32(&c->u.lms_f32, DSP_BENCH_TAPS, LMS_COEFFS(c, float32_t), S(float32_t), 0.01f, c->n);
+}
+
+static void run_arm_lms_f32(dsp_bench_ctx_t *c)
+{
+    arm_lms_f32(&c->u.lms_f32, A(float32_t), B(float32_t), D(float32_t), LMS_ERR(c, float32_t), c->n);
+}
+
+static void setup_lms_q31(dsp_bench_ctx_t *c)
+{
+    arm_lms_init_q31(&c->u.lms_q31, DSP_BENCH_TAPS, LMS_COEFFS(c, q31_t), S(q31_t), 0x01000000, c->n, 0);
+}
+
+static void run_arm_lms_q31(dsp_bench_ctx_t *c)
+{
+    arm_lms_q31(&c->u.lms_q31, A(q31_t), B(q31_t), D(q31_t), LMS_ERR(c, q31_t), c->n);
+}
+
+static void setup_lms_q15(dsp_bench_ctx_t *c)
+{
+    arm_lms_init_q15(&c->u.lms_q15, DSP_BENCH_TAPS, LMS_COEFFS(c, q15_t), S(q15_t), 0x0100, c->n, 0);
+}
+
+static void run_arm_lms_q15(dsp_bench_ctx_t *c)
+{
+    arm_lms_q15(&c->u.lms_q15, A(q15_t), B(q15_t), D(q15_t), LMS_ERR(c, q15_t), c->n);
+}
+
+static void setup_lmsn_f32(dsp_bench_ctx_t *c)
+{
+    arm_lms_norm_init_f32(&c->u.lmsn_f32, DSP_BENCH_TAPS, LMS_COEFFS(c, float32_t), S(float32_t), 0.01f, c->n);
+}
+
+static void run_arm_lms_norm_f32(dsp_bench_ctx_t *c)
+{
+    arm_lms_norm_f32(&c->u.lmsn_f32, A(float32_t), B(float32_t), D(float32_t), LMS_ERR(c, float32_t), c->n);
+}
+
+static void setup_lmsn_q31(dsp_bench_ctx_t *c)
+{
+    arm_lms_norm_init_q31(&c->u.lmsn_q31, DSP_BENCH_TAPS, LMS_COEFFS(c, q31_t), S(q31_t), 0x01000000, c->n, 0);
+}
+
+static void run_arm_lms_norm_q31(dsp_bench_ctx_t *c)
+{
+    arm_lms_norm_q31(&c->u.lmsn_q31, A(q31_t), B(q31_t), D(q31_t), LMS_ERR(c, q31_t), c->n);
+}
+
+static void setup_lmsn_q15(dsp_bench_ctx_t *c)
+{
+    arm_lms_norm_init_q15(&c->u.lmsn_q15, DSP_BENCH_TAPS, LMS_COEFFS(c, q15_t), S(q15_t), 0x0100, c->n, 0);
+}
+
+static void run_arm_lms_norm_q15(dsp_bench_ctx_t *c)
+{
+    arm_lms_norm_q15(&c->u.lmsn_q15, A(q15_t), B(q15_t), D(q15_t), LMS_ERR(c, q15_t), c->n);
+}
+
+/* Convolution and correlation of block samples with DSP_BENCH_TAPS */
+#define CONV(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) { fn(A(T), c->n, B(T), DSP_BENCH_TAPS, D(T)); }
+#define CONV_OPT(fn, T) \
+    static void run_##fn(dsp_bench_ctx_t *c) \
+    { \
+        fn(A(T), c->n, B(T), DSP_BENCH_TAPS, D(T), S(q15_t), S(q15_t) + c->n + 2U * DSP_BENCH_TAPS); \
+    }
+
+CONV(arm_conv_f32, float32_t)
+CONV(arm_conv_q31, q31_t)
+CONV(arm_conv_q15, q15_t)
+CONV(arm_conv_q7, q7_t)
+CONV(arm_conv_fast_q31, q31_t)
+CONV(arm_conv_fast_q15, q15_t)
+CONV_OPT(arm_conv_opt_q15, q15_t)
+CONV_OPT(arm_conv_fast_opt_q15, q15_t)
+CONV_OPT(arm_conv_opt_q7, q7_t)
+CONV(arm_correlate_f32, float32_t)
+CONV(arm_correlate_q31, q31_t)
+CONV(arm_correlate_q15, q15_t)
+CONV(arm_correlate_q7, q7_t)
+CONV(arm_correlate_fast_q31, q31_t)
+CONV(arm_correlate_fast_q15, q15_t)
+CONV_OPT(arm_correlate_opt_q7, q7_t)
+
+static void run_arm_correlate_opt_q15(dsp_bench_ctx_t *c)
+{
+    arm_correlate_opt_q15(A(q15_t), c->n, B(q15_t), DSP_BENCH_TAPS, D(q15_t), S(q15_t));
+}
+
+static void run_arm_correlate_fast_opt_q15(dsp_bench_ctx_t *c)
+{
+    arm_correlate_fast_opt_q15(A(q15_t), c->n, B(q15_t), DSP_BENCH_TAPS, D(q15_t), S(q15_t));
+}
+
+/* ---------------------------------------------------------------------------
+ * Transforms, in place on A restored from P
+ * ------------------------------------------------------------------------ */
+
+static const arm_cfft_instance_f32 *const s_cfft_f32[] =
+{
+    &arm_cfft_sR_f32_len16, &arm_cfft_sR_f32_len32, &arm_cfft_sR_f32_len64, &arm_cfft_sR_f32_len128,
+    &arm_cfft_sR_f32_len256, &arm_cfft_sR_f32_len512, &arm_cfft_sR_f32_len1024,
+    &arm_cfft_sR_f32_len2048, &arm_cfft_sR_f32_len4096,
+};
+
+static const arm_cfft_instance_q31 *const s_cfft_q31[] =
+{
+    &arm_cfft_sR_q31_len16, &arm_cfft_sR_q31_len32, &arm_cfft_sR_q31_len64, &arm_cfft_sR_q31_len128,
+    &arm_cfft_sR_q31_len256, &arm_cfft_sR_q31_len512, &arm_cfft_sR_q31_len1024,
+    &arm_cfft_sR_q31_len2048, &arm_cfft_sR_q31_len4096,
+};
+
+static const arm_cfft_instance_q15 *const s_cfft_q15[] =
+{
+    &arm_cfft_sR_q15_len16, &arm_cfft_sR_q15_len32, &arm_cfft_sR_q15_len64, &arm_cfft_sR_q15_len128,
+    &arm_cfft_sR_q15_len256, &arm_cfft_sR_q15_len512, &arm_cfft_sR_q15_len1024,
+    &arm_cfft_sR_q15_len2048, &arm_cfft_sR_q15_len4096,
+};
+
+/* Index of a power of two from 16 in the tables above */
+static uint32_t fft_index(uint32_t n)
+{
+    uint32_t i = 0;
+
+    while ((16U << i) < n)
+    {
+        i++;
+    }
+    return i;
+}
+
+static void restore_complex(dsp_bench_ctx_t *c)
+{
+    memcpy(c->a, c->p, 8U * c->n);
+}
+
+static void restore_real(dsp_bench_ctx_t *c)
+{
+    memcpy(c->a, c->p, 4U * c->n);
+}
+
+static void run_arm_cfft_f32(dsp_bench_ctx_t *c)
+{
+    arm_cfft_f32(s_cfft_f32[fft_index(c->n)], A(float32_t), 0, 1);
+}
+
+static void run_arm_cfft_q31(dsp_bench_ctx_t *c)
+{
+    arm_cfft_q31(s_cfft_q31[fft_index(c->n)], A(q31_t), 0, 1);
+}
+
+static void run_arm_cfft_q15(dsp_bench_ctx_t *c)
+{
+    arm_cfft_q15(s_cfft_q15[fft_index(c->n)], A(q15_t), 0, 1);
+}
+
+static void run_dsp_bfp_cfft_q31(dsp_bench_ctx_t *c)
+{
+    (void)dsp_bfp_cfft_q31(s_cfft_q31[fft_index(c->n)], A(q31_t), 0, 1);
+}
+
+static void run_dsp_bfp_cfft_q15(dsp_bench_ctx_t *c)
+{
+    (void)dsp_bfp_cfft_q15(s_cfft_q15[fft_index(c->n)], A(q15_t), 0, 1);
+}
+
+static void setup_rfft_fast(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    arm_rfft_fast_init_f32(&c->u.rfft_fast, (uint16_t)c->n);
+}
+
+static void run_arm_rfft_fast_f32(dsp_bench_ctx_t *c)
+{
+    arm_rfft_fast_f32(&c->u.rfft_fast, A(float32_t), D(float32_t), 0);
+}
+
+/* The mixed-radix plans go in S, which holds them at every block size */
+static void setup_mrfft_cfft(dsp_bench_ctx_t *c)
+{
+    restore_complex(c);
+    dsp_mrfft_cfft_init_f32(&c->u.mr_cfft, c->n, c->s, dsp_mrfft_cfft_size_f32(c->n));
+}
+
+static void run_dsp_mrfft_cfft_f32(dsp_bench_ctx_t *c)
+{
+    dsp_mrfft_cfft_f32(&c->u.mr_cfft, A(float32_t), 0);
+}
+
+static void setup_mrfft_rfft(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    dsp_mrfft_rfft_init_f32(&c->u.mr_rfft, c->n, c->s, dsp_mrfft_rfft_size_f32(c->n));
+}
+
+static void run_dsp_mrfft_rfft_f32(dsp_bench_ctx_t *c)
+{
+    dsp_mrfft_rfft_f32(&c->u.mr_rfft, A(float32_t), D(float32_t), 0);
+}
+
+static void setup_rfft_q31(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    arm_rfft_init_q31(&c->u.rfft_q31, c->n, 0, 1);
+}
+
+static void run_arm_rfft_q31(dsp_bench_ctx_t *c)
+{
+    arm_rfft_q31(&c->u.rfft_q31, A(q31_t), D(q31_t));
+}
+
+static void setup_rfft_q15(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    arm_rfft_init_q15(&c->u.rfft_q15, c->n, 0, 1);
+}
+
+static void run_arm_rfft_q15(dsp_bench_ctx_t *c)
+{
+    arm_rfft_q15(&c->u.rfft_q15, A(q15_t), D(q15_t));
+}
+
+static void setup_dct4_f32(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    arm_dct4_init_f32(&c->u.dct_f32.dct, &c->u.dct_f32.rfft, &c->u.dct_f32.cfft, (uint16_t)c->n,
+                      (uint16_t)(c->n / 2U), 0.125f);
+}
+
+static void run_arm_dct4_f32(dsp_bench_ctx_t *c)
+{
+    arm_dct4_f32(&c->u.dct_f32.dct, S(float32_t), A(float32_t));
+}
+
+static void setup_dct4_q31(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    arm_dct4_init_q31(&c->u.dct_q31.dct, &c->u.dct_q31.rfft, &c->u.dct_q31.cfft, (uint16_t)c->n,
+                      (uint16_t)(c->n / 2U), 0x10000000);
+}
+
+static void run_arm_dct4_q31(dsp_bench_ctx_t *c)
+{
+    arm_dct4_q31(&c->u.dct_q31.dct, S(q31_t), A(q31_t));
+}
+
+static void setup_dct4_q15(dsp_bench_ctx_t *c)
+{
+    restore_real(c);
+    arm_dct4_init_q15(&c->u.dct_q15.dct, &c->u.dct_q15.rfft, &c->u.dct_q15.cfft, (uint16_t)c->n,
+                      (uint16_t)(c->n / 2U), 0x1000);
+}
+
+static void run_arm_dct4_q15(dsp_bench_ctx_t *c)
+{
+    arm_dct4_q15(&c->u.dct_q15.dct, S(q15_t), A(q15_t));
+}
+
+/* ---------------------------------------------------------------------------
+ * Matrices: A is rows x cols, B the same shape for add and sub and its
+ * transpose for mult, so a product is rows x rows
+ * ------------------------------------------------------------------------ */
+
+#define MATRIX(sfx, T) \
+    static void setup_mat_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_mat_init_##sfx(&c->u.m_##sfx.a, (uint16_t)c->rows, (uint16_t)c->cols, A(T)); \
+        arm_mat_init_##sfx(&c->u.m_##sfx.b, (uint16_t)c->rows, (uint16_t)c->cols, B(T)); \
+        arm_mat_init_##sfx(&c->u.m_##sfx.d, (uint16_t)c->rows, (uint16_t)c->cols, D(T)); \
+    } \
+    static void setup_mat_mult_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_mat_init_##sfx(&c->u.m_##sfx.a, (uint16_t)c->rows, (uint16_t)c->cols, A(T)); \
+        arm_mat_init_##sfx(&c->u.m_##sfx.b, (uint16_t)c->cols, (uint16_t)c->rows, B(T)); \
+        arm_mat_init_##sfx(&c->u.m_##sfx.d, (uint16_t)c->rows, (uint16_t)c->rows, D(T)); \
+    } \
+    static void setup_mat_trans_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_mat_init_##sfx(&c->u.m_##sfx.a, (uint16_t)c->rows, (uint16_t)c->cols, A(T)); \
+        arm_mat_init_##sfx(&c->u.m_##sfx.d, (uint16_t)c->cols, (uint16_t)c->rows, D(T)); \
+    } \
+    static void run_arm_mat_add_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_mat_add_##sfx(&c->u.m_##sfx.a, &c->u.m_##sfx.b, &c->u.m_##sfx.d); \
+    } \
+    static void run_arm_mat_sub_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_mat_sub_##sfx(&c->u.m_##sfx.a, &c->u.m_##sfx.b, &c->u.m_##sfx.d); \
+    } \
+    static void run_arm_mat_trans_##sfx(dsp_bench_ctx_t *c) \
+    { \
+        arm_mat_trans_##sfx(&c->u.m_##sfx.a, &c->u.m_##sfx.d); \
+    }
+
+MATRIX(f32, float32_t)
+MATRIX(q31, q31_t)
+MATRIX(q15, q15_t)
+
+static void run_arm_mat_scale_f32(dsp_bench_ctx_t *c)
+{
+    arm_mat_scale_f32(&c->u.m_f32.a, 0.5f, &c->u.m_f32.d);
+}
+
+static void run_arm_mat_scale_q31(dsp_bench_ctx_t *c)
+{
+    arm_mat_scale_q31(&c->u.m_q31.a, 0x40000000, 1, &c->u.m_q31.d);
+}
+
+static void run_arm_mat_scale_q15(dsp_bench_ctx_t *c)
+{
+    arm_mat_scale_q15(&c->u.m_q15.a, 0x4000, 1, &c->u.m_q15.d);
+}
+
+static void run_arm_mat_mult_f32(dsp_bench_ctx_t *c)
+{
+    arm_mat_mult_f32(&c->u.m_f32.a, &c->u.m_f32.b, &c->u.m_f32.d);
+}
+
+static void run_arm_mat_mult_q31(dsp_bench_ctx_t *c)
+{
+    arm_mat_mult_q31(&c->u.m_q31.a, &c->u.m_q31.b, &c->u.m_q31.d);
+}
+
+static void run_arm_mat_mult_fast_q31(dsp_bench_ctx_t *c)
+{
+    arm_mat_mult_fast_q31(&c->u.m_q31.a, &c->u.m_q31.b, &c->u.m_q31.d);
+}
+
+static void run_arm_mat_mult_q15(dsp_bench_ctx_t *c)
+{
+    arm_mat_mult_q15(&c->u.m_q15.a, &c->u.m_q15.b, &c->u.m_q15.d, S(q15_t));
+}
+
+static void run_arm_mat_mult_fast_q15(dsp_bench_ctx_t *c)
+{
+    arm_mat_mult_fast_q15(&c->u.m_q15.a, &c->u.m_q15.b, &c->u.m_q15.d, S(q15_t));
+}
+
+static void run_arm_mat_cmplx_mult_f32(dsp_bench_ctx_t *c)
+{
+    arm_mat_cmplx_mult_f32(&c->u.m_f32.a, &c->u.m_f32.b, &c->u.m_f32.d);
+}
+
+static void run_arm_mat_cmplx_mult_q31(dsp_bench_ctx_t *c)
+{
+    arm_mat_cmplx_mult_q31(&c->u.m_q31.a, &c->u.m_q31.b, &c->u.m_q31.d);
+}
+
+static void run_arm_mat_cmplx_mult_q15(dsp_bench_ctx_t *c)
+{
+    arm_mat_cmplx_mult_q15(&c->u.m_q15.a, &c->u.m_q15.b, &c->u.m_q15.d, S(q15_t));
+}
+
+/* The largest square in block elements, made diagonally dominant so that it
+   has an inverse; the inverse overwrites its source */
+static void setup_mat_inverse_f32(dsp_bench_ctx_t *c)
+{
+    uint32_t k = c->rows, i;
+
+    memcpy(c->a, c->p, 4U * k * k);
+    for (i = 0; i < k; i++)
+    {
+        A(float32_t)[i * k + i] += (float32_t)k;
+    }
+    arm_mat_init_f32(&c->u.m_f32.a, (uint16_t)k, (uint16_t)k, A(float32_t));
+    arm_mat_init_f32(&c->u.m_f32.d, (uint16_t)k, (uint16_t)k, D(float32_t));
+}
+
+static void run_arm_mat_inverse_f32(dsp_bench_ctx_t *c)
+{
+    arm_mat_inverse_f32(&c->u.m_f32.a, &c->u.m_f32.d);
+}
+
+/* ---------------------------------------------------------------------------
+ * Table
+ * ------------------------------------------------------------------------ */
+
+#define E(fn, type)                     { #fn, type, 0, NULL, run_##fn }
+#define E_SETUP(fn, type, setup)        { #fn, type, 0, setup, run_##fn }
+#define E_LIMIT(fn, type, lim, setup)   { #fn, type, lim, setup, run_##fn }
+
+static const dsp_bench_entry_t s_entries[] =
+{
+    /* BasicMathFunctions */
+    E(arm_abs_f32, T_F32), E(arm_abs_q31, T_Q31), E(arm_abs_q15, T_Q15), E(arm_abs_q7, T_Q7),
+    E(arm_add_f32, T_F32), E(arm_add_q31, T_Q31), E(arm_add_q15, T_Q15), E(arm_add_q7, T_Q7),
+    E(arm_dot_prod_f32, T_F32), E(arm_dot_prod_q31, T_Q31), E(arm_dot_prod_q15, T_Q15),
+    E(arm_dot_prod_q7, T_Q7),
+    E(arm_mult_f32, T_F32), E(arm_mult_q31, T_Q31), E(arm_mult_q15, T_Q15), E(arm_mult_q7, T_Q7),
+    E(arm_negate_f32, T_F32), E(arm_negate_q31, T_Q31), E(arm_negate_q15, T_Q15),
+    E(arm_negate_q7, T_Q7),
+    E(arm_offset_f32, T_F32), E(arm_offset_q31, T_Q31), E(arm_offset_q15, T_Q15),
+    E(arm_offset_q7, T_Q7),
+    E(arm_scale_f32, T_F32), E(arm_scale_q31, T_Q31), E(arm_scale_q15, T_Q15), E(arm_scale_q7, T_Q7),
+    E(arm_shift_q31, T_Q31), E(arm_shift_q15, T_Q15), E(arm_shift_q7, T_Q7),
+    E(arm_sub_f32, T_F32), E(arm_sub_q31, T_Q31), E(arm_sub_q15, T_Q15), E(arm_sub_q7, T_Q7),
+
+    /* ComplexMathFunctions */
+    E(arm_cmplx_conj_f32, T_F32), E(arm_cmplx_conj_q31, T_Q31), E(arm_cmplx_conj_q15, T_Q15),
+    E(arm_cmplx_dot_prod_f32, T_F32), E(arm_cmplx_dot_prod_q31, T_Q31),
+    E(arm_cmplx_dot_prod_q15, T_Q15),
+    E(arm_cmplx_mag_f32, T_F32), E(arm_cmplx_mag_q31, T_Q31), E(arm_cmplx_mag_q15, T_Q15),
+    E(arm_cmplx_mag_squared_f32, T_F32), E(arm_cmplx_mag_squared_q31, T_Q31),
+    E(arm_cmplx_mag_squared_q15, T_Q15),
+    E(arm_cmplx_mult_cmplx_f32, T_F32), E(arm_cmplx_mult_cmplx_q31, T_Q31),
+    E(arm_cmplx_mult_cmplx_q15, T_Q15),
+    E(arm_cmplx_mult_real_f32, T_F32), E(arm_cmplx_mult_real_q31, T_Q31),
+    E(arm_cmplx_mult_real_q15, T_Q15),
+
+    /* ControllerFunctions */
+    E_SETUP(arm_pid_f32, T_F32, setup_pid_f32), E_SETUP(arm_pid_q31, T_Q31, setup_pid_q31),
+    E_SETUP(arm_pid_q15, T_Q15, setup_pid_q15),
+    E(arm_sin_cos_f32, T_F32), E(arm_sin_cos_q31, T_Q31),
+
+    /* FastMathFunctions */
+    E(arm_cos_f32, T_F32), E_LIMIT(arm_cos_q31, T_Q31, L_POSITIVE, NULL),
+    E_LIMIT(arm_cos_q15, T_Q15, L_POSITIVE, NULL),
+    E(arm_sin_f32, T_F32), E_LIMIT(arm_sin_q31, T_Q31, L_POSITIVE, NULL),
+    E_LIMIT(arm_sin_q15, T_Q15, L_POSITIVE, NULL),
+    E_LIMIT(arm_sqrt_q31, T_Q31, L_POSITIVE, NULL), E_LIMIT(arm_sqrt_q15, T_Q15, L_POSITIVE, NULL),
+
+    /* FilteringFunctions */
+    E_SETUP(arm_biquad_cascade_df1_f32, T_F32, setup_bq_f32),
+    E_SETUP(arm_biquad_cascade_df1_q31, T_Q31, setup_bq_q31),
+    E_SETUP(arm_biquad_cascade_df1_fast_q31, T_Q31, setup_bq_q31),
+    E_SETUP(arm_biquad_cascade_df1_q15, T_Q15, setup_bq_q15),
+    E_SETUP(arm_biquad_cascade_df1_fast_q15, T_Q15, setup_bq_q15),
+    E_SETUP(arm_biquad_cas_df1_32x64_q31, T_Q31, setup_bq_32x64),
+    E_SETUP(arm_biquad_cascade_df2T_f32, T_F32, setup_df2t_f32),
+    E_SETUP(arm_biquad_cascade_stereo_df2T_f32, T_F32, setup_sdf2t_f32),
+    E(arm_conv_f32, T_F32), E(arm_conv_q31, T_Q31), E(arm_conv_q15, T_Q15), E(arm_conv_q7, T_Q7),
+    E(arm_conv_fast_q31, T_Q31), E(arm_conv_fast_q15, T_Q15), E(arm_conv_opt_q15, T_Q15),
+    E(arm_conv_fast_opt_q15, T_Q15), E(arm_conv_opt_q7, T_Q7),
+    E(arm_correlate_f32, T_F32), E(arm_correlate_q31, T_Q31), E(arm_correlate_q15, T_Q15),
+    E(arm_correlate_q7, T_Q7), E(arm_correlate_fast_q31, T_Q31), E(arm_correlate_fast_q15, T_Q15),
+    E(arm_correlate_opt_q15, T_Q15), E(arm_correlate_fast_opt_q15, T_Q15),
+    E(arm_correlate_opt_q7, T_Q7),
+    E_SETUP(arm_fir_f32, T_F32, setup_fir_f32), E_SETUP(arm_fir_q31, T_Q31, setup_fir_q31),
+    E_SETUP(arm_fir_q15, T_Q15, setup_fir_q15), E_SETUP(arm_fir_q7, T_Q7, setup_fir_q7),
+    E_SETUP(arm_fir_fast_q31, T_Q31, setup_fir_q31), E_SETUP(arm_fir_fast_q15, T_Q15, setup_fir_q15),
+    E_SETUP(arm_fir_decimate_f32, T_F32, setup_dec_f32),
+    E_SETUP(arm_fir_decimate_q31, T_Q31, setup_dec_q31),
+    E_SETUP(arm_fir_decimate_q15, T_Q15, setup_dec_q15),
+    E_SETUP(arm_fir_decimate_fast_q31, T_Q31, setup_dec_q31),
+    E_SETUP(arm_fir_decimate_fast_q15, T_Q15, setup_dec_q15),
+    E_SETUP(arm_fir_interpolate_f32, T_F32, setup_int_f32),
+    E_SETUP(arm_fir_interpolate_q31, T_Q31, setup_int_q31),
+    E_SETUP(arm_fir_interpolate_q15, T_Q15, setup_int_q15),
+    E_SETUP(arm_fir_lattice_f32, T_F32, setup_fl_f32), E_SETUP(arm_fir_lattice_q31, T_Q31, setup_fl_q31),
+    E_SETUP(arm_fir_lattice_q15, T_Q15, setup_fl_q15),
+    E_SETUP(arm_fir_sparse_f32, T_F32, setup_sp_f32), E_SETUP(arm_fir_sparse_q31, T_Q31, setup_sp_q31),
+    E_SETUP(arm_fir_sparse_q15, T_Q15, setup_sp_q15), E_SETUP(arm_fir_sparse_q7, T_Q7, setup_sp_q7),
+    E_SETUP(arm_iir_lattice_f32, T_F32, setup_il_f32), E_SETUP(arm_iir_lattice_q31, T_Q31, setup_il_q31),
+    E_SETUP(arm_iir_lattice_q15, T_Q15, setup_il_q15),
+    E_SETUP(arm_lms_f32, T_F32, setup_lms_f32), E_SETUP(arm_lms_q31, T_Q31, setup_lms_q31),
+    E_SETUP(arm_lms_q15, T_Q15, setup_lms_q15),
+    E_SETUP(arm_lms_norm_f32, T_F32, setup_lmsn_f32), E_SETUP(arm_lms_norm_q31, T_Q31, setup_lmsn_q31),
+    E_SETUP(arm_lms_norm_q15, T_Q15, setup_lmsn_q15),
+
+    /* MatrixFunctions */
+    E_SETUP(arm_mat_add_f32, T_F32, setup_mat_f32), E_SETUP(arm_mat_add_q31, T_Q31, setup_mat_q31),
+    E_SETUP(arm_mat_add_q15, T_Q15, setup_mat_q15),
+    E_SETUP(arm_mat_cmplx_mult_f32, T_F32, setup_mat_mult_f32),
+    E_SETUP(arm_mat_cmplx_mult_q31, T_Q31, setup_mat_mult_q31),
+    E_SETUP(arm_mat_cmplx_mult_q15, T_Q15, setup_mat_mult_q15),
+    E_SETUP(arm_mat_inverse_f32, T_F32, setup_mat_inverse_f32),
+    E_SETUP(arm_mat_mult_f32, T_F32, setup_mat_mult_f32),
+    E_SETUP(arm_mat_mult_q31, T_Q31, setup_mat_mult_q31),
+    E_SETUP(arm_mat_mult_q15, T_Q15, setup_mat_mult_q15),
+    E_SETUP(arm_mat_mult_fast_q31, T_Q31, setup_mat_mult_q31),
+    E_SETUP(arm_mat_mult_fast_q15, T_Q15, setup_mat_mult_q15),
+    E_SETUP(arm_mat_scale_f32, T_F32, setup_mat_f32), E_SETUP(arm_mat_scale_q31, T_Q31, setup_mat_q31),
+    E_SETUP(arm_mat_scale_q15, T_Q15, setup_mat_q15),
+    E_SETUP(arm_mat_sub_f32, T_F32, setup_mat_f32), E_SETUP(arm_mat_sub_q31, T_Q31, setup_mat_q31),
+    E_SETUP(arm_mat_sub_q15, T_Q15, setup_mat_q15),
+    E_SETUP(arm_mat_trans_f32, T_F32, setup_mat_trans_f32),
+    E_SETUP(arm_mat_trans_q31, T_Q31, setup_mat_trans_q31),
+    E_SETUP(arm_mat_trans_q15, T_Q15, setup_mat_trans_q15),
+
+    /* StatisticsFunctions */
+    E(arm_max_f32, T_F32), E(arm_max_q31, T_Q31), E(arm_max_q15, T_Q15), E(arm_max_q7, T_Q7),
+    E(arm_mean_f32, T_F32), E(arm_mean_q31, T_Q31), E(arm_mean_q15, T_Q15), E(arm_mean_q7, T_Q7),
+    E(arm_min_f32, T_F32), E(arm_min_q31, T_Q31), E(arm_min_q15, T_Q15), E(arm_min_q7, T_Q7),
+    E(arm_power_f32, T_F32), E(arm_power_q31, T_Q31), E(arm_power_q15, T_Q15), E(arm_power_q7, T_Q7),
+    E(arm_rms_f32, T_F32), E(arm_rms_q31, T_Q31), E(arm_rms_q15, T_Q15),
+    E(arm_std_f32, T_F32), E(arm_std_q31, T_Q31), E(arm_std_q15, T_Q15),
+    E(arm_var_f32, T_F32), E(arm_var_q31, T_Q31), E(arm_var_q15, T_Q15),
+
+    /* SupportFunctions */
+    E(arm_copy_f32, T_F32), E(arm_copy_q31, T_Q31), E(arm_copy_q15, T_Q15), E(arm_copy_q7, T_Q7),
+    E(arm_fill_f32, T_F32), E(arm_fill_q31, T_Q31), E(arm_fill_q15, T_Q15), E(arm_fill_q7, T_Q7),
+    E(arm_float_to_q31, T_F32), E(arm_float_to_q15, T_F32), E(arm_float_to_q7, T_F32),
+    E(arm_q31_to_float, T_Q31), E(arm_q31_to_q15, T_Q31), E(arm_q31_to_q7, T_Q31),
+    E(arm_q15_to_float, T_Q15), E(arm_q15_to_q31, T_Q15), E(arm_q15_to_q7, T_Q15),
+    E(arm_q7_to_float, T_Q7), E(arm_q7_to_q31, T_Q7), E(arm_q7_to_q15, T_Q7),
+
+    /* TransformFunctions */
+    E_LIMIT(arm_cfft_f32, T_F32, L_FFT, restore_complex),
+    E_LIMIT(arm_cfft_q31, T_Q31, L_FFT, restore_complex),
+    E_LIMIT(arm_cfft_q15, T_Q15, L_FFT, restore_complex),
+    E_LIMIT(dsp_bfp_cfft_q31, T_Q31, L_FFT, restore_complex),
+    E_LIMIT(dsp_bfp_cfft_q15, T_Q15, L_FFT, restore_complex),
+    E_LIMIT(arm_rfft_fast_f32, T_F32, L_FFT | L_RFFT, setup_rfft_fast),
+    E_LIMIT(arm_rfft_q31, T_Q31, L_RFFT, setup_rfft_q31),
+    E_LIMIT(arm_rfft_q15, T_Q15, L_RFFT, setup_rfft_q15),
+    E_SETUP(dsp_mrfft_cfft_f32, T_F32, setup_mrfft_cfft),
+    E_LIMIT(dsp_mrfft_rfft_f32, T_F32, L_RFFT, setup_mrfft_rfft),
+    E_LIMIT(arm_dct4_f32, T_F32, L_DCT, setup_dct4_f32),
+    E_LIMIT(arm_dct4_q31, T_Q31, L_DCT, setup_dct4_q31),
+    E_LIMIT(arm_dct4_q15, T_Q15, L_DCT, setup_dct4_q15),
+};
+
+/* ---------------------------------------------------------------------------
+ * Runner
+ * ------------------------------------------------------------------------ */
+
+static const char *const s_type_names[T_TYPES] = { "f32", "q31", "q15", "q7" };
+static const uint8_t s_type_size[T_TYPES] = { 4, 4, 2, 1 };
+
+static uint32_t s_rng;
+
+static uint32_t dsp_bench_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/* Random data of the entry's type, at a quarter of full scale so that sums
+   rarely saturate, into the whole of a region */
+static void dsp_bench_fill(void *region, uint32_t bytes, uint8_t type, uint8_t limits)
+{
+    uint32_t i, r;
+
+    for (i = 0; i < bytes / s_type_size[type]; i++)
+    {
+        r = dsp_bench_rand();
+        if (limits & L_POSITIVE)
+        {
+            r &= 0x7FFFFFFFU;
+        }
+        switch (type)
+        {
+        case T_F32:
+            ((float32_t *)region)[i] = (float32_t)((int32_t)r >> 2) / 2147483648.0f;
+            break;
+        case T_Q31:
+            ((q31_t *)region)[i] = (q31_t)r >> 2;
+            break;
+        case T_Q15:
+            ((q15_t *)region)[i] = (q15_t)((q31_t)r >> 18);
+            break;
+        default:
+            ((q7_t *)region)[i] = (q7_t)((q31_t)r >> 26);
+            break;
+        }
+    }
+}
+
+static int dsp_bench_supports(const dsp_bench_entry_t *e, uint32_t n)
+{
+    if ((e->limits & L_FFT) && (n > DSP_BENCH_FFT_MAX))
+    {
+        return 0;
+    }
+    if ((e->limits & L_RFFT) && (n < 32U))
+    {
+        return 0;
+    }
+    if ((e->limits & L_DCT) && (n != 128U) && (n != 512U) && (n != 2048U))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+static void dsp_bench_json_string(char *out, size_t size, const char *s)
+{
+    size_t i = 0;
+
+    while ((*s != '\0') && (i + 3U < size))
+    {
+        if ((*s == '"') || (*s == '\\'))
+        {
+            out[i++] = '\\';
+        }
+        out[i++] = *s++;
+    }
+    out[i] = '\0';
+}
+
+static void dsp_bench_header(const dsp_bench_port_t *port, uint32_t overhead)
+{
+    char line[DSP_BENCH_LINE], build[96];
+
+    dsp_bench_json_string(build, sizeof(build), (port->build != NULL) ? port->build : "");
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line),
+                 "{\"run\":\"dsp_bench\",\"clock\":\"%s\",\"hz\":%lu,\"overhead\":%lu,"
+                 "\"repeat\":%lu,\"taps\":%d,\"build\":\"%s\"}",
+                 port->clock, (unsigned long)port->hz, (unsigned long)overhead,
+                 (unsigned long)port->repeat, DSP_BENCH_TAPS, build);
+        port->write(line);
+        return;
+    }
+
+    snprintf(line, sizeof(line), "# dsp_bench clock=%s hz=%lu overhead=%lu repeat=%lu taps=%d",
+             port->clock, (unsigned long)port->hz, (unsigned long)overhead,
+             (unsigned long)port->repeat, DSP_BENCH_TAPS);
+    port->write(line);
+    snprintf(line, sizeof(line), "# build %s", build);
+    port->write(line);
+    port->write("function,type,block,align,min,mean,per_sample");
+}
+
+static void dsp_bench_point(const dsp_bench_port_t *port, const dsp_bench_entry_t *e, uint32_t n,
+                            int offset, uint32_t min, uint32_t mean)
+{
+    char line[DSP_BENCH_LINE];
+    /* Cycles per sample with two decimals, without floating point printf */
+    uint32_t hundredths = (uint32_t)(((uint64_t)min * 100U + n / 2U) / n);
+
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line),
+                 "{\"function\":\"%s\",\"type\":\"%s\",\"block\":%lu,\"align\":\"%s\","
+                 "\"min\":%lu,\"mean\":%lu,\"per_sample\":%lu.%02lu}",
+                 e->name, s_type_names[e->type], (unsigned long)n, offset ? "offset" : "aligned",
+                 (unsigned long)min, (unsigned long)mean,
+                 (unsigned long)(hundredths / 100U), (unsigned long)(hundredths % 100U));
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "%s,%s,%lu,%s,%lu,%lu,%lu.%02lu",
+                 e->name, s_type_names[e->type], (unsigned long)n, offset ? "offset" : "aligned",
+                 (unsigned long)min, (unsigned long)mean,
+                 (unsigned long)(hundredths / 100U), (unsigned long)(hundredths % 100U));
+    }
+    port->write(line);
+}
+
+/* Smallest time between two counter reads */
+static uint32_t dsp_bench_overhead(const dsp_bench_port_t *port)
+{
+    uint32_t best = UINT32_MAX, t, i;
+
+    for (i = 0; i < 32U; i++)
+    {
+        t = port->cycles();
+        t = port->cycles() - t;
+        best = (t < best) ? t : best;
+    }
+    return best;
+}
+
+static void dsp_bench_call(const dsp_bench_entry_t *e, dsp_bench_ctx_t *c)
+{
+    if (e->setup != NULL)
+    {
+        e->setup(c);
+    }
+    e->run(c);
+}
+
+int dsp_bench_run(const dsp_bench_port_t *port)
+{
+    dsp_bench_ctx_t c;
+    uint8_t *region[5];
+    uint32_t region_size, overhead, n, r, t, min, lg;
+    uint64_t sum;
+    size_t i, k;
+    int offset, points = 0;
+
+    if ((port == NULL) || (port->cycles == NULL) || (port->write == NULL) || (port->arena == NULL) ||
+        (port->min_block < DSP_BENCH_MIN_BLOCK) || (port->max_block < port->min_block) ||
+        (port->repeat == 0U))
+    {
+        return -1;
+    }
+
+    region_size = 8U * port->max_block + 128U;
+    for (k = 0; k < 5U; k++)
+    {
+        region[k] = (uint8_t *)port->arena + k * region_size;
+    }
+    overhead = dsp_bench_overhead(port);
+    dsp_bench_header(port, overhead);
+
+    for (i = 0; i < sizeof(s_entries) / sizeof(s_entries[0]); i++)
+    {
+        const dsp_bench_entry_t *e = &s_entries[i];
+
+        if ((port->filter != NULL) && (strstr(e->name, port->filter) == NULL))
+        {
+            continue;
+        }
+
+        /* The same data for every run of the suite */
+        s_rng = 0x2545F491U + (uint32_t)i;
+        memset(&c, 0, sizeof(c));
+
+        for (offset = 0; offset <= 1; offset++)
+        {
+            /* Aligned: 8 bytes, as the arena. Offset: one element further. */
+            k = offset ? s_type_size[e->type] : 0U;
+            c.a = region[0] + k;
+            c.b = region[1] + k;
+            c.d = region[2] + k;
+            c.s = region[3];
+            c.p = region[4];
+            dsp_bench_fill(c.p, region_size - 8U, e->type, e->limits);
+            memcpy(c.a, c.p, region_size - 8U);
+            dsp_bench_fill(c.b, region_size - 8U, e->type, e->limits);
+
+            for (n = port->min_block; n <= port->max_block; n <<= 1)
+            {
+                if (!dsp_bench_supports(e, n))
+                {
+                    continue;
+                }
+                c.n = n;
+                for (lg = 0; (2UL << lg) <= n; lg++)
+                {
+                }
+                c.rows = 1UL << (lg / 2U);
+                c.cols = n / c.rows;
+
+                /* Warm caches and flash prefetch, untimed */
+                dsp_bench_call(e, &c);
+
+                min = UINT32_MAX;
+                sum = 0;
+                for (r = 0; r < port->repeat; r++)
+                {
+                    if (e->setup != NULL)
+                    {
+                        e->setup(&c);
+                    }
+                    if (port->enter != NULL)
+                    {
+                        port->enter();
+                    }
+                    t = port->cycles();
+                    e->run(&c);
+                    t = port->cycles() - t;
+                    if (port->leave != NULL)
+                    {
+                        port->leave();
+                    }
+                    t = (t > overhead) ? (t - overhead) : 0U;
+                    min = (t < min) ? t : min;
+                    sum += t;
+                }
+                dsp_bench_point(port, e, n, offset, min, (uint32_t)((sum + port->repeat / 2U) / port->repeat));
+                points++;
+            }
+        }
+    }
+    return points;
+}
+
+/* ---------------------------------------------------------------------------
+ * FIR crossover
+ * ------------------------------------------------------------------------ */
+
+#define DSP_BENCH_PARTS         8U      /* Partition lengths, 16 .. DSP_OLS_MAX_PART */
+
+typedef struct
+{
+    float32_t *x, *y, *ref;
+    uint32_t block;
+    arm_fir_instance_f32 fir;
+    dsp_ols_fir_instance_f32 ols;
+} dsp_bench_xover_t;
+
+static void dsp_bench_xover_call(dsp_bench_xover_t *x, uint32_t part)
+{
+    if (part == 0U)
+    {
+        arm_fir_f32(&x->fir, x->x, x->y, x->block);
+    }
+    else
+    {
+        (void)dsp_ols_fir_f32(&x->ols, x->x, x->y, x->block);
+    }
+}
+
+/* Minimum and mean of repeat calls, the filter state running on */
+static uint32_t dsp_bench_xover_time(const dsp_bench_port_t *port, uint32_t overhead, dsp_bench_xover_t *x,
+                                     uint32_t part, uint32_t *mean)
+{
+    uint32_t min = UINT32_MAX, r, t;
+    uint64_t sum = 0;
+
+    for (r = 0; r < port->repeat; r++)
+    {
+        if (port->enter != NULL)
+        {
+            port->enter();
+        }
+        t = port->cycles();
+        dsp_bench_xover_call(x, part);
+        t = port->cycles() - t;
+        if (port->leave != NULL)
+        {
+            port->leave();
+        }
+        t = (t > overhead) ? (t - overhead) : 0U;
+        min = (t < min) ? t : min;
+        sum += t;
+    }
+    *mean = (uint32_t)((sum + port->repeat / 2U) / port->repeat);
+    return min;
+}
+
+/* Whether y matches ref to within 1e-4 of the largest output */
+static int dsp_bench_xover_check(const dsp_bench_xover_t *x)
+{
+    float32_t peak = 0.0f, err = 0.0f, d;
+    uint32_t i;
+
+    for (i = 0; i < x->block; i++)
+    {
+        d = x->y[i] - x->ref[i];
+        d = (d < 0.0f) ? -d : d;
+        err = (d > err) ? d : err;
+        d = (x->ref[i] < 0.0f) ? -x->ref[i] : x->ref[i];
+        peak = (d > peak) ? d : peak;
+    }
+    return err <= 1e-4f * peak;
+}
+
+/* From a clear state: whether dsp_ols_fir_f32() refuses a block that is not
+   whole partitions, and dsp_ols_fir_stream_f32(), fed the block in pieces
+   shorter and longer than a partition, gives ref delayed by part */
+static int dsp_bench_xover_stream(dsp_bench_xover_t *x, uint32_t part)
+{
+    dsp_bench_xover_t tail = *x;
+    uint32_t i, n;
+
+    if (dsp_ols_fir_f32(&x->ols, x->x, x->y, part + 1U) != ARM_MATH_LENGTH_ERROR)
+    {
+        return 0;
+    }
+
+    for (i = 0, n = 1U; i < x->block; i += n, n = (n * 5U + 3U) % (2U * part) + 1U)
+    {
+        n = (n < x->block - i) ? n : (x->block - i);
+        dsp_ols_fir_stream_f32(&x->ols, x->x + i, x->y + i, n);
+    }
+
+    for (i = 0; i < part; i++)
+    {
+        if (x->y[i] != 0.0f)
+        {
+            return 0;
+        }
+    }
+    tail.y = x->y + part;
+    tail.block = x->block - part;
+    return dsp_bench_xover_check(&tail);
+}
+
+static void dsp_bench_xover_point(const dsp_bench_port_t *port, uint32_t taps, uint32_t part, uint32_t block,
+                                  uint32_t min, uint32_t mean, int ok)
+{
+    char line[DSP_BENCH_LINE];
+    uint32_t hundredths = (uint32_t)(((uint64_t)min * 100U + block / 2U) / block);
+
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line),
+                 "{\"taps\":%lu,\"partition\":%lu,\"min\":%lu,\"mean\":%lu,\"per_sample\":%lu.%02lu,"
+                 "\"check\":\"%s\"}",
+                 (unsigned long)taps, (unsigned long)part, (unsigned long)min, (unsigned long)mean,
+                 (unsigned long)(hundredths / 100U), (unsigned long)(hundredths % 100U), ok ? "ok" : "fail");
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "%lu,%lu,%lu,%lu,%lu.%02lu,%s",
+                 (unsigned long)taps, (unsigned long)part, (unsigned long)min, (unsigned long)mean,
+                 (unsigned long)(hundredths / 100U), (unsigned long)(hundredths % 100U), ok ? "ok" : "fail");
+    }
+    port->write(line);
+}
+
+int dsp_bench_fir_crossover(const dsp_bench_port_t *port, uint32_t max_taps)
+{
+    dsp_bench_xover_t x;
+    char line[DSP_BENCH_LINE], build[96];
+    float32_t *coeffs, *state;
+    void *mem;
+    uint32_t block, parts, part, taps, step, overhead, min, mean, fir_min, size;
+    uint32_t cross[DSP_BENCH_PARTS];
+    int stream[DSP_BENCH_PARTS];
+    int ok, points = 0;
+
+    block = (port != NULL) ? port->max_block : 0U;
+    if ((port == NULL) || (port->cycles == NULL) || (port->write == NULL) || (port->arena == NULL) ||
+        (port->min_block < DSP_BENCH_MIN_BLOCK) || (block < port->min_block) || ((block & (block - 1U)) != 0U) ||
+        (port->repeat == 0U) || (max_taps < 16U))
+    {
+        return -1;
+    }
+
+    x.block = block;
+    x.x = (float32_t *)port->arena;
+    x.y = x.x + block;
+    x.ref = x.y + block;
+    coeffs = x.ref + block;
+    state = coeffs + max_taps;
+    mem = state + max_taps + block;
+    size = 4U * (4U * max_taps + 11U * block);
+
+    overhead = dsp_bench_overhead(port);
+    dsp_bench_json_string(build, sizeof(build), (port->build != NULL) ? port->build : "");
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line),
+                 "{\"run\":\"fir_crossover\",\"clock\":\"%s\",\"hz\":%lu,\"overhead\":%lu,"
+                 "\"repeat\":%lu,\"block\":%lu,\"build\":\"%s\"}",
+                 port->clock, (unsigned long)port->hz, (unsigned long)overhead,
+                 (unsigned long)port->repeat, (unsigned long)block, build);
+        port->write(line);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "# dsp_bench fir_crossover clock=%s hz=%lu overhead=%lu repeat=%lu block=%lu",
+                 port->clock, (unsigned long)port->hz, (unsigned long)overhead,
+                 (unsigned long)port->repeat, (unsigned long)block);
+        port->write(line);
+        snprintf(line, sizeof(line), "# build %s", build);
+        port->write(line);
+        port->write("taps,partition,min,mean,per_sample,check");
+    }
+
+    memset(cross, 0, sizeof(cross));
+    for (parts = 0; parts < DSP_BENCH_PARTS; parts++)
+    {
+        stream[parts] = 1;
+    }
+    s_rng = 0x2545F491U;
+    dsp_bench_fill(x.x, 4U * block, T_F32, 0);
+
+    /* 16, 20, 24, 28, 32, 40, .. : four steps per octave */
+    for (step = 8U; (taps = (4U + step % 4U) << (step / 4U)) <= max_taps; step++)
+    {
+        dsp_bench_fill(coeffs, 4U * taps, T_F32, 0);
+
+        /* The first call of each, from a clear state, is the check */
+        arm_fir_init_f32(&x.fir, (uint16_t)taps, coeffs, state, block);
+        arm_fir_f32(&x.fir, x.x, x.ref, block);
+        fir_min = dsp_bench_xover_time(port, overhead, &x, 0U, &mean);
+        dsp_bench_xover_point(port, taps, 0U, block, fir_min, mean, 1);
+        points++;
+
+        for (parts = 0, part = port->min_block; (part <= block) && (part <= DSP_OLS_MAX_PART); parts++, part <<= 1)
+        {
+            if (dsp_ols_fir_init_f32(&x.ols, taps, coeffs, part, mem, size) != ARM_MATH_SUCCESS)
+            {
+                continue;
+            }
+            (void)dsp_ols_fir_f32(&x.ols, x.x, x.y, block);
+            ok = dsp_bench_xover_check(&x);
+            min = dsp_bench_xover_time(port, overhead, &x, part, &mean);
+            dsp_bench_xover_point(port, taps, part, block, min, mean, ok);
+            points++;
+
+            (void)dsp_ols_fir_init_f32(&x.ols, taps, coeffs, part, mem, size);
+            stream[parts] &= dsp_bench_xover_stream(&x, part);
+
+            /* The smallest count from which it stays faster */
+            if (min >= fir_min)
+            {
+                cross[parts] = 0;
+            }
+            else if (cross[parts] == 0U)
+            {
+                cross[parts] = taps;
+            }
+        }
+    }
+
+    for (parts = 0, part = port->min_block; (part <= block) && (part <= DSP_OLS_MAX_PART); parts++, part <<= 1)
+    {
+        if (port->format == DSP_BENCH_JSON)
+        {
+            snprintf(line, sizeof(line), "{\"crossover\":%lu,\"partition\":%lu,\"stream\":\"%s\"}",
+                     (unsigned long)cross[parts], (unsigned long)part, stream[parts] ? "ok" : "fail");
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "# crossover partition=%lu taps=%lu stream=%s",
+                     (unsigned long)part, (unsigned long)cross[parts], stream[parts] ? "ok" : "fail");
+        }
+        port->write(line);
+    }
+    return points;
+}
+
+/* ---------------------------------------------------------------------------
+ * Sample rate converters
+ * ------------------------------------------------------------------------ */
+
+#define DSP_BENCH_RS_CHUNK      4096U   /* Interpolator outputs per call in the chain */
+#define DSP_BENCH_RS_CHECKED    256U    /* Outputs compared with the tone */
+#define DSP_BENCH_RS_TOLERANCE  1e-3    /* Of full scale, the tone at half scale */
+
+enum
+{
+    RS_CHAIN = 0,
+    RS_SINGLE,
+    RS_MULTI,
+    RS_METHODS
+};
+
+static const char *const s_rs_names[RS_METHODS] = { "chain", "single", "multi" };
+
+/* Output rate / input rate: 44.1 to 16 kHz and back, 48 to 44.1 kHz and
+   back, 48 to 16 kHz and 32 to 48 kHz */
+static const uint16_t s_rs_ratios[][2] = {
+    { 160, 441 }, { 441, 160 }, { 147, 160 }, { 160, 147 }, { 1, 3 }, { 3, 2 }
+};
+
+typedef struct
+{
+    uint8_t type;                       /* T_F32 or T_Q15 */
+    uint8_t method;
+    uint32_t L, M, block, chunk;
+    uint32_t out_max;                   /* Room in y */
+    uint32_t skip;                      /* Of the chain, into the next interpolator output */
+    void *x, *y, *tmp;
+    dsp_resample_instance_f32 rs_f32;   /* The single stage one, then the multi-stage one */
+    dsp_resample_instance_q15 rs_q15;
+    arm_fir_interpolate_instance_f32 int_f32;
+    arm_fir_interpolate_instance_q15 int_q15;
+} dsp_bench_rs_t;
+
+/* The naive chain: arm_fir_interpolate_* by L with the one-stage filter,
+   then every Mth sample. arm_fir_decimate_* would filter again at L times
+   the input rate for nothing, and takes M up to 255 only. */
+static uint32_t dsp_bench_rs_chain(dsp_bench_rs_t *r)
+{
+    uint32_t i, j, n, out = 0;
+
+    for (i = 0; i < r->block; i += n)
+    {
+        n = (r->block - i < r->chunk) ? (r->block - i) : r->chunk;
+        if (r->type == T_F32)
+        {
+            arm_fir_interpolate_f32(&r->int_f32, (float32_t *)r->x + i, (float32_t *)r->tmp, n);
+            for (j = r->skip; j < n * r->L; j += r->M)
+            {
+                ((float32_t *)r->y)[out++] = ((float32_t *)r->tmp)[j];
+            }
+        }
+        else
+        {
+            arm_fir_interpolate_q15(&r->int_q15, (q15_t *)r->x + i, (q15_t *)r->tmp, n);
+            for (j = r->skip; j < n * r->L; j += r->M)
+            {
+                ((q15_t *)r->y)[out++] = ((q15_t *)r->tmp)[j];
+            }
+        }
+        r->skip = j - n * r->L;
+    }
+    return out;
+}
+
+static uint32_t dsp_bench_rs_call(dsp_bench_rs_t *r)
+{
+    if (r->method == RS_CHAIN)
+    {
+        return dsp_bench_rs_chain(r);
+    }
+    return (r->type == T_F32) ? dsp_resample_f32(&r->rs_f32, (float32_t *)r->x, (float32_t *)r->y, r->block) :
+                                dsp_resample_q15(&r->rs_q15, (q15_t *)r->x, (q15_t *)r->y, r->block);
+}
+
+/* From a clear state: a tone at 0.3 of the lower rate, half scale, against
+   the same tone delayed by the filters, once they are past the start */
+static int dsp_bench_rs_check(dsp_bench_rs_t *r, float32_t delay)
+{
+    double f = 0.3 * ((r->L < r->M) ? (double)r->L / (double)r->M : 1.0), start = 2.0 * delay + 4.0;
+    double t, v, d, err = 0.0;
+    uint32_t in = 0, out = 0, checked = 0, i, n;
+
+    while ((checked < DSP_BENCH_RS_CHECKED) && (in < 64U * r->block + 2U * (uint32_t)start))
+    {
+        for (i = 0; i < r->block; i++)
+        {
+            v = 0.5 * sin(2.0 * 3.14159265358979324 * f * (in + i));
+            if (r->type == T_F32)
+            {
+                ((float32_t *)r->x)[i] = (float32_t)v;
+            }
+            else
+            {
+                ((q15_t *)r->x)[i] = (q15_t)floor(v * 32768.0 + 0.5);
+            }
+        }
+        in += r->block;
+
+        n = dsp_bench_rs_call(r);
+        for (i = 0; i < n; i++, out++)
+        {
+            t = (double)out * r->M / r->L;
+            if (t < start)
+            {
+                continue;
+            }
+            v = (r->type == T_F32) ? ((float32_t *)r->y)[i] : ((q15_t *)r->y)[i] / 32768.0;
+            d = fabs(v - 0.5 * sin(2.0 * 3.14159265358979324 * f * (t - delay)));
+            err = (d > err) ? d : err;
+            checked++;
+        }
+    }
+    return (checked >= DSP_BENCH_RS_CHECKED) && (err <= DSP_BENCH_RS_TOLERANCE);
+}
+
+/* Minimum and mean of repeat calls, the state running on */
+static uint32_t dsp_bench_rs_time(const dsp_bench_port_t *port, uint32_t overhead, dsp_bench_rs_t *r,
+                                  uint32_t *mean)
+{
+    uint32_t min = UINT32_MAX, i, t;
+    uint64_t sum = 0;
+
+    for (i = 0; i < port->repeat; i++)
+    {
+        if (port->enter != NULL)
+        {
+            port->enter();
+        }
+        t = port->cycles();
+        (void)dsp_bench_rs_call(r);
+        t = port->cycles() - t;
+        if (port->leave != NULL)
+        {
+            port->leave();
+        }
+        t = (t > overhead) ? (t - overhead) : 0U;
+        min = (t < min) ? t : min;
+        sum += t;
+    }
+    *mean = (uint32_t)((sum + port->repeat / 2U) / port->repeat);
+    return min;
+}
+
+static void dsp_bench_rs_point(const dsp_bench_port_t *port, const dsp_bench_rs_t *r, uint32_t stages,
+                               uint32_t bytes, uint32_t min, uint32_t mean, int ok)
+{
+    char line[DSP_BENCH_LINE];
+    /* Per output, block * L / M of them on average */
+    uint32_t hundredths = (uint32_t)(((uint64_t)min * 100U * r->M + (uint64_t)r->block * r->L / 2U) /
+                                     ((uint64_t)r->block * r->L));
+
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line),
+                 "{\"ratio\":\"%lu/%lu\",\"type\":\"%s\",\"method\":\"%s\",\"stages\":%lu,\"bytes\":%lu,"
+                 "\"min\":%lu,\"mean\":%lu,\"per_output\":%lu.%02lu,\"check\":\"%s\"}",
+                 (unsigned long)r->L, (unsigned long)r->M, s_type_names[r->type], s_rs_names[r->method],
+                 (unsigned long)stages, (unsigned long)bytes, (unsigned long)min, (unsigned long)mean,
+                 (unsigned long)(hundredths / 100U), (unsigned long)(hundredths % 100U), ok ? "ok" : "fail");
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "%lu/%lu,%s,%s,%lu,%lu,%lu,%lu,%lu.%02lu,%s",
+                 (unsigned long)r->L, (unsigned long)r->M, s_type_names[r->type], s_rs_names[r->method],
+                 (unsigned long)stages, (unsigned long)bytes, (unsigned long)min, (unsigned long)mean,
+                 (unsigned long)(hundredths / 100U), (unsigned long)(hundredths % 100U), ok ? "ok" : "fail");
+    }
+    port->write(line);
+}
+
+static void dsp_bench_rs_skip(const dsp_bench_port_t *port, const dsp_bench_rs_t *r, const char *why)
+{
+    char line[DSP_BENCH_LINE];
+
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line), "{\"skipped\":\"%lu/%lu\",\"type\":\"%s\",\"method\":\"%s\",\"why\":\"%s\"}",
+                 (unsigned long)r->L, (unsigned long)r->M, s_type_names[r->type], s_rs_names[r->method], why);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "# skipped ratio=%lu/%lu type=%s method=%s: %s",
+                 (unsigned long)r->L, (unsigned long)r->M, s_type_names[r->type], s_rs_names[r->method], why);
+    }
+    port->write(line);
+}
+
+/* The one-stage filter, from the bank of r's converter, as arm_fir_interpolate_init_* takes it */
+static arm_status dsp_bench_rs_chain_init(dsp_bench_rs_t *r, void *coeffs, void *state)
+{
+    const dsp_resample_stage_t *st = (r->type == T_F32) ? &r->rs_f32.stage[0] : &r->rs_q15.stage[0];
+    uint32_t taps = st->taps, N = taps * r->L, p, k;
+
+    /* Phase p, element k is tap p + (taps - 1 - k) * L; the chain takes them all time reversed */
+    for (p = 0; p < r->L; p++)
+    {
+        for (k = 0; k < taps; k++)
+        {
+            if (r->type == T_F32)
+            {
+                ((float32_t *)coeffs)[N - 1U - p - (taps - 1U - k) * r->L] = r->rs_f32.pBank[0][p * taps + k];
+            }
+            else
+            {
+                ((q15_t *)coeffs)[N - 1U - p - (taps - 1U - k) * r->L] = r->rs_q15.pBank[0][p * taps + k];
+            }
+        }
+    }
+    r->skip = 0;
+    return (r->type == T_F32) ?
+        arm_fir_interpolate_init_f32(&r->int_f32, (uint8_t)r->L, (uint16_t)N, (float32_t *)coeffs,
+                                     (float32_t *)state, r->chunk) :
+        arm_fir_interpolate_init_q15(&r->int_q15, (uint8_t)r->L, (uint16_t)N, (q15_t *)coeffs,
+                                     (q15_t *)state, r->chunk);
+}
+
+/* Set up r's converter with at most maxStages stages in mem */
+static int dsp_bench_rs_init(dsp_bench_rs_t *r, uint32_t maxStages, void *mem, uint32_t size,
+                             uint32_t *stages, float32_t *delay)
+{
+    arm_status status;
+    uint32_t max_out;
+
+    if (r->type == T_F32)
+    {
+        status = dsp_resample_init_f32(&r->rs_f32, r->L, r->M, maxStages, r->block, mem, size);
+        *stages = r->rs_f32.stages;
+        *delay = r->rs_f32.delay;
+        max_out = r->rs_f32.maxOut;
+    }
+    else
+    {
+        status = dsp_resample_init_q15(&r->rs_q15, r->L, r->M, maxStages, r->block, mem, size);
+        *stages = r->rs_q15.stages;
+        *delay = r->rs_q15.delay;
+        max_out = r->rs_q15.maxOut;
+    }
+    return (status == ARM_MATH_SUCCESS) && (max_out <= r->out_max);
+}
+
+static uint32_t dsp_bench_rs_size(const dsp_bench_rs_t *r, uint32_t maxStages)
+{
+    return (r->type == T_F32) ? dsp_resample_size_f32(r->L, r->M, maxStages, r->block) :
+                                dsp_resample_size_q15(r->L, r->M, maxStages, r->block);
+}
+
+static void dsp_bench_rs_speedup(const dsp_bench_port_t *port, const dsp_bench_rs_t *r, const uint32_t *mins)
+{
+    char line[DSP_BENCH_LINE];
+    uint32_t x[2], i;
+
+    for (i = 0; i < 2U; i++)
+    {
+        x[i] = (uint32_t)(((uint64_t)mins[i] * 100U + mins[RS_MULTI] / 2U) / mins[RS_MULTI]);
+    }
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line), "{\"speedup\":\"%lu/%lu\",\"type\":\"%s\",\"chain\":%lu.%02lu,\"single\":%lu.%02lu}",
+                 (unsigned long)r->L, (unsigned long)r->M, s_type_names[r->type],
+                 (unsigned long)(x[RS_CHAIN] / 100U), (unsigned long)(x[RS_CHAIN] % 100U),
+                 (unsigned long)(x[RS_SINGLE] / 100U), (unsigned long)(x[RS_SINGLE] % 100U));
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "# speedup ratio=%lu/%lu type=%s chain=%lu.%02lu single=%lu.%02lu",
+                 (unsigned long)r->L, (unsigned long)r->M, s_type_names[r->type],
+                 (unsigned long)(x[RS_CHAIN] / 100U), (unsigned long)(x[RS_CHAIN] % 100U),
+                 (unsigned long)(x[RS_SINGLE] / 100U), (unsigned long)(x[RS_SINGLE] % 100U));
+    }
+    port->write(line);
+}
+
+#define DSP_BENCH_RS_ROUND(bytes)   (((bytes) + 7U) & ~7U)
+
+int dsp_bench_resample(const dsp_bench_port_t *port, uint32_t arena_size)
+{
+    static const uint8_t types[] = { T_F32, T_Q15 };
+    dsp_bench_rs_t r;
+    char line[DSP_BENCH_LINE], build[96];
+    uint8_t *mem, *coeffs, *state;
+    uint32_t ratio, t, overhead, min, mean, size, single, chain, multi, stages, esize, taps;
+    uint32_t mins[RS_METHODS];
+    float32_t delay;
+    int ok, points = 0;
+
+    r.block = (port != NULL) ? port->max_block : 0U;
+    if ((port == NULL) || (port->cycles == NULL) || (port->write == NULL) || (port->arena == NULL) ||
+        (port->min_block < DSP_BENCH_MIN_BLOCK) || (r.block < port->min_block) || ((r.block & (r.block - 1U)) != 0U) ||
+        (port->repeat == 0U))
+    {
+        return -1;
+    }
+
+    overhead = dsp_bench_overhead(port);
+    dsp_bench_json_string(build, sizeof(build), (port->build != NULL) ? port->build : "");
+    if (port->format == DSP_BENCH_JSON)
+    {
+        snprintf(line, sizeof(line),
+                 "{\"run\":\"resample\",\"clock\":\"%s\",\"hz\":%lu,\"overhead\":%lu,"
+                 "\"repeat\":%lu,\"block\":%lu,\"build\":\"%s\"}",
+                 port->clock, (unsigned long)port->hz, (unsigned long)overhead,
+                 (unsigned long)port->repeat, (unsigned long)r.block, build);
+        port->write(line);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "# dsp_bench resample clock=%s hz=%lu overhead=%lu repeat=%lu block=%lu",
+                 port->clock, (unsigned long)port->hz, (unsigned long)overhead,
+                 (unsigned long)port->repeat, (unsigned long)r.block);
+        port->write(line);
+        snprintf(line, sizeof(line), "# build %s", build);
+        port->write(line);
+        port->write("ratio,type,method,stages,bytes,min,mean,per_output,check");
+    }
+
+    for (ratio = 0; ratio < sizeof(s_rs_ratios) / sizeof(s_rs_ratios[0]); ratio++)
+    {
+        for (t = 0; t < sizeof(types); t++)
+        {
+            r.type = types[t];
+            r.L = s_rs_ratios[ratio][0];
+            r.M = s_rs_ratios[ratio][1];
+            esize = s_type_size[r.type];
+            memset(mins, 0, sizeof(mins));
+
+            /* Input and output blocks, then the converter; the chain after the one-stage converter */
+            r.out_max = (uint32_t)(((uint64_t)r.block * r.L + r.M - 1U) / r.M) + 2U * DSP_RESAMPLE_MAX_STAGES;
+            r.x = port->arena;
+            r.y = (uint8_t *)r.x + DSP_BENCH_RS_ROUND(esize * r.block);
+            mem = (uint8_t *)r.y + DSP_BENCH_RS_ROUND(esize * r.out_max);
+            size = (uint32_t)(mem - (uint8_t *)port->arena);
+            size = (arena_size > size) ? (arena_size - size) : 0U;
+
+            single = dsp_bench_rs_size(&r, 1U);
+            r.method = RS_CHAIN;
+            if ((single == 0U) || (single > size) || !dsp_bench_rs_init(&r, 1U, mem, single, &stages, &delay))
+            {
+                single = 0U;
+                dsp_bench_rs_skip(port, &r, "arena too small");
+            }
+            else if (r.L > 255U)
+            {
+                dsp_bench_rs_skip(port, &r, "arm_fir_interpolate takes L up to 255");
+            }
+            else
+            {
+                taps = (r.type == T_F32) ? r.rs_f32.stage[0].taps : r.rs_q15.stage[0].taps;
+                r.chunk = DSP_BENCH_RS_CHUNK / r.L;
+                r.chunk = (r.chunk > r.block) ? r.block : (r.chunk > 0U) ? r.chunk : 1U;
+                r.tmp = mem + DSP_BENCH_RS_ROUND(single);
+                coeffs = (uint8_t *)r.tmp + DSP_BENCH_RS_ROUND(esize * r.chunk * r.L);
+                state = coeffs + DSP_BENCH_RS_ROUND(esize * taps * r.L);
+                chain = (uint32_t)(state + DSP_BENCH_RS_ROUND(esize * (taps + r.chunk - 1U)) - mem);
+                if ((taps * r.L > 0xFFFFU) || (chain > size))
+                {
+                    dsp_bench_rs_skip(port, &r, "arena too small");
+                }
+                else
+                {
+                    (void)dsp_bench_rs_chain_init(&r, coeffs, state);
+                    ok = dsp_bench_rs_check(&r, delay);
+                    (void)dsp_bench_rs_chain_init(&r, coeffs, state);
+                    min = dsp_bench_rs_time(port, overhead, &r, &mean);
+                    dsp_bench_rs_point(port, &r, 1U, chain - DSP_BENCH_RS_ROUND(single), min, mean, ok);
+                    mins[RS_CHAIN] = min;
+                    points++;
+                }
+            }
+
+            r.method = RS_SINGLE;
+            if (single == 0U)
+            {
+                dsp_bench_rs_skip(port, &r, "arena too small");
+            }
+            else
+            {
+                (void)dsp_bench_rs_init(&r, 1U, mem, single, &stages, &delay);
+                ok = dsp_bench_rs_check(&r, delay);
+                min = dsp_bench_rs_time(port, overhead, &r, &mean);
+                dsp_bench_rs_point(port, &r, stages, single, min, mean, ok);
+                mins[RS_SINGLE] = min;
+                points++;
+            }
+
+            r.method = RS_MULTI;
+            multi = dsp_bench_rs_size(&r, 0U);
+            if ((multi == 0U) || (multi > size) || !dsp_bench_rs_init(&r, 0U, mem, multi, &stages, &delay))
+            {
+                dsp_bench_rs_skip(port, &r, "arena too small");
+                continue;
+            }
+            ok = dsp_bench_rs_check(&r, delay);
+            min = dsp_bench_rs_time(port, overhead, &r, &mean);
+            dsp_bench_rs_point(port, &r, stages, multi, min, mean, ok);
+            mins[RS_MULTI] = min;
+            points++;
+            if (min > 0U)
+            {
+                dsp_bench_rs_speedup(port, &r, mins);
+            }
+        }
+    }
+    return points;
+}
+
+#endif /* DSP_EXT_ENABLED */
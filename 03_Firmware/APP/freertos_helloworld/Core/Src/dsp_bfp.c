@@ -0,0 +1,566 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bfp.c
+  * @brief   Block floating point complex FFTs in q15_t and q31_t (dsp_bfp.h).
+  ******************************************************************************
+  * The stages are those of arm_cfft_q15/_q31: a radix 2 stage first when
+  * log2 fftLen is odd, then radix 4 decimation in frequency, the outputs of
+  * each butterfly stored in bit reversed order, so that the output ends in
+  * the order the instance's bit reversal table undoes. The twiddles are the
+  * instance's.
+  *
+  * Each stage ORs x ^ (x << 1) over the values it stores: the highest bit
+  * set in that is the highest bit any value needs, which gives the headroom
+  * of the block without another pass over it. The next stage shifts its
+  * inputs as they are loaded so that the headroom is the stage's guard,
+  * and the shifts add up to the exponent. The input gets one pass of its
+  * own for its headroom; the inverse swaps real and imaginary parts in
+  * that pass and after the last stage, as conjugation around the forward
+  * transform.
+  *
+  * With ARM_MATH_DSP the q15 transform works on packed pairs with the SIMD
+  * instructions and folds the right shifts into halving adds, as
+  * arm_cfft_q15 does; without, it shifts the inputs as they are loaded,
+  * which rounds a little differently.
+  ******************************************************************************
+  */
+#include "dsp_ext.h"
+
+#if DSP_EXT_ENABLED
+
+#include "dsp_bfp.h"
+
+#define BFP_GUARD_R2            2       /* Bits a stage's output can grow by */
+#define BFP_GUARD_R4            3
+
+extern void arm_bitreversal_16(uint16_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable);
+extern void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable);
+
+/* Shifts for a stage: left by l or right by r, one of them 0 */
+typedef struct
+{
+    uint32_t l, r;
+} bfp_shift_t;
+
+static int32_t bfp_plan(bfp_shift_t *sh, int32_t headroom, int32_t guard)
+{
+    int32_t s = guard - headroom;
+
+    sh->l = (s < 0) ? (uint32_t)-s : 0U;
+    sh->r = (s > 0) ? (uint32_t)s : 0U;
+    return s;
+}
+
+static uint32_t bfp_log2(uint32_t n)
+{
+    uint32_t k = 0;
+
+    while ((1UL << k) < n)
+    {
+        k++;
+    }
+    return k;
+}
+
+/* ---------------------------------------------------------------------------
+ * q15
+ * ------------------------------------------------------------------------ */
+
+/* Headroom in bits from the OR of x ^ (x << 1) over the values, either
+   half of the mask */
+static int32_t bfp_headroom_q15(uint32_t m)
+{
+    m = (m | (m >> 16)) & 0xFFFFU;
+    return (m == 0U) ? 15 : ((int32_t)__CLZ(m) - 16);
+}
+
+#if defined(ARM_MATH_DSP)
+
+/* A pair is re in the low half of a word, im in the high half. A stage
+   shifts its inputs right by up to its guard, which it folds into the
+   adds as CMSIS-DSP does: each level of adds halves, or not, and for the
+   third bit the inputs are halved on loading. Left shifts, for blocks
+   with more headroom than the guard, scale the inputs on loading. */
+#define BFP_PRE_NONE(x, sh)     (x)
+#define BFP_PRE_HALF(x, sh)     ((q31_t)__SHADD16((uint32_t)(x), 0U))
+#define BFP_PRE_SCALE(x, sh)    bfp_scale_q15((x), (sh))
+
+static inline q31_t bfp_scale_q15(q31_t x, bfp_shift_t sh)
+{
+    return (q31_t)__PKHBT((int32_t)((uint32_t)x << (16U + sh.l)) >> (16U + sh.r),
+                          (int32_t)(((uint32_t)x & 0xFFFF0000U) << sh.l) >> sh.r, 0);
+}
+
+static inline uint32_t bfp_store_q15(q15_t *p, uint32_t i, q31_t x)
+{
+    ((q31_t *)p)[i] = x;
+    return (uint32_t)x ^ ((uint32_t)x << 1);
+}
+
+/* z * (co - i si), C = si : co */
+static inline q31_t bfp_rotate_q15(q31_t z, q31_t C)
+{
+    q31_t re = (q31_t)__SMUAD((uint32_t)C, (uint32_t)z) >> 15;
+    q31_t im = (q31_t)__SMUSDX((uint32_t)C, (uint32_t)z);
+
+    return (q31_t)__PKHBT(re, im, 1);
+}
+
+static inline q31_t bfp_twiddle_q15(const q15_t *tw, uint32_t k)
+{
+    return ((const q31_t *)tw)[k];
+}
+
+static uint32_t bfp_scan_q15(q15_t *p, uint32_t n, uint8_t swap)
+{
+    uint32_t *w = (uint32_t *)p, m = 0, x, i;
+
+    for (i = 0; i < n; i++)
+    {
+        x = w[i];
+        if (swap)
+        {
+            x = __ROR(x, 16U);
+            w[i] = x;
+        }
+        m |= x ^ (x << 1);
+    }
+    return m;
+}
+
+#define BFP_RADIX2_Q15(name, PRE, ADD, SUB) \
+static uint32_t name(q15_t *p, uint32_t n, const q15_t *tw, bfp_shift_t sh) \
+{ \
+    const q31_t *x = (const q31_t *)p; \
+    uint32_t i, m = 0, h = n / 2U; \
+    q31_t a, b; \
+ \
+    for (i = 0; i < h; i++) \
+    { \
+        a = PRE(x[i], sh); \
+        b = PRE(x[i + h], sh); \
+        m |= bfp_store_q15(p, i, (q31_t)ADD((uint32_t)a, (uint32_t)b)); \
+        m |= bfp_store_q15(p, i + h, bfp_rotate_q15((q31_t)SUB((uint32_t)a, (uint32_t)b), \
+                                                    bfp_twiddle_q15(tw, i))); \
+    } \
+    return m; \
+}
+
+BFP_RADIX2_Q15(bfp_radix2_q15_r0, BFP_PRE_NONE, __QADD16, __QSUB16)
+BFP_RADIX2_Q15(bfp_radix2_q15_r1, BFP_PRE_NONE, __SHADD16, __SHSUB16)
+BFP_RADIX2_Q15(bfp_radix2_q15_r2, BFP_PRE_HALF, __SHADD16, __SHSUB16)
+BFP_RADIX2_Q15(bfp_radix2_q15_any, BFP_PRE_SCALE, __QADD16, __QSUB16)
+
+/* Groups of L points, twiddles W_L^k at step * k in the table; the last
+   stage, L = 4, has none */
+#define BFP_RADIX4_Q15(name, PRE, ADD1, SUB1, ADD2, SUB2, SAX, ASX) \
+static uint32_t name(q15_t *p, uint32_t n, uint32_t L, const q15_t *tw, uint32_t step, bfp_shift_t sh) \
+{ \
+    const q31_t *x = (const q31_t *)p; \
+    uint32_t j, i0, q = L / 4U, m = 0; \
+    q31_t a, b, c, d, R, S, T, U, C1, C2, C3; \
+ \
+    for (j = 0; j < q; j++) \
+    { \
+        C1 = bfp_twiddle_q15(tw, j * step); \
+        C2 = bfp_twiddle_q15(tw, 2U * j * step); \
+        C3 = bfp_twiddle_q15(tw, 3U * j * step); \
+        for (i0 = j; i0 < n; i0 += L) \
+        { \
+            a = PRE(x[i0], sh); \
+            b = PRE(x[i0 + q], sh); \
+            c = PRE(x[i0 + 2U * q], sh); \
+            d = PRE(x[i0 + 3U * q], sh); \
+            R = (q31_t)ADD1((uint32_t)a, (uint32_t)c); \
+            S = (q31_t)SUB1((uint32_t)a, (uint32_t)c); \
+            T = (q31_t)ADD1((uint32_t)b, (uint32_t)d); \
+            U = (q31_t)SUB1((uint32_t)b, (uint32_t)d); \
+            a = (q31_t)ADD2((uint32_t)R, (uint32_t)T);          /* X0 */ \
+            c = (q31_t)SUB2((uint32_t)R, (uint32_t)T);          /* X2 */ \
+            b = (q31_t)SAX((uint32_t)S, (uint32_t)U);           /* X1 = S - iU */ \
+            d = (q31_t)ASX((uint32_t)S, (uint32_t)U);           /* X3 = S + iU */ \
+            if (q > 1U) \
+            { \
+                b = bfp_rotate_q15(b, C1); \
+                c = bfp_rotate_q15(c, C2); \
+                d = bfp_rotate_q15(d, C3); \
+            } \
+            m |= bfp_store_q15(p, i0, a); \
+            m |= bfp_store_q15(p, i0 + q, c); \
+            m |= bfp_store_q15(p, i0 + 2U * q, b); \
+            m |= bfp_store_q15(p, i0 + 3U * q, d); \
+        } \
+    } \
+    return m; \
+}
+
+BFP_RADIX4_Q15(bfp_radix4_q15_r0, BFP_PRE_NONE, __QADD16, __QSUB16, __QADD16, __QSUB16, __QSAX, __QASX)
+BFP_RADIX4_Q15(bfp_radix4_q15_r1, BFP_PRE_NONE, __SHADD16, __SHSUB16, __QADD16, __QSUB16, __QSAX, __QASX)
+BFP_RADIX4_Q15(bfp_radix4_q15_r2, BFP_PRE_NONE, __SHADD16, __SHSUB16, __SHADD16, __SHSUB16, __SHSAX, __SHASX)
+BFP_RADIX4_Q15(bfp_radix4_q15_r3, BFP_PRE_HALF, __SHADD16, __SHSUB16, __SHADD16, __SHSUB16, __SHSAX, __SHASX)
+BFP_RADIX4_Q15(bfp_radix4_q15_any, BFP_PRE_SCALE, __QADD16, __QSUB16, __QADD16, __QSUB16, __QSAX, __QASX)
+
+static uint32_t bfp_radix2_q15(q15_t *p, uint32_t n, const q15_t *tw, bfp_shift_t sh)
+{
+    switch ((sh.l != 0U) ? 3U : sh.r)
+    {
+    case 0:
+        return bfp_radix2_q15_r0(p, n, tw, sh);
+    case 1:
+        return bfp_radix2_q15_r1(p, n, tw, sh);
+    case 2:
+        return bfp_radix2_q15_r2(p, n, tw, sh);
+    default:
+        return bfp_radix2_q15_any(p, n, tw, sh);
+    }
+}
+
+static uint32_t bfp_radix4_q15(q15_t *p, uint32_t n, uint32_t L, const q15_t *tw, uint32_t step,
+                               bfp_shift_t sh)
+{
+    switch ((sh.l != 0U) ? 4U : sh.r)
+    {
+    case 0:
+        return bfp_radix4_q15_r0(p, n, L, tw, step, sh);
+    case 1:
+        return bfp_radix4_q15_r1(p, n, L, tw, step, sh);
+    case 2:
+        return bfp_radix4_q15_r2(p, n, L, tw, step, sh);
+    case 3:
+        return bfp_radix4_q15_r3(p, n, L, tw, step, sh);
+    default:
+        return bfp_radix4_q15_any(p, n, L, tw, step, sh);
+    }
+}
+
+#else /* ARM_MATH_DSP */
+
+typedef struct
+{
+    q31_t re, im;
+} bfp_cpx_t;
+
+static inline bfp_cpx_t bfp_load_q15(const q15_t *p, uint32_t i, bfp_shift_t sh)
+{
+    bfp_cpx_t x;
+
+    x.re = (int32_t)((uint32_t)p[2U * i] << sh.l) >> sh.r;
+    x.im = (int32_t)((uint32_t)p[2U * i + 1U] << sh.l) >> sh.r;
+    return x;
+}
+
+static inline uint32_t bfp_store_q15(q15_t *p, uint32_t i, bfp_cpx_t x)
+{
+    p[2U * i] = (q15_t)x.re;
+    p[2U * i + 1U] = (q15_t)x.im;
+    return ((uint32_t)x.re ^ ((uint32_t)x.re << 1)) | ((uint32_t)x.im ^ ((uint32_t)x.im << 1));
+}
+
+static inline bfp_cpx_t bfp_rotate_q15(bfp_cpx_t z, bfp_cpx_t w)
+{
+    bfp_cpx_t y;
+
+    y.re = (w.re * z.re + w.im * z.im) >> 15;
+    y.im = (w.re * z.im - w.im * z.re) >> 15;
+    return y;
+}
+
+static inline bfp_cpx_t bfp_twiddle_q15(const q15_t *tw, uint32_t k)
+{
+    bfp_cpx_t w;
+
+    w.re = tw[2U * k];
+    w.im = tw[2U * k + 1U];
+    return w;
+}
+
+static inline bfp_cpx_t bfp_add(bfp_cpx_t a, bfp_cpx_t b)
+{
+    a.re += b.re;
+    a.im += b.im;
+    return a;
+}
+
+static inline bfp_cpx_t bfp_sub(bfp_cpx_t a, bfp_cpx_t b)
+{
+    a.re -= b.re;
+    a.im -= b.im;
+    return a;
+}
+
+static uint32_t bfp_scan_q15(q15_t *p, uint32_t n, uint8_t swap)
+{
+    uint32_t m = 0, i;
+    q15_t t;
+
+    for (i = 0; i < 2U * n; i += 2U)
+    {
+        if (swap)
+        {
+            t = p[i];
+            p[i] = p[i + 1U];
+            p[i + 1U] = t;
+        }
+        m |= ((uint32_t)p[i] ^ ((uint32_t)p[i] << 1)) | ((uint32_t)p[i + 1U] ^ ((uint32_t)p[i + 1U] << 1));
+    }
+    return m & 0xFFFFU;
+}
+
+static uint32_t bfp_radix2_q15(q15_t *p, uint32_t n, const q15_t *tw, bfp_shift_t sh)
+{
+    uint32_t i, m = 0, h = n / 2U;
+    bfp_cpx_t a, b;
+
+    for (i = 0; i < h; i++)
+    {
+        a = bfp_load_q15(p, i, sh);
+        b = bfp_load_q15(p, i + h, sh);
+        m |= bfp_store_q15(p, i, bfp_add(a, b));
+        m |= bfp_store_q15(p, i + h, bfp_rotate_q15(bfp_sub(a, b), bfp_twiddle_q15(tw, i)));
+    }
+    return m;
+}
+
+static uint32_t bfp_radix4_q15(q15_t *p, uint32_t n, uint32_t L, const q15_t *tw, uint32_t step,
+                               bfp_shift_t sh)
+{
+    uint32_t j, i0, q = L / 4U, m = 0;
+    bfp_cpx_t a, b, c, d, R, S, T, U, C1, C2, C3;
+
+    for (j = 0; j < q; j++)
+    {
+        C1 = bfp_twiddle_q15(tw, j * step);
+        C2 = bfp_twiddle_q15(tw, 2U * j * step);
+        C3 = bfp_twiddle_q15(tw, 3U * j * step);
+        for (i0 = j; i0 < n; i0 += L)
+        {
+            a = bfp_load_q15(p, i0, sh);
+            b = bfp_load_q15(p, i0 + q, sh);
+            c = bfp_load_q15(p, i0 + 2U * q, sh);
+            d = bfp_load_q15(p, i0 + 3U * q, sh);
+            R = bfp_add(a, c);
+            S = bfp_sub(a, c);
+            T = bfp_add(b, d);
+            U = bfp_sub(b, d);
+            a = bfp_add(R, T);
+            c = bfp_sub(R, T);
+            b.re = S.re + U.im;
+            b.im = S.im - U.re;
+            d.re = S.re - U.im;
+            d.im = S.im + U.re;
+            if (q > 1U)
+            {
+                b = bfp_rotate_q15(b, C1);
+                c = bfp_rotate_q15(c, C2);
+                d = bfp_rotate_q15(d, C3);
+            }
+            m |= bfp_store_q15(p, i0, a);
+            m |= bfp_store_q15(p, i0 + q, c);
+            m |= bfp_store_q15(p, i0 + 2U * q, b);
+            m |= bfp_store_q15(p, i0 + 3U * q, d);
+        }
+    }
+    return m;
+}
+
+#endif /* ARM_MATH_DSP */
+
+int32_t dsp_bfp_cfft_q15(const arm_cfft_instance_q15 *S, q15_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    uint32_t n = S->fftLen, lg = bfp_log2(n), L = n, step = 1, m;
+    bfp_shift_t sh;
+    int32_t e = 0;
+
+    m = bfp_scan_q15(p1, n, ifftFlag);
+    if ((lg % 2U) != 0U)
+    {
+        e += bfp_plan(&sh, bfp_headroom_q15(m), BFP_GUARD_R2);
+        m = bfp_radix2_q15(p1, n, S->pTwiddle, sh);
+        L /= 2U;
+        step = 2U;
+    }
+    for (; L >= 4U; L /= 4U, step *= 4U)
+    {
+        e += bfp_plan(&sh, bfp_headroom_q15(m), BFP_GUARD_R4);
+        m = bfp_radix4_q15(p1, n, L, S->pTwiddle, step, sh);
+    }
+
+    if (bitReverseFlag)
+    {
+        arm_bitreversal_16((uint16_t *)p1, S->bitRevLength, S->pBitRevTable);
+    }
+    if (ifftFlag)
+    {
+        (void)bfp_scan_q15(p1, n, 1U);
+        e -= (int32_t)lg;
+    }
+    return e;
+}
+
+/* ---------------------------------------------------------------------------
+ * q31
+ * ------------------------------------------------------------------------ */
+
+typedef struct
+{
+    q31_t re, im;
+} bfp_cpx31_t;
+
+static int32_t bfp_headroom_q31(uint32_t m)
+{
+    return (m == 0U) ? 31 : (int32_t)__CLZ(m);
+}
+
+static inline bfp_cpx31_t bfp_load_q31(const q31_t *p, uint32_t i, bfp_shift_t sh)
+{
+    bfp_cpx31_t x;
+
+    x.re = (int32_t)((uint32_t)p[2U * i] << sh.l) >> sh.r;
+    x.im = (int32_t)((uint32_t)p[2U * i + 1U] << sh.l) >> sh.r;
+    return x;
+}
+
+static inline uint32_t bfp_store_q31(q31_t *p, uint32_t i, bfp_cpx31_t x)
+{
+    p[2U * i] = x.re;
+    p[2U * i + 1U] = x.im;
+    return ((uint32_t)x.re ^ ((uint32_t)x.re << 1)) | ((uint32_t)x.im ^ ((uint32_t)x.im << 1));
+}
+
+/* z * (co - i si), w = co + i si */
+static inline bfp_cpx31_t bfp_rotate_q31(bfp_cpx31_t z, bfp_cpx31_t w)
+{
+    bfp_cpx31_t y;
+
+    y.re = (q31_t)(((q63_t)w.re * z.re + (q63_t)w.im * z.im) >> 31);
+    y.im = (q31_t)(((q63_t)w.re * z.im - (q63_t)w.im * z.re) >> 31);
+    return y;
+}
+
+static inline bfp_cpx31_t bfp_twiddle_q31(const q31_t *tw, uint32_t k)
+{
+    bfp_cpx31_t w;
+
+    w.re = tw[2U * k];
+    w.im = tw[2U * k + 1U];
+    return w;
+}
+
+static uint32_t bfp_scan_q31(q31_t *p, uint32_t n, uint8_t swap)
+{
+    uint32_t m = 0, i;
+    q31_t t;
+
+    for (i = 0; i < 2U * n; i += 2U)
+    {
+        if (swap)
+        {
+            t = p[i];
+            p[i] = p[i + 1U];
+            p[i + 1U] = t;
+        }
+        m |= ((uint32_t)p[i] ^ ((uint32_t)p[i] << 1)) | ((uint32_t)p[i + 1U] ^ ((uint32_t)p[i + 1U] << 1));
+    }
+    return m;
+}
+
+static uint32_t bfp_radix2_q31(q31_t *p, uint32_t n, const q31_t *tw, bfp_shift_t sh)
+{
+    uint32_t i, m = 0, h = n / 2U;
+    bfp_cpx31_t a, b, y;
+
+    for (i = 0; i < h; i++)
+    {
+        a = bfp_load_q31(p, i, sh);
+        b = bfp_load_q31(p, i + h, sh);
+        y.re = a.re + b.re;
+        y.im = a.im + b.im;
+        m |= bfp_store_q31(p, i, y);
+        y.re = a.re - b.re;
+        y.im = a.im - b.im;
+        m |= bfp_store_q31(p, i + h, bfp_rotate_q31(y, bfp_twiddle_q31(tw, i)));
+    }
+    return m;
+}
+
+static uint32_t bfp_radix4_q31(q31_t *p, uint32_t n, uint32_t L, const q31_t *tw, uint32_t step,
+                               bfp_shift_t sh)
+{
+    uint32_t j, i0, q = L / 4U, m = 0;
+    bfp_cpx31_t a, b, c, d, R, S, T, U, y0, y1, y2, y3, C1, C2, C3;
+
+    for (j = 0; j < q; j++)
+    {
+        C1 = bfp_twiddle_q31(tw, j * step);
+        C2 = bfp_twiddle_q31(tw, 2U * j * step);
+        C3 = bfp_twiddle_q31(tw, 3U * j * step);
+        for (i0 = j; i0 < n; i0 += L)
+        {
+            a = bfp_load_q31(p, i0, sh);
+            b = bfp_load_q31(p, i0 + q, sh);
+            c = bfp_load_q31(p, i0 + 2U * q, sh);
+            d = bfp_load_q31(p, i0 + 3U * q, sh);
+            R.re = a.re + c.re;
+            R.im = a.im + c.im;
+            S.re = a.re - c.re;
+            S.im = a.im - c.im;
+            T.re = b.re + d.re;
+            T.im = b.im + d.im;
+            U.re = b.re - d.re;
+            U.im = b.im - d.im;
+            y0.re = R.re + T.re;
+            y0.im = R.im + T.im;
+            y2.re = R.re - T.re;
+            y2.im = R.im - T.im;
+            y1.re = S.re + U.im;                        /* S - iU */
+            y1.im = S.im - U.re;
+            y3.re = S.re - U.im;                        /* S + iU */
+            y3.im = S.im + U.re;
+            if (q > 1U)
+            {
+                y1 = bfp_rotate_q31(y1, C1);
+                y2 = bfp_rotate_q31(y2, C2);
+                y3 = bfp_rotate_q31(y3, C3);
+            }
+            m |= bfp_store_q31(p, i0, y0);
+            m |= bfp_store_q31(p, i0 + q, y2);
+            m |= bfp_store_q31(p, i0 + 2U * q, y1);
+            m |= bfp_store_q31(p, i0 + 3U * q, y3);
+        }
+    }
+    return m;
+}
+
+int32_t dsp_bfp_cfft_q31(const arm_cfft_instance_q31 *S, q31_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    uint32_t n = S->fftLen, lg = bfp_log2(n), L = n, step = 1, m;
+    bfp_shift_t sh;
+    int32_t e = 0;
+
+    m = bfp_scan_q31(p1, n, ifftFlag);
+    if ((lg % 2U) != 0U)
+    {
+        e += bfp_plan(&sh, bfp_headroom_q31(m), BFP_GUARD_R2);
+        m = bfp_radix2_q31(p1, n, S->pTwiddle, sh);
+        L /= 2U;
+        step = 2U;
+    }
+    for (; L >= 4U; L /= 4U, step *= 4U)
+    {
+        e += bfp_plan(&sh, bfp_headroom_q31(m), BFP_GUARD_R4);
+        m = bfp_radix4_q31(p1, n, L, S->pTwiddle, step, sh);
+    }
+
+    if (bitReverseFlag)
+    {
+        arm_bitreversal_32((uint32_t *)p1, S->bitRevLength, S->pBitRevTable);
+    }
+    if (ifftFlag)
+    {
+        (void)bfp_scan_q31(p1, n, 1U);
+        e -= (int32_t)lg;
+    }
+    return e;
+}
+
+#endif /* DSP_EXT_ENABLED */
@@ -0,0 +1,551 @@
+/**
+  ******************************************************************************
+  * @file    dsp_mrfft.c
+  * @brief   Mixed-radix complex and real FFTs in float32_t (dsp_mrfft.h).
+  ******************************************************************************
+  * The complex FFT is decimation in frequency, in place, one pass over the
+  * data per stage. A stage of radix r on sub-transforms of L = r * m points
+  * takes the points j, j + m, .. j + (r - 1) * m of each, does an r point
+  * DFT and multiplies output q by W_L^(j * q). That leaves the output in
+  * the digit reversed order of the radix sequence; a last pass moves it
+  * into order along the cycles of that permutation, listed at init.
+  *
+  * All twiddles, W_L^e = cos - i sin of 2 pi e / L, are read from one table
+  * of cos over a quarter wave, with the sines taken from the other end of
+  * it. The inverse swaps real and imaginary parts around the forward
+  * transform.
+  *
+  * The real FFT of n samples is the complex FFT of the n / 2 pairs followed
+  * by the split into the spectrum of the even and odd samples, as in
+  * arm_rfft_fast_f32; its twiddles come from the same table, made for n.
+  ******************************************************************************
+  */
+#include <math.h>
+
+#include "dsp_ext.h"
+
+#if DSP_EXT_ENABLED
+
+#include "dsp_mrfft.h"
+
+#define MRFFT_SQRT1_2           0.70710678118654752f
+#define MRFFT_SIN_60            0.86602540378443865f    /* Radix 3 */
+#define MRFFT_COS_72            0.30901699437494742f    /* Radix 5 */
+#define MRFFT_COS_144           (-0.80901699437494742f)
+#define MRFFT_SIN_72            0.95105651629515357f
+#define MRFFT_SIN_144           0.58778525229247313f
+
+typedef struct
+{
+    float32_t re, im;
+} mrfft_cpx_t;
+
+/* ---------------------------------------------------------------------------
+ * Planning
+ * ------------------------------------------------------------------------ */
+
+/* Radices for n, or 0 stages if n has another prime factor: a 2 or a 4
+   for the odd power of two first, as arm_cfft_f32 does its radix 2 stage
+   before the radix 8 ones, then 8s, 5s and 3s */
+static uint32_t mrfft_factor(uint32_t n, uint8_t *radix)
+{
+    uint32_t stages = 0, twos = 0, i;
+
+    while ((n % 2U) == 0U)
+    {
+        n /= 2U;
+        twos++;
+    }
+    if ((twos % 3U) == 1U)
+    {
+        radix[stages++] = 2U;
+    }
+    else if ((twos % 3U) == 2U)
+    {
+        radix[stages++] = 4U;
+    }
+    for (i = 0; i < twos / 3U; i++)
+    {
+        radix[stages++] = 8U;
+    }
+    while ((n % 5U) == 0U)
+    {
+        n /= 5U;
+        radix[stages++] = 5U;
+    }
+    while ((n % 3U) == 0U)
+    {
+        n /= 3U;
+        radix[stages++] = 3U;
+    }
+    return (n == 1U) ? stages : 0U;
+}
+
+/* Where output i of the transform is after the stages: its digits in the
+   radix sequence, read from the other end */
+static uint32_t mrfft_source(uint32_t n, const uint8_t *radix, uint32_t stages, uint32_t i)
+{
+    uint32_t s, pos = 0, span = n;
+
+    for (s = 0; s < stages; s++)
+    {
+        span /= radix[s];
+        pos += (i % radix[s]) * span;
+        i /= radix[s];
+    }
+    return pos;
+}
+
+/* Write the cycles of the permutation, each from its smallest index, in
+   runs of equal length: length, count, then the indices; 0 ends. Returns
+   the number of uint16_t it takes; out may be NULL to count only. */
+static uint32_t mrfft_cycles(uint32_t n, const uint8_t *radix, uint32_t stages, uint16_t *out)
+{
+    uint32_t i, j, len, words = 1, run_len = 0, run_at = 0;
+
+    for (i = 1; i < n; i++)
+    {
+        /* Skip i unless it is the smallest index of its cycle */
+        for (j = mrfft_source(n, radix, stages, i), len = 1; j > i; len++)
+        {
+            j = mrfft_source(n, radix, stages, j);
+        }
+        if ((j != i) || (len == 1U))
+        {
+            continue;
+        }
+
+        if (len != run_len)
+        {
+            run_len = len;
+            run_at = words - 1U;
+            if (out != NULL)
+            {
+                out[run_at] = (uint16_t)len;
+                out[run_at + 1U] = 0;
+            }
+            words += 2U;
+        }
+        if (out != NULL)
+        {
+            out[run_at + 1U]++;
+            for (j = i, len = 0; len < run_len; len++)
+            {
+                out[words - 1U + len] = (uint16_t)j;
+                j = mrfft_source(n, radix, stages, j);
+            }
+        }
+        words += run_len;
+    }
+    if (out != NULL)
+    {
+        out[words - 1U] = 0;
+    }
+    return words;
+}
+
+/* Table bytes for twiddles over table_len, rounded up to a whole float */
+static uint32_t mrfft_table_bytes(uint32_t table_len)
+{
+    return (table_len / 4U + 1U) * sizeof(float32_t);
+}
+
+static uint32_t mrfft_size(uint32_t fftLen, uint32_t table_len)
+{
+    uint8_t radix[DSP_MRFFT_MAX_STAGES];
+    uint32_t stages;
+
+    if ((fftLen < 4U) || (fftLen > DSP_MRFFT_MAX_LEN) || ((table_len % 4U) != 0U))
+    {
+        return 0;
+    }
+    stages = mrfft_factor(fftLen, radix);
+    if (stages == 0U)
+    {
+        return 0;
+    }
+    return mrfft_table_bytes(table_len) +
+           mrfft_cycles(fftLen, radix, stages, NULL) * sizeof(uint16_t);
+}
+
+static arm_status mrfft_init(dsp_mrfft_cfft_instance_f32 *S, uint32_t fftLen, uint32_t table_len,
+                             void *mem, uint32_t size)
+{
+    uint32_t need = mrfft_size(fftLen, table_len);
+    float32_t *tab = (float32_t *)mem;
+    uint32_t k;
+
+    if ((need == 0U) || (mem == NULL) || (size < need))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    S->fftLen = fftLen;
+    S->quarter = table_len / 4U;
+    S->stride = table_len / fftLen;
+    S->bytes = need;
+    S->stages = (uint8_t)mrfft_factor(fftLen, S->radix);
+    for (k = 0; k <= S->quarter; k++)
+    {
+        tab[k] = (float32_t)cos(6.283185307179586 * (double)k / (double)table_len);
+    }
+    S->pCos = tab;
+    S->pCycles = (uint16_t *)((uint8_t *)mem + mrfft_table_bytes(table_len));
+    (void)mrfft_cycles(fftLen, S->radix, S->stages, (uint16_t *)S->pCycles);
+    return ARM_MATH_SUCCESS;
+}
+
+uint32_t dsp_mrfft_cfft_size_f32(uint32_t fftLen)
+{
+    return mrfft_size(fftLen, fftLen);
+}
+
+arm_status dsp_mrfft_cfft_init_f32(dsp_mrfft_cfft_instance_f32 *S, uint32_t fftLen, void *mem, uint32_t size)
+{
+    return mrfft_init(S, fftLen, fftLen, mem, size);
+}
+
+uint32_t dsp_mrfft_rfft_size_f32(uint32_t fftLenReal)
+{
+    return ((fftLenReal % 2U) == 0U) ? mrfft_size(fftLenReal / 2U, fftLenReal) : 0U;
+}
+
+arm_status dsp_mrfft_rfft_init_f32(dsp_mrfft_rfft_instance_f32 *S, uint32_t fftLenReal, void *mem, uint32_t size)
+{
+    if ((fftLenReal % 2U) != 0U)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLenReal = fftLenReal;
+    return mrfft_init(&S->cfft, fftLenReal / 2U, fftLenReal, mem, size);
+}
+
+/* ---------------------------------------------------------------------------
+ * Butterflies
+ * ------------------------------------------------------------------------ */
+
+/* cos and sin of 2 pi e / (4 * q), 0 <= e < 4 * q */
+static inline void mrfft_twiddle(const float32_t *tab, uint32_t q, uint32_t e, float32_t *c, float32_t *s)
+{
+    if (e <= q)
+    {
+        *c = tab[e];
+        *s = tab[q - e];
+    }
+    else if (e <= 2U * q)
+    {
+        *c = -tab[2U * q - e];
+        *s = tab[e - q];
+    }
+    else if (e <= 3U * q)
+    {
+        *c = -tab[e - 2U * q];
+        *s = -tab[3U * q - e];
+    }
+    else
+    {
+        *c = tab[4U * q - e];
+        *s = -tab[e - 3U * q];
+    }
+}
+
+/* x * (c - i s), with the twiddle as w.re = c, w.im = s */
+static inline mrfft_cpx_t mrfft_rotate(mrfft_cpx_t x, mrfft_cpx_t w)
+{
+    mrfft_cpx_t y;
+
+    y.re = x.re * w.re + x.im * w.im;
+    y.im = x.im * w.re - x.re * w.im;
+    return y;
+}
+
+/* Each butterfly reads x[0], x[m], .. x[(r - 1) * m] and leaves the r point
+   DFT in y */
+
+static inline void mrfft_bfly2(const mrfft_cpx_t *x, uint32_t m, mrfft_cpx_t *y)
+{
+    mrfft_cpx_t a = x[0], b = x[m];
+
+    y[0].re = a.re + b.re;
+    y[0].im = a.im + b.im;
+    y[1].re = a.re - b.re;
+    y[1].im = a.im - b.im;
+}
+
+/* Outputs 0, 1, 2, 3 of the 4 point DFT of u0 .. u3 */
+#define MRFFT_DFT4(u0, u1, u2, u3, y0, y1, y2, y3) \
+    do \
+    { \
+        float32_t s02r = u0.re + u2.re, s02i = u0.im + u2.im; \
+        float32_t d02r = u0.re - u2.re, d02i = u0.im - u2.im; \
+        float32_t s13r = u1.re + u3.re, s13i = u1.im + u3.im; \
+        float32_t d13r = u1.re - u3.re, d13i = u1.im - u3.im; \
+        y0.re = s02r + s13r; \
+        y0.im = s02i + s13i; \
+        y2.re = s02r - s13r; \
+        y2.im = s02i - s13i; \
+        y1.re = d02r + d13i; \
+        y1.im = d02i - d13r; \
+        y3.re = d02r - d13i; \
+        y3.im = d02i + d13r; \
+    } while (0)
+
+static inline void mrfft_bfly4(const mrfft_cpx_t *x, uint32_t m, mrfft_cpx_t *y)
+{
+    mrfft_cpx_t u0 = x[0], u1 = x[m], u2 = x[2U * m], u3 = x[3U * m];
+
+    MRFFT_DFT4(u0, u1, u2, u3, y[0], y[1], y[2], y[3]);
+}
+
+/* Radix 2 over the halves, times W_8^k, then two 4 point DFTs for the even
+   and the odd outputs */
+static inline void mrfft_bfly8(const mrfft_cpx_t *x, uint32_t m, mrfft_cpx_t *y)
+{
+    mrfft_cpx_t a0, a1, a2, a3, b0, b1, b2, b3;
+    float32_t r, i;
+
+    a0.re = x[0].re + x[4U * m].re;
+    a0.im = x[0].im + x[4U * m].im;
+    b0.re = x[0].re - x[4U * m].re;
+    b0.im = x[0].im - x[4U * m].im;
+    a1.re = x[m].re + x[5U * m].re;
+    a1.im = x[m].im + x[5U * m].im;
+    r = x[m].re - x[5U * m].re;
+    i = x[m].im - x[5U * m].im;
+    b1.re = (r + i) * MRFFT_SQRT1_2;
+    b1.im = (i - r) * MRFFT_SQRT1_2;
+    a2.re = x[2U * m].re + x[6U * m].re;
+    a2.im = x[2U * m].im + x[6U * m].im;
+    b2.re = x[2U * m].im - x[6U * m].im;
+    b2.im = x[6U * m].re - x[2U * m].re;
+    a3.re = x[3U * m].re + x[7U * m].re;
+    a3.im = x[3U * m].im + x[7U * m].im;
+    r = x[3U * m].re - x[7U * m].re;
+    i = x[3U * m].im - x[7U * m].im;
+    b3.re = (i - r) * MRFFT_SQRT1_2;
+    b3.im = -(i + r) * MRFFT_SQRT1_2;
+
+    MRFFT_DFT4(a0, a1, a2, a3, y[0], y[2], y[4], y[6]);
+    MRFFT_DFT4(b0, b1, b2, b3, y[1], y[3], y[5], y[7]);
+}
+
+static inline void mrfft_bfly3(const mrfft_cpx_t *x, uint32_t m, mrfft_cpx_t *y)
+{
+    mrfft_cpx_t x0 = x[0], x1 = x[m], x2 = x[2U * m];
+    float32_t tr = x1.re + x2.re, ti = x1.im + x2.im;
+    float32_t mr = x0.re - 0.5f * tr, mi = x0.im - 0.5f * ti;
+    float32_t dr = (x1.re - x2.re) * MRFFT_SIN_60, di = (x1.im - x2.im) * MRFFT_SIN_60;
+
+    y[0].re = x0.re + tr;
+    y[0].im = x0.im + ti;
+    y[1].re = mr + di;
+    y[1].im = mi - dr;
+    y[2].re = mr - di;
+    y[2].im = mi + dr;
+}
+
+static inline void mrfft_bfly5(const mrfft_cpx_t *x, uint32_t m, mrfft_cpx_t *y)
+{
+    mrfft_cpx_t x0 = x[0], x1 = x[m], x2 = x[2U * m], x3 = x[3U * m], x4 = x[4U * m];
+    float32_t t1r = x1.re + x4.re, t1i = x1.im + x4.im;
+    float32_t t2r = x2.re + x3.re, t2i = x2.im + x3.im;
+    float32_t d1r = x1.re - x4.re, d1i = x1.im - x4.im;
+    float32_t d2r = x2.re - x3.re, d2i = x2.im - x3.im;
+    float32_t a1r = x0.re + MRFFT_COS_72 * t1r + MRFFT_COS_144 * t2r;
+    float32_t a1i = x0.im + MRFFT_COS_72 * t1i + MRFFT_COS_144 * t2i;
+    float32_t a2r = x0.re + MRFFT_COS_144 * t1r + MRFFT_COS_72 * t2r;
+    float32_t a2i = x0.im + MRFFT_COS_144 * t1i + MRFFT_COS_72 * t2i;
+    float32_t b1r = MRFFT_SIN_72 * d1r + MRFFT_SIN_144 * d2r;
+    float32_t b1i = MRFFT_SIN_72 * d1i + MRFFT_SIN_144 * d2i;
+    float32_t b2r = MRFFT_SIN_144 * d1r - MRFFT_SIN_72 * d2r;
+    float32_t b2i = MRFFT_SIN_144 * d1i - MRFFT_SIN_72 * d2i;
+
+    /* y1 = a1 - i b1, y4 = a1 + i b1, y2 = a2 - i b2, y3 = a2 + i b2 */
+    y[0].re = x0.re + t1r + t2r;
+    y[0].im = x0.im + t1i + t2i;
+    y[1].re = a1r + b1i;
+    y[1].im = a1i - b1r;
+    y[4].re = a1r - b1i;
+    y[4].im = a1i + b1r;
+    y[2].re = a2r + b2i;
+    y[2].im = a2i - b2r;
+    y[3].re = a2r - b2i;
+    y[3].im = a2i + b2r;
+}
+
+/* One stage over all sub-transforms of r * m points in the n. Column 0 has
+   no twiddles; column j multiplies output q by W_L^(j * q), read once for
+   all sub-transforms. */
+#define MRFFT_STAGE(name, r, bfly) \
+    static void name(mrfft_cpx_t *x, uint32_t n, uint32_t m, uint32_t step, \
+                     const float32_t *tab, uint32_t quarter) \
+    { \
+        mrfft_cpx_t y[r], w[r]; \
+        uint32_t j, b, q; \
+        for (b = 0; b < n; b += (r) * m) \
+        { \
+            bfly(x + b, m, y); \
+            for (q = 0; q < (r); q++) \
+            { \
+                x[b + q * m] = y[q]; \
+            } \
+        } \
+        for (j = 1; j < m; j++) \
+        { \
+            for (q = 1; q < (r); q++) \
+            { \
+                mrfft_twiddle(tab, quarter, q * j * step, &w[q].re, &w[q].im); \
+            } \
+            for (b = j; b < n; b += (r) * m) \
+            { \
+                bfly(x + b, m, y); \
+                x[b] = y[0]; \
+                for (q = 1; q < (r); q++) \
+                { \
+                    x[b + q * m] = mrfft_rotate(y[q], w[q]); \
+                } \
+            } \
+        } \
+    }
+
+MRFFT_STAGE(mrfft_stage2, 2U, mrfft_bfly2)
+MRFFT_STAGE(mrfft_stage3, 3U, mrfft_bfly3)
+MRFFT_STAGE(mrfft_stage4, 4U, mrfft_bfly4)
+MRFFT_STAGE(mrfft_stage5, 5U, mrfft_bfly5)
+MRFFT_STAGE(mrfft_stage8, 8U, mrfft_bfly8)
+
+/* ---------------------------------------------------------------------------
+ * Transforms
+ * ------------------------------------------------------------------------ */
+
+static void mrfft_forward(const dsp_mrfft_cfft_instance_f32 *S, mrfft_cpx_t *x)
+{
+    uint32_t n = S->fftLen, m = n, s, len, count;
+    const uint16_t *cycle;
+    mrfft_cpx_t t;
+
+    for (s = 0; s < S->stages; s++)
+    {
+        uint32_t r = S->radix[s];
+        /* Twiddle exponent per column, in table steps: W_L = W_n^(n / L) */
+        uint32_t step = (n / m) * S->stride;
+
+        m /= r;
+        switch (r)
+        {
+        case 8:
+            mrfft_stage8(x, n, m, step, S->pCos, S->quarter);
+            break;
+        case 5:
+            mrfft_stage5(x, n, m, step, S->pCos, S->quarter);
+            break;
+        case 4:
+            mrfft_stage4(x, n, m, step, S->pCos, S->quarter);
+            break;
+        case 3:
+            mrfft_stage3(x, n, m, step, S->pCos, S->quarter);
+            break;
+        default:
+            mrfft_stage2(x, n, m, step, S->pCos, S->quarter);
+            break;
+        }
+    }
+
+    /* Output i is at its source; rotate each cycle by one */
+    for (cycle = S->pCycles; (len = cycle[0]) != 0U; )
+    {
+        count = cycle[1];
+        cycle += 2;
+        while (count-- > 0U)
+        {
+            t = x[cycle[0]];
+            for (s = 0; s + 1U < len; s++)
+            {
+                x[cycle[s]] = x[cycle[s + 1U]];
+            }
+            x[cycle[len - 1U]] = t;
+            cycle += len;
+        }
+    }
+}
+
+static void mrfft_swap(mrfft_cpx_t *x, uint32_t n, float32_t scale)
+{
+    uint32_t i;
+    float32_t t;
+
+    for (i = 0; i < n; i++)
+    {
+        t = x[i].re;
+        x[i].re = x[i].im * scale;
+        x[i].im = t * scale;
+    }
+}
+
+void dsp_mrfft_cfft_f32(const dsp_mrfft_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag)
+{
+    mrfft_cpx_t *x = (mrfft_cpx_t *)p1;
+
+    if (ifftFlag == 0U)
+    {
+        mrfft_forward(S, x);
+        return;
+    }
+    /* conj(FFT(conj(x))) with conj as the swap, which needs no sign change */
+    mrfft_swap(x, S->fftLen, 1.0f);
+    mrfft_forward(S, x);
+    mrfft_swap(x, S->fftLen, 1.0f / (float32_t)S->fftLen);
+}
+
+void dsp_mrfft_rfft_f32(const dsp_mrfft_rfft_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{
+    const dsp_mrfft_cfft_instance_f32 *C = &S->cfft;
+    uint32_t n = C->fftLen, k;
+    mrfft_cpx_t *z, *out, a, b, e, d;
+    float32_t c, s;
+
+    if (ifftFlag == 0U)
+    {
+        /* The pairs as complex points, then X[k] = E - i W_2n^k O with E and
+           O the spectra of the even and the odd samples */
+        z = (mrfft_cpx_t *)p;
+        out = (mrfft_cpx_t *)pOut;
+        mrfft_forward(C, z);
+        out[0].re = z[0].re + z[0].im;
+        out[0].im = z[0].re - z[0].im;
+        for (k = 1; k < n; k++)
+        {
+            a = z[k];
+            b = z[n - k];
+            e.re = 0.5f * (a.re + b.re);
+            e.im = 0.5f * (a.im - b.im);
+            d.re = 0.5f * (a.re - b.re);
+            d.im = 0.5f * (a.im + b.im);
+            mrfft_twiddle(C->pCos, C->quarter, k, &c, &s);
+            out[k].re = e.re - (s * d.re - c * d.im);
+            out[k].im = e.im - (s * d.im + c * d.re);
+        }
+        return;
+    }
+
+    /* Undo the split into pOut, then the inverse complex FFT there */
+    z = (mrfft_cpx_t *)pOut;
+    out = (mrfft_cpx_t *)p;
+    z[0].re = 0.5f * (out[0].re + out[0].im);
+    z[0].im = 0.5f * (out[0].re - out[0].im);
+    for (k = 1; k < n; k++)
+    {
+        a = out[k];
+        b = out[n - k];
+        e.re = 0.5f * (a.re + b.re);
+        e.im = 0.5f * (a.im - b.im);
+        d.re = 0.5f * (a.re - b.re);
+        d.im = 0.5f * (a.im + b.im);
+        mrfft_twiddle(C->pCos, C->quarter, k, &c, &s);
+        z[k].re = e.re - s * d.re - c * d.im;
+        z[k].im = e.im - s * d.im + c * d.re;
+    }
+    dsp_mrfft_cfft_f32(C, pOut, 1);
+}
+
+#endif /* DSP_EXT_ENABLED */
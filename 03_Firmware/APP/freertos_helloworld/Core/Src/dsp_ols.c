@@ -0,0 +1,181 @@
+/**
+  ******************************************************************************
+  * @file    dsp_ols.c
+  * @brief   Partitioned overlap-save FIR filter in float32_t (dsp_ols.h).
+  ******************************************************************************
+  * With B = partLen, partition k holds taps k * B .. k * B + B - 1 of the
+  * impulse response, zero padded to 2 * B points; its spectrum H_k is taken
+  * at init. Each block of B input samples is appended to the B before it
+  * and transformed, X_0, and the spectrum of the output is
+  *
+  *   Y = H_0 X_0 + H_1 X_1 + .. + H_(parts - 1) X_(parts - 1)
+  *
+  * where X_k is the spectrum taken k blocks ago, kept in a ring. The last B
+  * points of the inverse transform of Y are the output: the first B wrap
+  * around the circular convolution and are dropped.
+  *
+  * Spectra are in the packed format of arm_rfft_fast_f32, the real bins 0
+  * and B in the first two words, and are multiplied as such.
+  ******************************************************************************
+  */
+#include <string.h>
+
+#include "dsp_ext.h"
+
+#if DSP_EXT_ENABLED
+
+#include "dsp_ols.h"
+
+static uint32_t ols_parts(uint32_t numTaps, uint32_t partLen)
+{
+    return (numTaps + partLen - 1U) / partLen;
+}
+
+uint32_t dsp_ols_fir_size_f32(uint32_t numTaps, uint32_t partLen)
+{
+    if ((partLen < DSP_OLS_MIN_PART) || (partLen > DSP_OLS_MAX_PART) || ((partLen & (partLen - 1U)) != 0U))
+    {
+        return 0U;
+    }
+    /* Spectra and delay line, history, work, accumulator, stream in and out */
+    return (uint32_t)sizeof(float32_t) * (4U * ols_parts(numTaps, partLen) * partLen + 7U * partLen);
+}
+
+arm_status dsp_ols_fir_init_f32(dsp_ols_fir_instance_f32 *S, uint32_t numTaps, const float32_t *pCoeffs,
+                                uint32_t partLen, void *mem, uint32_t size)
+{
+    uint32_t need = dsp_ols_fir_size_f32(numTaps, partLen);
+    uint32_t k, i, tap;
+    float32_t *p = (float32_t *)mem;
+
+    if ((numTaps == 0U) || (need == 0U) || (size < need) || (mem == NULL) ||
+        (arm_rfft_fast_init_f32(&S->rfft, (uint16_t)(2U * partLen)) != ARM_MATH_SUCCESS))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    S->numTaps = numTaps;
+    S->partLen = partLen;
+    S->parts = ols_parts(numTaps, partLen);
+    S->head = 0;
+    S->fill = 0;
+    S->pSpectra = p;
+    p += 2U * partLen * S->parts;
+    S->pDelay = p;
+    p += 2U * partLen * S->parts;
+    S->pHistory = p;
+    p += partLen;
+    S->pWork = p;
+    p += 2U * partLen;
+    S->pAcc = p;
+    p += 2U * partLen;
+    S->pIn = p;
+    p += partLen;
+    S->pOut = p;
+
+    /* pCoeffs[numTaps - 1 - n] is tap n */
+    for (k = 0; k < S->parts; k++)
+    {
+        memset(S->pWork, 0, 2U * partLen * sizeof(float32_t));
+        for (i = 0; i < partLen; i++)
+        {
+            tap = k * partLen + i;
+            if (tap < numTaps)
+            {
+                S->pWork[i] = pCoeffs[numTaps - 1U - tap];
+            }
+        }
+        arm_rfft_fast_f32(&S->rfft, S->pWork, S->pSpectra + 2U * partLen * k, 0);
+    }
+
+    memset(S->pDelay, 0, 2U * partLen * S->parts * sizeof(float32_t));
+    memset(S->pHistory, 0, partLen * sizeof(float32_t));
+    memset(S->pOut, 0, partLen * sizeof(float32_t));
+    return ARM_MATH_SUCCESS;
+}
+
+/* acc += h x over n packed bins: two real, then n / 2 - 1 complex */
+static void ols_mac(float32_t *acc, const float32_t *h, const float32_t *x, uint32_t n)
+{
+    float32_t hr, hi, xr, xi;
+    uint32_t i;
+
+    acc[0] += h[0] * x[0];
+    acc[1] += h[1] * x[1];
+    for (i = 2; i < n; i += 2)
+    {
+        hr = h[i];
+        hi = h[i + 1U];
+        xr = x[i];
+        xi = x[i + 1U];
+        acc[i] += hr * xr - hi * xi;
+        acc[i + 1U] += hr * xi + hi * xr;
+    }
+}
+
+/* Filter one partition; pSrc and pDst may be the same */
+static void ols_partition(dsp_ols_fir_instance_f32 *S, const float32_t *pSrc, float32_t *pDst)
+{
+    uint32_t B = S->partLen, n = 2U * S->partLen, k, slot;
+
+    /* The previous partition and this one, which becomes the previous */
+    memcpy(S->pWork, S->pHistory, B * sizeof(float32_t));
+    memcpy(S->pWork + B, pSrc, B * sizeof(float32_t));
+    memcpy(S->pHistory, pSrc, B * sizeof(float32_t));
+
+    S->head = (S->head + 1U < S->parts) ? (S->head + 1U) : 0U;
+    arm_rfft_fast_f32(&S->rfft, S->pWork, S->pDelay + n * S->head, 0);
+
+    memset(S->pAcc, 0, n * sizeof(float32_t));
+    slot = S->head;
+    for (k = 0; k < S->parts; k++)
+    {
+        ols_mac(S->pAcc, S->pSpectra + n * k, S->pDelay + n * slot, n);
+        slot = (slot > 0U) ? (slot - 1U) : (S->parts - 1U);
+    }
+
+    arm_rfft_fast_f32(&S->rfft, S->pAcc, S->pWork, 1);
+    memcpy(pDst, S->pWork + B, B * sizeof(float32_t));
+}
+
+arm_status dsp_ols_fir_f32(dsp_ols_fir_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t B = S->partLen;
+
+    if (((blockSize & (B - 1U)) != 0U) || (S->fill != 0U))
+    {
+        return ARM_MATH_LENGTH_ERROR;
+    }
+
+    for (; blockSize > 0U; blockSize -= B, pSrc += B, pDst += B)
+    {
+        ols_partition(S, pSrc, pDst);
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/* Each sample goes into pIn and the one partLen before it comes out of
+   pOut, at the same index; a full pIn is filtered into pOut. */
+void dsp_ols_fir_stream_f32(dsp_ols_fir_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t B = S->partLen, n;
+
+    for (; blockSize > 0U; blockSize -= n, pSrc += n, pDst += n)
+    {
+        n = B - S->fill;
+        n = (blockSize < n) ? blockSize : n;
+
+        /* In before out, for pSrc == pDst */
+        memcpy(S->pIn + S->fill, pSrc, n * sizeof(float32_t));
+        memcpy(pDst, S->pOut + S->fill, n * sizeof(float32_t));
+
+        S->fill += n;
+        if (S->fill == B)
+        {
+            ols_partition(S, S->pIn, S->pOut);
+            S->fill = 0;
+        }
+    }
+}
+
+#endif /* DSP_EXT_ENABLED */
@@ -0,0 +1,552 @@
+/**
+  ******************************************************************************
+  * @file    dsp_resample.c
+  * @brief   Polyphase multi-stage sample rate converter (dsp_resample.h).
+  ******************************************************************************
+  * A stage up by L and down by M filters the input, with L - 1 zeros put
+  * after each sample, by h and keeps one point in M. Output n is point
+  * n * M = i * L + p of the filtered signal, whose only non-zero inputs are
+  * x[i], x[i - 1], .. so
+  *
+  *   y[n] = h[p] x[i] + h[p + L] x[i - 1] + .. + h[p + (taps - 1) L] x[i - taps + 1]
+  *
+  * the dot product of phase p of the bank, taps long and stored time
+  * reversed, with the last taps inputs. From one output to the next i grows
+  * by M / L or one more, and p by M % L. Each stage's state holds the last
+  * taps - 1 inputs before the block; the block itself is put after them, by
+  * the previous stage directly, and the tail moved to the front afterwards.
+  *
+  * The plan: with the rates relative to the input, the output at L / M and
+  * the lower Nyquist frequency fn = min(1, L / M) / 2, every stage must pass
+  * up to fp = DSP_RESAMPLE_PASS * fn and stop from min(in, out) - fn, where
+  * in and out are its rates: what it lets through between fn and there
+  * falls, once resampled, above fn, where the next stages or the output's
+  * own transition band take it. For a ratio below 1 the prime factors of M
+  * are taken largest first, one a stage, each with the smallest factor of
+  * L left that keeps the rate at or above the output's; above 1 the same is
+  * done for M / L and the stages reversed. Then, while it lowers the
+  * estimated multiply-adds per output, or there are more than maxStages,
+  * the two neighbouring stages whose merging costs least are merged.
+  ******************************************************************************
+  */
+#include <math.h>
+#include <string.h>
+
+#include "dsp_ext.h"
+
+#if DSP_EXT_ENABLED
+
+#include "dsp_resample.h"
+
+#define RS_MAX_FACTORS          16U     /* Prime factors of a 16-bit number */
+#define RS_OUTPUT_COST          4.0     /* Overhead of an output, in multiply-adds */
+#define RS_PI                   3.14159265358979324
+
+typedef struct
+{
+    uint32_t L, M, taps;
+    double fc;                          /* Cutoff, in cycles per sample at L times the input rate */
+    double delay;                       /* In input samples of the converter */
+} rs_stage_plan_t;
+
+typedef struct
+{
+    uint32_t L, M, stages;
+    double cost;                        /* Multiply-adds per output, estimated */
+    rs_stage_plan_t st[RS_MAX_FACTORS];
+} rs_plan_t;
+
+static uint32_t rs_gcd(uint32_t a, uint32_t b)
+{
+    uint32_t t;
+
+    while (b != 0U)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Prime factors in ascending order */
+static uint32_t rs_factor(uint32_t n, uint32_t *f)
+{
+    uint32_t count = 0, p;
+
+    for (p = 2U; n > 1U; p++)
+    {
+        while ((n % p) == 0U)
+        {
+            f[count++] = p;
+            n /= p;
+        }
+    }
+    return count;
+}
+
+/* Filter lengths, cutoffs, delays and cost of the stages in P */
+static void rs_design_plan(rs_plan_t *P)
+{
+    double in = 1.0, out, fn, fp, fs, rate, width, cost = 0.0;
+    double atten = DSP_RESAMPLE_ATTEN_DB;
+    uint32_t i, n;
+    rs_stage_plan_t *st;
+
+    fn = ((P->L < P->M) ? (double)P->L / (double)P->M : 1.0) / 2.0;
+    fp = DSP_RESAMPLE_PASS * fn;
+    for (i = 0; i < P->stages; i++)
+    {
+        st = &P->st[i];
+        out = in * st->L / st->M;
+        fs = ((in < out) ? in : out) - fn;
+        rate = in * st->L;
+        width = (fs - fp) / rate;
+
+        /* Kaiser: (A - 7.95) / (14.36 * width) + 1 taps, a whole number per phase */
+        n = (uint32_t)ceil((atten - 7.95) / (14.36 * width)) + 1U;
+        st->taps = (n + st->L - 1U) / st->L;
+        st->fc = (fp + fs) / (2.0 * rate);
+        st->delay = (st->taps * st->L - 1U) / (2.0 * st->L) / in;
+        cost += (st->taps + RS_OUTPUT_COST) * out / ((double)P->L / (double)P->M);
+        in = out;
+    }
+    P->cost = cost;
+}
+
+static void rs_merge(rs_plan_t *P, uint32_t i)
+{
+    uint32_t L = P->st[i].L * P->st[i + 1U].L, M = P->st[i].M * P->st[i + 1U].M;
+    uint32_t g = rs_gcd(L, M);
+
+    P->st[i].L = L / g;
+    P->st[i].M = M / g;
+    memmove(&P->st[i + 1U], &P->st[i + 2U], (P->stages - i - 2U) * sizeof(rs_stage_plan_t));
+    P->stages--;
+}
+
+/* 0 if the ratio is not supported */
+static uint32_t rs_plan(uint32_t L, uint32_t M, uint32_t maxStages, rs_plan_t *P)
+{
+    uint32_t f[RS_MAX_FACTORS], count, i, u, left, up, down, g;
+    uint64_t l = 1, m = 1;
+    rs_stage_plan_t t;
+    rs_plan_t trial;
+    int32_t best;
+    double cost;
+
+    if ((L == 0U) || (M == 0U))
+    {
+        return 0U;
+    }
+    g = rs_gcd(L, M);
+    L /= g;
+    M /= g;
+    if ((L > DSP_RESAMPLE_MAX_FACTOR) || (M > DSP_RESAMPLE_MAX_FACTOR))
+    {
+        return 0U;
+    }
+    maxStages = ((maxStages == 0U) || (maxStages > DSP_RESAMPLE_MAX_STAGES)) ? DSP_RESAMPLE_MAX_STAGES : maxStages;
+
+    /* Down by the factors of down, largest first, up by those of up */
+    up = (L < M) ? L : M;
+    down = (L < M) ? M : L;
+    count = rs_factor(down, f);
+    left = up;
+    for (i = 0; i < count; i++)
+    {
+        for (u = 1U; ((left % u) != 0U) || (l * u * down < (uint64_t)up * m * f[count - 1U - i]); u++)
+        {
+        }
+        l *= u;
+        m *= f[count - 1U - i];
+        left /= u;
+        P->st[i].L = u;
+        P->st[i].M = f[count - 1U - i];
+    }
+    P->L = L;
+    P->M = M;
+    P->stages = count;
+    if (L > M)
+    {
+        for (i = 0; i < count / 2U; i++)
+        {
+            t = P->st[i];
+            P->st[i] = P->st[count - 1U - i];
+            P->st[count - 1U - i] = t;
+        }
+        for (i = 0; i < count; i++)
+        {
+            u = P->st[i].L;
+            P->st[i].L = P->st[i].M;
+            P->st[i].M = u;
+        }
+    }
+    rs_design_plan(P);
+
+    while (P->stages > 1U)
+    {
+        best = -1;
+        cost = (P->stages > maxStages) ? HUGE_VAL : P->cost;
+        for (i = 0; i + 1U < P->stages; i++)
+        {
+            trial = *P;
+            rs_merge(&trial, i);
+            rs_design_plan(&trial);
+            if (trial.cost < cost)
+            {
+                best = (int32_t)i;
+                cost = trial.cost;
+            }
+        }
+        if (best < 0)
+        {
+            break;
+        }
+        rs_merge(P, (uint32_t)best);
+        rs_design_plan(P);
+    }
+
+    for (i = 0; i < P->stages; i++)
+    {
+        if (P->st[i].taps > 0xFFFFU)
+        {
+            return 0U;
+        }
+    }
+    return 1U;
+}
+
+/* Bytes for count elements of size bytes, kept 4-byte aligned */
+static uint64_t rs_bytes(uint64_t count, uint32_t size)
+{
+    return (count * size + 3U) & ~(uint64_t)3U;
+}
+
+/* Of memory for the stages of P, 0 if too much */
+static uint32_t rs_size(const rs_plan_t *P, uint32_t maxBlock, uint32_t size)
+{
+    uint64_t bytes = 0, in = maxBlock;
+    uint32_t i;
+
+    for (i = 0; i < P->stages; i++)
+    {
+        bytes += rs_bytes((uint64_t)P->st[i].taps * P->st[i].L, size);
+        bytes += rs_bytes(P->st[i].taps - 1U + in, size);
+        in = (in * P->st[i].L + P->st[i].M - 1U) / P->st[i].M;
+    }
+    return (bytes > UINT32_MAX - 3U) ? 0U : (uint32_t)((bytes > 0U) ? bytes : 4U);
+}
+
+static double rs_bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0, k;
+
+    for (k = 1.0; term > 1e-12 * sum; k += 1.0)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+/* Tap n of the Kaiser windowed sinc of stage st, before its gain */
+static double rs_tap(const rs_stage_plan_t *st, double beta, double i0beta, uint32_t n)
+{
+    double N = (double)(st->taps * st->L), t = n - (N - 1.0) / 2.0, r, s;
+
+    r = (N > 1.0) ? 2.0 * n / (N - 1.0) - 1.0 : 0.0;
+    s = (t == 0.0) ? 2.0 * st->fc : sin(2.0 * RS_PI * st->fc * t) / (RS_PI * t);
+    return s * rs_bessel_i0(beta * sqrt(1.0 - r * r)) / i0beta;
+}
+
+/* The polyphase bank of stage st, with a gain of L at DC, into f or q */
+static void rs_bank(const rs_stage_plan_t *st, float32_t *f, q15_t *q)
+{
+    double atten = DSP_RESAMPLE_ATTEN_DB, beta, i0beta, sum = 0.0, v;
+    uint32_t N = st->taps * st->L, n, p, k;
+    int32_t x;
+
+    beta = (atten > 50.0) ? 0.1102 * (atten - 8.7) :
+           (atten > 21.0) ? 0.5842 * pow(atten - 21.0, 0.4) + 0.07886 * (atten - 21.0) : 0.0;
+    i0beta = rs_bessel_i0(beta);
+    for (n = 0; n < N; n++)
+    {
+        sum += rs_tap(st, beta, i0beta, n);
+    }
+
+    /* Phase p, element k is tap p + (taps - 1 - k) * L */
+    for (p = 0; p < st->L; p++)
+    {
+        for (k = 0; k < st->taps; k++)
+        {
+            v = rs_tap(st, beta, i0beta, p + (st->taps - 1U - k) * st->L) * st->L / sum;
+            if (f != NULL)
+            {
+                f[p * st->taps + k] = (float32_t)v;
+            }
+            else
+            {
+                x = (int32_t)floor(v * 32768.0 + 0.5);
+                q[p * st->taps + k] = (q15_t)((x > 32767) ? 32767 : (x < -32768) ? -32768 : x);
+            }
+        }
+    }
+}
+
+/* The stages of an instance from the plan */
+static void rs_setup(const rs_plan_t *P, uint32_t maxBlock, dsp_resample_stage_t *stage, uint32_t *maxOut,
+                     float32_t *delay)
+{
+    uint32_t i, in = maxBlock;
+    double d = 0.0;
+
+    for (i = 0; i < P->stages; i++)
+    {
+        stage[i].L = (uint16_t)P->st[i].L;
+        stage[i].M = (uint16_t)P->st[i].M;
+        stage[i].taps = (uint16_t)P->st[i].taps;
+        stage[i].phase = 0;
+        stage[i].next = 0;
+        stage[i].maxIn = in;
+        in = (in * P->st[i].L + P->st[i].M - 1U) / P->st[i].M;
+        d += P->st[i].delay;
+    }
+    *maxOut = in;
+    *delay = (float32_t)d;
+}
+
+/* Advance to the next output */
+static inline void rs_step(const dsp_resample_stage_t *st, uint32_t *next, uint32_t *phase)
+{
+    *next += st->M / st->L;
+    *phase += st->M % st->L;
+    if (*phase >= st->L)
+    {
+        *phase -= st->L;
+        (*next)++;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * float32_t
+ * ------------------------------------------------------------------------ */
+
+uint32_t dsp_resample_size_f32(uint32_t L, uint32_t M, uint32_t maxStages, uint32_t maxBlock)
+{
+    rs_plan_t P;
+
+    if ((maxBlock == 0U) || !rs_plan(L, M, maxStages, &P))
+    {
+        return 0U;
+    }
+    return rs_size(&P, maxBlock, sizeof(float32_t));
+}
+
+arm_status dsp_resample_init_f32(dsp_resample_instance_f32 *S, uint32_t L, uint32_t M, uint32_t maxStages,
+                                 uint32_t maxBlock, void *mem, uint32_t size)
+{
+    rs_plan_t P;
+    uint8_t *p = (uint8_t *)mem;
+    uint32_t need, i;
+
+    if ((maxBlock == 0U) || (mem == NULL) || !rs_plan(L, M, maxStages, &P))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    need = rs_size(&P, maxBlock, sizeof(float32_t));
+    if ((need == 0U) || (size < need))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    S->L = P.L;
+    S->M = P.M;
+    S->stages = P.stages;
+    S->maxBlock = maxBlock;
+    rs_setup(&P, maxBlock, S->stage, &S->maxOut, &S->delay);
+    for (i = 0; i < P.stages; i++)
+    {
+        S->pBank[i] = (float32_t *)p;
+        p += rs_bytes((uint64_t)P.st[i].taps * P.st[i].L, sizeof(float32_t));
+        S->pState[i] = (float32_t *)p;
+        p += rs_bytes(P.st[i].taps - 1U + S->stage[i].maxIn, sizeof(float32_t));
+        rs_bank(&P.st[i], S->pBank[i], NULL);
+        memset(S->pState[i], 0, (P.st[i].taps - 1U) * sizeof(float32_t));
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/* The inputs are in state after its taps - 1 of history */
+static uint32_t rs_stage_f32(dsp_resample_stage_t *st, const float32_t *bank, float32_t *state, uint32_t nIn,
+                             float32_t *pDst)
+{
+    uint32_t taps = st->taps, next = st->next, phase = st->phase, out = 0, k;
+    const float32_t *px, *pb;
+    float32_t acc;
+
+    while (next < nIn)
+    {
+        px = state + next;
+        pb = bank + phase * taps;
+        acc = 0.0f;
+        for (k = taps >> 2; k > 0U; k--)
+        {
+            acc += px[0] * pb[0];
+            acc += px[1] * pb[1];
+            acc += px[2] * pb[2];
+            acc += px[3] * pb[3];
+            px += 4;
+            pb += 4;
+        }
+        for (k = taps & 3U; k > 0U; k--)
+        {
+            acc += *px++ * *pb++;
+        }
+        pDst[out++] = acc;
+        rs_step(st, &next, &phase);
+    }
+
+    st->next = next - nIn;
+    st->phase = (uint16_t)phase;
+    memmove(state, state + nIn, (taps - 1U) * sizeof(float32_t));
+    return out;
+}
+
+uint32_t dsp_resample_f32(dsp_resample_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t i, n = blockSize;
+    float32_t *dst;
+
+    if (blockSize > S->maxBlock)
+    {
+        return 0U;
+    }
+    if (S->stages == 0U)
+    {
+        memcpy(pDst, pSrc, blockSize * sizeof(float32_t));
+        return blockSize;
+    }
+
+    /* Each stage writes into the next one's state */
+    memcpy(S->pState[0] + S->stage[0].taps - 1U, pSrc, blockSize * sizeof(float32_t));
+    for (i = 0; i < S->stages; i++)
+    {
+        dst = (i + 1U < S->stages) ? S->pState[i + 1U] + S->stage[i + 1U].taps - 1U : pDst;
+        n = rs_stage_f32(&S->stage[i], S->pBank[i], S->pState[i], n, dst);
+    }
+    return n;
+}
+
+/* ---------------------------------------------------------------------------
+ * q15_t
+ * ------------------------------------------------------------------------ */
+
+uint32_t dsp_resample_size_q15(uint32_t L, uint32_t M, uint32_t maxStages, uint32_t maxBlock)
+{
+    rs_plan_t P;
+
+    if ((maxBlock == 0U) || !rs_plan(L, M, maxStages, &P))
+    {
+        return 0U;
+    }
+    return rs_size(&P, maxBlock, sizeof(q15_t));
+}
+
+arm_status dsp_resample_init_q15(dsp_resample_instance_q15 *S, uint32_t L, uint32_t M, uint32_t maxStages,
+                                 uint32_t maxBlock, void *mem, uint32_t size)
+{
+    rs_plan_t P;
+    uint8_t *p = (uint8_t *)mem;
+    uint32_t need, i;
+
+    if ((maxBlock == 0U) || (mem == NULL) || !rs_plan(L, M, maxStages, &P))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    need = rs_size(&P, maxBlock, sizeof(q15_t));
+    if ((need == 0U) || (size < need))
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    S->L = P.L;
+    S->M = P.M;
+    S->stages = P.stages;
+    S->maxBlock = maxBlock;
+    rs_setup(&P, maxBlock, S->stage, &S->maxOut, &S->delay);
+    for (i = 0; i < P.stages; i++)
+    {
+        S->pBank[i] = (q15_t *)p;
+        p += rs_bytes((uint64_t)P.st[i].taps * P.st[i].L, sizeof(q15_t));
+        S->pState[i] = (q15_t *)p;
+        p += rs_bytes(P.st[i].taps - 1U + S->stage[i].maxIn, sizeof(q15_t));
+        rs_bank(&P.st[i], NULL, S->pBank[i]);
+        memset(S->pState[i], 0, (P.st[i].taps - 1U) * sizeof(q15_t));
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/* As rs_stage_f32, the products summed in a 64-bit accumulator as arm_fir_q15 does */
+static uint32_t rs_stage_q15(dsp_resample_stage_t *st, const q15_t *bank, q15_t *state, uint32_t nIn,
+                             q15_t *pDst)
+{
+    uint32_t taps = st->taps, next = st->next, phase = st->phase, out = 0, k;
+    q15_t *px, *pb;
+    q63_t acc;
+
+    while (next < nIn)
+    {
+        px = state + next;
+        pb = (q15_t *)bank + phase * taps;
+        acc = 0;
+#if defined(ARM_MATH_DSP)
+        for (k = taps >> 1; k > 0U; k--)
+        {
+            acc = __SMLALD(*__SIMD32(px)++, *__SIMD32(pb)++, acc);
+        }
+        if ((taps & 1U) != 0U)
+        {
+            acc += (q31_t)*px * *pb;
+        }
+#else
+        for (k = taps; k > 0U; k--)
+        {
+            acc += (q31_t)*px++ * *pb++;
+        }
+#endif
+        pDst[out++] = (q15_t)__SSAT((acc >> 15), 16);
+        rs_step(st, &next, &phase);
+    }
+
+    st->next = next - nIn;
+    st->phase = (uint16_t)phase;
+    memmove(state, state + nIn, (taps - 1U) * sizeof(q15_t));
+    return out;
+}
+
+uint32_t dsp_resample_q15(dsp_resample_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t i, n = blockSize;
+    q15_t *dst;
+
+    if (blockSize > S->maxBlock)
+    {
+        return 0U;
+    }
+    if (S->stages == 0U)
+    {
+        memcpy(pDst, pSrc, blockSize * sizeof(q15_t));
+        return blockSize;
+    }
+
+    memcpy(S->pState[0] + S->stage[0].taps - 1U, pSrc, blockSize * sizeof(q15_t));
+    for (i = 0; i < S->stages; i++)
+    {
+        dst = (i + 1U < S->stages) ? S->pState[i + 1U] + S->stage[i + 1U].taps - 1U : pDst;
+        n = rs_stage_q15(&S->stage[i], S->pBank[i], S->pState[i], n, dst);
+    }
+    return n;
+}
+
+#endif /* DSP_EXT_ENABLED */
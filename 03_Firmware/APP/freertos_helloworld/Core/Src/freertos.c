@@ -26,6 +26,10 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include <stdio.h>
+#include "bench.h"
+#include "stack_prof.h"
+#include "task_arena.h"
+#include "cyclic.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -45,7 +49,20 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-
+/* Name of the task whose stack overflowed, for the debugger */
+volatile const char *stack_overflow_task;
+
+void app_job_1ms(void *argument);
+void app_job_10ms(void *argument);
+void app_job_100ms(void *argument);
+
+/* Periodic application work, run by the cyclic executive (cyclic.h). The
+   offsets keep the slower jobs out of each other's minor cycle. */
+static const cyclic_job_t app_jobs[] = {
+  { "1ms",   app_job_1ms,   NULL, 1,   0, 200,   CYCLIC_OVERRUN_SKIP },
+  { "10ms",  app_job_10ms,  NULL, 10,  1, 2000,  CYCLIC_OVERRUN_SKIP },
+  { "100ms", app_job_100ms, NULL, 100, 2, 20000, CYCLIC_OVERRUN_CATCH_UP },
+};
 /* USER CODE END Variables */
 /* Definitions for defaultTask */
 osThreadId_t defaultTaskHandle;
@@ -64,6 +81,23 @@ void StartDefaultTask(void *argument);
 
 void MX_FREERTOS_Init(void); /* (MISRA C 2004 rule 8.1) */
 
+/* Hook prototypes */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName);
+
+/* USER CODE BEGIN 4 */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+  /* Run time stack overflow checking is performed if
+  configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2. This hook function is
+  called if a stack overflow is detected. The stack and possibly the TCB are
+  corrupt, so nothing is logged: stop with the task's name in
+  stack_overflow_task. */
+  (void)xTask;
+  stack_overflow_task = pcTaskName;
+  Error_Handler();
+}
+/* USER CODE END 4 */
+
 /**
   * @brief  FreeRTOS initialization
   * @param  None
@@ -84,6 +118,9 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_TIMERS */
     /* start timers, add new ones, ... */
+#if STACK_PROF_ENABLE
+    stack_prof_init();
+#endif
   /* USER CODE END RTOS_TIMERS */
 
   /* USER CODE BEGIN RTOS_QUEUES */
@@ -114,16 +151,49 @@ void MX_FREERTOS_Init(void) {
 void StartDefaultTask(void *argument)
 {
   /* USER CODE BEGIN StartDefaultTask */
-    /* Infinite loop */
-    for (;;)
+#if APP_BENCH_ENABLE
+    bench_run_all();
+#endif
+#if STACK_PROF_ENABLE
+    stack_prof_report();
+#endif
+    task_arena_report();
+    if (cyclic_start(app_jobs, sizeof(app_jobs) / sizeof(app_jobs[0])) != 0)
     {
+        Error_Handler();
+    }
 
+    /* Periodic work runs in the cyclic executive and aperiodic work in tasks
+       of its own; this task only reports. */
+    for (;;)
+    {
+#if CYCLIC_REPORT_MS
+        osDelay(CYCLIC_REPORT_MS);
+        cyclic_report();
+#else
+        osDelay(osWaitForever);
+#endif
     }
   /* USER CODE END StartDefaultTask */
 }
 
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
+/* The application's periodic jobs; override these. Each must return well
+   within its budget in app_jobs. */
+__weak void app_job_1ms(void *argument)
+{
+  (void)argument;
+}
+
+__weak void app_job_10ms(void *argument)
+{
+  (void)argument;
+}
 
+__weak void app_job_100ms(void *argument)
+{
+  (void)argument;
+}
 /* USER CODE END Application */
 
@@ -0,0 +1,312 @@
+/**
+  ******************************************************************************
+  * @file    log_uart.c
+  * @brief   Log ring drained in place by the UART DMA.
+  ******************************************************************************
+  */
+#include <string.h>
+#include "log_uart.h"
+#include "uart_dma.h"
+#include "elog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Drop-oldest frees at least this much at once, so that under sustained
+ * overload the queued lines are moved up rarely, not on every line. */
+#define LOG_UART_DROP_MIN       (LOG_UART_RING_SIZE / 4)
+
+static uint8_t s_ring[LOG_UART_RING_SIZE];
+static uint32_t s_head;                 /* Offset of the next byte written */
+static uint32_t s_tail;                 /* Offset of the oldest byte not yet sent */
+static uint32_t s_count;                /* Bytes from s_tail to s_head */
+static uint32_t s_claimed;              /* Bytes from s_tail being sent by DMA */
+static SemaphoreHandle_t s_lock;        /* One writer at a time */
+static SemaphoreHandle_t s_space;       /* Given whenever DMA frees room */
+
+static log_uart_policy_t s_policy[ELOG_LVL_TOTAL_NUM] =
+{
+    LOG_UART_BLOCK,                     /* ELOG_LVL_ASSERT */
+    LOG_UART_BLOCK,                     /* ELOG_LVL_ERROR */
+    LOG_UART_DROP_OLDEST,               /* ELOG_LVL_WARN */
+    LOG_UART_DROP_OLDEST,               /* ELOG_LVL_INFO */
+    LOG_UART_DROP_NEWEST,               /* ELOG_LVL_DEBUG */
+    LOG_UART_DROP_NEWEST,               /* ELOG_LVL_VERBOSE */
+};
+
+static log_uart_stats_t s_stats;
+static TickType_t s_window_start;
+static uint32_t s_window_bytes;
+
+static size_t log_uart_claim(const uint8_t **chunk, size_t max)
+{
+    size_t len = s_count;
+
+    if (len > LOG_UART_RING_SIZE - s_tail)
+    {
+        len = LOG_UART_RING_SIZE - s_tail;
+    }
+    if (len > max)
+    {
+        len = max;
+    }
+
+    *chunk = &s_ring[s_tail];
+    s_claimed = len;
+
+    return len;
+}
+
+static void log_uart_release(size_t len)
+{
+    TickType_t now = xTaskGetTickCountFromISR();
+
+    s_tail = (s_tail + len) % LOG_UART_RING_SIZE;
+    s_count -= len;
+    s_claimed = 0;
+
+    s_stats.sent_bytes += len;
+    s_window_bytes += len;
+    if (now - s_window_start >= configTICK_RATE_HZ)
+    {
+        s_stats.rate = (uint32_t)((uint64_t)s_window_bytes * configTICK_RATE_HZ / (now - s_window_start));
+        s_window_start = now;
+        s_window_bytes = 0;
+    }
+
+    if (len != 0)
+    {
+        (void)xSemaphoreGiveFromISR(s_space, NULL);
+    }
+}
+
+static const uart_dma_source_t s_source = {log_uart_claim, log_uart_release};
+
+/* Copy n bytes from the ring at src to dst, both offsets, with dst behind src
+ * in ring order, one contiguous run at a time. */
+static void log_uart_move(uint32_t dst, uint32_t src, uint32_t n)
+{
+    uint32_t run;
+
+    while (n != 0)
+    {
+        run = n;
+        if (run > LOG_UART_RING_SIZE - src)
+        {
+            run = LOG_UART_RING_SIZE - src;
+        }
+        if (run > LOG_UART_RING_SIZE - dst)
+        {
+            run = LOG_UART_RING_SIZE - dst;
+        }
+        memmove(&s_ring[dst], &s_ring[src], run);
+        src = (src + run) % LOG_UART_RING_SIZE;
+        dst = (dst + run) % LOG_UART_RING_SIZE;
+        n -= run;
+    }
+}
+
+/* Length of the line starting at offset from, newline included, or n if no
+ * newline is found in the n bytes queued from there. */
+static uint32_t log_uart_line_len(uint32_t from, uint32_t n)
+{
+    uint32_t len = 0, run;
+    uint8_t *nl;
+
+    while (len < n)
+    {
+        from = (from + len) % LOG_UART_RING_SIZE;
+        run = n - len;
+        if (run > LOG_UART_RING_SIZE - from)
+        {
+            run = LOG_UART_RING_SIZE - from;
+        }
+        nl = memchr(&s_ring[from], '\n', run);
+        if (nl != NULL)
+        {
+            return len + (uint32_t)(nl - &s_ring[from]) + 1;
+        }
+        len += run;
+    }
+
+    return n;
+}
+
+/* Discard whole queued lines, oldest first, from those DMA has not claimed,
+ * until need bytes are free. The newer lines are moved up over them. Called
+ * with interrupts masked. */
+static void log_uart_drop_oldest(uint32_t need)
+{
+    uint32_t first = (s_tail + s_claimed) % LOG_UART_RING_SIZE;
+    uint32_t queued = s_count - s_claimed;
+    uint32_t target, len, drop = 0, lines = 0;
+
+    /* DMA stops at the end of the ring, possibly mid line: keep the rest of
+     * that line so it goes out whole. */
+    if ((s_claimed != 0) && (s_ring[(first + LOG_UART_RING_SIZE - 1) % LOG_UART_RING_SIZE] != '\n'))
+    {
+        len = log_uart_line_len(first, queued);
+        first = (first + len) % LOG_UART_RING_SIZE;
+        queued -= len;
+    }
+
+    target = need - (LOG_UART_RING_SIZE - s_count);
+    if (target < LOG_UART_DROP_MIN)
+    {
+        target = LOG_UART_DROP_MIN;
+    }
+
+    while ((drop < target) && (drop < queued))
+    {
+        drop += log_uart_line_len((first + drop) % LOG_UART_RING_SIZE, queued - drop);
+        lines++;
+    }
+
+    log_uart_move(first, (first + drop) % LOG_UART_RING_SIZE, queued - drop);
+    s_head = (first + queued - drop) % LOG_UART_RING_SIZE;
+    s_count -= drop;
+
+    s_stats.dropped_lines += lines;
+    s_stats.dropped_bytes += drop;
+}
+
+/**
+ * @brief  Start the UART at baudrate and attach the log ring to it.
+ * @retval 0 on success, -1 on failure.
+ */
+int log_uart_init(uint32_t baudrate)
+{
+    SemaphoreHandle_t lock;
+
+    s_space = xSemaphoreCreateBinary();
+    lock = xSemaphoreCreateMutex();
+    if ((s_space == NULL) || (lock == NULL) || (uart_dma_init(baudrate) != 0))
+    {
+        /* s_lock stays NULL, so log_uart_write() discards every line. */
+        return -1;
+    }
+
+    uart_dma_set_source(&s_source);
+    s_lock = lock;
+
+    return 0;
+}
+
+/**
+ * @brief  Set what happens to lines of level when the ring is full.
+ */
+void log_uart_set_policy(uint8_t level, log_uart_policy_t policy)
+{
+    if (level < ELOG_LVL_TOTAL_NUM)
+    {
+        s_policy[level] = policy;
+    }
+}
+
+/**
+ * @brief  Queue one formatted line. Lines logged from interrupts are dropped:
+ *         EasyLogger formats into a shared buffer and is not interrupt safe.
+ */
+void log_uart_write(uint8_t level, const char *log, size_t size)
+{
+    log_uart_policy_t policy = s_policy[(level < ELOG_LVL_TOTAL_NUM) ? level : ELOG_LVL_VERBOSE];
+    BaseType_t task = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+    UBaseType_t mask;
+    uint32_t at, run;
+
+    if ((s_lock == NULL) || (size == 0))
+    {
+        return;
+    }
+
+    if ((size > LOG_UART_RING_SIZE) || (xPortIsInsideInterrupt() != pdFALSE))
+    {
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        s_stats.dropped_lines++;
+        s_stats.dropped_bytes += size;
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+        return;
+    }
+
+    if ((policy == LOG_UART_BLOCK) && !task)
+    {
+        policy = LOG_UART_DROP_OLDEST;
+    }
+
+    if (task)
+    {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+    }
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        if ((size > LOG_UART_RING_SIZE - s_count) && (policy == LOG_UART_DROP_OLDEST))
+        {
+            log_uart_drop_oldest(size);
+        }
+        if (size <= LOG_UART_RING_SIZE - s_count)
+        {
+            break;
+        }
+        if (policy != LOG_UART_BLOCK)
+        {
+            s_stats.dropped_lines++;
+            s_stats.dropped_bytes += size;
+            taskEXIT_CRITICAL();
+            if (task)
+            {
+                xSemaphoreGive(s_lock);
+            }
+            return;
+        }
+        s_stats.blocked++;
+        taskEXIT_CRITICAL();
+
+        xSemaphoreTake(s_space, portMAX_DELAY);
+    }
+    at = s_head;
+    taskEXIT_CRITICAL();
+
+    /* DMA only claims bytes below s_head and the writer lock keeps other
+     * writers out, so the copy runs with interrupts enabled. */
+    run = LOG_UART_RING_SIZE - at;
+    if (run >= size)
+    {
+        memcpy(&s_ring[at], log, size);
+    }
+    else
+    {
+        memcpy(&s_ring[at], log, run);
+        memcpy(&s_ring[0], log + run, size - run);
+    }
+
+    taskENTER_CRITICAL();
+    s_head = (at + size) % LOG_UART_RING_SIZE;
+    s_count += size;
+    s_stats.queued_bytes += size;
+    if (s_count > s_stats.peak)
+    {
+        s_stats.peak = s_count;
+    }
+    taskEXIT_CRITICAL();
+
+    if (task)
+    {
+        xSemaphoreGive(s_lock);
+    }
+
+    uart_dma_kick();
+}
+
+void log_uart_get_stats(log_uart_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = s_stats;
+    /* Nothing sent for two windows: the last rate no longer holds. */
+    if (xTaskGetTickCount() - s_window_start >= 2 * configTICK_RATE_HZ)
+    {
+        stats->rate = 0;
+    }
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    mutex_prof.c
+  * @brief   Log and RTT reports of the CMSIS-RTOS2 mutex profile.
+  ******************************************************************************
+  */
+#define LOG_TAG "mprof"
+
+#include <string.h>
+#include "mutex_prof.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "freertos_os2_mprof.h"
+#include "SEGGER_RTT.h"
+
+static uint32_t mutex_prof_us(uint64_t counts, uint32_t hz)
+{
+    return (hz != 0) ? (uint32_t)((counts * 1000000U) / hz) : 0;
+}
+
+static const char *mutex_prof_name(const char *name)
+{
+    return (name != NULL) ? name : "(unnamed)";
+}
+
+/**
+ * @brief  Print the profile of every mutex and the inheritances kept, latest
+ *         first.
+ */
+void mutex_prof_log(void)
+{
+    osMutexProfile_t prof;
+    osMutexInheritEvent_t ev;
+    uint32_t hz, i, avg;
+
+    hz = osMutexProfileClockHz();
+    if (osMutexProfileGet(0, &prof) == osError)
+    {
+        log_i("mutex profile not built, set configUSE_OS2_MUTEX_PROFILE to 1");
+        return;
+    }
+
+    for (i = 0; osMutexProfileGet(i, &prof) == osOK; i++)
+    {
+        avg = (prof.contended != 0) ? mutex_prof_us(prof.wait_total / prof.contended, hz) : 0;
+        log_i("%-16s acq %lu cont %lu (%lu%%) tmo %lu inh %lu wait avg %lu max %lu us hold max %lu us",
+              mutex_prof_name(prof.name),
+              (unsigned long)prof.acquired,
+              (unsigned long)prof.contended,
+              (unsigned long)((prof.acquired != 0) ? (prof.contended * 100U) / prof.acquired : 0),
+              (unsigned long)prof.timeouts,
+              (unsigned long)prof.inherits,
+              (unsigned long)avg,
+              (unsigned long)mutex_prof_us(prof.wait_max, hz),
+              (unsigned long)mutex_prof_us(prof.hold_max, hz));
+    }
+
+    for (i = 0; osMutexProfileGetInherit(i, &ev) == osOK; i++)
+    {
+        log_i("inherit %s: %s (prio %u) waits on %s (prio %u)",
+              mutex_prof_name(ev.name), ev.waiter, ev.waiter_prio, ev.owner, ev.owner_prio);
+    }
+}
+
+/**
+ * @brief  Write the profile as binary records to RTT up-buffer channel. The
+ *         caller configures the channel, in SEGGER_RTT_MODE_NO_BLOCK_SKIP mode
+ *         so that a record that does not fit is left out whole.
+ * @retval Number of records written, or -1 if profiling is not built.
+ */
+int mutex_prof_rtt(unsigned channel)
+{
+    osMutexProfile_t prof;
+    osMutexInheritEvent_t ev;
+    mutex_prof_rec_t rec;
+    mutex_prof_inherit_t inh;
+    uint32_t i, n;
+    int written = 0;
+
+    if (osMutexProfileGet(0, &prof) == osError)
+    {
+        return -1;
+    }
+
+    for (i = 0; osMutexProfileGet(i, &prof) == osOK; i++)
+    {
+        memset(&rec, 0, sizeof(rec));
+        rec.type = MUTEX_PROF_REC_STAT;
+        rec.clock_hz = osMutexProfileClockHz();
+        rec.mutex = (uint32_t)(uintptr_t)prof.mutex_id;
+        rec.acquired = prof.acquired;
+        rec.contended = prof.contended;
+        rec.timeouts = prof.timeouts;
+        rec.inherits = prof.inherits;
+        rec.wait_max = prof.wait_max;
+        rec.hold_max = prof.hold_max;
+        rec.wait_total_lo = (uint32_t)prof.wait_total;
+        rec.wait_total_hi = (uint32_t)(prof.wait_total >> 32);
+        if (prof.name != NULL)
+        {
+            strncpy(rec.name, prof.name, sizeof(rec.name));
+        }
+        if (SEGGER_RTT_Write(channel, &rec, sizeof(rec)) != 0)
+        {
+            written++;
+        }
+    }
+
+    /* Oldest first, so that the host sees them in time order */
+    n = 0;
+    while (osMutexProfileGetInherit(n, &ev) == osOK)
+    {
+        n++;
+    }
+    while (n-- > 0)
+    {
+        if (osMutexProfileGetInherit(n, &ev) != osOK)
+        {
+            continue;
+        }
+        memset(&inh, 0, sizeof(inh));
+        inh.type = MUTEX_PROF_REC_INHERIT;
+        inh.owner_prio = ev.owner_prio;
+        inh.waiter_prio = ev.waiter_prio;
+        inh.time = ev.time;
+        inh.mutex = (uint32_t)(uintptr_t)ev.mutex_id;
+        if (ev.name != NULL)
+        {
+            strncpy(inh.name, ev.name, sizeof(inh.name));
+        }
+        memcpy(inh.owner, ev.owner, sizeof(inh.owner));
+        memcpy(inh.waiter, ev.waiter, sizeof(inh.waiter));
+        if (SEGGER_RTT_Write(channel, &inh, sizeof(inh)) != 0)
+        {
+            written++;
+        }
+    }
+
+    return written;
+}
@@ -0,0 +1,286 @@
+/**
+  ******************************************************************************
+  * @file    stack_prof.c
+  * @brief   Task and main stack high-water sampling and size recommendations.
+  ******************************************************************************
+  */
+#define LOG_TAG "stack"
+
+#include <string.h>
+#include "stack_prof.h"
+#include "main.h"
+#include "elog.h"
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if STACK_PROF_ENABLE
+
+#if (configUSE_TRACE_FACILITY != 1) || (configRECORD_STACK_HIGH_ADDRESS != 1)
+#error "The stack profiler needs configUSE_TRACE_FACILITY and configRECORD_STACK_HIGH_ADDRESS set to 1"
+#endif
+
+/* Main stack bounds: the STACK section of the startup file for the ARM
+ * linker, the _estack/_Min_Stack_Size symbols of the CubeMX linker scripts
+ * for GCC. */
+#if defined(__CC_ARM) || defined(__ARMCC_VERSION)
+extern uint32_t STACK$$Base[];
+extern uint32_t STACK$$Limit[];
+#define STACK_PROF_MSP_BASE     ((uint32_t *)STACK$$Base)
+#define STACK_PROF_MSP_LIMIT    ((uint32_t *)STACK$$Limit)
+#else
+extern uint32_t _estack[];
+extern uint32_t _Min_Stack_Size[];
+#define STACK_PROF_MSP_BASE     ((uint32_t *)((uint32_t)_estack - (uint32_t)_Min_Stack_Size))
+#define STACK_PROF_MSP_LIMIT    ((uint32_t *)_estack)
+#endif
+
+#define STACK_PROF_FILL         0xA5A5A5A5U     /* The kernel's tskSTACK_FILL_BYTE */
+#define STACK_PROF_MSP_GUARD    16              /* Words left unpainted below SP */
+
+typedef struct
+{
+    stack_prof_task_t info;
+    uint8_t seen;                       /* Present in the latest sample */
+    uint8_t warned;
+} stack_prof_entry_t;
+
+static stack_prof_entry_t s_tasks[STACK_PROF_MAX_TASKS];
+static TaskStatus_t s_status[STACK_PROF_MAX_TASKS];
+static uint32_t s_msp_used;
+static uint8_t s_overflow_logged;
+static osTimerId_t s_timer;
+
+/* Entry for a task number, a new one if it is not tracked yet. When the
+ * table is full the first deleted task's entry is reused. */
+static stack_prof_entry_t *stack_prof_entry(uint32_t number)
+{
+    stack_prof_entry_t *dead = NULL;
+    uint32_t i;
+
+    for (i = 0; i < STACK_PROF_MAX_TASKS; i++)
+    {
+        if ((s_tasks[i].info.size != 0) && (s_tasks[i].info.number == number))
+        {
+            return &s_tasks[i];
+        }
+    }
+
+    for (i = 0; i < STACK_PROF_MAX_TASKS; i++)
+    {
+        if (s_tasks[i].info.size == 0)
+        {
+            return &s_tasks[i];
+        }
+        if ((dead == NULL) && !s_tasks[i].info.alive)
+        {
+            dead = &s_tasks[i];
+        }
+    }
+
+    if (dead != NULL)
+    {
+        memset(dead, 0, sizeof(*dead));
+    }
+    return dead;
+}
+
+/* Words of the main stack never written since stack_prof_init(), scanning up
+ * from the far end. */
+static uint32_t stack_prof_msp_free(void)
+{
+    const uint32_t *p = STACK_PROF_MSP_BASE;
+
+    while ((p < STACK_PROF_MSP_LIMIT) && (*p == STACK_PROF_FILL))
+    {
+        p++;
+    }
+    return (uint32_t)(p - STACK_PROF_MSP_BASE);
+}
+
+static void stack_prof_timer(void *argument)
+{
+    (void)argument;
+    stack_prof_sample();
+}
+
+/**
+ * @brief  Paint the free part of the main stack and start sampling. Call
+ *         before the scheduler starts, while main() still runs on this stack.
+ */
+void stack_prof_init(void)
+{
+    uint32_t *p = STACK_PROF_MSP_BASE;
+    uint32_t *sp = (uint32_t *)__get_MSP() - STACK_PROF_MSP_GUARD;
+
+    while (p < sp)
+    {
+        *p++ = STACK_PROF_FILL;
+    }
+
+    s_timer = osTimerNew(stack_prof_timer, osTimerPeriodic, NULL, NULL);
+    if (s_timer != NULL)
+    {
+        osTimerStart(s_timer, pdMS_TO_TICKS(STACK_PROF_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief  Take one sample of every task's and the main stack's deepest use.
+ *         Runs from the profiler's timer; call it directly for an up to date
+ *         report.
+ */
+void stack_prof_sample(void)
+{
+    stack_prof_entry_t *e;
+    TaskStatus_t *st;
+    UBaseType_t n, i;
+    uint32_t used;
+
+    /* With the scheduler suspended no task can be deleted, and no deleted
+     * task freed, between reading the states and the stack sizes. */
+    vTaskSuspendAll();
+
+    n = uxTaskGetSystemState(s_status, STACK_PROF_MAX_TASKS, NULL);
+
+    for (i = 0; i < STACK_PROF_MAX_TASKS; i++)
+    {
+        s_tasks[i].seen = 0;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        st = &s_status[i];
+        e = stack_prof_entry(st->xTaskNumber);
+        if (e == NULL)
+        {
+            continue;
+        }
+
+        if (e->info.size == 0)
+        {
+            strncpy(e->info.name, st->pcTaskName, STACK_PROF_NAME_LEN - 1);
+            e->info.number = st->xTaskNumber;
+            e->info.size = uxTaskGetStackDepth(st->xHandle) * sizeof(StackType_t);
+        }
+
+        used = e->info.size - st->usStackHighWaterMark * sizeof(StackType_t);
+        if (used > e->info.used)
+        {
+            e->info.used = used;
+            e->info.recommended = stack_prof_recommend(used);
+        }
+        e->info.alive = 1;
+        e->seen = 1;
+    }
+
+    for (i = 0; i < STACK_PROF_MAX_TASKS; i++)
+    {
+        if (!s_tasks[i].seen)
+        {
+            s_tasks[i].info.alive = 0;
+        }
+    }
+
+    (void)xTaskResumeAll();
+
+    s_msp_used = (uint32_t)(STACK_PROF_MSP_LIMIT - STACK_PROF_MSP_BASE) * sizeof(uint32_t)
+                 - stack_prof_msp_free() * sizeof(uint32_t);
+
+    /* uxTaskGetSystemState() fills nothing when the array is too short */
+    if ((n == 0) && !s_overflow_logged)
+    {
+        s_overflow_logged = 1;
+        log_w("more than %d tasks, raise STACK_PROF_MAX_TASKS", STACK_PROF_MAX_TASKS);
+    }
+
+    for (i = 0; i < STACK_PROF_MAX_TASKS; i++)
+    {
+        e = &s_tasks[i];
+        if (e->seen && !e->warned && ((e->info.size - e->info.used) < STACK_PROF_WARN_BYTES))
+        {
+            e->warned = 1;
+            log_w("%s: %lu of %lu stack bytes used", e->info.name,
+                  (unsigned long)e->info.used, (unsigned long)e->info.size);
+        }
+    }
+}
+
+/**
+ * @brief  Copy the index-th tracked task, counting from 0.
+ * @retval 0 on success, -1 past the last one.
+ */
+int stack_prof_get(uint32_t index, stack_prof_task_t *task)
+{
+    uint32_t i;
+
+    for (i = 0; i < STACK_PROF_MAX_TASKS; i++)
+    {
+        if (s_tasks[i].info.size == 0)
+        {
+            continue;
+        }
+        if (index-- == 0)
+        {
+            vTaskSuspendAll();
+            *task = s_tasks[i].info;
+            (void)xTaskResumeAll();
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief  Size of the main stack and its deepest use seen, in bytes.
+ */
+void stack_prof_msp(uint32_t *size, uint32_t *used)
+{
+    *size = (uint32_t)(STACK_PROF_MSP_LIMIT - STACK_PROF_MSP_BASE) * sizeof(uint32_t);
+    *used = s_msp_used;
+}
+
+uint32_t stack_prof_recommend(uint32_t used)
+{
+    uint32_t size = used + (used * STACK_PROF_MARGIN_PCT) / 100;
+
+    size = (size + 7U) & ~7U;
+    return (size < STACK_PROF_MIN_BYTES) ? STACK_PROF_MIN_BYTES : size;
+}
+
+/**
+ * @brief  Sample, then log each task's stack use and recommended stack_size,
+ *         the same for the main stack, and the RAM the recommendations free.
+ */
+void stack_prof_report(void)
+{
+    stack_prof_task_t t;
+    uint32_t i, size, used, saved = 0;
+
+    stack_prof_sample();
+
+    log_i("%-16s %6s %6s %5s %10s", "task", "size", "used", "%", "stack_size");
+    for (i = 0; stack_prof_get(i, &t) == 0; i++)
+    {
+        log_i("%-16s %6lu %6lu %4lu%% %10lu%s", t.name, (unsigned long)t.size,
+              (unsigned long)t.used, (unsigned long)(t.used * 100U / t.size),
+              (unsigned long)t.recommended, t.alive ? "" : " (deleted)");
+        if (t.alive && (t.recommended < t.size))
+        {
+            saved += t.size - t.recommended;
+        }
+    }
+
+    stack_prof_msp(&size, &used);
+    log_i("%-16s %6lu %6lu %4lu%% %10lu (Stack_Size)", "main/ISR", (unsigned long)size,
+          (unsigned long)used, (unsigned long)(used * 100U / size),
+          (unsigned long)stack_prof_recommend(used));
+    if (stack_prof_recommend(used) < size)
+    {
+        saved += size - stack_prof_recommend(used);
+    }
+
+    log_i("%lu bytes of stack reclaimable at %d%% margin", (unsigned long)saved, STACK_PROF_MARGIN_PCT);
+}
+
+#endif /* STACK_PROF_ENABLE */
@@ -0,0 +1,269 @@
+/**
+  ******************************************************************************
+  * @file    task_arena.c
+  * @brief   Per-task bump allocator and its accounting.
+  ******************************************************************************
+  */
+#define LOG_TAG "arena"
+
+#include "task_arena.h"
+#include "elog.h"
+
+/* Every arena handed out, so task_arena_report() can list them. */
+static task_arena_t *s_arenas;
+
+/* Heap regions of arenas whose task was deleted without task_arena_destroy(),
+ * chained through their first word until they can be freed. */
+static void *s_orphans;
+
+/* Free the orphaned regions, outside any critical section. */
+static void task_arena_reclaim(void)
+{
+    void *region;
+
+    for (;;)
+    {
+        taskENTER_CRITICAL();
+        region = s_orphans;
+        if (region != NULL)
+        {
+            s_orphans = *(void **)region;
+        }
+        taskEXIT_CRITICAL();
+
+        if (region == NULL)
+        {
+            break;
+        }
+        vPortFree(region);
+    }
+}
+
+/**
+ * @brief  Attach an arena backed by buf to the calling task.
+ * @param  arena: Arena descriptor, must stay valid until task_arena_destroy().
+ * @param  buf:   Region to allocate from, aligned to portBYTE_ALIGNMENT.
+ * @param  size:  Size of buf in bytes.
+ * @retval pdPASS, or pdFAIL if the task already has an arena.
+ */
+BaseType_t task_arena_init(task_arena_t *arena, void *buf, size_t size)
+{
+    configASSERT(((size_t)buf & portBYTE_ALIGNMENT_MASK) == 0);
+
+    if ((arena == NULL) || (buf == NULL) || (task_arena_self() != NULL))
+    {
+        return pdFAIL;
+    }
+
+    arena->base = (uint8_t *)buf;
+    arena->size = size;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->allocs = 0;
+    arena->fails = 0;
+    arena->resets = 0;
+    arena->owner = xTaskGetCurrentTaskHandle();
+    arena->heap_owned = 0;
+
+    taskENTER_CRITICAL();
+    arena->next = s_arenas;
+    s_arenas = arena;
+    taskEXIT_CRITICAL();
+
+    vTaskSetThreadLocalStoragePointer(NULL, TASK_ARENA_TLS_INDEX, arena);
+
+    return pdPASS;
+}
+
+/**
+ * @brief  Attach an arena of size bytes, taken once from the FreeRTOS heap, to
+ *         the calling task.
+ * @retval pdPASS, or pdFAIL if the heap is exhausted or the task already has
+ *         an arena.
+ */
+BaseType_t task_arena_create(task_arena_t *arena, size_t size)
+{
+    void *buf;
+
+    if (task_arena_self() != NULL)
+    {
+        return pdFAIL;
+    }
+
+    task_arena_reclaim();
+
+    buf = pvPortMalloc(size);
+    if (buf == NULL)
+    {
+        return pdFAIL;
+    }
+
+    if (task_arena_init(arena, buf, size) != pdPASS)
+    {
+        vPortFree(buf);
+        return pdFAIL;
+    }
+
+    arena->heap_owned = 1;
+
+    return pdPASS;
+}
+
+/**
+ * @brief  Detach the arena from its task and give its region back to the heap
+ *         if it came from there. Must be called by the owning task.
+ */
+void task_arena_destroy(task_arena_t *arena)
+{
+    task_arena_t **link;
+
+    configASSERT(arena->owner == xTaskGetCurrentTaskHandle());
+
+    vTaskSetThreadLocalStoragePointer(NULL, TASK_ARENA_TLS_INDEX, NULL);
+
+    taskENTER_CRITICAL();
+    for (link = &s_arenas; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == arena)
+        {
+            *link = arena->next;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (arena->heap_owned)
+    {
+        vPortFree(arena->base);
+    }
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief  Unlink the arenas of a task being deleted, which may not have called
+ *         task_arena_destroy(); their descriptors may be on its stack. Called
+ *         by traceTASK_DELETE (FreeRTOSConfig.h) inside the kernel's critical
+ *         section, so it only relinks lists: a heap region is queued and freed
+ *         by the next task_arena_create() or task_arena_report().
+ */
+void task_arena_task_deleted(void *task)
+{
+    task_arena_t **link = &s_arenas;
+    task_arena_t *arena;
+
+    while ((arena = *link) != NULL)
+    {
+        if (arena->owner != (TaskHandle_t)task)
+        {
+            link = &arena->next;
+            continue;
+        }
+
+        *link = arena->next;
+        if (arena->heap_owned && (arena->size >= sizeof(void *)))
+        {
+            *(void **)arena->base = s_orphans;
+            s_orphans = arena->base;
+        }
+    }
+}
+
+/**
+ * @brief  Allocate size bytes, aligned to portBYTE_ALIGNMENT. Only the owning
+ *         task may call this, so no locking is needed.
+ * @retval Pointer to the memory, or NULL if the arena is missing or full.
+ */
+void *task_arena_alloc_from(task_arena_t *arena, size_t size)
+{
+    void *p;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    size = (size + portBYTE_ALIGNMENT_MASK) & ~((size_t)portBYTE_ALIGNMENT_MASK);
+
+    if ((size == 0) || (size > arena->size - arena->used))
+    {
+        arena->fails++;
+        return NULL;
+    }
+
+    p = arena->base + arena->used;
+    arena->used += size;
+    arena->allocs++;
+
+    if (arena->used > arena->peak)
+    {
+        arena->peak = arena->used;
+    }
+
+    return p;
+}
+
+/**
+ * @brief  Release everything allocated from the arena since the last reset.
+ *         Call at the end of the owning task's work cycle.
+ */
+void task_arena_reset(task_arena_t *arena)
+{
+    if (arena != NULL)
+    {
+        arena->used = 0;
+        arena->resets++;
+    }
+}
+
+/**
+ * @brief  Log the usage of every arena with its task's run time, the time
+ *         the task spent in the cycles the arena served.
+ */
+void task_arena_report(void)
+{
+    task_arena_t *arena;
+    task_arena_t snap;
+    TaskStatus_t status;
+    uint32_t i, n;
+
+    task_arena_reclaim();
+
+    /* Copy one entry at a time with the scheduler suspended, so no owner is
+     * deleted or freed while it is read and logging (which may block on the
+     * output) never runs with the list locked. */
+    for (i = 0; ; i++)
+    {
+        vTaskSuspendAll();
+        for (arena = s_arenas, n = 0; (arena != NULL) && (n < i); arena = arena->next, n++)
+        {
+        }
+        if (arena != NULL)
+        {
+            snap = *arena;
+            vTaskGetInfo(snap.owner, &status, pdFALSE, eInvalid);
+        }
+        (void)xTaskResumeAll();
+
+        if (arena == NULL)
+        {
+            break;
+        }
+
+        if (i == 0)
+        {
+            log_i("%-16s %10s %8s %8s %8s %8s %6s %8s", "task", "run_time",
+                  "used", "peak", "size", "allocs", "fails", "cycles");
+        }
+        log_i("%-16s %10lu %8lu %8lu %8lu %8lu %6lu %8lu", status.pcTaskName,
+#if (configGENERATE_RUN_TIME_STATS == 1)
+              (unsigned long)status.ulRunTimeCounter,
+#else
+              0UL,
+#endif
+              (unsigned long)snap.used, (unsigned long)snap.peak,
+              (unsigned long)snap.size, (unsigned long)snap.allocs,
+              (unsigned long)snap.fails, (unsigned long)snap.resets);
+    }
+}
@@ -0,0 +1,145 @@
+/**
+  ******************************************************************************
+  * @file    timestamp.c
+  * @brief   64-bit timestamps from TIM5, or from clock_gettime() on the host.
+  ******************************************************************************
+  */
+#include "timestamp.h"
+
+#ifdef TIMESTAMP_HOST
+
+#include <time.h>
+
+void timestamp_init(void)
+{
+}
+
+uint32_t timestamp_hz(void)
+{
+    return 1000000000U;
+}
+
+uint64_t timestamp_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+#else
+
+#include "tim.h"
+
+static volatile uint32_t s_hi;          /* TIM5 wraps since timestamp_init() */
+static uint32_t s_hz;
+static uint32_t s_per_us;               /* Counts per microsecond */
+
+/**
+ * @brief  Start TIM5 counting. Call once after MX_TIM5_Init(), before the
+ *         first timestamp is taken.
+ */
+void timestamp_init(void)
+{
+    /* APB1 timers run at twice PCLK1 whenever APB1 is divided. */
+    s_hz = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+    {
+        s_hz *= 2U;
+    }
+    s_per_us = s_hz / 1000000U;
+
+    s_hi = 0;
+    __HAL_TIM_SET_COUNTER(&htim5, 0);
+    __HAL_TIM_CLEAR_FLAG(&htim5, TIM_FLAG_UPDATE);
+    (void)HAL_TIM_Base_Start_IT(&htim5);
+}
+
+/**
+ * @brief  Count one wrap of TIM5. Called from its update interrupt, which has
+ *         the highest priority so that no reader can run between the HAL
+ *         clearing the update flag and this increment.
+ */
+void timestamp_overflow_isr(void)
+{
+    s_hi++;
+}
+
+uint32_t timestamp_hz(void)
+{
+    return s_hz;
+}
+
+/**
+ * @brief  Current count, 64 bits. If TIM5 has wrapped but its interrupt has
+ *         not run yet, because the caller masks it or outranks it, the
+ *         pending update flag accounts for the wrap.
+ */
+uint64_t timestamp_now(void)
+{
+    uint32_t hi, lo, sr;
+
+    do
+    {
+        hi = s_hi;
+        lo = TIM5->CNT;
+        sr = TIM5->SR;
+    } while (hi != s_hi);
+
+    /* A flag seen with a high count was raised after the count was read. */
+    if (((sr & TIM_SR_UIF) != 0U) && (lo < 0x80000000U))
+    {
+        hi++;
+    }
+
+    return ((uint64_t)hi << 32) | lo;
+}
+
+#endif /* TIMESTAMP_HOST */
+
+/**
+ * @brief  Low 32 bits of the count, for intervals shorter than one wrap
+ *         (42 s on the target). One register read.
+ */
+uint32_t timestamp_now32(void)
+{
+#ifdef TIMESTAMP_HOST
+    return (uint32_t)timestamp_now();
+#else
+    return TIM5->CNT;
+#endif
+}
+
+uint64_t timestamp_to_ns(uint64_t ticks)
+{
+    uint32_t hz = timestamp_hz();
+
+    if (hz == 0U)
+    {
+        return 0;
+    }
+
+    /* Split so that the multiply cannot overflow. */
+    return (ticks / hz) * 1000000000U + (ticks % hz) * 1000000000U / hz;
+}
+
+/**
+ * @brief  Microseconds since timestamp_init(), 0 before it.
+ */
+uint64_t timestamp_us(void)
+{
+#ifdef TIMESTAMP_HOST
+    return timestamp_now() / 1000U;
+#else
+    return (s_per_us != 0U) ? timestamp_now() / s_per_us : 0U;
+#endif
+}
+
+/**
+ * @brief  Microseconds, wrapping every 71 minutes. Run time stats counter.
+ */
+uint32_t timestamp_us32(void)
+{
+    return (uint32_t)timestamp_us();
+}
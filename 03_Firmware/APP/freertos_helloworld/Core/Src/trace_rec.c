@@ -0,0 +1,204 @@
+/**
+  ******************************************************************************
+  * @file    trace_rec.c
+  * @brief   Kernel trace recorder writing binary records to an RTT up-buffer.
+  ******************************************************************************
+  */
+#include <string.h>
+#include "trace_rec.h"
+#include "timestamp.h"
+#include "main.h"
+#include "FreeRTOS.h"
+#include "SEGGER_RTT.h"
+
+#if TRACE_REC_ENABLE
+
+#if (configUSE_TRACE_FACILITY != 1)
+#error "The trace recorder reads task and queue numbers: set configUSE_TRACE_FACILITY to 1"
+#endif
+
+#define TRACE_REC_NAME_LEN      16
+
+typedef struct
+{
+    uint32_t ts;
+    uint8_t type;
+    uint8_t a8;
+    uint16_t a16;
+    uint32_t word[2];                   /* Present in 16 byte records only */
+} trace_rec_t;
+
+typedef struct
+{
+    uint32_t ts;
+    uint8_t type;
+    uint8_t a8;
+    uint16_t a16;
+    char name[TRACE_REC_NAME_LEN];
+} trace_rec_name_t;
+
+static uint8_t s_buffer[TRACE_REC_BUFFER_SIZE];
+static uint8_t s_ready;                 /* The RTT channel is set up */
+static volatile uint8_t s_enabled;
+static uint32_t s_lost;                 /* Records lost since the last LOST record */
+static uint32_t s_lost_total;
+static uint32_t s_queue_number;
+
+/* Timestamp and write one record of len bytes with interrupts masked, so that
+ * records are in timestamp order in the stream. The time masked is at most
+ * two copies into the RTT buffer: the 8 byte LOST record, when records were
+ * dropped since the last one written, then the record itself, of at most 24
+ * bytes. The record is only copied if the LOST record fitted. */
+static void trace_rec_put(void *rec, unsigned len)
+{
+    trace_rec_t lost;
+    UBaseType_t mask;
+
+    if (!s_ready)
+    {
+        return;
+    }
+
+    mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    if (s_lost != 0)
+    {
+        lost.ts = timestamp_now32();
+        lost.type = TRACE_REC_LOST;
+        lost.a8 = 0;
+        lost.a16 = (uint16_t)((s_lost > 0xFFFFU) ? 0xFFFFU : s_lost);
+        if (SEGGER_RTT_WriteSkipNoLock(TRACE_REC_CHANNEL, &lost, 8) != 0)
+        {
+            s_lost = 0;
+        }
+    }
+
+    ((trace_rec_t *)rec)->ts = timestamp_now32();
+    if ((s_lost != 0) || (SEGGER_RTT_WriteSkipNoLock(TRACE_REC_CHANNEL, rec, len) == 0))
+    {
+        s_lost++;
+        s_lost_total++;
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+static void trace_rec_sync(void)
+{
+    trace_rec_t rec;
+
+    rec.type = TRACE_REC_SYNC;
+    rec.a8 = 0;
+    rec.a16 = 0;
+    rec.word[0] = (uint32_t)(timestamp_now() >> 32);
+    rec.word[1] = timestamp_hz();
+    trace_rec_put(&rec, 16);
+}
+
+/**
+ * @brief  Set up the RTT channel and start recording. Call after
+ *         timestamp_init() and before any task or queue is created.
+ */
+void trace_rec_init(void)
+{
+    SEGGER_RTT_ConfigUpBuffer(TRACE_REC_CHANNEL, "Trace", s_buffer, sizeof(s_buffer),
+                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    s_ready = 1;
+    trace_rec_start();
+}
+
+void trace_rec_start(void)
+{
+    s_enabled = 1;
+    trace_rec_sync();
+}
+
+void trace_rec_stop(void)
+{
+    s_enabled = 0;
+}
+
+/**
+ * @brief  Records lost because the RTT buffer was full, since start up.
+ */
+uint32_t trace_rec_lost(void)
+{
+    return s_lost_total;
+}
+
+void trace_rec_event(uint8_t type, uint8_t a8, uint32_t a16)
+{
+    trace_rec_t rec;
+
+    if (!s_enabled)
+    {
+        return;
+    }
+
+    rec.type = type;
+    rec.a8 = a8;
+    rec.a16 = (uint16_t)a16;
+    trace_rec_put(&rec, 8);
+}
+
+/* Recorded while stopped too, so that the host always knows the task's name. */
+void trace_rec_task_create(uint32_t task, uint32_t priority, const char *name)
+{
+    trace_rec_name_t rec;
+
+    rec.type = TRACE_REC_TASK_CREATE;
+    rec.a8 = (uint8_t)priority;
+    rec.a16 = (uint16_t)task;
+    strncpy(rec.name, name, sizeof(rec.name));
+    trace_rec_put(&rec, sizeof(rec));
+}
+
+/* Numbers queues in creation order; called with the queue not yet shared. */
+uint32_t trace_rec_queue_create(uint8_t type)
+{
+    trace_rec_t rec;
+    UBaseType_t mask;
+
+    mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    rec.a16 = (uint16_t)++s_queue_number;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+    /* Recorded while stopped too, like task names. */
+    rec.type = TRACE_REC_QUEUE_CREATE;
+    rec.a8 = type;
+    trace_rec_put(&rec, 8);
+
+    return rec.a16;
+}
+
+void trace_rec_heap(uint8_t type, const void *address, uint32_t size)
+{
+    trace_rec_t rec;
+
+    if (!s_enabled)
+    {
+        return;
+    }
+
+    rec.type = type;
+    rec.a8 = 0;
+    rec.a16 = 0;
+    rec.word[0] = (uint32_t)(uintptr_t)address;
+    rec.word[1] = size;
+    trace_rec_put(&rec, 16);
+}
+
+void trace_rec_tick(uint32_t tick)
+{
+    if (s_enabled && ((tick % TRACE_REC_SYNC_TICKS) == 0U))
+    {
+        trace_rec_sync();
+    }
+}
+
+void trace_rec_isr(uint8_t type)
+{
+    trace_rec_event(type, 0, __get_IPSR());
+}
+
+#endif /* TRACE_REC_ENABLE */
@@ -0,0 +1,486 @@
+/**
+  ******************************************************************************
+  * @file    uart_dma.c
+  * @brief   DMA transport on USART1: circular receive into a stream buffer and
+  *          double buffered transmit.
+  ******************************************************************************
+  */
+#include <string.h>
+#include "uart_dma.h"
+#include "usart.h"
+#include "task.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+
+#define UART_DMA_RX_CHUNK       64      /* Bytes fed to the frame decoder per pass */
+#define UART_DMA_FRAME_STEP     32      /* Payload bytes escaped per step */
+#define UART_DMA_TX_MAX         0xFFFFU /* Longest transfer NDTR can count */
+
+#define UART_DMA_TX_HALF        1
+#define UART_DMA_TX_SOURCE      2
+
+static uint8_t s_rx_dma[UART_DMA_RX_DMA_SIZE];
+static uint16_t s_rx_pos;               /* Next byte of s_rx_dma to hand over */
+static StreamBufferHandle_t s_rx_sbuf;
+
+/* Read but not yet decoded by uart_dma_read_frame(). */
+static uint8_t s_rx_chunk[UART_DMA_RX_CHUNK];
+static size_t s_rx_chunk_pos;
+static size_t s_rx_chunk_len;
+
+static uint8_t s_tx_buf[2][UART_DMA_TX_BUFFER_SIZE];
+static volatile uint16_t s_tx_len[2];
+static volatile uint8_t s_tx_fill;      /* Half that writers append to */
+static volatile uint8_t s_tx_busy;      /* UART_DMA_TX_HALF or UART_DMA_TX_SOURCE while sending */
+static volatile uint8_t s_tx_writing;   /* A writer is copying into the fill half */
+static const uart_dma_source_t *s_tx_source;
+static uint16_t s_tx_source_len;        /* Length of the source chunk being sent */
+static SemaphoreHandle_t s_tx_lock;
+static SemaphoreHandle_t s_tx_done;
+
+static uart_dma_stats_t s_stats;
+static uint8_t s_started;
+
+static void uart_dma_rx_start(void)
+{
+    s_rx_pos = 0;
+    if (HAL_UARTEx_ReceiveToIdle_DMA(&huart1, s_rx_dma, sizeof(s_rx_dma)) != HAL_OK)
+    {
+        s_stats.errors++;
+    }
+}
+
+static void uart_dma_rx_push(uint16_t from, uint16_t to, BaseType_t *woken)
+{
+    size_t sent;
+
+    sent = xStreamBufferSendFromISR(s_rx_sbuf, &s_rx_dma[from], to - from, woken);
+    s_stats.rx_bytes += sent;
+    s_stats.rx_dropped += (to - from) - sent;
+}
+
+/* Start sending the fill half, or else the next chunk of the source, unless
+ * DMA is busy or a writer is still copying into the fill half. Called with the
+ * UART and DMA interrupts masked. */
+static void uart_dma_tx_start(void)
+{
+    uint8_t half = s_tx_fill;
+    const uint8_t *chunk;
+    size_t len;
+
+    if (s_tx_busy)
+    {
+        return;
+    }
+
+    if (!s_tx_writing && (s_tx_len[half] != 0))
+    {
+        if (HAL_UART_Transmit_DMA(&huart1, s_tx_buf[half], s_tx_len[half]) != HAL_OK)
+        {
+            s_stats.errors++;
+            return;
+        }
+        s_tx_busy = UART_DMA_TX_HALF;
+        s_tx_fill = half ^ 1;
+    }
+    else if ((s_tx_source != NULL) && ((len = s_tx_source->claim(&chunk, UART_DMA_TX_MAX)) != 0))
+    {
+        if (HAL_UART_Transmit_DMA(&huart1, chunk, (uint16_t)len) != HAL_OK)
+        {
+            s_stats.errors++;
+            s_tx_source->release(0);
+            return;
+        }
+        s_tx_busy = UART_DMA_TX_SOURCE;
+        s_tx_source_len = (uint16_t)len;
+    }
+    else
+    {
+        return;
+    }
+
+    s_stats.tx_transfers++;
+}
+
+/* The transfer in progress is over; send what was gathered meanwhile. Called
+ * from the UART interrupt. */
+static void uart_dma_tx_done(BaseType_t *woken)
+{
+    uint8_t half = s_tx_fill ^ 1;
+
+    if (s_tx_busy == UART_DMA_TX_SOURCE)
+    {
+        s_stats.tx_bytes += s_tx_source_len;
+        s_tx_source->release(s_tx_source_len);
+        s_tx_source_len = 0;
+    }
+    else
+    {
+        s_stats.tx_bytes += s_tx_len[half];
+        s_tx_len[half] = 0;
+    }
+    s_tx_busy = 0;
+    uart_dma_tx_start();
+
+    xSemaphoreGiveFromISR(s_tx_done, woken);
+}
+
+/* A source with data never waits while DMA is idle: it is asked for its next
+ * chunk at the end of every transfer and whenever it is kicked. */
+static int uart_dma_tx_pending(void)
+{
+    return s_tx_busy || (s_tx_len[s_tx_fill] != 0);
+}
+
+/* Append len bytes, waiting for DMA to free a half while both are full. The
+ * caller holds s_tx_lock. */
+static size_t uart_dma_tx_put(const uint8_t *src, size_t len, TimeOut_t *timeout_state, TickType_t *timeout)
+{
+    size_t done = 0, n;
+    uint16_t at;
+    uint8_t half;
+
+    while (done < len)
+    {
+        taskENTER_CRITICAL();
+        half = s_tx_fill;
+        at = s_tx_len[half];
+        n = UART_DMA_TX_BUFFER_SIZE - at;
+        if (n > len - done)
+        {
+            n = len - done;
+        }
+        s_tx_len[half] = at + n;
+        s_tx_writing = (n != 0);
+        taskEXIT_CRITICAL();
+
+        if (n != 0)
+        {
+            /* The halves are not swapped while s_tx_writing is set. */
+            memcpy(&s_tx_buf[half][at], &src[done], n);
+            done += n;
+
+            taskENTER_CRITICAL();
+            s_tx_writing = 0;
+            uart_dma_tx_start();
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            if (xTaskCheckForTimeOut(timeout_state, timeout) != pdFALSE)
+            {
+                break;
+            }
+            xSemaphoreTake(s_tx_done, *timeout);
+        }
+    }
+
+    return done;
+}
+
+/**
+ * @brief  Start the transport, or restart it at another baud rate. Call from
+ *         a task; pending transmit data is sent first.
+ * @param  baudrate: Up to PCLK2 / 8 (12.5 Mbaud at 100 MHz), or 0 to keep the
+ *         rate set by MX_USART1_UART_Init().
+ * @retval 0 on success, -1 if the objects or the UART could not be set up.
+ */
+int uart_dma_init(uint32_t baudrate)
+{
+    if (s_rx_sbuf == NULL)
+    {
+        s_rx_sbuf = xStreamBufferCreate(UART_DMA_RX_BUFFER_SIZE, 1);
+        s_tx_lock = xSemaphoreCreateMutex();
+        s_tx_done = xSemaphoreCreateBinary();
+        if ((s_rx_sbuf == NULL) || (s_tx_lock == NULL) || (s_tx_done == NULL))
+        {
+            return -1;
+        }
+    }
+
+    if (s_started)
+    {
+        (void)uart_dma_flush(portMAX_DELAY);
+        HAL_UART_Abort(&huart1);
+        s_started = 0;
+
+        /* A source chunk claimed since the flush is sent again from its start. */
+        taskENTER_CRITICAL();
+        if (s_tx_busy == UART_DMA_TX_SOURCE)
+        {
+            s_tx_source->release(0);
+            s_tx_busy = 0;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    if (baudrate != 0)
+    {
+        /* Oversampling by 8 doubles the highest rate at a small cost in
+         * receiver noise margin; use it only above what 16 reaches. */
+        huart1.Init.BaudRate = baudrate;
+        huart1.Init.OverSampling = (baudrate > HAL_RCC_GetPCLK2Freq() / 16U) ?
+                                   UART_OVERSAMPLING_8 : UART_OVERSAMPLING_16;
+        if (HAL_UART_Init(&huart1) != HAL_OK)
+        {
+            return -1;
+        }
+    }
+
+    (void)xStreamBufferReset(s_rx_sbuf);
+    s_rx_chunk_pos = 0;
+    s_rx_chunk_len = 0;
+
+    taskENTER_CRITICAL();
+    uart_dma_rx_start();
+    uart_dma_tx_start();
+    taskEXIT_CRITICAL();
+    s_started = 1;
+
+    return 0;
+}
+
+/**
+ * @brief  Queue len bytes for transmission.
+ * @retval Bytes queued, less than len if timeout expired first.
+ */
+size_t uart_dma_write(const void *data, size_t len, TickType_t timeout)
+{
+    TimeOut_t timeout_state;
+    size_t done;
+
+    vTaskSetTimeOutState(&timeout_state);
+    if (xSemaphoreTake(s_tx_lock, timeout) != pdTRUE)
+    {
+        return 0;
+    }
+    done = uart_dma_tx_put((const uint8_t *)data, len, &timeout_state, &timeout);
+    xSemaphoreGive(s_tx_lock);
+
+    return done;
+}
+
+/**
+ * @brief  Queue one SLIP frame carrying len payload bytes. Frames from
+ *         different tasks are never interleaved.
+ * @retval 0 on success, -1 if timeout expired first. A frame cut short is
+ *         terminated with an invalid escape so the receiver drops it.
+ */
+int uart_dma_write_frame(const void *payload, size_t len, TickType_t timeout)
+{
+    static const uint8_t end = UART_FRAME_END;
+    static const uint8_t abort_frame[2] = {UART_FRAME_ESC, UART_FRAME_END};
+    const uint8_t *src = (const uint8_t *)payload;
+    uint8_t step[2 * UART_DMA_FRAME_STEP];
+    TimeOut_t timeout_state;
+    TickType_t forever = portMAX_DELAY;
+    size_t i, n, m;
+    int ok;
+
+    vTaskSetTimeOutState(&timeout_state);
+    if (xSemaphoreTake(s_tx_lock, timeout) != pdTRUE)
+    {
+        return -1;
+    }
+
+    ok = (uart_dma_tx_put(&end, 1, &timeout_state, &timeout) == 1);
+    if (ok)
+    {
+        for (i = 0; ok && (i < len); i += n)
+        {
+            n = (len - i < UART_DMA_FRAME_STEP) ? (len - i) : UART_DMA_FRAME_STEP;
+            m = uart_frame_escape(step, &src[i], n);
+            ok = (uart_dma_tx_put(step, m, &timeout_state, &timeout) == m);
+        }
+        ok = ok && (uart_dma_tx_put(&end, 1, &timeout_state, &timeout) == 1);
+
+        if (!ok)
+        {
+            /* Bounded by the time DMA takes to free a half. */
+            (void)uart_dma_tx_put(abort_frame, sizeof(abort_frame), &timeout_state, &forever);
+        }
+    }
+
+    xSemaphoreGive(s_tx_lock);
+
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief  Wait until everything queued has left the UART.
+ * @retval 0 on success, -1 if timeout expired first.
+ */
+int uart_dma_flush(TickType_t timeout)
+{
+    TimeOut_t timeout_state;
+    int ret = 0;
+
+    vTaskSetTimeOutState(&timeout_state);
+    if (xSemaphoreTake(s_tx_lock, timeout) != pdTRUE)
+    {
+        return -1;
+    }
+
+    while (uart_dma_tx_pending())
+    {
+        if (xTaskCheckForTimeOut(&timeout_state, &timeout) != pdFALSE)
+        {
+            ret = -1;
+            break;
+        }
+        xSemaphoreTake(s_tx_done, timeout);
+    }
+
+    xSemaphoreGive(s_tx_lock);
+
+    return ret;
+}
+
+/**
+ * @brief  Attach a source that DMA sends from in place whenever the transmit
+ *         halves are empty, or detach it with NULL.
+ */
+void uart_dma_set_source(const uart_dma_source_t *source)
+{
+    taskENTER_CRITICAL();
+    s_tx_source = source;
+    uart_dma_tx_start();
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Tell the transport that the source has new data. A no-op while DMA
+ *         is busy: the source is asked again when the transfer ends.
+ */
+void uart_dma_kick(void)
+{
+    taskENTER_CRITICAL();
+    uart_dma_tx_start();
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Read up to len received bytes, waiting up to timeout for the first.
+ * @retval Bytes read.
+ */
+size_t uart_dma_read(void *buf, size_t len, TickType_t timeout)
+{
+    return xStreamBufferReceive(s_rx_sbuf, buf, len, timeout);
+}
+
+/**
+ * @brief  Receive the next SLIP frame into dec->buf.
+ * @retval Payload length, or 0 if no whole frame arrived within timeout. A
+ *         partial frame is kept in dec for the next call.
+ */
+size_t uart_dma_read_frame(uart_frame_decoder_t *dec, TickType_t timeout)
+{
+    TimeOut_t timeout_state;
+    size_t frame_len;
+
+    vTaskSetTimeOutState(&timeout_state);
+
+    for (;;)
+    {
+        if (s_rx_chunk_pos == s_rx_chunk_len)
+        {
+            /* Once timeout expires it reads as 0: keep decoding what is
+             * already buffered, but do not block. */
+            (void)xTaskCheckForTimeOut(&timeout_state, &timeout);
+            s_rx_chunk_pos = 0;
+            s_rx_chunk_len = xStreamBufferReceive(s_rx_sbuf, s_rx_chunk, sizeof(s_rx_chunk), timeout);
+            if (s_rx_chunk_len == 0)
+            {
+                return 0;
+            }
+        }
+
+        s_rx_chunk_pos += uart_frame_feed(dec, &s_rx_chunk[s_rx_chunk_pos],
+                                          s_rx_chunk_len - s_rx_chunk_pos, &frame_len);
+        if (frame_len != 0)
+        {
+            return frame_len;
+        }
+    }
+}
+
+void uart_dma_get_stats(uart_dma_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = s_stats;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Half transfer, transfer complete or idle line on the circular
+ *         receive DMA. Size is the write position in s_rx_dma.
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (huart != &huart1)
+    {
+        return;
+    }
+
+    s_stats.rx_events++;
+
+    if (Size != s_rx_pos)
+    {
+        if (Size > s_rx_pos)
+        {
+            uart_dma_rx_push(s_rx_pos, Size, &woken);
+        }
+        else
+        {
+            uart_dma_rx_push(s_rx_pos, UART_DMA_RX_DMA_SIZE, &woken);
+            uart_dma_rx_push(0, Size, &woken);
+        }
+        s_rx_pos = (Size == UART_DMA_RX_DMA_SIZE) ? 0 : Size;
+    }
+
+    portYIELD_FROM_ISR(woken);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (huart != &huart1)
+    {
+        return;
+    }
+
+    uart_dma_tx_done(&woken);
+
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief  With DMA every UART error is reported after the receive DMA has
+ *         been aborted, so reception is restarted here. A transmit DMA error
+ *         ends the transfer; its data is lost.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (huart != &huart1)
+    {
+        return;
+    }
+
+    s_stats.errors++;
+
+    if (s_started && (huart->RxState == HAL_UART_STATE_READY))
+    {
+        uart_dma_rx_start();
+    }
+    if (s_tx_busy && (huart->gState == HAL_UART_STATE_READY))
+    {
+        uart_dma_tx_done(&woken);
+    }
+
+    portYIELD_FROM_ISR(woken);
+}
@@ -0,0 +1,156 @@
+/**
+  ******************************************************************************
+  * @file    uart_frame.c
+  * @brief   SLIP framing: escaping, frame encoding and stream decoding.
+  ******************************************************************************
+  */
+#include "uart_frame.h"
+
+/**
+ * @brief  Prepare a decoder that collects frames into buf.
+ * @param  size: Size of buf, the longest payload accepted.
+ */
+void uart_frame_decoder_init(uart_frame_decoder_t *dec, void *buf, size_t size)
+{
+    dec->buf = (uint8_t *)buf;
+    dec->size = size;
+    dec->len = 0;
+    dec->escaped = 0;
+    dec->discard = 0;
+    dec->frames = 0;
+    dec->dropped = 0;
+}
+
+/**
+ * @brief  Escape len payload bytes into dst, without delimiters.
+ * @param  dst: Room for 2 * len bytes.
+ * @retval Bytes written to dst.
+ */
+size_t uart_frame_escape(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    size_t i, n = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (src[i] == UART_FRAME_END)
+        {
+            dst[n++] = UART_FRAME_ESC;
+            dst[n++] = UART_FRAME_ESC_END;
+        }
+        else if (src[i] == UART_FRAME_ESC)
+        {
+            dst[n++] = UART_FRAME_ESC;
+            dst[n++] = UART_FRAME_ESC_ESC;
+        }
+        else
+        {
+            dst[n++] = src[i];
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief  Encode a whole frame, delimiters included.
+ * @retval Bytes written to dst, or 0 if size may be too small.
+ */
+size_t uart_frame_encode(uint8_t *dst, size_t size, const uint8_t *src, size_t len)
+{
+    size_t n;
+
+    if (size < UART_FRAME_MAX_ENCODED(len))
+    {
+        return 0;
+    }
+
+    dst[0] = UART_FRAME_END;
+    n = 1 + uart_frame_escape(&dst[1], src, len);
+    dst[n++] = UART_FRAME_END;
+
+    return n;
+}
+
+/**
+ * @brief  Feed received bytes to the decoder, stopping at the end of a frame.
+ * @param  frame_len: Set to the payload length when a frame is complete in
+ *         dec->buf, 0 otherwise. The frame stays valid until the next call.
+ * @retval Bytes of data consumed. Call again with the rest once the frame has
+ *         been handled.
+ */
+size_t uart_frame_feed(uart_frame_decoder_t *dec, const uint8_t *data, size_t len, size_t *frame_len)
+{
+    size_t i;
+    uint8_t c;
+
+    *frame_len = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        c = data[i];
+
+        if (c == UART_FRAME_END)
+        {
+            if (dec->discard)
+            {
+                dec->discard = 0;
+                dec->dropped++;
+            }
+            else if (dec->escaped)
+            {
+                dec->dropped++;
+            }
+            else if (dec->len != 0)
+            {
+                /* Empty frames between back to back delimiters are skipped. */
+                *frame_len = dec->len;
+                dec->frames++;
+            }
+            dec->len = 0;
+            dec->escaped = 0;
+
+            if (*frame_len != 0)
+            {
+                return i + 1;
+            }
+            continue;
+        }
+
+        if (dec->discard)
+        {
+            continue;
+        }
+
+        if (dec->escaped)
+        {
+            dec->escaped = 0;
+            if (c == UART_FRAME_ESC_END)
+            {
+                c = UART_FRAME_END;
+            }
+            else if (c == UART_FRAME_ESC_ESC)
+            {
+                c = UART_FRAME_ESC;
+            }
+            else
+            {
+                dec->discard = 1;
+                continue;
+            }
+        }
+        else if (c == UART_FRAME_ESC)
+        {
+            dec->escaped = 1;
+            continue;
+        }
+
+        if (dec->len == dec->size)
+        {
+            dec->discard = 1;
+            continue;
+        }
+        dec->buf[dec->len++] = c;
+    }
+
+    return len;
+}
@@ -40,6 +40,9 @@
   #include "ARMv8MML_DP.h"
 #elif defined ARMv8MML_DSP_DP
   #include "ARMv8MML_DSP_DP.h"
+#elif defined ARM_MATH_HOST
+  /* Native build (dsp_host): the runner supplies the timer below */
+  #include <stdint.h>
 
 #else
   #warning "no appropriate header file found!"
@@ -57,6 +60,30 @@
  */
 #define JTEST_SYSTICK_INITIAL_VALUE 0xFFFFFF
 
+#if defined ARM_MATH_HOST
+/*--------------------------------------------------------------------------------*/
+/* Host Timer */
+/*--------------------------------------------------------------------------------*/
+
+/* There is no SysTick on a host. The runner's timer counts down from
+ * JTEST_SYSTICK_INITIAL_VALUE in nanoseconds, so "Cycles" are nanoseconds
+ * there. */
+void     jtest_host_timer_start(void);
+uint32_t jtest_host_timer_value(void);
+
+#define JTEST_SYSTICK_RESET(systick_ptr)        \
+    do                                          \
+    {                                           \
+    } while (0)
+
+#define JTEST_SYSTICK_START(systick_ptr)        \
+        jtest_host_timer_start()
+
+#define JTEST_SYSTICK_VALUE(systick_ptr)        \
+        jtest_host_timer_value()
+
+#else
+
 /**
  *  Reset the SysTick, decrementing timer to it's maximum value and disable it.
  *
@@ -89,5 +116,7 @@
  */
 #define JTEST_SYSTICK_VALUE(systick_ptr)        \
     ((systick_ptr)->VAL)
+
+#endif /* ARM_MATH_HOST */
            
 #endif /* _JTEST_SYSTICK_H_ */
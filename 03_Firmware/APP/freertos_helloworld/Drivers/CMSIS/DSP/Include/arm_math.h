@@ -126,6 +126,12 @@
    * and ARM_MATH_CM0 for building library on Cortex-M0 target, ARM_MATH_CM0PLUS for building library on Cortex-M0+ target, and
    * ARM_MATH_CM7 for building the library on cortex-M7.
    *
+   * - ARM_MATH_HOST:
+   *
+   * Define macro ARM_MATH_HOST to build the library for a PC host, for example for offline analysis and CI.
+   * The Cortex-M4 code paths are used, with the DSP instructions emulated in C (arm_math_host.h), so that
+   * fixed-point results match the Cortex-M4 library bit for bit.
+   *
    * - ARM_MATH_ARMV8MxL:
    *
    * Define macro ARM_MATH_ARMV8MBL for building the library on Armv8-M Baseline target, ARM_MATH_ARMV8MML for building library
@@ -337,8 +343,11 @@
   #if (defined (__DSP_PRESENT) && (__DSP_PRESENT == 1))
     #define ARM_MATH_DSP
   #endif
+#elif defined (ARM_MATH_HOST)
+  #include "arm_math_host.h"
+  #define ARM_MATH_DSP
 #else
-  #error "Define according the used Cortex core ARM_MATH_CM7, ARM_MATH_CM4, ARM_MATH_CM3, ARM_MATH_CM0PLUS, ARM_MATH_CM0, ARM_MATH_ARMV8MBL, ARM_MATH_ARMV8MML"
+  #error "Define according the used Cortex core ARM_MATH_CM7, ARM_MATH_CM4, ARM_MATH_CM3, ARM_MATH_CM0PLUS, ARM_MATH_CM0, ARM_MATH_ARMV8MBL, ARM_MATH_ARMV8MML, ARM_MATH_HOST"
 #endif
 
 #undef  __CMSIS_GENERIC         /* enable NVIC and Systick functions */
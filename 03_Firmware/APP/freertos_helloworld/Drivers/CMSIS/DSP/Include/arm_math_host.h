@@ -0,0 +1,204 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS DSP Library
+ * Title:        arm_math_host.h
+ * Description:  Cortex-M4 DSP instructions in portable C, for building the
+ *               library on a PC host with ARM_MATH_HOST
+ *
+ * Target Processor: Any host with a C99 compiler
+ * -------------------------------------------------------------------- */
+/*
+ * With ARM_MATH_HOST the library takes its Cortex-M4 code paths
+ * (ARM_MATH_DSP) and the SIMD instructions below replace the ones that
+ * cmsis_gcc.h would emit. Each one computes what the Armv7E-M instruction
+ * computes, including the wrap-around of the 32-bit multiply-accumulates and
+ * the exact 64-bit sums of SMLALD, so that fixed-point functions give the
+ * same bits as on the target. The emulations arm_math.h defines for the
+ * Cortex-M3 and M0 do not: they sum the two products of __SMLALD in 32 bits.
+ *
+ * Build with -fno-strict-aliasing, as __SIMD32 reads q15_t and q7_t arrays
+ * through int32_t pointers, and without floating-point contraction
+ * (-ffp-contract=off) to keep float results close to the Cortex-M4 FPU.
+ * The Q flag is not modelled; no library function reads it.
+ */
+
+#ifndef _ARM_MATH_HOST_H
+#define _ARM_MATH_HOST_H
+
+#include <stdint.h>
+#include "cmsis_compiler.h"     /* __STATIC_FORCEINLINE, __SSAT, __USAT, __ROR */
+
+/* The instruction gives 32 for 0, where __builtin_clz is undefined */
+#undef  __CLZ
+#define __CLZ(x)              __clz_host(x)
+
+__STATIC_FORCEINLINE uint8_t __clz_host(uint32_t x)
+{
+  return (x == 0U) ? 32U : (uint8_t)__builtin_clz(x);
+}
+
+#define __PKHBT(ARG1, ARG2, ARG3) ( (((uint32_t)(ARG1)          ) & 0x0000FFFFUL) | \
+                                    (((uint32_t)(ARG2) << (ARG3)) & 0xFFFF0000UL)  )
+#define __PKHTB(ARG1, ARG2, ARG3) ( (((uint32_t)(ARG1)                   ) & 0xFFFF0000UL) | \
+                                    (((uint32_t)((int32_t)(ARG2) >> (ARG3))) & 0x0000FFFFUL)  )
+
+/* Signed halfwords and bytes of a packed word */
+#define __HOST_LO16(x)        ((int32_t)(int16_t)(uint16_t)(x))
+#define __HOST_HI16(x)        ((int32_t)(int16_t)(uint16_t)((uint32_t)(x) >> 16))
+#define __HOST_B(x, n)        ((int32_t)(int8_t)(uint8_t)((uint32_t)(x) >> (8 * (n))))
+
+__STATIC_FORCEINLINE uint32_t __HOST_PACK16(int32_t lo, int32_t hi)
+{
+  return ((uint32_t)lo & 0x0000FFFFUL) | ((uint32_t)hi << 16);
+}
+
+__STATIC_FORCEINLINE int32_t __HOST_SAT(int64_t x, int32_t min, int32_t max)
+{
+  return (x < min) ? min : ((x > max) ? max : (int32_t)x);
+}
+
+__STATIC_FORCEINLINE uint32_t __QADD8(uint32_t x, uint32_t y)
+{
+  uint32_t r = 0U;
+  int n;
+
+  for (n = 0; n < 4; n++)
+  {
+    r |= ((uint32_t)__HOST_SAT(__HOST_B(x, n) + __HOST_B(y, n), -128, 127) & 0xFFU) << (8 * n);
+  }
+  return r;
+}
+
+__STATIC_FORCEINLINE uint32_t __QSUB8(uint32_t x, uint32_t y)
+{
+  uint32_t r = 0U;
+  int n;
+
+  for (n = 0; n < 4; n++)
+  {
+    r |= ((uint32_t)__HOST_SAT(__HOST_B(x, n) - __HOST_B(y, n), -128, 127) & 0xFFU) << (8 * n);
+  }
+  return r;
+}
+
+__STATIC_FORCEINLINE uint32_t __QADD16(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16(__HOST_SAT(__HOST_LO16(x) + __HOST_LO16(y), -32768, 32767),
+                       __HOST_SAT(__HOST_HI16(x) + __HOST_HI16(y), -32768, 32767));
+}
+
+__STATIC_FORCEINLINE uint32_t __QSUB16(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16(__HOST_SAT(__HOST_LO16(x) - __HOST_LO16(y), -32768, 32767),
+                       __HOST_SAT(__HOST_HI16(x) - __HOST_HI16(y), -32768, 32767));
+}
+
+__STATIC_FORCEINLINE uint32_t __SHADD16(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16((__HOST_LO16(x) + __HOST_LO16(y)) >> 1,
+                       (__HOST_HI16(x) + __HOST_HI16(y)) >> 1);
+}
+
+__STATIC_FORCEINLINE uint32_t __SHSUB16(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16((__HOST_LO16(x) - __HOST_LO16(y)) >> 1,
+                       (__HOST_HI16(x) - __HOST_HI16(y)) >> 1);
+}
+
+__STATIC_FORCEINLINE uint32_t __QASX(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16(__HOST_SAT(__HOST_LO16(x) - __HOST_HI16(y), -32768, 32767),
+                       __HOST_SAT(__HOST_HI16(x) + __HOST_LO16(y), -32768, 32767));
+}
+
+__STATIC_FORCEINLINE uint32_t __SHASX(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16((__HOST_LO16(x) - __HOST_HI16(y)) >> 1,
+                       (__HOST_HI16(x) + __HOST_LO16(y)) >> 1);
+}
+
+__STATIC_FORCEINLINE uint32_t __QSAX(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16(__HOST_SAT(__HOST_LO16(x) + __HOST_HI16(y), -32768, 32767),
+                       __HOST_SAT(__HOST_HI16(x) - __HOST_LO16(y), -32768, 32767));
+}
+
+__STATIC_FORCEINLINE uint32_t __SHSAX(uint32_t x, uint32_t y)
+{
+  return __HOST_PACK16((__HOST_LO16(x) + __HOST_HI16(y)) >> 1,
+                       (__HOST_HI16(x) - __HOST_LO16(y)) >> 1);
+}
+
+__STATIC_FORCEINLINE int32_t __QADD(int32_t x, int32_t y)
+{
+  return __HOST_SAT((int64_t)x + y, INT32_MIN, INT32_MAX);
+}
+
+__STATIC_FORCEINLINE int32_t __QSUB(int32_t x, int32_t y)
+{
+  return __HOST_SAT((int64_t)x - y, INT32_MIN, INT32_MAX);
+}
+
+/* Dual 16 x 16 multiplies. The 32-bit results wrap as on the target. */
+__STATIC_FORCEINLINE uint32_t __SMUAD(uint32_t x, uint32_t y)
+{
+  return (uint32_t)((int64_t)(__HOST_LO16(x) * __HOST_LO16(y)) + (__HOST_HI16(x) * __HOST_HI16(y)));
+}
+
+__STATIC_FORCEINLINE uint32_t __SMUADX(uint32_t x, uint32_t y)
+{
+  return (uint32_t)((int64_t)(__HOST_LO16(x) * __HOST_HI16(y)) + (__HOST_HI16(x) * __HOST_LO16(y)));
+}
+
+__STATIC_FORCEINLINE uint32_t __SMUSD(uint32_t x, uint32_t y)
+{
+  return (uint32_t)((int64_t)(__HOST_LO16(x) * __HOST_LO16(y)) - (__HOST_HI16(x) * __HOST_HI16(y)));
+}
+
+__STATIC_FORCEINLINE uint32_t __SMUSDX(uint32_t x, uint32_t y)
+{
+  return (uint32_t)((int64_t)(__HOST_LO16(x) * __HOST_HI16(y)) - (__HOST_HI16(x) * __HOST_LO16(y)));
+}
+
+__STATIC_FORCEINLINE uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t sum)
+{
+  return __SMUAD(x, y) + sum;
+}
+
+__STATIC_FORCEINLINE uint32_t __SMLADX(uint32_t x, uint32_t y, uint32_t sum)
+{
+  return __SMUADX(x, y) + sum;
+}
+
+__STATIC_FORCEINLINE uint32_t __SMLSD(uint32_t x, uint32_t y, uint32_t sum)
+{
+  return __SMUSD(x, y) + sum;
+}
+
+__STATIC_FORCEINLINE uint32_t __SMLSDX(uint32_t x, uint32_t y, uint32_t sum)
+{
+  return __SMUSDX(x, y) + sum;
+}
+
+/* 64-bit accumulation of both products, without an intermediate 32-bit sum */
+__STATIC_FORCEINLINE uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t sum)
+{
+  return sum + (uint64_t)((int64_t)(__HOST_LO16(x) * __HOST_LO16(y)) + (__HOST_HI16(x) * __HOST_HI16(y)));
+}
+
+__STATIC_FORCEINLINE uint64_t __SMLALDX(uint32_t x, uint32_t y, uint64_t sum)
+{
+  return sum + (uint64_t)((int64_t)(__HOST_LO16(x) * __HOST_HI16(y)) + (__HOST_HI16(x) * __HOST_LO16(y)));
+}
+
+__STATIC_FORCEINLINE uint32_t __SXTB16(uint32_t x)
+{
+  return __HOST_PACK16(__HOST_B(x, 0), __HOST_B(x, 2));
+}
+
+/* Most significant word of x * y, truncated, plus sum */
+__STATIC_FORCEINLINE int32_t __SMMLA(int32_t x, int32_t y, int32_t sum)
+{
+  return (int32_t)((uint32_t)sum + (uint32_t)(((int64_t)x * y) >> 32));
+}
+
+#endif /* _ARM_MATH_HOST_H */
@@ -79,5 +79,8 @@
 // #define ELOG_BUF_OUTPUT_ENABLE
 /* buffer size for buffered output mode */
 #define ELOG_BUF_OUTPUT_BUF_SIZE                 (ELOG_LINE_BUF_SIZE * 10)
+/*---------------------------------------------------------------------------*/
+/* pass each log line's level to elog_port_output_lvl() in sync output mode */
+#define ELOG_PORT_OUTPUT_LVL_ENABLE
 
 #endif /* _ELOG_CFG_H_ */
@@ -29,6 +29,8 @@
 #include <elog.h>
 #include <stdio.h>
 #include "SEGGER_RTT.h"
+#include "log_uart.h"
+#include "timestamp.h"
 #include "main.h"
 #include "cmsis_os.h"
 //#include "tim.h"
@@ -43,7 +45,12 @@ ElogErrCode elog_port_init(void)
     ElogErrCode result = ELOG_NO_ERR;
 
     /* add your code here */
+#if LOG_UART_ENABLE
+    /* lines are discarded if the UART can't be started */
+    (void)log_uart_init(LOG_UART_BAUD);
+#else
     SEGGER_RTT_Init();
+#endif
 
     return result;
 }
@@ -69,7 +76,29 @@ void elog_port_output(const char *log, size_t size)
 
     /* add your code here */
     // SEGGER_RTT_Write(0, log, size);
+#if LOG_UART_ENABLE
+    /* raw and hexdump output carry no level */
+    log_uart_write(ELOG_LVL_INFO, log, size);
+#else
     printf("%.*s", size, log);
+#endif
+}
+
+/**
+ * output log port interface with the line's level
+ *
+ * @param level level of log
+ * @param log output of log
+ * @param size log size
+ */
+void elog_port_output_lvl(uint8_t level, const char *log, size_t size)
+{
+#if LOG_UART_ENABLE
+    log_uart_write(level, log, size);
+#else
+    (void)level;
+    printf("%.*s", (int)size, log);
+#endif
 }
 
 /**
@@ -98,21 +127,13 @@ void elog_port_output_unlock(void)
 const char *elog_port_get_time(void)
 {
     /* add your code here */
-    static char cur_system_time[16] = {0};
-
-    #if (INCLUDE_xTaskGetSchedulerState == 1)
-    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) 
-    {
-    #endif
-        TickType_t tick = xTaskGetTickCount();
-        snprintf(cur_system_time, sizeof(cur_system_time), "%lu.%03lu",
-                 tick / configTICK_RATE_HZ,
-                 (tick % configTICK_RATE_HZ) * 1000 / configTICK_RATE_HZ);
-        return cur_system_time;
-    #if (INCLUDE_xTaskGetSchedulerState == 1)
-    }
-    #endif
-    return "";
+    static char cur_system_time[24] = {0};
+    /* microseconds from the timestamp service, valid before the scheduler runs */
+    uint64_t us = timestamp_us();
+
+    snprintf(cur_system_time, sizeof(cur_system_time), "%lu.%06lu",
+             (unsigned long)(us / 1000000U), (unsigned long)(us % 1000000U));
+    return cur_system_time;
 }
 
 /**
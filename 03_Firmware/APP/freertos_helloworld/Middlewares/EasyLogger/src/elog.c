@@ -717,6 +717,9 @@ void elog_output(uint8_t level, const char *tag, const char *file, const char *f
 #elif defined(ELOG_BUF_OUTPUT_ENABLE)
     extern void elog_buf_output(const char *log, size_t size);
     elog_buf_output(log_buf, log_len);
+#elif defined(ELOG_PORT_OUTPUT_LVL_ENABLE)
+    extern void elog_port_output_lvl(uint8_t level, const char *log, size_t size);
+    elog_port_output_lvl(level, log_buf, log_len);
 #else
     elog_port_output(log_buf, log_len);
 #endif
@@ -31,7 +31,12 @@
 #include "semphr.h"                     // ARM.FreeRTOS::RTOS:Core
 
 #include "freertos_mpool.h"             // osMemoryPool definitions
+#include "freertos_msgq.h"              // osMessageQueue definitions
 #include "freertos_os2.h"               // Configuration check and setup
+#include "freertos_os2_pool.h"          // Static object pool definitions
+#include "freertos_os2_zcopy.h"         // Zero-copy message passing definitions
+#include "freertos_os2_batch.h"         // Batched wakeup definitions
+#include "freertos_os2_mprof.h"         // Mutex profiling definitions
 
 /*---------------------------------------------------------------------------*/
 #ifndef __ARM_ARCH_6M__
@@ -447,6 +452,11 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
   TaskHandle_t hTask;
   UBaseType_t prio;
   int32_t mem;
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  void *stack_mem;
+  uint32_t stack_sz;
+  #endif
 
   hTask = NULL;
 
@@ -497,7 +507,14 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
     }
     else {
       if (mem == 0) {
-        #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+          cb_mem = osPoolAlloc (OS2_POOL_THREAD, name, stack * sizeof(StackType_t), &stack_mem, &stack_sz);
+
+          if (cb_mem != NULL) {
+            hTask = xTaskCreateStatic ((TaskFunction_t)func, name, stack_sz / sizeof(StackType_t), argument, prio, (StackType_t  *)stack_mem,
+                                                                                                              (StaticTask_t *)cb_mem);
+          }
+        #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
           if (xTaskCreate ((TaskFunction_t)func, name, (uint16_t)stack, argument, prio, &hTask) != pdPASS) {
             hTask = NULL;
           }
@@ -552,6 +569,24 @@ osThreadState_t osThreadGetState (osThreadId_t thread_id) {
   return (state);
 }
 
+uint32_t osThreadGetStackSize (osThreadId_t thread_id) {
+  TaskHandle_t hTask = (TaskHandle_t)thread_id;
+  uint32_t sz;
+
+#if (configRECORD_STACK_HIGH_ADDRESS == 1)
+  if (IS_IRQ() || (hTask == NULL)) {
+    sz = 0U;
+  } else {
+    sz = (uint32_t)(uxTaskGetStackDepth(hTask) * sizeof(StackType_t));
+  }
+#else
+  (void)hTask;
+  sz = 0U;
+#endif
+
+  return (sz);
+}
+
 uint32_t osThreadGetStackSpace (osThreadId_t thread_id) {
   TaskHandle_t hTask = (TaskHandle_t)thread_id;
   uint32_t sz;
@@ -926,6 +961,23 @@ osStatus_t osDelayUntil (uint32_t ticks) {
 /*---------------------------------------------------------------------------*/
 #if (configUSE_OS2_TIMER == 1)
 
+#if (configUSE_OS2_STATIC_POOLS == 1)
+/*
+  Return a deleted timer to its pool, or free the callback of a timer created
+  in caller supplied memory. Runs in the timer daemon task, queued behind the
+  delete command, so the timer is no longer referenced by the kernel.
+*/
+static void TimerPoolRelease (void *callb, uint32_t unused) {
+  (void)unused;
+
+  if (osPoolContains (callb) != 0U) {
+    osPoolRelease (callb);
+  } else {
+    vPortFree (callb);
+  }
+}
+#endif
+
 static void TimerCallback (TimerHandle_t hTimer) {
   TimerCallback_t *callb;
 
@@ -942,12 +994,27 @@ osTimerId_t osTimerNew (osTimerFunc_t func, osTimerType_t type, void *argument,
   TimerCallback_t *callb;
   UBaseType_t reload;
   int32_t mem;
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  uint32_t callb_sz;
+  #endif
 
   hTimer = NULL;
 
   if (!IS_IRQ() && (func != NULL)) {
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    if ((attr != NULL) && (attr->cb_mem != NULL)) {
+      /* Timer memory supplied by the caller, only the callback is allocated */
+      cb_mem = NULL;
+      callb  = pvPortMalloc (sizeof(TimerCallback_t));
+    } else {
+      /* Take timer and callback function and argument storage from the pool */
+      cb_mem = osPoolAlloc (OS2_POOL_TIMER, (attr != NULL) ? attr->name : NULL, sizeof(TimerCallback_t), (void **)&callb, &callb_sz);
+    }
+    #else
     /* Allocate memory to store callback function and argument */
     callb = pvPortMalloc (sizeof(TimerCallback_t));
+    #endif
 
     if (callb != NULL) {
       callb->func = func;
@@ -987,14 +1054,24 @@ osTimerId_t osTimerNew (osTimerFunc_t func, osTimerType_t type, void *argument,
       }
       else {
         if (mem == 0) {
-          #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+          #if (configUSE_OS2_STATIC_POOLS == 1)
+            hTimer = xTimerCreateStatic (name, 1, reload, callb, TimerCallback, (StaticTimer_t *)cb_mem);
+          #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
             hTimer = xTimerCreate (name, 1, reload, callb, TimerCallback);
           #endif
         }
       }
 
       if ((hTimer == NULL) && (callb != NULL)) {
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+        if (cb_mem != NULL) {
+          osPoolRelease (callb);
+        } else {
+          vPortFree (callb);
+        }
+        #else
         vPortFree (callb);
+        #endif
       }
     }
   }
@@ -1026,7 +1103,12 @@ osStatus_t osTimerStart (osTimerId_t timer_id, uint32_t ticks) {
     stat = osErrorParameter;
   }
   else {
+    #if (configUSE_TIMER_WHEEL == 1)
+    /* Arm the timer in the timing wheel directly, bypassing the command queue */
+    if (xTimerArm (hTimer, ticks) == pdPASS) {
+    #else
     if (xTimerChangePeriod (hTimer, ticks, 0) == pdPASS) {
+    #endif
       stat = osOK;
     } else {
       stat = osErrorResource;
@@ -1051,7 +1133,11 @@ osStatus_t osTimerStop (osTimerId_t timer_id) {
       stat = osErrorResource;
     }
     else {
+      #if (configUSE_TIMER_WHEEL == 1)
+      if (xTimerDisarm (hTimer) == pdPASS) {
+      #else
       if (xTimerStop (hTimer, 0) == pdPASS) {
+      #endif
         stat = osOK;
       } else {
         stat = osError;
@@ -1091,7 +1177,13 @@ osStatus_t osTimerDelete (osTimerId_t timer_id) {
     callb = (TimerCallback_t *)pvTimerGetTimerID (hTimer);
 
     if (xTimerDelete (hTimer, 0) == pdPASS) {
+      #if (configUSE_OS2_STATIC_POOLS == 1)
+      /* Only the daemon task may block here when its command queue is full */
+      (void)xTimerPendFunctionCall (TimerPoolRelease, callb, 0U,
+                                    (xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle()) ? 0U : portMAX_DELAY);
+      #else
       vPortFree (callb);
+      #endif
       stat = osOK;
     } else {
       stat = osErrorResource;
@@ -1110,6 +1202,11 @@ osStatus_t osTimerDelete (osTimerId_t timer_id) {
 osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr) {
   EventGroupHandle_t hEventGroup;
   int32_t mem;
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  void *pool_mem;
+  uint32_t pool_sz;
+  #endif
 
   hEventGroup = NULL;
 
@@ -1137,7 +1234,13 @@ osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr) {
     }
     else {
       if (mem == 0) {
-        #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+          cb_mem = osPoolAlloc (OS2_POOL_EVENTFLAGS, (attr != NULL) ? attr->name : NULL, 0U, &pool_mem, &pool_sz);
+
+          if (cb_mem != NULL) {
+            hEventGroup = xEventGroupCreateStatic (cb_mem);
+          }
+        #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
           hEventGroup = xEventGroupCreate();
         #endif
       }
@@ -1285,8 +1388,46 @@ osStatus_t osEventFlagsDelete (osEventFlagsId_t ef_id) {
   else {
     stat = osOK;
     vEventGroupDelete (hEventGroup);
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    osPoolRelease (hEventGroup);
+    #endif
+  }
+#else
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+osStatus_t osEventFlagsSetWakeThreshold (osEventFlagsId_t ef_id, uint32_t count, uint32_t latency) {
+  EventGroupHandle_t hEventGroup = (EventGroupHandle_t)ef_id;
+  osStatus_t stat;
+
+#if (configUSE_BATCHED_WAKEUP == 1)
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if ((hEventGroup == NULL) || (count == 0U) || (latency == 0U)) {
+    stat = osErrorParameter;
+  }
+#if (tmrBATCH_LATENCY_POSSIBLE == 1)
+  /* osWaitForever is portMAX_DELAY, which removes the bound */
+  else if (xEventGroupSetWakeLatency (hEventGroup, (TickType_t)latency) != pdPASS) {
+    stat = osErrorNoMemory;
+  }
+#else
+  else if (latency != osWaitForever) {
+    stat = osError;
+  }
+#endif
+  else {
+    stat = osOK;
+    vEventGroupSetWakeThreshold (hEventGroup, (UBaseType_t)count);
   }
 #else
+  (void)hEventGroup;
+  (void)count;
+  (void)latency;
   stat = osError;
 #endif
 
@@ -1296,6 +1437,202 @@ osStatus_t osEventFlagsDelete (osEventFlagsId_t ef_id) {
 /*---------------------------------------------------------------------------*/
 #if (configUSE_OS2_MUTEX == 1)
 
+static BaseType_t MutexTake (SemaphoreHandle_t hMutex, uint32_t rmtx, uint32_t timeout) {
+  BaseType_t ret;
+
+  ret = pdFAIL;
+
+  if (rmtx != 0U) {
+    #if (configUSE_RECURSIVE_MUTEXES == 1)
+    ret = xSemaphoreTakeRecursive (hMutex, timeout);
+    #endif
+  }
+  else {
+    ret = xSemaphoreTake (hMutex, timeout);
+  }
+
+  return (ret);
+}
+
+#if (configUSE_OS2_MUTEX_PROFILE == 1)
+
+/* Profile slot: published statistics and the state of the current hold */
+typedef struct {
+  osMutexProfile_t stat;
+  uint32_t         hold_start;        ///< Profile clock when the hold began
+  uint32_t         depth;             ///< Recursive hold depth
+} MutexProfile_t;
+
+/* Slot of a deleted mutex: skipped by lookups, reused by osMutexNew */
+#define MUTEX_PROFILE_DELETED   ((osMutexId_t)~0U)
+
+static MutexProfile_t        MutexProfile[configOS2_MUTEX_PROFILE_SLOTS];
+static osMutexInheritEvent_t MutexInherit[configOS2_MUTEX_PROFILE_EVENTS];
+static uint32_t              MutexInheritCount;
+
+/*
+  Find the profile slot of a mutex. Slots are hashed on the handle and
+  probed linearly, so a lookup usually touches a single slot.
+*/
+static MutexProfile_t *MutexProfileFind (osMutexId_t mutex_id) {
+  MutexProfile_t *prof;
+  uint32_t i, n;
+
+  prof = NULL;
+  i = ((uint32_t)mutex_id >> 3) % configOS2_MUTEX_PROFILE_SLOTS;
+
+  for (n = 0U; n < configOS2_MUTEX_PROFILE_SLOTS; n++) {
+    if (MutexProfile[i].stat.mutex_id == mutex_id) {
+      prof = &MutexProfile[i];
+      break;
+    }
+    if (MutexProfile[i].stat.mutex_id == NULL) {
+      break;
+    }
+    i = (i + 1U) % configOS2_MUTEX_PROFILE_SLOTS;
+  }
+
+  return (prof);
+}
+
+static void MutexProfileAdd (osMutexId_t mutex_id, const char *name) {
+  MutexProfile_t *prof;
+  uint32_t i, n;
+
+  i = ((uint32_t)mutex_id >> 3) % configOS2_MUTEX_PROFILE_SLOTS;
+
+  taskENTER_CRITICAL();
+
+  for (n = 0U; n < configOS2_MUTEX_PROFILE_SLOTS; n++) {
+    prof = &MutexProfile[i];
+
+    if ((prof->stat.mutex_id == NULL) || (prof->stat.mutex_id == MUTEX_PROFILE_DELETED)) {
+      memset (prof, 0, sizeof(MutexProfile_t));
+      prof->stat.name     = name;
+      prof->stat.mutex_id = mutex_id;
+      break;
+    }
+    i = (i + 1U) % configOS2_MUTEX_PROFILE_SLOTS;
+  }
+
+  taskEXIT_CRITICAL();
+}
+
+static void MutexProfileRemove (osMutexId_t mutex_id) {
+  MutexProfile_t *prof;
+
+  taskENTER_CRITICAL();
+
+  prof = MutexProfileFind (mutex_id);
+
+  if (prof != NULL) {
+    prof->stat.mutex_id = MUTEX_PROFILE_DELETED;
+  }
+
+  taskEXIT_CRITICAL();
+}
+
+/*
+  Called before blocking on a mutex that is held. When the calling task
+  outranks the owner, the kernel is about to raise the owner's priority:
+  log the inheritance with both tasks.
+*/
+static void MutexProfileInherit (MutexProfile_t *prof, SemaphoreHandle_t hMutex, uint32_t time) {
+  osMutexInheritEvent_t *ev;
+  TaskHandle_t hOwner;
+  UBaseType_t  owner_prio;
+  UBaseType_t  waiter_prio;
+
+  hOwner = xSemaphoreGetMutexHolder (hMutex);
+
+  if (hOwner != NULL) {
+    owner_prio  = uxTaskPriorityGet (hOwner);
+    waiter_prio = uxTaskPriorityGet (NULL);
+
+    if (waiter_prio > owner_prio) {
+      taskENTER_CRITICAL();
+
+      ev = &MutexInherit[MutexInheritCount % configOS2_MUTEX_PROFILE_EVENTS];
+      MutexInheritCount++;
+
+      ev->mutex_id    = prof->stat.mutex_id;
+      ev->name        = prof->stat.name;
+      ev->time        = time;
+      ev->owner_prio  = (uint8_t)owner_prio;
+      ev->waiter_prio = (uint8_t)waiter_prio;
+      strncpy (ev->owner,  pcTaskGetName (hOwner), osMutexProfileNameLen - 1U);
+      strncpy (ev->waiter, pcTaskGetName (NULL),   osMutexProfileNameLen - 1U);
+      ev->owner[osMutexProfileNameLen - 1U]  = '\0';
+      ev->waiter[osMutexProfileNameLen - 1U] = '\0';
+
+      prof->stat.inherits++;
+
+      taskEXIT_CRITICAL();
+    }
+  }
+}
+
+/*
+  Take a profiled mutex. A take that does not wait is uncontended; otherwise
+  the wait is timed. Statistics written only by the new holder need no
+  critical section.
+*/
+static BaseType_t MutexProfileTake (MutexProfile_t *prof, SemaphoreHandle_t hMutex, uint32_t rmtx, uint32_t timeout) {
+  BaseType_t ret;
+  uint32_t start;
+  uint32_t wait;
+
+  ret = MutexTake (hMutex, rmtx, 0U);
+
+  if ((ret != pdPASS) && (timeout != 0U)) {
+    start = configOS2_MUTEX_PROFILE_CLOCK();
+    MutexProfileInherit (prof, hMutex, start);
+
+    ret  = MutexTake (hMutex, rmtx, timeout);
+    wait = configOS2_MUTEX_PROFILE_CLOCK() - start;
+
+    if (ret == pdPASS) {
+      prof->stat.contended++;
+      prof->stat.wait_total += wait;
+      if (wait > prof->stat.wait_max) {
+        prof->stat.wait_max = wait;
+      }
+    }
+    else {
+      taskENTER_CRITICAL();
+      prof->stat.timeouts++;
+      taskEXIT_CRITICAL();
+    }
+  }
+
+  if (ret == pdPASS) {
+    prof->stat.acquired++;
+    if (prof->depth++ == 0U) {
+      prof->hold_start = configOS2_MUTEX_PROFILE_CLOCK();
+    }
+  }
+
+  return (ret);
+}
+
+/* Called before giving a profiled mutex back, by any task */
+static void MutexProfileRelease (MutexProfile_t *prof, SemaphoreHandle_t hMutex) {
+  uint32_t hold;
+
+  if ((xSemaphoreGetMutexHolder (hMutex) == xTaskGetCurrentTaskHandle()) && (prof->depth != 0U)) {
+    prof->depth--;
+
+    if (prof->depth == 0U) {
+      hold = configOS2_MUTEX_PROFILE_CLOCK() - prof->hold_start;
+      if (hold > prof->stat.hold_max) {
+        prof->stat.hold_max = hold;
+      }
+    }
+  }
+}
+
+#endif /* (configUSE_OS2_MUTEX_PROFILE == 1) */
+
 osMutexId_t osMutexNew (const osMutexAttr_t *attr) {
   SemaphoreHandle_t hMutex;
   uint32_t type;
@@ -1304,6 +1641,11 @@ osMutexId_t osMutexNew (const osMutexAttr_t *attr) {
   #if (configQUEUE_REGISTRY_SIZE > 0)
   const char *name;
   #endif
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  void *pool_mem;
+  uint32_t pool_sz;
+  #endif
 
   hMutex = NULL;
 
@@ -1351,7 +1693,23 @@ osMutexId_t osMutexNew (const osMutexAttr_t *attr) {
       }
       else {
         if (mem == 0) {
-          #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+          #if (configUSE_OS2_STATIC_POOLS == 1)
+            cb_mem = osPoolAlloc (OS2_POOL_MUTEX, (attr != NULL) ? attr->name : NULL, 0U, &pool_mem, &pool_sz);
+
+            if (cb_mem != NULL) {
+              if (rmtx != 0U) {
+                #if (configUSE_RECURSIVE_MUTEXES == 1)
+                hMutex = xSemaphoreCreateRecursiveMutexStatic (cb_mem);
+                #endif
+              } else {
+                hMutex = xSemaphoreCreateMutexStatic (cb_mem);
+              }
+
+              if (hMutex == NULL) {
+                osPoolRelease (cb_mem);
+              }
+            }
+          #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
             if (rmtx != 0U) {
               #if (configUSE_RECURSIVE_MUTEXES == 1)
               hMutex = xSemaphoreCreateRecursiveMutex ();
@@ -1377,6 +1735,12 @@ osMutexId_t osMutexNew (const osMutexAttr_t *attr) {
       if ((hMutex != NULL) && (rmtx != 0U)) {
         hMutex = (SemaphoreHandle_t)((uint32_t)hMutex | 1U);
       }
+
+      #if (configUSE_OS2_MUTEX_PROFILE == 1)
+      if (hMutex != NULL) {
+        MutexProfileAdd ((osMutexId_t)hMutex, (attr != NULL) ? attr->name : NULL);
+      }
+      #endif
     }
   }
 
@@ -1387,6 +1751,10 @@ osStatus_t osMutexAcquire (osMutexId_t mutex_id, uint32_t timeout) {
   SemaphoreHandle_t hMutex;
   osStatus_t stat;
   uint32_t rmtx;
+  BaseType_t ret;
+  #if (configUSE_OS2_MUTEX_PROFILE == 1)
+  MutexProfile_t *prof;
+  #endif
 
   hMutex = (SemaphoreHandle_t)((uint32_t)mutex_id & ~1U);
 
@@ -1401,24 +1769,23 @@ osStatus_t osMutexAcquire (osMutexId_t mutex_id, uint32_t timeout) {
     stat = osErrorParameter;
   }
   else {
-    if (rmtx != 0U) {
-      #if (configUSE_RECURSIVE_MUTEXES == 1)
-      if (xSemaphoreTakeRecursive (hMutex, timeout) != pdPASS) {
-        if (timeout != 0U) {
-          stat = osErrorTimeout;
-        } else {
-          stat = osErrorResource;
-        }
-      }
-      #endif
+    #if (configUSE_OS2_MUTEX_PROFILE == 1)
+    prof = MutexProfileFind (mutex_id);
+
+    if (prof != NULL) {
+      ret = MutexProfileTake (prof, hMutex, rmtx, timeout);
+    } else {
+      ret = MutexTake (hMutex, rmtx, timeout);
     }
-    else {
-      if (xSemaphoreTake (hMutex, timeout) != pdPASS) {
-        if (timeout != 0U) {
-          stat = osErrorTimeout;
-        } else {
-          stat = osErrorResource;
-        }
+    #else
+    ret = MutexTake (hMutex, rmtx, timeout);
+    #endif
+
+    if (ret != pdPASS) {
+      if (timeout != 0U) {
+        stat = osErrorTimeout;
+      } else {
+        stat = osErrorResource;
       }
     }
   }
@@ -1430,6 +1797,9 @@ osStatus_t osMutexRelease (osMutexId_t mutex_id) {
   SemaphoreHandle_t hMutex;
   osStatus_t stat;
   uint32_t rmtx;
+  #if (configUSE_OS2_MUTEX_PROFILE == 1)
+  MutexProfile_t *prof;
+  #endif
 
   hMutex = (SemaphoreHandle_t)((uint32_t)mutex_id & ~1U);
 
@@ -1444,6 +1814,14 @@ osStatus_t osMutexRelease (osMutexId_t mutex_id) {
     stat = osErrorParameter;
   }
   else {
+    #if (configUSE_OS2_MUTEX_PROFILE == 1)
+    prof = MutexProfileFind (mutex_id);
+
+    if (prof != NULL) {
+      MutexProfileRelease (prof, hMutex);
+    }
+    #endif
+
     if (rmtx != 0U) {
       #if (configUSE_RECURSIVE_MUTEXES == 1)
       if (xSemaphoreGiveRecursive (hMutex) != pdPASS) {
@@ -1493,8 +1871,128 @@ osStatus_t osMutexDelete (osMutexId_t mutex_id) {
     #if (configQUEUE_REGISTRY_SIZE > 0)
     vQueueUnregisterQueue (hMutex);
     #endif
+    #if (configUSE_OS2_MUTEX_PROFILE == 1)
+    MutexProfileRemove (mutex_id);
+    #endif
     stat = osOK;
     vSemaphoreDelete (hMutex);
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    osPoolRelease (hMutex);
+    #endif
+  }
+#else
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+osStatus_t osMutexProfileGet (uint32_t index, osMutexProfile_t *profile) {
+  osStatus_t stat;
+#if (configUSE_OS2_MUTEX_PROFILE == 1)
+  osMutexId_t id;
+  uint32_t i;
+
+  if (profile == NULL) {
+    stat = osErrorParameter;
+  }
+  else {
+    stat = osErrorResource;
+
+    for (i = 0U; i < configOS2_MUTEX_PROFILE_SLOTS; i++) {
+      id = MutexProfile[i].stat.mutex_id;
+
+      if ((id != NULL) && (id != MUTEX_PROFILE_DELETED)) {
+        if (index == 0U) {
+          taskENTER_CRITICAL();
+          *profile = MutexProfile[i].stat;
+          taskEXIT_CRITICAL();
+          stat = osOK;
+          break;
+        }
+        index--;
+      }
+    }
+  }
+#else
+  (void)index;
+  (void)profile;
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+osStatus_t osMutexProfileGetInherit (uint32_t index, osMutexInheritEvent_t *event) {
+  osStatus_t stat;
+#if (configUSE_OS2_MUTEX_PROFILE == 1)
+  uint32_t count;
+
+  if (event == NULL) {
+    stat = osErrorParameter;
+  }
+  else {
+    taskENTER_CRITICAL();
+
+    count = MutexInheritCount;
+    if (count > configOS2_MUTEX_PROFILE_EVENTS) {
+      count = configOS2_MUTEX_PROFILE_EVENTS;
+    }
+
+    if (index < count) {
+      *event = MutexInherit[(MutexInheritCount - 1U - index) % configOS2_MUTEX_PROFILE_EVENTS];
+      stat = osOK;
+    } else {
+      stat = osErrorResource;
+    }
+
+    taskEXIT_CRITICAL();
+  }
+#else
+  (void)index;
+  (void)event;
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+uint32_t osMutexProfileClockHz (void) {
+#if (configUSE_OS2_MUTEX_PROFILE == 1)
+  return (configOS2_MUTEX_PROFILE_CLOCK_HZ());
+#else
+  return (0U);
+#endif
+}
+
+osStatus_t osMutexProfileReset (void) {
+  osStatus_t stat;
+#if (configUSE_OS2_MUTEX_PROFILE == 1)
+  osMutexProfile_t *st;
+  uint32_t i;
+
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else {
+    taskENTER_CRITICAL();
+
+    for (i = 0U; i < configOS2_MUTEX_PROFILE_SLOTS; i++) {
+      st = &MutexProfile[i].stat;
+
+      st->acquired   = 0U;
+      st->contended  = 0U;
+      st->timeouts   = 0U;
+      st->inherits   = 0U;
+      st->wait_total = 0U;
+      st->wait_max   = 0U;
+      st->hold_max   = 0U;
+    }
+    MutexInheritCount = 0U;
+
+    taskEXIT_CRITICAL();
+
+    stat = osOK;
   }
 #else
   stat = osError;
@@ -1512,6 +2010,11 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
   #if (configQUEUE_REGISTRY_SIZE > 0)
   const char *name;
   #endif
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  void *pool_mem;
+  uint32_t pool_sz;
+  #endif
 
   hSemaphore = NULL;
 
@@ -1532,6 +2035,19 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
       mem = 0;
     }
 
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    if (mem == 0) {
+      /* Take the control block from the pool and create the semaphore statically */
+      cb_mem = osPoolAlloc (OS2_POOL_SEMAPHORE, (attr != NULL) ? attr->name : NULL, 0U, &pool_mem, &pool_sz);
+
+      if (cb_mem != NULL) {
+        mem = 2;
+      } else {
+        mem = -1;
+      }
+    }
+    #endif
+
     if (mem != -1) {
       if (max_count == 1U) {
         if (mem == 1) {
@@ -1539,6 +2055,11 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
             hSemaphore = xSemaphoreCreateBinaryStatic ((StaticSemaphore_t *)attr->cb_mem);
           #endif
         }
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+        else if (mem == 2) {
+          hSemaphore = xSemaphoreCreateBinaryStatic ((StaticSemaphore_t *)cb_mem);
+        }
+        #endif
         else {
           #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
             hSemaphore = xSemaphoreCreateBinary();
@@ -1558,6 +2079,11 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
             hSemaphore = xSemaphoreCreateCountingStatic (max_count, initial_count, (StaticSemaphore_t *)attr->cb_mem);
           #endif
         }
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+        else if (mem == 2) {
+          hSemaphore = xSemaphoreCreateCountingStatic (max_count, initial_count, (StaticSemaphore_t *)cb_mem);
+        }
+        #endif
         else {
           #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
             hSemaphore = xSemaphoreCreateCounting (max_count, initial_count);
@@ -1565,6 +2091,12 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
         }
       }
       
+      #if (configUSE_OS2_STATIC_POOLS == 1)
+      if ((hSemaphore == NULL) && (mem == 2)) {
+        osPoolRelease (cb_mem);
+      }
+      #endif
+
       #if (configQUEUE_REGISTRY_SIZE > 0)
       if (hSemaphore != NULL) {
         if (attr != NULL) {
@@ -1680,6 +2212,9 @@ osStatus_t osSemaphoreDelete (osSemaphoreId_t semaphore_id) {
 
     stat = osOK;
     vSemaphoreDelete (hSemaphore);
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    osPoolRelease (hSemaphore);
+    #endif
   }
 #else
   stat = osError;
@@ -1689,6 +2224,7 @@ osStatus_t osSemaphoreDelete (osSemaphoreId_t semaphore_id) {
 }
 
 /*---------------------------------------------------------------------------*/
+#if (configUSE_OS2_MSGQUEUE_PRIO == 0)
 
 osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr) {
   QueueHandle_t hQueue;
@@ -1696,6 +2232,11 @@ osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, con
   #if (configQUEUE_REGISTRY_SIZE > 0)
   const char *name;
   #endif
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  void *mq_mem;
+  uint32_t mq_sz;
+  #endif
 
   hQueue = NULL;
 
@@ -1725,7 +2266,13 @@ osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, con
     }
     else {
       if (mem == 0) {
-        #if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+          cb_mem = osPoolAlloc (OS2_POOL_MSGQUEUE, (attr != NULL) ? attr->name : NULL, msg_count * msg_size, &mq_mem, &mq_sz);
+
+          if (cb_mem != NULL) {
+            hQueue = xQueueCreateStatic (msg_count, msg_size, mq_mem, cb_mem);
+          }
+        #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
           hQueue = xQueueCreate (msg_count, msg_size);
         #endif
       }
@@ -1915,6 +2462,41 @@ osStatus_t osMessageQueueReset (osMessageQueueId_t mq_id) {
   return (stat);
 }
 
+osStatus_t osMessageQueueSetWakeThreshold (osMessageQueueId_t mq_id, uint32_t count, uint32_t latency) {
+  QueueHandle_t hQueue = (QueueHandle_t)mq_id;
+  osStatus_t stat;
+
+#if (configUSE_BATCHED_WAKEUP == 1)
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if ((hQueue == NULL) || (count == 0U) || (count > osMessageQueueGetCapacity (mq_id)) || (latency == 0U)) {
+    stat = osErrorParameter;
+  }
+#if (tmrBATCH_LATENCY_POSSIBLE == 1)
+  /* osWaitForever is portMAX_DELAY, which removes the bound */
+  else if (xQueueSetWakeLatency (hQueue, (TickType_t)latency) != pdPASS) {
+    stat = osErrorNoMemory;
+  }
+#else
+  else if (latency != osWaitForever) {
+    stat = osError;
+  }
+#endif
+  else {
+    stat = osOK;
+    vQueueSetWakeThreshold (hQueue, (UBaseType_t)count);
+  }
+#else
+  (void)hQueue;
+  (void)count;
+  (void)latency;
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
 osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
   QueueHandle_t hQueue = (QueueHandle_t)mq_id;
   osStatus_t stat;
@@ -1933,6 +2515,9 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
 
     stat = osOK;
     vQueueDelete (hQueue);
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    osPoolRelease (hQueue);
+    #endif
   }
 #else
   stat = osError;
@@ -1941,259 +2526,893 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
   return (stat);
 }
 
-/*---------------------------------------------------------------------------*/
-#ifdef FREERTOS_MPOOL_H_
+#else /* (configUSE_OS2_MSGQUEUE_PRIO == 1) */
 
-/* Static memory pool functions */
-static void  FreeBlock   (MemPool_t *mp, void *block);
-static void *AllocBlock  (MemPool_t *mp);
-static void *CreateBlock (MemPool_t *mp);
+/* Priority message queue functions */
+static uint32_t MsgQueueBefore (MsgQueue_t *mq, uint32_t a, uint32_t b);
+static void     MsgQueueInsert (MsgQueue_t *mq, const void *msg_ptr, uint8_t msg_prio);
+static void     MsgQueueRemove (MsgQueue_t *mq, void *msg_ptr, uint8_t *msg_prio);
 
-osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
-  MemPool_t *mp;
+/* Header of message slot idx */
+#define MSGQ_HDR(mq, idx)         ((MsgQueueHdr_t *)((mq)->msg_arr + ((idx) * (mq)->slot_sz)))
+
+osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr) {
+  MsgQueue_t *mq;
+  uint8_t *mem_arr;
   const char *name;
-  int32_t mem_cb, mem_mp;
-  uint32_t sz;
+  int32_t mem;
+  uint32_t sz, i;
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  uint32_t mq_sz;
+  #endif
 
-  if (IS_IRQ()) {
-    mp = NULL;
-  }
-  else if ((block_count == 0U) || (block_size == 0U)) {
-    mp = NULL;
-  }
-  else {
-    mp = NULL;
-    sz = MEMPOOL_ARR_SIZE (block_count, block_size);
+  mq = NULL;
+
+  if (!IS_IRQ() && (msg_count > 0U) && (msg_size > 0U)) {
+    sz = MSGQUEUE_ARR_SIZE (msg_count, msg_size);
 
     name = NULL;
-    mem_cb = -1;
-    mem_mp = -1;
+    mem = -1;
 
     if (attr != NULL) {
-      if (attr->name != NULL) {
-        name = attr->name;
-      }
-
-      if ((attr->cb_mem != NULL) && (attr->cb_size >= sizeof(MemPool_t))) {
-        /* Static control block is provided */
-        mem_cb = 1;
-      }
-      else if ((attr->cb_mem == NULL) && (attr->cb_size == 0U)) {
-        /* Allocate control block memory on heap */
-        mem_cb = 0;
-      }
+      name = attr->name;
 
-      if ((attr->mp_mem == NULL) && (attr->mp_size == 0U)) {
-        /* Allocate memory array on heap */
-          mem_mp = 0;
+      if ((attr->cb_mem != NULL) && (attr->cb_size >= sizeof(MsgQueue_t)) &&
+          (attr->mq_mem != NULL) && (attr->mq_size >= sz)) {
+        /* Check if array is 4-byte aligned */
+        if (((uint32_t)attr->mq_mem & 3U) == 0U) {
+          mem = 1;
+        }
       }
       else {
-        if (attr->mp_mem != NULL) {
-          /* Check if array is 4-byte aligned */
-          if (((uint32_t)attr->mp_mem & 3U) == 0U) {
-            /* Check if array big enough */
-            if (attr->mp_size >= sz) {
-              /* Static memory pool array is provided */
-              mem_mp = 1;
-            }
-          }
+        if ((attr->cb_mem == NULL) && (attr->cb_size == 0U) &&
+            (attr->mq_mem == NULL) && (attr->mq_size == 0U)) {
+          mem = 0;
         }
       }
     }
     else {
-      /* Attributes not provided, allocate memory on heap */
-      mem_cb = 0;
-      mem_mp = 0;
+      mem = 0;
     }
 
-    if (mem_cb == 0) {
-      mp = pvPortMalloc (sizeof(MemPool_t));
-    } else {
-      mp = attr->cb_mem;
+    mem_arr = NULL;
+
+    if (mem == 1) {
+      mq      = attr->cb_mem;
+      mem_arr = attr->mq_mem;
     }
+    else {
+      if (mem == 0) {
+        #if (configUSE_OS2_STATIC_POOLS == 1)
+          cb_mem = osPoolAlloc (OS2_POOL_MSGQUEUE, name, sz, (void **)&mem_arr, &mq_sz);
 
-    if (mp != NULL) {
-      /* Create a semaphore (max count == initial count == block_count) */
+          if (cb_mem != NULL) {
+            mq = cb_mem;
+          }
+        #else
+          /* Control block and memory array in one heap block */
+          mq = pvPortMalloc (sizeof(MsgQueue_t) + sz);
+
+          if (mq != NULL) {
+            mem_arr = (uint8_t *)&mq[1];
+          }
+        #endif
+      }
+    }
+
+    if (mq != NULL) {
+      /* Create the semaphores counting queued messages and free slots */
       #if (configSUPPORT_STATIC_ALLOCATION == 1)
-        mp->sem = xSemaphoreCreateCountingStatic (block_count, block_count, &mp->mem_sem);
+        mq->sem_msg = xSemaphoreCreateCountingStatic (msg_count, 0U, &mq->mem_sem_msg);
+        mq->sem_spc = xSemaphoreCreateCountingStatic (msg_count, msg_count, &mq->mem_sem_spc);
       #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
-        mp->sem = xSemaphoreCreateCounting (block_count, block_count);
+        mq->sem_msg = xSemaphoreCreateCounting (msg_count, 0U);
+        mq->sem_spc = xSemaphoreCreateCounting (msg_count, msg_count);
       #else
-        mp->sem == NULL;
+        mq->sem_msg = NULL;
+        mq->sem_spc = NULL;
       #endif
 
-      if (mp->sem != NULL) {
-        /* Setup memory array */
-        if (mem_mp == 0) {
-          mp->mem_arr = pvPortMalloc (sz);
-        } else {
-          mp->mem_arr = attr->mp_mem;
+      if ((mq->sem_msg != NULL) && (mq->sem_spc != NULL)) {
+        /* Heap of slot indexes first, message slots behind it */
+        mq->heap    = (uint32_t *)mem_arr;
+        mq->msg_arr = mem_arr + (msg_count * sizeof(uint32_t));
+        mq->name    = name;
+        mq->msg_cnt = msg_count;
+        mq->msg_sz  = msg_size;
+        mq->slot_sz = MSGQUEUE_SLOT_SIZE (msg_size);
+        mq->n       = 0U;
+        mq->seq     = 0U;
+
+        /* Link all slots into the free list */
+        for (i = 0U; i < msg_count; i++) {
+          MSGQ_HDR(mq, i)->seq = i + 1U;
         }
-      }
-    }
+        mq->free = 0U;
 
-    if ((mp != NULL) && (mp->mem_arr != NULL)) {
-      /* Memory pool can be created */
-      mp->head    = NULL;
-      mp->mem_sz  = sz;
-      mp->name    = name;
-      mp->bl_sz   = block_size;
-      mp->bl_cnt  = block_count;
-      mp->n       = 0U;
+        mq->status = MSGQ_STATUS;
 
-      /* Set heap allocated memory flags */
-      mp->status = MPOOL_STATUS;
+        if (mem == 0) {
+          #if (configUSE_OS2_STATIC_POOLS == 1)
+          /* Control block and memory array from the static pool */
+          mq->status |= 4U;
+          #else
+          /* Control block and memory array on heap */
+          mq->status |= 1U;
+          #endif
+        }
 
-      if (mem_cb == 0) {
-        /* Control block on heap */
-        mp->status |= 1U;
-      }
-      if (mem_mp == 0) {
-        /* Memory array on heap */
-        mp->status |= 2U;
+        #if (configQUEUE_REGISTRY_SIZE > 0)
+        vQueueAddToRegistry (mq->sem_msg, name);
+        #endif
       }
-    }
-    else {
-      /* Memory pool cannot be created, release allocated resources */
-      if ((mem_cb == 0) && (mp != NULL)) {
-        /* Free control block memory */
-        vPortFree (mp);
+      else {
+        /* Message queue cannot be created, release allocated resources */
+        if (mq->sem_msg != NULL) {
+          vSemaphoreDelete (mq->sem_msg);
+        }
+        if (mq->sem_spc != NULL) {
+          vSemaphoreDelete (mq->sem_spc);
+        }
+        if (mem == 0) {
+          #if (configUSE_OS2_STATIC_POOLS == 1)
+          osPoolRelease (mq);
+          #else
+          vPortFree (mq);
+          #endif
+        }
+        mq = NULL;
       }
-      mp = NULL;
     }
   }
 
-  return (mp);
+  return ((osMessageQueueId_t)mq);
 }
 
-const char *osMemoryPoolGetName (osMemoryPoolId_t mp_id) {
-  MemPool_t *mp = (osMemoryPoolId_t)mp_id;
-  const char *p;
+osStatus_t osMessageQueuePut (osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  osStatus_t stat;
+  BaseType_t yield;
+  uint32_t isrm;
 
-  if (IS_IRQ()) {
-    p = NULL;
-  }
-  else if (mp_id == NULL) {
-    p = NULL;
-  }
-  else {
-    p = mp->name;
-  }
+  stat = osOK;
 
-  return (p);
-}
+  if (IS_IRQ()) {
+    if ((mq == NULL) || (msg_ptr == NULL) || (timeout != 0U)) {
+      stat = osErrorParameter;
+    }
+    else if ((mq->status & MSGQ_STATUS) != MSGQ_STATUS) {
+      stat = osErrorResource;
+    }
+    else {
+      yield = pdFALSE;
 
-void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
-  MemPool_t *mp;
-  void *block;
-  uint32_t isrm;
+      if (xSemaphoreTakeFromISR (mq->sem_spc, NULL) != pdTRUE) {
+        stat = osErrorResource;
+      } else {
+        isrm = taskENTER_CRITICAL_FROM_ISR();
+        MsgQueueInsert (mq, msg_ptr, msg_prio);
+        taskEXIT_CRITICAL_FROM_ISR(isrm);
 
-  if (mp_id == NULL) {
-    /* Invalid input parameters */
-    block = NULL;
+        (void)xSemaphoreGiveFromISR (mq->sem_msg, &yield);
+        portYIELD_FROM_ISR (yield);
+      }
+    }
   }
   else {
-    block = NULL;
-
-    mp = (MemPool_t *)mp_id;
-
-    if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-      if (IS_IRQ()) {
-        if (timeout == 0U) {
-          if (xSemaphoreTakeFromISR (mp->sem, NULL) == pdTRUE) {
-            if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-              isrm  = taskENTER_CRITICAL_FROM_ISR();
-
-              /* Get a block from the free-list */
-              block = AllocBlock(mp);
-
-              if (block == NULL) {
-                /* List of free blocks is empty, 'create' new block */
-                block = CreateBlock(mp);
-              }
-
-              taskEXIT_CRITICAL_FROM_ISR(isrm);
-            }
-          }
+    if ((mq == NULL) || (msg_ptr == NULL)) {
+      stat = osErrorParameter;
+    }
+    else if ((mq->status & MSGQ_STATUS) != MSGQ_STATUS) {
+      stat = osErrorResource;
+    }
+    else {
+      if (xSemaphoreTake (mq->sem_spc, (TickType_t)timeout) != pdPASS) {
+        if (timeout != 0U) {
+          stat = osErrorTimeout;
+        } else {
+          stat = osErrorResource;
         }
       }
       else {
-        if (xSemaphoreTake (mp->sem, (TickType_t)timeout) == pdTRUE) {
-          if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-            taskENTER_CRITICAL();
-
-            /* Get a block from the free-list */
-            block = AllocBlock(mp);
+        taskENTER_CRITICAL();
+        MsgQueueInsert (mq, msg_ptr, msg_prio);
+        taskEXIT_CRITICAL();
 
-            if (block == NULL) {
-              /* List of free blocks is empty, 'create' new block */
-              block = CreateBlock(mp);
-            }
-
-            taskEXIT_CRITICAL();
-          }
-        }
+        (void)xSemaphoreGive (mq->sem_msg);
       }
     }
   }
 
-  return (block);
+  return (stat);
 }
 
-osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
-  MemPool_t *mp;
+osStatus_t osMessageQueueGet (osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
   osStatus_t stat;
-  uint32_t isrm;
   BaseType_t yield;
+  uint32_t isrm;
 
-  if ((mp_id == NULL) || (block == NULL)) {
-    /* Invalid input parameters */
-    stat = osErrorParameter;
-  }
-  else {
-    mp = (MemPool_t *)mp_id;
+  stat = osOK;
 
-    if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
-      /* Invalid object status */
-      stat = osErrorResource;
-    }
-    else if ((block < (void *)&mp->mem_arr[0]) || (block > (void*)&mp->mem_arr[mp->mem_sz-1])) {
-      /* Block pointer outside of memory array area */
+  if (IS_IRQ()) {
+    if ((mq == NULL) || (msg_ptr == NULL) || (timeout != 0U)) {
       stat = osErrorParameter;
     }
+    else if ((mq->status & MSGQ_STATUS) != MSGQ_STATUS) {
+      stat = osErrorResource;
+    }
     else {
-      stat = osOK;
-
-      if (IS_IRQ()) {
-        if (uxSemaphoreGetCountFromISR (mp->sem) == mp->bl_cnt) {
-          stat = osErrorResource;
-        }
-        else {
-          isrm = taskENTER_CRITICAL_FROM_ISR();
-
-          /* Add block to the list of free blocks */
-          FreeBlock(mp, block);
+      yield = pdFALSE;
 
-          taskEXIT_CRITICAL_FROM_ISR(isrm);
+      if (xSemaphoreTakeFromISR (mq->sem_msg, NULL) != pdTRUE) {
+        stat = osErrorResource;
+      } else {
+        isrm = taskENTER_CRITICAL_FROM_ISR();
+        MsgQueueRemove (mq, msg_ptr, msg_prio);
+        taskEXIT_CRITICAL_FROM_ISR(isrm);
 
-          yield = pdFALSE;
-          xSemaphoreGiveFromISR (mp->sem, &yield);
-          portYIELD_FROM_ISR (yield);
-        }
+        (void)xSemaphoreGiveFromISR (mq->sem_spc, &yield);
+        portYIELD_FROM_ISR (yield);
       }
-      else {
-        if (uxSemaphoreGetCount (mp->sem) == mp->bl_cnt) {
+    }
+  }
+  else {
+    if ((mq == NULL) || (msg_ptr == NULL)) {
+      stat = osErrorParameter;
+    }
+    else if ((mq->status & MSGQ_STATUS) != MSGQ_STATUS) {
+      stat = osErrorResource;
+    }
+    else {
+      if (xSemaphoreTake (mq->sem_msg, (TickType_t)timeout) != pdPASS) {
+        if (timeout != 0U) {
+          stat = osErrorTimeout;
+        } else {
           stat = osErrorResource;
         }
-        else {
-          taskENTER_CRITICAL();
+      }
+      else {
+        taskENTER_CRITICAL();
+        MsgQueueRemove (mq, msg_ptr, msg_prio);
+        taskEXIT_CRITICAL();
+
+        (void)xSemaphoreGive (mq->sem_spc);
+      }
+    }
+  }
+
+  return (stat);
+}
+
+uint32_t osMessageQueueGetCapacity (osMessageQueueId_t mq_id) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  uint32_t capacity;
+
+  if (mq == NULL) {
+    capacity = 0U;
+  } else {
+    capacity = mq->msg_cnt;
+  }
+
+  return (capacity);
+}
+
+uint32_t osMessageQueueGetMsgSize (osMessageQueueId_t mq_id) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  uint32_t size;
+
+  if (mq == NULL) {
+    size = 0U;
+  } else {
+    size = mq->msg_sz;
+  }
+
+  return (size);
+}
+
+uint32_t osMessageQueueGetCount (osMessageQueueId_t mq_id) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  uint32_t count;
+
+  if (mq == NULL) {
+    count = 0U;
+  } else {
+    /* Single word read, safe from both thread and ISR context */
+    count = mq->n;
+  }
+
+  return (count);
+}
+
+uint32_t osMessageQueueGetSpace (osMessageQueueId_t mq_id) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  uint32_t space;
+
+  if (mq == NULL) {
+    space = 0U;
+  } else {
+    space = mq->msg_cnt - mq->n;
+  }
+
+  return (space);
+}
+
+osStatus_t osMessageQueueReset (osMessageQueueId_t mq_id) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  osStatus_t stat;
+
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if (mq == NULL) {
+    stat = osErrorParameter;
+  }
+  else if ((mq->status & MSGQ_STATUS) != MSGQ_STATUS) {
+    stat = osErrorResource;
+  }
+  else {
+    stat = osOK;
+
+    /* Discard queued messages one by one, so that blocked senders are woken up */
+    while (xSemaphoreTake (mq->sem_msg, 0U) == pdPASS) {
+      taskENTER_CRITICAL();
+      MsgQueueRemove (mq, NULL, NULL);
+      taskEXIT_CRITICAL();
+
+      (void)xSemaphoreGive (mq->sem_spc);
+    }
+  }
+
+  return (stat);
+}
+
+osStatus_t osMessageQueueSetWakeThreshold (osMessageQueueId_t mq_id, uint32_t count, uint32_t latency) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  osStatus_t stat;
+
+#if (configUSE_BATCHED_WAKEUP == 1)
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if ((mq == NULL) || (count == 0U) || (count > mq->msg_cnt) || (latency == 0U)) {
+    stat = osErrorParameter;
+  }
+  else if ((mq->status & MSGQ_STATUS) != MSGQ_STATUS) {
+    stat = osErrorResource;
+  }
+  /* Receivers block on the message count semaphore */
+#if (tmrBATCH_LATENCY_POSSIBLE == 1)
+  else if (xQueueSetWakeLatency (mq->sem_msg, (TickType_t)latency) != pdPASS) {
+    stat = osErrorNoMemory;
+  }
+#else
+  else if (latency != osWaitForever) {
+    stat = osError;
+  }
+#endif
+  else {
+    stat = osOK;
+    vQueueSetWakeThreshold (mq->sem_msg, (UBaseType_t)count);
+  }
+#else
+  (void)mq;
+  (void)count;
+  (void)latency;
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
+  MsgQueue_t *mq = (MsgQueue_t *)mq_id;
+  osStatus_t stat;
+
+#ifndef USE_FreeRTOS_HEAP_1
+  if (IS_IRQ()) {
+    stat = osErrorISR;
+  }
+  else if (mq == NULL) {
+    stat = osErrorParameter;
+  }
+  else {
+    #if (configQUEUE_REGISTRY_SIZE > 0)
+    vQueueUnregisterQueue (mq->sem_msg);
+    #endif
+
+    taskENTER_CRITICAL();
+
+    /* Invalidate control block status */
+    mq->status = mq->status & 0xFU;
+
+    taskEXIT_CRITICAL();
+
+    vSemaphoreDelete (mq->sem_msg);
+    vSemaphoreDelete (mq->sem_spc);
+
+    if ((mq->status & 1U) != 0U) {
+      /* Message queue control block and array allocated on heap */
+      vPortFree (mq);
+    }
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    if ((mq->status & 4U) != 0U) {
+      /* Message queue control block and array taken from the static pool */
+      osPoolRelease (mq);
+    }
+    #endif
+
+    stat = osOK;
+  }
+#else
+  stat = osError;
+#endif
+
+  return (stat);
+}
+
+/*
+  Return non-zero when the message in slot a is delivered before the message in
+  slot b: higher priority first, lower sequence number (put earlier) first within
+  the same priority.
+*/
+static uint32_t MsgQueueBefore (MsgQueue_t *mq, uint32_t a, uint32_t b) {
+  MsgQueueHdr_t *hdr_a = MSGQ_HDR(mq, a);
+  MsgQueueHdr_t *hdr_b = MSGQ_HDR(mq, b);
+  uint32_t before;
+
+  if (hdr_a->prio != hdr_b->prio) {
+    before = (hdr_a->prio > hdr_b->prio) ? 1U : 0U;
+  } else {
+    /* Wrap-around safe while fewer than 2^31 messages are queued */
+    before = ((int32_t)(hdr_a->seq - hdr_b->seq) < 0) ? 1U : 0U;
+  }
+
+  return (before);
+}
+
+/*
+  Copy a message into a free slot and add the slot to the heap.
+  Called in a critical section, after a free slot was claimed from sem_spc.
+*/
+static void MsgQueueInsert (MsgQueue_t *mq, const void *msg_ptr, uint8_t msg_prio) {
+  MsgQueueHdr_t *hdr;
+  uint32_t slot, i, parent;
+
+  slot     = mq->free;
+  hdr      = MSGQ_HDR(mq, slot);
+  mq->free = hdr->seq;
+
+  hdr->seq  = mq->seq++;
+  hdr->prio = msg_prio;
+  memcpy (&hdr[1], msg_ptr, mq->msg_sz);
+
+  /* Sift up from the end of the heap */
+  i = mq->n++;
+
+  while (i > 0U) {
+    parent = (i - 1U) / 2U;
+
+    if (MsgQueueBefore (mq, slot, mq->heap[parent]) == 0U) {
+      break;
+    }
+    mq->heap[i] = mq->heap[parent];
+    i = parent;
+  }
+
+  mq->heap[i] = slot;
+}
+
+/*
+  Copy out the first message (when msg_ptr is not NULL), and return its slot to
+  the free list. Called in a critical section, after a message was claimed from
+  sem_msg.
+*/
+static void MsgQueueRemove (MsgQueue_t *mq, void *msg_ptr, uint8_t *msg_prio) {
+  MsgQueueHdr_t *hdr;
+  uint32_t slot, last, i, child;
+
+  slot = mq->heap[0];
+  hdr  = MSGQ_HDR(mq, slot);
+
+  if (msg_ptr != NULL) {
+    memcpy (msg_ptr, &hdr[1], mq->msg_sz);
+  }
+  if (msg_prio != NULL) {
+    *msg_prio = (uint8_t)hdr->prio;
+  }
+
+  hdr->seq = mq->free;
+  mq->free = slot;
+
+  /* Move the last slot to the root and sift it down */
+  mq->n--;
+
+  if (mq->n > 0U) {
+    last = mq->heap[mq->n];
+    i    = 0U;
+
+    for (;;) {
+      child = (2U * i) + 1U;
+
+      if (child >= mq->n) {
+        break;
+      }
+      if (((child + 1U) < mq->n) && (MsgQueueBefore (mq, mq->heap[child + 1U], mq->heap[child]) != 0U)) {
+        child++;
+      }
+      if (MsgQueueBefore (mq, mq->heap[child], last) == 0U) {
+        break;
+      }
+      mq->heap[i] = mq->heap[child];
+      i = child;
+    }
+
+    mq->heap[i] = last;
+  }
+}
+
+#endif /* (configUSE_OS2_MSGQUEUE_PRIO == 0) */
+
+/*---------------------------------------------------------------------------*/
+#ifdef FREERTOS_MPOOL_H_
+
+/* Memory pool free list and counters are updated with exclusive access where available */
+#if ((__ARM_ARCH_7M__      == 1U) || \
+     (__ARM_ARCH_7EM__     == 1U) || \
+     (__ARM_ARCH_8M_MAIN__ == 1U) || \
+     (__ARM_ARCH_7A__      == 1U))
+#define MPOOL_EXCLUSIVE_ACCESS    1
+#else
+#define MPOOL_EXCLUSIVE_ACCESS    0
+#endif
+
+/* Static memory pool functions */
+static void  FreeBlock   (MemPool_t *mp, void *block);
+static void *AllocBlock  (MemPool_t *mp);
+static void *CreateBlock (MemPool_t *mp);
+static uint32_t AtomicIncLimit   (volatile uint32_t *mem, uint32_t limit);
+static uint32_t AtomicDecNonZero (volatile uint32_t *mem);
+
+/* Block number (index + 1) to block address and back; blocks are 4-byte aligned */
+#define MPOOL_BLOCK_STRIDE(mp)    MEMPOOL_ARR_SIZE (1U, (mp)->bl_sz)
+#define MPOOL_BLOCK_PTR(mp, num)  ((MemPoolBlock_t *)((mp)->mem_arr + MPOOL_BLOCK_HDR_SIZE + (MPOOL_BLOCK_STRIDE(mp) * ((num) - 1U))))
+#define MPOOL_BLOCK_NUM(mp, ptr)  ((((uint32_t)((uint8_t *)(ptr) - (mp)->mem_arr)) / MPOOL_BLOCK_STRIDE(mp)) + 1U)
+
+#if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+/* Ownership record in front of a block */
+#define MPOOL_BLOCK_OWNER(ptr)    ((MemPoolBlockOwner_t *)((uint8_t *)(ptr) - MPOOL_BLOCK_HDR_SIZE))
+
+/* Owner value of the caller: the running thread, or MPOOL_OWNER_ISR from
+   interrupts and before the kernel runs */
+static uint32_t MemPoolOwnerSelf (void) {
+  uint32_t owner;
+
+  if (IS_IRQ()) {
+    owner = MPOOL_OWNER_ISR;
+  }
+  else {
+    owner = (uint32_t)xTaskGetCurrentTaskHandle();
+
+    if (owner == MPOOL_OWNER_FREE) {
+      owner = MPOOL_OWNER_ISR;
+    }
+  }
+
+  return (owner);
+}
+#endif
+
+osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+  MemPool_t *mp;
+  const char *name;
+  int32_t mem_cb, mem_mp;
+  uint32_t sz;
+  #if (configUSE_OS2_STATIC_POOLS == 1)
+  void *cb_mem;
+  void *mp_mem;
+  uint32_t mp_sz;
+  #endif
+
+  if (IS_IRQ()) {
+    mp = NULL;
+  }
+  else if ((block_count == 0U) || (block_size == 0U) || (block_count > MPOOL_BLOCK_COUNT_MAX)) {
+    mp = NULL;
+  }
+  else {
+    mp = NULL;
+    sz = MEMPOOL_ARR_SIZE (block_count, block_size);
+
+    name = NULL;
+    mem_cb = -1;
+    mem_mp = -1;
+
+    if (attr != NULL) {
+      if (attr->name != NULL) {
+        name = attr->name;
+      }
+
+      if ((attr->cb_mem != NULL) && (attr->cb_size >= sizeof(MemPool_t))) {
+        /* Static control block is provided */
+        mem_cb = 1;
+      }
+      else if ((attr->cb_mem == NULL) && (attr->cb_size == 0U)) {
+        /* Allocate control block memory on heap */
+        mem_cb = 0;
+      }
+
+      if ((attr->mp_mem == NULL) && (attr->mp_size == 0U)) {
+        /* Allocate memory array on heap */
+          mem_mp = 0;
+      }
+      else {
+        if (attr->mp_mem != NULL) {
+          /* Check if array is 4-byte aligned */
+          if (((uint32_t)attr->mp_mem & 3U) == 0U) {
+            /* Check if array big enough */
+            if (attr->mp_size >= sz) {
+              /* Static memory pool array is provided */
+              mem_mp = 1;
+            }
+          }
+        }
+      }
+    }
+    else {
+      /* Attributes not provided, allocate memory on heap */
+      mem_cb = 0;
+      mem_mp = 0;
+    }
+
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    cb_mem = NULL;
+    mp_mem = NULL;
+
+    if ((mem_cb == 0) || (mem_mp == 0)) {
+      /* Take control block and/or block storage from the pool instead of the heap */
+      cb_mem = osPoolAlloc (OS2_POOL_MEMPOOL, name, (mem_mp == 0) ? sz : 0U, &mp_mem, &mp_sz);
+
+      if (cb_mem == NULL) {
+        mem_cb = -1;
+      }
+    }
+
+    if (mem_cb == 0) {
+      mp = cb_mem;
+    } else if (mem_cb == 1) {
+      mp = attr->cb_mem;
+    } else {
+      mp = NULL;
+    }
+    #else
+    if (mem_cb == 0) {
+      mp = pvPortMalloc (sizeof(MemPool_t));
+    } else {
+      mp = attr->cb_mem;
+    }
+    #endif
+
+    if (mp != NULL) {
+      /* Create a semaphore used only to wake threads waiting on an empty pool */
+      #if (configSUPPORT_STATIC_ALLOCATION == 1)
+        mp->sem = xSemaphoreCreateCountingStatic (block_count, 0U, &mp->mem_sem);
+      #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+        mp->sem = xSemaphoreCreateCounting (block_count, 0U);
+      #else
+        mp->sem == NULL;
+      #endif
+
+      if (mp->sem != NULL) {
+        /* Setup memory array */
+        if (mem_mp == 0) {
+          #if (configUSE_OS2_STATIC_POOLS == 1)
+          mp->mem_arr = mp_mem;
+          #else
+          mp->mem_arr = pvPortMalloc (sz);
+          #endif
+        } else {
+          mp->mem_arr = attr->mp_mem;
+        }
+      }
+    }
+
+    if ((mp != NULL) && (mp->mem_arr != NULL)) {
+      /* Memory pool can be created */
+      mp->head    = 0U;
+      mp->mem_sz  = sz;
+      mp->name    = name;
+      mp->bl_sz   = block_size;
+      mp->bl_cnt  = block_count;
+      mp->n       = 0U;
+      mp->used    = 0U;
+      mp->waiters = 0U;
+
+      /* Set heap allocated memory flags */
+      mp->status = MPOOL_STATUS;
+
+      if (mem_cb == 0) {
+        /* Control block on heap */
+        mp->status |= 1U;
+      }
+      if (mem_mp == 0) {
+        /* Memory array on heap */
+        mp->status |= 2U;
+      }
+      #if (configUSE_OS2_STATIC_POOLS == 1)
+      /* Control block and memory array come from the static pool, not the heap */
+      mp->status &= ~3U;
+      if (mem_cb == 0) {
+        /* Control block (and memory array) from pool, released by control block */
+        mp->status |= 4U;
+      }
+      else if (mem_mp == 0) {
+        /* Only memory array from pool, released by memory array */
+        mp->status |= 8U;
+      }
+      #endif
+    }
+    else {
+      /* Memory pool cannot be created, release allocated resources */
+      #if (configUSE_OS2_STATIC_POOLS == 1)
+      osPoolRelease (cb_mem);
+      #else
+      if ((mem_cb == 0) && (mp != NULL)) {
+        /* Free control block memory */
+        vPortFree (mp);
+      }
+      #endif
+      mp = NULL;
+    }
+  }
+
+  return (mp);
+}
+
+const char *osMemoryPoolGetName (osMemoryPoolId_t mp_id) {
+  MemPool_t *mp = (osMemoryPoolId_t)mp_id;
+  const char *p;
+
+  if (IS_IRQ()) {
+    p = NULL;
+  }
+  else if (mp_id == NULL) {
+    p = NULL;
+  }
+  else {
+    p = mp->name;
+  }
+
+  return (p);
+}
+
+void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
+  MemPool_t *mp;
+  void *block;
+  TimeOut_t tmo;
+  TickType_t wait;
+
+  if (mp_id == NULL) {
+    /* Invalid input parameters */
+    block = NULL;
+  }
+  else if (IS_IRQ() && (timeout != 0U)) {
+    /* Interrupts cannot wait for a block */
+    block = NULL;
+  }
+  else {
+    block = NULL;
+
+    mp = (MemPool_t *)mp_id;
+
+    if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
+      /* Get a block from the free-list, without entering the kernel */
+      block = AllocBlock(mp);
+
+      if (block == NULL) {
+        /* List of free blocks is empty, 'create' new block */
+        block = CreateBlock(mp);
+      }
+
+      if ((block == NULL) && (timeout != 0U)) {
+        /* Pool is exhausted, wait on the semaphore until a block is freed */
+        wait = (TickType_t)timeout;
+        vTaskSetTimeOutState (&tmo);
+
+        (void)AtomicIncLimit (&mp->waiters, 0xFFFFFFFFU);
+
+        for (;;) {
+          /* Retry after announcing the wait, a block freed meanwhile gives no signal */
+          block = AllocBlock(mp);
+
+          if ((block != NULL) || ((mp->status & MPOOL_STATUS) != MPOOL_STATUS)) {
+            break;
+          }
+          if (xTaskCheckForTimeOut (&tmo, &wait) != pdFALSE) {
+            break;
+          }
+          if (xSemaphoreTake (mp->sem, wait) != pdTRUE) {
+            break;
+          }
+        }
 
-          /* Add block to the list of free blocks */
-          FreeBlock(mp, block);
+        (void)AtomicDecNonZero (&mp->waiters);
+      }
 
-          taskEXIT_CRITICAL();
+      if (block != NULL) {
+        (void)AtomicIncLimit (&mp->used, mp->bl_cnt);
+
+        #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+        MPOOL_BLOCK_OWNER(block)->owner = MemPoolOwnerSelf();
+        #endif
+      }
+    }
+  }
+
+  return (block);
+}
+
+osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
+  MemPool_t *mp;
+  osStatus_t stat;
+  BaseType_t yield;
+
+  if ((mp_id == NULL) || (block == NULL)) {
+    /* Invalid input parameters */
+    stat = osErrorParameter;
+  }
+  else {
+    mp = (MemPool_t *)mp_id;
+
+    if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
+      /* Invalid object status */
+      stat = osErrorResource;
+    }
+    else if ((block < (void *)&mp->mem_arr[0]) || (block > (void*)&mp->mem_arr[mp->mem_sz-1])) {
+      /* Block pointer outside of memory array area */
+      stat = osErrorParameter;
+    }
+    #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+    else if (block != (void *)MPOOL_BLOCK_PTR(mp, MPOOL_BLOCK_NUM(mp, block))) {
+      /* Block pointer does not point to the start of a block */
+      configASSERT (0);
+      stat = osErrorParameter;
+    }
+    else if (MPOOL_BLOCK_OWNER(block)->owner == MPOOL_OWNER_FREE) {
+      /* Block is already free */
+      configASSERT (0);
+      stat = osErrorResource;
+    }
+    else if ((MPOOL_BLOCK_OWNER(block)->owner & MPOOL_OWNER_QUEUE) != 0U) {
+      /* Block is still waiting in a message queue */
+      configASSERT (0);
+      stat = osErrorResource;
+    }
+    #endif
+    else if (AtomicDecNonZero (&mp->used) == 0U) {
+      /* All blocks are already free */
+      stat = osErrorResource;
+    }
+    else {
+      stat = osOK;
 
-          xSemaphoreGive (mp->sem);
+      #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+      MPOOL_BLOCK_OWNER(block)->owner = MPOOL_OWNER_FREE;
+      #endif
+
+      /* Add block to the list of free blocks */
+      FreeBlock(mp, block);
+
+      /* Enter the kernel only when a thread waits for a block */
+      if (mp->waiters != 0U) {
+        if (IS_IRQ()) {
+          yield = pdFALSE;
+          (void)xSemaphoreGiveFromISR (mp->sem, &yield);
+          portYIELD_FROM_ISR (yield);
+        }
+        else {
+          (void)xSemaphoreGive (mp->sem);
         }
       }
     }
@@ -2266,13 +3485,7 @@ uint32_t osMemoryPoolGetCount (osMemoryPoolId_t mp_id) {
       n = 0U;
     }
     else {
-      if (IS_IRQ()) {
-        n = uxSemaphoreGetCountFromISR (mp->sem);
-      } else {
-        n = uxSemaphoreGetCount        (mp->sem);
-      }
-
-      n = mp->bl_cnt - n;
+      n = mp->used;
     }
   }
 
@@ -2296,11 +3509,7 @@ uint32_t osMemoryPoolGetSpace (osMemoryPoolId_t mp_id) {
       n = 0U;
     }
     else {
-      if (IS_IRQ()) {
-        n = uxSemaphoreGetCountFromISR (mp->sem);
-      } else {
-        n = uxSemaphoreGetCount        (mp->sem);
-      }
+      n = mp->bl_cnt - mp->used;
     }
   }
 
@@ -2322,15 +3531,20 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
   else {
     mp = (MemPool_t *)mp_id;
 
+    #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+    /* Every block must have been given back before the pool goes away */
+    configASSERT (mp->used == 0U);
+    #endif
+
     taskENTER_CRITICAL();
 
     /* Invalidate control block status */
-    mp->status  = mp->status & 3U;
+    mp->status  = mp->status & 0xFU;
 
     /* Wake-up tasks waiting for pool semaphore */
     while (xSemaphoreGive (mp->sem) == pdTRUE);
 
-    mp->head    = NULL;
+    mp->head    = 0U;
     mp->bl_sz   = 0U;
     mp->bl_cnt  = 0U;
 
@@ -2342,6 +3556,16 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
       /* Memory pool control block allocated on heap */
       vPortFree (mp);
     }
+    #if (configUSE_OS2_STATIC_POOLS == 1)
+    if ((mp->status & 4U) != 0U) {
+      /* Memory pool control block taken from the static pool */
+      osPoolRelease (mp);
+    }
+    else if ((mp->status & 8U) != 0U) {
+      /* Memory pool array taken from the static pool */
+      osPoolRelease (mp->mem_arr);
+    }
+    #endif
 
     taskEXIT_CRITICAL();
 
@@ -2356,31 +3580,49 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
 */
 static void *CreateBlock (MemPool_t *mp) {
   MemPoolBlock_t *p = NULL;
+  uint32_t n;
+
+  /* Claim the block index, unless all blocks were created already */
+  n = AtomicIncLimit (&mp->n, mp->bl_cnt);
 
-  if (mp->n < mp->bl_cnt) {
+  if (n < mp->bl_cnt) {
     /* Unallocated blocks exist, set pointer to new block */
-    p = (void *)(mp->mem_arr + (mp->bl_sz * mp->n));
+    p = MPOOL_BLOCK_PTR(mp, n + 1U);
 
-    /* Increment block index */
-    mp->n += 1U;
+    #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+    MPOOL_BLOCK_OWNER(p)->pool  = mp;
+    MPOOL_BLOCK_OWNER(p)->owner = MPOOL_OWNER_FREE;
+    #endif
   }
 
   return (p);
 }
 
+#if (MPOOL_EXCLUSIVE_ACCESS == 1)
 /*
   Allocate a block by reading the list of free blocks.
+
+  The head is replaced with a load/store exclusive pair. An interrupt or
+  context switch between the two clears the exclusive monitor, so the
+  store fails and the pop is retried with the new head.
 */
 static void *AllocBlock (MemPool_t *mp) {
-  MemPoolBlock_t *p = NULL;
+  MemPoolBlock_t *p;
+  uint32_t head;
 
-  if (mp->head != NULL) {
-    /* List of free block exists, get head block */
-    p = mp->head;
+  do {
+    head = __LDREXW (&mp->head);
 
-    /* Head block is now next on the list */
-    mp->head = p->next;
+    if ((head & MPOOL_HEAD_BLOCK_MSK) == 0U) {
+      /* List of free blocks is empty */
+      __CLREX();
+      p = NULL;
+      break;
+    }
+
+    p = MPOOL_BLOCK_PTR(mp, head & MPOOL_HEAD_BLOCK_MSK);
   }
+  while (__STREXW (((head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_BLOCK_MSK) | p->next, &mp->head) != 0U);
 
   return (p);
 }
@@ -2390,12 +3632,242 @@ static void *AllocBlock (MemPool_t *mp) {
 */
 static void FreeBlock (MemPool_t *mp, void *block) {
   MemPoolBlock_t *p = block;
+  uint32_t head;
+
+  for (;;) {
+    /* Link the block to the current head before the exclusive access, since
+       a store inside it may clear the monitor on some implementations */
+    head    = mp->head;
+    p->next = head & MPOOL_HEAD_BLOCK_MSK;
+
+    if (__LDREXW (&mp->head) != head) {
+      /* Head changed in the meantime */
+      __CLREX();
+    }
+    else if (__STREXW (((head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_BLOCK_MSK) | MPOOL_BLOCK_NUM(mp, p), &mp->head) == 0U) {
+      break;
+    }
+  }
+}
+
+/*
+  Increment value unless it equals limit, return the previous value.
+*/
+static uint32_t AtomicIncLimit (volatile uint32_t *mem, uint32_t limit) {
+  uint32_t val;
+
+  do {
+    val = __LDREXW (mem);
+
+    if (val == limit) {
+      __CLREX();
+      break;
+    }
+  }
+  while (__STREXW (val + 1U, mem) != 0U);
+
+  return (val);
+}
+
+/*
+  Decrement value unless it is zero, return the previous value.
+*/
+static uint32_t AtomicDecNonZero (volatile uint32_t *mem) {
+  uint32_t val;
+
+  do {
+    val = __LDREXW (mem);
+
+    if (val == 0U) {
+      __CLREX();
+      break;
+    }
+  }
+  while (__STREXW (val - 1U, mem) != 0U);
+
+  return (val);
+}
+
+#else /* (MPOOL_EXCLUSIVE_ACCESS == 0) */
+/*
+  Cores without exclusive access update the free list and counters with
+  interrupts masked; this is also valid from interrupt context.
+*/
+static void *AllocBlock (MemPool_t *mp) {
+  MemPoolBlock_t *p = NULL;
+  uint32_t isrm;
+
+  isrm = taskENTER_CRITICAL_FROM_ISR();
+
+  if ((mp->head & MPOOL_HEAD_BLOCK_MSK) != 0U) {
+    /* List of free block exists, get head block */
+    p = MPOOL_BLOCK_PTR(mp, mp->head & MPOOL_HEAD_BLOCK_MSK);
+
+    /* Head block is now next on the list */
+    mp->head = ((mp->head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_BLOCK_MSK) | p->next;
+  }
+
+  taskEXIT_CRITICAL_FROM_ISR(isrm);
+
+  return (p);
+}
+
+static void FreeBlock (MemPool_t *mp, void *block) {
+  MemPoolBlock_t *p = block;
+  uint32_t isrm;
+
+  isrm = taskENTER_CRITICAL_FROM_ISR();
 
   /* Store current head into block memory space */
-  p->next = mp->head;
+  p->next = mp->head & MPOOL_HEAD_BLOCK_MSK;
 
   /* Store current block as new head */
-  mp->head = p;
+  mp->head = ((mp->head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_BLOCK_MSK) | MPOOL_BLOCK_NUM(mp, p);
+
+  taskEXIT_CRITICAL_FROM_ISR(isrm);
+}
+
+static uint32_t AtomicIncLimit (volatile uint32_t *mem, uint32_t limit) {
+  uint32_t val;
+  uint32_t isrm;
+
+  isrm = taskENTER_CRITICAL_FROM_ISR();
+
+  val = *mem;
+  if (val != limit) {
+    *mem = val + 1U;
+  }
+
+  taskEXIT_CRITICAL_FROM_ISR(isrm);
+
+  return (val);
+}
+
+static uint32_t AtomicDecNonZero (volatile uint32_t *mem) {
+  uint32_t val;
+  uint32_t isrm;
+
+  isrm = taskENTER_CRITICAL_FROM_ISR();
+
+  val = *mem;
+  if (val != 0U) {
+    *mem = val - 1U;
+  }
+
+  taskEXIT_CRITICAL_FROM_ISR(isrm);
+
+  return (val);
+}
+#endif /* (MPOOL_EXCLUSIVE_ACCESS == 1) */
+
+/*---------------------------------------------------------------------------*/
+
+osStatus_t osMessageQueuePutBlock (osMessageQueueId_t mq_id, void *block, uint8_t msg_prio, uint32_t timeout) {
+  osStatus_t stat;
+#if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+  MemPoolBlockOwner_t *rec;
+  uint32_t owner;
+#endif
+
+  if ((mq_id == NULL) || (block == NULL)) {
+    /* Invalid input parameters */
+    stat = osErrorParameter;
+  }
+  else {
+  #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+    rec   = MPOOL_BLOCK_OWNER(block);
+    owner = MemPoolOwnerSelf();
+
+    if (osMessageQueueGetMsgSize (mq_id) != sizeof(void *)) {
+      /* Queue does not carry block pointers */
+      configASSERT (0);
+      stat = osErrorParameter;
+    }
+    else if ((rec->pool == NULL) || ((rec->pool->status & MPOOL_STATUS) != MPOOL_STATUS)) {
+      /* Not a memory pool block */
+      configASSERT (0);
+      stat = osErrorParameter;
+    }
+    else if (rec->owner != owner) {
+      /* Caller does not own the block (free, queued or held elsewhere) */
+      configASSERT (0);
+      stat = osErrorResource;
+    }
+    else {
+      /* Hand the block to the queue before a receiver can see it */
+      rec->owner = (uint32_t)mq_id | MPOOL_OWNER_QUEUE;
+
+      stat = osMessageQueuePut (mq_id, &block, msg_prio, timeout);
+
+      if (stat != osOK) {
+        /* Not enqueued, the caller keeps the block */
+        rec->owner = owner;
+      }
+    }
+  #else
+    stat = osMessageQueuePut (mq_id, &block, msg_prio, timeout);
+  #endif
+  }
+
+  return (stat);
+}
+
+void *osMessageQueueGetBlock (osMessageQueueId_t mq_id, uint8_t *msg_prio, uint32_t timeout) {
+  void *block;
+#if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+  MemPoolBlockOwner_t *rec;
+#endif
+
+  if (osMessageQueueGet (mq_id, &block, msg_prio, timeout) != osOK) {
+    block = NULL;
+  }
+  #if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+  else {
+    rec = MPOOL_BLOCK_OWNER(block);
+
+    /* Block must have been put with osMessageQueuePutBlock into this queue */
+    configASSERT (rec->owner == ((uint32_t)mq_id | MPOOL_OWNER_QUEUE));
+
+    rec->owner = MemPoolOwnerSelf();
+  }
+  #endif
+
+  return (block);
+}
+
+uint32_t osMemoryPoolGetOwnedCount (osMemoryPoolId_t mp_id, void *owner) {
+  uint32_t cnt;
+#if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+  MemPool_t *mp = (MemPool_t *)mp_id;
+  uint32_t num, n, rec;
+#endif
+
+  cnt = 0U;
+
+#if (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+  if ((mp != NULL) && ((mp->status & MPOOL_STATUS) == MPOOL_STATUS)) {
+    n = mp->n;
+
+    /* Only blocks handed out at least once carry an ownership record */
+    for (num = 1U; num <= n; num++) {
+      rec = MPOOL_BLOCK_OWNER(MPOOL_BLOCK_PTR(mp, num))->owner;
+
+      if (owner == NULL) {
+        if (rec == MPOOL_OWNER_ISR) {
+          cnt++;
+        }
+      }
+      else if ((rec & ~MPOOL_OWNER_QUEUE) == (uint32_t)owner) {
+        cnt++;
+      }
+    }
+  }
+#else
+  (void)mp_id;
+  (void)owner;
+#endif
+
+  return (cnt);
 }
 #endif /* FREERTOS_MPOOL_H_ */
 /*---------------------------------------------------------------------------*/
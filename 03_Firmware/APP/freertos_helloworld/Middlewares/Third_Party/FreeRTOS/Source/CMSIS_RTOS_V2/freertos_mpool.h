@@ -30,21 +30,54 @@
 /* Memory Pool implementation definitions */
 #define MPOOL_STATUS              0x5EED0000U
 
+/*
+  Free list head: number of the head block (index + 1, 0 when the list is empty)
+  in the low half, and a tag incremented on every change in the high half, so
+  that a head value read before a pop/push/pop sequence never matches again.
+*/
+#define MPOOL_HEAD_BLOCK_MSK      0x0000FFFFU
+#define MPOOL_HEAD_TAG_INC        0x00010000U
+
+/* Largest number of blocks the free list head can address */
+#define MPOOL_BLOCK_COUNT_MAX     MPOOL_HEAD_BLOCK_MSK
+
 /* Memory Block header */
 typedef struct {
-  void *next;                   /* Pointer to next block  */
+  uint32_t next;                /* Number of next block    */
 } MemPoolBlock_t;
 
+#if defined(configUSE_OS2_MSGBLOCK_DEBUG) && (configUSE_OS2_MSGBLOCK_DEBUG == 1)
+/*
+  Block ownership record, kept in front of every block when message block
+  debugging is enabled. The owner is the thread holding the block, the message
+  queue it was put into (tagged with MPOOL_OWNER_QUEUE) or MPOOL_OWNER_ISR.
+*/
+typedef struct {
+  struct MemPoolDef_t *pool;    /* Pool the block belongs to */
+  uint32_t             owner;   /* Current block owner       */
+} MemPoolBlockOwner_t;
+
+#define MPOOL_OWNER_FREE          0U
+#define MPOOL_OWNER_QUEUE         1U
+#define MPOOL_OWNER_ISR           2U
+
+#define MPOOL_BLOCK_HDR_SIZE      (sizeof(MemPoolBlockOwner_t))
+#else
+#define MPOOL_BLOCK_HDR_SIZE      0U
+#endif
+
 /* Memory Pool control block */
 typedef struct MemPoolDef_t {
-  MemPoolBlock_t    *head;      /* Pointer to head block   */
-  SemaphoreHandle_t  sem;       /* Pool semaphore handle   */
+  volatile uint32_t  head;      /* Tagged free list head   */
+  SemaphoreHandle_t  sem;       /* Signals blocked threads */
   uint8_t           *mem_arr;   /* Pool memory array       */
   uint32_t           mem_sz;    /* Pool memory array size  */
   const char        *name;      /* Pointer to name string  */
   uint32_t           bl_sz;     /* Size of a single block  */
   uint32_t           bl_cnt;    /* Number of blocks        */
-  uint32_t           n;         /* Block allocation index  */
+  volatile uint32_t  n;         /* Block allocation index  */
+  volatile uint32_t  used;      /* Number of used blocks   */
+  volatile uint32_t  waiters;   /* Threads waiting for a block */
   volatile uint32_t  status;    /* Object status flags     */
 #if (configSUPPORT_STATIC_ALLOCATION == 1)
   StaticSemaphore_t  mem_sem;   /* Semaphore object memory */
@@ -58,6 +91,6 @@ typedef struct MemPoolDef_t {
 #define MEMPOOL_CB_SIZE         (sizeof(StaticMemPool_t))
 
 /* Define size of the byte array required to create count of blocks of given size */
-#define MEMPOOL_ARR_SIZE(bl_count, bl_size) (((((bl_size) + (4 - 1)) / 4) * 4)*(bl_count))
+#define MEMPOOL_ARR_SIZE(bl_count, bl_size) ((((((bl_size) + (4 - 1)) / 4) * 4) + MPOOL_BLOCK_HDR_SIZE)*(bl_count))
 
 #endif /* FREERTOS_MPOOL_H_ */
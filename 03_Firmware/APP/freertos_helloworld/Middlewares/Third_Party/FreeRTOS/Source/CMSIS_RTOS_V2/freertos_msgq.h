@@ -0,0 +1,59 @@
+/* --------------------------------------------------------------------------
+ *      Name:    freertos_msgq.h
+ *      Purpose: Priority ordered osMessageQueue for the CMSIS-RTOS2 wrapper
+ *
+ *      When configUSE_OS2_MSGQUEUE_PRIO is 1, messages are delivered highest
+ *      msg_prio first and in FIFO order within the same msg_prio. Queued
+ *      messages are ordered by a binary heap of slot indexes; two counting
+ *      semaphores provide the blocking put and get.
+ *---------------------------------------------------------------------------*/
+
+#ifndef FREERTOS_MSGQ_H_
+#define FREERTOS_MSGQ_H_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+/* Message Queue implementation definitions */
+#define MSGQ_STATUS               0x5EEDA000U
+
+/* Message slot header, followed by the message data */
+typedef struct {
+  uint32_t seq;                 /* Put order, or next free slot while free */
+  uint32_t prio;                /* Message priority        */
+} MsgQueueHdr_t;
+
+/* Message Queue control block */
+typedef struct MsgQueueDef_t {
+  SemaphoreHandle_t  sem_msg;   /* Queued messages semaphore */
+  SemaphoreHandle_t  sem_spc;   /* Free slots semaphore    */
+  uint32_t          *heap;      /* Queued slots, binary heap ordered */
+  uint8_t           *msg_arr;   /* Message slots           */
+  const char        *name;      /* Pointer to name string  */
+  uint32_t           msg_cnt;   /* Number of slots         */
+  uint32_t           msg_sz;    /* Size of a message       */
+  uint32_t           slot_sz;   /* Size of a slot          */
+  uint32_t           n;         /* Number of queued messages */
+  uint32_t           free;      /* First free slot         */
+  uint32_t           seq;       /* Next put sequence number */
+  volatile uint32_t  status;    /* Object status flags     */
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+  StaticSemaphore_t  mem_sem_msg; /* Semaphore object memory */
+  StaticSemaphore_t  mem_sem_spc; /* Semaphore object memory */
+#endif
+} MsgQueue_t;
+
+/* No need to hide static object type, just align to coding style */
+#define StaticMsgQueue_t        MsgQueue_t
+
+/* Define message queue control block size */
+#define MSGQUEUE_CB_SIZE        (sizeof(StaticMsgQueue_t))
+
+/* Define size of a message slot holding a message of given size */
+#define MSGQUEUE_SLOT_SIZE(msg_size) (sizeof(MsgQueueHdr_t) + ((((msg_size) + (4 - 1)) / 4) * 4))
+
+/* Define size of the byte array required to create count of messages of given size */
+#define MSGQUEUE_ARR_SIZE(msg_count, msg_size) ((msg_count) * (4 + MSGQUEUE_SLOT_SIZE(msg_size)))
+
+#endif /* FREERTOS_MSGQ_H_ */
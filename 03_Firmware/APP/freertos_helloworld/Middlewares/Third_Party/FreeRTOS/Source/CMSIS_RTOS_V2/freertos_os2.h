@@ -84,6 +84,55 @@
 #define configUSE_OS2_MUTEX                   configUSE_MUTEXES
 #endif
 
+/*
+  Option to create CMSIS-RTOS2 objects that have no caller supplied memory from the
+  static object table (os2_pool_cfg.h) instead of the FreeRTOS heap.
+*/
+#ifndef configUSE_OS2_STATIC_POOLS
+#define configUSE_OS2_STATIC_POOLS            0
+#endif
+
+/*
+  Option to deliver osMessageQueue messages in msg_prio order (highest first, FIFO
+  within the same priority) instead of ignoring msg_prio.
+*/
+#ifndef configUSE_OS2_MSGQUEUE_PRIO
+#define configUSE_OS2_MSGQUEUE_PRIO           0
+#endif
+
+/*
+  Option to track the owner of every memory pool block and check ownership on
+  osMessageQueuePutBlock/GetBlock and osMemoryPoolFree (debug builds). Costs 8
+  bytes per block.
+*/
+#ifndef configUSE_OS2_MSGBLOCK_DEBUG
+#define configUSE_OS2_MSGBLOCK_DEBUG          0
+#endif
+
+/*
+  Option to collect per-mutex contention statistics in osMutexAcquire and
+  osMutexRelease (freertos_os2_mprof.h). Up to configOS2_MUTEX_PROFILE_SLOTS
+  mutexes are profiled and the last configOS2_MUTEX_PROFILE_EVENTS priority
+  inheritance events are kept. Times are in configOS2_MUTEX_PROFILE_CLOCK()
+  counts, configOS2_MUTEX_PROFILE_CLOCK_HZ() per second.
+*/
+#ifndef configUSE_OS2_MUTEX_PROFILE
+#define configUSE_OS2_MUTEX_PROFILE           0
+#endif
+
+#ifndef configOS2_MUTEX_PROFILE_SLOTS
+#define configOS2_MUTEX_PROFILE_SLOTS         16
+#endif
+
+#ifndef configOS2_MUTEX_PROFILE_EVENTS
+#define configOS2_MUTEX_PROFILE_EVENTS        8
+#endif
+
+#ifndef configOS2_MUTEX_PROFILE_CLOCK
+#define configOS2_MUTEX_PROFILE_CLOCK()       ((uint32_t)xTaskGetTickCount())
+#define configOS2_MUTEX_PROFILE_CLOCK_HZ()    ((uint32_t)configTICK_RATE_HZ)
+#endif
+
 
 /*
   CMSIS-RTOS2 FreeRTOS configuration check (FreeRTOSConfig.h).
@@ -281,6 +330,33 @@
   #endif
 #endif
 
+#if (configUSE_OS2_STATIC_POOLS == 1)
+  #if (configSUPPORT_STATIC_ALLOCATION == 0)
+    /*
+      CMSIS-RTOS2 static object pools create every object with the FreeRTOS xxxCreateStatic
+      functions.
+      Set #define configSUPPORT_STATIC_ALLOCATION 1 to fix this error.
+    */
+    #error "Definition configSUPPORT_STATIC_ALLOCATION must equal 1 to use static object pools."
+  #endif
+  #if (configUSE_OS2_TIMER == 1) && (INCLUDE_xTimerPendFunctionCall == 0)
+    /*
+      osTimerDelete returns a pooled timer from the timer daemon task, after the delete command
+      has been processed, using xTimerPendFunctionCall.
+      Set #define INCLUDE_xTimerPendFunctionCall 1 to fix this error.
+    */
+    #error "Definition INCLUDE_xTimerPendFunctionCall must equal 1 to use static object pools."
+  #endif
+#endif
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0) && (configUSE_OS2_THREAD_ENUMERATE == 1)
+  /*
+    CMSIS-RTOS2 function osThreadEnumerate allocates its temporary task status array on the heap.
+    Set #define configUSE_OS2_THREAD_ENUMERATE 0 to fix this error.
+  */
+  #error "Definition configUSE_OS2_THREAD_ENUMERATE must be zero when dynamic allocation is disabled."
+#endif
+
 #if (configUSE_16_BIT_TICKS == 1)
   /*
     CMSIS-RTOS2 wrapper for FreeRTOS relies on 32-bit tick timer which is also optimal on
@@ -298,13 +374,10 @@
   */
   #error "Definition configMAX_PRIORITIES must equal 56 to implement Thread Management API."
 #endif
-#if (configUSE_PORT_OPTIMISED_TASK_SELECTION != 0)
-  /*
-    CMSIS-RTOS2 requires handling of 56 different priorities (see osPriority_t) while FreeRTOS port
-    optimised selection for Cortex core only handles 32 different priorities.
-    Set #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0 to fix this error.
-  */
-  #error "Definition configUSE_PORT_OPTIMISED_TASK_SELECTION must be zero to implement Thread Management API."
-#endif
+/*
+  Note: configUSE_PORT_OPTIMISED_TASK_SELECTION may be set to 1. The Cortex port bit map only
+        covers 32 priorities, so with the 56 CMSIS-RTOS2 priorities the kernel switches to its
+        own two level ready bit map (see tasks.c) and still selects the next task in constant time.
+*/
 
 #endif /* FREERTOS_OS2_H_ */
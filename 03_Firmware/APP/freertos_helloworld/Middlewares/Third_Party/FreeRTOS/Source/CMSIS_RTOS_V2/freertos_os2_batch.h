@@ -0,0 +1,44 @@
+/* --------------------------------------------------------------------------
+ *      Name:    freertos_os2_batch.h
+ *      Purpose: Batched wakeups for the CMSIS-RTOS2 wrapper
+ *
+ *      A receiver that handles messages or event flags in bursts sets a
+ *      wake threshold: it is then woken once count messages are queued or
+ *      count osEventFlagsSet calls have been made, rather than on each one.
+ *      Puts and sets from interrupts below the threshold request no context
+ *      switch. A batch that does not fill up is delivered latency ticks
+ *      after its first message or set, so the receiver can wait with
+ *      osWaitForever and is not woken while nothing arrives. The latency is
+ *      a kernel timer armed in the timing wheel by the first event of each
+ *      batch, from a thread or an interrupt.
+ *
+ *      Requires configUSE_BATCHED_WAKEUP set to 1; otherwise both functions
+ *      return osError. A latency other than osWaitForever also needs
+ *      configUSE_TIMERS, configUSE_TIMER_WHEEL and dynamic allocation
+ *      (tmrBATCH_LATENCY_POSSIBLE), or osError is returned.
+ *---------------------------------------------------------------------------*/
+
+#ifndef FREERTOS_OS2_BATCH_H_
+#define FREERTOS_OS2_BATCH_H_
+
+#include <stdint.h>
+#include "cmsis_os2.h"
+
+/*
+  Wake a thread blocked in osMessageQueueGet only once count messages are
+  queued, count being from 1 (the default) up to the queue capacity, or
+  latency ticks after the first message of the batch. latency is at least 1,
+  or osWaitForever (the default) to wait for count messages. Returns
+  osErrorNoMemory if the latency timer could not be created.
+*/
+extern osStatus_t osMessageQueueSetWakeThreshold (osMessageQueueId_t mq_id, uint32_t count, uint32_t latency);
+
+/*
+  Check the threads blocked in osEventFlagsWait only on every count-th call
+  to osEventFlagsSet, count being at least 1 (the default), or latency ticks
+  after the first call of the batch, as for message queues. Flags are set at
+  once; only the wakeup is deferred.
+*/
+extern osStatus_t osEventFlagsSetWakeThreshold (osEventFlagsId_t ef_id, uint32_t count, uint32_t latency);
+
+#endif /* FREERTOS_OS2_BATCH_H_ */
@@ -0,0 +1,77 @@
+/* --------------------------------------------------------------------------
+ *      Name:    freertos_os2_mprof.h
+ *      Purpose: Mutex contention profiling for the CMSIS-RTOS2 wrapper
+ *
+ *      osMutexAcquire first tries to take the mutex without waiting. When
+ *      that succeeds, the uncontended path costs a slot lookup, a counter
+ *      and a clock read. Otherwise the acquisition is counted as contended,
+ *      its wait is timed, and if the waiter outranks the owner the priority
+ *      inheritance that follows is logged with both tasks. osMutexRelease
+ *      records how long the mutex was held.
+ *
+ *      Only mutexes created with osMutexNew are profiled, the first
+ *      configOS2_MUTEX_PROFILE_SLOTS of them. Most statistics are updated
+ *      by the task that holds the mutex, so they need no lock of their own;
+ *      timeouts and inheritances are counted in a critical section.
+ *
+ *      Requires configUSE_OS2_MUTEX_PROFILE set to 1; otherwise every
+ *      function returns osError.
+ *---------------------------------------------------------------------------*/
+
+#ifndef FREERTOS_OS2_MPROF_H_
+#define FREERTOS_OS2_MPROF_H_
+
+#include <stdint.h>
+#include "cmsis_os2.h"
+
+#define osMutexProfileNameLen     16U
+
+/* Statistics of one mutex. Times are in profile clock counts. */
+typedef struct {
+  osMutexId_t mutex_id;
+  const char *name;               ///< osMutexAttr_t name, may be NULL
+  uint32_t    acquired;           ///< Successful acquisitions, recursive ones included
+  uint32_t    contended;          ///< Acquisitions that waited for the mutex
+  uint32_t    timeouts;           ///< Waits that ended without the mutex
+  uint32_t    inherits;           ///< Waits that raised the owner's priority
+  uint64_t    wait_total;         ///< Sum of the contended waits
+  uint32_t    wait_max;
+  uint32_t    hold_max;
+} osMutexProfile_t;
+
+/* One priority inheritance: waiter blocked on a mutex held by a lower
+   priority owner, which then ran at the waiter's priority. */
+typedef struct {
+  osMutexId_t mutex_id;
+  const char *name;
+  uint32_t    time;               ///< Profile clock when the waiter blocked
+  char        owner[osMutexProfileNameLen];
+  char        waiter[osMutexProfileNameLen];
+  uint8_t     owner_prio;         ///< Owner's priority before inheriting
+  uint8_t     waiter_prio;
+} osMutexInheritEvent_t;
+
+/*
+  Copy the statistics of the index-th profiled mutex, counting from 0.
+  Returns osErrorResource past the last one.
+*/
+extern osStatus_t osMutexProfileGet (uint32_t index, osMutexProfile_t *profile);
+
+/*
+  Copy the index-th most recent inheritance event, 0 being the latest.
+  Returns osErrorResource past the oldest one kept.
+*/
+extern osStatus_t osMutexProfileGetInherit (uint32_t index, osMutexInheritEvent_t *event);
+
+/*
+  Clock rate of the profile times, in counts per second.
+*/
+extern uint32_t osMutexProfileClockHz (void);
+
+/*
+  Zero every statistic and forget the inheritance events. The mutexes stay
+  profiled.
+*/
+extern osStatus_t osMutexProfileReset (void);
+
+#endif /* FREERTOS_OS2_MPROF_H_ */
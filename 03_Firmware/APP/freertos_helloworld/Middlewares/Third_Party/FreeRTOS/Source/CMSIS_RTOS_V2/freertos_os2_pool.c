@@ -0,0 +1,188 @@
+/* --------------------------------------------------------------------------
+ *      Name:    freertos_os2_pool.c
+ *      Purpose: Static object pools for the CMSIS-RTOS2 wrapper
+ *
+ *      Every line of OS2_POOL_TABLE (os2_pool_cfg.h) expands to its own named
+ *      static objects, so the whole RTOS object budget is visible in the
+ *      linker map, and the build fails if it exceeds OS2_POOL_BUDGET.
+ *---------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "FreeRTOS.h"                   // ARM.FreeRTOS::RTOS:Core
+#include "task.h"                       // ARM.FreeRTOS::RTOS:Core
+#include "timers.h"                     // ARM.FreeRTOS::RTOS:Timers
+#include "event_groups.h"               // ARM.FreeRTOS::RTOS:Event Groups
+#include "semphr.h"                     // ARM.FreeRTOS::RTOS:Core
+
+#include "freertos_mpool.h"             // osMemoryPool definitions
+#include "freertos_msgq.h"              // osMessageQueue definitions
+#include "freertos_os2.h"               // Configuration check and setup
+#include "freertos_os2_pool.h"          // Static object pool definitions
+
+#if (configUSE_OS2_STATIC_POOLS == 1)
+
+#include "os2_pool_cfg.h"               // Application object table
+
+/* Number of 32-bit words needed to hold n bytes */
+#define POOL_WORDS(n)             (((uint32_t)(n) + 3U) / 4U)
+
+/* Object storage, one set of named objects per table line */
+#define POOL_THREAD_MEM(name, stack_size)                                     \
+  static StaticTask_t       os2_tcb_##name;                                   \
+  static StackType_t        os2_stack_##name[POOL_WORDS(stack_size)];
+#define POOL_TIMER_MEM(name)                                                  \
+  static StaticTimer_t      os2_tmr_##name;                                   \
+  static void              *os2_tmr_callb_##name[2];
+#define POOL_EVENTFLAGS_MEM(name)                                             \
+  static StaticEventGroup_t os2_evf_##name;
+#define POOL_MUTEX_MEM(name)                                                  \
+  static StaticSemaphore_t  os2_mtx_##name;
+#define POOL_SEMAPHORE_MEM(name)                                              \
+  static StaticSemaphore_t  os2_sem_##name;
+#if (configUSE_OS2_MSGQUEUE_PRIO == 1)
+#define POOL_MQ_CB_t              MsgQueue_t
+#define POOL_MQ_ARR_SIZE(msg_count, msg_size) MSGQUEUE_ARR_SIZE(msg_count, msg_size)
+#else
+#define POOL_MQ_CB_t              StaticQueue_t
+#define POOL_MQ_ARR_SIZE(msg_count, msg_size) ((msg_count) * (msg_size))
+#endif
+#define POOL_MSGQUEUE_MEM(name, msg_count, msg_size)                          \
+  static POOL_MQ_CB_t       os2_mq_##name;                                    \
+  static uint32_t           os2_mq_mem_##name[POOL_WORDS(POOL_MQ_ARR_SIZE(msg_count, msg_size))];
+#define POOL_MEMPOOL_MEM(name, block_count, block_size)                       \
+  static MemPool_t          os2_mp_##name;                                    \
+  static uint32_t           os2_mp_mem_##name[POOL_WORDS(MEMPOOL_ARR_SIZE(block_count, block_size))];
+
+OS2_POOL_TABLE(POOL_THREAD_MEM, POOL_TIMER_MEM, POOL_EVENTFLAGS_MEM, POOL_MUTEX_MEM,
+               POOL_SEMAPHORE_MEM, POOL_MSGQUEUE_MEM, POOL_MEMPOOL_MEM)
+
+/* Total RAM used by the table */
+#define POOL_THREAD_SIZE(name, stack_size)                                    \
+  + sizeof(StaticTask_t) + (POOL_WORDS(stack_size) * 4U)
+#define POOL_TIMER_SIZE(name)                                                 \
+  + sizeof(StaticTimer_t) + (2U * sizeof(void *))
+#define POOL_EVENTFLAGS_SIZE(name)                                            \
+  + sizeof(StaticEventGroup_t)
+#define POOL_MUTEX_SIZE(name)                                                 \
+  + sizeof(StaticSemaphore_t)
+#define POOL_SEMAPHORE_SIZE(name)                                             \
+  + sizeof(StaticSemaphore_t)
+#define POOL_MSGQUEUE_SIZE(name, msg_count, msg_size)                         \
+  + sizeof(POOL_MQ_CB_t) + (POOL_WORDS(POOL_MQ_ARR_SIZE(msg_count, msg_size)) * 4U)
+#define POOL_MEMPOOL_SIZE(name, block_count, block_size)                      \
+  + sizeof(MemPool_t) + (POOL_WORDS(MEMPOOL_ARR_SIZE(block_count, block_size)) * 4U)
+
+#define POOL_TOTAL_SIZE           (0U OS2_POOL_TABLE(POOL_THREAD_SIZE, POOL_TIMER_SIZE,     \
+                                                     POOL_EVENTFLAGS_SIZE, POOL_MUTEX_SIZE, \
+                                                     POOL_SEMAPHORE_SIZE, POOL_MSGQUEUE_SIZE, \
+                                                     POOL_MEMPOOL_SIZE))
+
+/* Compilation fails here when the object table does not fit in OS2_POOL_BUDGET */
+typedef char os2_pool_budget_exceeded[(POOL_TOTAL_SIZE <= (OS2_POOL_BUDGET)) ? 1 : -1];
+
+/* Pool entry descriptor */
+typedef struct {
+  const char *name;             /* Object name from the table        */
+  void       *cb_mem;           /* Control block memory              */
+  void       *mem;              /* Stack, queue, block or callb data */
+  uint32_t    mem_size;         /* Size of mem in bytes              */
+  uint32_t    type;             /* OS2_POOL_xxx object type          */
+} PoolEntry_t;
+
+#define POOL_THREAD_ENTRY(name, stack_size)                                   \
+  { #name, &os2_tcb_##name, os2_stack_##name, sizeof(os2_stack_##name), OS2_POOL_THREAD },
+#define POOL_TIMER_ENTRY(name)                                                \
+  { #name, &os2_tmr_##name, os2_tmr_callb_##name, sizeof(os2_tmr_callb_##name), OS2_POOL_TIMER },
+#define POOL_EVENTFLAGS_ENTRY(name)                                           \
+  { #name, &os2_evf_##name, NULL, 0U, OS2_POOL_EVENTFLAGS },
+#define POOL_MUTEX_ENTRY(name)                                                \
+  { #name, &os2_mtx_##name, NULL, 0U, OS2_POOL_MUTEX },
+#define POOL_SEMAPHORE_ENTRY(name)                                            \
+  { #name, &os2_sem_##name, NULL, 0U, OS2_POOL_SEMAPHORE },
+#define POOL_MSGQUEUE_ENTRY(name, msg_count, msg_size)                        \
+  { #name, &os2_mq_##name, os2_mq_mem_##name, sizeof(os2_mq_mem_##name), OS2_POOL_MSGQUEUE },
+#define POOL_MEMPOOL_ENTRY(name, block_count, block_size)                     \
+  { #name, &os2_mp_##name, os2_mp_mem_##name, sizeof(os2_mp_mem_##name), OS2_POOL_MEMPOOL },
+
+/* Pool entries, terminated by an empty entry so that an empty table still compiles */
+static const PoolEntry_t PoolEntry[] = {
+  OS2_POOL_TABLE(POOL_THREAD_ENTRY, POOL_TIMER_ENTRY, POOL_EVENTFLAGS_ENTRY, POOL_MUTEX_ENTRY,
+                 POOL_SEMAPHORE_ENTRY, POOL_MSGQUEUE_ENTRY, POOL_MEMPOOL_ENTRY)
+  { NULL, NULL, NULL, 0U, 0U }
+};
+
+#define POOL_ENTRY_COUNT          ((sizeof(PoolEntry) / sizeof(PoolEntry[0])) - 1U)
+
+/* Entry allocation flags */
+static volatile uint8_t PoolUsed[POOL_ENTRY_COUNT + 1U];
+
+/* Lines named OS2_POOL_ANY_PREFIX... are free for any object of their type */
+#define POOL_ANY_PREFIX_LEN       (sizeof(OS2_POOL_ANY_PREFIX) - 1U)
+#define POOL_IS_ANY(entry)        (strncmp ((entry)->name, OS2_POOL_ANY_PREFIX, POOL_ANY_PREFIX_LEN) == 0)
+
+void *osPoolAlloc (uint32_t type, const char *name, uint32_t mem_size, void **mem, uint32_t *mem_size_out) {
+  const PoolEntry_t *entry;
+  uint32_t i, sel;
+
+  sel = POOL_ENTRY_COUNT;
+
+  taskENTER_CRITICAL();
+
+  for (i = 0U; i < POOL_ENTRY_COUNT; i++) {
+    entry = &PoolEntry[i];
+
+    if ((entry->type == type) && (PoolUsed[i] == 0U) && (entry->mem_size >= mem_size)) {
+      if ((name != NULL) && (strcmp (entry->name, name) == 0)) {
+        /* Entry declared for this object */
+        sel = i;
+        break;
+      }
+      if ((sel == POOL_ENTRY_COUNT) && POOL_IS_ANY (entry)) {
+        /* First suitable wildcard entry, used unless a named match follows */
+        sel = i;
+      }
+    }
+  }
+
+  if (sel < POOL_ENTRY_COUNT) {
+    PoolUsed[sel] = 1U;
+  }
+
+  taskEXIT_CRITICAL();
+
+  /* The terminating entry returns NULL memory when nothing is free */
+  *mem          = PoolEntry[sel].mem;
+  *mem_size_out = PoolEntry[sel].mem_size;
+
+  return (PoolEntry[sel].cb_mem);
+}
+
+uint32_t osPoolContains (const void *ptr) {
+  uint32_t i;
+
+  if (ptr != NULL) {
+    for (i = 0U; i < POOL_ENTRY_COUNT; i++) {
+      if ((PoolEntry[i].cb_mem == ptr) || (PoolEntry[i].mem == ptr)) {
+        return (1U);
+      }
+    }
+  }
+
+  return (0U);
+}
+
+void osPoolRelease (void *ptr) {
+  uint32_t i;
+
+  if (ptr != NULL) {
+    for (i = 0U; i < POOL_ENTRY_COUNT; i++) {
+      if ((PoolEntry[i].cb_mem == ptr) || (PoolEntry[i].mem == ptr)) {
+        PoolUsed[i] = 0U;
+        break;
+      }
+    }
+  }
+}
+
+#endif /* (configUSE_OS2_STATIC_POOLS == 1) */
@@ -0,0 +1,49 @@
+/* --------------------------------------------------------------------------
+ *      Name:    freertos_os2_pool.h
+ *      Purpose: Static object pools for the CMSIS-RTOS2 wrapper
+ *
+ *      When configUSE_OS2_STATIC_POOLS is 1, objects created without caller
+ *      supplied cb_mem/stack_mem/mq_mem/mp_mem take their memory from typed,
+ *      statically sized entries declared in os2_pool_cfg.h instead of the
+ *      FreeRTOS heap.
+ *---------------------------------------------------------------------------*/
+
+#ifndef FREERTOS_OS2_POOL_H_
+#define FREERTOS_OS2_POOL_H_
+
+#include <stdint.h>
+
+/* Object types held in the pools */
+#define OS2_POOL_THREAD           1U
+#define OS2_POOL_TIMER            2U
+#define OS2_POOL_EVENTFLAGS       3U
+#define OS2_POOL_MUTEX            4U
+#define OS2_POOL_SEMAPHORE        5U
+#define OS2_POOL_MSGQUEUE         6U
+#define OS2_POOL_MEMPOOL          7U
+
+/*
+  Claim a free pool entry of the given type. The entry declared with the same
+  name as the object is preferred, otherwise the first free wildcard entry
+  (named OS2_POOL_ANY_PREFIX...) of that type whose storage holds at least
+  mem_size bytes is used. Entries declared for other objects are never taken.
+
+  Returns the entry control block, or NULL when the pool is exhausted. The
+  entry storage (thread stack, queue storage, memory pool blocks or timer
+  callback) is returned in *mem and its size in bytes in *mem_size_out.
+*/
+extern void *osPoolAlloc (uint32_t type, const char *name, uint32_t mem_size, void **mem, uint32_t *mem_size_out);
+
+/*
+  Return 1 when ptr is the control block or the storage of a pool entry,
+  0 otherwise.
+*/
+extern uint32_t osPoolContains (const void *ptr);
+
+/*
+  Return the pool entry owning ptr (its control block or its storage).
+  Pointers that do not belong to a pool entry are ignored.
+*/
+extern void  osPoolRelease (void *ptr);
+
+#endif /* FREERTOS_OS2_POOL_H_ */
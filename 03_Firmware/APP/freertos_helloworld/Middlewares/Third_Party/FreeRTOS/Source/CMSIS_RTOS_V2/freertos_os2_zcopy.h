@@ -0,0 +1,45 @@
+/* --------------------------------------------------------------------------
+ *      Name:    freertos_os2_zcopy.h
+ *      Purpose: Zero-copy message passing for the CMSIS-RTOS2 wrapper
+ *
+ *      A message is a block taken from an osMemoryPool with
+ *      osMemoryPoolAlloc and filled in place. Only the block pointer goes
+ *      through the message queue, which must be created with a message size
+ *      of sizeof(void *). The receiver owns the block and gives it back with
+ *      osMemoryPoolFree once done with it.
+ *
+ *      When configUSE_OS2_MSGBLOCK_DEBUG is 1 every block records its owner
+ *      (a thread, an interrupt or the queue it was put into), ownership is
+ *      checked at every hop and osMemoryPoolDelete asserts that no block is
+ *      still outstanding.
+ *---------------------------------------------------------------------------*/
+
+#ifndef FREERTOS_OS2_ZCOPY_H_
+#define FREERTOS_OS2_ZCOPY_H_
+
+#include <stdint.h>
+#include "cmsis_os2.h"
+
+/*
+  Put a memory pool block into a message queue, handing its ownership to the
+  receiver. The block must not be accessed after osOK is returned; on any other
+  status the caller still owns it. May be called from an interrupt with a
+  timeout of 0.
+*/
+extern osStatus_t osMessageQueuePutBlock (osMessageQueueId_t mq_id, void *block, uint8_t msg_prio, uint32_t timeout);
+
+/*
+  Get a memory pool block from a message queue, taking over its ownership.
+  Returns NULL when no block arrived within timeout. May be called from an
+  interrupt with a timeout of 0.
+*/
+extern void      *osMessageQueueGetBlock (osMessageQueueId_t mq_id, uint8_t *msg_prio, uint32_t timeout);
+
+/*
+  Count the blocks of a memory pool currently owned by owner: a thread id, a
+  message queue id, or NULL for blocks held by interrupts. Returns 0 unless
+  configUSE_OS2_MSGBLOCK_DEBUG is 1.
+*/
+extern uint32_t   osMemoryPoolGetOwnedCount (osMemoryPoolId_t mp_id, void *owner);
+
+#endif /* FREERTOS_OS2_ZCOPY_H_ */
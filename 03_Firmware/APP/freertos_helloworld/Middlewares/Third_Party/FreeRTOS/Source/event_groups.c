@@ -72,6 +72,17 @@ typedef struct EventGroupDef_t
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
 	#endif
+
+	#if( configUSE_BATCHED_WAKEUP == 1 )
+		UBaseType_t uxWakeThreshold;	/*< The number of set operations between checks of the blocked tasks. */
+		UBaseType_t uxSetsPending;		/*< The number of set operations since blocked tasks were last checked. */
+		EventBits_t uxBitsFromISR;		/*< Bits set from interrupts that have not yet been moved into uxEventBits. */
+	#endif
+
+	#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+		TimerHandle_t xWakeTimer;		/*< Checks the blocked tasks xWakeLatency ticks after the first set of a batch.  NULL until a latency is set. */
+		TickType_t xWakeLatency;		/*< portMAX_DELAY if a batch is held until the threshold is reached. */
+	#endif
 } EventGroup_t;
 
 /*-----------------------------------------------------------*/
@@ -86,6 +97,60 @@ typedef struct EventGroupDef_t
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * xEventGroupSetBits(), with xForceCheck set to pdTRUE when the blocked tasks
+ * must be checked whatever the wake threshold: the set of a rendezvous, whose
+ * other tasks would otherwise stay blocked until their timeout, and the set
+ * pended by an interrupt that completed a batch.
+ */
+static EventBits_t prvSetBits( EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet, const BaseType_t xForceCheck ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_BATCHED_WAKEUP == 1 )
+
+	/*
+	 * Counts one set operation.  Returns pdTRUE, and restarts the count, when
+	 * the wake threshold is reached and blocked tasks should be checked.  The
+	 * first set of a batch arms the wake latency timer, if there is one.  Must
+	 * be called with interrupts masked.
+	 */
+	static BaseType_t prvBatchComplete( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Restarts the count of set operations and disarms the wake latency timer.
+	 * Must be called with interrupts masked.
+	 */
+	static void prvEndBatch( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Moves bits set from interrupts into the event group.
+	 */
+	static void prvFoldBitsFromISR( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+	#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+		/*
+		 * Pended from xEventGroupSetBitsFromISR() when a batch completes.  Runs
+		 * in the timer task and checks the blocked tasks against all the bits.
+		 */
+		static void prvSetBitsFromISRCallback( void *pvEventGroup, const uint32_t ulUnused ) PRIVILEGED_FUNCTION;
+
+	#endif
+
+	#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+
+		/*
+		 * The callback of xWakeTimer.  Runs in the timer task and checks the
+		 * blocked tasks against the bits of the batch so far.
+		 */
+		static void prvWakeLatencyCallback( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+	#endif
+
+	#define eventFOLD_BITS_FROM_ISR( pxEventBits )	prvFoldBitsFromISR( pxEventBits )
+#else
+	#define eventFOLD_BITS_FROM_ISR( pxEventBits )
+#endif /* configUSE_BATCHED_WAKEUP */
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -115,6 +180,21 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_BATCHED_WAKEUP == 1 )
+			{
+				pxEventBits->uxWakeThreshold = ( UBaseType_t ) 1U;
+				pxEventBits->uxSetsPending = ( UBaseType_t ) 0U;
+				pxEventBits->uxBitsFromISR = 0;
+			}
+			#endif /* configUSE_BATCHED_WAKEUP */
+
+			#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+			{
+				pxEventBits->xWakeTimer = NULL;
+				pxEventBits->xWakeLatency = portMAX_DELAY;
+			}
+			#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note that
@@ -166,6 +246,21 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configUSE_BATCHED_WAKEUP == 1 )
+			{
+				pxEventBits->uxWakeThreshold = ( UBaseType_t ) 1U;
+				pxEventBits->uxSetsPending = ( UBaseType_t ) 0U;
+				pxEventBits->uxBitsFromISR = 0;
+			}
+			#endif /* configUSE_BATCHED_WAKEUP */
+
+			#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+			{
+				pxEventBits->xWakeTimer = NULL;
+				pxEventBits->xWakeLatency = portMAX_DELAY;
+			}
+			#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note this
@@ -203,11 +298,13 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 	}
 	#endif
 
+	eventFOLD_BITS_FROM_ISR( pxEventBits );
+
 	vTaskSuspendAll();
 	{
 		uxOriginalBitValue = pxEventBits->uxEventBits;
 
-		( void ) xEventGroupSetBits( xEventGroup, uxBitsToSet );
+		( void ) prvSetBits( pxEventBits, uxBitsToSet, pdTRUE );
 
 		if( ( ( uxOriginalBitValue | uxBitsToSet ) & uxBitsToWaitFor ) == uxBitsToWaitFor )
 		{
@@ -326,6 +423,9 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 	}
 	#endif
 
+	/* Bits set from interrupts below the wake threshold count as set. */
+	eventFOLD_BITS_FROM_ISR( pxEventBits );
+
 	vTaskSuspendAll();
 	{
 		const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
@@ -418,6 +518,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			taskENTER_CRITICAL();
 			{
 				/* The task timed out, just return the current event bit value. */
+				eventFOLD_BITS_FROM_ISR( pxEventBits );
 				uxReturn = pxEventBits->uxEventBits;
 
 				/* It is possible that the event bits were updated between this
@@ -472,6 +573,9 @@ EventBits_t uxReturn;
 	{
 		traceEVENT_GROUP_CLEAR_BITS( xEventGroup, uxBitsToClear );
 
+		/* Bits set from interrupts before this call are cleared too. */
+		eventFOLD_BITS_FROM_ISR( pxEventBits );
+
 		/* The value returned is the event group value prior to the bits being
 		cleared. */
 		uxReturn = pxEventBits->uxEventBits;
@@ -509,6 +613,12 @@ EventBits_t uxReturn;
 	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 	{
 		uxReturn = pxEventBits->uxEventBits;
+
+		#if( configUSE_BATCHED_WAKEUP == 1 )
+		{
+			uxReturn |= pxEventBits->uxBitsFromISR;
+		}
+		#endif
 	}
 	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
@@ -517,24 +627,56 @@ EventBits_t uxReturn;
 /*-----------------------------------------------------------*/
 
 EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet )
+{
+	return prvSetBits( xEventGroup, uxBitsToSet, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvSetBits( EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet, const BaseType_t xForceCheck )
 {
 ListItem_t *pxListItem, *pxNext;
 ListItem_t const *pxListEnd;
 List_t const * pxList;
 EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
-EventGroup_t *pxEventBits = xEventGroup;
 BaseType_t xMatchFound = pdFALSE;
+BaseType_t xCheckBlocked = pdTRUE;
 
 	/* Check the user is not attempting to set the bits used by the kernel
 	itself. */
-	configASSERT( xEventGroup );
+	configASSERT( pxEventBits );
 	configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
+	#if( configUSE_BATCHED_WAKEUP == 1 )
+	{
+		/* Below the wake threshold the bits are set but blocked tasks are left
+		blocked, until their block time runs out or the wake latency timer
+		checks them.  A forced check starts a new batch. */
+		taskENTER_CRITICAL();
+		{
+			eventFOLD_BITS_FROM_ISR( pxEventBits );
+
+			if( xForceCheck != pdFALSE )
+			{
+				prvEndBatch( pxEventBits );
+			}
+			else
+			{
+				xCheckBlocked = prvBatchComplete( pxEventBits );
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	#else
+	{
+		( void ) xForceCheck;
+	}
+	#endif /* configUSE_BATCHED_WAKEUP */
+
 	pxList = &( pxEventBits->xTasksWaitingForBits );
 	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	vTaskSuspendAll();
 	{
-		traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
+		traceEVENT_GROUP_SET_BITS( pxEventBits, uxBitsToSet );
 
 		pxListItem = listGET_HEAD_ENTRY( pxList );
 
@@ -542,7 +684,7 @@ BaseType_t xMatchFound = pdFALSE;
 		pxEventBits->uxEventBits |= uxBitsToSet;
 
 		/* See if the new bit value should unblock any tasks. */
-		while( pxListItem != pxListEnd )
+		while( ( pxListItem != pxListEnd ) && ( xCheckBlocked != pdFALSE ) )
 		{
 			pxNext = listGET_NEXT( pxListItem );
 			uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
@@ -614,11 +756,30 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
 {
 EventGroup_t *pxEventBits = xEventGroup;
 const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
+#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	TimerHandle_t xWakeTimer = pxEventBits->xWakeTimer;
+#endif
 
 	vTaskSuspendAll();
 	{
 		traceEVENT_GROUP_DELETE( xEventGroup );
 
+		#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+		{
+			/* A callback that has not yet read the timer ID finds NULL and
+			leaves the event group alone.  The timer is deleted below. */
+			if( xWakeTimer != NULL )
+			{
+				vTimerSetTimerID( xWakeTimer, NULL );
+				( void ) xTimerDisarm( xWakeTimer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
 		while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
 		{
 			/* Unblock the task, returning 0 as the event list is being deleted
@@ -649,6 +810,19 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 	}
 	( void ) xTaskResumeAll();
+
+	#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	{
+		if( xWakeTimer != NULL )
+		{
+			( void ) xTimerDelete( xWakeTimer, portMAX_DELAY );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* tmrBATCH_LATENCY_POSSIBLE */
 }
 /*-----------------------------------------------------------*/
 
@@ -668,6 +842,201 @@ void vEventGroupClearBitsCallback( void *pvEventGroup, const uint32_t ulBitsToCl
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_BATCHED_WAKEUP == 1 )
+
+	void vEventGroupSetWakeThreshold( EventGroupHandle_t xEventGroup, UBaseType_t uxSets )
+	{
+	EventGroup_t *pxEventBits = xEventGroup;
+
+		configASSERT( xEventGroup );
+		configASSERT( uxSets > ( UBaseType_t ) 0U );
+
+		taskENTER_CRITICAL();
+		{
+			pxEventBits->uxWakeThreshold = uxSets;
+			prvEndBatch( pxEventBits );
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvBatchComplete( EventGroup_t *pxEventBits )
+	{
+	BaseType_t xReturn;
+
+		pxEventBits->uxSetsPending++;
+
+		if( pxEventBits->uxSetsPending >= pxEventBits->uxWakeThreshold )
+		{
+			prvEndBatch( pxEventBits );
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+			{
+				/* The first set of the batch starts the latency.  Arming the
+				timer may ready the timer task, which then runs by priority
+				like any other task: it only has to read the wheel again before
+				the latency expires, so no switch is requested here. */
+				if( ( pxEventBits->uxSetsPending == ( UBaseType_t ) 1U ) && ( pxEventBits->xWakeLatency != portMAX_DELAY ) )
+				{
+					( void ) xTimerArmFromISR( pxEventBits->xWakeTimer, pxEventBits->xWakeLatency, NULL );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvEndBatch( EventGroup_t *pxEventBits )
+	{
+		pxEventBits->uxSetsPending = ( UBaseType_t ) 0U;
+
+		#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+		{
+			if( pxEventBits->xWakeTimer != NULL )
+			{
+				( void ) xTimerDisarmFromISR( pxEventBits->xWakeTimer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* tmrBATCH_LATENCY_POSSIBLE */
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvFoldBitsFromISR( EventGroup_t *pxEventBits )
+	{
+		taskENTER_CRITICAL();
+		{
+			pxEventBits->uxEventBits |= pxEventBits->uxBitsFromISR;
+			pxEventBits->uxBitsFromISR = 0;
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+		static void prvSetBitsFromISRCallback( void *pvEventGroup, const uint32_t ulUnused )
+		{
+		EventGroup_t *pxEventBits = pvEventGroup; /*lint !e9079 Can't avoid cast to void* as a generic timer callback prototype. Callback casts back to original type so safe. */
+
+			( void ) ulUnused;
+
+			/* The interrupt already counted the batch as complete, so check
+			the blocked tasks whatever the count is now. */
+			( void ) prvSetBits( pxEventBits, 0, pdTRUE );
+		}
+
+	#endif
+
+#endif /* configUSE_BATCHED_WAKEUP */
+/*-----------------------------------------------------------*/
+
+#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+
+	BaseType_t xEventGroupSetWakeLatency( EventGroupHandle_t xEventGroup, TickType_t xMaxLatency )
+	{
+	EventGroup_t *pxEventBits = xEventGroup;
+	BaseType_t xReturn = pdPASS;
+
+		configASSERT( xEventGroup );
+		configASSERT( xMaxLatency > ( TickType_t ) 0U );
+
+		if( ( xMaxLatency != portMAX_DELAY ) && ( pxEventBits->xWakeTimer == NULL ) )
+		{
+			/* The period is given each time the timer is armed. */
+			pxEventBits->xWakeTimer = xTimerCreate( "EWake", xMaxLatency, pdFALSE, ( void * ) pxEventBits, prvWakeLatencyCallback );
+
+			if( pxEventBits->xWakeTimer == NULL )
+			{
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xReturn != pdFAIL )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxEventBits->xWakeLatency = xMaxLatency;
+
+				/* A batch already pending is held for the new latency from
+				now, or until the threshold is reached. */
+				if( pxEventBits->xWakeTimer != NULL )
+				{
+					if( ( pxEventBits->uxSetsPending > ( UBaseType_t ) 0U ) && ( xMaxLatency != portMAX_DELAY ) )
+					{
+						( void ) xTimerArmFromISR( pxEventBits->xWakeTimer, xMaxLatency, NULL );
+					}
+					else
+					{
+						( void ) xTimerDisarm( pxEventBits->xWakeTimer );
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvWakeLatencyCallback( TimerHandle_t xTimer )
+	{
+	EventGroup_t *pxEventBits;
+
+		/* vEventGroupDelete() clears the timer ID with the scheduler suspended,
+		so the event group read here stays valid until the scheduler is
+		resumed. */
+		vTaskSuspendAll();
+		{
+			pxEventBits = ( EventGroup_t * ) pvTimerGetTimerID( xTimer );
+
+			if( pxEventBits != NULL )
+			{
+				/* The check starts a new batch, which also disarms the timer if
+				a batch started since it expired armed it again. */
+				( void ) prvSetBits( pxEventBits, 0, pdTRUE );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+
+#endif /* tmrBATCH_LATENCY_POSSIBLE */
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits )
 {
 BaseType_t xWaitConditionMet = pdFALSE;
@@ -703,14 +1072,45 @@ BaseType_t xWaitConditionMet = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_BATCHED_WAKEUP == 1 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	BaseType_t xReturn;
 
 		traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
-		xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+		#if( configUSE_BATCHED_WAKEUP == 1 )
+		{
+		EventGroup_t *pxEventBits = xEventGroup;
+		UBaseType_t uxSavedInterruptStatus;
+		BaseType_t xBatchComplete;
+
+			/* The bits are recorded here and only handed to the timer task,
+			which costs a context switch, once a batch is complete. */
+			configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				pxEventBits->uxBitsFromISR |= uxBitsToSet;
+				xBatchComplete = prvBatchComplete( pxEventBits );
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+			if( xBatchComplete != pdFALSE )
+			{
+				xReturn = xTimerPendFunctionCallFromISR( prvSetBitsFromISRCallback, ( void * ) xEventGroup, ( uint32_t ) 0, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+			}
+			else
+			{
+				xReturn = pdPASS;
+			}
+		}
+		#else
+		{
+			xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+		}
+		#endif /* configUSE_BATCHED_WAKEUP */
 
 		return xReturn;
 	}
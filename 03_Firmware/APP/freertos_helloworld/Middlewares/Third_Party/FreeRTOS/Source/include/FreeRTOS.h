@@ -210,6 +210,18 @@ extern "C" {
 	#define configUSE_TIMERS 0
 #endif
 
+#ifndef configUSE_TIMER_WHEEL
+	#define configUSE_TIMER_WHEEL 0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_MULTI_PRODUCER
+	#define configUSE_STREAM_BUFFER_MULTI_PRODUCER 0
+#endif
+
+#ifndef configUSE_BATCHED_WAKEUP
+	#define configUSE_BATCHED_WAKEUP 0
+#endif
+
 #ifndef configUSE_COUNTING_SEMAPHORES
 	#define configUSE_COUNTING_SEMAPHORES 0
 #endif
@@ -276,6 +288,14 @@ hold explicit before calling the code. */
 		#error If configUSE_TIMERS is set to 1 then configTIMER_TASK_STACK_DEPTH must also be defined.
 	#endif /* configTIMER_TASK_STACK_DEPTH */
 
+	#if ( configUSE_TIMER_WHEEL == 1 ) && ( INCLUDE_xTimerPendFunctionCall != 1 )
+		#error If configUSE_TIMER_WHEEL is set to 1 then INCLUDE_xTimerPendFunctionCall must also be set to 1.
+	#endif
+
+	#if ( configUSE_TIMER_WHEEL == 1 ) && ( configUSE_16_BIT_TICKS == 1 )
+		#error configUSE_TIMER_WHEEL requires 32-bit ticks.
+	#endif
+
 #endif /* configUSE_TIMERS */
 
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
@@ -1048,6 +1068,14 @@ the Secure Side only. */
 #define tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE	( ( ( portUSING_MPU_WRAPPERS == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) ) || \
 													  ( ( portUSING_MPU_WRAPPERS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) )
 
+/*
+ * tmrBATCH_LATENCY_POSSIBLE is only true if a queue or event group with a wake
+ * threshold can also bound how long a batch is held (xQueueSetWakeLatency(),
+ * xEventGroupSetWakeLatency()).  The bound is a software timer, created when
+ * it is first set and armed directly in the timing wheel.
+ */
+#define tmrBATCH_LATENCY_POSSIBLE	( ( configUSE_BATCHED_WAKEUP == 1 ) && ( configUSE_TIMERS == 1 ) && ( configUSE_TIMER_WHEEL == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
 /*
  * In line with software engineering best practice, FreeRTOS implements a strict
  * data hiding policy, so the real structures used by FreeRTOS to maintain the
@@ -1200,6 +1228,16 @@ typedef struct xSTATIC_QUEUE
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_BATCHED_WAKEUP == 1 )
+		UBaseType_t uxDummy10;
+	#endif
+
+	#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+		void *pvDummy11;
+		TickType_t xDummy12;
+		UBaseType_t uxDummy13;
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1230,6 +1268,16 @@ typedef struct xSTATIC_EVENT_GROUP
 			uint8_t ucDummy4;
 	#endif
 
+	#if( configUSE_BATCHED_WAKEUP == 1 )
+		UBaseType_t uxDummy5[ 2 ];
+		TickType_t xDummy6;
+	#endif
+
+	#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+		void *pvDummy7;
+		TickType_t xDummy8;
+	#endif
+
 } StaticEventGroup_t;
 
 /*
@@ -1282,6 +1330,9 @@ typedef struct xSTATIC_STREAM_BUFFER
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy4;
 	#endif
+	#if ( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		uint32_t ulDummy5;
+	#endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
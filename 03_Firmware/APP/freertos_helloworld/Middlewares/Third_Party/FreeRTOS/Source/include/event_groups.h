@@ -556,7 +556,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_BATCHED_WAKEUP == 1 ) )
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken )
@@ -738,6 +738,73 @@ EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup ) PRIVILEG
  */
 void vEventGroupDelete( EventGroupHandle_t xEventGroup ) PRIVILEGED_FUNCTION;
 
+/**
+ * event_groups.h
+ *<pre>
+	void vEventGroupSetWakeThreshold( EventGroupHandle_t xEventGroup, UBaseType_t uxSets );
+ </pre>
+ *
+ * Sets how many set operations, from tasks or interrupts, are made before the
+ * tasks blocked on the event group are checked and woken.  Bits are set
+ * immediately, so a task that does not block sees them at once; only the
+ * unblocking is deferred.  Below the threshold xEventGroupSetBitsFromISR()
+ * does not defer work to the timer task, so a burst of uxSets interrupts
+ * costs one context switch rather than uxSets.  The default of 1 checks the
+ * blocked tasks on every set.
+ *
+ * A batch that does not fill up is held until the block time passed to
+ * xEventGroupWaitBits() runs out, which counts from when the task blocked,
+ * or until the latency set by xEventGroupSetWakeLatency().  A task that
+ * times out returns the bits set so far.
+ *
+ * xEventGroupSync() is not batched: its set always checks the blocked tasks,
+ * as the other tasks of the rendezvous cannot make any more sets until they
+ * are woken.  It restarts the count of the batch.
+ *
+ * configUSE_BATCHED_WAKEUP must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xEventGroup The event group.
+ *
+ * @param uxSets The number of set operations per check, at least 1.
+ */
+#if( configUSE_BATCHED_WAKEUP == 1 )
+	void vEventGroupSetWakeThreshold( EventGroupHandle_t xEventGroup, UBaseType_t uxSets ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * event_groups.h
+ *<pre>
+	BaseType_t xEventGroupSetWakeLatency( EventGroupHandle_t xEventGroup, TickType_t xMaxLatency );
+ </pre>
+ *
+ * Bounds how long a batch below the wake threshold
+ * (vEventGroupSetWakeThreshold()) is held: the blocked tasks are checked
+ * xMaxLatency ticks after the first set of the batch, however many sets have
+ * been made by then.  A task can then block with portMAX_DELAY and still see
+ * every set in time, and is not woken while no bits are set.
+ *
+ * The bound is a one-shot software timer, created by the first call with a
+ * latency and armed directly in the timing wheel by the set that starts a
+ * batch, from a task or an interrupt.  Arming never blocks, but can make the
+ * timer task ready when the timer expires before the task would otherwise
+ * wake, at most about once per latency.
+ *
+ * configUSE_BATCHED_WAKEUP, configUSE_TIMERS, configUSE_TIMER_WHEEL and
+ * configSUPPORT_DYNAMIC_ALLOCATION must all be set to 1 in FreeRTOSConfig.h
+ * for this function to be available.  Must not be called from an interrupt.
+ *
+ * @param xEventGroup The event group.
+ *
+ * @param xMaxLatency The latency in ticks, at least 1, or portMAX_DELAY to
+ * hold a batch until the threshold is reached (the default).
+ *
+ * @return pdPASS, or pdFAIL if the timer could not be created.
+ */
+#if( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	BaseType_t xEventGroupSetWakeLatency( EventGroupHandle_t xEventGroup, TickType_t xMaxLatency ) PRIVILEGED_FUNCTION;
+#endif
+
 /* For internal use only. */
 void vEventGroupSetBitsCallback( void *pvEventGroup, const uint32_t ulBitsToSet ) PRIVILEGED_FUNCTION;
 void vEventGroupClearBitsCallback( void *pvEventGroup, const uint32_t ulBitsToClear ) PRIVILEGED_FUNCTION;
@@ -207,6 +207,29 @@ MessageBufferHandle_t xMessageBuffer;
  */
 #define xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, pdTRUE, pucMessageBufferStorageArea, pxStaticMessageBuffer )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+MessageBufferHandle_t xMessageBufferCreateMultiProducer( size_t xBufferSizeBytes );
+MessageBufferHandle_t xMessageBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                               uint8_t *pucMessageBufferStorageArea,
+                                                               StaticMessageBuffer_t *pxStaticMessageBuffer );
+</pre>
+ * As xMessageBufferCreate() and xMessageBufferCreateStatic(), but any number of
+ * tasks and interrupts can send to the message buffer at once.  A message and
+ * its length are claimed and written as one, so messages from different
+ * writers are never interleaved and are received in the order their space was
+ * claimed.  See xStreamBufferCreateMultiProducer() for details.
+ * configUSE_STREAM_BUFFER_MULTI_PRODUCER must be set to 1 in FreeRTOSConfig.h
+ * for these macros to be available.
+ *
+ * \defgroup xMessageBufferCreateMultiProducer xMessageBufferCreateMultiProducer
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferCreateMultiProducer( xBufferSizeBytes ) ( MessageBufferHandle_t ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, sbTYPE_MESSAGE_BUFFER | sbTYPE_MULTI_PRODUCER )
+#define xMessageBufferCreateMultiProducerStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, sbTYPE_MESSAGE_BUFFER | sbTYPE_MULTI_PRODUCER, pucMessageBufferStorageArea, pxStaticMessageBuffer )
+
 /**
  * message_buffer.h
  *
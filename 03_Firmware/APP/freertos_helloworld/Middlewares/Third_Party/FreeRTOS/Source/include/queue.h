@@ -899,6 +899,65 @@ UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue ) PRIVILEGED_FUNC
  */
 UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>void vQueueSetWakeThreshold( QueueHandle_t xQueue, UBaseType_t uxItems );</pre>
+ *
+ * Sets how many items must be waiting in a queue before a task blocked on
+ * receiving from it is woken.  Senders, including those in interrupts, add
+ * items below the threshold without unblocking the receiver or requesting a
+ * context switch, so a burst of uxItems sends wakes the receiver once.  The
+ * default of 1 wakes the receiver on every send.
+ *
+ * A batch that does not fill up is held until the receiver's block time
+ * passed to xQueueReceive() runs out, which counts from when the receiver
+ * blocked, or until the latency set by xQueueSetWakeLatency().  A receiver
+ * only blocks when the queue is empty, so it drains a batch without blocking.
+ *
+ * configUSE_BATCHED_WAKEUP must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xQueue A handle to the queue.
+ *
+ * @param uxItems The number of items, from 1 up to the queue length.
+ *
+ * \defgroup vQueueSetWakeThreshold vQueueSetWakeThreshold
+ * \ingroup QueueManagement
+ */
+void vQueueSetWakeThreshold( QueueHandle_t xQueue, UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>BaseType_t xQueueSetWakeLatency( QueueHandle_t xQueue, TickType_t xMaxLatency );</pre>
+ *
+ * Bounds how long a batch below the wake threshold (vQueueSetWakeThreshold())
+ * is held: the blocked receiver is woken xMaxLatency ticks after the first
+ * item of the batch was sent, however many items are waiting by then.  A
+ * receiver can then block with portMAX_DELAY and still see every item in
+ * time, and is not woken while the queue stays empty.
+ *
+ * The bound is a one-shot software timer, created by the first call with a
+ * latency and armed directly in the timing wheel by the send that starts a
+ * batch, from a task or an interrupt.  Arming never blocks, but can make the
+ * timer task ready when the timer expires before the task would otherwise
+ * wake, at most about once per latency.
+ *
+ * configUSE_BATCHED_WAKEUP, configUSE_TIMERS, configUSE_TIMER_WHEEL and
+ * configSUPPORT_DYNAMIC_ALLOCATION must all be set to 1 in FreeRTOSConfig.h
+ * for this function to be available.  Must not be called from an interrupt.
+ *
+ * @param xQueue A handle to the queue.
+ *
+ * @param xMaxLatency The latency in ticks, at least 1, or portMAX_DELAY to
+ * hold a batch until the threshold is reached (the default).
+ *
+ * @return pdPASS, or pdFAIL if the timer could not be created.
+ *
+ * \defgroup xQueueSetWakeLatency xQueueSetWakeLatency
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSetWakeLatency( QueueHandle_t xQueue, TickType_t xMaxLatency ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * <pre>void vQueueDelete( QueueHandle_t xQueue );</pre>
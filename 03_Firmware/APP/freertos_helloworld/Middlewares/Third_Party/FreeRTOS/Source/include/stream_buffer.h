@@ -46,6 +46,11 @@
  * (such as xStreamBufferReceive()) inside a critical section section and set the
  * receive block time to 0.
  *
+ * When configUSE_STREAM_BUFFER_MULTI_PRODUCER is set to 1 a buffer created with
+ * xStreamBufferCreateMultiProducer() or xMessageBufferCreateMultiProducer() may
+ * have any number of writers, tasks and interrupts alike, without a critical
+ * section.  There must still be only one reader.
+ *
  */
 
 #ifndef STREAM_BUFFER_H
@@ -68,6 +73,12 @@ extern "C" {
 struct StreamBufferDef_t;
 typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 
+/* Values passed as the xIsMessageBuffer parameter of the generic create
+functions.  sbTYPE_MULTI_PRODUCER is ORed with either of the other two. */
+#define sbTYPE_STREAM_BUFFER	( ( BaseType_t ) 0 )
+#define sbTYPE_MESSAGE_BUFFER	( ( BaseType_t ) 1 )
+#define sbTYPE_MULTI_PRODUCER	( ( BaseType_t ) 2 )
+
 
 /**
  * message_buffer.h
@@ -217,6 +228,43 @@ const size_t xTriggerLevel = 1;
  */
 #define xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE, pucStreamBufferStorageArea, pxStaticStreamBuffer )
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+StreamBufferHandle_t xStreamBufferCreateMultiProducer( size_t xBufferSizeBytes, size_t xTriggerLevelBytes );
+StreamBufferHandle_t xStreamBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                             size_t xTriggerLevelBytes,
+                                                             uint8_t *pucStreamBufferStorageArea,
+                                                             StaticStreamBuffer_t *pxStaticStreamBuffer );
+</pre>
+ * As xStreamBufferCreate() and xStreamBufferCreateStatic(), but the stream
+ * buffer can be written by any number of tasks and interrupts at once, for
+ * example several UART and SPI interrupts feeding one parser task.
+ * configUSE_STREAM_BUFFER_MULTI_PRODUCER must be set to 1 in FreeRTOSConfig.h
+ * for these macros to be available.
+ *
+ * Each writer claims space by atomically advancing a claim index, copies its
+ * bytes without holding a lock, then releases the claim.  Bytes are made
+ * visible to the reader in the order they were claimed, once every writer
+ * that claimed space before them has finished copying.  The reader is notified
+ * through its task notification by whichever writer publishes, so a burst of
+ * writes that completes together wakes it once, and only when the trigger
+ * level is reached.  Each call to a send function is written contiguously, so
+ * bytes from different writers are never interleaved.
+ *
+ * Only one task at a time can block waiting for space.  A task that finds the
+ * buffer full while another task is already waiting returns as if it had been
+ * given a block time of zero.
+ *
+ * The buffer size must be below 16 MB.
+ *
+ * \defgroup xStreamBufferCreateMultiProducer xStreamBufferCreateMultiProducer
+ * \ingroup StreamBufferManagement
+ */
+#define xStreamBufferCreateMultiProducer( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_MULTI_PRODUCER )
+#define xStreamBufferCreateMultiProducerStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_MULTI_PRODUCER, pucStreamBufferStorageArea, pxStaticStreamBuffer )
+
 /**
  * stream_buffer.h
  *
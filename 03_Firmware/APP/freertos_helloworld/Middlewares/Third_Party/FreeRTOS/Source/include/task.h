@@ -1468,6 +1468,25 @@ UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask ) PRIVILEGED_FUNCTIO
  */
 configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * <PRE>configSTACK_DEPTH_TYPE uxTaskGetStackDepth( TaskHandle_t xTask );</PRE>
+ *
+ * configRECORD_STACK_HIGH_ADDRESS must be set to 1 in FreeRTOSConfig.h for
+ * this function to be available on ports where the stack grows down.
+ *
+ * Returns the usable size of the stack allocated to xTask, in words: the
+ * depth passed to xTaskCreate() or xTaskCreateStatic(), less any word lost to
+ * aligning the top of the stack.  Together with
+ * uxTaskGetStackHighWaterMark2() it gives how much of the stack the task has
+ * ever used.
+ *
+ * @param xTask Handle of the task.  Set xTask to NULL for the calling task.
+ *
+ * @return The stack depth of the task, in words.
+ */
+configSTACK_DEPTH_TYPE uxTaskGetStackDepth( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /* When using trace macros it is sometimes necessary to include task.h before
 FreeRTOS.h.  When this is done TaskHookFunction_t will not yet have been defined,
 so the following two prototypes will cause a compilation error.  This can be
@@ -1288,6 +1288,57 @@ TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 */
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/**
+	 * BaseType_t xTimerArm( TimerHandle_t xTimer, const TickType_t xNewPeriod );
+	 * BaseType_t xTimerArmFromISR( TimerHandle_t xTimer, const TickType_t xNewPeriod, BaseType_t *pxHigherPriorityTaskWoken );
+	 *
+	 * Only available when configUSE_TIMER_WHEEL is 1.
+	 *
+	 * Set the period of a timer and (re)start it, so it expires xNewPeriod
+	 * ticks from now.  Unlike xTimerChangePeriod() the timer is placed in the
+	 * timing wheel directly, in constant time, rather than by sending a command
+	 * to the timer service task - so the call never blocks and cannot fail
+	 * because the timer command queue is full.  The timer service task is only
+	 * sent a wake request when the timer now expires before the task would
+	 * otherwise wake.
+	 *
+	 * A timer should not be armed directly while commands for the same timer
+	 * are still queued, as the queued command is applied after it.
+	 *
+	 * @param xTimer The handle of the timer being armed.
+	 *
+	 * @param xNewPeriod The new period in ticks, which must be greater than 0.
+	 *
+	 * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the wake request
+	 * unblocked the timer service task and it has a priority above the
+	 * interrupted task, in which case a context switch should be requested
+	 * before the interrupt exits.
+	 *
+	 * @return pdPASS.
+	 */
+	BaseType_t xTimerArm( TimerHandle_t xTimer, const TickType_t xNewPeriod ) PRIVILEGED_FUNCTION;
+	BaseType_t xTimerArmFromISR( TimerHandle_t xTimer, const TickType_t xNewPeriod, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+	/**
+	 * BaseType_t xTimerDisarm( TimerHandle_t xTimer );
+	 * BaseType_t xTimerDisarmFromISR( TimerHandle_t xTimer );
+	 *
+	 * Only available when configUSE_TIMER_WHEEL is 1.
+	 *
+	 * Stop a timer directly in the timing wheel, in constant time, without
+	 * going through the timer command queue.
+	 *
+	 * @param xTimer The handle of the timer being stopped.
+	 *
+	 * @return pdPASS.
+	 */
+	BaseType_t xTimerDisarm( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+	BaseType_t xTimerDisarmFromISR( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
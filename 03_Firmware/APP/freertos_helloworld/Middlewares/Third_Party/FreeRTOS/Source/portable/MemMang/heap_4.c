@@ -45,6 +45,10 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+/* heap_tlsf.c is built alongside and replaces this file when
+FreeRTOSConfig.h defines USE_FreeRTOS_HEAP_TLSF. */
+#if !defined( USE_FreeRTOS_HEAP_TLSF )
+
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -490,3 +494,5 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 	taskEXIT_CRITICAL();
 }
 
+#endif /* USE_FreeRTOS_HEAP_TLSF */
+
@@ -0,0 +1,723 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that uses a two
+ * level segregated fit (TLSF) allocator, so both functions execute in constant
+ * time regardless of how fragmented the heap is.  Adjacent free blocks are
+ * combined (coalesced) as they are freed, as in heap_4.c.
+ *
+ * Free blocks are kept in an array of lists indexed by two levels: the first
+ * level is the power of two range of the block size, and the second level
+ * divides each range into (1 << configTLSF_SL_INDEX_COUNT_LOG2) linear steps.
+ * A bit map per level records which lists are non empty, so finding a block
+ * that is large enough takes two find-first-set operations rather than a walk
+ * of the free list.  The price is that a request is rounded up to the next
+ * second level step, so up to 1 / (1 << configTLSF_SL_INDEX_COUNT_LOG2) of a
+ * large block can be wasted.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ *
+ * Usage notes:
+ *
+ * Select this file with configUSE_HEAP_TLSF in FreeRTOSConfig.h, which
+ * defines USE_FreeRTOS_HEAP_TLSF; heap_4.c then compiles to nothing, so both
+ * can stay in the project.
+ *
+ * As with heap_4.c the heap is, by default, the ucHeap array of
+ * configTOTAL_HEAP_SIZE bytes, which is added to the heap the first time it is
+ * used.  Set configTLSF_USE_DEFAULT_HEAP to 0 to omit ucHeap.
+ *
+ * As with heap_5.c more, non contiguous, memory can be given to the heap by
+ * calling vPortDefineHeapRegions() with an array of HeapRegion_t structures
+ * terminated by a NULL zero sized region.  Unlike heap_5.c the regions do not
+ * need to be in address order, and vPortDefineHeapRegions() can be called more
+ * than once.  When configTLSF_USE_DEFAULT_HEAP is 0 vPortDefineHeapRegions()
+ * ***must*** be called before pvPortMalloc().
+ */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Built only when FreeRTOSConfig.h selects this heap in place of heap_4.c. */
+#if defined( USE_FreeRTOS_HEAP_TLSF )
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configTLSF_USE_DEFAULT_HEAP
+	#define configTLSF_USE_DEFAULT_HEAP		1
+#endif
+
+/* log2 of the number of second level lists per first level range. */
+#ifndef configTLSF_SL_INDEX_COUNT_LOG2
+	#define configTLSF_SL_INDEX_COUNT_LOG2	4
+#endif
+
+/* log2 of the largest block the heap can manage.  24 allows blocks up to 16MB,
+which is more than the RAM of any device this port runs on. */
+#ifndef configTLSF_FL_INDEX_MAX
+	#define configTLSF_FL_INDEX_MAX			24
+#endif
+
+#if( portBYTE_ALIGNMENT == 32 )
+	#define tlsfALIGN_SIZE_LOG2		5
+#elif( portBYTE_ALIGNMENT == 16 )
+	#define tlsfALIGN_SIZE_LOG2		4
+#elif( portBYTE_ALIGNMENT == 8 )
+	#define tlsfALIGN_SIZE_LOG2		3
+#elif( portBYTE_ALIGNMENT == 4 )
+	#define tlsfALIGN_SIZE_LOG2		2
+#else
+	#error heap_tlsf.c requires portBYTE_ALIGNMENT to be 4, 8, 16 or 32
+#endif
+
+#define tlsfSL_INDEX_COUNT		( 1UL << configTLSF_SL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than tlsfSMALL_BLOCK_SIZE all live in first level list 0,
+which is divided linearly in steps of portBYTE_ALIGNMENT. */
+#define tlsfFL_INDEX_SHIFT		( configTLSF_SL_INDEX_COUNT_LOG2 + tlsfALIGN_SIZE_LOG2 )
+#define tlsfFL_INDEX_COUNT		( configTLSF_FL_INDEX_MAX - tlsfFL_INDEX_SHIFT + 1 )
+#define tlsfSMALL_BLOCK_SIZE	( ( size_t ) 1 << tlsfFL_INDEX_SHIFT )
+
+#if( configTLSF_SL_INDEX_COUNT_LOG2 > 5 ) || ( tlsfFL_INDEX_COUNT > 32 ) || ( tlsfFL_INDEX_COUNT < 1 )
+	#error The TLSF bit maps must fit in 32 bits - check configTLSF_SL_INDEX_COUNT_LOG2 and configTLSF_FL_INDEX_MAX
+#endif
+
+/* The low bit of xBlockSize is set while the block is on a free list.  Block
+sizes are always a multiple of portBYTE_ALIGNMENT so the bit is never part of
+the size. */
+#define tlsfBLOCK_FREE_BIT		( ( size_t ) 1 )
+#define tlsfBLOCK_SIZE( pxBlock )	( ( pxBlock )->xBlockSize & ~tlsfBLOCK_FREE_BIT )
+#define tlsfBLOCK_IS_FREE( pxBlock )	( ( ( pxBlock )->xBlockSize & tlsfBLOCK_FREE_BIT ) != 0 )
+#define tlsfNEXT_PHYS_BLOCK( pxBlock )	( ( TLSFBlock_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + tlsfBLOCK_SIZE( pxBlock ) ) )
+
+/* Find last set - the bit number of the most significant set bit, which must
+exist.  Ports that provide portCOUNT_LEADING_ZEROS use the CLZ instruction. */
+#if defined( portCOUNT_LEADING_ZEROS )
+	#define tlsfFLS( x )		( 31UL - ( uint32_t ) portCOUNT_LEADING_ZEROS( ( uint32_t ) ( x ) ) )
+#elif defined( __GNUC__ )
+	#define tlsfFLS( x )		( 31UL - ( uint32_t ) __builtin_clz( ( uint32_t ) ( x ) ) )
+#else
+	#define tlsfFLS( x )		prvFindLastSet( ( uint32_t ) ( x ) )
+#endif
+
+/* Find first set - the bit number of the least significant set bit. */
+#define tlsfFFS( x )			tlsfFLS( ( x ) & ( 0UL - ( x ) ) )
+
+/* Header of every block.  pxNextFree and pxPrevFree are only valid while the
+block is free, so an allocated block only carries the first two members in
+front of the memory returned to the application. */
+typedef struct TLSF_BLOCK
+{
+	struct TLSF_BLOCK *pxPrevPhysBlock;	/*<< The block immediately below this one in memory, NULL for the first block of a region. */
+	size_t xBlockSize;					/*<< Size of the block including the header, plus tlsfBLOCK_FREE_BIT. */
+	struct TLSF_BLOCK *pxNextFree;		/*<< The next block on the same free list. */
+	struct TLSF_BLOCK *pxPrevFree;		/*<< The previous block on the same free list. */
+} TLSFBlock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Adds a block of memory to the heap.  Called for ucHeap and for each region
+ * passed to vPortDefineHeapRegions().
+ */
+static void prvAddRegion( uint8_t *pucStartAddress, size_t xSizeInBytes );
+
+/*
+ * Calculates the first and second level list indexes for a block of size
+ * xSize.
+ */
+static void prvMappingInsert( size_t xSize, uint32_t *pulFL, uint32_t *pulSL );
+
+/*
+ * Places a free block on, and removes a free block from, the list indexed by
+ * its size, keeping the bit maps up to date.
+ */
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock );
+
+#if !defined( portCOUNT_LEADING_ZEROS ) && !defined( __GNUC__ )
+	static uint32_t prvFindLastSet( uint32_t ulValue );
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if( configTLSF_USE_DEFAULT_HEAP == 1 )
+	/* Allocate the memory for the heap. */
+	#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+		/* The application writer has already defined the array used for the RTOS
+		heap - probably so it can be placed in a special segment or address. */
+		extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+	#else
+		static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+	#endif /* configAPPLICATION_ALLOCATED_HEAP */
+#endif /* configTLSF_USE_DEFAULT_HEAP */
+
+/* The size of the part of the header kept in front of allocated memory, and the
+smallest block that can hold a full free block header. */
+static const size_t xHeapStructSize = ( offsetof( TLSFBlock_t, pxNextFree ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+static const size_t xMinimumBlockSize = ( sizeof( TLSFBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists and the bit maps that record which of them are non empty.  Bit
+n of ulFLBitmap is set when ulSLBitmap[ n ] is non zero. */
+static TLSFBlock_t *pxFreeLists[ tlsfFL_INDEX_COUNT ][ tlsfSL_INDEX_COUNT ];
+static uint32_t ulFLBitmap = 0UL;
+static uint32_t ulSLBitmap[ tlsfFL_INDEX_COUNT ];
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+number of free bytes remaining.  xNumberOfFreeBlocks gives an indication of
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfFreeBlocks = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/* Set once ucHeap has been added to the heap. */
+static BaseType_t xHeapInitialised = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+TLSFBlock_t *pxBlock, *pxNewBlock;
+uint32_t ulFL, ulSL, ulMap;
+size_t xSearchSize;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		#if( configTLSF_USE_DEFAULT_HEAP == 1 )
+		{
+			/* If this is the first call to malloc then the heap will require
+			initialisation to setup the list of free blocks. */
+			if( xHeapInitialised == pdFALSE )
+			{
+				prvAddRegion( ucHeap, configTOTAL_HEAP_SIZE );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			/* vPortDefineHeapRegions() must be called before the first call
+			to malloc. */
+			configASSERT( xFreeBytesRemaining > 0 );
+		}
+		#endif
+
+		/* Check the requested size is not so large that adding the header would
+		overflow, or that the block could not be represented in the lists. */
+		if( ( xWantedSize > 0 ) && ( xWantedSize < ( ( ( size_t ) 1 << configTLSF_FL_INDEX_MAX ) - xHeapStructSize ) ) )
+		{
+			/* The wanted size is increased so it can contain the block header
+			in addition to the requested amount of bytes, and rounded up so
+			blocks are always aligned to the required number of bytes. */
+			xWantedSize += xHeapStructSize;
+			xWantedSize = ( xWantedSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+			if( xWantedSize < xMinimumBlockSize )
+			{
+				xWantedSize = xMinimumBlockSize;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Round the search size up to the next second level step so that
+			any block on the list found is large enough - no list is walked. */
+			xSearchSize = xWantedSize;
+			if( xSearchSize >= tlsfSMALL_BLOCK_SIZE )
+			{
+				xSearchSize += ( ( size_t ) 1 << ( tlsfFLS( xSearchSize ) - configTLSF_SL_INDEX_COUNT_LOG2 ) ) - 1;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			prvMappingInsert( xSearchSize, &ulFL, &ulSL );
+			pxBlock = NULL;
+
+			if( ulFL < tlsfFL_INDEX_COUNT )
+			{
+				/* First look for a non empty list in the same first level
+				range, then in the next non empty range above it. */
+				ulMap = ulSLBitmap[ ulFL ] & ( ~0UL << ulSL );
+
+				if( ulMap == 0UL )
+				{
+					ulMap = ( ulFL < 31UL ) ? ( ulFLBitmap & ( ~0UL << ( ulFL + 1UL ) ) ) : 0UL;
+
+					if( ulMap != 0UL )
+					{
+						ulFL = tlsfFFS( ulMap );
+						ulMap = ulSLBitmap[ ulFL ];
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( ulMap != 0UL )
+				{
+					ulSL = tlsfFFS( ulMap );
+					pxBlock = pxFreeLists[ ulFL ][ ulSL ];
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxBlock != NULL )
+			{
+				/* This block is being returned for use so must be taken out
+				of the list of free blocks. */
+				prvRemoveFreeBlock( pxBlock );
+
+				/* If the block is larger than required it can be split into
+				two. */
+				if( ( tlsfBLOCK_SIZE( pxBlock ) - xWantedSize ) >= xMinimumBlockSize )
+				{
+					/* Create a new block following the number of bytes
+					requested.  The void cast is used to prevent byte alignment
+					warnings from the compiler. */
+					pxNewBlock = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+					pxNewBlock->xBlockSize = tlsfBLOCK_SIZE( pxBlock ) - xWantedSize;
+					pxNewBlock->pxPrevPhysBlock = pxBlock;
+					tlsfNEXT_PHYS_BLOCK( pxNewBlock )->pxPrevPhysBlock = pxNewBlock;
+					pxBlock->xBlockSize = xWantedSize;
+
+					/* Insert the new block into the list of free blocks. */
+					prvInsertFreeBlock( pxNewBlock );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xFreeBytesRemaining -= tlsfBLOCK_SIZE( pxBlock );
+
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Return the memory space pointed to - jumping over the block
+				header at its start. */
+				pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+				xNumberOfSuccessfulAllocations++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+TLSFBlock_t *pxBlock, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a block header immediately before
+		it.  This casting is to keep the compiler from issuing warnings. */
+		puc -= xHeapStructSize;
+		pxBlock = ( void * ) puc;
+
+		/* Check the block is actually allocated. */
+		configASSERT( tlsfBLOCK_IS_FREE( pxBlock ) == pdFALSE );
+
+		if( tlsfBLOCK_IS_FREE( pxBlock ) == pdFALSE )
+		{
+			vTaskSuspendAll();
+			{
+				xFreeBytesRemaining += tlsfBLOCK_SIZE( pxBlock );
+				traceFREE( pv, tlsfBLOCK_SIZE( pxBlock ) );
+
+				/* Merge with the block below, if it is free. */
+				pxNeighbour = pxBlock->pxPrevPhysBlock;
+				if( ( pxNeighbour != NULL ) && ( tlsfBLOCK_IS_FREE( pxNeighbour ) != pdFALSE ) )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxNeighbour->xBlockSize += tlsfBLOCK_SIZE( pxBlock );
+					pxBlock = pxNeighbour;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Merge with the block above, if it is free.  The zero sized
+				block at the end of each region is never free. */
+				pxNeighbour = tlsfNEXT_PHYS_BLOCK( pxBlock );
+				if( tlsfBLOCK_IS_FREE( pxNeighbour ) != pdFALSE )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxBlock->xBlockSize += tlsfBLOCK_SIZE( pxNeighbour );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				tlsfNEXT_PHYS_BLOCK( pxBlock )->pxPrevPhysBlock = pxBlock;
+				prvInsertFreeBlock( pxBlock );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, uint32_t *pulFL, uint32_t *pulSL )
+{
+uint32_t ulFL;
+
+	if( xSize < tlsfSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are stored in first level list 0, one second level
+		list per portBYTE_ALIGNMENT step. */
+		*pulFL = 0UL;
+		*pulSL = ( uint32_t ) ( xSize >> tlsfALIGN_SIZE_LOG2 );
+	}
+	else
+	{
+		ulFL = tlsfFLS( xSize );
+		*pulSL = ( uint32_t ) ( xSize >> ( ulFL - configTLSF_SL_INDEX_COUNT_LOG2 ) ) ^ tlsfSL_INDEX_COUNT;
+		*pulFL = ulFL - ( tlsfFL_INDEX_SHIFT - 1UL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock )
+{
+uint32_t ulFL, ulSL;
+
+	prvMappingInsert( tlsfBLOCK_SIZE( pxBlock ), &ulFL, &ulSL );
+	configASSERT( ulFL < tlsfFL_INDEX_COUNT );
+
+	pxBlock->xBlockSize |= tlsfBLOCK_FREE_BIT;
+	pxBlock->pxPrevFree = NULL;
+	pxBlock->pxNextFree = pxFreeLists[ ulFL ][ ulSL ];
+
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ ulFL ][ ulSL ] = pxBlock;
+	ulFLBitmap |= ( 1UL << ulFL );
+	ulSLBitmap[ ulFL ] |= ( 1UL << ulSL );
+	xNumberOfFreeBlocks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock )
+{
+uint32_t ulFL, ulSL;
+
+	pxBlock->xBlockSize &= ~tlsfBLOCK_FREE_BIT;
+	prvMappingInsert( pxBlock->xBlockSize, &ulFL, &ulSL );
+
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock->pxPrevFree != NULL )
+	{
+		pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+	}
+	else
+	{
+		/* The block was at the head of its list.  Clear the bit map entries
+		if the list is now empty. */
+		pxFreeLists[ ulFL ][ ulSL ] = pxBlock->pxNextFree;
+
+		if( pxBlock->pxNextFree == NULL )
+		{
+			ulSLBitmap[ ulFL ] &= ~( 1UL << ulSL );
+
+			if( ulSLBitmap[ ulFL ] == 0UL )
+			{
+				ulFLBitmap &= ~( 1UL << ulFL );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	xNumberOfFreeBlocks--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddRegion( uint8_t *pucStartAddress, size_t xSizeInBytes )
+{
+TLSFBlock_t *pxFirstBlock, *pxEndBlock;
+size_t xAddress, xEndAddress;
+
+	#if( configTLSF_USE_DEFAULT_HEAP == 1 )
+	{
+		/* ucHeap is always the first region, so that vPortDefineHeapRegions()
+		can be called before or after the first allocation. */
+		if( xHeapInitialised == pdFALSE )
+		{
+			xHeapInitialised = pdTRUE;
+
+			if( pucStartAddress != ucHeap )
+			{
+				prvAddRegion( ucHeap, configTOTAL_HEAP_SIZE );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	/* Ensure the region starts and ends on a correctly aligned boundary. */
+	xAddress = ( ( size_t ) pucStartAddress + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	xEndAddress = ( ( size_t ) pucStartAddress + xSizeInBytes ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	/* The region must hold at least one minimum sized block plus the end
+	marker. */
+	if( ( xEndAddress > xAddress ) && ( ( xEndAddress - xAddress ) >= ( xMinimumBlockSize + xHeapStructSize ) ) )
+	{
+		/* A zero sized, never free, block at the end of the region stops
+		vPortFree() merging past it. */
+		xEndAddress -= xHeapStructSize;
+		pxEndBlock = ( TLSFBlock_t * ) xEndAddress;
+
+		/* To start with there is a single free block in the region that is
+		sized to take up the entire region minus the end marker. */
+		pxFirstBlock = ( TLSFBlock_t * ) xAddress;
+		pxFirstBlock->pxPrevPhysBlock = NULL;
+		pxFirstBlock->xBlockSize = xEndAddress - xAddress;
+
+		/* Blocks larger than the lists can index are not supported. */
+		configASSERT( pxFirstBlock->xBlockSize < ( ( size_t ) 1 << configTLSF_FL_INDEX_MAX ) );
+
+		pxEndBlock->pxPrevPhysBlock = pxFirstBlock;
+		pxEndBlock->xBlockSize = 0;
+
+		prvInsertFreeBlock( pxFirstBlock );
+
+		/* The free bit is set now, so it must be masked out of the size. */
+		xFreeBytesRemaining += tlsfBLOCK_SIZE( pxFirstBlock );
+		xMinimumEverFreeBytesRemaining += tlsfBLOCK_SIZE( pxFirstBlock );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+const HeapRegion_t *pxHeapRegion;
+
+	vTaskSuspendAll();
+	{
+		for( pxHeapRegion = pxHeapRegions; pxHeapRegion->xSizeInBytes > 0; pxHeapRegion++ )
+		{
+			prvAddRegion( pxHeapRegion->pucStartAddress, pxHeapRegion->xSizeInBytes );
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	/* Check something was actually defined before it is accessed. */
+	configASSERT( xFreeBytesRemaining );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+TLSFBlock_t *pxBlock;
+uint32_t ulFL, ulSL;
+size_t xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+	vTaskSuspendAll();
+	{
+		/* The lists are ordered by size class, so the largest free block is on
+		the highest non empty list and the smallest on the lowest one.  Only
+		those two lists need to be walked. */
+		if( ulFLBitmap != 0UL )
+		{
+			ulFL = tlsfFLS( ulFLBitmap );
+			ulSL = tlsfFLS( ulSLBitmap[ ulFL ] );
+
+			for( pxBlock = pxFreeLists[ ulFL ][ ulSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+			{
+				if( tlsfBLOCK_SIZE( pxBlock ) > xMaxSize )
+				{
+					xMaxSize = tlsfBLOCK_SIZE( pxBlock );
+				}
+			}
+
+			ulFL = tlsfFFS( ulFLBitmap );
+			ulSL = tlsfFFS( ulSLBitmap[ ulFL ] );
+
+			for( pxBlock = pxFreeLists[ ulFL ][ ulSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+			{
+				if( tlsfBLOCK_SIZE( pxBlock ) < xMinSize )
+				{
+					xMinSize = tlsfBLOCK_SIZE( pxBlock );
+				}
+			}
+		}
+	}
+	xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+
+	taskENTER_CRITICAL();
+	{
+		pxHeapStats->xNumberOfFreeBlocks = xNumberOfFreeBlocks;
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if !defined( portCOUNT_LEADING_ZEROS ) && !defined( __GNUC__ )
+
+	static uint32_t prvFindLastSet( uint32_t ulValue )
+	{
+	uint32_t ulBit = 0UL;
+
+		while( ulValue > 1UL )
+		{
+			ulValue >>= 1;
+			ulBit++;
+		}
+
+		return ulBit;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#endif /* USE_FreeRTOS_HEAP_TLSF */
@@ -125,22 +125,33 @@ extern void vPortExitCritical( void );
 
 #if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
 
-	/* Check the configuration. */
-	#if( configMAX_PRIORITIES > 32 )
-		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
-	#endif
+	#define portCOUNT_LEADING_ZEROS( ulBitmap ) ( ( uint32_t ) __clz( ( ulBitmap ) ) )
+
+	/* Up to 32 priorities fit in a single word bit map.  Above that the kernel
+	keeps a two level bit map itself and only uses portCOUNT_LEADING_ZEROS(). */
+	#if( configMAX_PRIORITIES <= 32 )
+
+		/* Store/clear the ready priorities in a bit map. */
+		#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+		#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
 
-	/* Store/clear the ready priorities in a bit map. */
-	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
-	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+		/*-----------------------------------------------------------*/
 
-	/*-----------------------------------------------------------*/
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - portCOUNT_LEADING_ZEROS( ( uxReadyPriorities ) ) )
 
-	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( uint32_t ) __clz( ( uxReadyPriorities ) ) )
+	#endif
 
 #endif /* taskRECORD_READY_PRIORITY */
 /*-----------------------------------------------------------*/
 
+/* Exclusive access to a 32-bit word.  portSTORE_EXCLUSIVE() returns 0 if the
+store succeeded.  Exception entry and return clear the local monitor, so the
+store fails if anything ran since the matching portLOAD_EXCLUSIVE(). */
+#define portLOAD_EXCLUSIVE( pxAddress )				__ldrex( ( pxAddress ) )
+#define portSTORE_EXCLUSIVE( xValue, pxAddress )	__strex( ( xValue ), ( pxAddress ) )
+#define portCLEAR_EXCLUSIVE()						__clrex()
+/*-----------------------------------------------------------*/
+
 /* Task function macros as described on the FreeRTOS.org WEB site.  These are
 not necessary for to use this port.  They are defined so the common demo files
 (which build with all the ports) will build. */
@@ -37,6 +37,10 @@ task.h is included from an application file. */
 #include "task.h"
 #include "queue.h"
 
+#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	#include "timers.h"
+#endif
+
 #if ( configUSE_CO_ROUTINES == 1 )
 	#include "croutine.h"
 #endif
@@ -81,6 +85,17 @@ zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH ( ( UBaseType_t ) 0 )
 #define queueMUTEX_GIVE_BLOCK_TIME		 ( ( TickType_t ) 0U )
 
+/* True if a task is blocked waiting to receive from the queue and should be
+woken now.  With configUSE_BATCHED_WAKEUP the receiver is left blocked until
+uxWakeThreshold items are waiting, so a burst of sends costs one context
+switch.  If the queue has a wake latency the first item of a batch also arms
+xWakeTimer, which wakes the receiver if the rest of the batch is late. */
+#if( configUSE_BATCHED_WAKEUP == 1 )
+	#define queueRECEIVER_TO_WAKE( pxQueue ) ( prvReceiverToWake( pxQueue ) != pdFALSE )
+#else
+	#define queueRECEIVER_TO_WAKE( pxQueue ) ( listLIST_IS_EMPTY( &( ( pxQueue )->xTasksWaitingToReceive ) ) == pdFALSE )
+#endif
+
 #if( configUSE_PREEMPTION == 0 )
 	/* If the cooperative scheduler is being used then a yield should not be
 	performed just because a higher priority task has been woken. */
@@ -128,6 +143,16 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_BATCHED_WAKEUP == 1 )
+		UBaseType_t uxWakeThreshold;	/*< The number of items that must be waiting before a blocked receiver is woken. */
+	#endif
+
+	#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+		TimerHandle_t xWakeTimer;		/*< Wakes the receiver xWakeLatency ticks after the first item of a batch.  NULL until a latency is set. */
+		TickType_t xWakeLatency;		/*< portMAX_DELAY if a batch is held until the threshold is reached. */
+		UBaseType_t uxWakeTimerArmed;	/*< pdTRUE from the item that armed xWakeTimer until the receiver is woken. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -231,6 +256,24 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	 */
 	static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
+
+#if ( configUSE_BATCHED_WAKEUP == 1 )
+	/*
+	 * Returns pdTRUE if a receiver is blocked and the wake threshold is met.
+	 * Below the threshold, with items waiting, it arms the wake latency timer
+	 * if that is not armed already; once the threshold is met it disarms it.
+	 * Must be called with interrupts masked.
+	 */
+	static BaseType_t prvReceiverToWake( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	/*
+	 * The callback of xWakeTimer.  Runs in the timer task and wakes the
+	 * receiver if it is still blocked with items waiting.
+	 */
+	static void prvWakeLatencyCallback( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -445,6 +488,20 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	pxNewQueue->uxItemSize = uxItemSize;
 	( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
 
+	#if ( configUSE_BATCHED_WAKEUP == 1 )
+	{
+		pxNewQueue->uxWakeThreshold = ( UBaseType_t ) 1U;
+	}
+	#endif /* configUSE_BATCHED_WAKEUP */
+
+	#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	{
+		pxNewQueue->xWakeTimer = NULL;
+		pxNewQueue->xWakeLatency = portMAX_DELAY;
+		pxNewQueue->uxWakeTimerArmed = pdFALSE;
+	}
+	#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
 	#if ( configUSE_TRACE_FACILITY == 1 )
 	{
 		pxNewQueue->ucQueueType = ucQueueType;
@@ -799,7 +856,7 @@ Queue_t * const pxQueue = xQueue;
 					{
 						/* If there was a task waiting for data to arrive on the
 						queue then unblock it now. */
-						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+						if( queueRECEIVER_TO_WAKE( pxQueue ) )
 						{
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
@@ -834,7 +891,7 @@ Queue_t * const pxQueue = xQueue;
 
 					/* If there was a task waiting for data to arrive on the
 					queue then unblock it now. */
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( queueRECEIVER_TO_WAKE( pxQueue ) )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -1030,7 +1087,7 @@ Queue_t * const pxQueue = xQueue;
 					}
 					else
 					{
-						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+						if( queueRECEIVER_TO_WAKE( pxQueue ) )
 						{
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
@@ -1058,7 +1115,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#else /* configUSE_QUEUE_SETS */
 				{
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( queueRECEIVER_TO_WAKE( pxQueue ) )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -1198,7 +1255,7 @@ Queue_t * const pxQueue = xQueue;
 					}
 					else
 					{
-						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+						if( queueRECEIVER_TO_WAKE( pxQueue ) )
 						{
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
@@ -1226,7 +1283,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#else /* configUSE_QUEUE_SETS */
 				{
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( queueRECEIVER_TO_WAKE( pxQueue ) )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -1972,6 +2029,217 @@ Queue_t * const pxQueue = xQueue;
 } /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_BATCHED_WAKEUP == 1 )
+
+	void vQueueSetWakeThreshold( QueueHandle_t xQueue, UBaseType_t uxItems )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( ( uxItems > ( UBaseType_t ) 0U ) && ( uxItems <= pxQueue->uxLength ) );
+
+		taskENTER_CRITICAL();
+		{
+			pxQueue->uxWakeThreshold = uxItems;
+
+			/* A lower threshold may already be met by the items waiting. */
+			if( queueRECEIVER_TO_WAKE( pxQueue ) )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReceiverToWake( Queue_t * const pxQueue )
+	{
+	BaseType_t xReturn;
+
+		if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+		{
+			xReturn = pdFALSE;
+		}
+		else if( pxQueue->uxMessagesWaiting >= pxQueue->uxWakeThreshold )
+		{
+			#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+			{
+				if( pxQueue->uxWakeTimerArmed != pdFALSE )
+				{
+					pxQueue->uxWakeTimerArmed = pdFALSE;
+					( void ) xTimerDisarmFromISR( pxQueue->xWakeTimer );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+			{
+				/* The first item of the batch starts the latency.  Arming the
+				timer may ready the timer task, which then runs by priority
+				like any other task: it only has to read the wheel again before
+				the latency expires, so no switch is requested here. */
+				if( ( pxQueue->xWakeLatency != portMAX_DELAY ) && ( pxQueue->uxWakeTimerArmed == pdFALSE ) && ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0U ) )
+				{
+					pxQueue->uxWakeTimerArmed = pdTRUE;
+					( void ) xTimerArmFromISR( pxQueue->xWakeTimer, pxQueue->xWakeLatency, NULL );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_BATCHED_WAKEUP */
+/*-----------------------------------------------------------*/
+
+#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+
+	BaseType_t xQueueSetWakeLatency( QueueHandle_t xQueue, TickType_t xMaxLatency )
+	{
+	Queue_t * const pxQueue = xQueue;
+	BaseType_t xReturn = pdPASS;
+
+		configASSERT( pxQueue );
+		configASSERT( xMaxLatency > ( TickType_t ) 0U );
+
+		if( ( xMaxLatency != portMAX_DELAY ) && ( pxQueue->xWakeTimer == NULL ) )
+		{
+			/* The period is given each time the timer is armed. */
+			pxQueue->xWakeTimer = xTimerCreate( "QWake", xMaxLatency, pdFALSE, ( void * ) pxQueue, prvWakeLatencyCallback );
+
+			if( pxQueue->xWakeTimer == NULL )
+			{
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xReturn != pdFAIL )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxQueue->xWakeLatency = xMaxLatency;
+
+				/* A batch already waiting is held for the new latency from
+				now, or until the threshold is reached. */
+				if( pxQueue->uxWakeTimerArmed != pdFALSE )
+				{
+					pxQueue->uxWakeTimerArmed = pdFALSE;
+					( void ) xTimerDisarm( pxQueue->xWakeTimer );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( queueRECEIVER_TO_WAKE( pxQueue ) )
+				{
+					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+					{
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvWakeLatencyCallback( TimerHandle_t xTimer )
+	{
+	Queue_t *pxQueue;
+
+		/* vQueueDelete() clears the timer ID with the scheduler suspended, so
+		the queue read here stays valid until the scheduler is resumed. */
+		vTaskSuspendAll();
+		{
+			pxQueue = ( Queue_t * ) pvTimerGetTimerID( xTimer );
+
+			if( pxQueue != NULL )
+			{
+				taskENTER_CRITICAL();
+				{
+					/* A batch that started since the timer expired armed it
+					again, and is now bounded by that. */
+					if( xTimerIsTimerActive( xTimer ) == pdFALSE )
+					{
+						pxQueue->uxWakeTimerArmed = pdFALSE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The receiver may have been woken some other way since. */
+					if( ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0U ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ) )
+					{
+						( void ) xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				taskEXIT_CRITICAL();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+
+#endif /* tmrBATCH_LATENCY_POSSIBLE */
+/*-----------------------------------------------------------*/
+
 void vQueueDelete( QueueHandle_t xQueue )
 {
 Queue_t * const pxQueue = xQueue;
@@ -1979,6 +2247,28 @@ Queue_t * const pxQueue = xQueue;
 	configASSERT( pxQueue );
 	traceQUEUE_DELETE( pxQueue );
 
+	#if ( tmrBATCH_LATENCY_POSSIBLE == 1 )
+	{
+		if( pxQueue->xWakeTimer != NULL )
+		{
+			/* A callback that has not yet read the timer ID finds NULL and
+			leaves the queue alone. */
+			vTaskSuspendAll();
+			{
+				vTimerSetTimerID( pxQueue->xWakeTimer, NULL );
+				( void ) xTimerDisarm( pxQueue->xWakeTimer );
+			}
+			( void ) xTaskResumeAll();
+
+			( void ) xTimerDelete( pxQueue->xWakeTimer, portMAX_DELAY );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* tmrBATCH_LATENCY_POSSIBLE */
+
 	#if ( configQUEUE_REGISTRY_SIZE > 0 )
 	{
 		vQueueUnregisterQueue( pxQueue );
@@ -2206,7 +2496,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 					/* Tasks that are removed from the event list will get
 					added to the pending ready list as the scheduler is still
 					suspended. */
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( queueRECEIVER_TO_WAKE( pxQueue ) )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -2229,7 +2519,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 			{
 				/* Tasks that are removed from the event list will get added to
 				the pending ready list as the scheduler is still suspended. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+				if( queueRECEIVER_TO_WAKE( pxQueue ) )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
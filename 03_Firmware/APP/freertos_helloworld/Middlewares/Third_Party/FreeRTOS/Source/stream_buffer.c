@@ -134,6 +134,62 @@ that uses task notifications. */
 /* Bits stored in the ucFlags field of the stream buffer. */
 #define sbFLAGS_IS_MESSAGE_BUFFER		( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
 #define sbFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
+#define sbFLAGS_IS_MULTI_PRODUCER		( ( uint8_t ) 4 ) /* Set if the stream buffer was created with sbTYPE_MULTI_PRODUCER, in which case any number of tasks and interrupts can write to it at once. */
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	/* Writers to a multi-producer buffer claim space by advancing ulClaim, copy
+	their data into the claimed space without holding any lock, then release
+	the claim.  ulClaim holds the index of the next free byte in its low bits
+	and the number of writers still copying in its top byte.  xHead is only
+	moved up to the claim index by a writer that finds no other writer still
+	copying, so the reader never sees a region that is not completely written,
+	and data is published in the order it was claimed. */
+	#define sbCLAIM_INDEX_MASK		( ( uint32_t ) 0x00ffffffUL )
+	#define sbCLAIM_WRITER_INC		( ( uint32_t ) 0x01000000UL )
+
+	/* The claim and publish sequences use the port's exclusive access
+	instructions where available.  On a single core any interrupt or context
+	switch between the load and the store clears the exclusive monitor, so a
+	successful store proves nothing else ran in between.  Without exclusive
+	access the same sequences run with interrupts masked instead. */
+	#if defined( portLOAD_EXCLUSIVE )
+		#define sbCLAIM_DECLARE
+		#define sbCLAIM_LOAD( pxAddress )				portLOAD_EXCLUSIVE( pxAddress )
+		#define sbCLAIM_STORE( xValue, pxAddress )		portSTORE_EXCLUSIVE( ( xValue ), ( pxAddress ) )
+		#define sbCLAIM_ABANDON()						portCLEAR_EXCLUSIVE()
+	#else
+		#define sbCLAIM_DECLARE							UBaseType_t uxClaimMask;
+		#define sbCLAIM_LOAD( pxAddress )				( uxClaimMask = portSET_INTERRUPT_MASK_FROM_ISR(), *( pxAddress ) )
+		#define sbCLAIM_STORE( xValue, pxAddress )		( *( pxAddress ) = ( xValue ), portCLEAR_INTERRUPT_MASK_FROM_ISR( uxClaimMask ), 0 )
+		#define sbCLAIM_ABANDON()						portCLEAR_INTERRUPT_MASK_FROM_ISR( uxClaimMask )
+	#endif
+
+	/* sbSEND_COMPLETED() only suspends the scheduler, so an interrupt that
+	publishes to the same buffer can notify the reader and clear
+	xTaskWaitingToReceive between its test and its xTaskNotify().  A task
+	writing to a multi-producer buffer takes the handle with interrupts masked
+	instead, and notifies the copy. */
+	#ifndef sbSEND_COMPLETED_MULTI_PRODUCER
+		#define sbSEND_COMPLETED_MULTI_PRODUCER( pxStreamBuffer )						\
+		{																				\
+		TaskHandle_t xReceiver;															\
+																						\
+			taskENTER_CRITICAL();														\
+			{																			\
+				xReceiver = ( pxStreamBuffer )->xTaskWaitingToReceive;					\
+				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
+			}																			\
+			taskEXIT_CRITICAL();														\
+																						\
+			if( xReceiver != NULL )														\
+			{																			\
+				( void ) xTaskNotify( xReceiver, ( uint32_t ) 0, eNoAction );			\
+			}																			\
+		}
+	#endif /* sbSEND_COMPLETED_MULTI_PRODUCER */
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
 
 /*-----------------------------------------------------------*/
 
@@ -152,6 +208,10 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxStreamBufferNumber;		/* Used for tracing purposes. */
 	#endif
+
+	#if ( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		volatile uint32_t ulClaim;			/* Multi-producer buffers only.  Index of the next byte to claim, and the number of writers still copying. */
+	#endif
 } StreamBuffer_t;
 
 /*
@@ -160,12 +220,13 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
 
 /*
- * Add xCount bytes from pucData into the pxStreamBuffer message buffer.
- * Returns the number of bytes written, which will either equal xCount in the
- * success case, or 0 if there was not enough space in the buffer (in which case
- * no data is written into the buffer).
+ * Copies xCount bytes from pucData into the pxStreamBuffer storage area,
+ * starting at index xHead and wrapping at the end of the buffer.  The caller
+ * must already have checked there is space.  Returns the index following the
+ * last byte written, which is only made visible to the reader once the caller
+ * stores it in pxStreamBuffer->xHead.
  */
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount ) PRIVILEGED_FUNCTION;
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount, size_t xHead ) PRIVILEGED_FUNCTION;
 
 /*
  * If the stream buffer is being used as a message buffer, then reads an entire
@@ -212,6 +273,40 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  size_t xTriggerLevelBytes,
 										  uint8_t ucFlags ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	/*
+	 * Writes a message or a run of stream bytes into a multi-producer buffer:
+	 * claims the space, copies the data and releases the claim.  Returns the
+	 * number of data bytes written.  *pxPublished is set to pdTRUE if this
+	 * writer moved xHead, in which case it is the one that must notify the
+	 * reader.
+	 */
+	static size_t prvWriteMessageMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+												const void * pvTxData,
+												size_t xDataLengthBytes,
+												size_t xRequiredSpace,
+												BaseType_t * const pxPublished ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Claims between xMinimumSpace and xRequiredSpace bytes of free space.
+	 * Returns the number of bytes claimed, or 0 if not even xMinimumSpace bytes
+	 * are free, and sets *pxStart to the index of the first claimed byte.
+	 */
+	static size_t prvClaimSpace( StreamBuffer_t * const pxStreamBuffer,
+								 size_t xRequiredSpace,
+								 size_t xMinimumSpace,
+								 size_t * const pxStart ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Releases a claim made by prvClaimSpace() once its bytes are written, and
+	 * publishes everything claimed so far if no other writer is still copying.
+	 * Returns pdTRUE if xHead was moved.
+	 */
+	static BaseType_t prvReleaseClaim( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -225,7 +320,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 		(that is, it will hold discrete messages with a little meta data that
 		says how big the next message is) check the buffer will be large enough
 		to hold at least one message. */
-		if( xIsMessageBuffer == pdTRUE )
+		if( ( xIsMessageBuffer & sbTYPE_MESSAGE_BUFFER ) != pdFALSE )
 		{
 			/* Is a message buffer but not statically allocated. */
 			ucFlags = sbFLAGS_IS_MESSAGE_BUFFER;
@@ -239,6 +334,26 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 		}
 		configASSERT( xTriggerLevelBytes <= xBufferSizeBytes );
 
+		#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		{
+			if( ( xIsMessageBuffer & sbTYPE_MULTI_PRODUCER ) != pdFALSE )
+			{
+				/* Indexes into a multi-producer buffer must fit the claim word. */
+				ucFlags |= sbFLAGS_IS_MULTI_PRODUCER;
+				configASSERT( xBufferSizeBytes < ( size_t ) sbCLAIM_INDEX_MASK );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			configASSERT( ( xIsMessageBuffer & sbTYPE_MULTI_PRODUCER ) == pdFALSE );
+		}
+		#endif
+		xIsMessageBuffer &= sbTYPE_MESSAGE_BUFFER;
+
 		/* A trigger level of 0 would cause a waiting task to unblock even when
 		the buffer was empty. */
 		if( xTriggerLevelBytes == ( size_t ) 0 )
@@ -301,7 +416,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 			xTriggerLevelBytes = ( size_t ) 1;
 		}
 
-		if( xIsMessageBuffer != pdFALSE )
+		if( ( xIsMessageBuffer & sbTYPE_MESSAGE_BUFFER ) != pdFALSE )
 		{
 			/* Statically allocated message buffer. */
 			ucFlags = sbFLAGS_IS_MESSAGE_BUFFER | sbFLAGS_IS_STATICALLY_ALLOCATED;
@@ -312,6 +427,26 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 			ucFlags = sbFLAGS_IS_STATICALLY_ALLOCATED;
 		}
 
+		#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		{
+			if( ( xIsMessageBuffer & sbTYPE_MULTI_PRODUCER ) != pdFALSE )
+			{
+				/* Indexes into a multi-producer buffer must fit the claim word. */
+				ucFlags |= sbFLAGS_IS_MULTI_PRODUCER;
+				configASSERT( xBufferSizeBytes <= ( size_t ) sbCLAIM_INDEX_MASK );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			configASSERT( ( xIsMessageBuffer & sbTYPE_MULTI_PRODUCER ) == pdFALSE );
+		}
+		#endif
+		xIsMessageBuffer &= sbTYPE_MESSAGE_BUFFER;
+
 		/* In case the stream buffer is going to be used as a message buffer
 		(that is, it will hold discrete messages with a little meta data that
 		says how big the next message is) check the buffer will be large enough
@@ -413,7 +548,12 @@ BaseType_t xReturn = pdFAIL;
 	{
 		if( pxStreamBuffer->xTaskWaitingToReceive == NULL )
 		{
-			if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+				/* Nor while a producer is part way through writing to it. */
+				if( ( pxStreamBuffer->xTaskWaitingToSend == NULL ) && ( ( pxStreamBuffer->ulClaim & ~sbCLAIM_INDEX_MASK ) == ( uint32_t ) 0 ) )
+			#else
+				if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#endif
 			{
 				prvInitialiseNewStreamBuffer( pxStreamBuffer,
 											  pxStreamBuffer->pucBuffer,
@@ -470,12 +610,30 @@ BaseType_t xReturn;
 size_t xStreamBufferSpacesAvailable( StreamBufferHandle_t xStreamBuffer )
 {
 const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-size_t xSpace;
+size_t xSpace, xHead;
 
 	configASSERT( pxStreamBuffer );
 
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	{
+		/* Space claimed by a producer that is still copying is not free. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xHead = ( size_t ) ( pxStreamBuffer->ulClaim & sbCLAIM_INDEX_MASK );
+		}
+		else
+		{
+			xHead = pxStreamBuffer->xHead;
+		}
+	}
+	#else
+	{
+		xHead = pxStreamBuffer->xHead;
+	}
+	#endif
+
 	xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-	xSpace -= pxStreamBuffer->xHead;
+	xSpace -= xHead;
 	xSpace -= ( size_t ) 1;
 
 	if( xSpace >= pxStreamBuffer->xLength )
@@ -512,6 +670,7 @@ StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 size_t xReturn, xSpace = 0;
 size_t xRequiredSpace = xDataLengthBytes;
 TimeOut_t xTimeOut;
+BaseType_t xPublished = pdTRUE;
 
 	configASSERT( pvTxData );
 	configASSERT( pxStreamBuffer );
@@ -546,6 +705,24 @@ TimeOut_t xTimeOut;
 
 				if( xSpace < xRequiredSpace )
 				{
+					#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+					{
+						/* Producers to a multi-producer buffer share the one
+						waiting slot.  If another task is already waiting for
+						space then return as if no block time was given. */
+						if( ( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 ) &&
+							( pxStreamBuffer->xTaskWaitingToSend != NULL ) )
+						{
+							taskEXIT_CRITICAL();
+							break;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					#endif
+
 					/* Clear notification state as going to wait for space. */
 					( void ) xTaskNotifyStateClear( NULL );
 
@@ -581,16 +758,36 @@ TimeOut_t xTimeOut;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xReturn = prvWriteMessageMultiProducer( pxStreamBuffer, pvTxData, xDataLengthBytes, xRequiredSpace, &xPublished );
+		}
+		else
+	#endif
+	{
+		xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	}
 
 	if( xReturn > ( size_t ) 0 )
 	{
 		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
 
-		/* Was a task waiting for the data? */
-		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		/* Was a task waiting for the data?  In a multi-producer buffer only
+		the writer that published the data checks, so a batch of writes that
+		completes together wakes the reader once. */
+		if( ( xPublished != pdFALSE ) && ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) )
 		{
-			sbSEND_COMPLETED( pxStreamBuffer );
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+				if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+				{
+					sbSEND_COMPLETED_MULTI_PRODUCER( pxStreamBuffer );
+				}
+				else
+			#endif
+			{
+				sbSEND_COMPLETED( pxStreamBuffer );
+			}
 		}
 		else
 		{
@@ -615,6 +812,7 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 size_t xReturn, xSpace;
 size_t xRequiredSpace = xDataLengthBytes;
+BaseType_t xPublished = pdTRUE;
 
 	configASSERT( pvTxData );
 	configASSERT( pxStreamBuffer );
@@ -632,13 +830,22 @@ size_t xRequiredSpace = xDataLengthBytes;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xReturn = prvWriteMessageMultiProducer( pxStreamBuffer, pvTxData, xDataLengthBytes, xRequiredSpace, &xPublished );
+		}
+		else
+	#endif
+	{
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+		xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	}
 
 	if( xReturn > ( size_t ) 0 )
 	{
 		/* Was a task waiting for the data? */
-		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		if( ( xPublished != pdFALSE ) && ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) )
 		{
 			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
 		}
@@ -666,6 +873,7 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 {
 	BaseType_t xShouldWrite;
 	size_t xReturn;
+	size_t xNextHead = pxStreamBuffer->xHead;
 
 	if( xSpace == ( size_t ) 0 )
 	{
@@ -688,7 +896,7 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 		into the buffer.  Start by writing the length of the data, the data
 		itself will be written later in this function. */
 		xShouldWrite = pdTRUE;
-		( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH );
+		xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
 	}
 	else
 	{
@@ -698,8 +906,10 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 
 	if( xShouldWrite != pdFALSE )
 	{
-		/* Writes the data itself. */
-		xReturn = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		/* Writes the data itself, then makes the message visible to the
+		reader. */
+		pxStreamBuffer->xHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		xReturn = xDataLengthBytes;
 	}
 	else
 	{
@@ -710,6 +920,170 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	static size_t prvWriteMessageMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+												const void * pvTxData,
+												size_t xDataLengthBytes,
+												size_t xRequiredSpace,
+												BaseType_t * const pxPublished )
+	{
+	size_t xStart, xClaimed, xReturn;
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* A message and its length are claimed as one, or not at all. */
+			xClaimed = prvClaimSpace( pxStreamBuffer, xRequiredSpace, xRequiredSpace, &xStart );
+
+			if( xClaimed != ( size_t ) 0 )
+			{
+				xStart = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xStart );
+				xReturn = xDataLengthBytes;
+			}
+			else
+			{
+				xReturn = 0;
+			}
+		}
+		else
+		{
+			/* Write as many stream bytes as fit. */
+			xClaimed = prvClaimSpace( pxStreamBuffer, xRequiredSpace, ( size_t ) 1, &xStart );
+			xReturn = xClaimed;
+		}
+
+		if( xClaimed != ( size_t ) 0 )
+		{
+			if( xReturn != ( size_t ) 0 )
+			{
+				( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xReturn, xStart ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			*pxPublished = prvReleaseClaim( pxStreamBuffer );
+		}
+		else
+		{
+			*pxPublished = pdFALSE;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static size_t prvClaimSpace( StreamBuffer_t * const pxStreamBuffer,
+								 size_t xRequiredSpace,
+								 size_t xMinimumSpace,
+								 size_t * const pxStart )
+	{
+	uint32_t ulClaim;
+	size_t xStart, xSpace, xCount, xNextClaim;
+	sbCLAIM_DECLARE
+
+		do
+		{
+			ulClaim = sbCLAIM_LOAD( &( pxStreamBuffer->ulClaim ) );
+			xStart = ( size_t ) ( ulClaim & sbCLAIM_INDEX_MASK );
+
+			/* The free space runs from the last claim up to the reader. */
+			xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
+			xSpace -= xStart;
+			xSpace -= ( size_t ) 1;
+
+			if( xSpace >= pxStreamBuffer->xLength )
+			{
+				xSpace -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xSpace < xMinimumSpace )
+			{
+				sbCLAIM_ABANDON();
+				xCount = 0;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* The writer count must not overflow into the index. */
+			configASSERT( ( ulClaim & ~sbCLAIM_INDEX_MASK ) != ~sbCLAIM_INDEX_MASK );
+
+			xCount = configMIN( xRequiredSpace, xSpace );
+			xNextClaim = xStart + xCount;
+
+			if( xNextClaim >= pxStreamBuffer->xLength )
+			{
+				xNextClaim -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+		} while( sbCLAIM_STORE( ( ( ulClaim & ~sbCLAIM_INDEX_MASK ) + sbCLAIM_WRITER_INC ) | ( uint32_t ) xNextClaim, &( pxStreamBuffer->ulClaim ) ) != 0 );
+
+		*pxStart = xStart;
+
+		return xCount;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReleaseClaim( StreamBuffer_t * const pxStreamBuffer )
+	{
+	uint32_t ulClaim;
+	size_t xHead;
+	BaseType_t xPublished = pdFALSE;
+	sbCLAIM_DECLARE
+
+		/* This writer has finished copying. */
+		do
+		{
+			ulClaim = sbCLAIM_LOAD( &( pxStreamBuffer->ulClaim ) );
+			configASSERT( ( ulClaim & ~sbCLAIM_INDEX_MASK ) != ( uint32_t ) 0 );
+
+		} while( sbCLAIM_STORE( ulClaim - sbCLAIM_WRITER_INC, &( pxStreamBuffer->ulClaim ) ) != 0 );
+
+		/* Publish everything claimed so far, but only while no writer is
+		still copying.  If one is, it publishes when it finishes.  The claim
+		word is read inside the exclusive access to xHead so the store fails,
+		and is retried, if any other writer ran in between. */
+		for( ;; )
+		{
+			xHead = ( size_t ) sbCLAIM_LOAD( &( pxStreamBuffer->xHead ) );
+			ulClaim = pxStreamBuffer->ulClaim;
+
+			if( ( ( ulClaim & ~sbCLAIM_INDEX_MASK ) != ( uint32_t ) 0 ) || ( xHead == ( size_t ) ( ulClaim & sbCLAIM_INDEX_MASK ) ) )
+			{
+				/* Another writer is still copying, or one that finished after
+				this one has already published. */
+				sbCLAIM_ABANDON();
+				break;
+			}
+			else if( sbCLAIM_STORE( ( size_t ) ( ulClaim & sbCLAIM_INDEX_MASK ), &( pxStreamBuffer->xHead ) ) == 0 )
+			{
+				xPublished = pdTRUE;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xPublished;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
 							 void *pvRxData,
 							 size_t xBufferLengthBytes,
@@ -1085,13 +1459,13 @@ UBaseType_t uxSavedInterruptStatus;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount, size_t xHead )
 {
 size_t xNextHead, xFirstLength;
 
 	configASSERT( xCount > ( size_t ) 0 );
 
-	xNextHead = pxStreamBuffer->xHead;
+	xNextHead = xHead;
 
 	/* Calculate the number of bytes that can be added in the first write -
 	which may be less than the total number of bytes that need to be added if
@@ -1125,9 +1499,7 @@ size_t xNextHead, xFirstLength;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	pxStreamBuffer->xHead = xNextHead;
-
-	return xCount;
+	return xNextHead;
 }
 /*-----------------------------------------------------------*/
 
@@ -112,6 +112,17 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 	#define configIDLE_TASK_NAME "IDLE"
 #endif
 
+/* Port optimised task selection normally relies on the port keeping the ready
+priorities in a single word bit map, which limits configMAX_PRIORITIES to 32.
+When more priorities are used (CMSIS-RTOS2 needs 56), or the port does not
+provide its own bit map macros (as is the case for host/simulator ports), the
+kernel maintains a two level bit map itself instead. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 ) && ( ( configMAX_PRIORITIES > 32 ) || !defined( portGET_HIGHEST_PRIORITY ) )
+	#define taskUSE_READY_PRIORITY_GROUPS	1
+#else
+	#define taskUSE_READY_PRIORITY_GROUPS	0
+#endif
+
 #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 	/* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
@@ -155,6 +166,102 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 	#define taskRESET_READY_PRIORITY( uxPriority )
 	#define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )
 
+#elif ( taskUSE_READY_PRIORITY_GROUPS == 1 )
+
+	/* Ready priorities are held in a two level bit map.  Bit n of
+	uxTopReadyPriority is set when at least one task in priority group n
+	(priorities n * 32 to n * 32 + 31) is ready, and bit m of
+	uxReadyPriorityGroups[ n ] is set when a task of priority n * 32 + m is
+	ready.  The highest ready priority is then found with two count leading
+	zeros operations, however many priorities are configured. */
+	#if( configMAX_PRIORITIES > 1024 )
+		#error configMAX_PRIORITIES cannot exceed 1024 when configUSE_PORT_OPTIMISED_TASK_SELECTION is 1.
+	#endif
+
+	#define taskREADY_PRIORITY_GROUPS			( ( ( UBaseType_t ) configMAX_PRIORITIES + ( UBaseType_t ) 31U ) >> 5U )
+	#define taskREADY_GROUP( uxPriority )		( ( UBaseType_t ) ( uxPriority ) >> 5U )
+	#define taskREADY_GROUP_BIT( uxPriority )	( ( UBaseType_t ) 1U << ( ( UBaseType_t ) ( uxPriority ) & ( UBaseType_t ) 0x1FU ) )
+
+	/* Ports that have a count leading zeros instruction define
+	portCOUNT_LEADING_ZEROS() in portmacro.h.  Otherwise use the compiler
+	builtin if there is one, or a branch free binary search.  Defining
+	taskNO_BUILTIN_CLZ selects the binary search on any compiler, so that a
+	host build can check it. */
+	#ifndef portCOUNT_LEADING_ZEROS
+		#if defined( __GNUC__ ) && !defined( taskNO_BUILTIN_CLZ )
+			#define portCOUNT_LEADING_ZEROS( ulBitmap )	( ( uint32_t ) __builtin_clz( ( unsigned int ) ( ulBitmap ) ) )
+		#else
+			#define portCOUNT_LEADING_ZEROS( ulBitmap )	prvCountLeadingZeros( ( uint32_t ) ( ulBitmap ) )
+
+			static uint32_t prvCountLeadingZeros( uint32_t ulBitmap )
+			{
+			uint32_t ulZeros, ulShift;
+
+				/* ulBitmap is never 0 as the idle task is always ready. */
+				ulShift = ( uint32_t ) ( ( ulBitmap & 0xFFFF0000UL ) == 0UL ) << 4UL;
+				ulZeros = ulShift;
+				ulBitmap <<= ulShift;
+				ulShift = ( uint32_t ) ( ( ulBitmap & 0xFF000000UL ) == 0UL ) << 3UL;
+				ulZeros += ulShift;
+				ulBitmap <<= ulShift;
+				ulShift = ( uint32_t ) ( ( ulBitmap & 0xF0000000UL ) == 0UL ) << 2UL;
+				ulZeros += ulShift;
+				ulBitmap <<= ulShift;
+				ulShift = ( uint32_t ) ( ( ulBitmap & 0xC0000000UL ) == 0UL ) << 1UL;
+				ulZeros += ulShift;
+				ulBitmap <<= ulShift;
+				ulZeros += ( uint32_t ) ( ( ulBitmap & 0x80000000UL ) == 0UL );
+
+				return ulZeros;
+			}
+		#endif
+	#endif
+
+	/*-----------------------------------------------------------*/
+
+	#define taskRECORD_READY_PRIORITY( uxPriority )														\
+	{																									\
+		uxReadyPriorityGroups[ taskREADY_GROUP( uxPriority ) ] |= taskREADY_GROUP_BIT( uxPriority );	\
+		uxTopReadyPriority |= ( ( UBaseType_t ) 1U << taskREADY_GROUP( uxPriority ) );					\
+	} /* taskRECORD_READY_PRIORITY */
+
+	/*-----------------------------------------------------------*/
+
+	#define taskSELECT_HIGHEST_PRIORITY_TASK()															\
+	{																									\
+	UBaseType_t uxTopGroup, uxTopPriority;																\
+																										\
+		/* Find the highest group that contains ready tasks, then the highest						\
+		priority within that group. */																	\
+		uxTopGroup = ( UBaseType_t ) ( 31UL - portCOUNT_LEADING_ZEROS( uxTopReadyPriority ) );			\
+		uxTopPriority = ( uxTopGroup << 5U ) +															\
+						( UBaseType_t ) ( 31UL - portCOUNT_LEADING_ZEROS( uxReadyPriorityGroups[ uxTopGroup ] ) ); \
+		configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );			\
+		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );			\
+	} /* taskSELECT_HIGHEST_PRIORITY_TASK() */
+
+	/*-----------------------------------------------------------*/
+
+	/* Clear the priority bit, and the group bit too if that was the last ready
+	priority in the group.  Only called once the ready list is known to be
+	empty. */
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyGroups )										\
+	{																									\
+		uxReadyPriorityGroups[ taskREADY_GROUP( uxPriority ) ] &= ~taskREADY_GROUP_BIT( uxPriority );	\
+		if( uxReadyPriorityGroups[ taskREADY_GROUP( uxPriority ) ] == ( UBaseType_t ) 0 )				\
+		{																								\
+			( uxReadyGroups ) &= ~( ( UBaseType_t ) 1U << taskREADY_GROUP( uxPriority ) );				\
+		}																								\
+	}
+
+	#define taskRESET_READY_PRIORITY( uxPriority )														\
+	{																									\
+		if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) == ( UBaseType_t ) 0 )	\
+		{																								\
+			portRESET_READY_PRIORITY( ( uxPriority ), ( uxTopReadyPriority ) );							\
+		}																								\
+	}
+
 #else /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
 
 	/* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 1 then task selection is
@@ -370,6 +477,9 @@ the errno of the currently running task. */
 PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks 	= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xTickCount 				= ( TickType_t ) configINITIAL_TICK_COUNT;
 PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority 		= tskIDLE_PRIORITY;
+#if ( taskUSE_READY_PRIORITY_GROUPS == 1 )
+	PRIVILEGED_DATA static volatile UBaseType_t uxReadyPriorityGroups[ taskREADY_PRIORITY_GROUPS ] = { 0U };
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning 		= pdFALSE;
 PRIVILEGED_DATA static volatile TickType_t xPendedTicks 			= ( TickType_t ) 0U;
 PRIVILEGED_DATA static volatile BaseType_t xYieldPending 			= pdFALSE;
@@ -2146,6 +2256,18 @@ void vTaskSuspendAll( void )
 				uxHigherPriorityReadyTasks = pdTRUE;
 			}
 		}
+		#elif( taskUSE_READY_PRIORITY_GROUPS == 1 )
+		{
+			const UBaseType_t uxLeastSignificantBit = ( UBaseType_t ) 0x01;
+
+			/* With the two level bit map a ready task above the idle priority
+			shows up either as a group other than the first, or as a bit other
+			than the idle priority bit within the first group. */
+			if( ( uxTopReadyPriority > uxLeastSignificantBit ) || ( uxReadyPriorityGroups[ 0 ] > uxLeastSignificantBit ) )
+			{
+				uxHigherPriorityReadyTasks = pdTRUE;
+			}
+		}
 		#else
 		{
 			const UBaseType_t uxLeastSignificantBit = ( UBaseType_t ) 0x01;
@@ -3882,6 +4004,24 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_uxTaskGetStackHighWaterMark */
 /*-----------------------------------------------------------*/
 
+#if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
+
+	configSTACK_DEPTH_TYPE uxTaskGetStackDepth( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+
+		pxTCB = prvGetTCBFromHandle( xTask );
+
+		/* pxStack is the lowest address of the stack and pxEndOfStack the
+		highest valid one whichever way the stack grows.  On a descending
+		stack the top may have been rounded down for alignment, which is not
+		usable and so is not counted. */
+		return ( configSTACK_DEPTH_TYPE ) ( ( pxTCB->pxEndOfStack - pxTCB->pxStack ) + 1 );
+	}
+
+#endif /* ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelete == 1 )
 
 	static void prvDeleteTCB( TCB_t *pxTCB )
@@ -69,6 +69,43 @@ defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
 #define tmrSTATUS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 0x02 )
 #define tmrSTATUS_IS_AUTORELOAD				( ( uint8_t ) 0x04 )
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* Number of levels in the timing wheel.  Each level adds 32 slots (640
+	bytes on a 32-bit port) and multiplies the span of the wheel by 32; timers
+	further out than the span are parked in the top level and cascaded again
+	when it comes round. */
+	#ifndef configTIMER_WHEEL_LEVELS
+		#define configTIMER_WHEEL_LEVELS	4
+	#endif
+
+	#if( configTIMER_WHEEL_LEVELS < 1 ) || ( configTIMER_WHEEL_LEVELS > 6 )
+		#error configTIMER_WHEEL_LEVELS must be between 1 and 6.
+	#endif
+
+	#define tmrWHEEL_SLOT_BITS			( ( UBaseType_t ) 5U )
+	#define tmrWHEEL_SLOTS				( ( UBaseType_t ) 1U << tmrWHEEL_SLOT_BITS )
+	#define tmrWHEEL_SLOT_MASK			( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+	#define tmrWHEEL_SHIFT( uxLevel )	( ( UBaseType_t ) ( uxLevel ) * tmrWHEEL_SLOT_BITS )
+	#define tmrWHEEL_SPAN( uxLevel )	( ( TickType_t ) 1U << tmrWHEEL_SHIFT( uxLevel ) )
+
+	/* The longest delay the wheel holds without parking the timer.  The timer
+	service task also wakes at least this often, so xTimerWheelBase never falls
+	too far behind the tick count. */
+	#define tmrWHEEL_MAX_DELAY			( tmrWHEEL_SPAN( configTIMER_WHEEL_LEVELS ) - ( TickType_t ) 1U )
+
+	/* Index of the least significant set bit of a non zero word.  Ports that
+	provide portCOUNT_LEADING_ZEROS use the CLZ instruction. */
+	#if defined( portCOUNT_LEADING_ZEROS )
+		#define tmrFIND_FIRST_SET( x )	( 31UL - ( uint32_t ) portCOUNT_LEADING_ZEROS( ( x ) & ( 0UL - ( x ) ) ) )
+	#elif defined( __GNUC__ )
+		#define tmrFIND_FIRST_SET( x )	( ( uint32_t ) __builtin_ctz( ( unsigned int ) ( x ) ) )
+	#else
+		#define tmrFIND_FIRST_SET( x )	prvFindFirstSet( ( x ) )
+	#endif
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 {
@@ -132,10 +169,32 @@ timer service task is allowed to access these lists.
 xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
 breaks some kernel aware debuggers, and debuggers that reply on removing the
 static qualifier. */
-PRIVILEGED_DATA static List_t xActiveTimerList1;
-PRIVILEGED_DATA static List_t xActiveTimerList2;
-PRIVILEGED_DATA static List_t *pxCurrentTimerList;
-PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+#if( configUSE_TIMER_WHEEL == 0 )
+	PRIVILEGED_DATA static List_t xActiveTimerList1;
+	PRIVILEGED_DATA static List_t xActiveTimerList2;
+	PRIVILEGED_DATA static List_t *pxCurrentTimerList;
+	PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+#else
+	/* The active timers are held in a hierarchical timing wheel instead.  Level
+	n has tmrWHEEL_SLOTS slots, each covering 32^n ticks, and a timer sits in
+	the lowest level whose span covers its remaining delay.  When the wheel
+	reaches the start of a slot in level n > 0 the timers in it are cascaded
+	into lower levels, so starting, stopping and expiring a timer never
+	depends on how many other timers are active.  A bit map per level marks
+	the occupied slots, so the next expiry time is also found in constant
+	time.  Unlike the lists above the wheel can also be changed directly by
+	xTimerArm() and xTimerArmFromISR(), so it is only accessed with interrupts
+	masked. */
+	PRIVILEGED_DATA static List_t xTimerWheel[ configTIMER_WHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+	PRIVILEGED_DATA static uint32_t ulTimerWheelMap[ configTIMER_WHEEL_LEVELS ];
+
+	/* The next tick the wheel has to process.  Only moved by the timer service
+	task, and never beyond the current tick count plus one. */
+	PRIVILEGED_DATA static TickType_t xTimerWheelBase = ( TickType_t ) 0U;
+
+	/* The tick the timer service task is going to wake at. */
+	PRIVILEGED_DATA static TickType_t xTimerWheelWake = ( TickType_t ) 0U;
+#endif
 
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -176,21 +235,64 @@ static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
- * depending on if the expire time causes a timer counter overflow.
+ * depending on if the expire time causes a timer counter overflow (or into the
+ * timing wheel when configUSE_TIMER_WHEEL is 1).
  */
 static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
 
-/*
- * An active timer has reached its expire time.  Reload the timer if it is an
- * auto-reload timer, then call its callback.
- */
-static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+#if( configUSE_TIMER_WHEEL == 0 )
+
+	/*
+	 * An active timer has reached its expire time.  Reload the timer if it is an
+	 * auto-reload timer, then call its callback.
+	 */
+	static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * The tick count has overflowed.  Switch the timer lists after ensuring the
+	 * current timer list does not still reference some timers.
+	 */
+	static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+#else
+
+	/*
+	 * Add a timer to the wheel slot its expiry time belongs in, or remove it
+	 * from the slot it is in.  Must be called with interrupts masked.
+	 */
+	static void prvWheelInsert( Timer_t * const pxTimer, const TickType_t xExpiryTime ) PRIVILEGED_FUNCTION;
+	static void prvWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * The next tick at which a slot has to be expired or cascaded.  Must be
+	 * called with interrupts masked.
+	 */
+	static TickType_t prvWheelNextEvent( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Process every event due up to xTimeNow: cascade the higher level slots
+	 * that come round and call the callbacks of all the timers that expire, a
+	 * whole slot at a time.
+	 */
+	static void prvWheelAdvance( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Restart a timer with a new period directly in the wheel.  Must be called
+	 * with interrupts masked.  Returns pdTRUE if the timer service task has to
+	 * be woken because the timer now expires before the task would wake.
+	 */
+	static BaseType_t prvWheelArm( Timer_t * const pxTimer, const TickType_t xNewPeriod, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Pended to the timer service task to make it re-read the wheel.
+	 */
+	static void prvWheelWake( void *pvParameter1, uint32_t ulParameter2 ) PRIVILEGED_FUNCTION;
+
+	#if !defined( portCOUNT_LEADING_ZEROS ) && !defined( __GNUC__ )
+		static uint32_t prvFindFirstSet( uint32_t ulValue ) PRIVILEGED_FUNCTION;
+	#endif
 
-/*
- * The tick count has overflowed.  Switch the timer lists after ensuring the
- * current timer list does not still reference some timers.
- */
-static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+#endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -504,6 +606,8 @@ Timer_t *pxTimer = xTimer;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
 {
 BaseType_t xResult;
@@ -543,6 +647,8 @@ Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTi
 	/* Call the timer callback. */
 	pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static portTASK_FUNCTION( prvTimerTask, pvParameters )
@@ -581,6 +687,8 @@ BaseType_t xListWasEmpty;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
 {
 TickType_t xTimeNow;
@@ -665,6 +773,8 @@ TickType_t xNextExpireTime;
 
 	return xNextExpireTime;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
@@ -674,15 +784,26 @@ PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Va
 
 	xTimeNow = xTaskGetTickCount();
 
-	if( xTimeNow < xLastTime )
+	#if( configUSE_TIMER_WHEEL == 0 )
 	{
-		prvSwitchTimerLists();
-		*pxTimerListsWereSwitched = pdTRUE;
+		if( xTimeNow < xLastTime )
+		{
+			prvSwitchTimerLists();
+			*pxTimerListsWereSwitched = pdTRUE;
+		}
+		else
+		{
+			*pxTimerListsWereSwitched = pdFALSE;
+		}
 	}
-	else
+	#else
 	{
+		/* The wheel works on tick differences, so an overflow needs no
+		special handling. */
 		*pxTimerListsWereSwitched = pdFALSE;
+		( void ) xLastTime;
 	}
+	#endif
 
 	xLastTime = xTimeNow;
 
@@ -690,6 +811,8 @@ PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Va
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime )
 {
 BaseType_t xProcessTimerNow = pdFALSE;
@@ -729,6 +852,8 @@ BaseType_t xProcessTimerNow = pdFALSE;
 
 	return xProcessTimerNow;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void	prvProcessReceivedCommands( void )
@@ -770,15 +895,30 @@ TickType_t xTimeNow;
 			software timer. */
 			pxTimer = xMessage.u.xTimerParameters.pxTimer;
 
-			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+			#if( configUSE_TIMER_WHEEL == 0 )
 			{
-				/* The timer is in a list, remove it. */
-				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+				{
+					/* The timer is in a list, remove it. */
+					( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
-			else
+			#else
 			{
-				mtCOVERAGE_TEST_MARKER();
+				/* The timer may also be armed directly from other tasks and
+				interrupts, so the wheel is only changed with interrupts
+				masked. */
+				taskENTER_CRITICAL();
+				{
+					prvWheelRemove( pxTimer );
+				}
+				taskEXIT_CRITICAL();
 			}
+			#endif
 
 			traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
 
@@ -879,6 +1019,8 @@ TickType_t xTimeNow;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvSwitchTimerLists( void )
 {
 TickType_t xNextExpireTime, xReloadTime;
@@ -936,8 +1078,404 @@ BaseType_t xResult;
 	pxCurrentTimerList = pxOverflowTimerList;
 	pxOverflowTimerList = pxTemp;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
+{
+TickType_t xTimeNow;
+
+	vTaskSuspendAll();
+	{
+		xTimeNow = xTaskGetTickCount();
+
+		/* Ticks from xTimerWheelBase up to and including xTimeNow are due. */
+		if( ( TickType_t ) ( xNextExpireTime - xTimerWheelBase ) < ( TickType_t ) ( ( xTimeNow + ( TickType_t ) 1U ) - xTimerWheelBase ) )
+		{
+			( void ) xTaskResumeAll();
+			prvWheelAdvance( xTimeNow );
+		}
+		else
+		{
+			/* Block until the next event or until a command is received,
+			which includes the wake request sent when a timer is armed
+			directly with an earlier expiry time. */
+			vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+			if( xTaskResumeAll() == pdFALSE )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+{
+TickType_t xNextExpireTime;
+
+	/* Record the wake time under the same critical section, so a timer armed
+	directly afterwards can tell whether the task must be woken earlier. */
+	taskENTER_CRITICAL();
+	{
+		xNextExpireTime = prvWheelNextEvent();
+		xTimerWheelWake = xNextExpireTime;
+	}
+	taskEXIT_CRITICAL();
+
+	/* An empty wheel still has a next event, tmrWHEEL_MAX_DELAY ticks out, so
+	the task never blocks indefinitely. */
+	*pxListWasEmpty = pdFALSE;
+
+	return xNextExpireTime;
+}
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime )
+{
+BaseType_t xProcessTimerNow;
+
+	if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= ( ( TickType_t ) ( xNextExpiryTime - xCommandTime ) ) )
+	{
+		/* The expiry time passed between the command being issued and being
+		processed. */
+		listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+		xProcessTimerNow = pdTRUE;
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+		{
+			prvWheelInsert( pxTimer, xNextExpiryTime );
+		}
+		taskEXIT_CRITICAL();
+
+		xProcessTimerNow = pdFALSE;
+	}
+
+	return xProcessTimerNow;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWheelInsert( Timer_t * const pxTimer, const TickType_t xExpiryTime )
+{
+TickType_t xDelay, xSlotTime;
+UBaseType_t uxLevel = ( UBaseType_t ) 0U, uxIndex;
+
+	listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xExpiryTime );
+	listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+	/* Timers are never inserted with an expiry time before the base. */
+	xDelay = xExpiryTime - xTimerWheelBase;
+	xSlotTime = xExpiryTime;
+
+	if( xDelay > tmrWHEEL_MAX_DELAY )
+	{
+		/* Beyond the span of the wheel.  Park the timer in the furthest top
+		level slot, from where it is cascaded again with the delay left. */
+		xDelay = tmrWHEEL_MAX_DELAY;
+		xSlotTime = xTimerWheelBase + tmrWHEEL_MAX_DELAY;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	while( ( xDelay >> tmrWHEEL_SHIFT( uxLevel + ( UBaseType_t ) 1U ) ) != ( TickType_t ) 0U )
+	{
+		uxLevel++;
+	}
+
+	uxIndex = ( UBaseType_t ) ( xSlotTime >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK;
+
+	vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxIndex ] ), &( pxTimer->xTimerListItem ) );
+	ulTimerWheelMap[ uxLevel ] |= ( 1UL << uxIndex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWheelRemove( Timer_t * const pxTimer )
+{
+List_t * const pxSlot = ( List_t * ) listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+UBaseType_t uxSlot;
+
+	if( pxSlot != NULL )
+	{
+		( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+		if( listLIST_IS_EMPTY( pxSlot ) != pdFALSE )
+		{
+			uxSlot = ( UBaseType_t ) ( pxSlot - &( xTimerWheel[ 0 ][ 0 ] ) );
+			ulTimerWheelMap[ uxSlot >> tmrWHEEL_SLOT_BITS ] &= ~( 1UL << ( uxSlot & tmrWHEEL_SLOT_MASK ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvWheelNextEvent( void )
+{
+TickType_t xSlotNumber, xDelay, xNextDelay = tmrWHEEL_MAX_DELAY;
+UBaseType_t uxLevel;
+uint32_t ulMap, ulRotate;
+
+	for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+	{
+		ulMap = ulTimerWheelMap[ uxLevel ];
+
+		if( ulMap != 0UL )
+		{
+			/* The first slot of this level that starts at or after the base.
+			Level 0 slots are a single tick, so that is the base itself. */
+			xSlotNumber = xTimerWheelBase >> tmrWHEEL_SHIFT( uxLevel );
+
+			if( ( xTimerWheelBase & ( tmrWHEEL_SPAN( uxLevel ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+			{
+				xSlotNumber++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Rotate the bit map so that slot is bit 0, then the first set bit
+			is the number of slots until the first occupied one. */
+			ulRotate = ( uint32_t ) xSlotNumber & ( uint32_t ) tmrWHEEL_SLOT_MASK;
+			ulMap = ( ulMap >> ulRotate ) | ( ulMap << ( ( ( uint32_t ) tmrWHEEL_SLOTS - ulRotate ) & ( uint32_t ) tmrWHEEL_SLOT_MASK ) );
+			xSlotNumber += ( TickType_t ) tmrFIND_FIRST_SET( ulMap );
+
+			xDelay = ( TickType_t ) ( xSlotNumber << tmrWHEEL_SHIFT( uxLevel ) ) - xTimerWheelBase;
+
+			if( xDelay < xNextDelay )
+			{
+				xNextDelay = xDelay;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xTimerWheelBase + xNextDelay;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWheelAdvance( const TickType_t xTimeNow )
+{
+TickType_t xEventTime;
+UBaseType_t uxLevel, uxCount;
+List_t *pxSlot;
+Timer_t *pxTimer;
+BaseType_t xDue, xReload, xResult;
+
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			xEventTime = prvWheelNextEvent();
+
+			if( ( TickType_t ) ( xEventTime - xTimerWheelBase ) < ( TickType_t ) ( ( xTimeNow + ( TickType_t ) 1U ) - xTimerWheelBase ) )
+			{
+				/* Nothing happens on the ticks in between, skip them. */
+				xTimerWheelBase = xEventTime;
+				xDue = pdTRUE;
+			}
+			else
+			{
+				xTimerWheelBase = xTimeNow + ( TickType_t ) 1U;
+				xDue = pdFALSE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xDue == pdFALSE )
+		{
+			break;
+		}
+
+		/* Cascade the slots that start at this tick, highest level first so a
+		timer can drop more than one level at once.  Each timer is moved in its
+		own critical section to keep the time interrupts are masked short, and
+		only the timers present at the start are moved. */
+		for( uxLevel = ( UBaseType_t ) configTIMER_WHEEL_LEVELS - ( UBaseType_t ) 1U; uxLevel > ( UBaseType_t ) 0U; uxLevel-- )
+		{
+			if( ( xEventTime & ( tmrWHEEL_SPAN( uxLevel ) - ( TickType_t ) 1U ) ) == ( TickType_t ) 0U )
+			{
+				pxSlot = &( xTimerWheel[ uxLevel ][ ( UBaseType_t ) ( xEventTime >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK ] );
+
+				taskENTER_CRITICAL();
+				{
+					uxCount = listCURRENT_LIST_LENGTH( pxSlot );
+				}
+				taskEXIT_CRITICAL();
+
+				while( uxCount > ( UBaseType_t ) 0U )
+				{
+					uxCount--;
+
+					taskENTER_CRITICAL();
+					{
+						if( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+						{
+							pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+							prvWheelRemove( pxTimer );
+							prvWheelInsert( pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					taskEXIT_CRITICAL();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		/* Expire the level 0 slot.  Every timer in it is due at this tick,
+		except timers the callbacks below arm again, which go to the tail with a
+		later expiry time - so stop at the first timer that is not due. */
+		pxSlot = &( xTimerWheel[ 0 ][ ( UBaseType_t ) xEventTime & tmrWHEEL_SLOT_MASK ] );
+
+		for( ;; )
+		{
+			pxTimer = NULL;
+			xReload = pdFALSE;
+
+			taskENTER_CRITICAL();
+			{
+				if( ( listLIST_IS_EMPTY( pxSlot ) == pdFALSE ) && ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxSlot ) == xEventTime ) )
+				{
+					pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					prvWheelRemove( pxTimer );
+
+					if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+					{
+						xReload = prvInsertTimerInActiveList( pxTimer, ( xEventTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xEventTime );
+					}
+					else
+					{
+						pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( pxTimer == NULL )
+			{
+				break;
+			}
+
+			traceTIMER_EXPIRED( pxTimer );
+
+			if( xReload != pdFALSE )
+			{
+				/* The task is so far behind that the next period has elapsed
+				too.  Reload it through the queue, as the list version does. */
+				xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xEventTime, NULL, tmrNO_DELAY );
+				configASSERT( xResult );
+				( void ) xResult;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+		}
+
+		taskENTER_CRITICAL();
+		{
+			xTimerWheelBase = xEventTime + ( TickType_t ) 1U;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWheelArm( Timer_t * const pxTimer, const TickType_t xNewPeriod, const TickType_t xTimeNow )
+{
+TickType_t xExpiryTime;
+BaseType_t xWakeDaemon;
+
+	prvWheelRemove( pxTimer );
+
+	pxTimer->xTimerPeriodInTicks = xNewPeriod;
+	pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+
+	xExpiryTime = xTimeNow + xNewPeriod;
+	prvWheelInsert( pxTimer, xExpiryTime );
+
+	if( ( TickType_t ) ( xExpiryTime - xTimerWheelBase ) < ( TickType_t ) ( xTimerWheelWake - xTimerWheelBase ) )
+	{
+		xTimerWheelWake = xExpiryTime;
+		xWakeDaemon = pdTRUE;
+	}
+	else
+	{
+		xWakeDaemon = pdFALSE;
+	}
+
+	return xWakeDaemon;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWheelWake( void *pvParameter1, uint32_t ulParameter2 )
+{
+	/* Nothing to do.  Receiving the request is what makes the timer service
+	task read the next expiry time again. */
+	( void ) pvParameter1;
+	( void ) ulParameter2;
+}
+/*-----------------------------------------------------------*/
+
+#if !defined( portCOUNT_LEADING_ZEROS ) && !defined( __GNUC__ )
+
+	static uint32_t prvFindFirstSet( uint32_t ulValue )
+	{
+	uint32_t ulBit = 0UL;
+
+		/* ulValue is never 0. */
+		while( ( ulValue & 1UL ) == 0UL )
+		{
+			ulValue >>= 1UL;
+			ulBit++;
+		}
+
+		return ulBit;
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_WHEEL */
+
 static void prvCheckForValidListAndQueue( void )
 {
 	/* Check that the list from which active timers are referenced, and the
@@ -947,10 +1485,30 @@ static void prvCheckForValidListAndQueue( void )
 	{
 		if( xTimerQueue == NULL )
 		{
-			vListInitialise( &xActiveTimerList1 );
-			vListInitialise( &xActiveTimerList2 );
-			pxCurrentTimerList = &xActiveTimerList1;
-			pxOverflowTimerList = &xActiveTimerList2;
+			#if( configUSE_TIMER_WHEEL == 0 )
+			{
+				vListInitialise( &xActiveTimerList1 );
+				vListInitialise( &xActiveTimerList2 );
+				pxCurrentTimerList = &xActiveTimerList1;
+				pxOverflowTimerList = &xActiveTimerList2;
+			}
+			#else
+			{
+			UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+				{
+					for( uxSlot = ( UBaseType_t ) 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+					{
+						vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+					}
+					ulTimerWheelMap[ uxLevel ] = 0UL;
+				}
+
+				xTimerWheelBase = xTaskGetTickCount();
+				xTimerWheelWake = xTimerWheelBase + tmrWHEEL_MAX_DELAY;
+			}
+			#endif
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
@@ -1098,6 +1656,124 @@ Timer_t * const pxTimer = xTimer;
 #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	BaseType_t xTimerArm( TimerHandle_t xTimer, const TickType_t xNewPeriod )
+	{
+	Timer_t * const pxTimer = xTimer;
+	BaseType_t xWakeDaemon;
+
+		configASSERT( xTimer );
+		configASSERT( ( xNewPeriod > 0 ) );
+
+		taskENTER_CRITICAL();
+		{
+			xWakeDaemon = prvWheelArm( pxTimer, xNewPeriod, xTaskGetTickCount() );
+		}
+		taskEXIT_CRITICAL();
+
+		traceTIMER_COMMAND_SEND( xTimer, tmrCOMMAND_CHANGE_PERIOD, xNewPeriod, pdPASS );
+
+		if( xWakeDaemon != pdFALSE )
+		{
+			/* If the queue is full the daemon task has commands to process and
+			reads the wheel again anyway. */
+			( void ) xTimerPendFunctionCall( prvWheelWake, NULL, 0UL, tmrNO_DELAY );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pdPASS;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	BaseType_t xTimerArmFromISR( TimerHandle_t xTimer, const TickType_t xNewPeriod, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	Timer_t * const pxTimer = xTimer;
+	BaseType_t xWakeDaemon;
+	UBaseType_t uxSavedInterruptStatus;
+
+		configASSERT( xTimer );
+		configASSERT( ( xNewPeriod > 0 ) );
+
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+		{
+			xWakeDaemon = prvWheelArm( pxTimer, xNewPeriod, xTaskGetTickCountFromISR() );
+		}
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+		traceTIMER_COMMAND_SEND( xTimer, tmrCOMMAND_CHANGE_PERIOD_FROM_ISR, xNewPeriod, pdPASS );
+
+		if( xWakeDaemon != pdFALSE )
+		{
+			( void ) xTimerPendFunctionCallFromISR( prvWheelWake, NULL, 0UL, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pdPASS;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	BaseType_t xTimerDisarm( TimerHandle_t xTimer )
+	{
+	Timer_t * const pxTimer = xTimer;
+
+		configASSERT( xTimer );
+
+		/* The daemon task may wake for a timer that is no longer there, which
+		is harmless, so it is not told. */
+		taskENTER_CRITICAL();
+		{
+			prvWheelRemove( pxTimer );
+			pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
+		}
+		taskEXIT_CRITICAL();
+
+		traceTIMER_COMMAND_SEND( xTimer, tmrCOMMAND_STOP, 0U, pdPASS );
+
+		return pdPASS;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	BaseType_t xTimerDisarmFromISR( TimerHandle_t xTimer )
+	{
+	Timer_t * const pxTimer = xTimer;
+	UBaseType_t uxSavedInterruptStatus;
+
+		configASSERT( xTimer );
+
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+		{
+			prvWheelRemove( pxTimer );
+			pxTimer->ucStatus &= ~tmrSTATUS_IS_ACTIVE;
+		}
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+		traceTIMER_COMMAND_SEND( xTimer, tmrCOMMAND_STOP_FROM_ISR, 0U, pdPASS );
+
+		return pdPASS;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
 	UBaseType_t uxTimerGetTimerNumber( TimerHandle_t xTimer )
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    dsp_par.h
+  * @brief   CMSIS-DSP and CMSIS-NN kernels split over a job_pool for offline
+  *          replay of recorded data on the host.
+  ******************************************************************************
+  * Each call takes the arguments of the kernel it wraps plus the pool, splits
+  * the work into independent blocks and runs the unmodified CMSIS kernel on
+  * every block. The output is bit for bit what one call of the kernel on one
+  * thread produces, for any number of threads:
+  *
+  *  - dsp_par_fir_f32() cuts the signal into DSP_PAR_FIR_BLOCK samples. Each
+  *    block starts from the numTaps - 1 inputs before it, which is the state
+  *    arm_fir_f32() would have reached there, and every output sums its taps
+  *    in the same order whatever block it falls in.
+  *  - dsp_par_cfft_f32() transforms a run of frames, one block per frame.
+  *  - dsp_par_convolve_HWC_q7() runs one of the arm_convolve_HWC_q7_*
+  *    functions over a batch of images, one block per image.
+  *
+  * Scratch memory is allocated per worker for each call. Calls return
+  * ARM_MATH_SUCCESS, the first error a kernel returned, or
+  * ARM_MATH_ARGUMENT_ERROR if scratch memory could not be allocated.
+  ******************************************************************************
+  */
+#ifndef __DSP_PAR_H__
+#define __DSP_PAR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "arm_math.h"
+#include "arm_nnfunctions.h"
+#include "job_pool.h"
+
+#ifndef DSP_PAR_FIR_BLOCK
+#define DSP_PAR_FIR_BLOCK       4096    /* Samples per FIR block */
+#endif
+
+/* Same signature as arm_convolve_HWC_q7_basic, _fast and _RGB */
+typedef arm_status (*dsp_par_conv_q7_fn_t)(const q7_t *Im_in, const uint16_t dim_im_in,
+                                           const uint16_t ch_im_in, const q7_t *wt,
+                                           const uint16_t ch_im_out, const uint16_t dim_kernel,
+                                           const uint16_t padding, const uint16_t stride,
+                                           const q7_t *bias, const uint16_t bias_shift,
+                                           const uint16_t out_shift, q7_t *Im_out,
+                                           const uint16_t dim_im_out, q15_t *bufferA,
+                                           q7_t *bufferB);
+
+/* One convolution layer, as passed to arm_convolve_HWC_q7_* */
+typedef struct
+{
+    dsp_par_conv_q7_fn_t fn;
+    uint16_t dim_im_in;
+    uint16_t ch_im_in;
+    const q7_t *wt;
+    uint16_t ch_im_out;
+    uint16_t dim_kernel;
+    uint16_t padding;
+    uint16_t stride;
+    const q7_t *bias;
+    uint16_t bias_shift;
+    uint16_t out_shift;
+    uint16_t dim_im_out;
+} dsp_par_conv_q7_t;
+
+arm_status dsp_par_fir_f32(job_pool_t *pool, const arm_fir_instance_f32 *S,
+                           const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+arm_status dsp_par_cfft_f32(job_pool_t *pool, const arm_cfft_instance_f32 *S, float32_t *p1,
+                            uint32_t frames, uint8_t ifftFlag, uint8_t bitReverseFlag);
+arm_status dsp_par_convolve_HWC_q7(job_pool_t *pool, const dsp_par_conv_q7_t *conv,
+                                   const q7_t *Im_in, q7_t *Im_out, uint32_t images);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_PAR_H__ */
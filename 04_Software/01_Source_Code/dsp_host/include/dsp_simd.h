@@ -0,0 +1,54 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd.h
+  * @brief   Run-time selected x86 SIMD versions of the hot CMSIS-DSP kernels
+  *          in the host build.
+  ******************************************************************************
+  * The host library exports the usual CMSIS names for these kernels and
+  * forwards each call to the best version the CPU supports:
+  *
+  *   arm_fir_f32, arm_fir_q15, arm_fir_q31
+  *   arm_biquad_cascade_df1_f32
+  *   arm_dot_prod_f32, arm_dot_prod_q15, arm_dot_prod_q31
+  *   arm_mat_mult_f32
+  *   arm_radix8_butterfly_f32, the core of arm_cfft_f32 and arm_rfft_fast_f32
+  *
+  * The CMSIS C version of each, which gives the same results as the
+  * Cortex-M4 library, stays in the library as <name>_ref and is used
+  * where a level has no SIMD version. q31 kernels need 64-bit lane
+  * multiplies and are vectorised for AVX2 only.
+  *
+  * Fixed-point results are bit for bit those of the reference. The float
+  * kernels keep each output's order of operations, so they are bit-exact with
+  * the reference on the host too, except arm_dot_prod_f32, which sums in
+  * several lanes and differs by rounding.
+  *
+  * The level is chosen from the CPU when the program starts, capped by the
+  * DSP_SIMD environment variable (none, sse2 or avx2) if set.
+  ******************************************************************************
+  */
+#ifndef __DSP_SIMD_H__
+#define __DSP_SIMD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    DSP_SIMD_NONE = 0,                  /* CMSIS C reference */
+    DSP_SIMD_SSE2,
+    DSP_SIMD_AVX2,
+    DSP_SIMD_LEVELS
+} dsp_simd_t;
+
+dsp_simd_t dsp_simd_level(void);
+dsp_simd_t dsp_simd_supported(void);
+dsp_simd_t dsp_simd_select(dsp_simd_t level);
+const char *dsp_simd_name(dsp_simd_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_SIMD_H__ */
@@ -0,0 +1,45 @@
+/**
+  ******************************************************************************
+  * @file    job_pool.h
+  * @brief   Work-stealing thread pool for splitting long DSP and NN workloads
+  *          into independent blocks on the host.
+  ******************************************************************************
+  * job_pool_for() hands a range of items [0, count) to the pool. Workers split
+  * ranges in half until they are at most grain items, keep one half and push
+  * the other onto their own deque, where idle workers steal it from the other
+  * end. Large ranges are stolen first, so load balances without a central
+  * queue and each worker mostly runs neighbouring blocks.
+  *
+  * The calling thread is worker 0 and runs blocks too. The call returns when
+  * every item has been processed. The callback is told which worker runs it,
+  * for per-worker scratch buffers, and must only write output that belongs to
+  * its own items: the result is then the same for any thread count and any
+  * schedule.
+  *
+  * One thread submits at a time: a pool is not shared between submitters.
+  ******************************************************************************
+  */
+#ifndef __JOB_POOL_H__
+#define __JOB_POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef struct job_pool job_pool_t;
+
+/* Process items [begin, end) on worker number worker */
+typedef void (*job_pool_fn_t)(void *ctx, uint32_t begin, uint32_t end, unsigned worker);
+
+job_pool_t *job_pool_create(unsigned threads);
+void job_pool_destroy(job_pool_t *pool);
+unsigned job_pool_threads(const job_pool_t *pool);
+void job_pool_for(job_pool_t *pool, uint32_t count, uint32_t grain, job_pool_fn_t fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __JOB_POOL_H__ */
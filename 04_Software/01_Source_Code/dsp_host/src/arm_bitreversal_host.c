@@ -0,0 +1,45 @@
+/**
+  ******************************************************************************
+  * @file    arm_bitreversal_host.c
+  * @brief   C versions of arm_bitreversal_32 and arm_bitreversal_16, which the
+  *          CMSIS-DSP tree only provides in Arm assembly (arm_bitreversal2.S).
+  ******************************************************************************
+  * The table holds pairs of byte offsets into the f32/q31 buffer; the q15
+  * variant halves them. Each pair names two complex samples to swap. The
+  * result is the same as the assembly's.
+  ******************************************************************************
+  */
+#include <stdint.h>
+#include <string.h>
+
+void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable)
+{
+    uint8_t *base = (uint8_t *)pSrc;
+    uint32_t i, tmp[2];
+
+    for (i = 0; i < bitRevLen; i += 2)
+    {
+        uint8_t *a = base + pBitRevTable[i];
+        uint8_t *b = base + pBitRevTable[i + 1];
+
+        memcpy(tmp, a, 8);
+        memcpy(a, b, 8);
+        memcpy(b, tmp, 8);
+    }
+}
+
+void arm_bitreversal_16(uint16_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable)
+{
+    uint8_t *base = (uint8_t *)pSrc;
+    uint32_t i, tmp;
+
+    for (i = 0; i < bitRevLen; i += 2)
+    {
+        uint8_t *a = base + (pBitRevTable[i] >> 1);
+        uint8_t *b = base + (pBitRevTable[i + 1] >> 1);
+
+        memcpy(&tmp, a, 4);
+        memcpy(a, b, 4);
+        memcpy(b, &tmp, 4);
+    }
+}
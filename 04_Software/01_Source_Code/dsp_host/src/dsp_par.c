@@ -0,0 +1,200 @@
+/**
+  ******************************************************************************
+  * @file    dsp_par.c
+  * @brief   Block splitting of CMSIS-DSP and CMSIS-NN kernels over a job_pool.
+  ******************************************************************************
+  */
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsp_par.h"
+
+typedef struct
+{
+    const arm_fir_instance_f32 *S;
+    const float32_t *src;
+    float32_t *dst;
+    uint32_t length;
+    float32_t *scratch;                 /* numTaps - 1 + DSP_PAR_FIR_BLOCK per worker */
+} dsp_par_fir_t;
+
+typedef struct
+{
+    const arm_cfft_instance_f32 *S;
+    float32_t *p1;
+    uint8_t ifftFlag;
+    uint8_t bitReverseFlag;
+} dsp_par_cfft_t;
+
+typedef struct
+{
+    const dsp_par_conv_q7_t *conv;
+    const q7_t *in;
+    q7_t *out;
+    uint32_t in_size;                   /* Bytes per image */
+    uint32_t out_size;
+    q15_t *bufferA;                     /* bufferA_len per worker */
+    uint32_t bufferA_len;
+    _Atomic int status;                 /* First error */
+} dsp_par_conv_t;
+
+static void dsp_par_fir_block(void *ctx, uint32_t begin, uint32_t end, unsigned worker)
+{
+    dsp_par_fir_t *job = ctx;
+    uint32_t history = job->S->numTaps - 1U;
+    float32_t *state = job->scratch + (size_t)worker * (history + DSP_PAR_FIR_BLOCK);
+    arm_fir_instance_f32 fir;
+    uint32_t block, start, count, i;
+
+    fir.numTaps = job->S->numTaps;
+    fir.pCoeffs = job->S->pCoeffs;
+    fir.pState = state;
+
+    for (block = begin; block < end; block++)
+    {
+        start = block * DSP_PAR_FIR_BLOCK;
+        count = job->length - start;
+        if (count > DSP_PAR_FIR_BLOCK)
+        {
+            count = DSP_PAR_FIR_BLOCK;
+        }
+
+        /* The inputs before the block, from the caller's state where the
+           block starts within numTaps - 1 samples of the signal start */
+        for (i = 0; i < history; i++)
+        {
+            state[i] = (start + i >= history) ? job->src[start + i - history]
+                                              : job->S->pState[start + i];
+        }
+        arm_fir_f32(&fir, (float32_t *)job->src + start, job->dst + start, count);
+    }
+}
+
+/**
+ * @brief  arm_fir_f32() over blockSize samples on every worker of pool.
+ *         S->pState holds the numTaps - 1 inputs before pSrc on entry and,
+ *         as after arm_fir_f32(), the last numTaps - 1 inputs on return, so a
+ *         long recording can be replayed in several calls.
+ */
+arm_status dsp_par_fir_f32(job_pool_t *pool, const arm_fir_instance_f32 *S,
+                           const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t history = S->numTaps - 1U;
+    uint32_t workers = job_pool_threads(pool);
+    dsp_par_fir_t job;
+
+    if (blockSize == 0)
+    {
+        return ARM_MATH_SUCCESS;
+    }
+
+    job.S = S;
+    job.src = pSrc;
+    job.dst = pDst;
+    job.length = blockSize;
+    job.scratch = malloc((size_t)workers * (history + DSP_PAR_FIR_BLOCK) * sizeof(float32_t));
+    if (job.scratch == NULL)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    job_pool_for(pool, (blockSize + DSP_PAR_FIR_BLOCK - 1) / DSP_PAR_FIR_BLOCK, 1,
+                 dsp_par_fir_block, &job);
+
+    /* Leave the state where one arm_fir_f32() call would */
+    if (blockSize >= history)
+    {
+        memcpy(S->pState, pSrc + blockSize - history, history * sizeof(float32_t));
+    }
+    else
+    {
+        memmove(S->pState, S->pState + blockSize, (history - blockSize) * sizeof(float32_t));
+        memcpy(S->pState + history - blockSize, pSrc, blockSize * sizeof(float32_t));
+    }
+
+    free(job.scratch);
+    return ARM_MATH_SUCCESS;
+}
+
+static void dsp_par_cfft_block(void *ctx, uint32_t begin, uint32_t end, unsigned worker)
+{
+    dsp_par_cfft_t *job = ctx;
+    uint32_t frame;
+
+    (void)worker;
+    for (frame = begin; frame < end; frame++)
+    {
+        arm_cfft_f32(job->S, job->p1 + (size_t)frame * 2U * job->S->fftLen,
+                     job->ifftFlag, job->bitReverseFlag);
+    }
+}
+
+/**
+ * @brief  arm_cfft_f32() in place on each of frames consecutive frames of
+ *         S->fftLen complex samples.
+ */
+arm_status dsp_par_cfft_f32(job_pool_t *pool, const arm_cfft_instance_f32 *S, float32_t *p1,
+                            uint32_t frames, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    dsp_par_cfft_t job;
+
+    job.S = S;
+    job.p1 = p1;
+    job.ifftFlag = ifftFlag;
+    job.bitReverseFlag = bitReverseFlag;
+
+    /* Several short transforms per block keep the scheduling cost small */
+    job_pool_for(pool, frames, (S->fftLen >= 1024U) ? 1U : 1024U / S->fftLen,
+                 dsp_par_cfft_block, &job);
+    return ARM_MATH_SUCCESS;
+}
+
+static void dsp_par_conv_block(void *ctx, uint32_t begin, uint32_t end, unsigned worker)
+{
+    dsp_par_conv_t *job = ctx;
+    const dsp_par_conv_q7_t *c = job->conv;
+    q15_t *bufferA = job->bufferA + (size_t)worker * job->bufferA_len;
+    uint32_t image;
+    arm_status status;
+    int ok = ARM_MATH_SUCCESS;
+
+    for (image = begin; image < end; image++)
+    {
+        status = c->fn(job->in + (size_t)image * job->in_size, c->dim_im_in, c->ch_im_in, c->wt,
+                       c->ch_im_out, c->dim_kernel, c->padding, c->stride, c->bias,
+                       c->bias_shift, c->out_shift, job->out + (size_t)image * job->out_size,
+                       c->dim_im_out, bufferA, NULL);
+        if (status != ARM_MATH_SUCCESS)
+        {
+            atomic_compare_exchange_strong(&job->status, &ok, status);
+        }
+    }
+}
+
+/**
+ * @brief  conv->fn on each of images consecutive HWC images.
+ */
+arm_status dsp_par_convolve_HWC_q7(job_pool_t *pool, const dsp_par_conv_q7_t *conv,
+                                   const q7_t *Im_in, q7_t *Im_out, uint32_t images)
+{
+    dsp_par_conv_t job;
+
+    job.conv = conv;
+    job.in = Im_in;
+    job.out = Im_out;
+    job.in_size = (uint32_t)conv->dim_im_in * conv->dim_im_in * conv->ch_im_in;
+    job.out_size = (uint32_t)conv->dim_im_out * conv->dim_im_out * conv->ch_im_out;
+    /* 2 * ch_im_in * dim_kernel^2, what the _fast and _RGB variants need */
+    job.bufferA_len = 2U * conv->ch_im_in * conv->dim_kernel * conv->dim_kernel;
+    job.bufferA = malloc((size_t)job_pool_threads(pool) * job.bufferA_len * sizeof(q15_t));
+    if (job.bufferA == NULL)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    atomic_init(&job.status, ARM_MATH_SUCCESS);
+
+    job_pool_for(pool, images, 1, dsp_par_conv_block, &job);
+
+    free(job.bufferA);
+    return (arm_status)atomic_load(&job.status);
+}
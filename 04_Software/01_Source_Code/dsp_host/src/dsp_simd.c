@@ -0,0 +1,168 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd.c
+  * @brief   CPU detection and dispatch of the SIMD CMSIS-DSP kernels.
+  ******************************************************************************
+  */
+#include <stdlib.h>
+#include <string.h>
+#include "dsp_simd_int.h"
+
+static const dsp_simd_table_t s_ref =
+{
+    arm_fir_f32_ref,
+    arm_fir_q15_ref,
+    arm_fir_q31_ref,
+    arm_biquad_cascade_df1_f32_ref,
+    arm_dot_prod_f32_ref,
+    arm_dot_prod_q15_ref,
+    arm_dot_prod_q31_ref,
+    arm_mat_mult_f32_ref,
+    arm_radix8_butterfly_f32_ref,
+};
+
+static const char *const s_names[DSP_SIMD_LEVELS] = { "none", "sse2", "avx2" };
+
+static const dsp_simd_table_t *s_table = &s_ref;
+static dsp_simd_t s_level = DSP_SIMD_NONE;
+
+static const dsp_simd_table_t *dsp_simd_table(dsp_simd_t level)
+{
+    switch (level)
+    {
+#ifdef __SSE2__
+    case DSP_SIMD_SSE2:
+        return &dsp_simd_sse2;
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    case DSP_SIMD_AVX2:
+        return &dsp_simd_avx2;
+#endif
+    default:
+        return &s_ref;
+    }
+}
+
+/**
+ * @brief  The best level this CPU and build support.
+ */
+dsp_simd_t dsp_simd_supported(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return DSP_SIMD_AVX2;
+    }
+#ifdef __SSE2__
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return DSP_SIMD_SSE2;
+    }
+#endif
+#endif
+    return DSP_SIMD_NONE;
+}
+
+dsp_simd_t dsp_simd_level(void)
+{
+    return s_level;
+}
+
+/**
+ * @brief  Use the given level, or the best supported one below it.
+ * @retval The level now in use.
+ */
+dsp_simd_t dsp_simd_select(dsp_simd_t level)
+{
+    dsp_simd_t best = dsp_simd_supported();
+
+    if ((unsigned)level > (unsigned)best)
+    {
+        level = best;
+    }
+    /* SSE2 may be missing from a 32-bit build that still has AVX2 */
+    while ((level != DSP_SIMD_NONE) && (dsp_simd_table(level) == &s_ref))
+    {
+        level = (dsp_simd_t)(level - 1);
+    }
+    s_table = dsp_simd_table(level);
+    s_level = level;
+    return level;
+}
+
+const char *dsp_simd_name(dsp_simd_t level)
+{
+    return ((unsigned)level < DSP_SIMD_LEVELS) ? s_names[level] : "?";
+}
+
+/* Pick the level before main(), so that no kernel can run with another */
+__attribute__((constructor))
+static void dsp_simd_init(void)
+{
+    const char *env = getenv("DSP_SIMD");
+    dsp_simd_t level = DSP_SIMD_AVX2;
+    unsigned i;
+
+    if (env != NULL)
+    {
+        for (i = 0; i < DSP_SIMD_LEVELS; i++)
+        {
+            if (strcmp(env, s_names[i]) == 0)
+            {
+                level = (dsp_simd_t)i;
+            }
+        }
+    }
+    dsp_simd_select(level);
+}
+
+/* The CMSIS entry points */
+
+void arm_fir_f32(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    s_table->fir_f32(S, pSrc, pDst, blockSize);
+}
+
+void arm_fir_q15(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    s_table->fir_q15(S, pSrc, pDst, blockSize);
+}
+
+void arm_fir_q31(const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    s_table->fir_q31(S, pSrc, pDst, blockSize);
+}
+
+void arm_biquad_cascade_df1_f32(const arm_biquad_casd_df1_inst_f32 *S, float32_t *pSrc, float32_t *pDst,
+                                uint32_t blockSize)
+{
+    s_table->biquad_df1_f32(S, pSrc, pDst, blockSize);
+}
+
+void arm_dot_prod_f32(float32_t *pSrcA, float32_t *pSrcB, uint32_t blockSize, float32_t *result)
+{
+    s_table->dot_prod_f32(pSrcA, pSrcB, blockSize, result);
+}
+
+void arm_dot_prod_q15(q15_t *pSrcA, q15_t *pSrcB, uint32_t blockSize, q63_t *result)
+{
+    s_table->dot_prod_q15(pSrcA, pSrcB, blockSize, result);
+}
+
+void arm_dot_prod_q31(q31_t *pSrcA, q31_t *pSrcB, uint32_t blockSize, q63_t *result)
+{
+    s_table->dot_prod_q31(pSrcA, pSrcB, blockSize, result);
+}
+
+arm_status arm_mat_mult_f32(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+                            arm_matrix_instance_f32 *pDst)
+{
+    return s_table->mat_mult_f32(pSrcA, pSrcB, pDst);
+}
+
+void arm_radix8_butterfly_f32(float32_t *pSrc, uint16_t fftLen, const float32_t *pCoef,
+                              uint16_t twidCoefModifier)
+{
+    s_table->radix8_butterfly_f32(pSrc, fftLen, pCoef, twidCoefModifier);
+}
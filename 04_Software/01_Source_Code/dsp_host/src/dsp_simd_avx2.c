@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd_avx2.c
+  * @brief   AVX2 versions of the dispatched CMSIS-DSP kernels.
+  ******************************************************************************
+  * Built with -mavx2 and called only when the CPU reports AVX2; empty when
+  * the compiler does not target AVX2.
+  ******************************************************************************
+  */
+#include <string.h>
+#include "dsp_simd_int.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#define DSP_SIMD_W              8U
+#define DSP_SIMD_QW             16U
+#define DSP_SIMD_FN(name)       avx2_##name
+#define DSP_SIMD_TABLE          dsp_simd_avx2
+
+#define VF                      __m256
+#define VI                      __m256i
+
+#define vf_zero()               _mm256_setzero_ps()
+#define vf_set1(x)              _mm256_set1_ps(x)
+#define vf_loadu(p)             _mm256_loadu_ps(p)
+#define vf_storeu(p, v)         _mm256_storeu_ps((p), (v))
+#define vf_add(a, b)            _mm256_add_ps((a), (b))
+#define vf_sub(a, b)            _mm256_sub_ps((a), (b))
+#define vf_mul(a, b)            _mm256_mul_ps((a), (b))
+#define vf_select(m, a, b)      _mm256_blendv_ps((b), (a), (m))
+#define vf_shift_in(v, x)                                                       \
+    _mm256_blend_ps(_mm256_permutevar8x32_ps((v), _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6)), \
+                    _mm256_set1_ps(x), 1)
+
+/* Within each 128-bit half, as the SSE2 version: the lanes come out in the
+   order 0 1 4 5 2 3 6 7, which the store undoes */
+#define vf_load_cplx(p, re, im)                                                 \
+    do                                                                          \
+    {                                                                           \
+        __m256 lo_ = _mm256_loadu_ps(p), hi_ = _mm256_loadu_ps((p) + 8);        \
+        (re) = _mm256_shuffle_ps(lo_, hi_, 0x88);                               \
+        (im) = _mm256_shuffle_ps(lo_, hi_, 0xDD);                               \
+    } while (0)
+
+#define vf_store_cplx(p, re, im)                                                \
+    do                                                                          \
+    {                                                                           \
+        _mm256_storeu_ps((p), _mm256_unpacklo_ps((re), (im)));                  \
+        _mm256_storeu_ps((p) + 8, _mm256_unpackhi_ps((re), (im)));              \
+    } while (0)
+
+/* In the lane order of vf_load_cplx */
+#define vf_gather_cplx(p, stride, re, im)                                       \
+    do                                                                          \
+    {                                                                           \
+        const float32_t *p_ = (p);                                              \
+        uint32_t s_ = 2U * (stride);                                            \
+        (re) = _mm256_setr_ps(p_[0], p_[s_], p_[4U * s_], p_[5U * s_],          \
+                              p_[2U * s_], p_[3U * s_], p_[6U * s_], p_[7U * s_]); \
+        (im) = _mm256_setr_ps(p_[1], p_[s_ + 1U], p_[4U * s_ + 1U], p_[5U * s_ + 1U], \
+                              p_[2U * s_ + 1U], p_[3U * s_ + 1U], p_[6U * s_ + 1U], \
+                              p_[7U * s_ + 1U]);                                \
+    } while (0)
+
+#define vi_zero()               _mm256_setzero_si256()
+#define vi_loadu(p)             _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define vi_madd16(a, b)         _mm256_madd_epi16((a), (b))
+
+/* As sse2_acc64() */
+static inline __m256i avx2_acc64(__m256i acc, __m256i v)
+{
+    v = _mm256_sub_epi32(v, _mm256_set1_epi32(1));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+static inline q63_t avx2_hsum64(__m256i acc)
+{
+    int64_t lanes[4];
+
+    _mm256_storeu_si256((__m256i *)(void *)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+#define vi_acc64(acc, v)        avx2_acc64((acc), (v))
+#define vi_hsum64(acc)          avx2_hsum64(acc)
+
+/* Four q31 products as exact 64-bit lanes */
+static inline __m256i avx2_mul_q31(const q31_t *a, const q31_t *b)
+{
+    __m256i va = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(const void *)a));
+    __m256i vb = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(const void *)b));
+
+    return _mm256_mul_epi32(va, vb);
+}
+
+/* As arm_fir_q31: a 64-bit sum that wraps, then >> 31 */
+static void avx2_fir_q31(const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+    q31_t *pState = S->pState;
+    const q31_t *pCoeffs = S->pCoeffs;
+    uint32_t numTaps = S->numTaps;
+    uint32_t vecTaps = numTaps & ~3U;
+    uint32_t n, k;
+    q63_t acc;
+
+    memcpy(pState + numTaps - 1U, pSrc, blockSize * sizeof(q31_t));
+
+    for (n = 0; n < blockSize; n++)
+    {
+        const q31_t *px = pState + n;
+        __m256i acc64 = _mm256_setzero_si256();
+
+        for (k = 0; k < vecTaps; k += 4U)
+        {
+            acc64 = _mm256_add_epi64(acc64, avx2_mul_q31(px + k, pCoeffs + k));
+        }
+        acc = avx2_hsum64(acc64);
+        for (; k < numTaps; k++)
+        {
+            acc += (q63_t)px[k] * pCoeffs[k];
+        }
+        pDst[n] = (q31_t)(acc >> 31U);
+    }
+
+    memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(q31_t));
+}
+
+/* As arm_dot_prod_q31: each product >> 14 before it is added. AVX2 has no
+   64-bit arithmetic shift, so shift logically and fill in the sign. */
+static void avx2_dot_prod_q31(q31_t *pSrcA, q31_t *pSrcB, uint32_t blockSize, q63_t *result)
+{
+    __m256i acc64 = _mm256_setzero_si256(), p, sign;
+    uint32_t vec = blockSize & ~3U;
+    q63_t sum;
+    uint32_t n;
+
+    for (n = 0; n < vec; n += 4U)
+    {
+        p = avx2_mul_q31(pSrcA + n, pSrcB + n);
+        sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), p);
+        p = _mm256_or_si256(_mm256_srli_epi64(p, 14), _mm256_slli_epi64(sign, 64 - 14));
+        acc64 = _mm256_add_epi64(acc64, p);
+    }
+    sum = avx2_hsum64(acc64);
+    for (; n < blockSize; n++)
+    {
+        sum += ((q63_t)pSrcA[n] * pSrcB[n]) >> 14U;
+    }
+    *result = sum;
+}
+
+#define DSP_SIMD_FIR_Q31        avx2_fir_q31
+#define DSP_SIMD_DOT_PROD_Q31   avx2_dot_prod_q31
+
+#include "dsp_simd_impl.h"
+
+#endif /* __AVX2__ */
@@ -0,0 +1,588 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd_impl.h
+  * @brief   SIMD kernels written once against a small vector interface and
+  *          compiled by dsp_simd_sse2.c and dsp_simd_avx2.c.
+  ******************************************************************************
+  * The including file defines, for its instruction set:
+  *
+  *   DSP_SIMD_W          float lanes per vector
+  *   DSP_SIMD_QW         q15 lanes per integer vector
+  *   DSP_SIMD_FN(name)   the name of a kernel for this instruction set
+  *   DSP_SIMD_TABLE      the dsp_simd_table_t to define
+  *   VF, VI              float and integer vector types
+  *   vf_zero() vf_set1(x) vf_loadu(p) vf_storeu(p, v)
+  *   vf_add(a, b) vf_sub(a, b) vf_mul(a, b) vf_select(mask, a, b)
+  *   vf_shift_in(v, x)   lanes [x, v0, v1, ..., v(W-2)]
+  *   vf_load_cplx(p, re, im) and vf_store_cplx(p, re, im), which split W
+  *                       interleaved complex samples into real and imaginary
+  *                       vectors and back; the lane order may be permuted as
+  *                       long as both use the same order
+  *   vf_gather_cplx(p, stride, re, im)
+  *                       as vf_load_cplx, for W complex samples stride
+  *                       complex samples apart
+  *   vi_loadu(p) vi_madd16(a, b) vi_acc64(acc, v) vi_hsum64(acc) vi_zero()
+  *
+  * and optionally DSP_SIMD_FIR_Q31 and DSP_SIMD_DOT_PROD_Q31, the names of
+  * its q31 kernels.
+  *
+  * Except for the f32 dot product, every float kernel performs each output's
+  * additions and multiplications in the same order as the CMSIS code, only
+  * for several outputs at once, so the results are the same bits.
+  ******************************************************************************
+  */
+#include <string.h>
+
+/* ---------------------------------------------------------------------------
+ * FIR
+ * ------------------------------------------------------------------------ */
+
+/* As arm_fir_f32: out[n] = sum of pCoeffs[k] * x[n + k], k ascending */
+static void DSP_SIMD_FN(fir_f32)(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst,
+                                 uint32_t blockSize)
+{
+    float32_t *pState = S->pState;
+    const float32_t *pCoeffs = S->pCoeffs;
+    uint32_t numTaps = S->numTaps;
+    uint32_t n = 0, k;
+    float32_t acc;
+
+    memcpy(pState + numTaps - 1U, pSrc, blockSize * sizeof(float32_t));
+
+    for (; n + 4U * DSP_SIMD_W <= blockSize; n += 4U * DSP_SIMD_W)
+    {
+        VF acc0 = vf_zero(), acc1 = vf_zero(), acc2 = vf_zero(), acc3 = vf_zero();
+        const float32_t *px = pState + n;
+
+        for (k = 0; k < numTaps; k++)
+        {
+            VF c = vf_set1(pCoeffs[k]);
+
+            acc0 = vf_add(acc0, vf_mul(vf_loadu(px + k), c));
+            acc1 = vf_add(acc1, vf_mul(vf_loadu(px + k + DSP_SIMD_W), c));
+            acc2 = vf_add(acc2, vf_mul(vf_loadu(px + k + 2U * DSP_SIMD_W), c));
+            acc3 = vf_add(acc3, vf_mul(vf_loadu(px + k + 3U * DSP_SIMD_W), c));
+        }
+        vf_storeu(pDst + n, acc0);
+        vf_storeu(pDst + n + DSP_SIMD_W, acc1);
+        vf_storeu(pDst + n + 2U * DSP_SIMD_W, acc2);
+        vf_storeu(pDst + n + 3U * DSP_SIMD_W, acc3);
+    }
+
+    for (; n + DSP_SIMD_W <= blockSize; n += DSP_SIMD_W)
+    {
+        VF acc0 = vf_zero();
+
+        for (k = 0; k < numTaps; k++)
+        {
+            acc0 = vf_add(acc0, vf_mul(vf_loadu(pState + n + k), vf_set1(pCoeffs[k])));
+        }
+        vf_storeu(pDst + n, acc0);
+    }
+
+    for (; n < blockSize; n++)
+    {
+        acc = 0.0f;
+        for (k = 0; k < numTaps; k++)
+        {
+            acc += pState[n + k] * pCoeffs[k];
+        }
+        pDst[n] = acc;
+    }
+
+    memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(float32_t));
+}
+
+/* As arm_fir_q15: a 64-bit sum of the products, then >> 15 and saturated.
+   The sum is exact, so the order does not matter. */
+static void DSP_SIMD_FN(fir_q15)(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst,
+                                 uint32_t blockSize)
+{
+    q15_t *pState = S->pState;
+    const q15_t *pCoeffs = S->pCoeffs;
+    uint32_t numTaps = S->numTaps;
+    uint32_t vecTaps = numTaps & ~(DSP_SIMD_QW - 1U);
+    uint32_t n, k;
+    q63_t acc;
+
+    memcpy(pState + numTaps - 1U, pSrc, blockSize * sizeof(q15_t));
+
+    for (n = 0; n < blockSize; n++)
+    {
+        const q15_t *px = pState + n;
+        VI acc64 = vi_zero();
+
+        for (k = 0; k < vecTaps; k += DSP_SIMD_QW)
+        {
+            acc64 = vi_acc64(acc64, vi_madd16(vi_loadu(px + k), vi_loadu(pCoeffs + k)));
+        }
+        /* vi_acc64() takes 1 from every pair sum; put them back */
+        acc = vi_hsum64(acc64) + (q63_t)(vecTaps / 2U);
+        for (; k < numTaps; k++)
+        {
+            acc += (q31_t)px[k] * pCoeffs[k];
+        }
+        pDst[n] = (q15_t)__SSAT((q31_t)(acc >> 15), 16);
+    }
+
+    memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+/* ---------------------------------------------------------------------------
+ * Biquad cascade
+ * ------------------------------------------------------------------------ */
+
+/* As arm_biquad_cascade_df1_f32. Every stage is a recursion, so the samples
+   of one stage cannot be computed side by side; instead lane l runs stage
+   s0 + l, one sample behind lane l - 1 whose output it takes as input.
+   Each stage does the CMSIS arithmetic in the CMSIS order. */
+static void DSP_SIMD_FN(biquad_df1_f32)(const arm_biquad_casd_df1_inst_f32 *S, float32_t *pSrc,
+                                        float32_t *pDst, uint32_t blockSize)
+{
+    float32_t c[5][DSP_SIMD_W], st[4][DSP_SIMD_W], out[DSP_SIMD_W];
+    uint32_t mask[DSP_SIMD_W];
+    const float32_t *pIn = pSrc;
+    uint32_t numStages = S->numStages;
+    uint32_t s0, g, l, i, t, steps;
+    VF b0, b1, b2, a1, a2, x1, x2, y1, y2, xn, acc, m;
+
+    if ((numStages < 2U) || (blockSize == 0U))
+    {
+        arm_biquad_cascade_df1_f32_ref(S, pSrc, pDst, blockSize);
+        return;
+    }
+
+    for (s0 = 0; s0 < numStages; s0 += g)
+    {
+        g = (numStages - s0 < DSP_SIMD_W) ? (numStages - s0) : DSP_SIMD_W;
+        memset(c, 0, sizeof(c));
+        memset(st, 0, sizeof(st));
+        for (l = 0; l < g; l++)
+        {
+            for (i = 0; i < 5U; i++)
+            {
+                c[i][l] = S->pCoeffs[5U * (s0 + l) + i];
+            }
+            for (i = 0; i < 4U; i++)
+            {
+                st[i][l] = S->pState[4U * (s0 + l) + i];
+            }
+        }
+        b0 = vf_loadu(c[0]);
+        b1 = vf_loadu(c[1]);
+        b2 = vf_loadu(c[2]);
+        a1 = vf_loadu(c[3]);
+        a2 = vf_loadu(c[4]);
+        x1 = vf_loadu(st[0]);
+        x2 = vf_loadu(st[1]);
+        y1 = vf_loadu(st[2]);
+        y2 = vf_loadu(st[3]);
+        acc = vf_zero();
+
+        steps = blockSize + g - 1U;
+        for (t = 0; t < steps; t++)
+        {
+            xn = vf_shift_in(acc, (t < blockSize) ? pIn[t] : 0.0f);
+            acc = vf_add(vf_add(vf_add(vf_add(vf_mul(b0, xn), vf_mul(b1, x1)), vf_mul(b2, x2)),
+                                vf_mul(a1, y1)), vf_mul(a2, y2));
+
+            if ((t >= g - 1U) && (t < blockSize))
+            {
+                /* Every stage of the group has a sample */
+                x2 = x1;
+                x1 = xn;
+                y2 = y1;
+                y1 = acc;
+            }
+            else
+            {
+                /* Filling or draining: lane l has sample t - l only */
+                for (l = 0; l < DSP_SIMD_W; l++)
+                {
+                    mask[l] = ((t >= l) && (t - l < blockSize)) ? 0xFFFFFFFFU : 0U;
+                }
+                memcpy(out, mask, sizeof(out));
+                m = vf_loadu(out);
+                x2 = vf_select(m, x1, x2);
+                x1 = vf_select(m, xn, x1);
+                y2 = vf_select(m, y1, y2);
+                y1 = vf_select(m, acc, y1);
+            }
+
+            if (t >= g - 1U)
+            {
+                vf_storeu(out, acc);
+                pDst[t - (g - 1U)] = out[g - 1U];
+            }
+        }
+
+        vf_storeu(st[0], x1);
+        vf_storeu(st[1], x2);
+        vf_storeu(st[2], y1);
+        vf_storeu(st[3], y2);
+        for (l = 0; l < g; l++)
+        {
+            for (i = 0; i < 4U; i++)
+            {
+                S->pState[4U * (s0 + l) + i] = st[i][l];
+            }
+        }
+
+        /* Later stages filter the output in place */
+        pIn = pDst;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Dot products
+ * ------------------------------------------------------------------------ */
+
+/* Sums in 4 * DSP_SIMD_W lanes: the one kernel that rounds differently */
+static void DSP_SIMD_FN(dot_prod_f32)(float32_t *pSrcA, float32_t *pSrcB, uint32_t blockSize,
+                                      float32_t *result)
+{
+    VF acc0 = vf_zero(), acc1 = vf_zero(), acc2 = vf_zero(), acc3 = vf_zero();
+    float32_t lanes[DSP_SIMD_W];
+    float32_t sum = 0.0f;
+    uint32_t n = 0, l;
+
+    for (; n + 4U * DSP_SIMD_W <= blockSize; n += 4U * DSP_SIMD_W)
+    {
+        acc0 = vf_add(acc0, vf_mul(vf_loadu(pSrcA + n), vf_loadu(pSrcB + n)));
+        acc1 = vf_add(acc1, vf_mul(vf_loadu(pSrcA + n + DSP_SIMD_W), vf_loadu(pSrcB + n + DSP_SIMD_W)));
+        acc2 = vf_add(acc2, vf_mul(vf_loadu(pSrcA + n + 2U * DSP_SIMD_W),
+                                   vf_loadu(pSrcB + n + 2U * DSP_SIMD_W)));
+        acc3 = vf_add(acc3, vf_mul(vf_loadu(pSrcA + n + 3U * DSP_SIMD_W),
+                                   vf_loadu(pSrcB + n + 3U * DSP_SIMD_W)));
+    }
+    vf_storeu(lanes, vf_add(vf_add(acc0, acc1), vf_add(acc2, acc3)));
+    for (l = 0; l < DSP_SIMD_W; l++)
+    {
+        sum += lanes[l];
+    }
+    for (; n < blockSize; n++)
+    {
+        sum += pSrcA[n] * pSrcB[n];
+    }
+    *result = sum;
+}
+
+static void DSP_SIMD_FN(dot_prod_q15)(q15_t *pSrcA, q15_t *pSrcB, uint32_t blockSize, q63_t *result)
+{
+    uint32_t pairs = blockSize & ~3U;           /* Summed with __SMLALD by CMSIS */
+    uint32_t vec = pairs & ~(DSP_SIMD_QW - 1U);
+    VI acc64 = vi_zero();
+    q63_t sum;
+    uint32_t n;
+
+    for (n = 0; n < vec; n += DSP_SIMD_QW)
+    {
+        acc64 = vi_acc64(acc64, vi_madd16(vi_loadu(pSrcA + n), vi_loadu(pSrcB + n)));
+    }
+    sum = vi_hsum64(acc64) + (q63_t)(vec / 2U);
+    for (; n < pairs; n++)
+    {
+        sum += (q31_t)pSrcA[n] * pSrcB[n];
+    }
+    /* CMSIS passes the last 1 to 3 samples to __SMLALD sign-extended, which
+       adds 1 for each pair of negative samples. Keep that, for equal bits. */
+    for (; n < blockSize; n++)
+    {
+        sum = (q63_t)__SMLALD((uint32_t)(q31_t)pSrcA[n], (uint32_t)(q31_t)pSrcB[n], (uint64_t)sum);
+    }
+    *result = sum;
+}
+
+/* ---------------------------------------------------------------------------
+ * Matrix multiplication
+ * ------------------------------------------------------------------------ */
+
+/* As arm_mat_mult_f32: each output sums over k ascending from 0.0f. Here
+   DSP_SIMD_W columns of a row are summed at once. */
+static arm_status DSP_SIMD_FN(mat_mult_f32)(const arm_matrix_instance_f32 *pSrcA,
+                                            const arm_matrix_instance_f32 *pSrcB,
+                                            arm_matrix_instance_f32 *pDst)
+{
+    uint32_t rows = pSrcA->numRows, inner = pSrcA->numCols, cols = pSrcB->numCols;
+    const float32_t *a, *b = pSrcB->pData;
+    float32_t *out, sum;
+    uint32_t i, j, k;
+
+#ifdef ARM_MATH_MATRIX_CHECK
+    if ((pSrcA->numCols != pSrcB->numRows) ||
+        (pSrcA->numRows != pDst->numRows) || (pSrcB->numCols != pDst->numCols))
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+#endif
+
+    for (i = 0; i < rows; i++)
+    {
+        a = pSrcA->pData + i * inner;
+        out = pDst->pData + i * cols;
+
+        for (j = 0; j + 2U * DSP_SIMD_W <= cols; j += 2U * DSP_SIMD_W)
+        {
+            VF acc0 = vf_zero(), acc1 = vf_zero();
+
+            for (k = 0; k < inner; k++)
+            {
+                VF ak = vf_set1(a[k]);
+
+                acc0 = vf_add(acc0, vf_mul(ak, vf_loadu(b + k * cols + j)));
+                acc1 = vf_add(acc1, vf_mul(ak, vf_loadu(b + k * cols + j + DSP_SIMD_W)));
+            }
+            vf_storeu(out + j, acc0);
+            vf_storeu(out + j + DSP_SIMD_W, acc1);
+        }
+        for (; j + DSP_SIMD_W <= cols; j += DSP_SIMD_W)
+        {
+            VF acc0 = vf_zero();
+
+            for (k = 0; k < inner; k++)
+            {
+                acc0 = vf_add(acc0, vf_mul(vf_set1(a[k]), vf_loadu(b + k * cols + j)));
+            }
+            vf_storeu(out + j, acc0);
+        }
+        for (; j < cols; j++)
+        {
+            sum = 0.0f;
+            for (k = 0; k < inner; k++)
+            {
+                sum += a[k] * b[k * cols + j];
+            }
+            out[j] = sum;
+        }
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------
+ * Radix-8 butterfly of arm_cfft_f32
+ * ------------------------------------------------------------------------ */
+
+/* The two butterflies of arm_radix8_butterfly_f32, on the 8 points of one
+   butterfly in re[] and im[], for any type T with the given operations. The
+   statements are the CMSIS ones, in the same order. */
+#define DSP_SIMD_RADIX8_FIRST(T, ADD, SUB, MUL, C81, re, im)                    \
+    do                                                                          \
+    {                                                                           \
+        T r1, r2, r3, r4, r5, r6, r7, r8, s3, s5, s6, s7, s8, t1, t2;           \
+        r1 = ADD(re[0], re[4]); r5 = SUB(re[0], re[4]);                         \
+        r2 = ADD(re[1], re[5]); r6 = SUB(re[1], re[5]);                         \
+        r3 = ADD(re[2], re[6]); r7 = SUB(re[2], re[6]);                         \
+        r4 = ADD(re[3], re[7]); r8 = SUB(re[3], re[7]);                         \
+        t1 = SUB(r1, r3); r1 = ADD(r1, r3); r3 = SUB(r2, r4); r2 = ADD(r2, r4); \
+        re[0] = ADD(r1, r2); re[4] = SUB(r1, r2);                               \
+        r1 = ADD(im[0], im[4]); s5 = SUB(im[0], im[4]);                         \
+        r2 = ADD(im[1], im[5]); s6 = SUB(im[1], im[5]);                         \
+        s3 = ADD(im[2], im[6]); s7 = SUB(im[2], im[6]);                         \
+        r4 = ADD(im[3], im[7]); s8 = SUB(im[3], im[7]);                         \
+        t2 = SUB(r1, s3); r1 = ADD(r1, s3); s3 = SUB(r2, r4); r2 = ADD(r2, r4); \
+        im[0] = ADD(r1, r2); im[4] = SUB(r1, r2);                               \
+        re[2] = ADD(t1, s3); re[6] = SUB(t1, s3);                               \
+        im[2] = SUB(t2, r3); im[6] = ADD(t2, r3);                               \
+        r1 = MUL(SUB(r6, r8), C81); r6 = MUL(ADD(r6, r8), C81);                 \
+        r2 = MUL(SUB(s6, s8), C81); s6 = MUL(ADD(s6, s8), C81);                 \
+        t1 = SUB(r5, r1); r5 = ADD(r5, r1); r8 = SUB(r7, r6); r7 = ADD(r7, r6); \
+        t2 = SUB(s5, r2); s5 = ADD(s5, r2); s8 = SUB(s7, s6); s7 = ADD(s7, s6); \
+        re[1] = ADD(r5, s7); re[7] = SUB(r5, s7);                               \
+        re[5] = ADD(t1, s8); re[3] = SUB(t1, s8);                               \
+        im[1] = SUB(s5, r7); im[7] = ADD(s5, r7);                               \
+        im[5] = SUB(t2, r8); im[3] = ADD(t2, r8);                               \
+    } while (0)
+
+/* Point p is multiplied by the twiddle co[p], si[p] */
+#define DSP_SIMD_RADIX8_TWIDDLE(T, ADD, SUB, MUL, C81, re, im, co, si)          \
+    do                                                                          \
+    {                                                                           \
+        T r1, r2, r3, r4, r5, r6, r7, r8, s1, s2, s3, s4, s5, s6, s7, s8;       \
+        T t1, t2;                                                               \
+        r1 = ADD(re[0], re[4]); r5 = SUB(re[0], re[4]);                         \
+        r2 = ADD(re[1], re[5]); r6 = SUB(re[1], re[5]);                         \
+        r3 = ADD(re[2], re[6]); r7 = SUB(re[2], re[6]);                         \
+        r4 = ADD(re[3], re[7]); r8 = SUB(re[3], re[7]);                         \
+        t1 = SUB(r1, r3); r1 = ADD(r1, r3); r3 = SUB(r2, r4); r2 = ADD(r2, r4); \
+        re[0] = ADD(r1, r2); r2 = SUB(r1, r2);                                  \
+        s1 = ADD(im[0], im[4]); s5 = SUB(im[0], im[4]);                         \
+        s2 = ADD(im[1], im[5]); s6 = SUB(im[1], im[5]);                         \
+        s3 = ADD(im[2], im[6]); s7 = SUB(im[2], im[6]);                         \
+        s4 = ADD(im[3], im[7]); s8 = SUB(im[3], im[7]);                         \
+        t2 = SUB(s1, s3); s1 = ADD(s1, s3); s3 = SUB(s2, s4); s2 = ADD(s2, s4); \
+        r1 = ADD(t1, s3); t1 = SUB(t1, s3);                                     \
+        im[0] = ADD(s1, s2); s2 = SUB(s1, s2);                                  \
+        s1 = SUB(t2, r3); t2 = ADD(t2, r3);                                     \
+        re[4] = ADD(MUL(co[4], r2), MUL(si[4], s2));                            \
+        im[4] = SUB(MUL(co[4], s2), MUL(si[4], r2));                            \
+        re[2] = ADD(MUL(co[2], r1), MUL(si[2], s1));                            \
+        im[2] = SUB(MUL(co[2], s1), MUL(si[2], r1));                            \
+        re[6] = ADD(MUL(co[6], t1), MUL(si[6], t2));                            \
+        im[6] = SUB(MUL(co[6], t2), MUL(si[6], t1));                            \
+        r1 = MUL(SUB(r6, r8), C81); r6 = MUL(ADD(r6, r8), C81);                 \
+        s1 = MUL(SUB(s6, s8), C81); s6 = MUL(ADD(s6, s8), C81);                 \
+        t1 = SUB(r5, r1); r5 = ADD(r5, r1); r8 = SUB(r7, r6); r7 = ADD(r7, r6); \
+        t2 = SUB(s5, s1); s5 = ADD(s5, s1); s8 = SUB(s7, s6); s7 = ADD(s7, s6); \
+        r1 = ADD(r5, s7); r5 = SUB(r5, s7); r6 = ADD(t1, s8); t1 = SUB(t1, s8); \
+        s1 = SUB(s5, r7); s5 = ADD(s5, r7); s6 = SUB(t2, r8); t2 = ADD(t2, r8); \
+        re[1] = ADD(MUL(co[1], r1), MUL(si[1], s1));                            \
+        im[1] = SUB(MUL(co[1], s1), MUL(si[1], r1));                            \
+        re[7] = ADD(MUL(co[7], r5), MUL(si[7], s5));                            \
+        im[7] = SUB(MUL(co[7], s5), MUL(si[7], r5));                            \
+        re[5] = ADD(MUL(co[5], r6), MUL(si[5], s6));                            \
+        im[5] = SUB(MUL(co[5], s6), MUL(si[5], r6));                            \
+        re[3] = ADD(MUL(co[3], t1), MUL(si[3], t2));                            \
+        im[3] = SUB(MUL(co[3], t2), MUL(si[3], t1));                            \
+    } while (0)
+
+#define DSP_SIMD_S_ADD(a, b)    ((a) + (b))
+#define DSP_SIMD_S_SUB(a, b)    ((a) - (b))
+#define DSP_SIMD_S_MUL(a, b)    ((a) * (b))
+
+#define DSP_SIMD_C81            0.70710678118f
+
+static void DSP_SIMD_FN(radix8_first)(float32_t *pSrc, uint32_t i1, uint32_t n2)
+{
+    float32_t re[8], im[8];
+    uint32_t p;
+
+    for (p = 0; p < 8U; p++)
+    {
+        re[p] = pSrc[2U * (i1 + p * n2)];
+        im[p] = pSrc[2U * (i1 + p * n2) + 1U];
+    }
+    DSP_SIMD_RADIX8_FIRST(float32_t, DSP_SIMD_S_ADD, DSP_SIMD_S_SUB, DSP_SIMD_S_MUL,
+                          DSP_SIMD_C81, re, im);
+    for (p = 0; p < 8U; p++)
+    {
+        pSrc[2U * (i1 + p * n2)] = re[p];
+        pSrc[2U * (i1 + p * n2) + 1U] = im[p];
+    }
+}
+
+/* DSP_SIMD_W butterflies without twiddles, lane l at i1 + l * n1 */
+static void DSP_SIMD_FN(radix8_first_v)(float32_t *pSrc, uint32_t i1, uint32_t n1, uint32_t n2)
+{
+    float32_t tmp[2U * DSP_SIMD_W];
+    VF re[8], im[8], c81 = vf_set1(DSP_SIMD_C81);
+    uint32_t p, l, at;
+
+    for (p = 0; p < 8U; p++)
+    {
+        vf_gather_cplx(pSrc + 2U * (i1 + p * n2), n1, re[p], im[p]);
+    }
+    DSP_SIMD_RADIX8_FIRST(VF, vf_add, vf_sub, vf_mul, c81, re, im);
+    for (p = 0; p < 8U; p++)
+    {
+        vf_store_cplx(tmp, re[p], im[p]);
+        for (l = 0; l < DSP_SIMD_W; l++)
+        {
+            at = 2U * (i1 + l * n1 + p * n2);
+            pSrc[at] = tmp[2U * l];
+            pSrc[at + 1U] = tmp[2U * l + 1U];
+        }
+    }
+}
+
+static void DSP_SIMD_FN(radix8_butterfly_f32)(float32_t *pSrc, uint16_t fftLen, const float32_t *pCoef,
+                                              uint16_t twidCoefModifier)
+{
+    uint32_t lane0[DSP_SIMD_W] = { 0xFFFFFFFFU };
+    float32_t mask[DSP_SIMD_W];
+    VF vco[8], vsi[8], re[8], im[8], fre[8], fim[8], first, c81 = vf_set1(DSP_SIMD_C81);
+    uint32_t n1, n2 = fftLen, mod = twidCoefModifier;
+    uint32_t i1, j, p;
+
+    memcpy(mask, lane0, sizeof(mask));
+    first = vf_loadu(mask);
+
+    do
+    {
+        n1 = n2;
+        n2 = n2 >> 3;
+
+        if (n2 < 8U)
+        {
+            /* Last stage: butterflies without twiddles only, at i1 = 0, n1,
+               2 * n1, ... */
+            for (i1 = 0; i1 + DSP_SIMD_W * n1 <= fftLen; i1 += DSP_SIMD_W * n1)
+            {
+                DSP_SIMD_FN(radix8_first_v)(pSrc, i1, n1, n2);
+            }
+            for (; i1 < fftLen; i1 += n1)
+            {
+                DSP_SIMD_FN(radix8_first)(pSrc, i1, n2);
+            }
+            break;
+        }
+
+        /* The butterflies at i1 = j, j + n1, ... for DSP_SIMD_W consecutive
+           j side by side, their points being adjacent in memory. n2 is a
+           multiple of 8, so the groups fill it. CMSIS does j = 0 without
+           twiddles, in other operations, so in the first group lane 0 is
+           computed both ways and the untwiddled result kept. */
+        for (j = 0; j < n2; j += DSP_SIMD_W)
+        {
+            for (p = 1; p < 8U; p++)
+            {
+                vf_gather_cplx(pCoef + 2U * p * j * mod, p * mod, vco[p], vsi[p]);
+            }
+            for (i1 = j; i1 < fftLen; i1 += n1)
+            {
+                for (p = 0; p < 8U; p++)
+                {
+                    vf_load_cplx(pSrc + 2U * (i1 + p * n2), re[p], im[p]);
+                }
+                if (j == 0U)
+                {
+                    for (p = 0; p < 8U; p++)
+                    {
+                        fre[p] = re[p];
+                        fim[p] = im[p];
+                    }
+                    DSP_SIMD_RADIX8_FIRST(VF, vf_add, vf_sub, vf_mul, c81, fre, fim);
+                }
+                DSP_SIMD_RADIX8_TWIDDLE(VF, vf_add, vf_sub, vf_mul, c81, re, im, vco, vsi);
+                if (j == 0U)
+                {
+                    for (p = 0; p < 8U; p++)
+                    {
+                        re[p] = vf_select(first, fre[p], re[p]);
+                        im[p] = vf_select(first, fim[p], im[p]);
+                    }
+                }
+                for (p = 0; p < 8U; p++)
+                {
+                    vf_store_cplx(pSrc + 2U * (i1 + p * n2), re[p], im[p]);
+                }
+            }
+        }
+
+        mod <<= 3;
+    } while (n2 > 7U);
+}
+
+/* ---------------------------------------------------------------------------
+ * Table
+ * ------------------------------------------------------------------------ */
+
+#ifndef DSP_SIMD_FIR_Q31
+#define DSP_SIMD_FIR_Q31        arm_fir_q31_ref
+#endif
+
+#ifndef DSP_SIMD_DOT_PROD_Q31
+#define DSP_SIMD_DOT_PROD_Q31   arm_dot_prod_q31_ref
+#endif
+
+const dsp_simd_table_t DSP_SIMD_TABLE =
+{
+    DSP_SIMD_FN(fir_f32),
+    DSP_SIMD_FN(fir_q15),
+    DSP_SIMD_FIR_Q31,
+    DSP_SIMD_FN(biquad_df1_f32),
+    DSP_SIMD_FN(dot_prod_f32),
+    DSP_SIMD_FN(dot_prod_q15),
+    DSP_SIMD_DOT_PROD_Q31,
+    DSP_SIMD_FN(mat_mult_f32),
+    DSP_SIMD_FN(radix8_butterfly_f32),
+};
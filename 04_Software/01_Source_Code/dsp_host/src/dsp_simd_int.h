@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd_int.h
+  * @brief   Kernel tables shared by dsp_simd.c and the SIMD kernel files.
+  ******************************************************************************
+  */
+#ifndef __DSP_SIMD_INT_H__
+#define __DSP_SIMD_INT_H__
+
+#include "arm_math.h"
+#include "dsp_simd.h"
+
+typedef struct
+{
+    void (*fir_f32)(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+    void (*fir_q15)(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+    void (*fir_q31)(const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+    void (*biquad_df1_f32)(const arm_biquad_casd_df1_inst_f32 *S, float32_t *pSrc, float32_t *pDst,
+                           uint32_t blockSize);
+    void (*dot_prod_f32)(float32_t *pSrcA, float32_t *pSrcB, uint32_t blockSize, float32_t *result);
+    void (*dot_prod_q15)(q15_t *pSrcA, q15_t *pSrcB, uint32_t blockSize, q63_t *result);
+    void (*dot_prod_q31)(q31_t *pSrcA, q31_t *pSrcB, uint32_t blockSize, q63_t *result);
+    arm_status (*mat_mult_f32)(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+                               arm_matrix_instance_f32 *pDst);
+    void (*radix8_butterfly_f32)(float32_t *pSrc, uint16_t fftLen, const float32_t *pCoef,
+                                 uint16_t twidCoefModifier);
+} dsp_simd_table_t;
+
+/* The CMSIS C versions, renamed by the Makefile */
+void arm_fir_f32_ref(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+void arm_fir_q15_ref(const arm_fir_instance_q15 *S, q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+void arm_fir_q31_ref(const arm_fir_instance_q31 *S, q31_t *pSrc, q31_t *pDst, uint32_t blockSize);
+void arm_biquad_cascade_df1_f32_ref(const arm_biquad_casd_df1_inst_f32 *S, float32_t *pSrc, float32_t *pDst,
+                                    uint32_t blockSize);
+void arm_dot_prod_f32_ref(float32_t *pSrcA, float32_t *pSrcB, uint32_t blockSize, float32_t *result);
+void arm_dot_prod_q15_ref(q15_t *pSrcA, q15_t *pSrcB, uint32_t blockSize, q63_t *result);
+void arm_dot_prod_q31_ref(q31_t *pSrcA, q31_t *pSrcB, uint32_t blockSize, q63_t *result);
+arm_status arm_mat_mult_f32_ref(const arm_matrix_instance_f32 *pSrcA, const arm_matrix_instance_f32 *pSrcB,
+                                arm_matrix_instance_f32 *pDst);
+void arm_radix8_butterfly_f32_ref(float32_t *pSrc, uint16_t fftLen, const float32_t *pCoef,
+                                  uint16_t twidCoefModifier);
+
+/* Defined when the compiler targets x86 */
+extern const dsp_simd_table_t dsp_simd_sse2;
+extern const dsp_simd_table_t dsp_simd_avx2;
+
+#endif /* __DSP_SIMD_INT_H__ */
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd_sse2.c
+  * @brief   SSE2 versions of the dispatched CMSIS-DSP kernels.
+  ******************************************************************************
+  * Built with -msse2; empty when the compiler does not target SSE2.
+  ******************************************************************************
+  */
+#include "dsp_simd_int.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#define DSP_SIMD_W              4U
+#define DSP_SIMD_QW             8U
+#define DSP_SIMD_FN(name)       sse2_##name
+#define DSP_SIMD_TABLE          dsp_simd_sse2
+
+#define VF                      __m128
+#define VI                      __m128i
+
+#define vf_zero()               _mm_setzero_ps()
+#define vf_set1(x)              _mm_set1_ps(x)
+#define vf_loadu(p)             _mm_loadu_ps(p)
+#define vf_storeu(p, v)         _mm_storeu_ps((p), (v))
+#define vf_add(a, b)            _mm_add_ps((a), (b))
+#define vf_sub(a, b)            _mm_sub_ps((a), (b))
+#define vf_mul(a, b)            _mm_mul_ps((a), (b))
+#define vf_select(m, a, b)      _mm_or_ps(_mm_and_ps((m), (a)), _mm_andnot_ps((m), (b)))
+#define vf_shift_in(v, x)       _mm_move_ss(_mm_shuffle_ps((v), (v), _MM_SHUFFLE(2, 1, 0, 0)), _mm_set_ss(x))
+
+#define vf_load_cplx(p, re, im)                                                 \
+    do                                                                          \
+    {                                                                           \
+        __m128 lo_ = _mm_loadu_ps(p), hi_ = _mm_loadu_ps((p) + 4);              \
+        (re) = _mm_shuffle_ps(lo_, hi_, 0x88);                                  \
+        (im) = _mm_shuffle_ps(lo_, hi_, 0xDD);                                  \
+    } while (0)
+
+#define vf_store_cplx(p, re, im)                                                \
+    do                                                                          \
+    {                                                                           \
+        _mm_storeu_ps((p), _mm_unpacklo_ps((re), (im)));                        \
+        _mm_storeu_ps((p) + 4, _mm_unpackhi_ps((re), (im)));                    \
+    } while (0)
+
+#define vf_gather_cplx(p, stride, re, im)                                      \
+    do                                                                          \
+    {                                                                           \
+        const float32_t *p_ = (p);                                              \
+        uint32_t s_ = 2U * (stride);                                            \
+        (re) = _mm_setr_ps(p_[0], p_[s_], p_[2U * s_], p_[3U * s_]);            \
+        (im) = _mm_setr_ps(p_[1], p_[s_ + 1U], p_[2U * s_ + 1U], p_[3U * s_ + 1U]); \
+    } while (0)
+
+#define vi_zero()               _mm_setzero_si128()
+#define vi_loadu(p)             _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define vi_madd16(a, b)         _mm_madd_epi16((a), (b))
+
+/* Add the four 32-bit pair sums of pmaddwd to the two 64-bit lanes of acc.
+   A pair sum of 2^31 (both pairs -32768 * -32768) wraps to -2^31, so take 1
+   from each first: every sum then fits, and the caller adds the 1s back. */
+static inline __m128i sse2_acc64(__m128i acc, __m128i v)
+{
+    __m128i sign;
+
+    v = _mm_sub_epi32(v, _mm_set1_epi32(1));
+    sign = _mm_srai_epi32(v, 31);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+}
+
+static inline q63_t sse2_hsum64(__m128i acc)
+{
+    int64_t lanes[2];
+
+    _mm_storeu_si128((__m128i *)(void *)lanes, acc);
+    return lanes[0] + lanes[1];
+}
+
+#define vi_acc64(acc, v)        sse2_acc64((acc), (v))
+#define vi_hsum64(acc)          sse2_hsum64(acc)
+
+#include "dsp_simd_impl.h"
+
+#endif /* __SSE2__ */
@@ -0,0 +1,320 @@
+/**
+  ******************************************************************************
+  * @file    job_pool.c
+  * @brief   Work-stealing thread pool on POSIX threads and C11 atomics.
+  ******************************************************************************
+  * Each worker owns a Chase-Lev deque of ranges, packed into 64-bit words as
+  * begin << 32 | end. The owner pushes and pops at the bottom, thieves take
+  * from the top (Le et al., "Correct and Efficient Work-Stealing for Weak
+  * Memory Models", 2013). Splitting halves a range each time, so a deque never
+  * holds more than log2(count) ranges and a fixed array is enough.
+  ******************************************************************************
+  */
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "job_pool.h"
+
+#define JOB_POOL_DEQUE_SIZE     64      /* Power of two, above log2 of any range */
+#define JOB_POOL_CACHE_LINE     64
+
+typedef struct
+{
+    _Atomic int64_t top;
+    char pad0[JOB_POOL_CACHE_LINE - sizeof(int64_t)];
+    _Atomic int64_t bottom;
+    char pad1[JOB_POOL_CACHE_LINE - sizeof(int64_t)];
+    _Atomic uint64_t buf[JOB_POOL_DEQUE_SIZE];
+} job_deque_t;
+
+typedef struct
+{
+    job_pool_t *pool;
+    unsigned index;
+} job_worker_t;
+
+struct job_pool
+{
+    unsigned threads;                   /* Workers, the submitting thread included */
+    job_deque_t *deques;
+    job_worker_t *workers;
+    pthread_t *tids;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    uint64_t generation;                /* Bumped for every job_pool_for() */
+    int quit;
+
+    /* The current run, written before its first range is pushed */
+    job_pool_fn_t fn;
+    void *ctx;
+    uint32_t grain;
+    _Atomic uint32_t remaining;         /* Items not yet processed */
+};
+
+static uint64_t job_pack(uint32_t begin, uint32_t end)
+{
+    return ((uint64_t)begin << 32) | end;
+}
+
+/* Owner only. Returns 0 if the deque is full. */
+static int job_push(job_deque_t *d, uint64_t range)
+{
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+
+    if (b - t >= JOB_POOL_DEQUE_SIZE)
+    {
+        return 0;
+    }
+    atomic_store_explicit(&d->buf[b & (JOB_POOL_DEQUE_SIZE - 1)], range, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+/* Owner only */
+static int job_pop(job_deque_t *d, uint64_t *range)
+{
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    int64_t t;
+    int ok = 1;
+
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    if (t > b)
+    {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return 0;
+    }
+
+    *range = atomic_load_explicit(&d->buf[b & (JOB_POOL_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (t == b)
+    {
+        /* Last range: race the thieves for it */
+        ok = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return ok;
+}
+
+/* Any thread */
+static int job_steal(job_deque_t *d, uint64_t *range)
+{
+    int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+    int64_t b;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b)
+    {
+        return 0;
+    }
+
+    *range = atomic_load_explicit(&d->buf[t & (JOB_POOL_DEQUE_SIZE - 1)], memory_order_relaxed);
+    return atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                   memory_order_seq_cst, memory_order_relaxed);
+}
+
+/* Split a range down to the grain, pushing the upper halves, and run it */
+static void job_run(job_pool_t *pool, unsigned me, uint64_t range)
+{
+    uint32_t begin = (uint32_t)(range >> 32);
+    uint32_t end = (uint32_t)range;
+    uint32_t mid;
+
+    while (end - begin > pool->grain)
+    {
+        mid = begin + (end - begin) / 2;
+        if (!job_push(&pool->deques[me], job_pack(mid, end)))
+        {
+            break;
+        }
+        end = mid;
+    }
+
+    pool->fn(pool->ctx, begin, end, me);
+    atomic_fetch_sub_explicit(&pool->remaining, end - begin, memory_order_acq_rel);
+}
+
+/* Work on the current run until every item is done */
+static void job_work(job_pool_t *pool, unsigned me)
+{
+    uint32_t seed = 2463534242U + me * 1013904223U;
+    uint64_t range;
+    unsigned i, victim;
+    int found;
+
+    while (atomic_load_explicit(&pool->remaining, memory_order_acquire) != 0)
+    {
+        found = job_pop(&pool->deques[me], &range);
+
+        /* Try every other worker, starting at a random one */
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        for (i = 0; !found && (i < pool->threads); i++)
+        {
+            victim = (seed + i) % pool->threads;
+            if (victim != me)
+            {
+                found = job_steal(&pool->deques[victim], &range);
+            }
+        }
+
+        if (found)
+        {
+            job_run(pool, me, range);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
+
+static void *job_thread(void *arg)
+{
+    job_worker_t *w = arg;
+    job_pool_t *pool = w->pool;
+    uint64_t seen = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while ((pool->generation == seen) && !pool->quit)
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        seen = pool->generation;
+        if (pool->quit)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        job_work(pool, w->index);
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Create a pool of threads workers, the calling thread being one of
+ *         them. threads 0 uses every online CPU.
+ * @retval The pool, or NULL if it could not be created.
+ */
+job_pool_t *job_pool_create(unsigned threads)
+{
+    job_pool_t *pool;
+    unsigned i;
+
+    if (threads == 0)
+    {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (n > 0) ? (unsigned)n : 1;
+    }
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->threads = threads;
+    pool->workers = calloc(threads, sizeof(job_worker_t));
+    pool->tids = calloc(threads, sizeof(pthread_t));
+    if ((pool->workers == NULL) || (pool->tids == NULL) ||
+        (posix_memalign((void **)&pool->deques, JOB_POOL_CACHE_LINE, threads * sizeof(job_deque_t)) != 0))
+    {
+        free(pool->workers);
+        free(pool->tids);
+        free(pool);
+        return NULL;
+    }
+    memset(pool->deques, 0, threads * sizeof(job_deque_t));
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+
+    for (i = 0; i < threads; i++)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+    }
+    for (i = 1; i < threads; i++)
+    {
+        if (pthread_create(&pool->tids[i], NULL, job_thread, &pool->workers[i]) != 0)
+        {
+            /* Run with the workers that did start */
+            pool->threads = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void job_pool_destroy(job_pool_t *pool)
+{
+    unsigned i;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 1; i < pool->threads; i++)
+    {
+        pthread_join(pool->tids[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->tids);
+    free(pool);
+}
+
+unsigned job_pool_threads(const job_pool_t *pool)
+{
+    return pool->threads;
+}
+
+/**
+ * @brief  Run fn over items [0, count) in ranges of at most grain items and
+ *         return when all are done.
+ */
+void job_pool_for(job_pool_t *pool, uint32_t count, uint32_t grain, job_pool_fn_t fn, void *ctx)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->grain = (grain != 0) ? grain : 1;
+    atomic_store_explicit(&pool->remaining, count, memory_order_release);
+    job_push(&pool->deques[0], job_pack(0, count));
+
+    if (pool->threads > 1)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pool->generation++;
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    job_work(pool, 0);
+}
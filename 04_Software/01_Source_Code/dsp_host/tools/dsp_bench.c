@@ -0,0 +1,226 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bench.c
+  * @brief   Host runner of the firmware's CMSIS-DSP cycle count sweep
+  *          (Core/Src/dsp_bench.c).
+  ******************************************************************************
+  * usage: dsp_bench [-f csv|json] [-m MIN] [-n MAX] [-r REPEAT] [-k NAME]
+  *                  [-c tsc|perf|ns] [-x TAPS] [-s]
+  *
+  * Sweeps block sizes MIN (default 16) to MAX (default 4096), timing each
+  * point REPEAT times (default 20), and prints the results on stdout. -k
+  * keeps the functions whose name contains NAME. -x runs the FIR crossover
+  * sweep instead: arm_fir_f32 against dsp_ols_fir_f32 up to TAPS taps, on
+  * blocks of MAX samples, with partitions of MIN to MAX. -s runs the sample
+  * rate converter comparison instead, on blocks of MAX input samples.
+  *
+  * The counter is, by default, the time stamp counter on x86, with its rate
+  * measured against CLOCK_MONOTONIC, and the perf_event_open cycle counter
+  * elsewhere; -c picks one. ns falls back on CLOCK_MONOTONIC itself. The
+  * time stamp counter runs at a fixed rate whatever the core clock, so pin
+  * the core frequency, or use perf, for figures comparable between runs.
+  * Kernels dispatched by dsp_simd.h run at the level DSP_SIMD selects.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "dsp_bench.h"
+#include "dsp_simd.h"
+
+#ifndef DSP_BENCH_BUILD
+#define DSP_BENCH_BUILD         "host"
+#endif
+
+/* For -s: the one-stage filters and the chain's, a few hundred kilobytes,
+   and the blocks, inputs, outputs and states, in float */
+#define DSP_BENCH_HOST_RESAMPLE_ARENA(max_block)    ((1U << 20) + 64U * (uint32_t)(max_block))
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t clock_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static uint32_t clock_tsc(void)
+{
+    return (uint32_t)__rdtsc();
+}
+
+/* Time stamp counts per second, over 100 ms */
+static uint32_t tsc_hz(void)
+{
+    double t0 = now_s(), t1;
+    uint64_t c0 = __rdtsc(), c1;
+
+    do
+    {
+        t1 = now_s();
+    } while (t1 - t0 < 0.1);
+    c1 = __rdtsc();
+    return (uint32_t)((double)(c1 - c0) / (t1 - t0));
+}
+#endif
+
+#ifdef __linux__
+static int perf_fd = -1;
+
+static uint32_t clock_perf(void)
+{
+    uint64_t count = 0;
+
+    if (read(perf_fd, &count, sizeof(count)) != sizeof(count))
+    {
+        return 0;
+    }
+    return (uint32_t)count;
+}
+
+/* Cycles of this thread, user space only; fails without perf permission */
+static int perf_open(void)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (perf_fd < 0)
+    {
+        return -1;
+    }
+    ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    return 0;
+}
+#endif
+
+static void write_line(const char *line)
+{
+    puts(line);
+}
+
+int main(int argc, char **argv)
+{
+    dsp_bench_port_t port;
+    char build[96];
+    const char *clock = NULL;
+    uint32_t taps = 0, size;
+    int resample = 0;
+    int opt, points;
+
+    memset(&port, 0, sizeof(port));
+    port.min_block = DSP_BENCH_MIN_BLOCK;
+    port.max_block = 4096;
+    port.repeat = 20;
+    port.format = DSP_BENCH_CSV;
+    port.write = write_line;
+
+    while ((opt = getopt(argc, argv, "f:m:n:r:k:c:x:s")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            port.format = (strcmp(optarg, "json") == 0) ? DSP_BENCH_JSON : DSP_BENCH_CSV;
+            break;
+        case 'm':
+            port.min_block = (uint32_t)atoi(optarg);
+            break;
+        case 'n':
+            port.max_block = (uint32_t)atoi(optarg);
+            break;
+        case 'r':
+            port.repeat = (uint32_t)atoi(optarg);
+            break;
+        case 'k':
+            port.filter = optarg;
+            break;
+        case 'c':
+            clock = optarg;
+            break;
+        case 'x':
+            taps = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            resample = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-f csv|json] [-m MIN] [-n MAX] [-r REPEAT] [-k NAME] "
+                    "[-c tsc|perf|ns] [-x TAPS] [-s]\n", argv[0]);
+            return 2;
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    if ((clock == NULL) || (strcmp(clock, "tsc") == 0))
+    {
+        port.cycles = clock_tsc;
+        port.hz = tsc_hz();
+        port.clock = "tsc";
+    }
+#endif
+#ifdef __linux__
+    if ((port.cycles == NULL) && ((clock == NULL) || (strcmp(clock, "perf") == 0)))
+    {
+        if (perf_open() == 0)
+        {
+            port.cycles = clock_perf;
+            port.clock = "perf";
+        }
+        else if (clock != NULL)
+        {
+            fprintf(stderr, "perf_event_open failed, using ns\n");
+        }
+    }
+#endif
+    if (port.cycles == NULL)
+    {
+        port.cycles = clock_ns;
+        port.hz = 1000000000U;
+        port.clock = "ns";
+    }
+
+    snprintf(build, sizeof(build), "%s simd=%s", DSP_BENCH_BUILD, dsp_simd_name(dsp_simd_level()));
+    port.build = build;
+    size = resample ? DSP_BENCH_HOST_RESAMPLE_ARENA(port.max_block) :
+           (taps > 0U) ? DSP_BENCH_CROSSOVER_ARENA_SIZE(port.max_block, taps) : DSP_BENCH_ARENA_SIZE(port.max_block);
+    port.arena = aligned_alloc(64, (size + 63U) & ~63U);
+    if (port.arena == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    points = resample ? dsp_bench_resample(&port, size) :
+             (taps > 0U) ? dsp_bench_fir_crossover(&port, taps) : dsp_bench_run(&port);
+    free(port.arena);
+    if (points < 0)
+    {
+        fprintf(stderr, "block sizes must be powers of two from %d, MIN <= MAX, TAPS from 16\n", DSP_BENCH_MIN_BLOCK);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,390 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bfp_check.c
+  * @brief   Compares the block floating point FFTs of dsp_bfp.h with
+  *          arm_cfft_q15, arm_cfft_q31 and arm_cfft_f32: SNR against a
+  *          double precision DFT, and time per transform.
+  ******************************************************************************
+  * usage: dsp_bfp_check [-r REPEATS] [-l LEVEL_DB] [-s] [LEN...]
+  *
+  * For each length (default: the powers of two from 16 to 4096) and input
+  * level (default: -6 and -40 dB full scale, or the -l given) the five
+  * transforms run on the same random complex data, quantised to q15 so
+  * that every one of them sees the same values. Printed per transform:
+  *
+  *   - the time per transform, the best of three runs of REPEATS (default
+  *     200) alternating forward and inverse;
+  *   - the SNR of the forward transform against the DFT, the fixed-point
+  *     outputs taken with their scale: fftLen for arm_cfft_q15/_q31, the
+  *     returned exponent for dsp_bfp_cfft_q15/_q31, which is printed too.
+  *
+  * The fixed-point transforms compute the same values here as on the
+  * target; the times are the host's, with the Cortex-M4 DSP instructions
+  * emulated in C. arm_cfft_f32 runs as the C code the target would unless
+  * -s keeps the SIMD radix-8 butterfly of dsp_simd.h. Exits with 1 if the
+  * SNR of a block floating point transform is more than 3 dB below that of
+  * the arm_cfft of its type: for signals near full scale the two shift
+  * about alike, and either may round a little better.
+  ******************************************************************************
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_bfp.h"
+#include "dsp_simd.h"
+
+#define CHECK_TIMINGS           3
+#define CHECK_SNR_MARGIN_DB     3.0
+
+enum
+{
+    K_F32 = 0,
+    K_Q15,
+    K_BFP15,
+    K_Q31,
+    K_BFP31,
+    K_KINDS
+};
+
+static const char *const s_kind_names[K_KINDS] = { "f32", "q15", "bfp15", "q31", "bfp31" };
+
+static const uint32_t s_default_lens[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+static const double s_default_levels[] = { -6.0, -40.0 };
+
+static unsigned repeats = 200;
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---------------------------------------------------------------------------
+ * Reference
+ * ------------------------------------------------------------------------ */
+
+static void dft(const double *x, uint32_t n, double *out)
+{
+    double *c = malloc(n * sizeof(double)), *s = malloc(n * sizeof(double));
+    uint32_t k, j, e;
+
+    for (k = 0; k < n; k++)
+    {
+        c[k] = cos(6.283185307179586 * k / n);
+        s[k] = sin(6.283185307179586 * k / n);
+    }
+    for (k = 0; k < n; k++)
+    {
+        double re = 0.0, im = 0.0;
+
+        for (j = 0, e = 0; j < n; j++)
+        {
+            re += x[2 * j] * c[e] + x[2 * j + 1] * s[e];
+            im += x[2 * j + 1] * c[e] - x[2 * j] * s[e];
+            e += k;
+            e = (e >= n) ? e - n : e;
+        }
+        out[2 * k] = re;
+        out[2 * k + 1] = im;
+    }
+    free(c);
+    free(s);
+}
+
+static double snr_db(const double *ref, const double *x, uint32_t words)
+{
+    double sig = 0.0, err = 0.0;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        sig += ref[i] * ref[i];
+        err += (ref[i] - x[i]) * (ref[i] - x[i]);
+    }
+    return (err == 0.0) ? 999.0 : 10.0 * log10(sig / err);
+}
+
+/* ---------------------------------------------------------------------------
+ * The transforms under test
+ * ------------------------------------------------------------------------ */
+
+typedef struct
+{
+    uint32_t n;
+    const arm_cfft_instance_f32 *f32;
+    const arm_cfft_instance_q31 *q31;
+    const arm_cfft_instance_q15 *q15;
+} plan_t;
+
+/* In place on buf; the exponent of the output */
+static int32_t run(const plan_t *p, int kind, void *buf, uint8_t inverse)
+{
+    switch (kind)
+    {
+    case K_F32:
+        arm_cfft_f32(p->f32, buf, inverse, 1);
+        return 0;
+    case K_Q15:
+        arm_cfft_q15(p->q15, buf, inverse, 1);
+        return inverse ? 0 : (int32_t)(31 - __builtin_clz(p->n));
+    case K_BFP15:
+        return dsp_bfp_cfft_q15(p->q15, buf, inverse, 1);
+    case K_Q31:
+        arm_cfft_q31(p->q31, buf, inverse, 1);
+        return inverse ? 0 : (int32_t)(31 - __builtin_clz(p->n));
+    default:
+        return dsp_bfp_cfft_q31(p->q31, buf, inverse, 1);
+    }
+}
+
+static void load(int kind, const q15_t *in, uint32_t words, void *buf)
+{
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        if (kind == K_F32)
+        {
+            ((float32_t *)buf)[i] = in[i] / 32768.0f;
+        }
+        else if ((kind == K_Q15) || (kind == K_BFP15))
+        {
+            ((q15_t *)buf)[i] = in[i];
+        }
+        else
+        {
+            ((q31_t *)buf)[i] = (q31_t)in[i] * 65536;
+        }
+    }
+}
+
+/* The output as fractions times 2^e */
+static void unload(int kind, const void *buf, uint32_t words, int32_t e, double *out)
+{
+    double scale = ldexp(1.0, e);
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        if (kind == K_F32)
+        {
+            out[i] = ((const float32_t *)buf)[i];
+        }
+        else if ((kind == K_Q15) || (kind == K_BFP15))
+        {
+            out[i] = ((const q15_t *)buf)[i] / 32768.0 * scale;
+        }
+        else
+        {
+            out[i] = ((const q31_t *)buf)[i] / 2147483648.0 * scale;
+        }
+    }
+}
+
+typedef struct
+{
+    double us, snr;
+    int32_t exponent;
+} result_t;
+
+static void measure(const plan_t *p, int kind, const q15_t *in, const double *ref, result_t *r)
+{
+    uint32_t words = 2U * p->n;
+    void *buf = malloc(words * sizeof(float32_t));
+    double *out = malloc(words * sizeof(double)), best = 0.0, t;
+    unsigned k, i;
+
+    load(kind, in, words, buf);
+    r->exponent = run(p, kind, buf, 0);
+    unload(kind, buf, words, r->exponent, out);
+    r->snr = snr_db(ref, out, words);
+
+    for (k = 0; k < CHECK_TIMINGS; k++)
+    {
+        load(kind, in, words, buf);
+        t = now_s();
+        for (i = 0; i < repeats; i++)
+        {
+            (void)run(p, kind, buf, (uint8_t)(i & 1U));
+        }
+        t = (now_s() - t) / repeats;
+        best = ((k == 0) || (t < best)) ? t : best;
+    }
+    r->us = best * 1e6;
+    free(buf);
+    free(out);
+}
+
+static int plan_for(uint32_t n, plan_t *p)
+{
+    p->n = n;
+    switch (n)
+    {
+    case 16:
+        p->f32 = &arm_cfft_sR_f32_len16; p->q31 = &arm_cfft_sR_q31_len16; p->q15 = &arm_cfft_sR_q15_len16;
+        return 1;
+    case 32:
+        p->f32 = &arm_cfft_sR_f32_len32; p->q31 = &arm_cfft_sR_q31_len32; p->q15 = &arm_cfft_sR_q15_len32;
+        return 1;
+    case 64:
+        p->f32 = &arm_cfft_sR_f32_len64; p->q31 = &arm_cfft_sR_q31_len64; p->q15 = &arm_cfft_sR_q15_len64;
+        return 1;
+    case 128:
+        p->f32 = &arm_cfft_sR_f32_len128; p->q31 = &arm_cfft_sR_q31_len128; p->q15 = &arm_cfft_sR_q15_len128;
+        return 1;
+    case 256:
+        p->f32 = &arm_cfft_sR_f32_len256; p->q31 = &arm_cfft_sR_q31_len256; p->q15 = &arm_cfft_sR_q15_len256;
+        return 1;
+    case 512:
+        p->f32 = &arm_cfft_sR_f32_len512; p->q31 = &arm_cfft_sR_q31_len512; p->q15 = &arm_cfft_sR_q15_len512;
+        return 1;
+    case 1024:
+        p->f32 = &arm_cfft_sR_f32_len1024; p->q31 = &arm_cfft_sR_q31_len1024; p->q15 = &arm_cfft_sR_q15_len1024;
+        return 1;
+    case 2048:
+        p->f32 = &arm_cfft_sR_f32_len2048; p->q31 = &arm_cfft_sR_q31_len2048; p->q15 = &arm_cfft_sR_q15_len2048;
+        return 1;
+    case 4096:
+        p->f32 = &arm_cfft_sR_f32_len4096; p->q31 = &arm_cfft_sR_q31_len4096; p->q15 = &arm_cfft_sR_q15_len4096;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Main
+ * ------------------------------------------------------------------------ */
+
+static int check(uint32_t n, double level_db)
+{
+    plan_t p;
+    result_t r[K_KINDS];
+    uint32_t words = 2U * n, i;
+    double amp = 32767.0 * pow(10.0, level_db / 20.0), *x, *ref;
+    q15_t *in;
+    int kind, ok;
+
+    if (!plan_for(n, &p))
+    {
+        printf("%6u  not supported\n", n);
+        return 0;
+    }
+
+    in = malloc(words * sizeof(q15_t));
+    x = malloc(words * sizeof(double));
+    ref = malloc(words * sizeof(double));
+    for (i = 0; i < words; i++)
+    {
+        in[i] = (q15_t)lrint(amp * ((int32_t)rng() / 2147483648.0));
+        x[i] = in[i] / 32768.0;
+    }
+    dft(x, n, ref);
+
+    printf("%6u %6.0f", n, level_db);
+    for (kind = 0; kind < K_KINDS; kind++)
+    {
+        measure(&p, kind, in, ref, &r[kind]);
+        printf(" %8.2f %6.1f", r[kind].us, r[kind].snr);
+        if ((kind == K_BFP15) || (kind == K_BFP31))
+        {
+            printf(" %4d", (int)r[kind].exponent);
+        }
+    }
+    ok = (r[K_BFP15].snr >= r[K_Q15].snr - CHECK_SNR_MARGIN_DB) &&
+         (r[K_BFP31].snr >= r[K_Q31].snr - CHECK_SNR_MARGIN_DB);
+    printf("%s\n", ok ? "" : "  FAIL");
+
+    free(in);
+    free(x);
+    free(ref);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t *lens = s_default_lens;
+    const double *levels = s_default_levels;
+    uint32_t count = sizeof(s_default_lens) / sizeof(s_default_lens[0]), *given = NULL, i, j;
+    uint32_t nlevels = sizeof(s_default_levels) / sizeof(s_default_levels[0]);
+    double level;
+    int opt, simd = 0, ok = 1;
+
+    while ((opt = getopt(argc, argv, "r:l:s")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            repeats = (unsigned)atoi(optarg);
+            break;
+        case 'l':
+            level = atof(optarg);
+            levels = &level;
+            nlevels = 1;
+            break;
+        case 's':
+            simd = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-r REPEATS] [-l LEVEL_DB] [-s] [LEN...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats == 0U)
+    {
+        repeats = 1;
+    }
+    if (optind < argc)
+    {
+        count = (uint32_t)(argc - optind);
+        given = malloc(count * sizeof(uint32_t));
+        for (i = 0; i < count; i++)
+        {
+            given[i] = (uint32_t)strtoul(argv[optind + (int)i], NULL, 0);
+        }
+        lens = given;
+    }
+    if (!simd)
+    {
+        dsp_simd_select(DSP_SIMD_NONE);
+    }
+
+    printf("%u repeats, arm_cfft_f32 with %s butterflies; level in dBFS, time per transform in us, "
+           "SNR in dB\n", repeats, dsp_simd_name(simd ? dsp_simd_supported() : DSP_SIMD_NONE));
+    printf("%6s %6s", "len", "level");
+    for (i = 0; i < K_KINDS; i++)
+    {
+        printf(" %8s %6s", s_kind_names[i], "snr");
+        if ((i == K_BFP15) || (i == K_BFP31))
+        {
+            printf(" %4s", "exp");
+        }
+    }
+    printf("\n");
+    for (j = 0; j < nlevels; j++)
+    {
+        for (i = 0; i < count; i++)
+        {
+            ok &= check(lens[i], levels[j]);
+        }
+    }
+    free(given);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+  * @file    dsp_fft_check.c
+  * @brief   Checks the mixed-radix FFTs of dsp_mrfft.h against a double
+  *          precision DFT and compares their speed and memory with
+  *          arm_cfft_f32 and arm_rfft_fast_f32.
+  ******************************************************************************
+  * usage: dsp_fft_check [-r REPEATS] [-s] [LEN...]
+  *
+  * For each length (default: the powers of two from 16 to 16384 and a set
+  * of mixed lengths) the complex FFT of LEN points and the real FFT of LEN
+  * samples are run on random data. Printed per transform:
+  *
+  *   - the radices of the plan;
+  *   - the bytes of tables: dsp_mrfft's caller memory, and the constant
+  *     twiddle and bit reversal tables of the CMSIS-DSP transform where
+  *     there is one (16 to 4096 points);
+  *   - the time per transform, the best of three runs of REPEATS (default
+  *     200) alternating forward and inverse;
+  *   - the SNR of the forward transform against the DFT and of the round
+  *     trip against the input.
+  *
+  * The CMSIS-DSP transforms run as the C code the target would, unless -s
+  * keeps the SIMD radix-8 butterfly of dsp_simd.h. Exits with 1 if any SNR
+  * is below CHECK_SNR_DB.
+  ******************************************************************************
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_mrfft.h"
+#include "dsp_simd.h"
+
+#define CHECK_TIMINGS           3
+#define CHECK_SNR_DB            100.0
+
+static const uint32_t s_default_lens[] =
+{
+    16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384,
+    240, 1000, 1536, 3000, 6000, 10000,
+};
+
+static unsigned repeats = 200;
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---------------------------------------------------------------------------
+ * Reference
+ * ------------------------------------------------------------------------ */
+
+/* Forward DFT of n complex points, or of n real ones */
+static void dft(const float32_t *x, uint32_t n, int real, double *out)
+{
+    double *c = malloc(n * sizeof(double)), *s = malloc(n * sizeof(double));
+    uint32_t k, j, e;
+
+    for (k = 0; k < n; k++)
+    {
+        c[k] = cos(6.283185307179586 * k / n);
+        s[k] = sin(6.283185307179586 * k / n);
+    }
+    for (k = 0; k < n; k++)
+    {
+        double re = 0.0, im = 0.0;
+
+        for (j = 0, e = 0; j < n; j++)
+        {
+            double xr = real ? x[j] : x[2 * j], xi = real ? 0.0 : x[2 * j + 1];
+
+            re += xr * c[e] + xi * s[e];
+            im += xi * c[e] - xr * s[e];
+            e += k;
+            e = (e >= n) ? e - n : e;
+        }
+        out[2 * k] = re;
+        out[2 * k + 1] = im;
+    }
+    free(c);
+    free(s);
+}
+
+static double snr_db(const double *ref, const float32_t *x, uint32_t words)
+{
+    double sig = 0.0, err = 0.0;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        sig += ref[i] * ref[i];
+        err += (ref[i] - x[i]) * (ref[i] - x[i]);
+    }
+    return (err == 0.0) ? 999.0 : 10.0 * log10(sig / err);
+}
+
+static double snr_db_f(const float32_t *ref, const float32_t *x, uint32_t words)
+{
+    double sig = 0.0, err = 0.0, d;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        d = (double)ref[i] - x[i];
+        sig += (double)ref[i] * ref[i];
+        err += d * d;
+    }
+    return (err == 0.0) ? 999.0 : 10.0 * log10(sig / err);
+}
+
+/* ---------------------------------------------------------------------------
+ * The transforms under test, behind one signature
+ * ------------------------------------------------------------------------ */
+
+typedef struct
+{
+    int real;
+    uint32_t n;
+    const arm_cfft_instance_f32 *arm_cfft;
+    arm_rfft_fast_instance_f32 arm_rfft;
+    dsp_mrfft_cfft_instance_f32 mr_cfft;
+    dsp_mrfft_rfft_instance_f32 mr_rfft;
+    void *mem;
+} plan_t;
+
+typedef struct
+{
+    double us, snr, round_trip;
+} result_t;
+
+/* Real: forward from x into y, inverse from y into x, the source
+   overwritten. Complex: x in place. */
+static void run(plan_t *p, int mr, float32_t *x, float32_t *y, uint8_t inverse)
+{
+    if (p->real && mr)
+    {
+        dsp_mrfft_rfft_f32(&p->mr_rfft, inverse ? y : x, inverse ? x : y, inverse);
+    }
+    else if (p->real)
+    {
+        arm_rfft_fast_f32(&p->arm_rfft, inverse ? y : x, inverse ? x : y, inverse);
+    }
+    else if (mr)
+    {
+        dsp_mrfft_cfft_f32(&p->mr_cfft, x, inverse);
+    }
+    else
+    {
+        arm_cfft_f32(p->arm_cfft, x, inverse, 1);
+    }
+}
+
+static void measure(plan_t *p, int mr, const float32_t *in, const double *ref, result_t *r)
+{
+    uint32_t words = p->real ? p->n : 2U * p->n;
+    float32_t *x = malloc(words * sizeof(float32_t)), *y = malloc(words * sizeof(float32_t));
+    double best = 0.0, t;
+    unsigned k, i;
+
+    /* Accuracy */
+    memcpy(x, in, words * sizeof(float32_t));
+    run(p, mr, x, y, 0);
+    if (!p->real)
+    {
+        memcpy(y, x, words * sizeof(float32_t));
+    }
+    if (p->real)
+    {
+        /* Packed: X[0] and X[n / 2] real, then X[1] .. X[n / 2 - 1] */
+        double *packed = malloc(words * sizeof(double));
+
+        memcpy(packed, ref, words * sizeof(double));
+        packed[1] = ref[p->n];
+        r->snr = snr_db(packed, y, words);
+        free(packed);
+    }
+    else
+    {
+        r->snr = snr_db(ref, y, words);
+    }
+    run(p, mr, x, y, 1);
+    r->round_trip = snr_db_f(in, x, words);
+
+    /* Speed */
+    for (k = 0; k < CHECK_TIMINGS; k++)
+    {
+        memcpy(x, in, words * sizeof(float32_t));
+        t = now_s();
+        for (i = 0; i < repeats; i++)
+        {
+            run(p, mr, x, y, (uint8_t)(i & 1U));
+        }
+        t = (now_s() - t) / repeats;
+        best = ((k == 0) || (t < best)) ? t : best;
+    }
+    r->us = best * 1e6;
+    free(x);
+    free(y);
+}
+
+static const arm_cfft_instance_f32 *arm_cfft_for(uint32_t n)
+{
+    switch (n)
+    {
+    case 16:   return &arm_cfft_sR_f32_len16;
+    case 32:   return &arm_cfft_sR_f32_len32;
+    case 64:   return &arm_cfft_sR_f32_len64;
+    case 128:  return &arm_cfft_sR_f32_len128;
+    case 256:  return &arm_cfft_sR_f32_len256;
+    case 512:  return &arm_cfft_sR_f32_len512;
+    case 1024: return &arm_cfft_sR_f32_len1024;
+    case 2048: return &arm_cfft_sR_f32_len2048;
+    case 4096: return &arm_cfft_sR_f32_len4096;
+    default:   return NULL;
+    }
+}
+
+/* Constant tables of the CMSIS-DSP transform: n complex twiddles and the
+   bit reversal swaps, plus n real twiddles for the real FFT */
+static uint32_t arm_bytes(const plan_t *p)
+{
+    const arm_cfft_instance_f32 *C = arm_cfft_for(p->real ? p->n / 2U : p->n);
+
+    if (C == NULL)
+    {
+        return 0;
+    }
+    return 2U * C->fftLen * sizeof(float32_t) + C->bitRevLength * sizeof(uint16_t) +
+           (p->real ? p->n * sizeof(float32_t) : 0U);
+}
+
+/* ---------------------------------------------------------------------------
+ * Main
+ * ------------------------------------------------------------------------ */
+
+static int check(uint32_t n, int real)
+{
+    plan_t p;
+    result_t mr, arm;
+    uint32_t words = real ? n : 2U * n, size, i;
+    const dsp_mrfft_cfft_instance_f32 *C;
+    float32_t *in;
+    double *ref;
+    char radices[64];
+    int have_arm, ok;
+    size_t at = 0;
+
+    memset(&p, 0, sizeof(p));
+    p.real = real;
+    p.n = n;
+    size = real ? dsp_mrfft_rfft_size_f32(n) : dsp_mrfft_cfft_size_f32(n);
+    if (size == 0U)
+    {
+        printf("%-5s %6u  not supported\n", real ? "rfft" : "cfft", n);
+        return 0;
+    }
+    p.mem = malloc(size);
+    if (real)
+    {
+        (void)dsp_mrfft_rfft_init_f32(&p.mr_rfft, n, p.mem, size);
+        C = &p.mr_rfft.cfft;
+        have_arm = (arm_cfft_for(n / 2U) != NULL) &&
+                   (arm_rfft_fast_init_f32(&p.arm_rfft, (uint16_t)n) == ARM_MATH_SUCCESS);
+    }
+    else
+    {
+        (void)dsp_mrfft_cfft_init_f32(&p.mr_cfft, n, p.mem, size);
+        C = &p.mr_cfft;
+        p.arm_cfft = arm_cfft_for(n);
+        have_arm = (p.arm_cfft != NULL);
+    }
+    for (i = 0; i < C->stages; i++)
+    {
+        at += (size_t)snprintf(radices + at, sizeof(radices) - at, "%s%u", i ? "*" : "", C->radix[i]);
+    }
+
+    in = malloc(words * sizeof(float32_t));
+    ref = malloc(2U * n * sizeof(double));
+    for (i = 0; i < words; i++)
+    {
+        in[i] = (float32_t)(int32_t)rng() / 2147483648.0f;
+    }
+    dft(in, n, real, ref);
+
+    measure(&p, 1, in, ref, &mr);
+    ok = (mr.snr >= CHECK_SNR_DB) && (mr.round_trip >= CHECK_SNR_DB);
+    printf("%-5s %6u %-14s %8u %10.2f %7.1f %7.1f", real ? "rfft" : "cfft", n, radices, C->bytes, mr.us,
+           mr.snr, mr.round_trip);
+    if (have_arm)
+    {
+        measure(&p, 0, in, ref, &arm);
+        ok &= (arm.snr >= CHECK_SNR_DB) && (arm.round_trip >= CHECK_SNR_DB);
+        printf(" %8u %10.2f %7.1f %7.1f %6.2fx", arm_bytes(&p), arm.us, arm.snr, arm.round_trip, arm.us / mr.us);
+    }
+    printf("%s\n", ok ? "" : "  FAIL");
+
+    free(in);
+    free(ref);
+    free(p.mem);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t *lens = s_default_lens;
+    uint32_t count = sizeof(s_default_lens) / sizeof(s_default_lens[0]), *given = NULL, i;
+    int opt, simd = 0, ok = 1;
+
+    while ((opt = getopt(argc, argv, "r:s")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            repeats = (unsigned)atoi(optarg);
+            break;
+        case 's':
+            simd = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-r REPEATS] [-s] [LEN...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats == 0U)
+    {
+        repeats = 1;
+    }
+    if (optind < argc)
+    {
+        count = (uint32_t)(argc - optind);
+        given = malloc(count * sizeof(uint32_t));
+        for (i = 0; i < count; i++)
+        {
+            given[i] = (uint32_t)strtoul(argv[optind + (int)i], NULL, 0);
+        }
+        lens = given;
+    }
+    if (!simd)
+    {
+        dsp_simd_select(DSP_SIMD_NONE);
+    }
+
+    printf("%u repeats, CMSIS-DSP with %s butterflies; SNR in dB, time per transform\n", repeats,
+           dsp_simd_name(simd ? dsp_simd_supported() : DSP_SIMD_NONE));
+    printf("%-5s %6s %-14s %8s %10s %7s %7s %8s %10s %7s %7s %7s\n", "", "len", "radices",
+           "mr B", "mr us", "snr", "trip", "arm B", "arm us", "snr", "trip", "arm/mr");
+    for (i = 0; i < count; i++)
+    {
+        ok &= check(lens[i], 0);
+        ok &= check(lens[i], 1);
+    }
+    free(given);
+    return ok ? 0 : 1;
+}
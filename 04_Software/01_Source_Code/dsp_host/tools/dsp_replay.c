@@ -0,0 +1,276 @@
+/**
+  ******************************************************************************
+  * @file    dsp_replay.c
+  * @brief   Replays a recording through FIR, CFFT and convolution on one
+  *          thread and on a job_pool, checks that the outputs are identical
+  *          and prints the speed-up.
+  ******************************************************************************
+  * usage: dsp_replay [-t THREADS] [-s SECONDS] [recording.f32]
+  *
+  * The recording is raw little-endian float32 samples at 1 kHz; without one,
+  * SECONDS of a synthetic signal are used. The single-threaded reference
+  * calls each CMSIS kernel directly, the same way the firmware does.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_par.h"
+
+#define REPLAY_RATE_HZ          1000
+#define REPLAY_TAPS             64
+#define REPLAY_FFT              (&arm_cfft_sR_f32_len256)
+#define REPLAY_CONV_DIM         32      /* 32x32x3 images, 5x5 kernel, 32 channels */
+#define REPLAY_CONV_CH_IN       3
+#define REPLAY_CONV_CH_OUT      32
+#define REPLAY_CONV_KERNEL      5
+#define REPLAY_CONV_IMAGES      256
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static float32_t *load(const char *path, uint32_t seconds, uint32_t *length)
+{
+    float32_t *data;
+    uint32_t i;
+    long size;
+    FILE *f;
+
+    if (path == NULL)
+    {
+        *length = seconds * REPLAY_RATE_HZ;
+        data = malloc(*length * sizeof(float32_t));
+        for (i = 0; (data != NULL) && (i < *length); i++)
+        {
+            data[i] = arm_sin_f32(2.0f * PI * 50.0f * i / REPLAY_RATE_HZ)
+                    + (float32_t)(rng() & 0xFFFF) / 65536.0f - 0.5f;
+        }
+        return data;
+    }
+
+    f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    *length = (uint32_t)(size / sizeof(float32_t));
+    data = malloc(*length * sizeof(float32_t) + 1);
+    if ((data != NULL) && (fread(data, sizeof(float32_t), *length, f) != *length))
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static void report(const char *name, double t1, double tn, int same)
+{
+    printf("%-10s %10.3f %10.3f %8.2fx  %s\n", name, t1 * 1e3, tn * 1e3, t1 / tn,
+           same ? "identical" : "DIFFERENT");
+}
+
+static int replay_fir(job_pool_t *pool, const float32_t *x, uint32_t n)
+{
+    static float32_t coeffs[REPLAY_TAPS];
+    float32_t *ref = malloc(n * sizeof(float32_t));
+    float32_t *par = malloc(n * sizeof(float32_t));
+    float32_t *state1 = calloc(REPLAY_TAPS - 1 + n, sizeof(float32_t));
+    float32_t staten[REPLAY_TAPS - 1] = {0};
+    arm_fir_instance_f32 S1, Sn;
+    double t1, tn;
+    uint32_t i;
+    int same;
+
+    for (i = 0; i < REPLAY_TAPS; i++)
+    {
+        coeffs[i] = 1.0f / REPLAY_TAPS;
+    }
+    arm_fir_init_f32(&S1, REPLAY_TAPS, coeffs, state1, n);
+    Sn = S1;
+    Sn.pState = staten;
+
+    t1 = now_s();
+    arm_fir_f32(&S1, (float32_t *)x, ref, n);
+    t1 = now_s() - t1;
+
+    tn = now_s();
+    dsp_par_fir_f32(pool, &Sn, x, par, n);
+    tn = now_s() - tn;
+
+    same = (memcmp(ref, par, n * sizeof(float32_t)) == 0)
+        && (memcmp(state1, staten, sizeof(staten)) == 0);
+    report("fir", t1, tn, same);
+
+    free(ref);
+    free(par);
+    free(state1);
+    return same;
+}
+
+static int replay_cfft(job_pool_t *pool, const float32_t *x, uint32_t n)
+{
+    const arm_cfft_instance_f32 *S = REPLAY_FFT;
+    uint32_t frames = n / S->fftLen;
+    uint32_t size = frames * 2U * S->fftLen;
+    float32_t *ref = malloc(size * sizeof(float32_t));
+    float32_t *par = malloc(size * sizeof(float32_t));
+    double t1, tn;
+    uint32_t i;
+    int same;
+
+    /* Real recording into complex frames */
+    for (i = 0; i < size; i++)
+    {
+        ref[i] = (i & 1U) ? 0.0f : x[i / 2U];
+    }
+    memcpy(par, ref, size * sizeof(float32_t));
+
+    t1 = now_s();
+    for (i = 0; i < frames; i++)
+    {
+        arm_cfft_f32(S, ref + i * 2U * S->fftLen, 0, 1);
+    }
+    t1 = now_s() - t1;
+
+    tn = now_s();
+    dsp_par_cfft_f32(pool, S, par, frames, 0, 1);
+    tn = now_s() - tn;
+
+    same = memcmp(ref, par, size * sizeof(float32_t)) == 0;
+    report("cfft", t1, tn, same);
+
+    free(ref);
+    free(par);
+    return same;
+}
+
+static int replay_conv(job_pool_t *pool)
+{
+    static q7_t wt[REPLAY_CONV_CH_OUT * REPLAY_CONV_KERNEL * REPLAY_CONV_KERNEL * REPLAY_CONV_CH_IN];
+    static q7_t bias[REPLAY_CONV_CH_OUT];
+    static q15_t bufferA[2 * REPLAY_CONV_CH_IN * REPLAY_CONV_KERNEL * REPLAY_CONV_KERNEL];
+    dsp_par_conv_q7_t conv;
+    uint32_t in_size = REPLAY_CONV_DIM * REPLAY_CONV_DIM * REPLAY_CONV_CH_IN;
+    uint32_t out_size = REPLAY_CONV_DIM * REPLAY_CONV_DIM * REPLAY_CONV_CH_OUT;
+    q7_t *in = malloc(REPLAY_CONV_IMAGES * in_size);
+    q7_t *ref = malloc(REPLAY_CONV_IMAGES * out_size);
+    q7_t *par = malloc(REPLAY_CONV_IMAGES * out_size);
+    double t1, tn;
+    uint32_t i;
+    int same;
+
+    for (i = 0; i < sizeof(wt); i++)
+    {
+        wt[i] = (q7_t)rng();
+    }
+    for (i = 0; i < sizeof(bias); i++)
+    {
+        bias[i] = (q7_t)rng();
+    }
+    for (i = 0; i < REPLAY_CONV_IMAGES * in_size; i++)
+    {
+        in[i] = (q7_t)rng();
+    }
+
+    conv.fn = arm_convolve_HWC_q7_RGB;
+    conv.dim_im_in = REPLAY_CONV_DIM;
+    conv.ch_im_in = REPLAY_CONV_CH_IN;
+    conv.wt = wt;
+    conv.ch_im_out = REPLAY_CONV_CH_OUT;
+    conv.dim_kernel = REPLAY_CONV_KERNEL;
+    conv.padding = REPLAY_CONV_KERNEL / 2;
+    conv.stride = 1;
+    conv.bias = bias;
+    conv.bias_shift = 0;
+    conv.out_shift = 9;
+    conv.dim_im_out = REPLAY_CONV_DIM;
+
+    t1 = now_s();
+    for (i = 0; i < REPLAY_CONV_IMAGES; i++)
+    {
+        conv.fn(in + i * in_size, conv.dim_im_in, conv.ch_im_in, conv.wt, conv.ch_im_out,
+                conv.dim_kernel, conv.padding, conv.stride, conv.bias, conv.bias_shift,
+                conv.out_shift, ref + i * out_size, conv.dim_im_out, bufferA, NULL);
+    }
+    t1 = now_s() - t1;
+
+    tn = now_s();
+    dsp_par_convolve_HWC_q7(pool, &conv, in, par, REPLAY_CONV_IMAGES);
+    tn = now_s() - tn;
+
+    same = memcmp(ref, par, REPLAY_CONV_IMAGES * out_size) == 0;
+    report("conv q7", t1, tn, same);
+
+    free(in);
+    free(ref);
+    free(par);
+    return same;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned threads = 0;
+    uint32_t seconds = 3600;
+    uint32_t length;
+    float32_t *x;
+    job_pool_t *pool;
+    int opt, ok;
+
+    while ((opt = getopt(argc, argv, "t:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            threads = (unsigned)atoi(optarg);
+            break;
+        case 's':
+            seconds = (uint32_t)atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t THREADS] [-s SECONDS] [recording.f32]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    x = load((optind < argc) ? argv[optind] : NULL, seconds, &length);
+    pool = job_pool_create(threads);
+    if ((x == NULL) || (pool == NULL))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("%u samples, %u threads\n", length, job_pool_threads(pool));
+    printf("%-10s %10s %10s %9s\n", "kernel", "1 thr ms", "pool ms", "speed-up");
+    ok = replay_fir(pool, x, length);
+    ok &= replay_cfft(pool, x, length);
+    ok &= replay_conv(pool);
+
+    job_pool_destroy(pool);
+    free(x);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd_check.c
+  * @brief   Runs every dispatched kernel at each SIMD level the CPU supports,
+  *          checks the results against the CMSIS C reference and prints the
+  *          speed-ups.
+  ******************************************************************************
+  * usage: dsp_simd_check [-r REPEATS]
+  *
+  * Each kernel runs REPEATS times (default 200) on the same random data at
+  * every level, carrying filter state from one run to the next, and the last
+  * outputs and the filter state are compared. All kernels must match the
+  * reference bit for bit except arm_dot_prod_f32, which is checked against a
+  * rounding error bound. The sizes are chosen to leave remainders after
+  * every vector width.
+  ******************************************************************************
+  */
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include "dsp_simd.h"
+
+#define CHECK_DATA              8192    /* Samples of each random input */
+#define CHECK_BLOCK             1021
+#define CHECK_TAPS              37      /* Odd: q15 uses CHECK_TAPS + 1 */
+#define CHECK_STAGES            5
+#define CHECK_DOT               4099
+#define CHECK_ROWS              37
+#define CHECK_INNER             53
+#define CHECK_COLS              61
+#define CHECK_TIMINGS           3
+#define CHECK_OUT_MAX           (2 * 4096 * sizeof(float32_t))
+
+static float32_t fa[CHECK_DATA], fb[CHECK_DATA];
+static q15_t qa[CHECK_DATA], qb[CHECK_DATA];
+static q31_t ra[CHECK_DATA], rb[CHECK_DATA];
+static unsigned repeats = 200;
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng_state = 1;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Mostly random, with the extremes that overflow pair sums and products */
+static void fill_inputs(void)
+{
+    uint32_t i, r;
+
+    for (i = 0; i < CHECK_DATA; i++)
+    {
+        fa[i] = (float32_t)(int32_t)rng() / 2147483648.0f;
+        fb[i] = (float32_t)(int32_t)rng() / 2147483648.0f;
+        r = rng();
+        qa[i] = ((r & 7U) == 0U) ? (q15_t)-32768 : (q15_t)(r >> 16);
+        r = rng();
+        qb[i] = ((r & 7U) == 0U) ? (q15_t)-32768 : (q15_t)(r >> 16);
+        r = rng();
+        ra[i] = ((r & 7U) == 0U) ? INT32_MIN : (q31_t)rng();
+        r = rng();
+        rb[i] = ((r & 7U) == 0U) ? INT32_MIN : (q31_t)rng();
+    }
+}
+
+/* Each check runs its kernel `repeats` times and leaves what is compared in
+   out, returning its size in bytes. */
+
+static size_t check_fir_f32(uint8_t *out)
+{
+    static float32_t state[CHECK_TAPS - 1 + CHECK_BLOCK];
+    arm_fir_instance_f32 S;
+    float32_t *y = (float32_t *)out;
+    unsigned r;
+
+    arm_fir_init_f32(&S, CHECK_TAPS, fb, state, CHECK_BLOCK);
+    for (r = 0; r < repeats; r++)
+    {
+        arm_fir_f32(&S, fa + (r % 4U) * CHECK_BLOCK, y, CHECK_BLOCK);
+    }
+    memcpy(y + CHECK_BLOCK, state, (CHECK_TAPS - 1) * sizeof(float32_t));
+    return (CHECK_BLOCK + CHECK_TAPS - 1) * sizeof(float32_t);
+}
+
+static size_t check_fir_q15(uint8_t *out)
+{
+    static q15_t state[CHECK_TAPS + CHECK_BLOCK];
+    arm_fir_instance_q15 S;
+    q15_t *y = (q15_t *)out;
+    unsigned r;
+
+    arm_fir_init_q15(&S, CHECK_TAPS + 1, qb, state, CHECK_BLOCK);
+    for (r = 0; r < repeats; r++)
+    {
+        arm_fir_q15(&S, qa + (r % 4U) * CHECK_BLOCK, y, CHECK_BLOCK);
+    }
+    memcpy(y + CHECK_BLOCK, state, CHECK_TAPS * sizeof(q15_t));
+    return (CHECK_BLOCK + CHECK_TAPS) * sizeof(q15_t);
+}
+
+static size_t check_fir_q31(uint8_t *out)
+{
+    static q31_t state[CHECK_TAPS - 1 + CHECK_BLOCK];
+    arm_fir_instance_q31 S;
+    q31_t *y = (q31_t *)out;
+    unsigned r;
+
+    arm_fir_init_q31(&S, CHECK_TAPS, rb, state, CHECK_BLOCK);
+    for (r = 0; r < repeats; r++)
+    {
+        arm_fir_q31(&S, ra + (r % 4U) * CHECK_BLOCK, y, CHECK_BLOCK);
+    }
+    memcpy(y + CHECK_BLOCK, state, (CHECK_TAPS - 1) * sizeof(q31_t));
+    return (CHECK_BLOCK + CHECK_TAPS - 1) * sizeof(q31_t);
+}
+
+static size_t check_biquad_f32(uint8_t *out)
+{
+    static float32_t coeffs[5 * CHECK_STAGES];
+    static float32_t state[4 * CHECK_STAGES];
+    arm_biquad_casd_df1_inst_f32 S;
+    float32_t *y = (float32_t *)out;
+    unsigned r, s;
+
+    /* Stable low-pass sections, each a little different */
+    for (s = 0; s < CHECK_STAGES; s++)
+    {
+        coeffs[5 * s + 0] = 0.2f + 0.01f * s;
+        coeffs[5 * s + 1] = 0.4f;
+        coeffs[5 * s + 2] = 0.2f - 0.01f * s;
+        coeffs[5 * s + 3] = 0.5f + 0.05f * s;
+        coeffs[5 * s + 4] = -0.3f;
+    }
+    arm_biquad_cascade_df1_init_f32(&S, CHECK_STAGES, coeffs, state);
+    for (r = 0; r < repeats; r++)
+    {
+        arm_biquad_cascade_df1_f32(&S, fa + (r % 4U) * CHECK_BLOCK, y, CHECK_BLOCK);
+    }
+    memcpy(y + CHECK_BLOCK, state, sizeof(state));
+    return CHECK_BLOCK * sizeof(float32_t) + sizeof(state);
+}
+
+/* The result, then the bound on its rounding error */
+static size_t check_dot_f32(uint8_t *out)
+{
+    float32_t *y = (float32_t *)out;
+    float32_t bound = 0.0f;
+    unsigned r, i;
+
+    for (r = 0; r < repeats; r++)
+    {
+        arm_dot_prod_f32(fa + (r % 4U), fb, CHECK_DOT, y);
+    }
+    for (i = 0; i < CHECK_DOT; i++)
+    {
+        bound += fabsf(fa[(repeats - 1U) % 4U + i] * fb[i]);
+    }
+    y[1] = bound * CHECK_DOT * FLT_EPSILON;
+    return 2 * sizeof(float32_t);
+}
+
+static size_t check_dot_q15(uint8_t *out)
+{
+    unsigned r;
+
+    for (r = 0; r < repeats; r++)
+    {
+        arm_dot_prod_q15(qa + (r % 4U), qb, CHECK_DOT - (r % 4U), (q63_t *)out);
+    }
+    return sizeof(q63_t);
+}
+
+static size_t check_dot_q31(uint8_t *out)
+{
+    unsigned r;
+
+    for (r = 0; r < repeats; r++)
+    {
+        arm_dot_prod_q31(ra + (r % 4U), rb, CHECK_DOT - (r % 4U), (q63_t *)out);
+    }
+    return sizeof(q63_t);
+}
+
+static size_t check_mat_mult_f32(uint8_t *out)
+{
+    arm_matrix_instance_f32 A, B, C;
+    unsigned r;
+
+    arm_mat_init_f32(&A, CHECK_ROWS, CHECK_INNER, fa);
+    arm_mat_init_f32(&B, CHECK_INNER, CHECK_COLS, fb);
+    arm_mat_init_f32(&C, CHECK_ROWS, CHECK_COLS, (float32_t *)out);
+    for (r = 0; r < repeats; r++)
+    {
+        if (arm_mat_mult_f32(&A, &B, &C) != ARM_MATH_SUCCESS)
+        {
+            return 0;
+        }
+    }
+    return CHECK_ROWS * CHECK_COLS * sizeof(float32_t);
+}
+
+static size_t check_cfft(uint8_t *out, const arm_cfft_instance_f32 *S)
+{
+    float32_t *y = (float32_t *)out;
+    unsigned r;
+
+    for (r = 0; r < repeats; r++)
+    {
+        memcpy(y, fa + (r % 4U) * 16U, 2U * S->fftLen * sizeof(float32_t));
+        arm_cfft_f32(S, y, (uint8_t)(r & 1U), 1);
+    }
+    return 2U * S->fftLen * sizeof(float32_t);
+}
+
+static size_t check_cfft_256(uint8_t *out)
+{
+    return check_cfft(out, &arm_cfft_sR_f32_len256);
+}
+
+static size_t check_cfft_1024(uint8_t *out)
+{
+    return check_cfft(out, &arm_cfft_sR_f32_len1024);
+}
+
+static size_t check_cfft_4096(uint8_t *out)
+{
+    return check_cfft(out, &arm_cfft_sR_f32_len4096);
+}
+
+static size_t check_rfft_2048(uint8_t *out)
+{
+    static float32_t x[2048];
+    arm_rfft_fast_instance_f32 S;
+    unsigned r;
+
+    arm_rfft_fast_init_f32(&S, 2048);
+    for (r = 0; r < repeats; r++)
+    {
+        /* arm_rfft_fast_f32 overwrites its input */
+        memcpy(x, fa + (r % 4U) * 16U, sizeof(x));
+        arm_rfft_fast_f32(&S, x, (float32_t *)out, 0);
+    }
+    return sizeof(x);
+}
+
+typedef struct
+{
+    const char *name;
+    size_t (*run)(uint8_t *out);
+} check_t;
+
+static const check_t s_checks[] =
+{
+    { "fir f32",        check_fir_f32 },
+    { "fir q15",        check_fir_q15 },
+    { "fir q31",        check_fir_q31 },
+    { "biquad f32",     check_biquad_f32 },
+    { "dot f32",        check_dot_f32 },
+    { "dot q15",        check_dot_q15 },
+    { "dot q31",        check_dot_q31 },
+    { "mat mult f32",   check_mat_mult_f32 },
+    { "cfft 256",       check_cfft_256 },
+    { "cfft 1024",      check_cfft_1024 },
+    { "cfft 4096",      check_cfft_4096 },
+    { "rfft 2048",      check_rfft_2048 },
+};
+
+/* Best time of CHECK_TIMINGS runs; each starts from fresh filter state */
+static double timed_run(const check_t *c, uint8_t *out, size_t *size)
+{
+    double best = 0.0, t;
+    unsigned n;
+
+    for (n = 0; n < CHECK_TIMINGS; n++)
+    {
+        t = now_s();
+        *size = c->run(out);
+        t = now_s() - t;
+        best = ((n == 0) || (t < best)) ? t : best;
+    }
+    return best;
+}
+
+static int same(const check_t *c, const uint8_t *ref, const uint8_t *out, size_t size)
+{
+    const float32_t *fr = (const float32_t *)ref, *fo = (const float32_t *)out;
+
+    if (c->run == check_dot_f32)
+    {
+        return fabsf(fo[0] - fr[0]) <= fr[1];
+    }
+    return memcmp(ref, out, size) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t ref[CHECK_OUT_MAX], out[CHECK_OUT_MAX];
+    dsp_simd_t best = dsp_simd_supported();
+    dsp_simd_t level;
+    double t_ref, t;
+    size_t i, size, size_out;
+    int opt, ok = 1, match;
+
+    while ((opt = getopt(argc, argv, "r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            repeats = (unsigned)atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-r REPEATS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats == 0U)
+    {
+        repeats = 1;
+    }
+
+    fill_inputs();
+    printf("%u repeats, CPU supports %s\n", repeats, dsp_simd_name(best));
+    printf("%-14s %10s", "kernel", "none ms");
+    for (level = DSP_SIMD_SSE2; level <= best; level++)
+    {
+        printf(" %10s %8s", dsp_simd_name(level), "speed-up");
+    }
+    printf("\n");
+
+    for (i = 0; i < sizeof(s_checks) / sizeof(s_checks[0]); i++)
+    {
+        const check_t *c = &s_checks[i];
+
+        dsp_simd_select(DSP_SIMD_NONE);
+        t_ref = timed_run(c, ref, &size);
+        match = (size != 0);
+        printf("%-14s %10.3f", c->name, t_ref * 1e3);
+
+        for (level = DSP_SIMD_SSE2; level <= best; level++)
+        {
+            if (dsp_simd_select(level) != level)
+            {
+                continue;
+            }
+            memset(out, 0, size);
+            t = timed_run(c, out, &size_out);
+            match &= (size_out == size) && same(c, ref, out, size);
+            printf(" %10.3f %7.2fx", t * 1e3, t_ref / t);
+        }
+        printf("  %s\n", match ? "ok" : "MISMATCH");
+        ok &= match;
+    }
+
+    dsp_simd_select(best);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,622 @@
+/**
+  ******************************************************************************
+  * @file    dsp_test.c
+  * @brief   Native runner of the CMSIS-DSP DSP_Lib_TestSuite: runs the JTest
+  *          groups in parallel worker processes and writes JUnit XML.
+  ******************************************************************************
+  * usage: dsp_test [-j JOBS] [-o junit.xml] [-t SECONDS] [-v] [GROUP...]
+  *
+  * Each top-level test group (basic_math_tests, filtering_tests, ...), or
+  * each GROUP named on the command line, runs in a forked worker, at most
+  * JOBS at a time (default: one per CPU). Processes rather than threads
+  * because the suite keeps its inputs, outputs and the JTest state in
+  * globals; a crash or a hang (-t, default 60 s) also stays in its worker
+  * and is reported as an error of the test that was running.
+  *
+  * On the target JTest hands its output to the Keil debugger through the
+  * trigger functions (test_start, dump_str, ...); here those functions
+  * write the test names, results, times and output lines to a file per
+  * worker, which the parent turns into one JUnit testsuite per group and a
+  * testcase per test, named after the subgroup path. Cycle counts printed
+  * by the tests are nanoseconds on the host (jtest_systick.h).
+  *
+  * Exits with 0 if every test passed, 1 otherwise.
+  ******************************************************************************
+  */
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "jtest.h"
+#include "basic_math_test_group.h"
+#include "complex_math_test_group.h"
+#include "controller_test_group.h"
+#include "fast_math_test_group.h"
+#include "filtering_test_group.h"
+#include "intrinsics_test_group.h"
+#include "matrix_test_group.h"
+#include "statistics_test_group.h"
+#include "support_test_group.h"
+#include "transform_test_group.h"
+
+#define TEST_DEPTH              8       /* Group nesting kept for names */
+#define TEST_NAME               128
+#define TEST_OUTPUT             4096    /* Output kept per test */
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+} test_group_t;
+
+#define GROUP(g) \
+    static void run_##g(void) { JTEST_GROUP_CALL(g); }
+
+GROUP(basic_math_tests)
+GROUP(complex_math_tests)
+GROUP(controller_tests)
+GROUP(fast_math_tests)
+GROUP(filtering_tests)
+GROUP(intrinsics_tests)
+GROUP(matrix_tests)
+GROUP(statistics_tests)
+GROUP(support_tests)
+GROUP(transform_tests)
+
+/* Longest first, so that they start first */
+static const test_group_t s_groups[] =
+{
+    { "filtering_tests", run_filtering_tests },
+    { "transform_tests", run_transform_tests },
+    { "matrix_tests", run_matrix_tests },
+    { "statistics_tests", run_statistics_tests },
+    { "complex_math_tests", run_complex_math_tests },
+    { "basic_math_tests", run_basic_math_tests },
+    { "fast_math_tests", run_fast_math_tests },
+    { "support_tests", run_support_tests },
+    { "controller_tests", run_controller_tests },
+    { "intrinsics_tests", run_intrinsics_tests },
+};
+
+#define GROUPS                  (sizeof(s_groups) / sizeof(s_groups[0]))
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ---------------------------------------------------------------------------
+ * Worker: the JTest trigger functions and the timer of jtest_systick.h
+ *
+ * Records, one per line, text escaped with \\ and \n:
+ *   G name             group entered
+ *   g                  group left
+ *   T name<TAB>fut     test started
+ *   O text             output of the running test
+ *   R P|F seconds      test finished, passed or failed
+ * ------------------------------------------------------------------------ */
+
+static FILE *s_out;
+static double s_test_t0;
+static struct timespec s_timer_t0;
+
+enum
+{
+    DUMP_TEXT = 0,
+    DUMP_GROUP_NAME,
+    DUMP_TEST_NAME,
+    DUMP_FUT
+};
+
+static int s_expect = DUMP_TEXT;
+static int s_in_test;
+static int s_passed;
+static char s_test_name[TEST_NAME];
+
+void jtest_host_timer_start(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &s_timer_t0);
+}
+
+uint32_t jtest_host_timer_value(void)
+{
+    struct timespec ts;
+    uint64_t ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = (uint64_t)(ts.tv_sec - s_timer_t0.tv_sec) * 1000000000U + (uint64_t)ts.tv_nsec - (uint64_t)s_timer_t0.tv_nsec;
+    return (ns < JTEST_SYSTICK_INITIAL_VALUE) ? (uint32_t)(JTEST_SYSTICK_INITIAL_VALUE - ns) : 0U;
+}
+
+/* Write s without its trailing newline, escaped */
+static void put_escaped(const char *s, size_t len)
+{
+    size_t i;
+
+    while ((len > 0U) && (s[len - 1U] == '\n'))
+    {
+        len--;
+    }
+    for (i = 0; i < len; i++)
+    {
+        if (s[i] == '\\')
+        {
+            fputs("\\\\", s_out);
+        }
+        else if (s[i] == '\n')
+        {
+            fputs("\\n", s_out);
+        }
+        else
+        {
+            fputc(s[i], s_out);
+        }
+    }
+}
+
+/* Name without the newline STR_NL adds */
+static void copy_name(char *dst, const char *src)
+{
+    size_t len = strcspn(src, "\n");
+
+    len = (len < TEST_NAME - 1U) ? len : TEST_NAME - 1U;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+void test_start(void)
+{
+    s_in_test = 1;
+    s_passed = 0;
+    s_test_t0 = now_s();
+}
+
+void test_end(void)
+{
+    fprintf(s_out, "R %c %.6f\n", s_passed ? 'P' : 'F', now_s() - s_test_t0);
+    fflush(s_out);
+    s_in_test = 0;
+}
+
+void group_start(void)
+{
+}
+
+void group_end(void)
+{
+    fputs("g\n", s_out);
+}
+
+/* The debugger reads JTEST_STR_MAX_OUTPUT_SIZE bytes per dump */
+void dump_str(void)
+{
+    const char *s = JTEST_FW.str_buffer;
+    size_t len = strnlen(s, JTEST_STR_MAX_OUTPUT_SIZE);
+
+    switch (s_expect)
+    {
+    case DUMP_GROUP_NAME:
+        fputs("G ", s_out);
+        put_escaped(s, len);
+        fputc('\n', s_out);
+        s_expect = DUMP_TEXT;
+        return;
+    case DUMP_TEST_NAME:
+        copy_name(s_test_name, s);
+        s_expect = DUMP_TEXT;
+        return;
+    case DUMP_FUT:
+        fprintf(s_out, "T %s\t", s_test_name);
+        put_escaped(s, len);
+        fputc('\n', s_out);
+        fflush(s_out);
+        s_expect = DUMP_TEXT;
+        return;
+    default:
+        break;
+    }
+
+    if (strcmp(s, "Group Name:\n") == 0)
+    {
+        s_expect = DUMP_GROUP_NAME;
+    }
+    else if (strcmp(s, "Test Name:\n") == 0)
+    {
+        s_expect = DUMP_TEST_NAME;
+    }
+    else if (strcmp(s, "Function Under Test:\n") == 0)
+    {
+        s_expect = DUMP_FUT;
+    }
+    else if (s_in_test && (strcmp(s, "Test Passed\n") == 0))
+    {
+        s_passed = 1;
+    }
+    else if (s_in_test && (strcmp(s, "Test Failed\n") != 0))
+    {
+        fputs("O ", s_out);
+        put_escaped(s, len);
+        fputc('\n', s_out);
+    }
+}
+
+void dump_data(void)
+{
+}
+
+void exit_fw(void)
+{
+}
+
+static void worker(const test_group_t *group, FILE *out, unsigned timeout)
+{
+    s_out = out;
+    alarm(timeout);
+    JTEST_INIT();
+    group->run();
+    fflush(out);
+    _exit(0);
+}
+
+/* ---------------------------------------------------------------------------
+ * Parent: scheduling and the report
+ * ------------------------------------------------------------------------ */
+
+typedef struct
+{
+    const test_group_t *group;
+    FILE *out;
+    pid_t pid;
+    int status;
+    double t0, seconds;
+    unsigned tests, failures, errors;
+} test_job_t;
+
+static int s_verbose;
+
+static void xml_escaped(FILE *xml, const char *s)
+{
+    for (; *s != '\0'; s++)
+    {
+        switch (*s)
+        {
+        case '<':
+            fputs("&lt;", xml);
+            break;
+        case '>':
+            fputs("&gt;", xml);
+            break;
+        case '&':
+            fputs("&amp;", xml);
+            break;
+        case '"':
+            fputs("&quot;", xml);
+            break;
+        default:
+            /* XML 1.0 has no other control characters than these */
+            if (((unsigned char)*s >= 0x20U) || (*s == '\n') || (*s == '\t'))
+            {
+                fputc(*s, xml);
+            }
+            break;
+        }
+    }
+}
+
+/* Undo put_escaped in place */
+static void unescape(char *s)
+{
+    char *d = s;
+
+    for (; *s != '\0'; s++)
+    {
+        if ((s[0] == '\\') && (s[1] == 'n'))
+        {
+            *d++ = '\n';
+            s++;
+        }
+        else if ((s[0] == '\\') && (s[1] == '\\'))
+        {
+            *d++ = '\\';
+            s++;
+        }
+        else
+        {
+            *d++ = *s;
+        }
+    }
+    *d = '\0';
+}
+
+static void append(char *buf, size_t size, const char *text)
+{
+    size_t used = strlen(buf);
+
+    if (used + 1U < size)
+    {
+        snprintf(buf + used, size - used, "%s\n", text);
+    }
+}
+
+static void write_case(FILE *xml, const char *classname, const char *name, const char *fut,
+                       double seconds, const char *kind, const char *message, const char *output)
+{
+    fputs("    <testcase classname=\"", xml);
+    xml_escaped(xml, classname);
+    fputs("\" name=\"", xml);
+    xml_escaped(xml, name);
+    fprintf(xml, "\" time=\"%.6f\">\n", seconds);
+    if (kind != NULL)
+    {
+        fprintf(xml, "      <%s message=\"", kind);
+        xml_escaped(xml, message);
+        fputs("\">", xml);
+        xml_escaped(xml, output);
+        fprintf(xml, "</%s>\n", kind);
+    }
+    if ((fut != NULL) || (output[0] != '\0'))
+    {
+        fputs("      <system-out>", xml);
+        if (fut != NULL)
+        {
+            fputs("Function Under Test: ", xml);
+            xml_escaped(xml, fut);
+            fputc('\n', xml);
+        }
+        xml_escaped(xml, output);
+        fputs("</system-out>\n", xml);
+    }
+    fputs("    </testcase>\n", xml);
+}
+
+/* Why a worker ended early, or NULL */
+static const char *job_failure(const test_job_t *job, char *buf, size_t size)
+{
+    if (WIFSIGNALED(job->status))
+    {
+        if (WTERMSIG(job->status) == SIGALRM)
+        {
+            snprintf(buf, size, "timed out");
+        }
+        else
+        {
+            snprintf(buf, size, "killed by signal %d (%s)", WTERMSIG(job->status),
+                     strsignal(WTERMSIG(job->status)));
+        }
+        return buf;
+    }
+    if (!WIFEXITED(job->status) || (WEXITSTATUS(job->status) != 0))
+    {
+        snprintf(buf, size, "exited with %d", WEXITSTATUS(job->status));
+        return buf;
+    }
+    return NULL;
+}
+
+/* Read a worker's records and write its testsuite, counting into job */
+static void report_job(test_job_t *job, FILE *xml)
+{
+    static char line[TEST_OUTPUT], output[TEST_OUTPUT];
+    char path[TEST_DEPTH * TEST_NAME], name[TEST_NAME], fut[TEST_NAME], why[64];
+    size_t depth_len[TEST_DEPTH + 1];
+    unsigned depth = 0;
+    int open = 0;
+    const char *failure = job_failure(job, why, sizeof(why));
+    FILE *body = tmpfile();
+
+    path[0] = '\0';
+    depth_len[0] = 0;
+    output[0] = '\0';
+    rewind(job->out);
+    while (fgets(line, sizeof(line), job->out) != NULL)
+    {
+        char *text = line + 2;
+
+        line[strcspn(line, "\n")] = '\0';
+        unescape(text);
+        switch (line[0])
+        {
+        case 'G':
+            if (depth < TEST_DEPTH)
+            {
+                snprintf(path + depth_len[depth], sizeof(path) - depth_len[depth], "%s%s",
+                         (depth > 0U) ? "." : "", text);
+                depth_len[depth + 1U] = strlen(path);
+            }
+            depth++;
+            break;
+        case 'g':
+            depth = (depth > 0U) ? depth - 1U : 0U;
+            path[depth_len[(depth < TEST_DEPTH) ? depth : TEST_DEPTH]] = '\0';
+            break;
+        case 'T':
+            copy_name(name, strtok(text, "\t"));
+            copy_name(fut, (text = strtok(NULL, "")) != NULL ? text : "");
+            output[0] = '\0';
+            open = 1;
+            break;
+        case 'O':
+            append(output, sizeof(output), text);
+            break;
+        case 'R':
+            job->tests++;
+            if (text[0] != 'P')
+            {
+                job->failures++;
+            }
+            write_case(body, path, name, fut, atof(text + 2), (text[0] == 'P') ? NULL : "failure",
+                       "Test Failed", output);
+            if (s_verbose || (text[0] != 'P'))
+            {
+                printf("  %-4s %s.%s\n", (text[0] == 'P') ? "ok" : "FAIL", path, name);
+            }
+            open = 0;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (failure != NULL)
+    {
+        /* The test that was running, or the group itself */
+        job->tests++;
+        job->errors++;
+        write_case(body, open ? path : job->group->name, open ? name : "(group)", open ? fut : NULL,
+                   0.0, "error", failure, output);
+        printf("  ERROR %s.%s: %s\n", open ? path : job->group->name, open ? name : "(group)", failure);
+    }
+
+    fprintf(xml, "  <testsuite name=\"%s\" tests=\"%u\" failures=\"%u\" errors=\"%u\" time=\"%.6f\">\n",
+            job->group->name, job->tests, job->failures, job->errors, job->seconds);
+    if (body != NULL)
+    {
+        int c;
+
+        rewind(body);
+        while ((c = fgetc(body)) != EOF)
+        {
+            fputc(c, xml);
+        }
+        fclose(body);
+    }
+    fputs("  </testsuite>\n", xml);
+}
+
+static int start_job(test_job_t *job, unsigned timeout)
+{
+    job->out = tmpfile();
+    if (job->out == NULL)
+    {
+        return -1;
+    }
+    fflush(stdout);
+    job->t0 = now_s();
+    job->pid = fork();
+    if (job->pid == 0)
+    {
+        worker(job->group, job->out, timeout);
+    }
+    return (job->pid < 0) ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    static test_job_t jobs[GROUPS];
+    const char *xml_path = "dsp_test.xml";
+    unsigned timeout = 60, parallel, count = 0, next = 0, running = 0, tests = 0, failures = 0, errors = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    double t0 = now_s();
+    FILE *xml;
+    size_t i, k;
+    int opt, status;
+    pid_t pid;
+
+    parallel = (cpus > 0) ? (unsigned)cpus : 1U;
+    while ((opt = getopt(argc, argv, "j:o:t:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 'j':
+            parallel = (unsigned)atoi(optarg);
+            break;
+        case 'o':
+            xml_path = optarg;
+            break;
+        case 't':
+            timeout = (unsigned)atoi(optarg);
+            break;
+        case 'v':
+            s_verbose = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-j JOBS] [-o junit.xml] [-t SECONDS] [-v] [GROUP...]\n", argv[0]);
+            return 2;
+        }
+    }
+    parallel = (parallel > 0U) ? parallel : 1U;
+
+    for (i = 0; i < GROUPS; i++)
+    {
+        int wanted = (optind == argc);
+
+        for (k = (size_t)optind; k < (size_t)argc; k++)
+        {
+            wanted |= (strcmp(argv[k], s_groups[i].name) == 0);
+        }
+        if (wanted)
+        {
+            jobs[count++].group = &s_groups[i];
+        }
+    }
+    if (count == 0U)
+    {
+        fprintf(stderr, "no such group; the groups are:\n");
+        for (i = 0; i < GROUPS; i++)
+        {
+            fprintf(stderr, "  %s\n", s_groups[i].name);
+        }
+        return 2;
+    }
+
+    while ((next < count) || (running > 0U))
+    {
+        while ((next < count) && (running < parallel))
+        {
+            if (start_job(&jobs[next], timeout) != 0)
+            {
+                fprintf(stderr, "cannot start %s: %s\n", jobs[next].group->name, strerror(errno));
+                return 1;
+            }
+            next++;
+            running++;
+        }
+
+        pid = wait(&status);
+        if (pid < 0)
+        {
+            break;
+        }
+        for (i = 0; i < count; i++)
+        {
+            if (jobs[i].pid == pid)
+            {
+                jobs[i].status = status;
+                jobs[i].seconds = now_s() - jobs[i].t0;
+                running--;
+            }
+        }
+    }
+
+    xml = fopen(xml_path, "w");
+    if (xml == NULL)
+    {
+        fprintf(stderr, "cannot write %s: %s\n", xml_path, strerror(errno));
+        return 1;
+    }
+    fprintf(xml, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites name=\"DSP_Lib_TestSuite\">\n");
+    printf("%-20s %6s %6s %6s %8s\n", "group", "tests", "failed", "errors", "seconds");
+    for (i = 0; i < count; i++)
+    {
+        report_job(&jobs[i], xml);
+        printf("%-20s %6u %6u %6u %8.2f\n", jobs[i].group->name, jobs[i].tests, jobs[i].failures,
+               jobs[i].errors, jobs[i].seconds);
+        tests += jobs[i].tests;
+        failures += jobs[i].failures;
+        errors += jobs[i].errors;
+        fclose(jobs[i].out);
+    }
+    fputs("</testsuites>\n", xml);
+    fclose(xml);
+
+    printf("%u tests, %u failed, %u errors in %.2f s, %u jobs; JUnit report in %s\n",
+           tests, failures, errors, now_s() - t0, parallel, xml_path);
+    return ((failures + errors) == 0U) ? 0 : 1;
+}
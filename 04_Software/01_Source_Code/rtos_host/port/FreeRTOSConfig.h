@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    FreeRTOSConfig.h
+  * @brief   Kernel configuration of the host port (portmacro.h): the
+  *          firmware's scheduling, batched wakeup, stream buffer and
+  *          timer wheel options. Timers are only built for the check that
+  *          defines configUSE_TIMERS (Makefile).
+  ******************************************************************************
+  */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+
+#define configUSE_PREEMPTION                     1
+#define configSUPPORT_STATIC_ALLOCATION          0
+#define configSUPPORT_DYNAMIC_ALLOCATION         1
+#define configUSE_IDLE_HOOK                      0
+#define configUSE_TICK_HOOK                      0
+#define configCPU_CLOCK_HZ                       100000000UL
+#define configTICK_RATE_HZ                       ((TickType_t)1000)
+/* As the firmware: CMSIS-RTOS2 needs 56, more than one bit map word holds */
+#define configMAX_PRIORITIES                     ( 56 )
+#define configMINIMAL_STACK_SIZE                 ((uint16_t)128)
+#define configMAX_TASK_NAME_LEN                  ( 16 )
+#define configUSE_TRACE_FACILITY                 1
+#define configUSE_16_BIT_TICKS                   0
+#define configUSE_MUTEXES                        1
+#define configCHECK_FOR_STACK_OVERFLOW           0
+#define configUSE_RECURSIVE_MUTEXES              1
+#define configUSE_COUNTING_SEMAPHORES            1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  1
+#define configRECORD_STACK_HIGH_ADDRESS          1
+/* For the checks that link a firmware heap file: its size, and ucHeap
+   defined by the check so it can walk the blocks */
+#define configTOTAL_HEAP_SIZE                    ((size_t)15360)
+#define configAPPLICATION_ALLOCATED_HEAP         1
+
+#define configUSE_BATCHED_WAKEUP                 1
+#define configUSE_STREAM_BUFFER_MULTI_PRODUCER   1
+
+#define configUSE_CO_ROUTINES                    0
+/* The timer service task takes a priority the other checks give their own
+   tasks, so it is only created for timer_wheel_check */
+#ifndef configUSE_TIMERS
+#define configUSE_TIMERS                         0
+#endif
+#define configTIMER_TASK_PRIORITY                ( 2 )
+#define configTIMER_QUEUE_LENGTH                 10
+#define configTIMER_TASK_STACK_DEPTH             256
+#define configUSE_TIMER_WHEEL                    1
+#define configTIMER_WHEEL_LEVELS                 4
+
+#define INCLUDE_vTaskPrioritySet             1
+#define INCLUDE_uxTaskPriorityGet            1
+#define INCLUDE_vTaskDelete                  1
+#define INCLUDE_vTaskSuspend                 1
+#define INCLUDE_vTaskDelayUntil              1
+#define INCLUDE_vTaskDelay                   1
+#define INCLUDE_xTaskGetSchedulerState       1
+#define INCLUDE_xTaskGetCurrentTaskHandle    1
+#define INCLUDE_eTaskGetState                1
+#define INCLUDE_xTimerPendFunctionCall       configUSE_TIMERS
+
+/* A task that blocks here carries on at once on the host port, so what
+   happens while it waits is run from the hook the check sets in port.c */
+extern void ( *pxPortStreamBufferWaitHook )( void *pvStreamBuffer );
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer ) \
+    if( pxPortStreamBufferWaitHook != NULL ) pxPortStreamBufferWaitHook( xStreamBuffer )
+
+/* A failed assertion names its line and exits the check with 1 */
+void vPortAssert( const char *pcFile, int iLine );
+#define configASSERT( x ) if( ( x ) == 0 ) vPortAssert( __FILE__, __LINE__ )
+
+#endif /* FREERTOS_CONFIG_H */
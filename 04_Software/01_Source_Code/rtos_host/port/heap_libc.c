@@ -0,0 +1,21 @@
+/**
+  ******************************************************************************
+  * @file    heap_libc.c
+  * @brief   Heap of the host port: the C library's.
+  ******************************************************************************
+  * Linked by the checks that do not put a firmware heap file under test;
+  * heap_replay links heap_4.c or heap_tlsf.c instead.
+  ******************************************************************************
+  */
+#include <stdlib.h>
+#include "FreeRTOS.h"
+
+void *pvPortMalloc(size_t xSize)
+{
+    return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+    free(pv);
+}
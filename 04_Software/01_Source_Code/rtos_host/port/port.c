@@ -0,0 +1,181 @@
+/**
+  ******************************************************************************
+  * @file    port.c
+  * @brief   Host port of the FreeRTOS kernel (portmacro.h).
+  ******************************************************************************
+  * xPortStartScheduler() returns at once, so vTaskStartScheduler() returns
+  * to the check with the scheduler running and the highest priority ready
+  * task selected. Task functions never run and stacks are only allocated.
+  * The heap is the C library's (heap_libc.c) unless a check links a
+  * firmware heap file.
+  *
+  * A check can install one simulated interrupt with vPortSetInterrupt(),
+  * raised by SIGALRM every period or by vPortPendInterrupt(). While
+  * interrupts are masked, by a critical section or
+  * portSET_INTERRUPT_MASK_FROM_ISR() as BASEPRI masks them on the target,
+  * it stays pending and runs when they are unmasked. A yield it asks for is
+  * taken when it returns, and like PendSV the switch runs masked.
+  ******************************************************************************
+  */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+static UBaseType_t s_critical_nesting;
+static BaseType_t s_yield_pending;
+
+/* Masked until the scheduler starts, as vTaskStartScheduler() leaves them */
+static volatile sig_atomic_t s_masked = 1;
+static volatile sig_atomic_t s_pending;
+static volatile sig_atomic_t s_in_isr;
+static void (*volatile s_isr)(void);
+
+/* Set by a check to run while a task waits on a stream buffer (FreeRTOSConfig.h) */
+void (*pxPortStreamBufferWaitHook)(void *pvStreamBuffer);
+
+/* As PendSV runs it: an interrupt that readies a task part way through the
+   selection would be lost */
+static void port_switch_context(void)
+{
+    UBaseType_t uxMask = uxPortSetInterruptMask();
+
+    vTaskSwitchContext();
+    vPortClearInterruptMask(uxMask);
+}
+
+static void port_run_isr(void)
+{
+    s_in_isr = 1;
+    s_pending = 0;
+    if (s_isr != NULL)
+    {
+        s_isr();
+    }
+    s_in_isr = 0;
+    if ((s_yield_pending != pdFALSE) && (s_critical_nesting == 0U) && (s_masked == 0))
+    {
+        s_yield_pending = pdFALSE;
+        port_switch_context();
+    }
+}
+
+static void port_signal(int sig)
+{
+    (void)sig;
+    vPortPendInterrupt();
+}
+
+void vPortAssert(const char *pcFile, int iLine)
+{
+    printf("  assertion failed at %s:%d\n", pcFile, iLine);
+    exit(1);
+}
+
+void vPortSetInterrupt(void (*pxHandler)(void), uint32_t ulPeriodUs)
+{
+    struct itimerval period;
+    struct sigaction sa;
+
+    memset(&period, 0, sizeof(period));
+    (void)setitimer(ITIMER_REAL, &period, NULL);
+    s_isr = pxHandler;
+    s_pending = 0;
+    if ((pxHandler != NULL) && (ulPeriodUs != 0U))
+    {
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = port_signal;
+        sa.sa_flags = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        (void)sigaction(SIGALRM, &sa, NULL);
+        period.it_interval.tv_sec = (time_t)(ulPeriodUs / 1000000U);
+        period.it_interval.tv_usec = (suseconds_t)(ulPeriodUs % 1000000U);
+        period.it_value = period.it_interval;
+        (void)setitimer(ITIMER_REAL, &period, NULL);
+    }
+}
+
+void vPortPendInterrupt(void)
+{
+    if ((s_masked != 0) || (s_in_isr != 0))
+    {
+        s_pending = 1;
+    }
+    else
+    {
+        port_run_isr();
+    }
+}
+
+UBaseType_t uxPortSetInterruptMask(void)
+{
+    UBaseType_t uxMask = (UBaseType_t)s_masked;
+
+    s_masked = 1;
+    return uxMask;
+}
+
+void vPortClearInterruptMask(UBaseType_t uxMask)
+{
+    s_masked = (sig_atomic_t)uxMask;
+    if ((uxMask == 0U) && (s_pending != 0) && (s_in_isr == 0))
+    {
+        port_run_isr();
+    }
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    (void)pxCode;
+    (void)pvParameters;
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    vPortClearInterruptMask(0);
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void vPortYield(void)
+{
+    if ((s_critical_nesting != 0U) || (s_in_isr != 0))
+    {
+        /* PendSV is masked until the critical section is left, and taken
+           after the interrupt */
+        s_yield_pending = pdTRUE;
+    }
+    else
+    {
+        port_switch_context();
+    }
+}
+
+void vPortEnterCritical(void)
+{
+    (void)uxPortSetInterruptMask();
+    s_critical_nesting++;
+}
+
+void vPortExitCritical(void)
+{
+    configASSERT(s_critical_nesting != 0U);
+    s_critical_nesting--;
+    if (s_critical_nesting == 0U)
+    {
+        /* A pending interrupt runs before PendSV */
+        vPortClearInterruptMask(0);
+        if (s_yield_pending != pdFALSE)
+        {
+            s_yield_pending = pdFALSE;
+            port_switch_context();
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    portmacro.h
+  * @brief   Host port of the FreeRTOS kernel, for checks that build the
+  *          firmware's kernel sources unchanged (port.c).
+  ******************************************************************************
+  * There is no second stack: the check's main() calls the kernel API as
+  * whichever task is running, and its one interrupt handler, if it has
+  * one, runs from a signal (port.c). A yield switches
+  * pxCurrentTCB at once, or when the critical section it was asked for in
+  * is left, as PendSV would on the target; the task that was running does
+  * not stop, so a check tells who runs from the kernel's state, not from
+  * the code that executes.
+  *
+  * portCOUNT_LEADING_ZEROS is left to tasks.c, which then keeps the two
+  * level ready bit map the firmware uses with 56 priorities.
+  ******************************************************************************
+  */
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define portCHAR                char
+#define portFLOAT               float
+#define portDOUBLE              double
+#define portLONG                long
+#define portSHORT               short
+#define portSTACK_TYPE          uintptr_t
+#define portBASE_TYPE           long
+#define portPOINTER_SIZE_TYPE   uintptr_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#endif
+
+#define portSTACK_GROWTH        ( -1 )
+#define portTICK_PERIOD_MS      ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT      8
+
+/* Scheduler utilities */
+void vPortYield( void );
+#define portYIELD()                                 vPortYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired )    if( ( xSwitchRequired ) != pdFALSE ) portYIELD()
+#define portYIELD_FROM_ISR( x )                     portEND_SWITCHING_ISR( x )
+
+/* Critical section management: masking holds off the simulated interrupt */
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+UBaseType_t uxPortSetInterruptMask( void );
+void vPortClearInterruptMask( UBaseType_t uxMask );
+#define portDISABLE_INTERRUPTS()                    ( void ) uxPortSetInterruptMask()
+#define portENABLE_INTERRUPTS()                     vPortClearInterruptMask( 0 )
+#define portENTER_CRITICAL()                        vPortEnterCritical()
+#define portEXIT_CRITICAL()                         vPortExitCritical()
+#define portSET_INTERRUPT_MASK_FROM_ISR()           uxPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )      vPortClearInterruptMask( x )
+
+/* The simulated interrupt: pxHandler runs every ulPeriodUs microseconds,
+   or only when pended with ulPeriodUs 0; NULL removes it */
+void vPortSetInterrupt( void ( *pxHandler )( void ), uint32_t ulPeriodUs );
+void vPortPendInterrupt( void );
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+#define portNOP()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,28 @@
+/**
+  ******************************************************************************
+  * @file    FreeRTOS.h
+  * @brief   The part of the FreeRTOS interface the simulated kernel
+  *          (sim_kernel.h) provides to host builds of firmware modules.
+  ******************************************************************************
+  */
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFU)
+
+#define configTICK_RATE_HZ      1000U
+#define pdMS_TO_TICKS(xTimeInMs) \
+    ((TickType_t)(((uint64_t)(xTimeInMs) * configTICK_RATE_HZ) / 1000U))
+
+#endif /* INC_FREERTOS_H */
@@ -0,0 +1,25 @@
+/**
+  ******************************************************************************
+  * @file    elog.h
+  * @brief   EasyLogger's log macros on stdout, for host builds.
+  ******************************************************************************
+  */
+#ifndef __ELOG_H__
+#define __ELOG_H__
+
+#include <stdio.h>
+
+#ifndef LOG_TAG
+#define LOG_TAG                 "NO_TAG"
+#endif
+
+#define elog_host(level, ...)   (printf("%s/%s: ", level, LOG_TAG), printf(__VA_ARGS__), printf("\n"))
+
+#define log_a(...)              elog_host("A", __VA_ARGS__)
+#define log_e(...)              elog_host("E", __VA_ARGS__)
+#define log_w(...)              elog_host("W", __VA_ARGS__)
+#define log_i(...)              elog_host("I", __VA_ARGS__)
+#define log_d(...)              elog_host("D", __VA_ARGS__)
+#define log_v(...)              elog_host("V", __VA_ARGS__)
+
+#endif /* __ELOG_H__ */
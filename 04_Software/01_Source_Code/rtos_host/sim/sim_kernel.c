@@ -0,0 +1,187 @@
+/**
+  ******************************************************************************
+  * @file    sim_kernel.c
+  * @brief   Simulated kernel and clock (sim_kernel.h).
+  ******************************************************************************
+  */
+#include <setjmp.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cmsis_os2.h"
+#include "timestamp.h"
+#include "sim_kernel.h"
+
+#define SIM_COUNTS_PER_TICK     (SIM_HZ / configTICK_RATE_HZ)
+#define SIM_COUNTS_PER_US       (SIM_HZ / 1000000U)
+
+static uint64_t s_now;                  /* Counts since sim_reset() */
+static uint32_t s_latency_max;          /* Counts */
+static uint32_t s_rng;
+static void (*s_hook)(void);
+static osThreadFunc_t s_func;
+static void *s_arg;
+static uint32_t s_notify;
+static jmp_buf s_exit;
+
+static uint32_t sim_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+void sim_reset(void)
+{
+    s_now = 0;
+    s_latency_max = 0;
+    s_rng = 1;
+    s_hook = NULL;
+    s_func = NULL;
+    s_arg = NULL;
+    s_notify = 0;
+}
+
+void sim_wake_latency(uint32_t max_us, uint32_t seed)
+{
+    s_latency_max = max_us * SIM_COUNTS_PER_US;
+    s_rng = (seed != 0U) ? seed : 1U;
+}
+
+void sim_on_wake(void (*hook)(void))
+{
+    s_hook = hook;
+}
+
+void sim_spend_us(uint32_t us)
+{
+    s_now += (uint64_t)us * SIM_COUNTS_PER_US;
+}
+
+int sim_run(void)
+{
+    osThreadFunc_t func = s_func;
+
+    if (func == NULL)
+    {
+        return -1;
+    }
+    if (setjmp(s_exit) == 0)
+    {
+        func(s_arg);
+    }
+    s_func = NULL;
+    return 0;
+}
+
+/* Timestamp service ---------------------------------------------------------*/
+
+void timestamp_init(void)
+{
+}
+
+uint32_t timestamp_hz(void)
+{
+    return SIM_HZ;
+}
+
+uint32_t timestamp_now32(void)
+{
+    return (uint32_t)s_now;
+}
+
+uint64_t timestamp_now(void)
+{
+    return s_now;
+}
+
+uint64_t timestamp_to_ns(uint64_t ticks)
+{
+    return ticks * (1000000000U / SIM_HZ);
+}
+
+uint64_t timestamp_us(void)
+{
+    return s_now / SIM_COUNTS_PER_US;
+}
+
+uint32_t timestamp_us32(void)
+{
+    return (uint32_t)timestamp_us();
+}
+
+/* Kernel --------------------------------------------------------------------*/
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(s_now / SIM_COUNTS_PER_TICK);
+}
+
+/* As the kernel's: no wait when the wake time has passed already */
+void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement)
+{
+    uint64_t wake;
+
+    *pxPreviousWakeTime += xTimeIncrement;
+    wake = (uint64_t)*pxPreviousWakeTime * SIM_COUNTS_PER_TICK;
+    if (wake > s_now)
+    {
+        s_now = wake + ((s_latency_max != 0U) ? (sim_rand() % (s_latency_max + 1U)) : 0U);
+    }
+    if (s_hook != NULL)
+    {
+        s_hook();
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)&s_func;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    if ((xTaskToDelete == NULL) || (xTaskToDelete == xTaskGetCurrentTaskHandle()))
+    {
+        longjmp(s_exit, 1);
+    }
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    (void)xTaskToNotify;
+    s_notify++;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    uint32_t n = s_notify;
+
+    (void)xTicksToWait;
+    s_notify = xClearCountOnExit ? 0U : ((n != 0U) ? (n - 1U) : 0U);
+    return n;
+}
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+    (void)attr;
+
+    if ((func == NULL) || (s_func != NULL))
+    {
+        return NULL;
+    }
+    s_func = func;
+    s_arg = argument;
+    return (osThreadId_t)&s_func;
+}
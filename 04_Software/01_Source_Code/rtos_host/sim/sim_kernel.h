@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file    sim_kernel.h
+  * @brief   Simulated kernel and clock for host builds of firmware modules
+  *          that run on one FreeRTOS task.
+  ******************************************************************************
+  * Time only moves when the code under test waits or a job says it spent
+  * some: vTaskDelayUntil() jumps to the wake tick plus a pseudo-random wake
+  * latency, and sim_spend_us() stands for work. The timestamp service
+  * (timestamp.h) reads the same clock at SIM_HZ, the rate of TIM5 on the
+  * target, and the tick is 1 ms, so every count a module derives from the
+  * two is exact and a run is repeatable.
+  *
+  * One thread may exist at a time. osThreadNew() records it and sim_run()
+  * runs it on the caller's stack until it deletes itself; blocking calls
+  * other than vTaskDelayUntil() return at once.
+  ******************************************************************************
+  */
+#ifndef __SIM_KERNEL_H__
+#define __SIM_KERNEL_H__
+
+#include <stdint.h>
+
+#define SIM_HZ                  100000000U
+
+/**
+ * @brief  Clock, tick and thread back to zero, no latency and no hook.
+ */
+void sim_reset(void);
+
+/**
+ * @brief  Wake up to max_us late from vTaskDelayUntil(), drawn from seed.
+ */
+void sim_wake_latency(uint32_t max_us, uint32_t seed);
+
+/**
+ * @brief  Call hook after every wake-up, in the thread, e.g. to stop it.
+ */
+void sim_on_wake(void (*hook)(void));
+
+/**
+ * @brief  Advance the clock by us microseconds of work.
+ */
+void sim_spend_us(uint32_t us);
+
+/**
+ * @brief  Run the thread osThreadNew() created until it deletes itself.
+ * @retval 0, or -1 if there is none.
+ */
+int sim_run(void);
+
+#endif /* __SIM_KERNEL_H__ */
@@ -0,0 +1,23 @@
+/**
+  ******************************************************************************
+  * @file    task.h
+  * @brief   Task functions of the simulated kernel (sim_kernel.h).
+  ******************************************************************************
+  */
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+#endif /* INC_TASK_H */
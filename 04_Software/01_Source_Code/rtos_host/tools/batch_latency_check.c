@@ -0,0 +1,392 @@
+/**
+  ******************************************************************************
+  * @file    batch_latency_check.c
+  * @brief   Runs the firmware's batched wakeups (queue.c, event_groups.c)
+  *          on the host port with the timer service task, and checks that
+  *          the wake latency delivers a batch that never fills up.
+  ******************************************************************************
+  * usage: batch_latency_check
+  *
+  * As in timer_wheel_check.c, timers.c is included here and check_daemon()
+  * runs the timer service task's loop while it is the task running. Task
+  * rx, above the timer service task, waits with portMAX_DELAY on a queue
+  * or event group with a wake threshold and a latency of CHECK_LATENCY
+  * ticks; task tx, below it, sends, sets and ticks the kernel:
+  *
+  *   queue      one item from tx and two from an interrupt, below the
+  *              threshold of CHECK_ITEMS: rx must stay blocked and be woken
+  *              at the tick the first item was sent plus the latency;
+  *   threshold  a full batch from an interrupt wakes rx at once and
+  *              leaves no timer in the wheel. One more item two ticks later
+  *              starts a new batch, which must wake rx a latency after it,
+  *              not after the batch that filled up;
+  *   flags      one set from tx, then one from an interrupt, below the
+  *              threshold of CHECK_SETS: each must wake rx a latency later
+  *              with the bit, and clear it. A full batch of sets from tx
+  *              then wakes rx at once and leaves no timer in the wheel;
+  *   idle       nothing is sent for several latencies: rx stays blocked and
+  *              the timer service task runs at most once, for a wake time
+  *              it had planned before.
+  *
+  * A failed kernel assertion, or a timer service task that never blocks,
+  * also exits with 1.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+/* The kernel's timers.c, with its static functions and state */
+#include "timers.c"
+#include "event_groups.h"
+
+#define CHECK_LATENCY           5U
+#define CHECK_ITEMS             8U      /* The queue's wake threshold */
+#define CHECK_SETS              4U      /* The event group's */
+#define CHECK_QUEUE_LENGTH      16U
+#define CHECK_BIT               0x01U
+#define CHECK_MAX_PASSES        1000U   /* Of the timer service task's loop without blocking */
+
+static TaskHandle_t s_rx, s_tx, s_daemon;
+static QueueHandle_t s_queue;
+static EventGroupHandle_t s_group;
+static uint32_t s_isr_items;            /* Sent by the next interrupt, or a set if 0 */
+static uint32_t s_sent, s_received;
+static uint32_t s_daemon_runs;
+
+/* Where check_daemon() left the timer service task */
+static int s_daemon_waiting;
+
+static void check_task(void *argument)
+{
+    (void)argument;
+}
+
+/* prvTimerTask()'s loop, for as long as the timer service task is running,
+   as in timer_wheel_check.c */
+static void check_daemon(void)
+{
+    TickType_t next;
+    BaseType_t empty;
+    uint32_t passes = 0;
+
+    if (xTaskGetCurrentTaskHandle() == s_daemon)
+    {
+        s_daemon_runs++;
+    }
+    while (xTaskGetCurrentTaskHandle() == s_daemon)
+    {
+        if (++passes > CHECK_MAX_PASSES)
+        {
+            printf("  timer service task never blocks at tick 0x%lx\n", (unsigned long)xTaskGetTickCount());
+            exit(1);
+        }
+        if (!s_daemon_waiting)
+        {
+            next = prvGetNextExpireTime(&empty);
+            prvProcessTimerOrBlockTask(next, empty);
+            if (xTaskGetCurrentTaskHandle() != s_daemon)
+            {
+                s_daemon_waiting = 1;
+                return;
+            }
+        }
+        s_daemon_waiting = 0;
+        prvProcessReceivedCommands();
+    }
+}
+
+/* One tick, as SysTick raises it, then whatever the timer service task does */
+static void check_tick(void)
+{
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    BaseType_t switch_required = xTaskIncrementTick();
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    portYIELD_FROM_ISR(switch_required);
+    check_daemon();
+}
+
+static void check_isr(void)
+{
+    BaseType_t woken = pdFALSE;
+    uint32_t i;
+
+    if (s_isr_items == 0U)
+    {
+        (void)xEventGroupSetBitsFromISR(s_group, CHECK_BIT, &woken);
+    }
+    for (i = 0; i < s_isr_items; i++)
+    {
+        if (xQueueSendFromISR(s_queue, &s_sent, &woken) == pdPASS)
+        {
+            s_sent++;
+        }
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+static void check_interrupt(uint32_t items)
+{
+    s_isr_items = items;
+    vPortPendInterrupt();
+    check_daemon();
+}
+
+static int check_running(TaskHandle_t task, const char *who, const char *when)
+{
+    if (xTaskGetCurrentTaskHandle() != task)
+    {
+        printf("  %s: %s not running at tick 0x%lx\n", when, who, (unsigned long)xTaskGetTickCount());
+        return 0;
+    }
+    return 1;
+}
+
+/* rx blocks on the queue as the timer service task does, since
+   xQueueReceive() would carry on as tx on the host port */
+static int check_wait_queue(const char *when)
+{
+    if (!check_running(s_rx, "rx", when))
+    {
+        return 0;
+    }
+    vTaskSuspendAll();
+    vQueueWaitForMessageRestricted(s_queue, portMAX_DELAY, pdTRUE);
+    if (xTaskResumeAll() == pdFALSE)
+    {
+        portYIELD();
+    }
+    check_daemon();
+    return check_running(s_tx, "tx", when);
+}
+
+static int check_wait_flags(const char *when)
+{
+    if (!check_running(s_rx, "rx", when))
+    {
+        return 0;
+    }
+    (void)xEventGroupWaitBits(s_group, CHECK_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+    check_daemon();
+    return check_running(s_tx, "tx", when);
+}
+
+/* A batch that is delivered disarms its timer: a stale one would only
+   wake the timer service task, so the wheel is looked at directly */
+static int check_disarmed(const char *when)
+{
+    uint32_t level, slot, timers = 0;
+
+    for (level = 0; level < configTIMER_WHEEL_LEVELS; level++)
+    {
+        for (slot = 0; slot < tmrWHEEL_SLOTS; slot++)
+        {
+            timers += (uint32_t)listCURRENT_LIST_LENGTH(&xTimerWheel[level][slot]);
+        }
+    }
+    if (timers != 0U)
+    {
+        printf("  %s: %lu timers left in the wheel\n", when, (unsigned long)timers);
+        return 0;
+    }
+    return 1;
+}
+
+/* rx must stay blocked until base + CHECK_LATENCY and run then */
+static int check_woken_at(TickType_t base, const char *when)
+{
+    while ((TickType_t)(xTaskGetTickCount() - base) < CHECK_LATENCY)
+    {
+        if (!check_running(s_tx, "tx", when))
+        {
+            return 0;
+        }
+        check_tick();
+    }
+    return check_running(s_rx, "rx", when);
+}
+
+/* rx takes what is queued, which must be everything sent */
+static int check_drain(const char *when)
+{
+    uint32_t item;
+
+    while (xQueueReceive(s_queue, &item, 0) == pdPASS)
+    {
+        if (item != s_received)
+        {
+            printf("  %s: item %lu received, expected %lu\n", when, (unsigned long)item, (unsigned long)s_received);
+            return 0;
+        }
+        s_received++;
+    }
+    if (s_received != s_sent)
+    {
+        printf("  %s: %lu of %lu items received\n", when, (unsigned long)s_received, (unsigned long)s_sent);
+        return 0;
+    }
+    return 1;
+}
+
+static int check_queue(void)
+{
+    TickType_t base;
+
+    if (!check_wait_queue("queue"))
+    {
+        return 0;
+    }
+    base = xTaskGetTickCount();
+    if (xQueueSend(s_queue, &s_sent, 0) != pdPASS)
+    {
+        printf("  queue: send failed\n");
+        return 0;
+    }
+    s_sent++;
+    /* Arming the timer may have readied the timer service task */
+    check_daemon();
+    check_tick();
+    check_interrupt(2);
+    return check_woken_at(base, "queue") && check_drain("queue");
+}
+
+static int check_threshold(void)
+{
+    TickType_t base;
+
+    if (!check_wait_queue("threshold"))
+    {
+        return 0;
+    }
+    check_interrupt(CHECK_ITEMS);
+    if (!check_running(s_rx, "rx", "threshold") || !check_disarmed("threshold") ||
+        !check_drain("threshold") || !check_wait_queue("threshold"))
+    {
+        return 0;
+    }
+    check_tick();
+    check_tick();
+    base = xTaskGetTickCount();
+    check_interrupt(1);
+    return check_woken_at(base, "threshold") && check_drain("threshold");
+}
+
+static int check_bit_taken(const char *when)
+{
+    if (xEventGroupGetBits(s_group) != 0U)
+    {
+        printf("  %s: bits 0x%lx left set\n", when, (unsigned long)xEventGroupGetBits(s_group));
+        return 0;
+    }
+    return 1;
+}
+
+static int check_flags(void)
+{
+    TickType_t base;
+    uint32_t n;
+
+    if (!check_wait_flags("flags"))
+    {
+        return 0;
+    }
+    base = xTaskGetTickCount();
+    (void)xEventGroupSetBits(s_group, CHECK_BIT);
+    check_daemon();
+    if (!check_woken_at(base, "flags") || !check_bit_taken("flags") || !check_wait_flags("flags isr"))
+    {
+        return 0;
+    }
+    check_tick();
+    base = xTaskGetTickCount();
+    check_interrupt(0);
+    if (!check_woken_at(base, "flags isr") || !check_bit_taken("flags isr") || !check_wait_flags("flags full"))
+    {
+        return 0;
+    }
+    for (n = 0; n < CHECK_SETS; n++)
+    {
+        if (!check_running(s_tx, "tx", "flags full"))
+        {
+            return 0;
+        }
+        (void)xEventGroupSetBits(s_group, CHECK_BIT);
+        check_daemon();
+    }
+    return check_running(s_rx, "rx", "flags full") && check_bit_taken("flags full") &&
+           check_disarmed("flags full");
+}
+
+static int check_idle(void)
+{
+    uint32_t i;
+
+    if (!check_wait_queue("idle"))
+    {
+        return 0;
+    }
+    s_daemon_runs = 0;
+    for (i = 0; i < 4U * CHECK_LATENCY; i++)
+    {
+        check_tick();
+        if (!check_running(s_tx, "tx", "idle"))
+        {
+            return 0;
+        }
+    }
+    if (s_daemon_runs > 1U)
+    {
+        printf("  idle: timer service task ran %lu times\n", (unsigned long)s_daemon_runs);
+        return 0;
+    }
+    return 1;
+}
+
+int main(void)
+{
+    static const struct
+    {
+        const char *name;
+        int (*run)(void);
+    } scenarios[] = {
+        { "queue", check_queue },
+        { "threshold", check_threshold },
+        { "flags", check_flags },
+        { "idle", check_idle },
+    };
+    uint32_t i;
+    int ok = 1, r;
+
+    if ((xTaskCreate(check_task, "rx", configMINIMAL_STACK_SIZE, NULL, configTIMER_TASK_PRIORITY + 1, &s_rx) != pdPASS) ||
+        (xTaskCreate(check_task, "tx", configMINIMAL_STACK_SIZE, NULL, configTIMER_TASK_PRIORITY - 1, &s_tx) != pdPASS))
+    {
+        printf("  xTaskCreate failed\n");
+        return 1;
+    }
+    s_queue = xQueueCreate(CHECK_QUEUE_LENGTH, sizeof(uint32_t));
+    s_group = xEventGroupCreate();
+    if ((s_queue == NULL) || (s_group == NULL))
+    {
+        printf("  no memory\n");
+        return 1;
+    }
+    vQueueSetWakeThreshold(s_queue, CHECK_ITEMS);
+    vEventGroupSetWakeThreshold(s_group, CHECK_SETS);
+    if ((xQueueSetWakeLatency(s_queue, CHECK_LATENCY) != pdPASS) ||
+        (xEventGroupSetWakeLatency(s_group, CHECK_LATENCY) != pdPASS))
+    {
+        printf("  no memory for the latency timers\n");
+        return 1;
+    }
+    vPortSetInterrupt(check_isr, 0);
+    vTaskStartScheduler();
+    s_daemon = xTimerGetTimerDaemonTaskHandle();
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        r = ok && scenarios[i].run();
+        printf("%-10s %s\n", scenarios[i].name, r ? "ok" : "FAIL");
+        ok &= r;
+    }
+    vPortSetInterrupt(NULL, 0);
+    return ok ? 0 : 1;
+}
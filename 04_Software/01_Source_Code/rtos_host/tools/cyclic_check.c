@@ -0,0 +1,317 @@
+/**
+  ******************************************************************************
+  * @file    cyclic_check.c
+  * @brief   Runs the firmware's cyclic executive (cyclic.c) on the simulated
+  *          kernel and checks its release jitter, overrun detection and
+  *          overrun policies.
+  ******************************************************************************
+  * usage: cyclic_check [-v]
+  *
+  * Each scenario runs a job table for a number of 1 ms minor cycles. Jobs
+  * take a fixed simulated time, one of them longer on one chosen run, and
+  * every wake-up is up to CHECK_LATENCY_US late. The statistics the
+  * executive keeps are compared with the values the scenario implies:
+  *
+  *   jitter     three jobs, no overrun: every release runs, each job starts
+  *              exactly the run time of the jobs before it in its cycle
+  *              late, and the wake-up jitter stays within the latency;
+  *   skip       a 2.5 ms run makes one cycle overrun; the 1 ms job drops
+  *              the release it missed;
+  *   catch-up   the same with the 1 ms job catching up, late by a cycle;
+  *   cap        an 8 ms run leaves 8 releases pending, of which
+  *              CYCLIC_CATCH_UP_MAX run and the rest are dropped;
+  *   disable    a 12 ms run misses its own deadline and disables its job.
+  *
+  * -v logs the executive's own report after each scenario. Exits with 1 if
+  * any statistic differs.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cyclic.h"
+#include "sim_kernel.h"
+
+#define CHECK_LATENCY_US        20U
+
+typedef struct
+{
+    uint32_t exec_us;
+    uint32_t long_run;                  /* Run, counted from 1, that takes long_us; 0 for none */
+    uint32_t long_us;
+    uint32_t runs;
+} check_job_t;
+
+typedef struct
+{
+    uint32_t releases, runs, skipped, misses, overruns, jitter_max_us;
+    uint8_t disabled;
+} check_expect_t;
+
+static uint32_t s_cycles;               /* Minor cycles to run */
+static int s_verbose;
+
+static void check_job(void *argument)
+{
+    check_job_t *j = (check_job_t *)argument;
+
+    j->runs++;
+    sim_spend_us((j->runs == j->long_run) ? j->long_us : j->exec_us);
+}
+
+static void check_stop(void)
+{
+    if (xTaskGetTickCount() >= s_cycles)
+    {
+        cyclic_stop();
+    }
+}
+
+/* Run the table from tick 0 until s_cycles */
+static int check_run(const cyclic_job_t *jobs, uint32_t count)
+{
+    sim_reset();
+    sim_wake_latency(CHECK_LATENCY_US, 12345U);
+    sim_on_wake(check_stop);
+    if ((cyclic_start(jobs, count) != 0) || (sim_run() != 0))
+    {
+        printf("  cyclic_start failed\n");
+        return 0;
+    }
+    if (s_verbose)
+    {
+        cyclic_report();
+    }
+    return 1;
+}
+
+static int check_value(const char *job, const char *what, uint32_t got, uint32_t want)
+{
+    if (got != want)
+    {
+        printf("  %-6s %-10s %lu, expected %lu\n", job, what, (unsigned long)got, (unsigned long)want);
+        return 0;
+    }
+    return 1;
+}
+
+static int check_stats(const cyclic_job_t *jobs, uint32_t index, const check_expect_t *want)
+{
+    const char *name = jobs[index].name;
+    cyclic_stats_t st;
+    int ok = 1;
+
+    if (cyclic_get_stats(index, &st) != 0)
+    {
+        printf("  %s: no statistics\n", name);
+        return 0;
+    }
+    ok &= check_value(name, "releases", st.releases, want->releases);
+    ok &= check_value(name, "runs", st.runs, want->runs);
+    ok &= check_value(name, "skipped", st.skipped, want->skipped);
+    ok &= check_value(name, "misses", st.misses, want->misses);
+    ok &= check_value(name, "overruns", st.overruns, want->overruns);
+    ok &= check_value(name, "disabled", st.disabled, want->disabled);
+    if (want->jitter_max_us != UINT32_MAX)
+    {
+        ok &= check_value(name, "jitter", st.jitter_max_us, want->jitter_max_us);
+    }
+    return ok;
+}
+
+static int check_frame(uint32_t cycles, uint32_t overruns)
+{
+    cyclic_frame_stats_t frame;
+    int ok = 1;
+
+    cyclic_get_frame_stats(&frame);
+    ok &= check_value("frame", "cycles", frame.cycles, cycles);
+    ok &= check_value("frame", "overruns", frame.overruns, overruns);
+    if (frame.wake_jitter_max_us > CHECK_LATENCY_US)
+    {
+        printf("  frame  wake jitter %lu us, over the %u us latency\n",
+               (unsigned long)frame.wake_jitter_max_us, CHECK_LATENCY_US);
+        ok = 0;
+    }
+    return ok;
+}
+
+/* No overrun: the expected counts and jitter follow from the table alone */
+static int check_jitter(void)
+{
+    static check_job_t arg[3];
+    /* Out of period order, to check the executive sorts them */
+    const cyclic_job_t jobs[3] = {
+        { "slow", check_job, &arg[0], 20, 0, 0, CYCLIC_OVERRUN_SKIP },
+        { "fast", check_job, &arg[1], 1, 0, 0, CYCLIC_OVERRUN_SKIP },
+        { "mid", check_job, &arg[2], 5, 2, 100, CYCLIC_OVERRUN_SKIP },
+    };
+    static const uint8_t order[3] = { 1, 2, 0 };
+    check_expect_t want[3];
+    uint32_t c, i, j, late;
+    cyclic_frame_stats_t frame;
+    cyclic_stats_t st;
+    int ok = 1;
+
+    s_cycles = 1000;
+    memset(arg, 0, sizeof(arg));
+    arg[0].exec_us = 300;
+    arg[1].exec_us = 50;
+    arg[2].exec_us = 120;
+    if (!check_run(jobs, 3))
+    {
+        return 0;
+    }
+
+    memset(want, 0, sizeof(want));
+    for (c = 0; c < s_cycles; c++)
+    {
+        late = 0;
+        for (i = 0; i < 3; i++)
+        {
+            j = order[i];
+            if ((c < jobs[j].offset) || ((c - jobs[j].offset) % jobs[j].period != 0U))
+            {
+                continue;
+            }
+            want[j].releases++;
+            want[j].runs++;
+            want[j].jitter_max_us = (late > want[j].jitter_max_us) ? late : want[j].jitter_max_us;
+            late += arg[j].exec_us;
+        }
+    }
+    /* mid's 100 us budget against 120 us runs */
+    want[2].overruns = want[2].runs;
+
+    for (j = 0; j < 3; j++)
+    {
+        ok &= check_stats(jobs, j, &want[j]);
+        if (cyclic_get_stats(j, &st) == 0)
+        {
+            ok &= check_value(jobs[j].name, "exec min", st.exec_min_us, arg[j].exec_us);
+            ok &= check_value(jobs[j].name, "exec max", st.exec_max_us, arg[j].exec_us);
+        }
+    }
+    ok &= check_frame(s_cycles, 0);
+
+    /* The latency varies from cycle to cycle, so some must show */
+    cyclic_get_frame_stats(&frame);
+    if (frame.wake_jitter_max_us == 0U)
+    {
+        printf("  frame  no wake jitter seen\n");
+        ok = 0;
+    }
+    return ok;
+}
+
+/*
+ * A 1 ms job and a 10 ms one whose fifth run, in cycle 40, takes long_us.
+ * At 2.5 ms cycle 40 ends in tick 42: cycle 41 is never started, and the
+ * 1 ms job finds its releases 41 and 42 pending in cycle 42.
+ */
+static int check_overrun(cyclic_policy_t fast_policy, cyclic_policy_t slow_policy, uint32_t long_us,
+                         const check_expect_t *fast_want, const check_expect_t *slow_want,
+                         uint32_t cycles_want)
+{
+    static check_job_t arg[2];
+    const cyclic_job_t jobs[2] = {
+        { "fast", check_job, &arg[0], 1, 0, 0, fast_policy },
+        { "slow", check_job, &arg[1], 10, 0, 1000, slow_policy },
+    };
+    int ok = 1;
+
+    s_cycles = 100;
+    memset(arg, 0, sizeof(arg));
+    arg[0].exec_us = 50;
+    arg[1].exec_us = 200;
+    arg[1].long_run = 5;
+    arg[1].long_us = long_us;
+    if (!check_run(jobs, 2))
+    {
+        return 0;
+    }
+
+    ok &= check_stats(jobs, 0, fast_want);
+    ok &= check_stats(jobs, 1, slow_want);
+    ok &= check_frame(cycles_want, 1);
+    return ok;
+}
+
+static int check_skip(void)
+{
+    /* Release 41 dropped */
+    static const check_expect_t fast = { 100, 99, 1, 0, 0, UINT32_MAX, 0 };
+    static const check_expect_t slow = { 10, 10, 0, 0, 1, UINT32_MAX, 0 };
+
+    return check_overrun(CYCLIC_OVERRUN_SKIP, CYCLIC_OVERRUN_SKIP, 2500, &fast, &slow, 99);
+}
+
+static int check_catch_up(void)
+{
+    /* Release 41 runs in cycle 42, a cycle after it was due: a miss */
+    static const check_expect_t fast = { 100, 100, 0, 1, 0, UINT32_MAX, 0 };
+    static const check_expect_t slow = { 10, 10, 0, 0, 1, UINT32_MAX, 0 };
+
+    return check_overrun(CYCLIC_OVERRUN_CATCH_UP, CYCLIC_OVERRUN_SKIP, 2500, &fast, &slow, 99);
+}
+
+static int check_cap(void)
+{
+    /* Cycle 40 ends in tick 48: releases 41 to 44 run late, 45 to 48 are
+       dropped, and cycles 41 to 47 are never started */
+    static const check_expect_t fast = { 100, 100 - (8 - CYCLIC_CATCH_UP_MAX), 8 - CYCLIC_CATCH_UP_MAX,
+                                         CYCLIC_CATCH_UP_MAX, 0, UINT32_MAX, 0 };
+    static const check_expect_t slow = { 10, 10, 0, 0, 1, UINT32_MAX, 0 };
+
+    return check_overrun(CYCLIC_OVERRUN_CATCH_UP, CYCLIC_OVERRUN_SKIP, 8000, &fast, &slow, 93);
+}
+
+static int check_disable(void)
+{
+    /* Cycle 40 ends in tick 52, after the 10 ms job's next release: it stops
+       there, and the 1 ms job drops releases 41 to 51 */
+    static const check_expect_t fast = { 100, 89, 11, 0, 0, UINT32_MAX, 0 };
+    static const check_expect_t slow = { 5, 5, 0, 1, 1, UINT32_MAX, 1 };
+
+    return check_overrun(CYCLIC_OVERRUN_SKIP, CYCLIC_OVERRUN_DISABLE, 12000, &fast, &slow, 89);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct
+    {
+        const char *name;
+        int (*run)(void);
+    } scenarios[] = {
+        { "jitter", check_jitter },
+        { "skip", check_skip },
+        { "catch-up", check_catch_up },
+        { "cap", check_cap },
+        { "disable", check_disable },
+    };
+    uint32_t i;
+    int opt, ok = 1, r;
+
+    while ((opt = getopt(argc, argv, "v")) != -1)
+    {
+        if (opt == 'v')
+        {
+            s_verbose = 1;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        r = scenarios[i].run();
+        printf("%-10s %s\n", scenarios[i].name, r ? "ok" : "FAIL");
+        ok &= r;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file    event_group_check.c
+  * @brief   Runs the firmware's event groups (event_groups.c) on the host
+  *          port and checks the wake threshold against xEventGroupSync().
+  ******************************************************************************
+  * usage: event_group_check
+  *
+  * Tasks a, b and c, at priorities 3, 2 and 1, share one event group with
+  * a wake threshold of CHECK_THRESHOLD. A call that blocks switches to the
+  * next task, so each call below is made by the task running then:
+  *
+  *   sync       a and b block in a rendezvous on three bits and c
+  *              completes it, the third set of the batch. Both must be
+  *              woken at once, a running, and the bits cleared;
+  *   batch      a waits for a bit and b sets it: a stays blocked for
+  *              CHECK_THRESHOLD - 1 sets and is woken by the last, as the
+  *              rendezvous started a new batch.
+  *
+  * Exits with 1 if a task is in the wrong state.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+#define CHECK_THRESHOLD         4U
+#define CHECK_BLOCK_TICKS       100U
+
+#define CHECK_BIT_A             0x01U
+#define CHECK_BIT_B             0x02U
+#define CHECK_BIT_C             0x04U
+#define CHECK_BITS_ALL          (CHECK_BIT_A | CHECK_BIT_B | CHECK_BIT_C)
+
+static const char *const s_name[] = { "a", "b", "c" };
+static TaskHandle_t s_task[3];
+static EventGroupHandle_t s_group;
+
+static void check_task(void *argument)
+{
+    (void)argument;
+}
+
+static int check_state(uint32_t i, eTaskState want, const char *when)
+{
+    static const char *const state[] = { "running", "ready", "blocked", "suspended", "deleted", "invalid" };
+    eTaskState got = eTaskGetState(s_task[i]);
+
+    if (got != want)
+    {
+        printf("  %s: task %s %s, expected %s\n", when, s_name[i], state[got], state[want]);
+        return 0;
+    }
+    return 1;
+}
+
+static int check_sync(void)
+{
+    EventBits_t bits;
+    int ok = 1;
+
+    /* a, then b, block in the rendezvous */
+    (void)xEventGroupSync(s_group, CHECK_BIT_A, CHECK_BITS_ALL, CHECK_BLOCK_TICKS);
+    ok &= check_state(0, eBlocked, "a synced");
+    (void)xEventGroupSync(s_group, CHECK_BIT_B, CHECK_BITS_ALL, CHECK_BLOCK_TICKS);
+    ok &= check_state(1, eBlocked, "b synced");
+    ok &= check_state(2, eRunning, "b synced");
+
+    /* c completes it without blocking and a preempts it */
+    bits = xEventGroupSync(s_group, CHECK_BIT_C, CHECK_BITS_ALL, CHECK_BLOCK_TICKS);
+    if (bits != CHECK_BITS_ALL)
+    {
+        printf("  c synced: returned 0x%lx, expected 0x%x\n", (unsigned long)bits, CHECK_BITS_ALL);
+        ok = 0;
+    }
+    ok &= check_state(0, eRunning, "c synced");
+    ok &= check_state(1, eReady, "c synced");
+    ok &= check_state(2, eReady, "c synced");
+    bits = xEventGroupGetBits(s_group);
+    if (bits != 0U)
+    {
+        printf("  c synced: bits 0x%lx left set\n", (unsigned long)bits);
+        ok = 0;
+    }
+    return ok;
+}
+
+static int check_batch(void)
+{
+    char when[32];
+    uint32_t n;
+    int ok = 1;
+
+    /* a blocks, b runs and sets */
+    (void)xEventGroupWaitBits(s_group, CHECK_BIT_A, pdTRUE, pdFALSE, CHECK_BLOCK_TICKS);
+    ok &= check_state(1, eRunning, "a waited");
+    for (n = 1; n < CHECK_THRESHOLD; n++)
+    {
+        (void)xEventGroupSetBits(s_group, CHECK_BIT_A);
+        snprintf(when, sizeof(when), "set %lu", (unsigned long)n);
+        ok &= check_state(0, eBlocked, when);
+    }
+    (void)xEventGroupSetBits(s_group, CHECK_BIT_A);
+    snprintf(when, sizeof(when), "set %u", CHECK_THRESHOLD);
+    ok &= check_state(0, eRunning, when);
+    return ok;
+}
+
+int main(void)
+{
+    static const struct
+    {
+        const char *name;
+        int (*run)(void);
+    } scenarios[] = {
+        { "sync", check_sync },
+        { "batch", check_batch },
+    };
+    uint32_t i;
+    int ok = 1, r;
+
+    for (i = 0; i < 3; i++)
+    {
+        if (xTaskCreate(check_task, s_name[i], configMINIMAL_STACK_SIZE, NULL, 3 - i, &s_task[i]) != pdPASS)
+        {
+            printf("  xTaskCreate failed\n");
+            return 1;
+        }
+    }
+    s_group = xEventGroupCreate();
+    if (s_group == NULL)
+    {
+        printf("  xEventGroupCreate failed\n");
+        return 1;
+    }
+    vEventGroupSetWakeThreshold(s_group, CHECK_THRESHOLD);
+    vTaskStartScheduler();
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        r = scenarios[i].run();
+        printf("%-10s %s\n", scenarios[i].name, r ? "ok" : "FAIL");
+        ok &= r;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,509 @@
+/**
+  ******************************************************************************
+  * @file    heap_replay.c
+  * @brief   Replays an allocation trace through the firmware's heap_4.c or
+  *          heap_tlsf.c on the host port, reports worst case latency and
+  *          fragmentation, and checks the heap's free space figures.
+  ******************************************************************************
+  * usage: heap_replay_4 | heap_replay_tlsf [-r repeats] [trace.bin]
+  *
+  * The trace is bench_heap.c's (bench_heap_trace.h): its start-up pattern,
+  * then BENCH_HEAP_CHURN steps of seeded churn. Given a trace_rec capture
+  * (JLinkRTTLogger ... trace.bin, as for trace2json.py), its MALLOC and FREE
+  * records are replayed instead, each address live on the target becoming a
+  * slot. Both heaps trace the block size, header included, so the 8 byte
+  * header of the 32 bit target is taken off and the heap under check adds
+  * its own. Every slot is freed at the end, which leaves the heap as it
+  * started for the next repeat.
+  *
+  * The Makefile builds this with heap_4.c (heap_replay_4) and with
+  * heap_tlsf.c (heap_replay_tlsf), each in a ucHeap of the firmware's
+  * configTOTAL_HEAP_SIZE, and `make heap` runs both on the same trace:
+  *
+  *   trace, churn  free space, largest free block, number of free blocks
+  *                 and fragmentation, the share of the free space not in
+  *                 the largest block in per mille, at the end of the phase
+  *                 (capture for a recorded trace);
+  *   worst         the highest fragmentation after any step;
+  *   malloc, free  worst case and mean latency in ns. Each step is timed
+  *                 in every repeat and its fastest time kept, which takes
+  *                 out the host's own interruptions but not the heap's
+  *                 slow paths.
+  *
+  * After every step the blocks are walked from the start of ucHeap to the
+  * end marker: the free ones must add up to xPortGetFreeHeapSize() and to
+  * the figures of vPortGetHeapStats(), and each block's contents must be
+  * intact when it is freed. Exits with 1 on a mismatch.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "bench_heap_trace.h"
+
+#define REPLAY_SLOTS            1024U
+#define REPLAY_REPEATS          20U
+/* Header the 32 bit target's heaps include in a traced block size */
+#define REPLAY_TARGET_HEADER    8U
+
+/* trace_rec.h record types and lengths, as trace2json.py */
+#define REPLAY_REC_SYNC         0x01U
+#define REPLAY_REC_TASK_CREATE  0x10U
+#define REPLAY_REC_MALLOC       0x40U
+#define REPLAY_REC_FREE         0x41U
+
+/* Both heaps start a block with a pointer and the size, and end the heap
+   with a zero sized block. heap_4.c marks a used block with the top bit of
+   the size, heap_tlsf.c a free one with the bottom bit. */
+typedef struct
+{
+    void *link;
+    size_t size;
+} replay_block_t;
+
+#if defined(USE_FreeRTOS_HEAP_TLSF)
+#define REPLAY_HEAP             "heap_tlsf"
+#define REPLAY_FREE_BIT         ((size_t)1)
+#define REPLAY_BLOCK_FREE(b)    (((b)->size & REPLAY_FREE_BIT) != 0U)
+#define REPLAY_BLOCK_SIZE(b)    ((b)->size & ~REPLAY_FREE_BIT)
+#else
+#define REPLAY_HEAP             "heap_4"
+#define REPLAY_USED_BIT         ((size_t)1 << (sizeof(size_t) * 8U - 1U))
+#define REPLAY_BLOCK_FREE(b)    (((b)->size & REPLAY_USED_BIT) == 0U)
+#define REPLAY_BLOCK_SIZE(b)    ((b)->size & ~REPLAY_USED_BIT)
+#endif
+
+/* One step: allocate size bytes into slot, or free the slot when size is 0.
+   A slot still holding a block is freed first. */
+typedef struct
+{
+    uint16_t slot;
+    uint32_t size;
+} replay_op_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t end;               /* First step after the phase */
+} replay_phase_t;
+
+typedef struct
+{
+    size_t free;
+    size_t largest;
+    size_t smallest;
+    size_t blocks;
+} replay_walk_t;
+
+uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+
+static replay_op_t *s_op;
+static uint32_t s_ops;
+static uint32_t s_ops_max;
+static replay_phase_t s_phase[3];
+static uint32_t s_phases;
+
+static void *s_slot[REPLAY_SLOTS];
+static uint32_t s_slot_size[REPLAY_SLOTS];
+static uint8_t s_slot_fill[REPLAY_SLOTS];
+static uint8_t s_fill;
+static uint64_t *s_malloc_ns;   /* Fastest time of each step, all repeats */
+static uint64_t *s_free_ns;
+static uint32_t s_failed;
+static uint32_t s_worst_frag;
+
+static void replay_add(uint32_t slot, uint32_t size)
+{
+    if (s_ops == s_ops_max)
+    {
+        s_ops_max = (s_ops_max != 0U) ? s_ops_max * 2U : 4096U;
+        s_op = realloc(s_op, s_ops_max * sizeof(s_op[0]));
+        if (s_op == NULL)
+        {
+            printf("  out of memory\n");
+            exit(1);
+        }
+    }
+    s_op[s_ops].slot = (uint16_t)slot;
+    s_op[s_ops].size = size;
+    s_ops++;
+}
+
+static void replay_end_phase(const char *name)
+{
+    s_phase[s_phases].name = name;
+    s_phase[s_phases].end = s_ops;
+    s_phases++;
+}
+
+static void replay_free_all(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < REPLAY_SLOTS; i++)
+    {
+        replay_add(i, 0);
+    }
+}
+
+static void replay_load_bench(void)
+{
+    uint32_t i, seed = BENCH_HEAP_CHURN_SEED;
+    bench_heap_op_t op;
+
+    for (i = 0; i < sizeof(s_bench_heap_trace) / sizeof(s_bench_heap_trace[0]); i++)
+    {
+        replay_add(s_bench_heap_trace[i].slot, s_bench_heap_trace[i].size);
+    }
+    replay_end_phase("trace");
+    for (i = 0; i < BENCH_HEAP_CHURN; i++)
+    {
+        op = bench_heap_churn_step(&seed);
+        replay_add(op.slot, op.size);
+    }
+    replay_end_phase("churn");
+}
+
+static uint32_t replay_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int replay_load_capture(const char *path)
+{
+    static uint32_t address[REPLAY_SLOTS];
+    uint8_t rec[24];
+    uint32_t i, addr, size, len, lost = 0;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return 0;
+    }
+    while (fread(rec, 1, 8, f) == 8)
+    {
+        len = (rec[4] == REPLAY_REC_TASK_CREATE) ? 24U :
+              ((rec[4] == REPLAY_REC_SYNC) || (rec[4] == REPLAY_REC_MALLOC) || (rec[4] == REPLAY_REC_FREE)) ? 16U : 8U;
+        if ((len > 8U) && (fread(rec + 8, 1, len - 8U, f) != len - 8U))
+        {
+            break;
+        }
+        if ((rec[4] != REPLAY_REC_MALLOC) && (rec[4] != REPLAY_REC_FREE))
+        {
+            continue;
+        }
+        addr = replay_le32(rec + 8);
+        size = replay_le32(rec + 12);
+        if (addr == 0U)
+        {
+            continue;           /* A failed allocation */
+        }
+        /* The slot of a live address; for an allocation whose free was
+           lost, the same slot, which the step frees first */
+        for (i = 0; (i < REPLAY_SLOTS) && (address[i] != addr); i++)
+        {
+        }
+        if (rec[4] == REPLAY_REC_MALLOC)
+        {
+            if (i == REPLAY_SLOTS)
+            {
+                for (i = 0; (i < REPLAY_SLOTS) && (address[i] != 0U); i++)
+                {
+                }
+            }
+            if (i == REPLAY_SLOTS)
+            {
+                lost++;
+                continue;
+            }
+            address[i] = addr;
+            replay_add(i, (size > REPLAY_TARGET_HEADER) ? size - REPLAY_TARGET_HEADER : 1U);
+        }
+        else if (i < REPLAY_SLOTS)
+        {
+            address[i] = 0;
+            replay_add(i, 0);
+        }
+    }
+    fclose(f);
+    if (lost != 0U)
+    {
+        printf("  %lu allocations beyond %u live blocks left out\n", (unsigned long)lost, REPLAY_SLOTS);
+    }
+    replay_end_phase("capture");
+    return 1;
+}
+
+static uint64_t replay_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/* The blocks from the start of ucHeap, aligned as both heaps do, to the end
+   marker. Returns 0 if a block runs past the end of ucHeap. */
+static int replay_walk(replay_walk_t *walk)
+{
+    uint8_t *p = (uint8_t *)(((uintptr_t)ucHeap + portBYTE_ALIGNMENT_MASK) & ~(uintptr_t)portBYTE_ALIGNMENT_MASK);
+    const replay_block_t *block;
+    size_t size;
+
+    memset(walk, 0, sizeof(*walk));
+    walk->smallest = portMAX_DELAY;
+    for (;;)
+    {
+        if (p + sizeof(replay_block_t) > ucHeap + sizeof(ucHeap))
+        {
+            return 0;
+        }
+        block = (const replay_block_t *)p;
+        size = REPLAY_BLOCK_SIZE(block);
+        if (size == 0U)
+        {
+            return 1;
+        }
+        if (REPLAY_BLOCK_FREE(block))
+        {
+            walk->free += size;
+            walk->blocks++;
+            if (size > walk->largest)
+            {
+                walk->largest = size;
+            }
+            if (size < walk->smallest)
+            {
+                walk->smallest = size;
+            }
+        }
+        p += size;
+    }
+}
+
+static int replay_check(uint32_t step)
+{
+    replay_walk_t walk;
+    HeapStats_t stats;
+    size_t free = xPortGetFreeHeapSize();
+    uint32_t frag;
+
+    if (!replay_walk(&walk))
+    {
+        printf("  step %lu: a block runs past the end of the heap\n", (unsigned long)step);
+        return 0;
+    }
+    vPortGetHeapStats(&stats);
+    if ((free != walk.free) || (stats.xAvailableHeapSpaceInBytes != walk.free) ||
+        (stats.xNumberOfFreeBlocks != walk.blocks) ||
+        (stats.xSizeOfLargestFreeBlockInBytes != walk.largest) ||
+        ((walk.blocks != 0U) && (stats.xSizeOfSmallestFreeBlockInBytes != walk.smallest)) ||
+        (xPortGetMinimumEverFreeHeapSize() > free))
+    {
+        printf("  step %lu: free %lu, stats %lu in %lu blocks, largest %lu, smallest %lu, minimum ever %lu;"
+               " the free blocks add up to %lu in %lu, largest %lu, smallest %lu\n", (unsigned long)step,
+               (unsigned long)free, (unsigned long)stats.xAvailableHeapSpaceInBytes,
+               (unsigned long)stats.xNumberOfFreeBlocks, (unsigned long)stats.xSizeOfLargestFreeBlockInBytes,
+               (unsigned long)stats.xSizeOfSmallestFreeBlockInBytes,
+               (unsigned long)xPortGetMinimumEverFreeHeapSize(), (unsigned long)walk.free,
+               (unsigned long)walk.blocks, (unsigned long)walk.largest, (unsigned long)walk.smallest);
+        return 0;
+    }
+
+    frag = 0;
+    if (walk.free != 0U)
+    {
+        frag = 1000U - (uint32_t)(((uint64_t)walk.largest * 1000U) / walk.free);
+    }
+    if (frag > s_worst_frag)
+    {
+        s_worst_frag = frag;
+    }
+    return 1;
+}
+
+static void replay_report_phase(const char *phase)
+{
+    HeapStats_t stats;
+    uint32_t frag = 0;
+
+    vPortGetHeapStats(&stats);
+    if (stats.xAvailableHeapSpaceInBytes != 0U)
+    {
+        frag = 1000U - (uint32_t)(((uint64_t)stats.xSizeOfLargestFreeBlockInBytes * 1000U) /
+                                  stats.xAvailableHeapSpaceInBytes);
+    }
+    printf("%-10s free=%lu largest=%lu blocks=%lu frag=%lu/1000\n", phase,
+           (unsigned long)stats.xAvailableHeapSpaceInBytes,
+           (unsigned long)stats.xSizeOfLargestFreeBlockInBytes,
+           (unsigned long)stats.xNumberOfFreeBlocks, (unsigned long)frag);
+}
+
+static int replay_step(uint32_t step, int first)
+{
+    const replay_op_t *op = &s_op[step];
+    uint64_t t;
+    uint32_t i;
+    uint8_t *p;
+
+    p = s_slot[op->slot];
+    if (p != NULL)
+    {
+        for (i = 0; i < s_slot_size[op->slot]; i++)
+        {
+            if (p[i] != s_slot_fill[op->slot])
+            {
+                printf("  step %lu: block of slot %u overwritten at byte %lu\n",
+                       (unsigned long)step, op->slot, (unsigned long)i);
+                return 0;
+            }
+        }
+        t = replay_ns();
+        vPortFree(p);
+        t = replay_ns() - t;
+        if (first || (t < s_free_ns[step]))
+        {
+            s_free_ns[step] = t;
+        }
+        s_slot[op->slot] = NULL;
+    }
+
+    if (op->size != 0U)
+    {
+        t = replay_ns();
+        p = pvPortMalloc(op->size);
+        t = replay_ns() - t;
+        if (first || (t < s_malloc_ns[step]))
+        {
+            s_malloc_ns[step] = t;
+        }
+        if (p == NULL)
+        {
+            if (first)
+            {
+                s_failed++;
+            }
+        }
+        else
+        {
+            s_fill = (uint8_t)((s_fill == 0xFFU) ? 1U : s_fill + 1U);
+            memset(p, s_fill, op->size);
+            s_slot[op->slot] = p;
+            s_slot_size[op->slot] = op->size;
+            s_slot_fill[op->slot] = s_fill;
+        }
+    }
+    return replay_check(step);
+}
+
+static void replay_report_latency(const char *name, const uint64_t *ns, int malloc_steps)
+{
+    uint64_t worst = 0, sum = 0;
+    uint32_t i, n = 0;
+
+    for (i = 0; i < s_ops; i++)
+    {
+        /* Only the steps that made the call */
+        if (malloc_steps ? (s_op[i].size == 0U) : (ns[i] == UINT64_MAX))
+        {
+            continue;
+        }
+        if (ns[i] > worst)
+        {
+            worst = ns[i];
+        }
+        sum += ns[i];
+        n++;
+    }
+    printf("%-10s worst=%lu ns mean=%lu ns calls=%lu\n", name, (unsigned long)worst,
+           (unsigned long)((n != 0U) ? sum / n : 0U), (unsigned long)n);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t repeats = REPLAY_REPEATS, r, i, phase;
+    size_t initial = 0;
+    int opt, ok = 1;
+
+    while ((opt = getopt(argc, argv, "r:")) != -1)
+    {
+        if (opt == 'r')
+        {
+            repeats = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-r repeats] [trace.bin]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats == 0U)
+    {
+        repeats = 1;
+    }
+    if (optind < argc)
+    {
+        if (!replay_load_capture(argv[optind]))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        replay_load_bench();
+    }
+    replay_free_all();
+
+    s_malloc_ns = calloc(s_ops, sizeof(s_malloc_ns[0]));
+    s_free_ns = calloc(s_ops, sizeof(s_free_ns[0]));
+    if ((s_malloc_ns == NULL) || (s_free_ns == NULL))
+    {
+        printf("  out of memory\n");
+        return 1;
+    }
+    /* A free time stays UINT64_MAX where the step had nothing to free */
+    for (i = 0; i < s_ops; i++)
+    {
+        s_free_ns[i] = UINT64_MAX;
+    }
+
+    printf("%s: %lu steps, %lu repeats, %lu byte heap\n", REPLAY_HEAP, (unsigned long)s_ops,
+           (unsigned long)repeats, (unsigned long)configTOTAL_HEAP_SIZE);
+    for (r = 0; ok && (r < repeats); r++)
+    {
+        phase = 0;
+        for (i = 0; ok && (i < s_ops); i++)
+        {
+            ok &= replay_step(i, r == 0U);
+            if ((r == 0U) && (phase < s_phases) && (i + 1U == s_phase[phase].end))
+            {
+                replay_report_phase(s_phase[phase].name);
+                phase++;
+            }
+        }
+        /* Everything freed, the heap is one block again */
+        if (ok && (r == 0U))
+        {
+            initial = xPortGetFreeHeapSize();
+        }
+        else if (ok && (xPortGetFreeHeapSize() != initial))
+        {
+            printf("  repeat %lu: %lu bytes free at the end, %lu after the first\n", (unsigned long)r,
+                   (unsigned long)xPortGetFreeHeapSize(), (unsigned long)initial);
+            ok = 0;
+        }
+    }
+    if (ok)
+    {
+        printf("%-10s frag=%lu/1000 failed=%lu\n", "worst", (unsigned long)s_worst_frag, (unsigned long)s_failed);
+        replay_report_latency("malloc", s_malloc_ns, 1);
+        replay_report_latency("free", s_free_ns, 0);
+    }
+    printf("%-10s %s\n", "check", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
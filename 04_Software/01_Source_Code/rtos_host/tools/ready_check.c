@@ -0,0 +1,238 @@
+/**
+  ******************************************************************************
+  * @file    ready_check.c
+  * @brief   Runs the firmware's scheduler (tasks.c) on the host port and
+  *          checks that the two level ready bit map selects the highest
+  *          ready priority across all configMAX_PRIORITIES.
+  ******************************************************************************
+  * usage: ready_check [-s seed] [-n ops]
+  *
+  * One task is created at each priority 0 to configMAX_PRIORITIES - 1 and
+  * the scheduler started; the idle task shares priority 0. Suspending,
+  * resuming and reprioritising tasks sets and clears the bit map, and after
+  * every call the running task's priority is compared with the highest
+  * priority of the tasks not suspended:
+  *
+  *   descend    suspend the running task from the top priority down to 0,
+  *              then resume them from the bottom up;
+  *   single     each priority alone above the idle task, which crosses
+  *              every group boundary of the bit map;
+  *   random     ops random suspends, resumes and priority changes.
+  *
+  * The Makefile links this with tasks.c built twice, using the compiler's
+  * count leading zeros builtin (ready_check) and the binary search of
+  * tasks.c (ready_check_generic). Exits with 1 on the first wrong choice.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define CHECK_TASKS             configMAX_PRIORITIES
+
+static TaskHandle_t s_task[CHECK_TASKS];
+static UBaseType_t s_prio[CHECK_TASKS];
+static uint8_t s_suspended[CHECK_TASKS];
+static uint32_t s_rng;
+
+static void check_task(void *argument)
+{
+    (void)argument;
+}
+
+static uint32_t check_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/* The running task must have the highest priority of any task not suspended */
+static int check_running(const char *after, uint32_t i)
+{
+    UBaseType_t want = tskIDLE_PRIORITY, got;
+    uint32_t j;
+
+    for (j = 0; j < CHECK_TASKS; j++)
+    {
+        if (!s_suspended[j] && (s_prio[j] > want))
+        {
+            want = s_prio[j];
+        }
+    }
+    got = uxTaskPriorityGet(NULL);
+    if (got != want)
+    {
+        printf("  after %s of task %lu: running priority %lu, expected %lu\n",
+               after, (unsigned long)i, (unsigned long)got, (unsigned long)want);
+        return 0;
+    }
+    return 1;
+}
+
+static int check_suspend(uint32_t i)
+{
+    vTaskSuspend(s_task[i]);
+    s_suspended[i] = 1;
+    return check_running("suspend", i);
+}
+
+static int check_resume(uint32_t i)
+{
+    vTaskResume(s_task[i]);
+    s_suspended[i] = 0;
+    return check_running("resume", i);
+}
+
+static int check_descend(void)
+{
+    uint32_t i;
+
+    if (!check_running("start", 0))
+    {
+        return 0;
+    }
+    for (i = CHECK_TASKS; i-- > 0;)
+    {
+        /* The task suspended is the one running */
+        if ((uxTaskPriorityGet(NULL) != s_prio[i]) && (i != 0U))
+        {
+            printf("  task %lu not running\n", (unsigned long)i);
+            return 0;
+        }
+        if (!check_suspend(i))
+        {
+            return 0;
+        }
+    }
+    for (i = 0; i < CHECK_TASKS; i++)
+    {
+        /* Above priority 0, which it shares with the idle task, the task
+           resumed preempts */
+        if (!check_resume(i))
+        {
+            return 0;
+        }
+        if ((i != 0U) && (xTaskGetCurrentTaskHandle() != s_task[i]))
+        {
+            printf("  task %lu resumed but not running\n", (unsigned long)i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int check_single(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < CHECK_TASKS; i++)
+    {
+        if (!check_suspend(i))
+        {
+            return 0;
+        }
+    }
+    for (i = 0; i < CHECK_TASKS; i++)
+    {
+        if (!check_resume(i) || !check_suspend(i))
+        {
+            return 0;
+        }
+    }
+    for (i = 0; i < CHECK_TASKS; i++)
+    {
+        if (!check_resume(i))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int check_random(uint32_t ops)
+{
+    uint32_t n, i;
+    UBaseType_t prio;
+
+    for (n = 0; n < ops; n++)
+    {
+        i = check_rand() % CHECK_TASKS;
+        switch (check_rand() % 3U)
+        {
+            case 0:
+                if (!check_suspend(i))
+                {
+                    return 0;
+                }
+                break;
+            case 1:
+                if (!check_resume(i))
+                {
+                    return 0;
+                }
+                break;
+            default:
+                prio = check_rand() % configMAX_PRIORITIES;
+                vTaskPrioritySet(s_task[i], prio);
+                s_prio[i] = prio;
+                if (!check_running("priority change", i))
+                {
+                    return 0;
+                }
+                break;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t i, ops = 100000, seed = 12345;
+    char name[configMAX_TASK_NAME_LEN];
+    int opt, ok = 1, r;
+
+    while ((opt = getopt(argc, argv, "s:n:")) != -1)
+    {
+        if (opt == 's')
+        {
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if (opt == 'n')
+        {
+            ops = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-s seed] [-n ops]\n", argv[0]);
+            return 2;
+        }
+    }
+    s_rng = (seed != 0U) ? seed : 1U;
+
+    for (i = 0; i < CHECK_TASKS; i++)
+    {
+        snprintf(name, sizeof(name), "p%lu", (unsigned long)i);
+        s_prio[i] = i;
+        if (xTaskCreate(check_task, name, configMINIMAL_STACK_SIZE, NULL, s_prio[i], &s_task[i]) != pdPASS)
+        {
+            printf("  xTaskCreate failed\n");
+            return 1;
+        }
+    }
+    vTaskStartScheduler();
+
+    r = check_descend();
+    printf("%-10s %s\n", "descend", r ? "ok" : "FAIL");
+    ok &= r;
+    r = ok && check_single();
+    printf("%-10s %s\n", "single", r ? "ok" : "FAIL");
+    ok &= r;
+    r = ok && check_random(ops);
+    printf("%-10s %s\n", "random", r ? "ok" : "FAIL");
+    ok &= r;
+    return ok ? 0 : 1;
+}
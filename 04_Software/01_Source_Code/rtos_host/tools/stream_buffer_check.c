@@ -0,0 +1,239 @@
+/**
+  ******************************************************************************
+  * @file    stream_buffer_check.c
+  * @brief   Runs the firmware's multi-producer message buffers
+  *          (stream_buffer.c) on the host port with a task producer and an
+  *          interrupt producer writing to the same buffer.
+  ******************************************************************************
+  * usage: stream_buffer_check [-n rounds] [-p period_us]
+  *
+  * As in bench_sbuf.c, one buffer has a task producer, an interrupt producer
+  * and a receiving task. Each round the receiver blocks on the empty buffer,
+  * and the task producer's send runs while it waits (the receive's trace
+  * hook). Every message holds its producer and a sequence number:
+  *
+  *   nested     the interrupt is pended before the task sends, so it runs
+  *              as the task's claim is made and writes inside it. The task
+  *              publishes both messages, in claim order, and wakes the
+  *              receiver once;
+  *   race       the interrupt is raised by a timer every period, wherever
+  *              the task is, for rounds rounds. One that publishes while the
+  *              task is waking the receiver clears the waiting receiver
+  *              under it, which the task must not then notify.
+  *
+  * After each round the receiver must have been woken, not left blocked,
+  * and each producer's messages must arrive whole and in order. A failed
+  * kernel assertion also exits with 1.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "message_buffer.h"
+
+#define CHECK_BUFFER_SIZE       256U
+#define CHECK_BLOCK_TICKS       100U
+#define CHECK_TASK              0U
+#define CHECK_ISR               1U
+
+typedef struct
+{
+    uint32_t producer;
+    uint32_t seq;
+} check_msg_t;
+
+static MessageBufferHandle_t s_buffer;
+static TaskHandle_t s_receiver;
+static uint32_t s_sent[2];              /* Messages each producer has written */
+static uint32_t s_received[2];
+static volatile uint32_t s_isr_seq;
+
+static void check_task(void *argument)
+{
+    (void)argument;
+}
+
+static void check_isr(void)
+{
+    check_msg_t msg = { CHECK_ISR, s_isr_seq };
+    BaseType_t woken = pdFALSE;
+
+    if (xMessageBufferSendFromISR(s_buffer, &msg, sizeof(msg), &woken) == sizeof(msg))
+    {
+        s_isr_seq++;
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+static void check_send(void)
+{
+    check_msg_t msg = { CHECK_TASK, s_sent[CHECK_TASK] };
+
+    if (xMessageBufferSend(s_buffer, &msg, sizeof(msg), 0) == sizeof(msg))
+    {
+        s_sent[CHECK_TASK]++;
+    }
+}
+
+/* The receiver is waiting: the task producer sends */
+static void check_wait_send(void *buffer)
+{
+    (void)buffer;
+    check_send();
+}
+
+/* The nested round also has the interrupt run inside the send */
+static void check_wait_nested(void *buffer)
+{
+    (void)buffer;
+    vPortPendInterrupt();
+    check_send();
+}
+
+static int check_msg(const check_msg_t *msg, size_t len, const char *when)
+{
+    if ((len != sizeof(*msg)) || (msg->producer > CHECK_ISR))
+    {
+        printf("  %s: message of %lu bytes from producer %lu\n", when, (unsigned long)len,
+               (unsigned long)msg->producer);
+        return 0;
+    }
+    if (msg->seq != s_received[msg->producer])
+    {
+        printf("  %s: %s message %lu, expected %lu\n", when, (msg->producer == CHECK_TASK) ? "task" : "interrupt",
+               (unsigned long)msg->seq, (unsigned long)s_received[msg->producer]);
+        return 0;
+    }
+    s_received[msg->producer]++;
+    return 1;
+}
+
+static int check_drain(const char *when)
+{
+    check_msg_t msg;
+    size_t len;
+
+    while ((len = xMessageBufferReceive(s_buffer, &msg, sizeof(msg), 0)) != 0U)
+    {
+        if (!check_msg(&msg, len, when))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* One round: the receiver blocks, is woken, and empties the buffer */
+static int check_round(const char *when)
+{
+    check_msg_t msg;
+    size_t len;
+
+    len = xMessageBufferReceive(s_buffer, &msg, sizeof(msg), CHECK_BLOCK_TICKS);
+    if (xTaskGetCurrentTaskHandle() != s_receiver)
+    {
+        printf("  %s: receiver not woken\n", when);
+        return 0;
+    }
+    if ((len != 0U) && !check_msg(&msg, len, when))
+    {
+        return 0;
+    }
+    return check_drain(when);
+}
+
+static int check_nested(void)
+{
+    int ok;
+
+    vPortSetInterrupt(check_isr, 0);
+    pxPortStreamBufferWaitHook = check_wait_nested;
+    ok = check_round("nested");
+    pxPortStreamBufferWaitHook = NULL;
+    vPortSetInterrupt(NULL, 0);
+    if (ok && ((s_received[CHECK_TASK] != 1U) || (s_received[CHECK_ISR] != 1U)))
+    {
+        printf("  nested: %lu task and %lu interrupt messages, expected 1 and 1\n",
+               (unsigned long)s_received[CHECK_TASK], (unsigned long)s_received[CHECK_ISR]);
+        ok = 0;
+    }
+    return ok;
+}
+
+static int check_race(uint32_t rounds, uint32_t period_us)
+{
+    char when[32];
+    uint32_t n;
+    int ok = 1;
+
+    pxPortStreamBufferWaitHook = check_wait_send;
+    vPortSetInterrupt(check_isr, period_us);
+    for (n = 0; ok && (n < rounds); n++)
+    {
+        snprintf(when, sizeof(when), "round %lu", (unsigned long)n);
+        ok = check_round(when);
+    }
+    vPortSetInterrupt(NULL, 0);
+    pxPortStreamBufferWaitHook = NULL;
+    /* Whatever the last interrupts wrote */
+    ok = ok && check_drain("drain");
+    s_sent[CHECK_ISR] = s_isr_seq;
+    if (ok && ((s_received[CHECK_TASK] != s_sent[CHECK_TASK]) || (s_received[CHECK_ISR] != s_sent[CHECK_ISR])))
+    {
+        printf("  race: received %lu of %lu task and %lu of %lu interrupt messages\n",
+               (unsigned long)s_received[CHECK_TASK], (unsigned long)s_sent[CHECK_TASK],
+               (unsigned long)s_received[CHECK_ISR], (unsigned long)s_sent[CHECK_ISR]);
+        ok = 0;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = 200000, period_us = 20;
+    int opt, ok = 1, r;
+
+    while ((opt = getopt(argc, argv, "n:p:")) != -1)
+    {
+        if (opt == 'n')
+        {
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if (opt == 'p')
+        {
+            period_us = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n rounds] [-p period_us]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (period_us == 0U)
+    {
+        period_us = 1;
+    }
+
+    if (xTaskCreate(check_task, "rx", configMINIMAL_STACK_SIZE, NULL, 1, &s_receiver) != pdPASS)
+    {
+        printf("  xTaskCreate failed\n");
+        return 1;
+    }
+    s_buffer = xMessageBufferCreateMultiProducer(CHECK_BUFFER_SIZE);
+    if (s_buffer == NULL)
+    {
+        printf("  xMessageBufferCreateMultiProducer failed\n");
+        return 1;
+    }
+    vTaskStartScheduler();
+
+    r = check_nested();
+    printf("%-10s %s\n", "nested", r ? "ok" : "FAIL");
+    ok &= r;
+    r = ok && check_race(rounds, period_us);
+    printf("%-10s %s\n", "race", r ? "ok" : "FAIL");
+    ok &= r;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,640 @@
+/**
+  ******************************************************************************
+  * @file    timer_wheel_check.c
+  * @brief   Runs the firmware's software timers (timers.c) on the host port
+  *          and checks the timing wheel of configUSE_TIMER_WHEEL.
+  ******************************************************************************
+  * usage: timer_wheel_check [-n ticks] [-p period_us]
+  *
+  * The timer service task never runs on the host port, so timers.c is
+  * included here and check_daemon() runs its loop while the task is the one
+  * running, as it would be once woken. The check's own task ticks the
+  * kernel, sends the timer commands and checks that each one shot timer
+  * expires at the tick it is due, whose periods straddle the level
+  * boundaries of the wheel: 32, 1024 and 32768 ticks.
+  *
+  *   start      all the timers are started at once, from a base aligned to
+  *              every level and from two that are not;
+  *   restart    half way through its period each timer is stopped, then
+  *              started again when it would have expired, or reset, so it
+  *              moves down the levels and back up;
+  *   isr        the first callback of a batch of timers due at one tick
+  *              raises an interrupt that arms one of the batch still to
+  *              expire, the one that has just expired and an idle one, with
+  *              xTimerArmFromISR(). Then an interrupt arms a timer while the
+  *              task is blocked, which must wake it;
+  *   wrap       restart again, across the tick count's wraparound, with an
+  *              auto-reload timer running through it. The kernel is built
+  *              with configINITIAL_TICK_COUNT a little below the wrap;
+  *   race       for ticks ticks, an interrupt every period arms three idle
+  *              timers to expire together and restarts any one, and the
+  *              task arms one every few ticks, wherever the timer service
+  *              task is. The callbacks take a while, so the interrupt often
+  *              lands in an expiry batch, and restarts a timer whose
+  *              callback is still to run. Each arming must expire at its
+  *              tick unless restarted while still in the wheel.
+  *
+  * A failed kernel assertion, or a timer service task that never blocks,
+  * also exits with 1.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+/* The kernel's timers.c, with its static functions and state */
+#include "timers.c"
+
+#define CHECK_TIMERS            10U     /* The first CHECK_TIMERS take s_period[] */
+#define CHECK_POOL              32U     /* Timers armed in the race */
+#define CHECK_RACE_BATCH        4U
+#define CHECK_RACE_TASK_TICKS   7U      /* The task arms a timer this often */
+#define CHECK_RACE_SPIN         200U    /* Work in each race callback */
+#define CHECK_RELOAD_PERIOD     100U
+#define CHECK_WRAP_LEAD         520U    /* Ticks before the wrap the wrap check starts */
+#define CHECK_MAX_SKIP          0x00400000UL
+#define CHECK_MAX_PASSES        1000U   /* Of the timer service task's loop without blocking */
+
+static const TickType_t s_period[CHECK_TIMERS] = { 1, 31, 32, 33, 1023, 1024, 1025, 32767, 32768, 32769 };
+
+static TaskHandle_t s_task;
+static TaskHandle_t s_daemon;
+static TimerHandle_t s_timer[CHECK_POOL];
+static TimerHandle_t s_reload;
+static uint32_t s_fired[CHECK_POOL];
+static TickType_t s_fired_at[CHECK_POOL];
+static uint32_t s_reload_fired;
+static TickType_t s_reload_base;
+static int s_reload_ok;
+static void (*s_on_expired)(uint32_t i);
+
+/* Where check_daemon() left the timer service task */
+static int s_daemon_waiting;
+
+/* The race's bookkeeping, shared with the interrupt */
+static volatile uint32_t s_armed[CHECK_POOL];
+static volatile TickType_t s_due[CHECK_POOL];
+static volatile uint32_t s_in_flight[CHECK_POOL];
+static volatile TickType_t s_in_flight_due[CHECK_POOL];
+static volatile uint32_t s_arms, s_cancelled, s_expiries, s_isr_in_batch, s_race_next, s_race_seed;
+static volatile int s_in_batch;
+static char s_race_error[96];
+
+static void check_task(void *argument)
+{
+    (void)argument;
+}
+
+/* prvTimerTask()'s loop, for as long as the timer service task is running.
+   After it blocks in prvProcessTimerOrBlockTask() it carries on from there,
+   with the commands it was woken for, the next time it runs. */
+static void check_daemon(void)
+{
+    TickType_t next;
+    BaseType_t empty;
+    uint32_t passes = 0;
+
+    while (xTaskGetCurrentTaskHandle() == s_daemon)
+    {
+        if (++passes > CHECK_MAX_PASSES)
+        {
+            printf("  timer service task never blocks at tick 0x%lx\n", (unsigned long)xTaskGetTickCount());
+            exit(1);
+        }
+        if (!s_daemon_waiting)
+        {
+            next = prvGetNextExpireTime(&empty);
+            prvProcessTimerOrBlockTask(next, empty);
+            s_in_batch = 0;
+            if (xTaskGetCurrentTaskHandle() != s_daemon)
+            {
+                s_daemon_waiting = 1;
+                return;
+            }
+        }
+        s_daemon_waiting = 0;
+        prvProcessReceivedCommands();
+    }
+}
+
+/* One tick, as SysTick raises it, then whatever the timer service task does */
+static void check_tick(void)
+{
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    BaseType_t switch_required = xTaskIncrementTick();
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    portYIELD_FROM_ISR(switch_required);
+    check_daemon();
+}
+
+static TickType_t check_elapsed(TickType_t base)
+{
+    return (TickType_t)(xTaskGetTickCount() - base);
+}
+
+/* Ticks up to target, which must not be too far ahead */
+static int check_goto(TickType_t target, const char *when)
+{
+    TickType_t ticks = (TickType_t)(target - xTaskGetTickCount());
+
+    if (ticks > CHECK_MAX_SKIP)
+    {
+        printf("  %s: tick count 0x%lx is 0x%lx ticks short of 0x%lx\n", when,
+               (unsigned long)xTaskGetTickCount(), (unsigned long)ticks, (unsigned long)target);
+        return 0;
+    }
+    while (xTaskGetTickCount() != target)
+    {
+        check_tick();
+    }
+    return 1;
+}
+
+static int check_command(BaseType_t result, uint32_t i, const char *what)
+{
+    check_daemon();
+    if (result != pdPASS)
+    {
+        printf("  %s of timer %lu failed\n", what, (unsigned long)i);
+        return 0;
+    }
+    return 1;
+}
+
+static void check_expired(TimerHandle_t timer)
+{
+    uint32_t i = (uint32_t)(uintptr_t)pvTimerGetTimerID(timer);
+
+    s_fired[i]++;
+    s_fired_at[i] = xTaskGetTickCount();
+    if (s_on_expired != NULL)
+    {
+        s_on_expired(i);
+    }
+}
+
+static void check_reload_expired(TimerHandle_t timer)
+{
+    (void)timer;
+    s_reload_fired++;
+    if (xTaskGetTickCount() != (TickType_t)(s_reload_base + s_reload_fired * CHECK_RELOAD_PERIOD))
+    {
+        s_reload_ok = 0;
+    }
+}
+
+static void check_clear(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < CHECK_POOL; i++)
+    {
+        s_fired[i] = 0;
+        s_fired_at[i] = 0;
+    }
+}
+
+/* Timer i must have expired count times, the last at base + at */
+static int check_fired(uint32_t i, uint32_t count, TickType_t base, TickType_t at, const char *when)
+{
+    if (s_fired[i] != count)
+    {
+        printf("  %s: timer %lu (period %lu) expired %lu times, expected %lu\n", when, (unsigned long)i,
+               (unsigned long)xTimerGetPeriod(s_timer[i]), (unsigned long)s_fired[i], (unsigned long)count);
+        return 0;
+    }
+    if ((count != 0U) && (s_fired_at[i] != (TickType_t)(base + at)))
+    {
+        printf("  %s: timer %lu (period %lu) expired at base + %lu, expected base + %lu\n", when, (unsigned long)i,
+               (unsigned long)xTimerGetPeriod(s_timer[i]), (unsigned long)(TickType_t)(s_fired_at[i] - base),
+               (unsigned long)at);
+        return 0;
+    }
+    return 1;
+}
+
+/* Gives the timers their periods back after arming them with others */
+static void check_periods(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < CHECK_TIMERS; i++)
+    {
+        (void)xTimerArm(s_timer[i], s_period[i]);
+        check_daemon();
+        (void)xTimerDisarm(s_timer[i]);
+    }
+}
+
+static int check_start_from(TickType_t offset)
+{
+    char when[32];
+    TickType_t base;
+    uint32_t i;
+    int ok = 1;
+
+    snprintf(when, sizeof(when), "start + %lu", (unsigned long)offset);
+    ok = check_goto((TickType_t)(((xTaskGetTickCount() >> 15) + 1U) << 15) + offset, when);
+    check_clear();
+    base = xTaskGetTickCount();
+    for (i = 0; ok && (i < CHECK_TIMERS); i++)
+    {
+        ok = check_command(xTimerStart(s_timer[i], 0), i, "start");
+    }
+    while (ok && (check_elapsed(base) <= s_period[CHECK_TIMERS - 1U]))
+    {
+        check_tick();
+    }
+    for (i = 0; ok && (i < CHECK_TIMERS); i++)
+    {
+        ok = check_fired(i, 1, base, s_period[i], when);
+    }
+    return ok;
+}
+
+static int check_start(void)
+{
+    return check_start_from(0) && check_start_from(17) && check_start_from(1000);
+}
+
+/* Even timers are stopped half way and started again when they would have
+   expired, odd ones are reset half way */
+static int check_restart_from(TickType_t base, const char *when)
+{
+    TickType_t now, end = 2U * s_period[CHECK_TIMERS - 1U] + 1U;
+    uint32_t i;
+    int ok = 1;
+
+    check_clear();
+    for (i = 0; ok && (i < CHECK_TIMERS); i++)
+    {
+        ok = check_command(xTimerStart(s_timer[i], 0), i, "start");
+    }
+    while (ok)
+    {
+        now = check_elapsed(base);
+        for (i = 0; ok && (i < CHECK_TIMERS); i++)
+        {
+            if (now == s_period[i] / 2U)
+            {
+                ok = ((i & 1U) == 0U) ? check_command(xTimerStop(s_timer[i], 0), i, "stop")
+                                      : check_command(xTimerReset(s_timer[i], 0), i, "reset");
+            }
+            if (((i & 1U) == 0U) && (now == s_period[i]))
+            {
+                ok = check_fired(i, 0, base, 0, when) && check_command(xTimerStart(s_timer[i], 0), i, "start");
+            }
+        }
+        if (now == end)
+        {
+            break;
+        }
+        check_tick();
+    }
+    for (i = 0; ok && (i < CHECK_TIMERS); i++)
+    {
+        ok = check_fired(i, 1, base, ((i & 1U) == 0U) ? 2U * s_period[i] : s_period[i] / 2U + s_period[i], when);
+    }
+    return ok;
+}
+
+static int check_restart(void)
+{
+    return check_goto((TickType_t)(((xTaskGetTickCount() >> 15) + 1U) << 15) + 17U, "restart") &&
+           check_restart_from(xTaskGetTickCount(), "restart");
+}
+
+/* The batch: timers 0, 1 and 2 are due at one tick, in that order, and 3 is
+   idle */
+#define CHECK_BATCH_PERIOD      40U
+#define CHECK_BATCH_REARM_0     1U
+#define CHECK_BATCH_REARM_1     5U
+#define CHECK_BATCH_ARM_3       32U
+#define CHECK_WAKE_PERIOD       3U
+
+static void check_isr_batch(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    (void)xTimerArmFromISR(s_timer[1], CHECK_BATCH_REARM_1, &woken);
+    (void)xTimerArmFromISR(s_timer[0], CHECK_BATCH_REARM_0, &woken);
+    (void)xTimerArmFromISR(s_timer[3], CHECK_BATCH_ARM_3, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void check_isr_wake(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    (void)xTimerArmFromISR(s_timer[3], CHECK_WAKE_PERIOD, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void check_batch_expired(uint32_t i)
+{
+    if ((i == 0U) && (s_fired[0] == 1U))
+    {
+        vPortPendInterrupt();
+    }
+}
+
+static int check_isr(void)
+{
+    TickType_t base;
+    uint32_t i;
+    int ok = 1;
+
+    check_clear();
+    base = xTaskGetTickCount();
+    for (i = 0; i < 3U; i++)
+    {
+        (void)xTimerArm(s_timer[i], CHECK_BATCH_PERIOD);
+        check_daemon();
+    }
+    s_on_expired = check_batch_expired;
+    vPortSetInterrupt(check_isr_batch, 0);
+    while (check_elapsed(base) <= CHECK_BATCH_PERIOD + CHECK_BATCH_ARM_3)
+    {
+        check_tick();
+    }
+    s_on_expired = NULL;
+    ok = ok && check_fired(0, 2, base, CHECK_BATCH_PERIOD + CHECK_BATCH_REARM_0, "batch");
+    ok = ok && check_fired(1, 1, base, CHECK_BATCH_PERIOD + CHECK_BATCH_REARM_1, "batch");
+    ok = ok && check_fired(2, 1, base, CHECK_BATCH_PERIOD, "batch");
+    ok = ok && check_fired(3, 1, base, CHECK_BATCH_PERIOD + CHECK_BATCH_ARM_3, "batch");
+
+    /* The wheel is empty and the task blocked for as long as it can be */
+    if (ok && (xTaskGetCurrentTaskHandle() == s_daemon))
+    {
+        printf("  wake: timer service task not blocked\n");
+        ok = 0;
+    }
+    vPortSetInterrupt(check_isr_wake, 0);
+    base = xTaskGetTickCount();
+    vPortPendInterrupt();
+    check_daemon();
+    while (ok && (check_elapsed(base) <= CHECK_WAKE_PERIOD))
+    {
+        check_tick();
+    }
+    vPortSetInterrupt(NULL, 0);
+    ok = ok && check_fired(3, 2, base, CHECK_WAKE_PERIOD, "wake");
+    check_periods();
+    return ok;
+}
+
+static int check_wrap(void)
+{
+    int ok;
+
+    ok = check_goto((TickType_t)0U - CHECK_WRAP_LEAD, "wrap");
+    s_reload_base = xTaskGetTickCount();
+    s_reload_fired = 0;
+    s_reload_ok = 1;
+    ok = ok && check_command(xTimerStart(s_reload, 0), 0, "start");
+    ok = ok && check_restart_from(s_reload_base, "wrap");
+    ok = ok && check_command(xTimerStop(s_reload, 0), 0, "stop");
+    if (ok && (!s_reload_ok || (s_reload_fired != check_elapsed(s_reload_base) / CHECK_RELOAD_PERIOD)))
+    {
+        printf("  wrap: auto-reload timer expired %lu times in %lu ticks, %s\n", (unsigned long)s_reload_fired,
+               (unsigned long)check_elapsed(s_reload_base), s_reload_ok ? "on time" : "not on time");
+        ok = 0;
+    }
+    return ok;
+}
+
+static uint32_t check_random(void)
+{
+    s_race_seed = s_race_seed * 1664525UL + 1013904223UL;
+    return s_race_seed >> 8;
+}
+
+/* Called with interrupts masked, just before timer i is armed. An arming it
+   replaces is cancelled if the timer is still in the wheel; if not, it has
+   been taken off to expire and its callback is still to come. */
+static void check_race_arm(uint32_t i, TickType_t period, TickType_t now)
+{
+    if (s_armed[i])
+    {
+        if (listLIST_ITEM_CONTAINER(&(((Timer_t *)s_timer[i])->xTimerListItem)) != NULL)
+        {
+            s_cancelled++;
+        }
+        else
+        {
+            s_in_flight[i] = 1;
+            s_in_flight_due[i] = s_due[i];
+        }
+    }
+    s_armed[i] = 1;
+    s_due[i] = now + period;
+    s_arms++;
+}
+
+/* Called with interrupts masked: the next idle timer of the pool, or -1 */
+static int check_race_idle(void)
+{
+    uint32_t n, i;
+
+    for (n = 0; n < CHECK_POOL; n++)
+    {
+        i = (s_race_next + n) % CHECK_POOL;
+        if (!s_armed[i])
+        {
+            s_race_next = i + 1U;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/* Arms idle timers in a batch, all due at the same tick, and one of the pool
+   whatever it is doing */
+static void check_isr_race(void)
+{
+    TickType_t period = s_period[check_random() % CHECK_TIMERS], now = xTaskGetTickCountFromISR();
+    BaseType_t woken = pdFALSE;
+    uint32_t n;
+    int i;
+
+    if (s_in_batch)
+    {
+        s_isr_in_batch++;
+    }
+    for (n = 0; n < CHECK_RACE_BATCH; n++)
+    {
+        i = (n == 0U) ? (int)(check_random() % CHECK_POOL) : check_race_idle();
+        if (i < 0)
+        {
+            break;
+        }
+        check_race_arm((uint32_t)i, period, now);
+        (void)xTimerArmFromISR(s_timer[i], period, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+static void check_race_expired(uint32_t i)
+{
+    volatile uint32_t spin;
+
+    /* The interrupt can arm the timer again meanwhile */
+    s_in_batch = 1;
+    for (spin = 0; spin < CHECK_RACE_SPIN; spin++)
+    {
+    }
+    taskENTER_CRITICAL();
+    {
+        if (s_in_flight[i] && (s_fired_at[i] == s_in_flight_due[i]))
+        {
+            s_in_flight[i] = 0;
+        }
+        else if (s_armed[i] && (s_fired_at[i] == s_due[i]))
+        {
+            s_armed[i] = 0;
+        }
+        else if (s_race_error[0] == '\0')
+        {
+            snprintf(s_race_error, sizeof(s_race_error), "timer %lu expired at 0x%lx, %s 0x%lx", (unsigned long)i,
+                     (unsigned long)s_fired_at[i], s_armed[i] ? "due at" : "not armed, last due at",
+                     (unsigned long)s_due[i]);
+        }
+        s_expiries++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+static int check_race(uint32_t ticks, uint32_t period_us)
+{
+    TickType_t period;
+    uint32_t n, armed;
+    int i, ok = 1;
+
+    s_race_seed = 0x2545F491UL;
+    s_on_expired = check_race_expired;
+    vPortSetInterrupt(check_isr_race, period_us);
+    for (n = 0; (n < ticks) && (s_race_error[0] == '\0'); n++)
+    {
+        if ((n % CHECK_RACE_TASK_TICKS) == 0U)
+        {
+            /* Arming and bookkeeping together, or the interrupt could come
+               in between */
+            taskENTER_CRITICAL();
+            {
+                period = s_period[check_random() % CHECK_TIMERS];
+                i = check_race_idle();
+                if (i >= 0)
+                {
+                    check_race_arm((uint32_t)i, period, xTaskGetTickCount());
+                    (void)xTimerArm(s_timer[i], period);
+                }
+            }
+            taskEXIT_CRITICAL();
+            check_daemon();
+        }
+        check_tick();
+    }
+    vPortSetInterrupt(NULL, 0);
+
+    /* Whatever is still armed expires within the longest period */
+    for (n = 0; (n <= s_period[CHECK_TIMERS - 1U]) && (s_race_error[0] == '\0'); n++)
+    {
+        check_tick();
+    }
+    s_on_expired = NULL;
+    for (n = 0, armed = 0; n < CHECK_POOL; n++)
+    {
+        armed += s_armed[n] + s_in_flight[n];
+    }
+    if (s_race_error[0] != '\0')
+    {
+        printf("  race: %s\n", s_race_error);
+        ok = 0;
+    }
+    else if ((armed != 0U) || (s_expiries != s_arms - s_cancelled))
+    {
+        printf("  race: %lu timers armed %lu times, %lu cancelled, expired %lu times, %lu still armed\n",
+               (unsigned long)CHECK_POOL, (unsigned long)s_arms, (unsigned long)s_cancelled,
+               (unsigned long)s_expiries, (unsigned long)armed);
+        ok = 0;
+    }
+    else if (s_isr_in_batch == 0U)
+    {
+        printf("  race: no interrupt arrived during an expiry batch in %lu arms\n", (unsigned long)s_arms);
+        ok = 0;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct
+    {
+        const char *name;
+        int (*run)(void);
+    } scenarios[] = {
+        { "start", check_start },
+        { "restart", check_restart },
+        { "isr", check_isr },
+        { "wrap", check_wrap },
+    };
+    uint32_t ticks = 10000000, period_us = 20, i;
+    int opt, ok = 1, r;
+
+    while ((opt = getopt(argc, argv, "n:p:")) != -1)
+    {
+        if (opt == 'n')
+        {
+            ticks = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else if (opt == 'p')
+        {
+            period_us = (uint32_t)strtoul(optarg, NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n ticks] [-p period_us]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (period_us == 0U)
+    {
+        period_us = 1;
+    }
+
+    if (xTaskCreate(check_task, "check", configMINIMAL_STACK_SIZE, NULL, 1, &s_task) != pdPASS)
+    {
+        printf("  xTaskCreate failed\n");
+        return 1;
+    }
+    for (i = 0; i < CHECK_POOL; i++)
+    {
+        s_timer[i] = xTimerCreate("check", (i < CHECK_TIMERS) ? s_period[i] : 1U, pdFALSE,
+                                  (void *)(uintptr_t)i, check_expired);
+        if (s_timer[i] == NULL)
+        {
+            printf("  xTimerCreate failed\n");
+            return 1;
+        }
+    }
+    s_reload = xTimerCreate("reload", CHECK_RELOAD_PERIOD, pdTRUE, NULL, check_reload_expired);
+    if (s_reload == NULL)
+    {
+        printf("  xTimerCreate failed\n");
+        return 1;
+    }
+    vTaskStartScheduler();
+    s_daemon = xTimerGetTimerDaemonTaskHandle();
+    check_daemon();
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        r = ok && scenarios[i].run();
+        printf("%-10s %s\n", scenarios[i].name, r ? "ok" : "FAIL");
+        ok &= r;
+    }
+    r = ok && check_race(ticks, period_us);
+    printf("%-10s %s\n", "race", r ? "ok" : "FAIL");
+    ok &= r;
+    return ok ? 0 : 1;
+}
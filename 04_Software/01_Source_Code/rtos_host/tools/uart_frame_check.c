@@ -0,0 +1,301 @@
+/**
+  ******************************************************************************
+  * @file    uart_frame_check.c
+  * @brief   Checks the firmware's SLIP framing layer (uart_frame.c): encode
+  *          and decode round trips, frames split across reads, and the
+  *          escape and error cases.
+  ******************************************************************************
+  * usage: uart_frame_check [-n FRAMES] [-s SEED]
+  *
+  *   round trip  FRAMES (default 2000) random payloads, rich in END and ESC
+  *               bytes, encoded back to back and fed to the decoder in
+  *               random pieces of 1 to 64 bytes, come out unchanged and in
+  *               order;
+  *   split       a frame fed in two reads, cut at every byte, including
+  *               between an ESC and the byte it escapes;
+  *   edges       payloads of only END or ESC bytes, raw ESC_END and ESC_ESC
+  *               bytes, empty frames, a payload exactly the decoder size and
+  *               one byte over, invalid escapes, ESC before END, and
+  *               uart_frame_encode() with too little room.
+  *
+  * Exits with 1 if any frame or counter differs from the expected.
+  ******************************************************************************
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "uart_frame.h"
+
+#define CHECK_MAX_PAYLOAD       300U
+#define CHECK_DECODER_SIZE      CHECK_MAX_PAYLOAD
+
+typedef struct
+{
+    uart_frame_decoder_t dec;
+    uint8_t buf[CHECK_DECODER_SIZE];
+    uint8_t frame[64][CHECK_DECODER_SIZE];     /* Frames received, in order */
+    size_t frame_len[64];
+    uint32_t count;
+} check_rx_t;
+
+static uint32_t s_rng = 1;
+
+static uint32_t check_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static void check_rx_init(check_rx_t *rx)
+{
+    uart_frame_decoder_init(&rx->dec, rx->buf, sizeof(rx->buf));
+    rx->count = 0;
+}
+
+/* Feed one read to the decoder, keeping every frame it completes */
+static void check_rx_feed(check_rx_t *rx, const uint8_t *data, size_t len)
+{
+    size_t used, frame_len;
+
+    while (len > 0)
+    {
+        used = uart_frame_feed(&rx->dec, data, len, &frame_len);
+        if (frame_len != 0)
+        {
+            if (rx->count < 64)
+            {
+                memcpy(rx->frame[rx->count], rx->dec.buf, frame_len);
+                rx->frame_len[rx->count] = frame_len;
+            }
+            rx->count++;
+        }
+        data += used;
+        len -= used;
+    }
+}
+
+static int check_frame(const check_rx_t *rx, uint32_t index, const uint8_t *payload, size_t len, const char *what)
+{
+    if ((index >= rx->count) || (rx->frame_len[index] != len) || (memcmp(rx->frame[index], payload, len) != 0))
+    {
+        printf("  %s: frame %lu differs\n", what, (unsigned long)index);
+        return 0;
+    }
+    return 1;
+}
+
+static int check_counts(const check_rx_t *rx, uint32_t frames, uint32_t dropped, const char *what)
+{
+    if ((rx->count != frames) || (rx->dec.frames != frames) || (rx->dec.dropped != dropped))
+    {
+        printf("  %s: %lu frames (decoder %lu), %lu dropped; expected %lu and %lu\n", what,
+               (unsigned long)rx->count, (unsigned long)rx->dec.frames, (unsigned long)rx->dec.dropped,
+               (unsigned long)frames, (unsigned long)dropped);
+        return 0;
+    }
+    return 1;
+}
+
+/* Random payload, one byte in four a delimiter or escape byte */
+static size_t check_payload(uint8_t *p, size_t max)
+{
+    static const uint8_t special[4] = { UART_FRAME_END, UART_FRAME_ESC, UART_FRAME_ESC_END, UART_FRAME_ESC_ESC };
+    size_t len = 1U + check_rand() % max, i;
+    uint32_t r;
+
+    for (i = 0; i < len; i++)
+    {
+        r = check_rand();
+        p[i] = ((r & 3U) == 0U) ? special[(r >> 2) & 3U] : (uint8_t)(r >> 8);
+    }
+    return len;
+}
+
+static int check_round_trip(uint32_t frames)
+{
+    static check_rx_t rx;
+    static uint8_t payload[64][CHECK_MAX_PAYLOAD];
+    static uint8_t stream[64 * UART_FRAME_MAX_ENCODED(CHECK_MAX_PAYLOAD)];
+    size_t len[64], n, off, piece;
+    uint32_t done, batch, i;
+    int ok = 1;
+
+    for (done = 0; (done < frames) && ok; done += batch)
+    {
+        batch = (frames - done < 64U) ? (frames - done) : 64U;
+        check_rx_init(&rx);
+
+        for (i = 0, n = 0; i < batch; i++)
+        {
+            len[i] = check_payload(payload[i], CHECK_MAX_PAYLOAD);
+            off = uart_frame_encode(&stream[n], sizeof(stream) - n, payload[i], len[i]);
+            if ((off < len[i] + 2U) || (off > UART_FRAME_MAX_ENCODED(len[i])))
+            {
+                printf("  round trip: encoded %lu bytes for %lu\n", (unsigned long)off, (unsigned long)len[i]);
+                return 0;
+            }
+            n += off;
+        }
+
+        for (off = 0; off < n; off += piece)
+        {
+            piece = 1U + check_rand() % 64U;
+            piece = (piece < n - off) ? piece : (n - off);
+            check_rx_feed(&rx, &stream[off], piece);
+        }
+
+        ok &= check_counts(&rx, batch, 0, "round trip");
+        for (i = 0; (i < batch) && ok; i++)
+        {
+            ok &= check_frame(&rx, i, payload[i], len[i], "round trip");
+        }
+    }
+    return ok;
+}
+
+static int check_split(void)
+{
+    static check_rx_t rx;
+    static const uint8_t payload[] = { 0x01, UART_FRAME_END, 0x02, UART_FRAME_ESC, UART_FRAME_ESC_END,
+                                       UART_FRAME_ESC, UART_FRAME_END };
+    uint8_t enc[UART_FRAME_MAX_ENCODED(sizeof(payload))];
+    size_t n, cut;
+    int ok = 1;
+
+    n = uart_frame_encode(enc, sizeof(enc), payload, sizeof(payload));
+    for (cut = 0; cut <= n; cut++)
+    {
+        check_rx_init(&rx);
+        check_rx_feed(&rx, enc, cut);
+        check_rx_feed(&rx, &enc[cut], n - cut);
+        ok &= check_counts(&rx, 1, 0, "split") && check_frame(&rx, 0, payload, sizeof(payload), "split");
+    }
+
+    /* Byte by byte, twice over, so the second frame starts mid-read */
+    check_rx_init(&rx);
+    for (cut = 0; cut < 2U * n; cut++)
+    {
+        check_rx_feed(&rx, &enc[cut % n], 1);
+    }
+    ok &= check_counts(&rx, 2, 0, "split, byte by byte");
+    ok &= check_frame(&rx, 1, payload, sizeof(payload), "split, byte by byte");
+    return ok;
+}
+
+/* Feed raw bytes and compare what comes out */
+static int check_raw(const char *what, const uint8_t *data, size_t len, uint32_t frames, uint32_t dropped,
+                     const uint8_t *first, size_t first_len)
+{
+    static check_rx_t rx;
+    int ok;
+
+    check_rx_init(&rx);
+    check_rx_feed(&rx, data, len);
+    ok = check_counts(&rx, frames, dropped, what);
+    if (ok && (first != NULL))
+    {
+        ok = check_frame(&rx, frames - 1U, first, first_len, what);
+    }
+    return ok;
+}
+
+static int check_edges(void)
+{
+    static uint8_t payload[CHECK_DECODER_SIZE + 1U];
+    static uint8_t enc[UART_FRAME_MAX_ENCODED(CHECK_DECODER_SIZE + 1U) + 8U];
+    static const uint8_t raw_esc[] = { UART_FRAME_ESC_END, UART_FRAME_ESC_ESC, 0x00 };
+    static const uint8_t ok_frame[] = { 0x41, 0x42 };
+    static const uint8_t empty[] = { UART_FRAME_END, UART_FRAME_END, UART_FRAME_END };
+    static const uint8_t bad_escape[] = { UART_FRAME_END, 0x01, UART_FRAME_ESC, 0x02, 0x03, UART_FRAME_END,
+                                          0x41, 0x42, UART_FRAME_END };
+    static const uint8_t esc_end[] = { UART_FRAME_END, 0x01, UART_FRAME_ESC, UART_FRAME_END,
+                                       0x41, 0x42, UART_FRAME_END };
+    static const uint8_t no_start[] = { 0x41, 0x42, UART_FRAME_END };
+    size_t n;
+    int ok = 1;
+
+    /* Only END, then only ESC: every byte doubles */
+    memset(payload, UART_FRAME_END, 16);
+    n = uart_frame_encode(enc, sizeof(enc), payload, 16);
+    ok &= (n == UART_FRAME_MAX_ENCODED(16)) && check_raw("all END", enc, n, 1, 0, payload, 16);
+    memset(payload, UART_FRAME_ESC, 16);
+    n = uart_frame_encode(enc, sizeof(enc), payload, 16);
+    ok &= (n == UART_FRAME_MAX_ENCODED(16)) && check_raw("all ESC", enc, n, 1, 0, payload, 16);
+
+    /* ESC_END and ESC_ESC stand for themselves unless they follow ESC */
+    n = uart_frame_encode(enc, sizeof(enc), raw_esc, sizeof(raw_esc));
+    ok &= (n == sizeof(raw_esc) + 2U) && check_raw("raw ESC_END", enc, n, 1, 0, raw_esc, sizeof(raw_esc));
+
+    /* A payload ending in ESC: the escape pair sits against the closing END */
+    payload[0] = 0x41;
+    payload[1] = UART_FRAME_ESC;
+    n = uart_frame_encode(enc, sizeof(enc), payload, 2);
+    ok &= check_raw("trailing ESC", enc, n, 1, 0, payload, 2);
+
+    /* Back to back delimiters carry no frame and drop none */
+    ok &= check_raw("empty", empty, sizeof(empty), 0, 0, NULL, 0);
+
+    /* Exactly the decoder size fits; one byte more is dropped and the decoder
+       resumes at the next END */
+    memset(payload, 0x55, sizeof(payload));
+    payload[CHECK_DECODER_SIZE - 1U] = UART_FRAME_END;
+    n = uart_frame_encode(enc, sizeof(enc), payload, CHECK_DECODER_SIZE);
+    ok &= check_raw("full", enc, n, 1, 0, payload, CHECK_DECODER_SIZE);
+    n = uart_frame_encode(enc, sizeof(enc) - 8U, payload, CHECK_DECODER_SIZE + 1U);
+    memcpy(&enc[n], ok_frame, sizeof(ok_frame));
+    enc[n + sizeof(ok_frame)] = UART_FRAME_END;
+    ok &= check_raw("too long", enc, n + sizeof(ok_frame) + 1U, 1, 1, ok_frame, sizeof(ok_frame));
+
+    /* ESC before anything but ESC_END or ESC_ESC drops the frame */
+    ok &= check_raw("bad escape", bad_escape, sizeof(bad_escape), 1, 1, ok_frame, sizeof(ok_frame));
+    ok &= check_raw("ESC END", esc_end, sizeof(esc_end), 1, 1, ok_frame, sizeof(ok_frame));
+
+    /* Bytes before the first END still make a frame, as RFC 1055 allows */
+    ok &= check_raw("no opening END", no_start, sizeof(no_start), 1, 0, ok_frame, sizeof(ok_frame));
+
+    /* Too little room for the worst case, even if this payload would fit */
+    if ((uart_frame_encode(enc, UART_FRAME_MAX_ENCODED(2) - 1U, ok_frame, sizeof(ok_frame)) != 0) ||
+        (uart_frame_encode(enc, UART_FRAME_MAX_ENCODED(2), ok_frame, sizeof(ok_frame)) != 4U))
+    {
+        printf("  encode: room check\n");
+        ok = 0;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = 2000;
+    int opt, ok = 1, r;
+
+    while ((opt = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            frames = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            s_rng = (uint32_t)strtoul(optarg, NULL, 0);
+            s_rng = (s_rng != 0U) ? s_rng : 1U;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n FRAMES] [-s SEED]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    r = check_round_trip(frames);
+    printf("%-12s %s\n", "round trip", r ? "ok" : "FAIL");
+    ok &= r;
+    r = check_split();
+    printf("%-12s %s\n", "split", r ? "ok" : "FAIL");
+    ok &= r;
+    r = check_edges();
+    printf("%-12s %s\n", "edges", r ? "ok" : "FAIL");
+    ok &= r;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Compare two CMSIS-DSP cycle count sweeps.
+
+Reads the CSV or JSON output of dsp_bench (Core/Inc/dsp_bench.h): the
+target's, captured from the log port, or the host's dsp_host/build/dsp_bench.
+Log lines around the results, such as the elog prefix of other output, are
+skipped. Points are matched on function, type, block size and alignment and
+the minimum cycle counts compared:
+
+  * every point slower than the baseline by more than the threshold is a
+    regression, every one faster by as much an improvement;
+  * the geometric mean of new / old is printed over all points.
+
+Exits with 1 if there is any regression, so that CI can keep a baseline file
+and fail a change that slows a kernel down. Runs with different clocks
+(tsc, perf, DWT) or different numbers of taps are not comparable; the script
+warns when the run lines differ.
+
+usage: dsp_bench_compare.py BASELINE NEW [-t 5] [-k NAME] [--all]
+"""
+
+import argparse
+import csv
+import io
+import json
+import math
+import sys
+
+KEY = ("function", "type", "block", "align")
+
+
+def read_run(path):
+    """Return (run description, {key: (min, mean)})."""
+    run = {}
+    points = {}
+    with open(path, errors="replace") as f:
+        lines = [line.strip() for line in f]
+
+    rows = []
+    for line in lines:
+        # Output captured from a log port may have text before the record
+        brace = line.find("{")
+        if brace >= 0:
+            try:
+                obj = json.loads(line[brace:])
+            except ValueError:
+                continue
+            if "run" in obj:
+                run = {k: v for k, v in obj.items() if k != "run"}
+            elif "function" in obj:
+                rows.append(obj)
+            continue
+        if line.startswith("# dsp_bench"):
+            run = dict(field.split("=", 1) for field in line.split()[2:] if "=" in field)
+        elif line.startswith(("arm_", "dsp_")):
+            rows.extend(csv.DictReader(io.StringIO(line), fieldnames=KEY + ("min", "mean", "per_sample")))
+
+    for row in rows:
+        try:
+            key = (row["function"], row["type"], int(row["block"]), row["align"])
+            points[key] = (int(row["min"]), int(row["mean"]))
+        except (KeyError, TypeError, ValueError):
+            continue
+    return run, points
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("new")
+    parser.add_argument("-t", "--threshold", type=float, default=5.0,
+                        help="percent change reported as a regression or improvement (default 5)")
+    parser.add_argument("-k", "--keep", help="only functions whose name contains this")
+    parser.add_argument("--all", action="store_true", help="print every point, not just the changes")
+    args = parser.parse_args()
+
+    old_run, old = read_run(args.baseline)
+    new_run, new = read_run(args.new)
+    if not old or not new:
+        sys.exit("no dsp_bench results in %s" % (args.baseline if not old else args.new))
+    for field in ("clock", "taps"):
+        if str(old_run.get(field)) != str(new_run.get(field)):
+            print("warning: %s differs: %s vs %s" % (field, old_run.get(field), new_run.get(field)))
+
+    keys = sorted(k for k in old.keys() & new.keys() if not args.keep or args.keep in k[0])
+    limit = args.threshold / 100.0
+    regressions = improvements = 0
+    log_sum = 0.0
+    counted = 0
+
+    print("%-36s %-4s %6s %-7s %10s %10s %8s" % ("function", "type", "block", "align", "old", "new", "change"))
+    for key in keys:
+        before, after = old[key][0], new[key][0]
+        if before <= 0 or after <= 0:
+            continue
+        ratio = after / before
+        log_sum += math.log(ratio)
+        counted += 1
+        mark = ""
+        if ratio > 1.0 + limit:
+            regressions += 1
+            mark = "  slower"
+        elif ratio < 1.0 - limit:
+            improvements += 1
+            mark = "  faster"
+        if mark or args.all:
+            print("%-36s %-4s %6d %-7s %10d %10d %+7.1f%%%s" % (key + (before, after, (ratio - 1.0) * 100.0, mark)))
+
+    only_old = len(old.keys() - new.keys())
+    only_new = len(new.keys() - old.keys())
+    print("\n%d points compared, %d slower, %d faster by more than %g%%"
+          % (counted, regressions, improvements, args.threshold))
+    if counted:
+        print("geometric mean new/old: %.3f" % math.exp(log_sum / counted))
+    if only_old or only_new:
+        print("%d points only in the baseline, %d only in the new run" % (only_old, only_new))
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
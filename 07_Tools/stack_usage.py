@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Static worst-case stack usage from GCC stack usage output.
+
+Build the firmware with
+
+    -fstack-usage -fcallgraph-info=su
+
+which leaves a .su file (frame size of every function) and a .ci file (call
+graph) next to each object. This script reads them and prints:
+
+  * the largest frames, and
+  * for each entry point, the deepest chain of calls below it and the stack
+    that chain needs.
+
+Entry points are the functions given with -e, for example a task function
+and the interrupt handlers, or by default every function nothing calls.
+Compare a task's figure with the stack_size that stack_prof_report() (see
+Core/Inc/stack_prof.h) recommends from the measured high-water mark: the
+static figure covers paths the measurement may never have run, while the
+measurement covers what static analysis cannot see, such as calls through
+pointers. Add the exception frame the port stacks on a switch, up to 104
+bytes with the FPU context, to task figures.
+
+A frame marked "dynamic" uses alloca or variable length arrays and a chain
+marked "recursive" calls itself; both make the figure a lower bound, as do
+calls to functions without stack usage data (the C library, assembly).
+Without .ci files only the frame sizes are printed.
+
+With the ARM compiler, armlink --info=stack and --callgraph give the same
+analysis for the Keil build.
+
+usage: stack_usage.py BUILD_DIR... [-e FUNCTION]... [-n 20]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# file.c:12:6:function<TAB>48<TAB>static
+SU_LINE = re.compile(r"^(?P<loc>.*?):(?P<func>[^:\s]+)\t(?P<size>\d+)\t(?P<kind>[\w,]+)$")
+CI_NODE = re.compile(r'node:\s*\{\s*title:\s*"(?P<title>[^"]+)"')
+CI_EDGE = re.compile(r'edge:\s*\{\s*sourcename:\s*"(?P<src>[^"]+)"\s*targetname:\s*"(?P<dst>[^"]+)"')
+
+
+def find_files(paths, suffix):
+    for path in paths:
+        if os.path.isfile(path):
+            if path.endswith(suffix):
+                yield path
+            continue
+        for root, _, files in os.walk(path):
+            for name in files:
+                if name.endswith(suffix):
+                    yield os.path.join(root, name)
+
+
+def read_su(paths):
+    """Return {function: (frame bytes, kind, location)}."""
+    frames = {}
+    for path in find_files(paths, ".su"):
+        with open(path) as f:
+            for line in f:
+                m = SU_LINE.match(line.rstrip("\n"))
+                if m:
+                    frames[m["func"]] = (int(m["size"]), m["kind"], m["loc"])
+    return frames
+
+
+def read_ci(paths):
+    """Return {function: set of callees}, or None if there are no .ci files."""
+    calls = None
+    for path in find_files(paths, ".ci"):
+        calls = calls if calls is not None else {}
+        with open(path) as f:
+            text = f.read()
+        for m in CI_NODE.finditer(text):
+            calls.setdefault(m["title"], set())
+        for m in CI_EDGE.finditer(text):
+            calls.setdefault(m["src"], set()).add(m["dst"])
+    return calls
+
+
+class Analysis:
+    def __init__(self, frames, calls):
+        self.frames = frames
+        self.calls = calls
+        self.memo = {}
+
+    def frame(self, func):
+        return self.frames.get(func, (0, "unknown", ""))
+
+    def worst(self, func, stack=()):
+        """Return (bytes, chain, notes) for the deepest path from func."""
+        if func in self.memo:
+            return self.memo[func]
+        size, kind, _ = self.frame(func)
+        notes = set()
+        if "dynamic" in kind:
+            notes.add("dynamic")
+        if func not in self.frames:
+            notes.add("unknown")
+
+        best = (0, (), set())
+        for callee in sorted(self.calls.get(func, ())):
+            if callee == func or callee in stack:
+                notes.add("recursive")
+                continue
+            below = self.worst(callee, stack + (func,))
+            if below[0] > best[0] or not best[1]:
+                best = below
+        result = (size + best[0], (func,) + best[1], notes | best[2])
+        # A chain cut short by recursion depends on the path taken; only
+        # remember complete results.
+        if "recursive" not in notes:
+            self.memo[func] = result
+        return result
+
+    def roots(self):
+        called = set()
+        for callees in self.calls.values():
+            called |= callees
+        return sorted(f for f in self.calls if f not in called and f in self.frames)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("paths", nargs="+", help="build directories or .su/.ci files")
+    parser.add_argument("-e", "--entry", action="append", default=[],
+                        help="entry point to analyse (repeatable; default: all roots)")
+    parser.add_argument("-n", "--top", type=int, default=20, help="rows per table (default 20)")
+    parser.add_argument("--chain", action="store_true", help="print the deepest call chain of each entry")
+    args = parser.parse_args()
+
+    frames = read_su(args.paths)
+    if not frames:
+        sys.exit("no .su files found; build with -fstack-usage")
+
+    print("%-40s %8s  %s" % ("largest frames", "bytes", "kind"))
+    for func, (size, kind, _) in sorted(frames.items(), key=lambda kv: -kv[1][0])[:args.top]:
+        print("%-40s %8d  %s" % (func, size, kind))
+
+    calls = read_ci(args.paths)
+    if calls is None:
+        print("\nno .ci files found; build with -fcallgraph-info=su for per-entry totals")
+        return
+
+    analysis = Analysis(frames, calls)
+    entries = args.entry or analysis.roots()
+    results = sorted(((analysis.worst(e), e) for e in entries), key=lambda r: -r[0][0])
+
+    print("\n%-40s %8s %6s  %s" % ("entry point", "bytes", "depth", "notes"))
+    for (size, chain, notes), entry in results[:args.top if not args.entry else None]:
+        print("%-40s %8d %6d  %s" % (entry, size, len(chain), ", ".join(sorted(notes))))
+        if args.chain:
+            for func in chain:
+                print("    %-36s %8d" % (func, analysis.frame(func)[0]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""Convert a trace_rec RTT capture to Chrome trace event JSON.
+
+The input is the raw byte stream of the firmware's trace channel (RTT up
+buffer 1), for example as saved by
+
+    JLinkRTTLogger -Device STM32F411CE -If SWD -Speed 4000 -RTTChannel 1 trace.bin
+
+The output loads in chrome://tracing and https://ui.perfetto.dev:
+
+  * Tasks        one track per task, a slice for every period it runs. The
+                 wait from becoming ready to running is in each slice's args.
+  * Interrupts   one track per exception number, from ISR entry to exit.
+  * Waits        one track per task, a slice for every time it blocked on a
+                 queue, semaphore or mutex until it ran again.
+  * Heap         bytes allocated, as a counter.
+
+Queue operations, priority inheritance and lost records are instant events.
+The record layout is defined in Core/Inc/trace_rec.h.
+
+usage: trace2json.py trace.bin [-o trace.json]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+SYNC = 0x01
+LOST = 0x02
+TASK_CREATE = 0x10
+TASK_DELETE = 0x11
+TASK_IN = 0x12
+TASK_OUT = 0x13
+TASK_READY = 0x14
+QUEUE_CREATE = 0x20
+QUEUE_SEND = 0x21
+QUEUE_SEND_FAILED = 0x22
+QUEUE_RECEIVE = 0x23
+QUEUE_RECEIVE_FAILED = 0x24
+QUEUE_BLOCK_SEND = 0x25
+QUEUE_BLOCK_RECEIVE = 0x26
+QUEUE_SEND_ISR = 0x27
+QUEUE_RECEIVE_ISR = 0x28
+QUEUE_DELETE = 0x29
+MUTEX_INHERIT = 0x30
+MUTEX_DISINHERIT = 0x31
+MALLOC = 0x40
+FREE = 0x41
+ISR_ENTER = 0x50
+ISR_EXIT = 0x51
+
+# Record length by type; every other type is a plain 8 byte record.
+RECORD_LEN = {SYNC: 16, TASK_CREATE: 24, MALLOC: 16, FREE: 16}
+
+QUEUE_EVENTS = {
+    QUEUE_SEND: "send",
+    QUEUE_SEND_FAILED: "send failed",
+    QUEUE_RECEIVE: "receive",
+    QUEUE_RECEIVE_FAILED: "receive failed",
+    QUEUE_SEND_ISR: "send from ISR",
+    QUEUE_RECEIVE_ISR: "receive from ISR",
+    QUEUE_DELETE: "delete",
+}
+
+# ucQueueType values from queue.h.
+QUEUE_TYPES = {
+    0: "queue",
+    1: "mutex",
+    2: "counting semaphore",
+    3: "binary semaphore",
+    4: "recursive mutex",
+}
+
+PID_TASKS = 1
+PID_ISRS = 2
+PID_WAITS = 3
+PID_HEAP = 4
+
+
+def records(data):
+    """Yield (timestamp low word, type, a8, a16, payload) for every record."""
+    pos = 0
+    while pos + 8 <= len(data):
+        ts, rtype, a8, a16 = struct.unpack_from("<IBBH", data, pos)
+        length = RECORD_LEN.get(rtype, 8)
+        if pos + length > len(data):
+            break
+        yield ts, rtype, a8, a16, data[pos + 8:pos + length]
+        pos += length
+
+
+class Converter:
+    def __init__(self):
+        self.events = []
+        self.hz = 100000000
+        self.high = 0
+        self.last_low = None
+        self.task_names = {}
+        self.queues = {}
+        self.running = None
+        self.ready_at = {}
+        self.waiting = {}
+        self.isr_stack = []
+        self.isrs = set()
+        self.blocks = {}
+        self.heap = 0
+
+    def time_us(self, low):
+        # Records are in timestamp order; a smaller low word is a wrap.
+        if self.last_low is not None and low < self.last_low:
+            self.high += 1
+        self.last_low = low
+        return ((self.high << 32) | low) * 1e6 / self.hz
+
+    def task_name(self, task):
+        return self.task_names.get(task, "task %d" % task)
+
+    def queue_name(self, queue):
+        kind = self.queues.get(queue, "queue")
+        return "%s %d" % (kind, queue)
+
+    def emit(self, **event):
+        self.events.append(event)
+
+    def instant(self, ts, name, args=None):
+        """An instant event on the track of whatever is running."""
+        if self.isr_stack:
+            pid, tid = PID_ISRS, self.isr_stack[-1]
+        else:
+            pid, tid = PID_TASKS, self.running if self.running is not None else 0
+        self.emit(name=name, ph="i", s="t", ts=ts, pid=pid, tid=tid, args=args or {})
+
+    def record(self, low, rtype, a8, a16, payload):
+        if rtype == SYNC:
+            high, hz = struct.unpack_from("<II", payload)
+            self.high, self.hz, self.last_low = high, hz or self.hz, low
+            return
+        ts = self.time_us(low)
+
+        if rtype == LOST:
+            self.emit(name="lost %d records" % a16, ph="i", s="g", ts=ts, pid=PID_TASKS, tid=0)
+        elif rtype == TASK_CREATE:
+            name = payload.split(b"\0", 1)[0].decode("ascii", "replace")
+            self.task_names[a16] = name
+            for pid in (PID_TASKS, PID_WAITS):
+                self.emit(name="thread_name", ph="M", pid=pid, tid=a16, args={"name": name})
+            self.instant(ts, "create " + name, {"priority": a8})
+        elif rtype == TASK_DELETE:
+            self.instant(ts, "delete " + self.task_name(a16))
+        elif rtype == TASK_READY:
+            self.ready_at.setdefault(a16, ts)
+        elif rtype == TASK_IN:
+            self.running = a16
+            args = {}
+            if a16 in self.ready_at:
+                args["ready_to_run_us"] = round(ts - self.ready_at.pop(a16), 3)
+            self.emit(name=self.task_name(a16), ph="B", ts=ts, pid=PID_TASKS, tid=a16, args=args)
+            if a16 in self.waiting:
+                self.emit(name=self.waiting.pop(a16), ph="E", ts=ts, pid=PID_WAITS, tid=a16)
+        elif rtype == TASK_OUT:
+            self.emit(name=self.task_name(a16), ph="E", ts=ts, pid=PID_TASKS, tid=a16)
+            self.ready_at.pop(a16, None)
+            self.running = None
+        elif rtype == QUEUE_CREATE:
+            self.queues[a16] = QUEUE_TYPES.get(a8, "queue")
+        elif rtype in (QUEUE_BLOCK_SEND, QUEUE_BLOCK_RECEIVE):
+            verb = "send" if rtype == QUEUE_BLOCK_SEND else "take" if "mutex" in self.queues.get(a16, "") else "receive"
+            name = "blocked on %s (%s)" % (self.queue_name(a16), verb)
+            if self.running is not None and self.running not in self.waiting:
+                self.waiting[self.running] = name
+                self.emit(name=name, ph="B", ts=ts, pid=PID_WAITS, tid=self.running)
+        elif rtype in QUEUE_EVENTS:
+            self.instant(ts, "%s %s" % (QUEUE_EVENTS[rtype], self.queue_name(a16)))
+        elif rtype in (MUTEX_INHERIT, MUTEX_DISINHERIT):
+            what = "inherits" if rtype == MUTEX_INHERIT else "drops back to"
+            self.instant(ts, "%s %s priority %d" % (self.task_name(a16), what, a8))
+        elif rtype in (MALLOC, FREE):
+            address, size = struct.unpack_from("<II", payload)
+            if rtype == MALLOC and address != 0:
+                self.blocks[address] = size
+                self.heap += size
+            elif rtype == FREE:
+                self.heap -= self.blocks.pop(address, size)
+            name = "malloc" if rtype == MALLOC else "free"
+            self.instant(ts, name, {"address": "0x%08x" % address, "size": size})
+            self.emit(name="heap", ph="C", ts=ts, pid=PID_HEAP, args={"bytes": self.heap})
+        elif rtype == ISR_ENTER:
+            self.isr_stack.append(a16)
+            if a16 not in self.isrs:
+                self.isrs.add(a16)
+                self.emit(name="thread_name", ph="M", pid=PID_ISRS, tid=a16,
+                          args={"name": "IRQ %d" % (a16 - 16) if a16 >= 16 else "exception %d" % a16})
+            self.emit(name="ISR", ph="B", ts=ts, pid=PID_ISRS, tid=a16)
+        elif rtype == ISR_EXIT:
+            if self.isr_stack and self.isr_stack[-1] == a16:
+                self.isr_stack.pop()
+            self.emit(name="ISR", ph="E", ts=ts, pid=PID_ISRS, tid=a16)
+
+    def document(self):
+        names = {PID_TASKS: "Tasks", PID_ISRS: "Interrupts", PID_WAITS: "Waits", PID_HEAP: "Heap"}
+        meta = [dict(name="process_name", ph="M", pid=pid, args={"name": name}) for pid, name in names.items()]
+        return {"traceEvents": meta + self.events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="raw capture of the trace RTT channel")
+    parser.add_argument("-o", "--output", help="JSON file to write (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    conv = Converter()
+    for rec in records(data):
+        conv.record(*rec)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    json.dump(conv.document(), out)
+    if args.output:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()